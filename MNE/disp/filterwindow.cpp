@@ -191,6 +191,10 @@ void FilterWindow::setFilterParameters(double hp, double lp, int order, int type
         ui->m_comboBox_designMethod->setCurrentText("Tschebyscheff");
     if(designMethod == 1)
         ui->m_comboBox_designMethod->setCurrentText("Cosine");
+    if(designMethod == 3)
+        ui->m_comboBox_designMethod->setCurrentText("Butterworth IIR");
+    if(designMethod == 4)
+        ui->m_comboBox_designMethod->setCurrentText("Chebyshev IIR");
 
     ui->m_doubleSpinBox_transitionband->setValue(transition);
 
@@ -553,6 +557,13 @@ void FilterWindow::changeStateSpinBoxes(int currentIndex)
             ui->m_spinBox_filterTaps->setVisible(true);
             ui->m_label_filterTaps->setVisible(true);
             break;
+
+        case 2: //Butterworth IIR
+        case 3: //Chebyshev IIR
+            //IIR filters are designed with a fixed low order, the taps are not used
+            ui->m_spinBox_filterTaps->setVisible(false);
+            ui->m_label_filterTaps->setVisible(false);
+            break;
     }
 
     //Change visibility of spin boxes depending on filter type
@@ -645,6 +656,17 @@ void FilterWindow::filterParametersChanged()
     if(ui->m_comboBox_designMethod->currentText() == "Cosine")
         dMethod = FilterData::Cosine;
 
+    if(ui->m_comboBox_designMethod->currentText() == "Butterworth IIR")
+        dMethod = FilterData::ButterworthIIR;
+
+    if(ui->m_comboBox_designMethod->currentText() == "Chebyshev IIR")
+        dMethod = FilterData::ChebyshevIIR;
+
+    //IIR filters take the order of the analog prototype instead of the number of taps
+    int iOrder = m_iFilterTaps;
+    if(dMethod == FilterData::ButterworthIIR || dMethod == FilterData::ChebyshevIIR)
+        iOrder = 4;
+
     //Generate filters
     QSharedPointer<FilterData> userDefinedFilterOperator;
 
@@ -654,7 +676,7 @@ void FilterWindow::filterParametersChanged()
         userDefinedFilterOperator = QSharedPointer<FilterData>(
                                                 new FilterData("User Design",
                                                                FilterData::LPF,
-                                                               m_iFilterTaps,
+                                                               iOrder,
                                                                lowpassHz/nyquistFrequency,
                                                                0.2,
                                                                (double)trans_width/nyquistFrequency,
@@ -667,7 +689,7 @@ void FilterWindow::filterParametersChanged()
         userDefinedFilterOperator = QSharedPointer<FilterData>(
                                         new FilterData("User Design",
                                                         FilterData::HPF,
-                                                        m_iFilterTaps,
+                                                        iOrder,
                                                         highpassHz/nyquistFrequency,
                                                         0.2,
                                                         (double)trans_width/nyquistFrequency,
@@ -680,7 +702,7 @@ void FilterWindow::filterParametersChanged()
         userDefinedFilterOperator = QSharedPointer<FilterData>(
                    new FilterData("User Design",
                                   FilterData::BPF,
-                                  m_iFilterTaps,
+                                  iOrder,
                                   (double)center/nyquistFrequency,
                                   (double)bw/nyquistFrequency,
                                   (double)trans_width/nyquistFrequency,
@@ -103,7 +103,8 @@ SOURCES += fiff.cpp \
     fiff_evoked.cpp \
     fiff_evoked_set.cpp \
     fiff_io.cpp \
-    fiff_dig_point_set.cpp
+    fiff_dig_point_set.cpp \
+    fiff_rt_buffer_info.cpp
 
 HEADERS += fiff.h \
     fiff_global.h \
@@ -129,7 +130,8 @@ HEADERS += fiff.h \
     fiff_evoked.h \
     fiff_evoked_set.h \ \
     fiff_io.h \
-    fiff_dig_point_set.h
+    fiff_dig_point_set.h \
+    fiff_rt_buffer_info.h
 
 INCLUDEPATH += $${EIGEN_INCLUDE_DIR}
 INCLUDEPATH += $${MNE_INCLUDE_DIR}
@@ -0,0 +1,120 @@
+//=============================================================================================================
+/**
+* @file     fiff_rt_buffer_info.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    FiffRtBufferInfo class definition.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_rt_buffer_info.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QDateTime>
+#include <QElapsedTimer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC DEFINITIONS
+//=============================================================================================================
+
+namespace
+{
+    //Wall clock anchor of the monotonic clock, taken at first use
+    struct AcqClock
+    {
+        AcqClock()
+        : iEpochAnchor(QDateTime::currentMSecsSinceEpoch() * 1000)
+        {
+            timer.start();
+        }
+
+        qint64          iEpochAnchor;
+        QElapsedTimer   timer;
+    };
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffRtBufferInfo::FiffRtBufferInfo()
+: sequence(-1)
+, acqTime(-1)
+{
+}
+
+
+//*************************************************************************************************************
+
+FiffRtBufferInfo::FiffRtBufferInfo(fiff_int_t p_iSequence, qint64 p_iAcqTime)
+: sequence(p_iSequence)
+, acqTime(p_iAcqTime)
+{
+}
+
+
+//*************************************************************************************************************
+
+fiffTimeRec FiffRtBufferInfo::toFiffTime() const
+{
+    fiffTimeRec t_time;
+    t_time.secs = (fiff_int_t)(acqTime / 1000000);
+    t_time.usecs = (fiff_int_t)(acqTime % 1000000);
+    return t_time;
+}
+
+
+//*************************************************************************************************************
+
+qint64 FiffRtBufferInfo::currentTime()
+{
+    static AcqClock s_clock;
+    return s_clock.iEpochAnchor + s_clock.timer.nsecsElapsed() / 1000;
+}
@@ -0,0 +1,171 @@
+//=============================================================================================================
+/**
+* @file     fiff_rt_buffer_info.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    FiffRtBufferInfo class declaration.
+*
+*/
+
+#ifndef FIFF_RT_BUFFER_INFO_H
+#define FIFF_RT_BUFFER_INFO_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FIFF INCLUDES
+//=============================================================================================================
+
+#include "fiff_global.h"
+#include "fiff_types.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QMetaType>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE FIFFLIB
+//=============================================================================================================
+
+namespace FIFFLIB
+{
+
+
+//=============================================================================================================
+/**
+* Each raw buffer which is send by mne_rt_server is preceded by a FIFF_MNE_RT_BUFFER_INFO tag, holding a
+* monotonic sequence number and the acquisition time stamp. The tag data are three ints: the sequence number,
+* the GMT seconds and the microseconds of the acquisition time (same layout as fiffTimeRec).
+*
+* @brief Real-time buffer description: sequence number and acquisition time
+*/
+class FIFFSHARED_EXPORT FiffRtBufferInfo
+{
+public:
+    typedef QSharedPointer<FiffRtBufferInfo> SPtr;              /**< Shared pointer type for FiffRtBufferInfo. */
+    typedef QSharedPointer<const FiffRtBufferInfo> ConstSPtr;   /**< Const shared pointer type for FiffRtBufferInfo. */
+
+    //=========================================================================================================
+    /**
+    * Constructs an invalid buffer info.
+    */
+    FiffRtBufferInfo();
+
+    //=========================================================================================================
+    /**
+    * Constructs a buffer info.
+    *
+    * @param[in] p_iSequence    The sequence number of the buffer.
+    * @param[in] p_iAcqTime     The acquisition time in microseconds since epoch.
+    */
+    FiffRtBufferInfo(fiff_int_t p_iSequence, qint64 p_iAcqTime);
+
+    //=========================================================================================================
+    /**
+    * Returns whether the buffer info was set.
+    *
+    * @return true if valid, false otherwise.
+    */
+    inline bool isValid() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the age of the buffer, i.e., the time which has elapsed since its acquisition.
+    *
+    * @return the age in microseconds, -1 if the info is not valid.
+    */
+    inline qint64 age() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the acquisition time as fiff time stamp.
+    *
+    * @return the acquisition time.
+    */
+    fiffTimeRec toFiffTime() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the current time in microseconds since epoch. The time stamps are derived from a monotonic clock
+    * anchored at the wall clock, so they never step backwards within a process.
+    *
+    * @return the current time in microseconds since epoch.
+    */
+    static qint64 currentTime();
+
+    //=========================================================================================================
+    /**
+    * Number of ints of the FIFF_MNE_RT_BUFFER_INFO tag data.
+    *
+    * @return the number of ints.
+    */
+    inline static qint32 storageSize();
+
+public:
+    fiff_int_t  sequence;   /**< Monotonic sequence number, -1 if not set. */
+    qint64      acqTime;    /**< Acquisition time in microseconds since epoch, -1 if not set. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline bool FiffRtBufferInfo::isValid() const
+{
+    return sequence >= 0 && acqTime >= 0;
+}
+
+
+//*************************************************************************************************************
+
+inline qint64 FiffRtBufferInfo::age() const
+{
+    return isValid() ? currentTime() - acqTime : -1;
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 FiffRtBufferInfo::storageSize()
+{
+    return 3;
+}
+
+} // NAMESPACE
+
+Q_DECLARE_METATYPE(FIFFLIB::FiffRtBufferInfo)
+
+#endif // FIFF_RT_BUFFER_INFO_H
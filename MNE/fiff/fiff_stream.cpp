@@ -49,6 +49,7 @@
 #include "fiff_coord_trans.h"
 #include "fiff_ch_info.h"
 #include "fiff_dig_point.h"
+#include "fiff_rt_buffer_info.h"
 
 #include <utils/mnemath.h>
 
@@ -2557,3 +2558,18 @@ void FiffStream::write_rt_command(fiff_int_t command, const QString& data)
 
     this->writeRawData(data.toUtf8().constData(),datasize);
 }
+
+
+//*************************************************************************************************************
+
+void FiffStream::write_rt_buffer_info(const FiffRtBufferInfo& p_bufferInfo)
+{
+    fiffTimeRec t_acqTime = p_bufferInfo.toFiffTime();
+
+    fiff_int_t t_data[3];
+    t_data[0] = p_bufferInfo.sequence;
+    t_data[1] = t_acqTime.secs;
+    t_data[2] = t_acqTime.usecs;
+
+    this->write_int(FIFF_MNE_RT_BUFFER_INFO, t_data, FiffRtBufferInfo::storageSize());
+}
@@ -96,6 +96,7 @@ class FiffNamedMatrix;
 class FiffDigPoint;
 class FiffChInfo;
 class FiffCoordTrans;
+class FiffRtBufferInfo;
 
 static FiffId defaultFiffId;
 
@@ -675,6 +676,14 @@ public:
     * @param[in] data       The string data to write
     */
     void write_rt_command(fiff_int_t command, const QString& data);
+
+    //=========================================================================================================
+    /**
+    * Writes the real-time buffer info, which precedes a raw data buffer
+    *
+    * @param[in] p_bufferInfo   The sequence number and acquisition time of the following buffer
+    */
+    void write_rt_buffer_info(const FiffRtBufferInfo& p_bufferInfo);
 };
 
 } // NAMESPACE
@@ -91,6 +91,7 @@
 #include "fiff_dir_entry.h"
 #include "fiff_tag.h"
 #include "fiff_dig_point.h"
+#include "fiff_rt_buffer_info.h"
 
 
 //*************************************************************************************************************
@@ -396,6 +397,14 @@ public:
     */
     inline FiffDigPoint toDigPoint() const;
 
+    //=========================================================================================================
+    /**
+    * to real-time buffer info
+    *
+    * @return the sequence number and acquisition time of the FIFF_MNE_RT_BUFFER_INFO tag
+    */
+    inline FiffRtBufferInfo toRtBufferInfo() const;
+
     //=========================================================================================================
     /**
     * to fiff COORD TRANS
@@ -778,6 +787,25 @@ inline FiffDigPoint FiffTag::toDigPoint() const
 }
 
 
+//*************************************************************************************************************
+
+inline FiffRtBufferInfo FiffTag::toRtBufferInfo() const
+{
+    FiffRtBufferInfo t_fiffRtBufferInfo;
+    if(this->isMatrix() || this->getType() != FIFFT_INT || this->size() < FiffRtBufferInfo::storageSize()*4 || this->data() == NULL)
+        return t_fiffRtBufferInfo;
+    else
+    {
+        qint32* t_pInt32 = (qint32*)this->data();
+
+        t_fiffRtBufferInfo.sequence = t_pInt32[0];
+        t_fiffRtBufferInfo.acqTime = (qint64)t_pInt32[1] * 1000000 + t_pInt32[2];
+
+        return t_fiffRtBufferInfo;
+    }
+}
+
+
 //*************************************************************************************************************
 
 inline FiffCoordTrans FiffTag::toCoordTrans() const
@@ -135,6 +135,15 @@ public:
     */
     inline Matrix<_Tp, Dynamic, Dynamic> pop();
 
+    //=========================================================================================================
+    /**
+    * Copies the first matrix (first in first out) into the given matrix. No memory is allocated if the matrix
+    * already has the shape of the buffer, e.g. when it is reused or taken from a MatrixPool.
+    *
+    * @param [out] matrix   the matrix to fill, resized if necessary.
+    */
+    inline void pop(Matrix<_Tp, Dynamic, Dynamic>& matrix);
+
     //=========================================================================================================
     /**
     * Clears the buffer.
@@ -264,6 +273,20 @@ inline Matrix<_Tp, Dynamic, Dynamic> CircularMatrixBuffer<_Tp>::pop()
 {
     Matrix<_Tp, Dynamic, Dynamic> matrix(m_uiRows, m_uiCols);
 
+    pop(matrix);
+
+    return matrix;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void CircularMatrixBuffer<_Tp>::pop(Matrix<_Tp, Dynamic, Dynamic>& matrix)
+{
+    if(matrix.rows() != (int)m_uiRows || matrix.cols() != (int)m_uiCols)
+        matrix.resize(m_uiRows, m_uiCols);
+
     if(!m_bPause)
     {
         m_pUsedElements->acquire(m_uiRows*m_uiCols);
@@ -273,8 +296,6 @@ inline Matrix<_Tp, Dynamic, Dynamic> CircularMatrixBuffer<_Tp>::pop()
     }
     else
         matrix.setZero();
-
-    return matrix;
 }
 
 
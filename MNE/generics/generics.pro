@@ -72,11 +72,16 @@ else {
 SOURCES += \ 
     circularbuffer.cpp \
     circularmatrixbuffer.cpp \
+    matrixringbuffer.cpp \
+    matrixpool.cpp \
     observerpattern.cpp \
     buffer.cpp
 
 HEADERS += generics_global.h \
     circularmatrixbuffer.h \
+    matrixringbuffer.h \
+    matrixringbufferadapter.h \
+    matrixpool.h \
     circularbuffer.h \
     observerpattern.h \
     commandpattern.h \
@@ -0,0 +1,228 @@
+//=============================================================================================================
+/**
+* @file     matrixpool.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the definition of the MatrixPool class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "matrixpool.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QMutexLocker>
+#include <QtAlgorithms>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace IOBuffer;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+MatrixPool::Storage::~Storage()
+{
+    QHash<QPair<qint32, qint32>, QVector<MatrixXd*> >::iterator it = freeLists.begin();
+    for( ; it != freeLists.end(); ++it)
+        qDeleteAll(it.value());
+}
+
+
+//*************************************************************************************************************
+
+void MatrixPool::Recycler::operator()(MatrixXd* pMatrix) const
+{
+    {
+        QMutexLocker t_locker(&pStorage->mutex);
+
+        QVector<MatrixXd*>& t_freeList = pStorage->freeLists[qMakePair((qint32)pMatrix->rows(), (qint32)pMatrix->cols())];
+        if(t_freeList.size() < pStorage->iMaxPerClass)
+        {
+            //Allocate the list once so that returning a block never allocates
+            if(t_freeList.capacity() < pStorage->iMaxPerClass)
+                t_freeList.reserve(pStorage->iMaxPerClass);
+
+            t_freeList.append(pMatrix);
+            pStorage->iReleases.fetchAndAddRelaxed(1);
+            pStorage->iIdle.fetchAndAddRelaxed(1);
+            return;
+        }
+    }
+
+    pStorage->iDiscards.fetchAndAddRelaxed(1);
+    delete pMatrix;
+}
+
+
+//*************************************************************************************************************
+
+MatrixPool::MatrixPool(qint32 iMaxPerClass)
+: m_pStorage(new Storage)
+{
+    m_pStorage->iMaxPerClass = iMaxPerClass;
+}
+
+
+//*************************************************************************************************************
+
+MatrixPool::~MatrixPool()
+{
+}
+
+
+//*************************************************************************************************************
+
+MatrixPool::MatrixPtr MatrixPool::acquire(qint32 iRows, qint32 iCols)
+{
+    MatrixXd* t_pMatrix = NULL;
+
+    {
+        QMutexLocker t_locker(&m_pStorage->mutex);
+
+        QHash<QPair<qint32, qint32>, QVector<MatrixXd*> >::iterator it = m_pStorage->freeLists.find(qMakePair(iRows, iCols));
+        if(it != m_pStorage->freeLists.end() && !it.value().isEmpty())
+        {
+            t_pMatrix = it.value().last();
+            it.value().removeLast();
+        }
+    }
+
+    if(t_pMatrix)
+    {
+        m_pStorage->iReuses.fetchAndAddRelaxed(1);
+        m_pStorage->iIdle.fetchAndAddRelaxed(-1);
+    }
+    else
+    {
+        t_pMatrix = new MatrixXd(iRows, iCols);
+        m_pStorage->iAllocations.fetchAndAddRelaxed(1);
+    }
+
+    Recycler t_recycler;
+    t_recycler.pStorage = m_pStorage;
+
+    return MatrixPtr(t_pMatrix, t_recycler);
+}
+
+
+//*************************************************************************************************************
+
+MatrixPool::MatrixPtr MatrixPool::copy(const MatrixXd& mat)
+{
+    MatrixPtr t_pMatrix = acquire((qint32)mat.rows(), (qint32)mat.cols());
+    *t_pMatrix = mat;
+    return t_pMatrix;
+}
+
+
+//*************************************************************************************************************
+
+void MatrixPool::reserve(qint32 iRows, qint32 iCols, qint32 iCount)
+{
+    QMutexLocker t_locker(&m_pStorage->mutex);
+
+    QVector<MatrixXd*>& t_freeList = m_pStorage->freeLists[qMakePair(iRows, iCols)];
+    t_freeList.reserve(m_pStorage->iMaxPerClass);
+
+    while(t_freeList.size() < qMin(iCount, m_pStorage->iMaxPerClass))
+    {
+        t_freeList.append(new MatrixXd(iRows, iCols));
+        m_pStorage->iAllocations.fetchAndAddRelaxed(1);
+        m_pStorage->iIdle.fetchAndAddRelaxed(1);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void MatrixPool::clear()
+{
+    QMutexLocker t_locker(&m_pStorage->mutex);
+
+    QHash<QPair<qint32, qint32>, QVector<MatrixXd*> >::iterator it = m_pStorage->freeLists.begin();
+    for( ; it != m_pStorage->freeLists.end(); ++it)
+    {
+        m_pStorage->iIdle.fetchAndAddRelaxed(-it.value().size());
+        qDeleteAll(it.value());
+    }
+
+    m_pStorage->freeLists.clear();
+}
+
+
+//*************************************************************************************************************
+
+MatrixPool::Counters MatrixPool::counters() const
+{
+    Counters t_counters;
+    t_counters.allocations = m_pStorage->iAllocations.loadAcquire();
+    t_counters.reuses = m_pStorage->iReuses.loadAcquire();
+    t_counters.releases = m_pStorage->iReleases.loadAcquire();
+    t_counters.discards = m_pStorage->iDiscards.loadAcquire();
+    t_counters.idle = m_pStorage->iIdle.loadAcquire();
+    return t_counters;
+}
+
+
+//*************************************************************************************************************
+
+void MatrixPool::resetCounters()
+{
+    m_pStorage->iAllocations.storeRelease(0);
+    m_pStorage->iReuses.storeRelease(0);
+    m_pStorage->iReleases.storeRelease(0);
+    m_pStorage->iDiscards.storeRelease(0);
+}
+
+
+//*************************************************************************************************************
+
+MatrixPool& MatrixPool::global()
+{
+    //Never destroyed - blocks may be released during static destruction
+    static MatrixPool* s_pPool = new MatrixPool;
+    return *s_pPool;
+}
@@ -0,0 +1,221 @@
+//=============================================================================================================
+/**
+* @file     matrixpool.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the declaration of the MatrixPool class.
+*
+*/
+
+#ifndef MATRIXPOOL_H
+#define MATRIXPOOL_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "generics_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QSharedPointer>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define MATRIX_POOL_MAX_PER_CLASS   64      /**< Default number of idle matrices kept per shape. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE IOBuffer
+//=============================================================================================================
+
+namespace IOBuffer
+{
+
+
+//=============================================================================================================
+/**
+* Thread-safe pool of MatrixXd blocks, classed by shape. acquire() hands out a reference-counted block; when the
+* last reference is dropped the block goes back to the free list of its shape instead of being freed, so a
+* stream of equally shaped blocks runs without allocating matrix storage once the pool is warm. The free lists
+* are guarded by a mutex which is held for a list push or pop only.
+*
+* Blocks may outlive the pool: the free lists are shared with the outstanding blocks and released with the last
+* of them.
+*
+* @brief Size-classed pool of reference-counted matrices
+*/
+class GENERICSSHARED_EXPORT MatrixPool
+{
+public:
+    typedef QSharedPointer<MatrixPool> SPtr;                /**< Shared pointer type for MatrixPool. */
+    typedef QSharedPointer<const MatrixPool> ConstSPtr;     /**< Const shared pointer type for MatrixPool. */
+
+    typedef QSharedPointer<Eigen::MatrixXd> MatrixPtr;      /**< A pooled block. */
+
+    //=========================================================================================================
+    /**
+    * Allocation and reuse counters of the pool.
+    */
+    struct Counters {
+        qint32 allocations;     /**< Blocks for which new matrix storage was allocated. */
+        qint32 reuses;          /**< Blocks served from a free list. */
+        qint32 releases;        /**< Blocks returned to a free list. */
+        qint32 discards;        /**< Blocks freed because the free list of their shape was full. */
+        qint32 idle;            /**< Blocks currently held in the free lists. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs an empty MatrixPool.
+    *
+    * @param [in] iMaxPerClass  Maximal number of idle blocks kept per shape.
+    */
+    explicit MatrixPool(qint32 iMaxPerClass = MATRIX_POOL_MAX_PER_CLASS);
+
+    //=========================================================================================================
+    /**
+    * Destroys the MatrixPool. Outstanding blocks stay valid.
+    */
+    ~MatrixPool();
+
+    //=========================================================================================================
+    /**
+    * Returns a block of the given shape. The content of a reused block is undefined.
+    *
+    * @param [in] iRows     Number of rows.
+    * @param [in] iCols     Number of columns.
+    *
+    * @return the block.
+    */
+    MatrixPtr acquire(qint32 iRows, qint32 iCols);
+
+    //=========================================================================================================
+    /**
+    * Returns a block holding a copy of the given matrix.
+    *
+    * @param [in] mat   The matrix to copy.
+    *
+    * @return the block.
+    */
+    MatrixPtr copy(const Eigen::MatrixXd& mat);
+
+    //=========================================================================================================
+    /**
+    * Fills the free list of a shape ahead of time.
+    *
+    * @param [in] iRows     Number of rows.
+    * @param [in] iCols     Number of columns.
+    * @param [in] iCount    Number of idle blocks to provide.
+    */
+    void reserve(qint32 iRows, qint32 iCols, qint32 iCount);
+
+    //=========================================================================================================
+    /**
+    * Frees all idle blocks.
+    */
+    void clear();
+
+    //=========================================================================================================
+    /**
+    * Returns the allocation and reuse counters.
+    *
+    * @return the counters.
+    */
+    Counters counters() const;
+
+    //=========================================================================================================
+    /**
+    * Sets the counters, except idle, to zero.
+    */
+    void resetCounters();
+
+    //=========================================================================================================
+    /**
+    * Returns the process wide pool which is shared by the buffers, measurements and processing classes.
+    *
+    * @return the global pool.
+    */
+    static MatrixPool& global();
+
+private:
+    /**
+    * The free lists and counters, shared with the outstanding blocks.
+    */
+    struct Storage {
+        QMutex                                          mutex;          /**< Guards the free lists. */
+        QHash<QPair<qint32, qint32>, QVector<Eigen::MatrixXd*> >    freeLists;      /**< Idle blocks per shape. */
+        qint32                                          iMaxPerClass;   /**< Maximal number of idle blocks per shape. */
+        QAtomicInt                                      iAllocations;   /**< See Counters. */
+        QAtomicInt                                      iReuses;        /**< See Counters. */
+        QAtomicInt                                      iReleases;      /**< See Counters. */
+        QAtomicInt                                      iDiscards;      /**< See Counters. */
+        QAtomicInt                                      iIdle;          /**< See Counters. */
+
+        ~Storage();
+    };
+
+    /**
+    * Deleter of the blocks - puts them back into the free list of their shape.
+    */
+    struct Recycler {
+        QSharedPointer<Storage> pStorage;   /**< The free lists to return to. */
+
+        void operator()(Eigen::MatrixXd* pMatrix) const;
+    };
+
+    QSharedPointer<Storage> m_pStorage;     /**< The free lists and counters. */
+};
+
+} // NAMESPACE
+
+#endif // MATRIXPOOL_H
@@ -0,0 +1,538 @@
+//=============================================================================================================
+/**
+* @file     matrixringbuffer.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    MatrixRingBuffer class declaration
+*
+*/
+
+#ifndef MATRIXRINGBUFFER_H
+#define MATRIXRINGBUFFER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "generics_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QWaitCondition>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define RING_MAX_WAIT_SLICE_MSEC    5       /**< Upper bound for a single sleep of a blocked producer or consumer. */
+#define RING_CACHE_LINE_SIZE        64      /**< Padding which keeps producer and consumer counters on separate cache lines. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE IOBuffer
+//=============================================================================================================
+
+namespace IOBuffer
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* Lock-free single-producer/single-consumer ring of preallocated matrix slots of a fixed shape. The producer
+* fills a slot in place (acquireWrite, commitWrite), the consumer processes it in place (acquireRead, release).
+* No data is copied and no memory is allocated after construction. Producer and consumer synchronize over
+* two atomic counters only; a mutex is touched only when one side has to block.
+*
+* Exactly one thread may call the write methods and exactly one thread may call the read methods.
+*
+* The number of slots is rounded up to a power of two. The free running counters are mapped to a slot with a
+* mask, so the mapping stays continuous when the counters wrap around at 2^32.
+*
+* @brief Lock-free SPSC matrix ring buffer
+*/
+template<typename _Tp>
+class MatrixRingBuffer
+{
+public:
+    typedef QSharedPointer<MatrixRingBuffer> SPtr;              /**< Shared pointer type for MatrixRingBuffer. */
+    typedef QSharedPointer<const MatrixRingBuffer> ConstSPtr;   /**< Const shared pointer type for MatrixRingBuffer. */
+
+    typedef Matrix<_Tp, Dynamic, Dynamic> MatrixType;           /**< The slot type. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a MatrixRingBuffer and allocates all slots.
+    *
+    * @param [in] uiNumSlots    Number of slots, rounded up to the next power of two.
+    * @param [in] uiRows        Number of rows of each slot.
+    * @param [in] uiCols        Number of columns of each slot.
+    */
+    explicit MatrixRingBuffer(quint32 uiNumSlots, quint32 uiRows, quint32 uiCols);
+
+    //=========================================================================================================
+    /**
+    * Destroys the MatrixRingBuffer.
+    */
+    ~MatrixRingBuffer();
+
+    //=========================================================================================================
+    /**
+    * Producer: Returns the next free slot without blocking.
+    *
+    * @return the slot to write to, NULL if the ring is full.
+    */
+    inline MatrixType* tryAcquireWrite();
+
+    //=========================================================================================================
+    /**
+    * Producer: Returns the next free slot, blocks until one is available.
+    *
+    * @param [in] msecs     Timeout in milliseconds, -1 waits forever.
+    *
+    * @return the slot to write to, NULL on timeout or when the ring was aborted.
+    */
+    MatrixType* acquireWrite(int msecs = -1);
+
+    //=========================================================================================================
+    /**
+    * Producer: Publishes the slot returned by the last acquireWrite to the consumer.
+    */
+    inline void commitWrite();
+
+    //=========================================================================================================
+    /**
+    * Consumer: Returns the oldest written slot without blocking.
+    *
+    * @return the slot to read from, NULL if the ring is empty.
+    */
+    inline MatrixType* tryAcquireRead();
+
+    //=========================================================================================================
+    /**
+    * Consumer: Returns the oldest written slot, blocks until one is available.
+    *
+    * @param [in] msecs     Timeout in milliseconds, -1 waits forever.
+    *
+    * @return the slot to read from, NULL on timeout or when the ring was aborted.
+    */
+    MatrixType* acquireRead(int msecs = -1);
+
+    //=========================================================================================================
+    /**
+    * Consumer: Hands the slot returned by the last acquireRead back to the producer.
+    */
+    inline void release();
+
+    //=========================================================================================================
+    /**
+    * Wakes blocked producers and consumers. All blocking calls return NULL until clear() is called.
+    * May be called from any thread.
+    */
+    void abort();
+
+    //=========================================================================================================
+    /**
+    * Whether the ring was aborted.
+    */
+    inline bool isAborted() const;
+
+    //=========================================================================================================
+    /**
+    * Drops all committed slots and resets the abort state. Only the consumer's counter is moved, so this is a
+    * consumer side call: the consumer must not access the ring concurrently, but the producer may keep writing.
+    */
+    void clear();
+
+    //=========================================================================================================
+    /**
+    * Number of written slots which were not released yet.
+    */
+    inline quint32 available() const;
+
+    //=========================================================================================================
+    /**
+    * Number of slots of the ring.
+    */
+    inline quint32 size() const;
+
+    //=========================================================================================================
+    /**
+    * Rows of the slots.
+    */
+    inline quint32 rows() const;
+
+    //=========================================================================================================
+    /**
+    * Cols of the slots.
+    */
+    inline quint32 cols() const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Wakes the other side if it is blocked.
+    */
+    inline void wakeWaiters();
+
+    //=========================================================================================================
+    /**
+    * Rounds up to the next power of two.
+    *
+    * @param [in] uiValue   The value to round.
+    *
+    * @return the smallest power of two which is not smaller than uiValue, at least 1.
+    */
+    static inline quint32 nextPowerOfTwo(quint32 uiValue);
+
+    quint32         m_uiNumSlots;           /**< Holds the number of slots, a power of two.*/
+    quint32         m_uiSlotMask;           /**< Holds m_uiNumSlots - 1, maps a counter to its slot.*/
+    quint32         m_uiRows;               /**< Holds the number of rows.*/
+    quint32         m_uiCols;               /**< Holds the number of cols.*/
+    MatrixType*     m_pSlots;               /**< Holds the preallocated slots.*/
+
+    char            m_cPadWrite[RING_CACHE_LINE_SIZE];
+    QAtomicInt      m_iWriteCount;          /**< Holds the number of committed slots, written by the producer only.*/
+    quint32         m_uiCachedReadCount;    /**< Holds the producer's last seen read count.*/
+
+    char            m_cPadRead[RING_CACHE_LINE_SIZE];
+    QAtomicInt      m_iReadCount;           /**< Holds the number of released slots, written by the consumer only.*/
+    quint32         m_uiCachedWriteCount;   /**< Holds the consumer's last seen write count.*/
+
+    char            m_cPadShared[RING_CACHE_LINE_SIZE];
+    QAtomicInt      m_iWaiters;             /**< Holds the number of blocked threads.*/
+    QAtomicInt      m_iAborted;             /**< Holds whether the ring was aborted.*/
+    QMutex          m_mutex;                /**< Guards the wait condition.*/
+    QWaitCondition  m_waitCondition;        /**< Wakes blocked threads.*/
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+template<typename _Tp>
+MatrixRingBuffer<_Tp>::MatrixRingBuffer(quint32 uiNumSlots, quint32 uiRows, quint32 uiCols)
+: m_uiNumSlots(nextPowerOfTwo(uiNumSlots))
+, m_uiSlotMask(m_uiNumSlots - 1)
+, m_uiRows(uiRows)
+, m_uiCols(uiCols)
+, m_pSlots(new MatrixType[m_uiNumSlots])
+, m_iWriteCount(0)
+, m_uiCachedReadCount(0)
+, m_iReadCount(0)
+, m_uiCachedWriteCount(0)
+, m_iWaiters(0)
+, m_iAborted(0)
+{
+    for(quint32 i = 0; i < m_uiNumSlots; ++i)
+        m_pSlots[i] = MatrixType::Zero(m_uiRows, m_uiCols);
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+MatrixRingBuffer<_Tp>::~MatrixRingBuffer()
+{
+    abort();
+    delete [] m_pSlots;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline typename MatrixRingBuffer<_Tp>::MatrixType* MatrixRingBuffer<_Tp>::tryAcquireWrite()
+{
+    quint32 t_uiWriteCount = (quint32)m_iWriteCount.load();
+
+    //Only reload the consumer's counter when the cached one says the ring is full
+    if(t_uiWriteCount - m_uiCachedReadCount >= m_uiNumSlots)
+    {
+        m_uiCachedReadCount = (quint32)m_iReadCount.loadAcquire();
+        if(t_uiWriteCount - m_uiCachedReadCount >= m_uiNumSlots)
+            return NULL;
+    }
+
+    return &m_pSlots[t_uiWriteCount & m_uiSlotMask];
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+typename MatrixRingBuffer<_Tp>::MatrixType* MatrixRingBuffer<_Tp>::acquireWrite(int msecs)
+{
+    if(m_iAborted.loadAcquire())
+        return NULL;
+
+    MatrixType* t_pSlot = tryAcquireWrite();
+    if(t_pSlot || msecs == 0)
+        return t_pSlot;
+
+    QElapsedTimer t_timer;
+    t_timer.start();
+
+    QMutexLocker t_locker(&m_mutex);
+    m_iWaiters.fetchAndAddOrdered(1);
+
+    //Sleep in bounded slices - a wake up which crosses the registration is caught by the next check
+    while(!(t_pSlot = tryAcquireWrite()) && !m_iAborted.loadAcquire())
+    {
+        int t_iWait = RING_MAX_WAIT_SLICE_MSEC;
+        if(msecs > 0)
+        {
+            qint64 t_iRemaining = msecs - t_timer.elapsed();
+            if(t_iRemaining <= 0)
+                break;
+            t_iWait = qMin(t_iWait, (int)t_iRemaining);
+        }
+        m_waitCondition.wait(&m_mutex, t_iWait);
+    }
+
+    m_iWaiters.fetchAndAddOrdered(-1);
+
+    return m_iAborted.loadAcquire() ? NULL : t_pSlot;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void MatrixRingBuffer<_Tp>::commitWrite()
+{
+    m_iWriteCount.fetchAndAddOrdered(1);
+    wakeWaiters();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline typename MatrixRingBuffer<_Tp>::MatrixType* MatrixRingBuffer<_Tp>::tryAcquireRead()
+{
+    quint32 t_uiReadCount = (quint32)m_iReadCount.load();
+
+    //Only reload the producer's counter when the cached one says the ring is empty
+    if(t_uiReadCount == m_uiCachedWriteCount)
+    {
+        m_uiCachedWriteCount = (quint32)m_iWriteCount.loadAcquire();
+        if(t_uiReadCount == m_uiCachedWriteCount)
+            return NULL;
+    }
+
+    return &m_pSlots[t_uiReadCount & m_uiSlotMask];
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+typename MatrixRingBuffer<_Tp>::MatrixType* MatrixRingBuffer<_Tp>::acquireRead(int msecs)
+{
+    if(m_iAborted.loadAcquire())
+        return NULL;
+
+    MatrixType* t_pSlot = tryAcquireRead();
+    if(t_pSlot || msecs == 0)
+        return t_pSlot;
+
+    QElapsedTimer t_timer;
+    t_timer.start();
+
+    QMutexLocker t_locker(&m_mutex);
+    m_iWaiters.fetchAndAddOrdered(1);
+
+    while(!(t_pSlot = tryAcquireRead()) && !m_iAborted.loadAcquire())
+    {
+        int t_iWait = RING_MAX_WAIT_SLICE_MSEC;
+        if(msecs > 0)
+        {
+            qint64 t_iRemaining = msecs - t_timer.elapsed();
+            if(t_iRemaining <= 0)
+                break;
+            t_iWait = qMin(t_iWait, (int)t_iRemaining);
+        }
+        m_waitCondition.wait(&m_mutex, t_iWait);
+    }
+
+    m_iWaiters.fetchAndAddOrdered(-1);
+
+    return m_iAborted.loadAcquire() ? NULL : t_pSlot;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void MatrixRingBuffer<_Tp>::release()
+{
+    m_iReadCount.fetchAndAddOrdered(1);
+    wakeWaiters();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+void MatrixRingBuffer<_Tp>::abort()
+{
+    m_iAborted.storeRelease(1);
+
+    QMutexLocker t_locker(&m_mutex);
+    m_waitCondition.wakeAll();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline bool MatrixRingBuffer<_Tp>::isAborted() const
+{
+    return m_iAborted.loadAcquire() != 0;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+void MatrixRingBuffer<_Tp>::clear()
+{
+    //Catch up with the producer instead of resetting its counter, a concurrent commitWrite stays valid
+    m_uiCachedWriteCount = (quint32)m_iWriteCount.loadAcquire();
+    m_iReadCount.storeRelease((qint32)m_uiCachedWriteCount);
+    m_iAborted.storeRelease(0);
+
+    //A producer may wait for free slots
+    wakeWaiters();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 MatrixRingBuffer<_Tp>::available() const
+{
+    return (quint32)m_iWriteCount.loadAcquire() - (quint32)m_iReadCount.loadAcquire();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 MatrixRingBuffer<_Tp>::size() const
+{
+    return m_uiNumSlots;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 MatrixRingBuffer<_Tp>::rows() const
+{
+    return m_uiRows;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 MatrixRingBuffer<_Tp>::cols() const
+{
+    return m_uiCols;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 MatrixRingBuffer<_Tp>::nextPowerOfTwo(quint32 uiValue)
+{
+    quint32 t_uiPower = 1;
+    while(t_uiPower < uiValue && t_uiPower < 0x80000000u)
+        t_uiPower <<= 1;
+    return t_uiPower;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void MatrixRingBuffer<_Tp>::wakeWaiters()
+{
+    //The fast path stays lock-free as long as nobody sleeps
+    if(m_iWaiters.loadAcquire() > 0)
+    {
+        QMutexLocker t_locker(&m_mutex);
+        m_waitCondition.wakeAll();
+    }
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// TYPEDEF
+//=============================================================================================================
+
+typedef GENERICSSHARED_EXPORT MatrixRingBuffer<float>      _float_MatrixRingBuffer;        /**< Defines MatrixRingBuffer of float type.*/
+typedef GENERICSSHARED_EXPORT MatrixRingBuffer<double>     _double_MatrixRingBuffer;       /**< Defines MatrixRingBuffer of double type.*/
+
+} // NAMESPACE
+
+#endif // MATRIXRINGBUFFER_H
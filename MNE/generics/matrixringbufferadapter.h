@@ -0,0 +1,373 @@
+//=============================================================================================================
+/**
+* @file     matrixringbufferadapter.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    MatrixRingBufferAdapter class declaration
+*
+*/
+
+#ifndef MATRIXRINGBUFFERADAPTER_H
+#define MATRIXRINGBUFFERADAPTER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "generics_global.h"
+#include "buffer.h"
+#include "matrixringbuffer.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <typeinfo>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QAtomicInt>
+#include <QSharedPointer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define ADAPTER_RELEASE_POLL_MSEC   10      /**< Interval in which blocked push and pop calls check for a release request. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE IOBuffer
+//=============================================================================================================
+
+namespace IOBuffer
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* Drop-in replacement for CircularMatrixBuffer which stores the matrices in a MatrixRingBuffer. push and pop
+* keep their copying semantics, but copy each matrix in one go instead of element by element. Call sites
+* which switched to the adapter can move to the zero-copy interface of ring() one by one.
+*
+* Like the ring, the adapter supports a single producer and a single consumer thread.
+*
+* @brief Adapter with the CircularMatrixBuffer interface on top of a MatrixRingBuffer
+*/
+template<typename _Tp>
+class MatrixRingBufferAdapter : public Buffer
+{
+public:
+    typedef QSharedPointer<MatrixRingBufferAdapter> SPtr;              /**< Shared pointer type for MatrixRingBufferAdapter. */
+    typedef QSharedPointer<const MatrixRingBufferAdapter> ConstSPtr;   /**< Const shared pointer type for MatrixRingBufferAdapter. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a MatrixRingBufferAdapter.
+    *
+    * @param [in] uiMaxNumMatrices  length of buffer.
+    * @param [in] uiRows            Number of rows.
+    * @param [in] uiCols            Number of columns.
+    */
+    explicit MatrixRingBufferAdapter(unsigned int uiMaxNumMatrices, unsigned int uiRows, unsigned int uiCols);
+
+    //=========================================================================================================
+    /**
+    * Adds a whole matrix at the end buffer. Matrices of a wrong size are skipped.
+    *
+    * @param [in] pMatrix pointer to a Matrix which should be apend to the end.
+    */
+    inline void push(const Matrix<_Tp, Dynamic, Dynamic>* pMatrix);
+
+    //=========================================================================================================
+    /**
+    * Returns the first matrix (first in first out).
+    *
+    * @return the first matrix
+    */
+    inline Matrix<_Tp, Dynamic, Dynamic> pop();
+
+    //=========================================================================================================
+    /**
+    * Copies the first matrix (first in first out) into the given matrix without allocating if its shape fits.
+    *
+    * @param [out] matrix   the matrix to fill, resized if necessary.
+    */
+    inline void pop(Matrix<_Tp, Dynamic, Dynamic>& matrix);
+
+    //=========================================================================================================
+    /**
+    * Clears the buffer.
+    */
+    void clear();
+
+    //=========================================================================================================
+    /**
+    * Size of the buffer.
+    */
+    inline quint32 size() const;
+
+    //=========================================================================================================
+    /**
+    * Rows of the stored matrices of the buffer.
+    */
+    inline quint32 rows() const;
+
+    //=========================================================================================================
+    /**
+    * Cols of the stored matrices of the buffer.
+    */
+    inline quint32 cols() const;
+
+    //=========================================================================================================
+    /**
+    * Pauses the buffer. Skips any incoming matrices and only pops zero matrices.
+    */
+    inline void pause(bool);
+
+    //=========================================================================================================
+    /**
+    * Releases a pop() which waits for data. The released pop returns a zero matrix.
+    *
+    * @return true if the buffer was empty, i.e. a pop had to be released, otherwise false.
+    */
+    inline bool releaseFromPop();
+
+    //=========================================================================================================
+    /**
+    * Releases a push() which waits for a free slot. The released push drops its matrix.
+    *
+    * @return true if the buffer was full, i.e. a push had to be released, otherwise false.
+    */
+    inline bool releaseFromPush();
+
+    //=========================================================================================================
+    /**
+    * The underlying ring, for call sites which move to the zero-copy interface.
+    */
+    inline MatrixRingBuffer<_Tp>& ring();
+
+private:
+    MatrixRingBuffer<_Tp>   m_ring;             /**< Holds the matrix slots.*/
+    QAtomicInt              m_iReleasePop;      /**< Holds a pending release request for pop.*/
+    QAtomicInt              m_iReleasePush;     /**< Holds a pending release request for push.*/
+    bool                    m_bPause;
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+template<typename _Tp>
+MatrixRingBufferAdapter<_Tp>::MatrixRingBufferAdapter(unsigned int uiMaxNumMatrices, unsigned int uiRows, unsigned int uiCols)
+: Buffer(typeid(_Tp).name())
+, m_ring(uiMaxNumMatrices, uiRows, uiCols)
+, m_iReleasePop(0)
+, m_iReleasePush(0)
+, m_bPause(false)
+{
+
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void MatrixRingBufferAdapter<_Tp>::push(const Matrix<_Tp, Dynamic, Dynamic>* pMatrix)
+{
+    if(m_bPause || (quint32)pMatrix->rows() != m_ring.rows() || (quint32)pMatrix->cols() != m_ring.cols())
+        return;
+
+    Matrix<_Tp, Dynamic, Dynamic>* t_pSlot;
+    while(!(t_pSlot = m_ring.acquireWrite(ADAPTER_RELEASE_POLL_MSEC)))
+        if(m_iReleasePush.testAndSetOrdered(1, 0) || m_ring.isAborted())
+            return;
+
+    *t_pSlot = *pMatrix;
+    m_ring.commitWrite();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline Matrix<_Tp, Dynamic, Dynamic> MatrixRingBufferAdapter<_Tp>::pop()
+{
+    Matrix<_Tp, Dynamic, Dynamic> matrix(m_ring.rows(), m_ring.cols());
+
+    pop(matrix);
+
+    return matrix;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void MatrixRingBufferAdapter<_Tp>::pop(Matrix<_Tp, Dynamic, Dynamic>& matrix)
+{
+    if(!m_bPause)
+    {
+        Matrix<_Tp, Dynamic, Dynamic>* t_pSlot;
+        while(!(t_pSlot = m_ring.acquireRead(ADAPTER_RELEASE_POLL_MSEC)))
+        {
+            if(m_iReleasePop.testAndSetOrdered(1, 0) || m_ring.isAborted())
+            {
+                matrix.setZero(m_ring.rows(), m_ring.cols());
+                return;
+            }
+        }
+
+        //Same shape - the assignment copies without allocating
+        matrix = *t_pSlot;
+        m_ring.release();
+        return;
+    }
+
+    matrix.setZero(m_ring.rows(), m_ring.cols());
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+void MatrixRingBufferAdapter<_Tp>::clear()
+{
+    m_ring.clear();
+    m_iReleasePop.storeRelease(0);
+    m_iReleasePush.storeRelease(0);
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 MatrixRingBufferAdapter<_Tp>::size() const
+{
+    return m_ring.size();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 MatrixRingBufferAdapter<_Tp>::rows() const
+{
+    return m_ring.rows();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 MatrixRingBufferAdapter<_Tp>::cols() const
+{
+    return m_ring.cols();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void MatrixRingBufferAdapter<_Tp>::pause(bool bPause)
+{
+    m_bPause = bPause;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline bool MatrixRingBufferAdapter<_Tp>::releaseFromPop()
+{
+    if(m_ring.available() == 0)
+    {
+        m_iReleasePop.storeRelease(1);
+        return true;
+    }
+
+    return false;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline bool MatrixRingBufferAdapter<_Tp>::releaseFromPush()
+{
+    if(m_ring.available() >= m_ring.size())
+    {
+        m_iReleasePush.storeRelease(1);
+        return true;
+    }
+
+    return false;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline MatrixRingBuffer<_Tp>& MatrixRingBufferAdapter<_Tp>::ring()
+{
+    return m_ring;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// TYPEDEF
+//=============================================================================================================
+
+typedef GENERICSSHARED_EXPORT MatrixRingBufferAdapter<float>       _float_MatrixRingBufferAdapter;     /**< Defines MatrixRingBufferAdapter of float type.*/
+typedef GENERICSSHARED_EXPORT MatrixRingBufferAdapter<double>      _double_MatrixRingBufferAdapter;    /**< Defines MatrixRingBufferAdapter of double type.*/
+
+} // NAMESPACE
+
+#endif // MATRIXRINGBUFFERADAPTER_H
@@ -163,15 +163,18 @@ void RtClient::run()
 //    qDebug() << t_cmdClient.readAvailableData();
 
 
-    // read meas info
+    // request meas info and start measurement within one round trip - the data port delivers the info first
     t_cmdClient["measinfo"].pValues()[0].setValue(clientId);
-    t_cmdClient["measinfo"].send();
+    t_cmdClient["start"].pValues()[0].setValue(clientId);
+
+    QList<Command> t_qListSessionCommands;
+    t_qListSessionCommands << t_cmdClient["measinfo"] << t_cmdClient["start"];
+    QFuture<QStringList> t_futureSession = t_cmdClient.sendCommandsAsync(t_qListSessionCommands);
 
+    // read meas info
     m_pFiffInfo = t_dataClient.readInfo();
 
-    // start measurement
-    t_cmdClient["start"].pValues()[0].setValue(clientId);
-    t_cmdClient["start"].send();
+    t_cmdClient.waitForReplies(t_futureSession);
 
     while(m_bIsRunning)
     {
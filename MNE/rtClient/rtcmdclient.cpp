@@ -48,6 +48,9 @@
 //=============================================================================================================
 
 #include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QThread>
 
 #include <iostream>
@@ -69,9 +72,19 @@ using namespace RTCLIENTLIB;
 
 RtCmdClient::RtCmdClient(QObject *parent) :
         QTcpSocket(parent)
+      , m_iNextRequestId(0)
+      , m_iBlockSize(0)
+      , m_bSyncReplyReceived(false)
+      , m_bRawRead(false)
 {
     QObject::connect(&m_commandManager, &CommandManager::triggered, this,
             &RtCmdClient::sendCommandJSON);
+
+    QObject::connect(this, &QTcpSocket::readyRead, this, &RtCmdClient::readReplies);
+    QObject::connect(this, &QTcpSocket::disconnected, this, &RtCmdClient::checkTimeouts);
+
+    m_qTimerTimeout.setInterval(100);
+    QObject::connect(&m_qTimerTimeout, &QTimer::timeout, this, &RtCmdClient::checkTimeouts);
 }
 
 //*************************************************************************************************************
@@ -90,6 +103,8 @@ QString RtCmdClient::sendCLICommand(const QString &p_sCommand)
 
     if (this->state() == QAbstractSocket::ConnectedState)
     {
+        m_bRawRead = true;
+
         this->write(t_sCommand.toUtf8().constData(), t_sCommand.size());
         this->waitForBytesWritten();
 
@@ -102,6 +117,8 @@ QString RtCmdClient::sendCLICommand(const QString &p_sCommand)
             t_qByteArrayRaw += this->readAll();
 
         p_sReply = QString(t_qByteArrayRaw);
+
+        m_bRawRead = false;
     }
     return p_sReply;
 }
@@ -131,29 +148,17 @@ void RtCmdClient::sendCommandJSON(const Command &p_command)
         this->write(block);
         this->waitForBytesWritten();
 
-        // Receive response
-        QDataStream in(this);
-        in.setVersion(QDataStream::Qt_5_1);
-
-        quint16 blockSize = 0;
+        // Receive response - replies of pipelined requests which arrive meanwhile are dispatched to their futures
+        m_bSyncReplyReceived = false;
+        readReplies();
 
-        bool respComplete = false;
-
-        do
+        while(!m_bSyncReplyReceived && this->state() == QAbstractSocket::ConnectedState)
         {
             this->waitForReadyRead(100);
+            readReplies();
+        }
 
-            if (blockSize == 0)
-            {
-                if (this->bytesAvailable() >= (int)sizeof(quint16))
-                    in >> blockSize;
-            }
-            else if(this->bytesAvailable() >= blockSize)
-            {
-                in >> t_sReply;
-                respComplete = true;
-            }
-        } while (!respComplete && blockSize < 65000);//Sanity Check -> allowed maximal blocksize is 65.000
+        t_sReply = m_sSyncReply;
 #else
         this->write(t_sCommand.toUtf8().constData(), t_sCommand.size());
         this->waitForBytesWritten();
@@ -190,6 +195,183 @@ void RtCmdClient::sendCommandJSON(const Command &p_command)
 }
 
 
+//*************************************************************************************************************
+
+QFuture<QStringList> RtCmdClient::sendCommandsAsync(const QList<Command> &p_qListCommands, qint32 p_iTimeoutMs)
+{
+    QFutureInterface<QStringList> t_futureInterface;
+    t_futureInterface.reportStarted();
+
+    if (this->state() != QAbstractSocket::ConnectedState || p_qListCommands.isEmpty())
+    {
+        if(p_qListCommands.size() > 0)
+            qWarning() << "Request was not send, because client is not connected!";
+        t_futureInterface.reportCanceled();
+        t_futureInterface.reportFinished();
+        return t_futureInterface.future();
+    }
+
+    qint32 t_iRequestId = m_iNextRequestId++;
+
+    QStringList t_qListCommands;
+    for(qint32 i = 0; i < p_qListCommands.size(); ++i)
+        t_qListCommands.append(QString("{%1}").arg(p_qListCommands[i].toStringReadySend()));
+
+    const QString t_sRequest = QString("{\"id\":%1,\"commands\":[%2]}\n").arg(t_iRequestId).arg(t_qListCommands.join(","));
+
+    PendingRequest t_pendingRequest;
+    t_pendingRequest.futureInterface = t_futureInterface;
+    t_pendingRequest.deadline = p_iTimeoutMs < 0 ? -1 : QDateTime::currentMSecsSinceEpoch() + p_iTimeoutMs;
+    m_qMapPendingRequests.insert(t_iRequestId, t_pendingRequest);
+
+    QByteArray block;
+    QDataStream out(&block, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_1);
+
+    out << (quint16)0;
+    out << t_sRequest;
+    out.device()->seek(0);
+    out << (quint16)(block.size() - sizeof(quint16));
+
+    // Do not block - flush whatever the socket accepts right now, the rest is sent by the event loop or
+    // during the next wait
+    this->write(block);
+    this->flush();
+
+    // Timers can only be started from the thread the client lives in
+    if(!m_qTimerTimeout.isActive() && QThread::currentThread() == this->thread())
+        m_qTimerTimeout.start();
+
+    return t_futureInterface.future();
+}
+
+
+//*************************************************************************************************************
+
+QFuture<QStringList> RtCmdClient::sendCommandAsync(const Command &p_command, qint32 p_iTimeoutMs)
+{
+    QList<Command> t_qListCommands;
+    t_qListCommands.append(p_command);
+    return sendCommandsAsync(t_qListCommands, p_iTimeoutMs);
+}
+
+
+//*************************************************************************************************************
+
+bool RtCmdClient::waitForReplies(const QFuture<QStringList> &p_future, qint32 msecs)
+{
+    qint64 t_msecsStart = QDateTime::currentMSecsSinceEpoch();
+
+    readReplies();
+    checkTimeouts();
+
+    while(!p_future.isFinished())
+    {
+        if(msecs != -1 && QDateTime::currentMSecsSinceEpoch() - t_msecsStart > msecs)
+            return false;
+
+        this->waitForReadyRead(100);
+        readReplies();
+        checkTimeouts();
+    }
+
+    return !p_future.isCanceled();
+}
+
+
+//*************************************************************************************************************
+
+void RtCmdClient::readReplies()
+{
+    if(m_bRawRead)
+        return;
+
+    QDataStream in(this);
+    in.setVersion(QDataStream::Qt_5_1);
+
+    forever
+    {
+        if(m_iBlockSize == 0)
+        {
+            if(this->bytesAvailable() < (int)sizeof(quint16))
+                return;
+            in >> m_iBlockSize;
+        }
+
+        if(this->bytesAvailable() < m_iBlockSize)
+            return;
+
+        QString t_sReply;
+        in >> t_sReply;
+        m_iBlockSize = 0;
+
+        dispatchReply(t_sReply);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void RtCmdClient::dispatchReply(const QString &p_sReply)
+{
+    if(!m_qMapPendingRequests.isEmpty() && p_sReply.startsWith('{'))
+    {
+        QJsonDocument t_jsonDocument = QJsonDocument::fromJson(p_sReply.toUtf8());
+
+        if(t_jsonDocument.isObject() && t_jsonDocument.object().value(QString("replies")).isArray())
+        {
+            qint32 t_iRequestId = (qint32)t_jsonDocument.object().value(QString("id")).toDouble();
+
+            if(m_qMapPendingRequests.contains(t_iRequestId))
+            {
+                PendingRequest t_pendingRequest = m_qMapPendingRequests.take(t_iRequestId);
+
+                QStringList t_qListReplies;
+                QJsonArray t_jsonArrayReplies = t_jsonDocument.object().value(QString("replies")).toArray();
+                for(qint32 i = 0; i < t_jsonArrayReplies.size(); ++i)
+                    t_qListReplies.append(t_jsonArrayReplies[i].toObject().value(QString("reply")).toString());
+
+                t_pendingRequest.futureInterface.reportResult(t_qListReplies);
+                t_pendingRequest.futureInterface.reportFinished();
+            }
+            return;
+        }
+    }
+
+    m_sSyncReply = p_sReply;
+    m_bSyncReplyReceived = true;
+}
+
+
+//*************************************************************************************************************
+
+void RtCmdClient::checkTimeouts()
+{
+    bool t_bConnected = this->state() == QAbstractSocket::ConnectedState;
+    qint64 t_msecsNow = QDateTime::currentMSecsSinceEpoch();
+
+    if(!t_bConnected)
+        m_iBlockSize = 0;
+
+    QMap<qint32, PendingRequest>::Iterator it = m_qMapPendingRequests.begin();
+    while(it != m_qMapPendingRequests.end())
+    {
+        if(!t_bConnected || (it.value().deadline >= 0 && t_msecsNow > it.value().deadline))
+        {
+            qWarning() << "Request" << it.key() << (t_bConnected ? "timed out." : "canceled, because client is not connected.");
+            it.value().futureInterface.reportCanceled();
+            it.value().futureInterface.reportFinished();
+            it = m_qMapPendingRequests.erase(it);
+        }
+        else
+            ++it;
+    }
+
+    if(m_qMapPendingRequests.isEmpty() && m_qTimerTimeout.isActive() && QThread::currentThread() == this->thread())
+        m_qTimerTimeout.stop();
+}
+
+
 //*************************************************************************************************************
 
 qint32 RtCmdClient::requestBufsize()
@@ -55,10 +55,16 @@
 //=============================================================================================================
 
 #include <QDataStream>
+#include <QFuture>
+#include <QFutureInterface>
+#include <QList>
+#include <QMap>
 #include <QMutex>
 #include <QSharedPointer>
 #include <QString>
+#include <QStringList>
 #include <QTcpSocket>
+#include <QTimer>
 
 
 //*************************************************************************************************************
@@ -136,6 +142,51 @@ public:
     */
     void sendCommandJSON(const Command &p_command);
 
+    //=========================================================================================================
+    /**
+    * Sends several commands as one pipelined request without blocking the calling thread. The mne_rt_server
+    * executes the commands in the given order and answers with all replies at once, i.e., the whole list costs a
+    * single round trip. Use a QFutureWatcher to get notified when the replies arrived, or waitForReplies() when
+    * no event loop is running.
+    *
+    * @param[in] p_qListCommands    The commands to send, in execution order.
+    * @param[in] p_iTimeoutMs       Time in milliseconds after which the request is canceled, -1 for no timeout.
+    *
+    * @return future holding one reply per command; it is canceled on timeout or when the client is not connected.
+    */
+    QFuture<QStringList> sendCommandsAsync(const QList<Command> &p_qListCommands, qint32 p_iTimeoutMs = 30000);
+
+    //=========================================================================================================
+    /**
+    * Sends a single command without blocking the calling thread.
+    *
+    * @param[in] p_command      The command to send.
+    * @param[in] p_iTimeoutMs   Time in milliseconds after which the request is canceled, -1 for no timeout.
+    *
+    * @return future holding the reply of the command.
+    */
+    QFuture<QStringList> sendCommandAsync(const Command &p_command, qint32 p_iTimeoutMs = 30000);
+
+    //=========================================================================================================
+    /**
+    * Processes incoming replies until the given future is finished. This is meant for threads without an event
+    * loop; the replies of all other pending requests which arrive meanwhile are dispatched as well.
+    *
+    * @param[in] p_future   Future returned by sendCommandsAsync.
+    * @param[in] msecs      Time to wait in milliseconds, if -1 function will not time out. Default value is 30000.
+    *
+    * @return true if the replies were received, false on timeout or cancellation.
+    */
+    bool waitForReplies(const QFuture<QStringList> &p_future, qint32 msecs = 30000);
+
+    //=========================================================================================================
+    /**
+    * Returns the number of pipelined requests which are still waiting for their replies.
+    *
+    * @return the number of pending requests.
+    */
+    inline qint32 pendingRequests() const;
+
     //=========================================================================================================
     /**
     * Returns the available data.
@@ -206,9 +257,48 @@ signals:
     void response(QString p_sResponse);
 
 private:
+    //=========================================================================================================
+    /**
+    * Reads all completely received reply blocks from the socket and dispatches them.
+    */
+    void readReplies();
+
+    //=========================================================================================================
+    /**
+    * Completes the pending request a pipelined reply belongs to, or stores a plain reply as the reply of the
+    * current synchronous command.
+    *
+    * @param[in] p_sReply   The received reply block.
+    */
+    void dispatchReply(const QString &p_sReply);
+
+    //=========================================================================================================
+    /**
+    * Cancels all pending requests which exceeded their timeout.
+    */
+    void checkTimeouts();
+
+    //=========================================================================================================
+    /**
+    * Pipelined request which waits for its replies.
+    */
+    struct PendingRequest
+    {
+        QFutureInterface<QStringList> futureInterface; /**< Reports the replies to the future handed to the caller. */
+        qint64 deadline;                                /**< Time since epoch in ms at which the request is canceled, -1 for none. */
+    };
+
     CommandManager  m_commandManager;   /**< The command manager. */
     QMutex          m_qMutex;           /**< Access serialization between threads */
     QString         m_sAvailableData;   /**< The last received response. */
+
+    QMap<qint32, PendingRequest> m_qMapPendingRequests; /**< Pipelined requests waiting for replies, by request id. */
+    qint32          m_iNextRequestId;   /**< Id of the next pipelined request. */
+    QTimer          m_qTimerTimeout;    /**< Checks the pending requests for timeouts while an event loop is running. */
+    quint16         m_iBlockSize;       /**< Size of the reply block which is currently received, 0 if none. */
+    QString         m_sSyncReply;       /**< Last reply which does not belong to a pipelined request. */
+    bool            m_bSyncReplyReceived;   /**< Whether m_sSyncReply was received since the last synchronous command. */
+    bool            m_bRawRead;         /**< Whether a CLI command reads the socket directly. */
 };
 
 //*************************************************************************************************************
@@ -234,6 +324,14 @@ inline bool RtCmdClient::hasCommand(const QString &p_sCommand) const
     return m_commandManager.hasCommand(p_sCommand);
 }
 
+
+//*************************************************************************************************************
+
+inline qint32 RtCmdClient::pendingRequests() const
+{
+    return m_qMapPendingRequests.size();
+}
+
 } // NAMESPACE
 
 #endif // RTCMDCLIENT_H
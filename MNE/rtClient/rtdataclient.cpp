@@ -59,6 +59,7 @@ using namespace RTCLIENTLIB;
 RtDataClient::RtDataClient(QObject *parent)
 : QTcpSocket(parent)
 , m_clientID(-1)
+, m_iMissedBuffers(0)
 {
     getClientId();
 }
@@ -78,6 +79,8 @@ void RtDataClient::disconnectFromHost()
 {
     QTcpSocket::disconnectFromHost();
     m_clientID = -1;
+    m_lastBufferInfo = FiffRtBufferInfo();
+    m_iMissedBuffers = 0;
 }
 
 
@@ -370,6 +373,21 @@ void RtDataClient::readRawBuffer(qint32 p_nChannels, MatrixXf& data, fiff_int_t&
 
     FiffTag::read_rt_tag(&t_fiffStream, t_pTag);
 
+    //
+    // Buffer info precedes the data buffer
+    //
+    if(t_pTag->kind == FIFF_MNE_RT_BUFFER_INFO)
+    {
+        FiffRtBufferInfo t_bufferInfo = t_pTag->toRtBufferInfo();
+
+        if(m_lastBufferInfo.isValid() && t_bufferInfo.sequence > m_lastBufferInfo.sequence + 1)
+            m_iMissedBuffers += t_bufferInfo.sequence - m_lastBufferInfo.sequence - 1;
+
+        m_lastBufferInfo = t_bufferInfo;
+
+        FiffTag::read_rt_tag(&t_fiffStream, t_pTag);
+    }
+
     kind = t_pTag->kind;
 
     if(kind == FIFF_DATA_BUFFER)
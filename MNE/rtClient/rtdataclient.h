@@ -54,6 +54,7 @@
 #include <fiff/fiff_stream.h>
 #include <fiff/fiff_info.h>
 #include <fiff/fiff_tag.h>
+#include <fiff/fiff_rt_buffer_info.h>
 
 
 //*************************************************************************************************************
@@ -138,7 +139,8 @@ public:
 
     //=========================================================================================================
     /**
-    * Reads fiff measurement information of a data the connection
+    * Reads the next raw buffer of the data connection. A FIFF_MNE_RT_BUFFER_INFO tag, which precedes the
+    * data buffer, is consumed and its content is available via lastBufferInfo().
     *
     * @param[in] p_nChannels    Number of channels to reshape the received data
     * @param[out] data          The read data - ToDo change this to raw buffer data object
@@ -154,8 +156,27 @@ public:
     */
     void setClientAlias(const QString &p_sAlias);
 
+    //=========================================================================================================
+    /**
+    * Returns the sequence number and acquisition time of the last read raw buffer. The info is invalid if
+    * the mne_rt_server does not send buffer infos.
+    *
+    * @return the info of the last read raw buffer.
+    */
+    inline const FiffRtBufferInfo& lastBufferInfo() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of raw buffers, which were missed according to gaps in the sequence numbers.
+    *
+    * @return the number of missed raw buffers.
+    */
+    inline qint32 missedBuffers() const;
+
 private:
-    qint32 m_clientID;  /**< Corresponding client id of the data client at mne_rt_server */
+    qint32 m_clientID;                      /**< Corresponding client id of the data client at mne_rt_server */
+    FiffRtBufferInfo m_lastBufferInfo;      /**< Sequence number and acquisition time of the last read raw buffer. */
+    qint32 m_iMissedBuffers;                /**< Number of raw buffers missed according to the sequence numbers. */
 
 signals:
     
@@ -163,6 +184,25 @@ public slots:
     
 };
 
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline const FiffRtBufferInfo& RtDataClient::lastBufferInfo() const
+{
+    return m_lastBufferInfo;
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 RtDataClient::missedBuffers() const
+{
+    return m_iMissedBuffers;
+}
+
 } // NAMESPACE
 
 #endif // RTDATACLIENT_H
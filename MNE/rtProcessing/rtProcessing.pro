@@ -93,7 +93,11 @@ SOURCES += \
         rtave.cpp \
         rtnoise.cpp \
         rthpis.cpp \
-        rtfilter.cpp
+        rtfilter.cpp \
+        rtfirengine.cpp \
+        rtiirengine.cpp \
+        rtresampler.cpp \
+        rtlcmv.cpp
 
 HEADERS +=  \
         rtprocessing_global.h \
@@ -102,7 +106,11 @@ HEADERS +=  \
         rtave.h \
         rtnoise.h \
         rthpis.h \
-        rtfilter.h
+        rtfilter.h \
+        rtfirengine.h \
+        rtiirengine.h \
+        rtresampler.h \
+        rtlcmv.h
 
 INCLUDEPATH += $${EIGEN_INCLUDE_DIR}
 INCLUDEPATH += $${MNE_INCLUDE_DIR}
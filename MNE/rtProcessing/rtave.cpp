@@ -82,24 +82,26 @@ RtAve::RtAve(quint32 numAverages, quint32 p_iPreStimSamples, quint32 p_iPostStim
 , m_bIsRunning(false)
 , m_bAutoAspect(true)
 , m_fTriggerThreshold(0.5)
-, m_bFillingBackBuffer(false)
-, m_iTriggerIndex(-1)
-, m_iNewTriggerIndex(p_iTriggerIndex)
-, m_iTriggerPos(-1)
 , m_iAverageMode(0)
 , m_iNewAverageMode(0)
 , m_bDoBaselineCorrection(false)
 , m_pairBaselineSec(qMakePair(QVariant(QString::number(p_iBaselineFromSecs)),QVariant(QString::number(p_iBaselineToSecs))))
 , m_pStimEvoked(FiffEvoked::SPtr(new FiffEvoked))
-, m_iMatDataPostIdx(0)
 , m_iNumberCalcAverages(0)
 , m_iCurrentBlockSize(0)
+, m_iSampleCount(0)
 , m_dArtifactThreshold(300e-6)
 , m_bDoArtifactReduction(false)
+, m_bDoStdErr(false)
+, m_bNewDoStdErr(false)
+, m_bResetPending(false)
 {
     qRegisterMetaType<FiffEvoked::SPtr>("FiffEvoked::SPtr");
+    qRegisterMetaType<FiffEvokedSet::SPtr>("FiffEvokedSet::SPtr");
 
     init();
+
+    addCondition(p_iTriggerIndex);
 }
 
 
@@ -173,9 +175,55 @@ void RtAve::setPostStim(qint32 samples, qint32 secs)
 //*************************************************************************************************************
 
 void RtAve::setTriggerChIndx(qint32 idx)
+{
+    clearConditions();
+    addCondition(idx);
+}
+
+
+//*************************************************************************************************************
+
+void RtAve::addCondition(qint32 iTriggerChIdx, qint32 iTriggerValue, const QString& sComment)
+{
+    Condition t_condition;
+    t_condition.iTriggerChIdx = iTriggerChIdx;
+    t_condition.iTriggerValue = iTriggerValue;
+    t_condition.sComment = sComment;
+    t_condition.iOldestEpoch = 0;
+    t_condition.iCount = 0;
+    t_condition.iSinceResync = 0;
+    t_condition.bUpdated = false;
+
+    if(t_condition.sComment.isEmpty() && iTriggerChIdx >= 0 && iTriggerChIdx < m_pFiffInfo->chs.size()) {
+        t_condition.sComment = m_pFiffInfo->chs[iTriggerChIdx].ch_name;
+        if(iTriggerValue != 0)
+            t_condition.sComment += QString(":%1").arg(iTriggerValue);
+    }
+
+    m_qMutex.lock();
+    m_qListNewConditions.append(t_condition);
+    m_bResetPending = true;
+    m_qMutex.unlock();
+}
+
+
+//*************************************************************************************************************
+
+void RtAve::clearConditions()
+{
+    m_qMutex.lock();
+    m_qListNewConditions.clear();
+    m_bResetPending = true;
+    m_qMutex.unlock();
+}
+
+
+//*************************************************************************************************************
+
+void RtAve::setStdErrEstimation(bool bActivate)
 {
     m_qMutex.lock();
-    m_iNewTriggerIndex = idx;
+    m_bNewDoStdErr = bActivate;
     m_qMutex.unlock();
 }
 
@@ -277,97 +325,74 @@ bool RtAve::stop()
 void RtAve::run()
 {
     //Do initial reset
-    reset();
+    resetState();
 
     //Enter the main loop
     while(m_bIsRunning) {
         bool doProcessing = false;
+        bool doReset = false;
 
         m_qMutex.lock();
         if(m_pRawMatrixBuffer)
             doProcessing = true;
+
+        doReset = m_bResetPending
+                || m_iNewPreStimSamples != m_iPreStimSamples
+                || m_iNewPostStimSamples != m_iPostStimSamples
+                || m_iNewAverageMode != m_iAverageMode
+                || m_iNewNumAverages != m_iNumAverages
+                || m_bNewDoStdErr != m_bDoStdErr;
         m_qMutex.unlock();
 
         if(doProcessing) {
-            if(m_iNewPreStimSamples != m_iPreStimSamples
-                    || m_iNewPostStimSamples != m_iPostStimSamples
-                    || m_iNewTriggerIndex != m_iTriggerIndex
-                    || m_iNewAverageMode != m_iAverageMode
-                    || m_iNewNumAverages != m_iNumAverages)
-                reset();
+            if(doReset)
+                resetState();
 
             //Acquire Data
             MatrixXd rawSegment = m_pRawMatrixBuffer->pop();
 
-            //Fill back buffer and decide when to do the data packing of the different buffers
-            if(m_bFillingBackBuffer) {
-                if(m_iMatDataPostIdx == m_iPostStimSamples) {
-                    m_iMatDataPostIdx = 0;
-
-                    //Merge the different buffers
-                    mergeData();
+            if(rawSegment.cols() != m_iCurrentBlockSize) {
+                m_iCurrentBlockSize = rawSegment.cols();
+                resetRing();
+            }
 
-                    //Calculate the actual average
-                    generateEvoked();
+            //Queue the epochs of all conditions triggered in this block, then cut out those which are complete
+            detectTriggers(rawSegment);
+            fillRing(rawSegment);
+            processPendingEpochs();
 
-                    //If number of averages was reached emit new average
-                    if(m_qListStimAve.size() > 0)
-                        emit evokedStim(m_pStimEvoked);
+            generateEvoked();
+        }
+    }
+}
 
-                    m_bFillingBackBuffer = false;
 
-                    qDebug()<<"RtAve::run() - Number of calculated averages:"<<m_iNumberCalcAverages;
-                    qDebug()<<"RtAve::run() - m_qListStimAve.size():"<<m_qListStimAve.size();
-                } else {
-                    fillBackBuffer(rawSegment);
-                }
-            } else {
-                clearDetectedTriggers();
+//*************************************************************************************************************
 
-                //Detect trigger
-                m_iTriggerPos = -1;
-                QList<QPair<int,double> > lDetectedTriggers = DetectTrigger::detectTriggerFlanksGrad(rawSegment, m_iTriggerIndex, 0, m_fTriggerThreshold, true, "Rising");
+void RtAve::detectTriggers(const MatrixXd& data)
+{
+    if(data.cols() == 0)
+        return;
 
-                if(!lDetectedTriggers.isEmpty())
-                {
-                    m_iTriggerPos = lDetectedTriggers.at(0).first;
-                }
+    //If number of averages is equals zero do not perform averages - every block end triggers all conditions
+    if(m_iNumAverages == 0) {
+        for(int i = 0; i < m_vecConditions.size(); ++i)
+            m_qListPendingEpochs.append(qMakePair(m_iSampleCount + (qint64)data.cols() - 1, (qint32)i));
+        return;
+    }
 
-                //If number of averages is equals zero do not perform averages
-                if(m_iNumAverages == 0) {
-                    m_iTriggerPos = rawSegment.cols()-1;
-                }
+    //Event samples are counted from the last reset of the detector, which is reset together with the ring
+    const qint64 t_iOffset = m_iSampleCount - m_triggerDetector.sampleCount();
+    const QVector<TriggerDetector::Event>& t_vecEvents = m_triggerDetector.detect(data);
 
-                //If detected turn on filling of the back / post stim buffer
-                if(m_iTriggerPos != -1) {
-                    //Do front buffer stuff
-                    MatrixXd tempMat;
-
-                    if(m_iTriggerPos >= m_iPreStimSamples) {
-                        tempMat = rawSegment.block(0,m_iTriggerPos-m_iPreStimSamples,rawSegment.rows(),m_iPreStimSamples);
-                        fillFrontBuffer(tempMat);
-                    } else {
-                        tempMat = rawSegment.block(0,0,rawSegment.rows(),m_iTriggerPos);
-                        fillFrontBuffer(tempMat);
-                    }
-
-                    //Do back buffer stuff
-                    if(rawSegment.cols()-m_iTriggerPos >= m_matDataPost.cols()) {
-                        m_matDataPost = rawSegment.block(0,m_iTriggerPos,m_matDataPost.rows(),m_matDataPost.cols());
-                        m_iMatDataPostIdx = m_iPostStimSamples;
-                    } else {
-                        m_matDataPost.block(0,0,m_matDataPost.rows(),rawSegment.cols()-m_iTriggerPos) = rawSegment.block(0,m_iTriggerPos,rawSegment.rows(),rawSegment.cols()-m_iTriggerPos);
-                        m_iMatDataPostIdx = rawSegment.cols()-m_iTriggerPos;
-                    }
-
-                    m_bFillingBackBuffer = true;
-                } else {
-                    //Fill front / pre stim buffer
-                    fillFrontBuffer(rawSegment);
-                }
+    for(int j = 0; j < t_vecEvents.size(); ++j) {
+        const TriggerDetector::Event& t_event = t_vecEvents[j];
 
-                //qDebug()<<"Trigger channel "<<m_iTriggerIndex<<" found at "<<m_iTriggerPos;
-            }
+        //The value after the flank selects the condition
+        for(int i = 0; i < m_vecConditions.size(); ++i) {
+            const Condition& t_condition = m_vecConditions[i];
+            if(t_condition.iTriggerChIdx == t_event.iChannel && (t_condition.iTriggerValue == 0 || t_condition.iTriggerValue == t_event.iValue))
+                m_qListPendingEpochs.append(qMakePair(t_iOffset + t_event.iSample, (qint32)i));
         }
     }
 }
@@ -375,84 +400,129 @@ void RtAve::run()
 
 //*************************************************************************************************************
 
-void RtAve::clearDetectedTriggers()
+void RtAve::fillRing(const MatrixXd& data)
 {
-    QMutableMapIterator<int,QList<int> > i(m_qMapDetectedTrigger);
-    while (i.hasNext()) {
-        i.next();
-        i.value().clear();
-    }
-}
-
+    const qint32 t_iRingSize = m_matRing.cols();
+    const qint32 t_iPos = m_iSampleCount % t_iRingSize;
+    const qint32 t_iFirst = qMin((qint32)data.cols(), t_iRingSize - t_iPos);
 
-//*************************************************************************************************************
+    m_matRing.block(0, t_iPos, m_matRing.rows(), t_iFirst) = data.leftCols(t_iFirst);
+    if(t_iFirst < data.cols())
+        m_matRing.leftCols(data.cols() - t_iFirst) = data.rightCols(data.cols() - t_iFirst);
 
-void RtAve::fillBackBuffer(MatrixXd &data)
-{
-    int iResidualCols = data.cols();
-    if(m_iMatDataPostIdx+data.cols() > m_iPostStimSamples) {
-        iResidualCols = m_iPostStimSamples-m_iMatDataPostIdx;
-        m_matDataPost.block(0,m_iMatDataPostIdx,m_matDataPost.rows(),iResidualCols) = data.block(0,0,data.rows(),iResidualCols);
-    } else
-        m_matDataPost.block(0,m_iMatDataPostIdx,m_matDataPost.rows(),iResidualCols) = data;
-
-    m_iMatDataPostIdx += iResidualCols;
+    m_iSampleCount += data.cols();
 }
 
 
 //*************************************************************************************************************
 
-void RtAve::fillFrontBuffer(MatrixXd &data)
+void RtAve::processPendingEpochs()
 {
-    if(m_matDataPre.cols() <= data.cols()) {
-        m_matDataPre = data.block(0,data.cols()-m_iPreStimSamples,data.rows(),m_iPreStimSamples);
-    } else {
-        int residual = m_matDataPre.cols()-data.cols();
-
-        //Copy shift data
-        m_matDataPre.block(0,0,m_matDataPre.rows(),residual) = m_matDataPre.block(0,m_matDataPre.cols()-residual,m_matDataPre.rows(),residual);
+    const qint32 t_iEpochLength = m_iPreStimSamples + m_iPostStimSamples;
+    const qint32 t_iRingSize = m_matRing.cols();
+
+    QMutableListIterator<QPair<qint64,qint32> > it(m_qListPendingEpochs);
+    while(it.hasNext()) {
+        const QPair<qint64,qint32>& t_pending = it.next();
+        const qint64 t_iStart = t_pending.first - m_iPreStimSamples;
+
+        //Wait for the post stim data
+        if(t_iStart + t_iEpochLength > m_iSampleCount)
+            continue;
+
+        //Epochs reaching back before the last reset are dropped
+        if(t_iStart >= 0 && t_iStart >= m_iSampleCount - t_iRingSize) {
+            const qint32 t_iPos = t_iStart % t_iRingSize;
+            const qint32 t_iFirst = qMin(t_iEpochLength, t_iRingSize - t_iPos);
+
+            m_matEpoch.leftCols(t_iFirst) = m_matRing.block(0, t_iPos, m_matRing.rows(), t_iFirst);
+            if(t_iFirst < t_iEpochLength)
+                m_matEpoch.rightCols(t_iEpochLength - t_iFirst) = m_matRing.leftCols(t_iEpochLength - t_iFirst);
+
+            //Perform artifact threshold
+            if(!m_bDoArtifactReduction || !checkForArtifact(m_matEpoch, m_dArtifactThreshold))
+                addEpoch(m_vecConditions[t_pending.second], m_matEpoch);
+        }
 
-        //Copy new data in
-        m_matDataPre.block(0,residual,m_matDataPre.rows(),data.cols()) = data;
+        it.remove();
     }
 }
 
 
 //*************************************************************************************************************
 
-void RtAve::mergeData()
+void RtAve::addEpoch(Condition& condition, const MatrixXd& epoch)
 {
-    MatrixXd mergedData(m_matDataPre.rows(), m_matDataPre.cols()+m_matDataPost.cols());
+    if(m_iAverageMode == 0) {
+        const qint32 t_iWindow = m_iNumAverages > 0 ? m_iNumAverages : 1;
 
-    mergedData << m_matDataPre, m_matDataPost;
+        if(condition.iCount == t_iWindow) {
+            //Window is full - subtract the oldest epoch and overwrite it in place
+            MatrixXd& t_matOldest = condition.vecEpochs[condition.iOldestEpoch];
 
-    //Perform artifact threshold
-    bool bArtifactedDetected = false;
+            condition.matSum -= t_matOldest;
+            --condition.iCount;
 
-    if(m_bDoArtifactReduction) {
-       bArtifactedDetected = checkForArtifact(mergedData, m_dArtifactThreshold);
+            if(m_bDoStdErr) {
+                if(condition.iCount == 0) {
+                    condition.matMean.setZero();
+                    condition.matM2.setZero();
+                } else {
+                    m_matDelta = t_matOldest - condition.matMean;
+                    condition.matMean -= m_matDelta / condition.iCount;
+                    condition.matM2 -= m_matDelta.cwiseProduct(t_matOldest - condition.matMean);
+                }
+            }
+
+            t_matOldest = epoch;
+            condition.iOldestEpoch = (condition.iOldestEpoch + 1) % t_iWindow;
+            ++condition.iSinceResync;
+        } else {
+            condition.vecEpochs.append(epoch);
+        }
     }
 
-    if(bArtifactedDetected == false) {
-        //Add cut data to average buffer
-        m_qListStimAve.append(mergedData);
+    condition.matSum += epoch;
+    ++condition.iCount;
+
+    if(m_bDoStdErr) {
+        m_matDelta = epoch - condition.matMean;
+        condition.matMean += m_matDelta / condition.iCount;
+        condition.matM2 += m_matDelta.cwiseProduct(epoch - condition.matMean);
+    }
+
+    if(condition.iSinceResync >= RTAVE_RESYNC_EPOCHS)
+        resync(condition);
+
+    condition.bUpdated = true;
+    ++m_iNumberCalcAverages;
+}
 
-        //Pop data from buffer
-        if(m_qListStimAve.size() > m_iNumAverages && m_iNumAverages >= 1) {
-            m_qListStimAve.pop_front();
-        }
 
-        //Proceed a bit different if we use zero number of averages
-        if(m_qListStimAve.size() > 1 && m_iNumAverages == 0) {
-            m_qListStimAve.pop_front();
+//*************************************************************************************************************
+
+void RtAve::resync(Condition& condition)
+{
+    condition.matSum.setZero();
+    for(int i = 0; i < condition.vecEpochs.size(); ++i)
+        condition.matSum += condition.vecEpochs[i];
+
+    if(m_bDoStdErr) {
+        condition.matMean = condition.matSum / condition.iCount;
+        condition.matM2.setZero();
+        for(int i = 0; i < condition.vecEpochs.size(); ++i) {
+            m_matDelta = condition.vecEpochs[i] - condition.matMean;
+            condition.matM2 += m_matDelta.cwiseAbs2();
         }
     }
+
+    condition.iSinceResync = 0;
 }
 
 
 //*************************************************************************************************************
 
-bool RtAve::checkForArtifact(MatrixXd& data, double dThreshold)
+bool RtAve::checkForArtifact(const MatrixXd& data, double dThreshold)
 {
     double min = 0;
     double max = 0;
@@ -496,42 +566,74 @@ bool RtAve::checkForArtifact(MatrixXd& data, double dThreshold)
 
 void RtAve::generateEvoked()
 {
-    if(m_qListStimAve.isEmpty())
+    bool t_bUpdated = false;
+    for(int i = 0; i < m_vecConditions.size(); ++i)
+        t_bUpdated |= m_vecConditions[i].bUpdated;
+
+    if(!t_bUpdated)
         return;
 
-    // Generate final evoked
-    MatrixXd finalAverage = MatrixXd::Zero(m_qListStimAve.first().rows(), m_iPreStimSamples+m_iPostStimSamples);
+    m_qMutex.lock();
+    bool t_bDoBaselineCorrection = m_bDoBaselineCorrection;
+    QPair<QVariant,QVariant> t_pairBaselineSec = m_pairBaselineSec;
+    FiffEvoked t_evokedTemplate(*m_pStimEvoked.data());
+    m_qMutex.unlock();
 
-    if(m_iAverageMode == 0) {
-        for(int i = 0; i<m_qListStimAve.size(); i++) {
-            finalAverage += m_qListStimAve.at(i);
+    FiffEvokedSet::SPtr t_pEvokedSet(new FiffEvokedSet);
+    t_pEvokedSet->info = *m_pFiffInfo.data();
+
+    for(int i = 0; i < m_vecConditions.size(); ++i) {
+        Condition& t_condition = m_vecConditions[i];
+        if(t_condition.iCount == 0)
+            continue;
+
+        // Generate final evoked - baseline correction is linear and is applied to the average only
+        FiffEvoked::SPtr t_pEvoked(new FiffEvoked(t_evokedTemplate));
+        t_pEvoked->comment = t_condition.sComment;
+        t_pEvoked->aspect_kind = FIFFV_ASPECT_AVERAGE;
+        t_pEvoked->nave = t_condition.iCount;
+        t_pEvoked->data = t_condition.matSum / t_condition.iCount;
+
+        if(t_bDoBaselineCorrection) {
+            t_pEvoked->baseline = t_pairBaselineSec;
+            t_pEvoked->data = MNEMath::rescale(t_pEvoked->data, t_pEvoked->times, t_pairBaselineSec, QString("mean"));
+        } else {
+            t_pEvoked->baseline = qMakePair(QVariant("None"), QVariant("None"));
         }
-        finalAverage = finalAverage/m_qListStimAve.size();
-
-        if(m_bDoBaselineCorrection)
-            finalAverage = MNEMath::rescale(finalAverage, m_pStimEvoked->times, m_pairBaselineSec, QString("mean"));
-
-        m_pStimEvoked->data = finalAverage;
-        m_pStimEvoked->nave = m_iNumAverages;
 
-        if(m_iNumberCalcAverages<m_iNumAverages)
-            m_iNumberCalcAverages++;
-    } else if(m_iAverageMode == 1) {
-        MatrixXd tempMatrix = m_qListStimAve.last();
+        t_pEvokedSet->evoked.append(*t_pEvoked.data());
 
-        if(m_bDoBaselineCorrection)
-            tempMatrix = MNEMath::rescale(tempMatrix, m_pStimEvoked->times, m_pairBaselineSec, QString("mean"));
+        if(m_bDoStdErr && t_condition.iCount > 1) {
+            FiffEvoked t_stdErr(*t_pEvoked.data());
+            t_stdErr.aspect_kind = FIFFV_ASPECT_STD_ERR;
+            t_stdErr.data = (t_condition.matM2 / ((double)t_condition.iCount * (t_condition.iCount - 1))).cwiseSqrt();
 
-        *m_pStimEvoked.data() += tempMatrix;
+            t_pEvokedSet->evoked.append(t_stdErr);
+        }
 
-        m_iNumberCalcAverages++;
+        if(t_condition.bUpdated) {
+            t_condition.bUpdated = false;
+            emit evokedStim(t_pEvoked);
+        }
     }
+
+    emit evokedSet(t_pEvokedSet);
 }
 
 
 //*************************************************************************************************************
 
 void RtAve::reset()
+{
+    m_qMutex.lock();
+    m_bResetPending = true;
+    m_qMutex.unlock();
+}
+
+
+//*************************************************************************************************************
+
+void RtAve::resetState()
 {
     //Reset
     m_qMutex.lock();
@@ -540,40 +642,69 @@ void RtAve::reset()
 
     m_iPreStimSamples = m_iNewPreStimSamples;
     m_iPostStimSamples = m_iNewPostStimSamples;
-    m_iTriggerIndex = m_iNewTriggerIndex;
     m_iAverageMode = m_iNewAverageMode;
     m_iNumAverages = m_iNewNumAverages;
+    m_bDoStdErr = m_bNewDoStdErr;
+    m_bResetPending = false;
 
     m_iNumberCalcAverages = 0;
 
-    //Resize data matrices
-    m_matDataPre.resize(m_pFiffInfo->chs.size(), m_iPreStimSamples);
-    m_matDataPre.setZero();
-    m_matDataPost.resize(m_pFiffInfo->chs.size(), m_iPostStimSamples);
-    m_matDataPost.setZero();
+    const qint32 t_iNumChannels = m_pFiffInfo->chs.size();
+    const qint32 t_iEpochLength = m_iPreStimSamples + m_iPostStimSamples;
+
+    //Take over the conditions with empty sums, skipping those without a valid trigger channel
+    m_vecConditions.clear();
+    QList<int> t_lTriggerChs;
+    for(int i = 0; i < m_qListNewConditions.size(); ++i) {
+        Condition t_condition = m_qListNewConditions[i];
+        if(t_condition.iTriggerChIdx < 0 || t_condition.iTriggerChIdx >= t_iNumChannels)
+            continue;
+
+        t_condition.matSum = MatrixXd::Zero(t_iNumChannels, t_iEpochLength);
+        if(m_bDoStdErr) {
+            t_condition.matMean = MatrixXd::Zero(t_iNumChannels, t_iEpochLength);
+            t_condition.matM2 = MatrixXd::Zero(t_iNumChannels, t_iEpochLength);
+        }
+        if(m_iAverageMode == 0)
+            t_condition.vecEpochs.reserve(m_iNumAverages > 0 ? m_iNumAverages : 1);
+
+        m_vecConditions.append(t_condition);
+
+        if(!t_lTriggerChs.contains(t_condition.iTriggerChIdx))
+            t_lTriggerChs.append(t_condition.iTriggerChIdx);
+    }
+
+    m_triggerDetector.setChannels(t_lTriggerChs);
+    m_triggerDetector.setThreshold(m_fTriggerThreshold);
+    m_matEpoch.resize(t_iNumChannels, t_iEpochLength);
 
     //Full real-time evoked response
     m_pStimEvoked->setInfo(*m_pFiffInfo.data());
     m_pStimEvoked->baseline = m_pairBaselineSec;
-    m_pStimEvoked->times.resize(m_iPreStimSamples+m_iPostStimSamples);
+    m_pStimEvoked->times.resize(t_iEpochLength);
     m_pStimEvoked->times[0] = -T*m_iPreStimSamples;
     for(int i = 1; i < m_pStimEvoked->times.size(); ++i)
         m_pStimEvoked->times[i] = m_pStimEvoked->times[i-1] + T;
     m_pStimEvoked->first = m_pStimEvoked->times[0];
     m_pStimEvoked->last = m_pStimEvoked->times[m_pStimEvoked->times.size()-1];
-    m_pStimEvoked->data.setZero();
+    m_pStimEvoked->data.resize(0, 0);
+    m_pStimEvoked->nave = 0;
+
+    m_qMutex.unlock();
 
-    if(m_iAverageMode == 0)
-        m_pStimEvoked->nave = m_iNumAverages;
-    else
-        m_pStimEvoked->nave = 0;
+    resetRing();
+}
 
-    m_qListStimAve.clear();
-    clearDetectedTriggers();
 
-    m_bFillingBackBuffer = false;
+//*************************************************************************************************************
 
-    m_qMutex.unlock();
+void RtAve::resetRing()
+{
+    m_matRing = MatrixXd::Zero(m_pFiffInfo->chs.size(), m_iPreStimSamples + m_iPostStimSamples + qMax(m_iCurrentBlockSize, 1));
+    m_iSampleCount = 0;
+    m_triggerDetector.reset();
+
+    m_qListPendingEpochs.clear();
 }
 
 
@@ -583,22 +714,9 @@ void RtAve::init()
 {
     m_qMutex.lock();
 
-    QList<int> tempList;
-    for(int i = 0; i < m_pFiffInfo->nchan; ++i) {
-        if(m_pFiffInfo->chs[i].kind == FIFFV_STIM_CH && (m_pFiffInfo->chs[i].ch_name != QString("STI 014")))
-            m_qMapDetectedTrigger.insert(i,tempList);
-    }
-
     m_iNewPreStimSamples = m_iPreStimSamples;
     m_iNewPostStimSamples = m_iPostStimSamples;
     m_iNewNumAverages = m_iNumAverages;
 
-    //Resize data matrices
-    m_matDataPre.resize(m_pFiffInfo->chs.size(), m_iPreStimSamples);
-    m_matDataPre.setZero();
-    m_matDataPost.resize(m_pFiffInfo->chs.size(), m_iPostStimSamples);
-    m_matDataPost.setZero();
-
     m_qMutex.unlock();
 }
-
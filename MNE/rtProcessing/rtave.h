@@ -43,7 +43,7 @@
 //=============================================================================================================
 
 #include "rtprocessing_global.h"
-#include "utils/detecttrigger.h"
+#include "utils/triggerdetector.h"
 #include "utils/mnemath.h"
 
 
@@ -53,6 +53,7 @@
 //=============================================================================================================
 
 #include <fiff/fiff_evoked.h>
+#include <fiff/fiff_evoked_set.h>
 #include <fiff/fiff_info.h>
 
 
@@ -74,6 +75,7 @@
 #include <QSharedPointer>
 #include <QSet>
 #include <QList>
+#include <QVector>
 #include <QVariant>
 
 
@@ -85,6 +87,14 @@
 #include <Eigen/Core>
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define RTAVE_RESYNC_EPOCHS     256     /**< Number of evicted epochs after which the running sums of a condition are recomputed from the stored epochs, which bounds the rounding drift of adding and subtracting. */
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE NAMESPACE RTPROCESSINGLIB
@@ -105,13 +115,16 @@ using namespace FIFFLIB;
 
 //=============================================================================================================
 /**
-* Real-time averaging and returns evoked data
+* Real-time averaging and returns evoked data. Any number of conditions, each defined by a trigger channel and
+* an optional trigger value, are averaged in one pass over the incoming data. The running average of a
+* condition is kept as a sum which is updated with the new and the evicted epoch only.
 *
 * @brief Real-time averaging helper
 */
 class RTPROCESSINGSHARED_EXPORT RtAve : public QThread
 {
     Q_OBJECT
+
 public:
     typedef QSharedPointer<RtAve> SPtr;             /**< Shared pointer type for RtCov. */
     typedef QSharedPointer<const RtAve> ConstSPtr;  /**< Const shared pointer type for RtCov. */
@@ -181,12 +194,37 @@ public:
 
     //=========================================================================================================
     /**
-    * Sets the index of the trigger channel which is to be scanned fo triggers
+    * Sets the index of the trigger channel which is to be scanned fo triggers. Replaces all conditions by a single
+    * condition which accepts every rising flank of this channel.
     *
     * @param[in] idx    trigger channel index
     */
     void setTriggerChIndx(qint32 idx);
 
+    //=========================================================================================================
+    /**
+    * Adds a condition which is averaged alongside the already defined ones.
+    *
+    * @param[in] iTriggerChIdx  Row index of the trigger channel
+    * @param[in] iTriggerValue  Value of the trigger channel after the flank which selects the condition, 0 accepts every rising flank
+    * @param[in] sComment       Name of the condition, stored as the comment of its evoked data. Defaults to the channel name (and value).
+    */
+    void addCondition(qint32 iTriggerChIdx, qint32 iTriggerValue = 0, const QString& sComment = QString());
+
+    //=========================================================================================================
+    /**
+    * Removes all conditions.
+    */
+    void clearConditions();
+
+    //=========================================================================================================
+    /**
+    * Sets whether the standard error of each average is estimated (Welford's method) and emitted with the evoked set.
+    *
+    * @param[in] bActivate      Whether to estimate the standard error
+    */
+    void setStdErrEstimation(bool bActivate);
+
     //=========================================================================================================
     /**
     * Sets the artifact reduction
@@ -246,7 +284,7 @@ public:
 
     //=========================================================================================================
     /**
-    * Resets the averaged data stored.
+    * Resets the averaged data stored. The reset is carried out by the processing thread before the next block.
     */
     void reset();
 
@@ -260,33 +298,78 @@ protected:
     virtual void run();
 
 private:
+    /**
+    * Definition and running sums of one averaged condition.
+    */
+    struct Condition {
+        qint32                  iTriggerChIdx;  /**< Row index of the trigger channel. */
+        qint32                  iTriggerValue;  /**< Trigger value which selects the condition, 0 for every rising flank. */
+        QString                 sComment;       /**< Name of the condition. */
+        QVector<Eigen::MatrixXd> vecEpochs;     /**< Epochs of the running window, used as ring. Running mode only. */
+        qint32                  iOldestEpoch;   /**< Ring index of the oldest epoch once the window is full. */
+        qint32                  iCount;         /**< Number of epochs in the average. */
+        qint32                  iSinceResync;   /**< Number of epochs evicted since the sums were recomputed. */
+        Eigen::MatrixXd         matSum;         /**< Sum of the averaged epochs. */
+        Eigen::MatrixXd         matMean;        /**< Welford mean of the averaged epochs. Standard error estimation only. */
+        Eigen::MatrixXd         matM2;          /**< Welford sum of squared deviations. Standard error estimation only. */
+        bool                    bUpdated;       /**< Whether an epoch was added since the last emission. */
+    };
+
     //=========================================================================================================
     /**
-    * Clears already detected trigger.
+    * Takes over the new settings and conditions and clears all buffers and averages. Processing thread only.
     */
-    void clearDetectedTriggers();
+    void resetState();
 
     //=========================================================================================================
     /**
-    * Prepends incoming data to front/pre stim buffer.
+    * Sizes the sample ring for the current epoch and block length and drops all queued epochs.
     */
-    void fillFrontBuffer(Eigen::MatrixXd& data);
+    void resetRing();
 
     //=========================================================================================================
     /**
-    * Prepends incoming data to back/post stim buffer.
+    * Scans the trigger channels of a block for rising flanks with m_triggerDetector, which carries the last
+    * sample of each channel over to the next block, and queues an epoch for every matching condition.
+    *
+    * @param[in] data       The incoming block.
     */
-    void fillBackBuffer(Eigen::MatrixXd& data);
+    void detectTriggers(const Eigen::MatrixXd& data);
 
     //=========================================================================================================
     /**
-    * Packs the buffers togehter as one and calcualtes the current running average and emits the result if number of averages has been reached.
+    * Writes a block to the sample ring.
+    *
+    * @param[in] data       The incoming block.
+    */
+    void fillRing(const Eigen::MatrixXd& data);
+
+    //=========================================================================================================
+    /**
+    * Cuts all queued epochs which are complete out of the sample ring and adds them to their conditions.
+    */
+    void processPendingEpochs();
+
+    //=========================================================================================================
+    /**
+    * Adds an epoch to a condition and evicts the oldest epoch if the running window is full.
+    *
+    * @param[in] condition      The condition.
+    * @param[in] epoch          The epoch.
+    */
+    void addEpoch(Condition& condition, const Eigen::MatrixXd& epoch);
+
+    //=========================================================================================================
+    /**
+    * Recomputes the sums of a running average from its stored epochs.
+    *
+    * @param[in] condition      The condition.
     */
-    void mergeData();
+    void resync(Condition& condition);
 
     //=========================================================================================================
     /**
-    * Generates the final evoke variable.
+    * Generates the evoked data of all updated conditions and emits them.
     */
     void generateEvoked();
 
@@ -299,11 +382,11 @@ private:
     *
     * @return   Whether a thresold artifact was detected.
     */
-    bool checkForArtifact(Eigen::MatrixXd& data, double dThreshold);
+    bool checkForArtifact(const Eigen::MatrixXd& data, double dThreshold);
 
     //=========================================================================================================
     /**
-    * Clears already detected trigger.
+    * Initializes the settings which are taken over at the first reset.
     */
     void init();
 
@@ -318,48 +401,58 @@ private:
     qint32  m_iNewPostStimSamples;      /**< New amount of samples averaged after the stimulus, including the stimulus sample.*/
     qint32  m_iPreStimSeconds;          /**< Amount of seconds averaged before the stimulus. */
     qint32  m_iPostStimSeconds;         /**< Amount of seconds averaged after the stimulus, including the stimulus sample.*/
-    qint32  m_iMatDataPostIdx;          /**< Current index inside of the matrix m_matDataPost */
-    qint32  m_iTriggerIndex;            /**< Current row index of the data matrix which is to be scanned for triggers */
-    qint32  m_iNewTriggerIndex;         /**< Old row index of the data matrix which is to be scanned for triggers */
-    qint32  m_iTriggerPos;              /**< Last found trigger postion */
     qint32  m_iNewAverageMode;          /**< The new averaging mode 0-running 1-cumulative. */
     qint32  m_iAverageMode;             /**< The averaging mode 0-running 1-cumulative. */
     qint32  m_iNumberCalcAverages;      /**< The number of currently calculated averages. */
+    qint64  m_iSampleCount;             /**< Number of samples written to the ring since the last reset. */
 
     float   m_fTriggerThreshold;        /**< Threshold to detect trigger */
-
     double  m_dArtifactThreshold;       /**< Threshold to detect artifacts */
 
     bool    m_bDoArtifactReduction;     /**< Whether to do artifact reduction or not. */
     bool    m_bIsRunning;               /**< Holds if real-time Covariance estimation is running.*/
     bool    m_bAutoAspect;              /**< Auto aspect detection on or off. */
-    bool    m_bFillingBackBuffer;       /**< Whether the back buffer is currently getting filled. */
     bool    m_bDoBaselineCorrection;    /**< Whether to perform baseline correction. */
+    bool    m_bDoStdErr;                /**< Whether the standard error is estimated. */
+    bool    m_bNewDoStdErr;             /**< Whether the standard error is to be estimated after the next reset. */
+    bool    m_bResetPending;            /**< Whether a reset was requested. */
 
     QPair<QVariant,QVariant>                m_pairBaselineSec;              /**< Baseline information in seconds form where the seconds are seen relative to the trigger, meaning they can also be negative [from to]*/
     QPair<QVariant,QVariant>                m_pairBaselineSamp;             /**< Baseline information in samples form where the seconds are seen relative to the trigger, meaning they can also be negative [from to]*/
 
     FiffInfo::SPtr                          m_pFiffInfo;                    /**< Holds the fiff measurement information. */
-    FiffEvoked::SPtr                        m_pStimEvoked;                  /**< Holds the evoked information. */
+    FiffEvoked::SPtr                        m_pStimEvoked;                  /**< Holds the evoked information which is common to all conditions. */
 
     CircularMatrixBuffer<double>::SPtr      m_pRawMatrixBuffer;             /**< The Circular Raw Matrix Buffer. */
 
-    QMap<int,QList<int> >                   m_qMapDetectedTrigger;          /**< Detected trigger for each trigger channel. */
-
-    Eigen::MatrixXd                         m_matDataPre;                   /**< The matrix holding the pre stim data. */
-    Eigen::MatrixXd                         m_matDataPost;                  /**< The matrix holding the post stim data. */
+    QList<Condition>                        m_qListNewConditions;           /**< Conditions which are taken over at the next reset. */
+    QVector<Condition>                      m_vecConditions;                /**< The averaged conditions. Processing thread only. */
+    UTILSLIB::TriggerDetector               m_triggerDetector;              /**< Rising flank detection on the distinct trigger channels of all conditions. */
+    QList<QPair<qint64,qint32> >            m_qListPendingEpochs;           /**< Trigger sample and condition of epochs which are still waiting for post stim data. */
 
-    QList<Eigen::MatrixXd>                  m_qListStimAve;                 /**< the current stimulus average buffer. Holds m_iNumAverages vectors */
+    Eigen::MatrixXd                         m_matRing;                      /**< Ring holding the latest samples, long enough for one epoch and one block. */
+    Eigen::MatrixXd                         m_matEpoch;                     /**< Work matrix of the epoch which is currently cut out. */
+    Eigen::MatrixXd                         m_matDelta;                     /**< Work matrix of the Welford updates. */
 
 signals:
     //=========================================================================================================
     /**
-    * Signal which is emitted when new evoked stimulus data are available.
+    * Signal which is emitted when new evoked stimulus data are available. Emitted once per updated condition, the
+    * comment of the evoked data holds the name of the condition.
     *
     * @param[out] p_pEvokedStim     The evoked stimulus data
     */
     void evokedStim(FIFFLIB::FiffEvoked::SPtr p_pEvokedStim);
 
+    //=========================================================================================================
+    /**
+    * Signal which is emitted after a block which updated at least one condition. Holds the average of every
+    * condition with at least one epoch and, if activated, its standard error.
+    *
+    * @param[out] p_pEvokedSet      The evoked data of all conditions
+    */
+    void evokedSet(FIFFLIB::FiffEvokedSet::SPtr p_pEvokedSet);
+
     //=========================================================================================================
     /**
     * Emitted when number of averages changed
@@ -384,4 +477,9 @@ inline bool RtAve::isRunning()
 Q_DECLARE_METATYPE(FIFFLIB::FiffEvoked::SPtr); /**< Provides QT META type declaration of the FIFFLIB::FiffEvoked type. For signal/slot usage.*/
 #endif
 
+#ifndef metatype_fiffevokedsetsptr
+#define metatype_fiffevokedsetsptr
+Q_DECLARE_METATYPE(FIFFLIB::FiffEvokedSet::SPtr); /**< Provides QT META type declaration of the FIFFLIB::FiffEvokedSet type. For signal/slot usage.*/
+#endif
+
 #endif // RTAVE_H
@@ -46,6 +46,14 @@
 #include <fiff/fiff_cov.h>
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <math.h>
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // QT INCLUDES
@@ -72,8 +80,18 @@ RtCov::RtCov(qint32 p_iMaxSamples, FiffInfo::SPtr p_pFiffInfo, QObject *parent)
 : QThread(parent)
 , m_iMaxSamples(p_iMaxSamples)
 , m_iNewMaxSamples(0)
+, m_mode(Block)
+, m_iUpdateInterval(p_iMaxSamples)
+, m_bSinglePrecision(false)
+, m_bSettingsChanged(false)
 , m_pFiffInfo(p_pFiffInfo)
 , m_bIsRunning(false)
+, m_activeMode(Block)
+, m_bActiveSingle(false)
+, m_dNumSamples(0.0)
+, m_iSeenSamples(0)
+, m_iSinceUpdate(0)
+, m_iSinceResync(0)
 {
     qRegisterMetaType<FiffCov::SPtr>("FiffCov::SPtr");
 }
@@ -95,9 +113,18 @@ void RtCov::append(const MatrixXd &p_DataSegment)
 //    if(m_pRawMatrixBuffer) // ToDo handle change buffersize
 
     if(!m_pRawMatrixBuffer)
-        m_pRawMatrixBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(32, p_DataSegment.rows(), p_DataSegment.cols()));
+        m_pRawMatrixBuffer = MatrixRingBuffer<double>::SPtr(new MatrixRingBuffer<double>(32, p_DataSegment.rows(), p_DataSegment.cols()));
 
-    m_pRawMatrixBuffer->push(&p_DataSegment);
+    if((quint32)p_DataSegment.rows() != m_pRawMatrixBuffer->rows() || (quint32)p_DataSegment.cols() != m_pRawMatrixBuffer->cols())
+        return;
+
+    //Copy straight into the preallocated slot
+    MatrixXd* t_pSlot = m_pRawMatrixBuffer->acquireWrite();
+    if(t_pSlot)
+    {
+        *t_pSlot = p_DataSegment;
+        m_pRawMatrixBuffer->commitWrite();
+    }
 }
 
 
@@ -105,10 +132,40 @@ void RtCov::append(const MatrixXd &p_DataSegment)
 
 void RtCov::setSamples(qint32 samples)
 {
+    QMutexLocker t_locker(&mutex);
     m_iNewMaxSamples = samples;
 }
 
 
+//*************************************************************************************************************
+
+void RtCov::setMode(EstimationMode mode)
+{
+    QMutexLocker t_locker(&mutex);
+    m_mode = mode;
+    m_bSettingsChanged = true;
+}
+
+
+//*************************************************************************************************************
+
+void RtCov::setUpdateInterval(qint32 samples)
+{
+    QMutexLocker t_locker(&mutex);
+    m_iUpdateInterval = qMax(1, samples);
+}
+
+
+//*************************************************************************************************************
+
+void RtCov::setSinglePrecision(bool bSinglePrecision)
+{
+    QMutexLocker t_locker(&mutex);
+    m_bSinglePrecision = bSinglePrecision;
+    m_bSettingsChanged = true;
+}
+
+
 //*************************************************************************************************************
 
 bool RtCov::start()
@@ -117,6 +174,11 @@ bool RtCov::start()
     if(this->isRunning())
         QThread::wait();
 
+    //A stopped buffer is aborted - reset it before the processing thread blocks on it again. clear() only moves
+    //the consumer's counter, so the producer may keep appending meanwhile.
+    if(m_pRawMatrixBuffer && m_pRawMatrixBuffer->isAborted())
+        m_pRawMatrixBuffer->clear();
+
     m_bIsRunning = true;
     QThread::start();
 
@@ -130,9 +192,9 @@ bool RtCov::stop()
 {
     m_bIsRunning = false;
 
-    m_pRawMatrixBuffer->releaseFromPop();
-
-    m_pRawMatrixBuffer->clear();
+    //Wake the processing thread and a blocked producer
+    if(m_pRawMatrixBuffer)
+        m_pRawMatrixBuffer->abort();
 
     return true;
 }
@@ -149,68 +211,203 @@ void RtCov::run()
             exclude << m_pFiffInfo->chs.at(i).ch_name;
         }
     }
-    bool doProj = true;
 
-    quint32 n_samples = 0;
+    mutex.lock();
+    m_activeMode = m_mode;
+    m_bActiveSingle = m_bSinglePrecision;
+    m_bSettingsChanged = false;
+    mutex.unlock();
 
-    FiffCov::SPtr cov(new FiffCov());
-    VectorXd mu;
+    resetEstimate();
 
     while(m_bIsRunning)
     {
         if(m_pRawMatrixBuffer)
         {
-            MatrixXd rawSegment = m_pRawMatrixBuffer->pop();
+            //Work on the slot in place, it is handed back as soon as it is accumulated
+            MatrixXd* t_pRawSegment = m_pRawMatrixBuffer->acquireRead();
+            if(!t_pRawSegment)
+                continue;
+
+            const MatrixXd& rawSegment = *t_pRawSegment;
+
+            //Take over the settings
+            mutex.lock();
+            if(m_iNewMaxSamples > 0) {
+                m_iMaxSamples = m_iNewMaxSamples;
+                m_iNewMaxSamples = 0;
+            }
+            const quint32 t_iMaxSamples = qMax(m_iMaxSamples, (quint32)2);
+            const quint32 t_iUpdateInterval = m_iUpdateInterval;
+            bool t_bReset = m_bSettingsChanged;
+            if(m_bSettingsChanged) {
+                m_activeMode = m_mode;
+                m_bActiveSingle = m_bSinglePrecision;
+                m_bSettingsChanged = false;
+            }
+            mutex.unlock();
 
-            if(n_samples == 0)
-            {
-                mu = rawSegment.rowwise().sum();
-                cov->data = rawSegment * rawSegment.transpose();
+            if(t_bReset)
+                resetEstimate();
+
+            //Forget the past before the new block is added
+            if(m_activeMode == Exponential)
+                scale(pow(1.0 - 1.0 / t_iMaxSamples, (double)rawSegment.cols()));
+
+            accumulate(rawSegment, 1.0);
+            m_iSeenSamples += rawSegment.cols();
+            m_iSinceUpdate += rawSegment.cols();
+
+            //Keep the block until it leaves the window - the storage of an expired block is reused
+            if(m_activeMode == SlidingWindow) {
+                m_matSpare = rawSegment;
+                m_qQueueWindow.enqueue(MatrixXd());
+                m_qQueueWindow.last().swap(m_matSpare);
+                m_iSinceResync += rawSegment.cols();
             }
-            else
-            {
-                mu.array() += rawSegment.rowwise().sum().array();
-                cov->data += rawSegment * rawSegment.transpose();
+
+            m_pRawMatrixBuffer->release();
+
+            bool t_bEmit = false;
+
+            switch(m_activeMode) {
+                case SlidingWindow:
+                    while(!m_qQueueWindow.isEmpty() && m_dNumSamples - m_qQueueWindow.head().cols() >= t_iMaxSamples) {
+                        accumulate(m_qQueueWindow.head(), -1.0);
+                        m_matSpare.swap(m_qQueueWindow.head());
+                        m_qQueueWindow.dequeue();
+                    }
+
+                    if(m_iSinceResync >= (quint64)RTCOV_RESYNC_WINDOWS * t_iMaxSamples)
+                        resync();
+
+                    t_bEmit = m_dNumSamples >= t_iMaxSamples && m_iSinceUpdate >= t_iUpdateInterval;
+                    break;
+
+                case Exponential:
+                    t_bEmit = m_iSeenSamples >= t_iMaxSamples && m_iSinceUpdate >= t_iUpdateInterval;
+                    break;
+
+                default:
+                    t_bEmit = m_dNumSamples > t_iMaxSamples;
+                    break;
             }
-            n_samples += rawSegment.cols();
 
-            if(n_samples > m_iMaxSamples)
+            if(t_bEmit)
             {
-                mu /= (float)n_samples;
-                cov->data.array() -= n_samples * (mu * mu.transpose()).array();
-                cov->data.array() /= (n_samples - 1);
+                emit covCalculated(estimate(exclude));
+                m_iSinceUpdate = 0;
 
-                cov->kind = FIFFV_MNE_NOISE_COV;
-                cov->diag = false;
-                cov->dim = cov->data.rows();
+                if(m_activeMode == Block)
+                    resetEstimate();
+            }
+        }
+    }
+}
 
-                //ToDo do picks
-                cov->names = m_pFiffInfo->ch_names;
-                cov->projs = m_pFiffInfo->projs;
-                cov->bads = m_pFiffInfo->bads;
-                cov->nfree = n_samples;
 
-                // regularize noise covariance
-                *cov.data() = cov->regularize(*m_pFiffInfo, 0.05, 0.05, 0.1, doProj, exclude);
+//*************************************************************************************************************
 
-                emit covCalculated(cov);
+void RtCov::resetEstimate()
+{
+    m_matSum.resize(0, 0);
+    m_matSumSingle.resize(0, 0);
+    m_vecSum.resize(0);
+    m_dNumSamples = 0.0;
+    m_iSeenSamples = 0;
+    m_iSinceUpdate = 0;
+    m_iSinceResync = 0;
+    m_qQueueWindow.clear();
+}
 
-                cov = FiffCov::SPtr(new FiffCov());
-                n_samples = 0;
-            }
 
+//*************************************************************************************************************
+
+void RtCov::accumulate(const MatrixXd& matBlock, double dWeight)
+{
+    if(m_vecSum.size() != matBlock.rows()) {
+        if(m_bActiveSingle)
+            m_matSumSingle = MatrixXf::Zero(matBlock.rows(), matBlock.rows());
+        else
+            m_matSum = MatrixXd::Zero(matBlock.rows(), matBlock.rows());
+        m_vecSum = VectorXd::Zero(matBlock.rows());
+    }
 
-//            qint32 samples = rawSegment.cols();
-//            VectorXf mu = rawSegment.rowwise().sum().array() / (float)samples;
+    //Symmetric rank-k update - only the lower triangle is computed
+    if(m_bActiveSingle)
+        m_matSumSingle.selfadjointView<Lower>().rankUpdate(matBlock.cast<float>(), (float)dWeight);
+    else
+        m_matSum.selfadjointView<Lower>().rankUpdate(matBlock, dWeight);
 
-//            MatrixXf noise_covariance = rawSegment * rawSegment.transpose();// noise_covariance == raw_covariance
-//            noise_covariance.array() -= samples * (mu * mu.transpose()).array();
-//            noise_covariance.array() /= (samples - 1);
+    m_vecSum += dWeight * matBlock.rowwise().sum();
+    m_dNumSamples += dWeight * matBlock.cols();
+}
 
-//            std::cout << "Noise Covariance:\n" << noise_covariance.block(0,0,10,10) << std::endl;
 
-//            printf("%d raw buffer (%d x %d) generated\r\n", count, tmp.rows(), tmp.cols());
+//*************************************************************************************************************
 
-        }
+void RtCov::scale(double dFactor)
+{
+    if(m_vecSum.size() == 0)
+        return;
+
+    if(m_bActiveSingle)
+        m_matSumSingle.triangularView<Lower>() *= (float)dFactor;
+    else
+        m_matSum.triangularView<Lower>() *= dFactor;
+
+    m_vecSum *= dFactor;
+    m_dNumSamples *= dFactor;
+}
+
+
+//*************************************************************************************************************
+
+void RtCov::resync()
+{
+    m_vecSum.resize(0);
+    m_dNumSamples = 0.0;
+
+    for(int i = 0; i < m_qQueueWindow.size(); ++i)
+        accumulate(m_qQueueWindow[i], 1.0);
+
+    m_iSinceResync = 0;
+}
+
+
+//*************************************************************************************************************
+
+FiffCov::SPtr RtCov::estimate(const QStringList& exclude)
+{
+    bool doProj = true;
+
+    FiffCov::SPtr cov(new FiffCov());
+
+    //Complete the upper triangle
+    if(m_bActiveSingle) {
+        MatrixXd t_matSum = m_matSumSingle.cast<double>();
+        cov->data = t_matSum.selfadjointView<Lower>();
+    }
+    else {
+        cov->data = m_matSum.selfadjointView<Lower>();
     }
+
+    VectorXd mu = m_vecSum / m_dNumSamples;
+    cov->data.noalias() -= (m_dNumSamples * mu) * mu.transpose();
+    cov->data.array() /= (m_dNumSamples - 1.0);
+
+    cov->kind = FIFFV_MNE_NOISE_COV;
+    cov->diag = false;
+    cov->dim = cov->data.rows();
+
+    //ToDo do picks
+    cov->names = m_pFiffInfo->ch_names;
+    cov->projs = m_pFiffInfo->projs;
+    cov->bads = m_pFiffInfo->bads;
+    cov->nfree = (fiff_int_t)m_dNumSamples;
+
+    // regularize noise covariance
+    *cov.data() = cov->regularize(*m_pFiffInfo, 0.05, 0.05, 0.1, doProj, exclude);
+
+    return cov;
 }
@@ -58,7 +58,7 @@
 // Generics INCLUDES
 //=============================================================================================================
 
-#include <generics/circularmatrixbuffer.h>
+#include <generics/matrixringbuffer.h>
 
 
 //*************************************************************************************************************
@@ -68,6 +68,7 @@
 
 #include <QThread>
 #include <QMutex>
+#include <QQueue>
 #include <QSharedPointer>
 
 
@@ -79,6 +80,14 @@
 #include <Eigen/Core>
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define RTCOV_RESYNC_WINDOWS    16      /**< Number of windows after which the sliding window sums are recomputed from the stored blocks, which bounds the rounding drift of adding and subtracting. */
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE NAMESPACE RTPROCESSINGLIB
@@ -100,7 +109,12 @@ using namespace FIFFLIB;
 
 //=============================================================================================================
 /**
-* Real-time covariance estimation
+* Real-time covariance estimation. The sums are accumulated by symmetric rank-k updates of the lower triangle. In
+* Block mode a covariance is estimated from every m_iMaxSamples samples and the sums start over. SlidingWindow keeps
+* the blocks of the most recent m_iMaxSamples samples and subtracts the outer products of a block once it leaves
+* the window. Exponential weights the samples by a forgetting factor with a time constant of m_iMaxSamples samples.
+* In the latter two modes an estimate is emitted every update interval, so the estimate follows changing noise
+* without gaps.
 *
 * @brief Real-time covariance estimation
 */
@@ -111,6 +125,16 @@ public:
     typedef QSharedPointer<RtCov> SPtr;             /**< Shared pointer type for RtCov. */
     typedef QSharedPointer<const RtCov> ConstSPtr;  /**< Const shared pointer type for RtCov. */
 
+    //=========================================================================================================
+    /**
+    * How the samples are combined into an estimate.
+    */
+    enum EstimationMode {
+        Block,              /**< Estimate from consecutive, non-overlapping chunks of samples. */
+        SlidingWindow,      /**< Estimate from the most recent samples, updated at the update interval. */
+        Exponential         /**< Exponentially weighted estimate, updated at the update interval. */
+    };
+
     //=========================================================================================================
     /**
     * Creates the real-time covariance estimation object.
@@ -151,6 +175,31 @@ public:
     */
     void setSamples(qint32 samples);
 
+    //=========================================================================================================
+    /**
+    * Sets how the samples are combined. The estimate starts over with the next block.
+    *
+    * @param[in] mode       the estimation mode
+    */
+    void setMode(EstimationMode mode);
+
+    //=========================================================================================================
+    /**
+    * Sets the number of samples between two estimates of the SlidingWindow and Exponential modes.
+    *
+    * @param[in] samples    the update interval in samples
+    */
+    void setUpdateInterval(qint32 samples);
+
+    //=========================================================================================================
+    /**
+    * Sets whether the sums are accumulated in single precision, which halves memory traffic and about doubles the
+    * speed of the rank updates. The estimate starts over with the next block.
+    *
+    * @param[in] bSinglePrecision   whether to accumulate in float
+    */
+    void setSinglePrecision(bool bSinglePrecision);
+
     //=========================================================================================================
     /**
     * Starts the RtCov by starting the producer's thread.
@@ -186,17 +235,73 @@ protected:
     virtual void run();
 
 private:
+    //=========================================================================================================
+    /**
+    * Clears the sums and the window. Processing thread only.
+    */
+    void resetEstimate();
+
+    //=========================================================================================================
+    /**
+    * Adds the outer products and the sums of a block, weighted by dWeight. Processing thread only.
+    *
+    * @param[in] matBlock   the block
+    * @param[in] dWeight    1 to add the block, -1 to remove it
+    */
+    void accumulate(const MatrixXd& matBlock, double dWeight);
+
+    //=========================================================================================================
+    /**
+    * Scales the sums, i.e. forgets a part of the past samples. Processing thread only.
+    *
+    * @param[in] dFactor    the scaling factor
+    */
+    void scale(double dFactor);
+
+    //=========================================================================================================
+    /**
+    * Recomputes the sums from the blocks of the sliding window. Processing thread only.
+    */
+    void resync();
+
+    //=========================================================================================================
+    /**
+    * Computes and regularizes the covariance from the current sums. Processing thread only.
+    *
+    * @param[in] exclude    the channels which are excluded from regularization
+    *
+    * @return the covariance
+    */
+    FiffCov::SPtr estimate(const QStringList& exclude);
+
     QMutex      mutex;                  /**< Provides access serialization between threads*/
 
     quint32      m_iMaxSamples;         /**< Maximal amount of samples received, before covariance is estimated.*/
 
     quint32      m_iNewMaxSamples;      /**< New maximal amount of samples received, before covariance is estimated.*/
 
+    EstimationMode  m_mode;             /**< The estimation mode. Guarded by mutex. */
+    quint32      m_iUpdateInterval;     /**< Samples between two estimates of the SlidingWindow and Exponential modes. Guarded by mutex. */
+    bool        m_bSinglePrecision;     /**< Whether the sums are accumulated in float. Guarded by mutex. */
+    bool        m_bSettingsChanged;     /**< Whether the estimate has to start over. Guarded by mutex. */
+
     FiffInfo::SPtr  m_pFiffInfo;        /**< Holds the fiff measurement information. */
 
     bool        m_bIsRunning;           /**< Holds if real-time Covariance estimation is running.*/
 
-    CircularMatrixBuffer<double>::SPtr m_pRawMatrixBuffer;   /**< The Circular Raw Matrix Buffer. */
+    MatrixRingBuffer<double>::SPtr m_pRawMatrixBuffer;       /**< The Raw Matrix Ring Buffer. */
+
+    EstimationMode  m_activeMode;       /**< The mode of the running estimate. Processing thread only. */
+    bool        m_bActiveSingle;        /**< The precision of the running estimate. Processing thread only. */
+    MatrixXd    m_matSum;               /**< Lower triangle of the sum of outer products, double precision. Processing thread only. */
+    MatrixXf    m_matSumSingle;         /**< Lower triangle of the sum of outer products, single precision. Processing thread only. */
+    VectorXd    m_vecSum;               /**< Sum of the samples. Processing thread only. */
+    double      m_dNumSamples;          /**< (Effective) number of samples in the sums. Processing thread only. */
+    quint64     m_iSeenSamples;         /**< Samples since the estimate started. Processing thread only. */
+    quint64     m_iSinceUpdate;         /**< Samples since the last estimate was emitted. Processing thread only. */
+    quint64     m_iSinceResync;         /**< Samples since the sliding window sums were recomputed. Processing thread only. */
+    QQueue<MatrixXd> m_qQueueWindow;    /**< Blocks of the sliding window, oldest first. Processing thread only. */
+    MatrixXd    m_matSpare;             /**< Storage of the last expired block, reused for the next one. Processing thread only. */
 };
 
 //*************************************************************************************************************
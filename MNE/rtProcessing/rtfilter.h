@@ -41,6 +41,8 @@
 //=============================================================================================================
 
 #include "rtprocessing_global.h"
+#include "rtfirengine.h"
+#include "rtiirengine.h"
 
 #include <utils/filterTools/filterdata.h>
 #include <fiff/fiff_info.h>
@@ -115,9 +117,24 @@ public:
     */
     Eigen::MatrixXd filterChannelsConcurrently(const Eigen::MatrixXd& matDataIn, int iMaxFilterLength, const QVector<int>& lFilterChannelList, const QList<UTILSLIB::FilterData> &lFilterData);
 
+    //=========================================================================================================
+    /**
+    * Calculates the filtered version of the raw input data and writes it into a caller provided matrix.
+    * The output storage is only reallocated if its shape differs from the input, which allows pooled blocks to be reused.
+    * The filter spectrum is only recomputed if the filters or the channel list change. FIR filters are applied
+    * first, IIR filters (see FilterData::isIIR) run afterwards on the FIR output.
+    *
+    * @param [in] matDataIn             data which is to be filtered
+    * @param [in] iMaxFilterLength      length of the longest filter (kept for compatibility, the lengths are taken from lFilterData)
+    * @param [in] lFilterChannelList    indices of the channels which are to be filtered
+    * @param [in] lFilterData           the filters to apply
+    * @param [out] matDataOut           the filtered data
+    */
+    void filterChannelsConcurrently(const Eigen::MatrixXd& matDataIn, int iMaxFilterLength, const QVector<int>& lFilterChannelList, const QList<UTILSLIB::FilterData> &lFilterData, Eigen::MatrixXd& matDataOut);
+
 protected:
-    Eigen::MatrixXd                 m_matOverlap;                   /**< Last overlap block */
-    Eigen::MatrixXd                 m_matDelay;                     /**< Last delay block */
+    RtFirEngine                     m_firEngine;                    /**< Overlap-add engine which keeps the filter spectrum and the per-channel state */
+    RtIirEngine                     m_iirEngine;                    /**< Second-order section engine for the IIR filters */
 
 private:
 
@@ -0,0 +1,307 @@
+//=============================================================================================================
+/**
+* @file     rtfirengine.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the RtFirEngine Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rtfirengine.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtConcurrent/QtConcurrent>
+#include <QThread>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <algorithm>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace Eigen;
+using namespace UTILSLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+RtFirEngine::RtFirEngine()
+: m_vecImpulse(RowVectorXd::Ones(1))
+, m_iDelay(0)
+, m_iNumChannels(0)
+, m_iBlockSize(0)
+, m_iFFTLength(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+void RtFirEngine::setFilters(const QList<FilterData>& lFilterData, const QVector<int>& lFilterChannelList)
+{
+    m_lCoefficients.clear();
+    m_vecFilterChannels = lFilterChannelList;
+
+    //Cascade the filters: the impulse response is the convolution of all coefficient sets
+    m_vecImpulse = RowVectorXd::Ones(1);
+    m_iDelay = 0;
+
+    for(int i = 0; i < lFilterData.size(); ++i) {
+        //Recursive filters are handled by RtIirEngine
+        if(lFilterData.at(i).isIIR())
+            continue;
+
+        const RowVectorXd& t_vecCoeff = lFilterData.at(i).m_dCoeffA;
+        m_lCoefficients.append(t_vecCoeff);
+
+        if(t_vecCoeff.cols() == 0)
+            continue;
+
+        RowVectorXd t_vecImpulse = RowVectorXd::Zero(m_vecImpulse.cols() + t_vecCoeff.cols() - 1);
+        for(int k = 0; k < t_vecCoeff.cols(); ++k)
+            t_vecImpulse.segment(k, m_vecImpulse.cols()) += t_vecCoeff(k) * m_vecImpulse;
+
+        m_vecImpulse = t_vecImpulse;
+        m_iDelay += t_vecCoeff.cols()/2;
+    }
+
+    if(m_iNumChannels > 0 && m_iBlockSize > 0)
+        prepare(m_iNumChannels, m_iBlockSize);
+}
+
+
+//*************************************************************************************************************
+
+bool RtFirEngine::hasFilters(const QList<FilterData>& lFilterData, const QVector<int>& lFilterChannelList) const
+{
+    if(lFilterChannelList != m_vecFilterChannels)
+        return false;
+
+    int t_iFir = 0;
+    for(int i = 0; i < lFilterData.size(); ++i) {
+        if(lFilterData.at(i).isIIR())
+            continue;
+
+        const RowVectorXd& t_vecCoeff = lFilterData.at(i).m_dCoeffA;
+        if(t_iFir >= m_lCoefficients.size() || t_vecCoeff.cols() != m_lCoefficients.at(t_iFir).cols() || t_vecCoeff != m_lCoefficients.at(t_iFir))
+            return false;
+        ++t_iFir;
+    }
+
+    return t_iFir == m_lCoefficients.size();
+}
+
+
+//*************************************************************************************************************
+
+void RtFirEngine::prepare(int iNumChannels, int iBlockSize)
+{
+    m_iNumChannels = iNumChannels;
+    m_iBlockSize = iBlockSize;
+
+    //Linear convolution of a block with the impulse response has to fit into one FFT
+    int t_iOverlap = m_vecImpulse.cols() - 1;
+    m_iFFTLength = 4;
+    while(m_iFFTLength < iBlockSize + t_iOverlap)
+        m_iFFTLength *= 2;
+
+    //Spectrum of the cascade. The inverse FFTs run unscaled, so the scaling is folded in here.
+    FFT<double> t_fft;
+    t_fft.SetFlag(t_fft.HalfSpectrum);
+
+    VectorXd t_vecImpulsePad = VectorXd::Zero(m_iFFTLength);
+    t_vecImpulsePad.head(m_vecImpulse.cols()) = m_vecImpulse.transpose();
+
+    m_vecSpectrum.resize(m_iFFTLength/2 + 1);
+    t_fft.fwd(m_vecSpectrum.data(), t_vecImpulsePad.data(), m_iFFTLength);
+    m_vecSpectrum /= (double)m_iFFTLength;
+
+    //Sort the channels into filtered and passed ones
+    QVector<bool> t_vecFiltered(iNumChannels, false);
+    for(int i = 0; i < m_vecFilterChannels.size(); ++i) {
+        int t_iChannel = m_vecFilterChannels.at(i);
+        if(t_iChannel >= 0 && t_iChannel < iNumChannels)
+            t_vecFiltered[t_iChannel] = true;
+    }
+
+    QVector<int> t_vecFilterChannels;
+    m_vecPassChannels.clear();
+    for(int i = 0; i < iNumChannels; ++i) {
+        if(t_vecFiltered.at(i))
+            t_vecFilterChannels.append(i);
+        else
+            m_vecPassChannels.append(i);
+    }
+
+    //Split the filtered channels into contiguous batches, one per thread
+    int t_iNumBatches = t_vecFilterChannels.size() / RTFIRENGINE_MIN_BATCH_CHANNELS;
+    t_iNumBatches = qBound(1, t_iNumBatches, qMax(1, QThread::idealThreadCount()));
+    if(t_vecFilterChannels.isEmpty())
+        t_iNumBatches = 0;
+
+    m_vecBatches.clear();
+    m_vecBatches.resize(t_iNumBatches);
+
+    for(int b = 0; b < t_iNumBatches; ++b) {
+        Batch& t_batch = m_vecBatches[b];
+
+        int t_iFirst = (int)((qint64)t_vecFilterChannels.size() * b / t_iNumBatches);
+        int t_iLast = (int)((qint64)t_vecFilterChannels.size() * (b+1) / t_iNumBatches);
+        t_batch.vecChannels = t_vecFilterChannels.mid(t_iFirst, t_iLast - t_iFirst);
+
+        t_batch.fft.SetFlag(t_batch.fft.HalfSpectrum);
+        t_batch.fft.SetFlag(t_batch.fft.Unscaled);
+
+        t_batch.matTime = MatrixXd::Zero(m_iFFTLength, t_batch.vecChannels.size());
+        t_batch.matFreq = MatrixXcd::Zero(m_iFFTLength/2 + 1, t_batch.vecChannels.size());
+        t_batch.matOverlap = MatrixXd::Zero(t_iOverlap, t_batch.vecChannels.size());
+        t_batch.pDataIn = NULL;
+        t_batch.pDataOut = NULL;
+        t_batch.pSpectrum = &m_vecSpectrum;
+
+        //Create the FFT plans and scratch memory now instead of during the first block
+        t_batch.fft.fwd(t_batch.matFreq.col(0).data(), t_batch.matTime.col(0).data(), m_iFFTLength);
+        t_batch.fft.inv(t_batch.matTime.col(0).data(), t_batch.matFreq.col(0).data(), m_iFFTLength);
+    }
+
+    m_matDelay = MatrixXd::Zero(m_iDelay, m_vecPassChannels.size());
+}
+
+
+//*************************************************************************************************************
+
+void RtFirEngine::reset()
+{
+    for(int b = 0; b < m_vecBatches.size(); ++b)
+        m_vecBatches[b].matOverlap.setZero();
+
+    m_matDelay.setZero();
+}
+
+
+//*************************************************************************************************************
+
+void RtFirEngine::filter(const MatrixXd& matDataIn, MatrixXd& matDataOut)
+{
+    //Without FIR filters there is nothing to convolve and no delay
+    if(m_lCoefficients.isEmpty()) {
+        matDataOut = matDataIn;
+        return;
+    }
+
+    if(matDataIn.rows() != m_iNumChannels || matDataIn.cols() != m_iBlockSize)
+        prepare(matDataIn.rows(), matDataIn.cols());
+
+    //Keep the caller's storage if it already has the right shape
+    if(matDataOut.rows() != matDataIn.rows() || matDataOut.cols() != matDataIn.cols())
+        matDataOut.resize(matDataIn.rows(), matDataIn.cols());
+
+    //Filtered channels
+    for(int b = 0; b < m_vecBatches.size(); ++b) {
+        m_vecBatches[b].pDataIn = &matDataIn;
+        m_vecBatches[b].pDataOut = &matDataOut;
+    }
+
+    if(m_vecBatches.size() == 1) {
+        filterBatch(m_vecBatches[0]);
+    } else if(m_vecBatches.size() > 1) {
+        QFuture<void> future = QtConcurrent::map(m_vecBatches, &RtFirEngine::filterBatch);
+        future.waitForFinished();
+    }
+
+    //Passed channels are delayed to stay aligned with the filtered ones
+    int t_iBlockSize = matDataIn.cols();
+
+    for(int j = 0; j < m_vecPassChannels.size(); ++j) {
+        int t_iChannel = m_vecPassChannels.at(j);
+        double* t_pDelay = m_matDelay.col(j).data();
+
+        if(m_iDelay >= t_iBlockSize) {
+            matDataOut.row(t_iChannel) = m_matDelay.col(j).head(t_iBlockSize).transpose();
+            std::copy(t_pDelay + t_iBlockSize, t_pDelay + m_iDelay, t_pDelay);
+            m_matDelay.col(j).tail(t_iBlockSize) = matDataIn.row(t_iChannel).transpose();
+        } else {
+            matDataOut.row(t_iChannel).head(m_iDelay) = m_matDelay.col(j).transpose();
+            matDataOut.row(t_iChannel).tail(t_iBlockSize - m_iDelay) = matDataIn.row(t_iChannel).head(t_iBlockSize - m_iDelay);
+            m_matDelay.col(j) = matDataIn.row(t_iChannel).tail(m_iDelay).transpose();
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void RtFirEngine::filterBatch(Batch& batch)
+{
+    const MatrixXd& t_matDataIn = *batch.pDataIn;
+    MatrixXd& t_matDataOut = *batch.pDataOut;
+
+    int t_iBlockSize = t_matDataIn.cols();
+    int t_iFFTLength = batch.matTime.rows();
+    int t_iOverlap = batch.matOverlap.rows();
+
+    for(int j = 0; j < batch.vecChannels.size(); ++j) {
+        int t_iChannel = batch.vecChannels.at(j);
+
+        //Zero padded block of this channel
+        batch.matTime.col(j).head(t_iBlockSize) = t_matDataIn.row(t_iChannel).transpose();
+        batch.matTime.col(j).tail(t_iFFTLength - t_iBlockSize).setZero();
+
+        //Filter in the frequency domain
+        batch.fft.fwd(batch.matFreq.col(j).data(), batch.matTime.col(j).data(), t_iFFTLength);
+        batch.matFreq.col(j).array() *= batch.pSpectrum->array();
+        batch.fft.inv(batch.matTime.col(j).data(), batch.matFreq.col(j).data(), t_iFFTLength);
+
+        //Overlap-add with the tail of the previous block
+        batch.matTime.col(j).head(t_iOverlap) += batch.matOverlap.col(j);
+        t_matDataOut.row(t_iChannel) = batch.matTime.col(j).head(t_iBlockSize).transpose();
+        batch.matOverlap.col(j) = batch.matTime.col(j).segment(t_iBlockSize, t_iOverlap);
+    }
+}
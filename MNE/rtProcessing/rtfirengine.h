@@ -0,0 +1,220 @@
+//=============================================================================================================
+/**
+* @file     rtfirengine.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the RtFirEngine Class.
+*
+*/
+
+#ifndef RTFIRENGINE_H
+#define RTFIRENGINE_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rtprocessing_global.h"
+
+#include <utils/filterTools/filterdata.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QList>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+#include <unsupported/Eigen/FFT>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define RTFIRENGINE_MIN_BATCH_CHANNELS  32      /**< Minimal number of channels which are worth an own thread. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE RTPROCESSINGLIB
+//=============================================================================================================
+
+namespace RTPROCESSINGLIB
+{
+
+
+//=============================================================================================================
+/**
+* Streaming multi-channel FIR filter based on FFT overlap-add. The spectrum of the (cascaded) filters is computed
+* once per configuration. Each block is filtered in contiguous channel batches: a batch copies its channels into
+* a column-major work matrix, transforms every column with a real FFT, applies the spectrum and adds the tail of
+* the previous block. All work memory is owned by the engine, so filtering a block of unchanged shape does not
+* allocate. Channels which are not filtered are delayed by the group delay of the filters to stay aligned.
+*
+* @brief Batched FFT overlap-add FIR engine.
+*/
+class RTPROCESSINGSHARED_EXPORT RtFirEngine
+{
+public:
+    //=========================================================================================================
+    /**
+    * Creates an unconfigured engine. Until setFilters is called, filter copies the input.
+    */
+    RtFirEngine();
+
+    //=========================================================================================================
+    /**
+    * Sets the filters and the channels they are applied to. The filters are applied as a cascade, IIR filters
+    * (see FilterData::isIIR) are skipped. Without FIR filters, filter copies the input. The spectrum
+    * and the work memory are prepared on the next call to filter or immediately if the block shape is known.
+    * Resets the overlap state.
+    *
+    * @param[in] lFilterData            the filters to apply
+    * @param[in] lFilterChannelList     indices of the channels which are to be filtered
+    */
+    void setFilters(const QList<UTILSLIB::FilterData>& lFilterData, const QVector<int>& lFilterChannelList);
+
+    //=========================================================================================================
+    /**
+    * Returns whether the engine is configured with the given filters and channels.
+    *
+    * @param[in] lFilterData            the filters to compare with
+    * @param[in] lFilterChannelList     the channel indices to compare with
+    *
+    * @return true if setFilters was called with equal filter coefficients and channels
+    */
+    bool hasFilters(const QList<UTILSLIB::FilterData>& lFilterData, const QVector<int>& lFilterChannelList) const;
+
+    //=========================================================================================================
+    /**
+    * Prepares spectrum and work memory for blocks of the given shape. Called by filter when the shape changes.
+    * Resets the overlap state.
+    *
+    * @param[in] iNumChannels   number of rows of the blocks
+    * @param[in] iBlockSize     number of columns of the blocks
+    */
+    void prepare(int iNumChannels, int iBlockSize);
+
+    //=========================================================================================================
+    /**
+    * Clears the overlap and delay state, e.g. after a gap in the data stream.
+    */
+    void reset();
+
+    //=========================================================================================================
+    /**
+    * Filters one block. The output is delayed by delay() samples. The output storage is only reallocated if
+    * its shape differs from the input.
+    *
+    * @param[in] matDataIn      the block which is to be filtered
+    * @param[out] matDataOut    the filtered block
+    */
+    void filter(const Eigen::MatrixXd& matDataIn, Eigen::MatrixXd& matDataOut);
+
+    //=========================================================================================================
+    /**
+    * Returns the delay in samples which is introduced by the filters.
+    *
+    * @return the delay in samples
+    */
+    inline int delay() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the length of the FFT which is used for blocks of the prepared shape.
+    *
+    * @return the FFT length, 0 if not prepared
+    */
+    inline int fftLength() const;
+
+private:
+    /**
+    * Work memory and FFT plan of one contiguous range of filtered channels.
+    */
+    struct Batch {
+        QVector<int>            vecChannels;    /**< Rows of the block handled by this batch. */
+        Eigen::FFT<double>      fft;            /**< FFT object - holds the plans and scratch memory of this batch. */
+        Eigen::MatrixXd         matTime;        /**< Time domain work matrix - one column per channel, FFT length rows. */
+        Eigen::MatrixXcd        matFreq;        /**< Half spectrum work matrix - one column per channel. */
+        Eigen::MatrixXd         matOverlap;     /**< Tail of the previous block - one column per channel. */
+        const Eigen::MatrixXd*  pDataIn;        /**< Block which is currently filtered. */
+        Eigen::MatrixXd*        pDataOut;       /**< Output of the block which is currently filtered. */
+        const Eigen::VectorXcd* pSpectrum;      /**< The spectrum of the filters. */
+    };
+
+    static void filterBatch(Batch& batch);
+
+    QList<Eigen::RowVectorXd>   m_lCoefficients;        /**< Coefficients of the cascaded filters. */
+    QVector<int>                m_vecFilterChannels;    /**< Channel list as it was set. */
+    Eigen::RowVectorXd          m_vecImpulse;           /**< Impulse response of the cascade. */
+    int                         m_iDelay;               /**< Group delay of the cascade in samples. */
+
+    int                         m_iNumChannels;         /**< Number of rows the engine is prepared for. */
+    int                         m_iBlockSize;           /**< Number of columns the engine is prepared for. */
+    int                         m_iFFTLength;           /**< FFT length for the prepared shape. */
+    Eigen::VectorXcd            m_vecSpectrum;          /**< Half spectrum of the cascade, scaled by 1/FFT length. */
+
+    QVector<Batch>              m_vecBatches;           /**< Batches of filtered channels. */
+    QVector<int>                m_vecPassChannels;      /**< Channels which are only delayed. */
+    Eigen::MatrixXd             m_matDelay;             /**< Delay line of the passed channels - one column per channel. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline int RtFirEngine::delay() const
+{
+    return m_iDelay;
+}
+
+
+//*************************************************************************************************************
+
+inline int RtFirEngine::fftLength() const
+{
+    return m_iFFTLength;
+}
+
+} // NAMESPACE
+
+#endif // RTFIRENGINE_H
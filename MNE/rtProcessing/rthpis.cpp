@@ -62,8 +62,8 @@
 // QT INCLUDES
 //=============================================================================================================
 
-#include <QElapsedTimer>
 #include <QDebug>
+#include <QtConcurrent/QtConcurrent>
 
 
 //*************************************************************************************************************
@@ -86,7 +86,6 @@ RtHPIS::RtHPIS(FiffInfo::SPtr p_pFiffInfo, QObject *parent)
 , m_bIsRunning(false)
 , m_iMaxSamples(0)
 , m_iNewMaxSamples(0)
-, simplex_numitr(0)
 {
     qRegisterMetaType<Eigen::MatrixXd>("Eigen::MatrixXd");
     //qRegisterMetaType<QVector<double>>("QVector<double>");
@@ -158,7 +157,7 @@ void RtHPIS::run()
     int numCoils = 4;
     int numCh = m_pFiffInfo->nchan;
     int samF = m_pFiffInfo->sfreq;
-    int numLoc = 1, numBlock, samLoc; // numLoc : Number of times to localize in a second
+    int numLoc = RTHPIS_LOCALIZATIONS_PER_SEC, samLoc; // numLoc : Number of times to localize in a second
     samLoc = samF/numLoc; // minimum samples required to localize numLoc times in a second
     Eigen::VectorXd coilfreq(numCoils);
 //    coilfreq[0] = 154; coilfreq[1] = 158;coilfreq[2] = 162;coilfreq[3] = 166;
@@ -179,44 +178,16 @@ void RtHPIS::run()
 
     for (int i = 0;i < samLoc;i++) time[i] = i*1.0/samF;
 
-//    std::ofstream outsin;
-//    outsin.open ("C:/Users/babyMEG/Desktop/Seok/sin.txt");
-//    std::ofstream outcos;
-//    outcos.open ("C:/Users/babyMEG/Desktop/Seok/cos.txt");
-
     for(int i=0;i<numCoils;i++) {
         for(int j=0;j<samLoc;j++) {
             simsig(j,i) = sin(2*M_PI*coilfreq[i]*time[j]);
             simsig(j,i+numCoils) = cos(2*M_PI*coilfreq[i]*time[j]);
-
-//            outsin <<simsig(j,i)<<" ";
-//            outcos <<simsig(j,i+numCoils) << " ";
         }
-//            outsin <<"\n";
-//            outcos <<"\n";
     }
 
-//    outsin.close();
-//    outcos.close();
-
-    //====== Seok 2016. 3.25 ==========================================
-    // Get the indices of trigger channels
-//    QVector<int> trigind(0);
-//    for (int i = 0, k = 0 ;i < numCh;i++) {
-//        if(m_pFiffInfo->chs[i].coil_type == 3) {
-//            k++;
-//            if (k >= 9 && k <= 12) {
-//                qDebug() << "trigger channel found ..."  << i;
-//                trigind.append(i);
-//            }
-//            if (k >=9 && k <=12) {
-//                qDebug() << "HPI trigger channel found ..."  << i;
-//                trigind.append(i);
-//            }
-//        }
-//    }
-//    qDebug() << "trigind: " << trigind.length();
-    //==================================================================
+    // The sin/cos reference model is fixed - its pseudo-inverse maps each sample onto the coil amplitudes.
+    // The demodulation is linear, so it is accumulated block by block while the window fills.
+    Eigen::MatrixXd refPinvT = pinv(simsig).transpose();
 
     //load polhemus HPI
     Eigen::MatrixXd headHPI(numCoils,3);
@@ -232,658 +203,240 @@ void RtHPIS::run()
     }
     else
     {
-        for (int i=0;i<numCoils;i++) {
-            headHPI(i,0) = 0;headHPI(i,1) = 0;headHPI(i,2) = 0;
-        }
-        qDebug() << "\n \n \n";
-        qDebug()<< "    **********************************************************";
-        qDebug()<< "   *************************************************************";
-        qDebug()<< "  ***************************************************************";
-        qDebug()<< "******************************************************************";
-        qDebug()<< "********    You forget to load polhemus HPI information!   *********";
-        qDebug()<< "***********  Please stop running and load it propoerly!  **********";
-        qDebug()<< "******************************************************************";
-        qDebug()<< " ****************************************************************";
-        qDebug()<< "  **************************************************************";
-        qDebug()<< "   ************************************************************";
-        qDebug()<< "    **********************************************************";
-        qDebug() << "\n \n \n";
-
+        headHPI.setZero();
+        qDebug() << "RtHPIS::run - No polhemus HPI information loaded. Please stop running and load it properly!";
     }
 
-    Eigen::Matrix4d trans;
-    QVector<MatrixXd> buffer;
-    double phase;
-
-//    qDebug() << "samLoc (1024): " << samLoc;
-//    int OUT_FLAG = 0;
-//    int OUT_RAW = 0;
-//    std::ofstream outinnerdata;
-//    outinnerdata.open ("C:/Users/babyMEG/Desktop/Seok/innerdata.txt");
-//    std::ofstream outtrigdata;
-//    outtrigdata.open ("C:/Users/babyMEG/Desktop/Seok/trigdata.txt");
-
-//    std::ofstream outtopo;
-//    outtopo.open ("C:/Users/babyMEG/Desktop/Seok/topo.txt");
-//    std::ofstream outamp;
-//    outamp.open ("C:/Users/babyMEG/Desktop/Seok/amp.txt");
-//    std::ofstream outphase;
-//    outphase.open ("C:/Users/babyMEG/Desktop/Seok/phase.txt");
-//    std::ofstream outxfm;
-//    outxfm.open ("C:/Users/babyMEG/Desktop/Seok/xfm.txt");
-//    std::ofstream outcoilp;
-//    outcoilp.open ("C:/Users/babyMEG/Desktop/Seok/coilp.txt");
-//    std::ofstream outcoilm;
-//    outcoilm.open ("C:/Users/babyMEG/Desktop/Seok/coilm.txt");
-//    std::ofstream outdpfiterror;
-//    outdpfiterror.open ("C:/Users/babyMEG/Desktop/Seok/dpfiterror.txt");
-//    std::ofstream outdpfitnumitr;
-//    outdpfitnumitr.open ("C:/Users/babyMEG/Desktop/Seok/dpfitnumitr.txt");
-
-    // --------------------------------------
-    int itimerMatAlloc,itimerLocCoils,itimerTransMulti,itimerPhase,itimerDipFit,itimerCompTrans,itimerBufFull;
-
-    QElapsedTimer timerBufFull;
-    QElapsedTimer timerMatAlloc;
-    QElapsedTimer timerAll;
-    QElapsedTimer timerLocCoils;
-    QElapsedTimer timerTransMulti;
-    QElapsedTimer timerPhase;
-    QElapsedTimer timerDipFit;
-
-    QElapsedTimer timerCompTrans;
-
-    while(m_bIsRunning)
-    {
-        // Get the indices of inner layer channels
-        QVector<int> innerind(0);
-        for (int i = 0;i < numCh;i++) {
-            if(m_pFiffInfo->chs[i].coil_type == 7002) {
-                // Check if the sensor is bad, if not append to innerind
-                if(!(m_pFiffInfo->bads.contains(m_pFiffInfo->ch_names.at(i)))) innerind.append(i);
-            }
+    // Get the indices of inner layer channels
+    QVector<int> innerind(0);
+    for (int i = 0;i < numCh;i++) {
+        if(m_pFiffInfo->chs[i].coil_type == 7002) {
+            // Check if the sensor is bad, if not append to innerind
+            if(!(m_pFiffInfo->bads.contains(m_pFiffInfo->ch_names.at(i)))) innerind.append(i);
         }
+    }
 
-        qDebug() << "innerind (number of inlayer channels): " << innerind.size();
+    qDebug() << "innerind (number of inlayer channels): " << innerind.size();
 
-        // Initialize inner layer sensors
-        sensors.coilpos = Eigen::MatrixXd::Zero(innerind.size(),3);
-        sensors.coilori = Eigen::MatrixXd::Zero(innerind.size(),3);
-        sensors.tra = Eigen::MatrixXd::Identity(innerind.size(),innerind.size());
+    // Initialize inner layer sensors
+    sensors.coilpos = Eigen::MatrixXd::Zero(innerind.size(),3);
+    sensors.coilori = Eigen::MatrixXd::Zero(innerind.size(),3);
+    sensors.tra = Eigen::MatrixXd::Identity(innerind.size(),innerind.size());
 
-        for(int i=0;i<innerind.size();i++) {
-            sensors.coilpos(i,0) = m_pFiffInfo->chs[innerind.at(i)].loc(0,0);
-            sensors.coilpos(i,1) = m_pFiffInfo->chs[innerind.at(i)].loc(1,0);
-            sensors.coilpos(i,2) = m_pFiffInfo->chs[innerind.at(i)].loc(2,0);
-            sensors.coilori(i,0) = m_pFiffInfo->chs[innerind.at(i)].loc(9,0);
-            sensors.coilori(i,1) = m_pFiffInfo->chs[innerind.at(i)].loc(10,0);
-            sensors.coilori(i,2) = m_pFiffInfo->chs[innerind.at(i)].loc(11,0);
-            }
+    for(int i=0;i<innerind.size();i++) {
+        sensors.coilpos(i,0) = m_pFiffInfo->chs[innerind.at(i)].loc(0,0);
+        sensors.coilpos(i,1) = m_pFiffInfo->chs[innerind.at(i)].loc(1,0);
+        sensors.coilpos(i,2) = m_pFiffInfo->chs[innerind.at(i)].loc(2,0);
+        sensors.coilori(i,0) = m_pFiffInfo->chs[innerind.at(i)].loc(9,0);
+        sensors.coilori(i,1) = m_pFiffInfo->chs[innerind.at(i)].loc(10,0);
+        sensors.coilori(i,2) = m_pFiffInfo->chs[innerind.at(i)].loc(11,0);
+    }
 
-        Eigen::MatrixXd topo(innerind.size(),numCoils*2);
-        Eigen::MatrixXd amp(innerind.size(),numCoils);
+    // The coils are fitted in parallel, each one warm started from its last position
+    QVector<CoilFit> coilFits(numCoils);
+    for(int i = 0;i < numCoils;i++) {
+        coilFits[i].pSensorPos = &sensors.coilpos;
+        coilFits[i].pSensorOri = &sensors.coilori;
+        coilFits[i].vecPos = Eigen::Vector3d::Zero();
+        coilFits[i].vecMom = Eigen::Vector3d::Zero();
+        coilFits[i].dError = 1.0;
+        coilFits[i].iIterations = 0;
+    }
+
+    Eigen::MatrixXd topo = Eigen::MatrixXd::Zero(innerind.size(),numCoils*2);
+    Eigen::MatrixXd innerdata;
+    Eigen::Matrix2d phaseCov;
+    Eigen::Matrix4d trans;
+    int windowFill = 0;
 
+    while(m_bIsRunning)
+    {
         if(m_pRawMatrixBuffer)
         {
             MatrixXd t_mat = m_pRawMatrixBuffer->pop();
 
-            buffer.append(t_mat);
-
-            timerAll.start();
-            qDebug() << "buffer(size): " << buffer.length();
-            qDebug() << "t_mat(size): " << t_mat.rows() << " x " << t_mat.cols();
+            // Get the data from inner layer channels
+            innerdata.resize(innerind.size(),t_mat.cols());
+            for(int j = 0;j < innerind.size();j++)
+                innerdata.row(j) = t_mat.row(innerind[j]);
 
-            //If enough data has been stored in the buffer
-            if(buffer.size()*t_mat.cols() >= samLoc)
-            {
-                timerBufFull.start();
+            int pos = 0;
+            while(pos < t_mat.cols()) {
+                int count = qMin((int)t_mat.cols() - pos, samLoc - windowFill);
 
-                timerMatAlloc.start();
+                // topo 247 x 8
+                topo.noalias() += innerdata.middleCols(pos,count) * refPinvT.middleRows(windowFill,count);
 
-                Eigen::MatrixXd alldata(t_mat.rows(),buffer.size()*t_mat.cols());
+                pos += count;
+                windowFill += count;
 
-                // Concatenate data into a matrix
-                for(int i=0;i<buffer.size();i++)
-                    alldata << buffer[i];
+                if(windowFill < samLoc)
+                    continue;
 
-//                // Get the data from inner layer channels
-                Eigen::MatrixXd innerdata(innerind.size(),samLoc);
-//                Eigen::MatrixXd trigdata(trigind.size(),samLoc);
-
-                numBlock = alldata.cols()/samLoc;
-
-                itimerMatAlloc = timerMatAlloc.elapsed();
-
-                // Loop for localizing coils
+                // Signed amplitude: project the sin/cos pair of each channel onto the dominant phase of the coil
+                for (int i = 0;i < numCoils;i++) {
+                    phaseCov(0,0) = topo.col(i).squaredNorm();
+                    phaseCov(1,1) = topo.col(i+numCoils).squaredNorm();
+                    phaseCov(0,1) = phaseCov(1,0) = topo.col(i).dot(topo.col(i+numCoils));
 
-                timerLocCoils.start();
+                    Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d> t_eig(phaseCov);
+                    Eigen::Vector2d phase = t_eig.eigenvectors().col(1);
 
-                for(int i = 0;i<numBlock;i++) {
-                    for(int j = 0;j < innerind.size();j++){
-                        innerdata.row(j) << alldata.block(innerind[j],i*samLoc,1,samLoc);
-//                        if (OUT_RAW == 1) {
-//                            for (int k = 0; k < innerdata.cols(); k++)
-//                                outinnerdata << innerdata(j,k) << " ";
-//                        }
-                   }
-//                    for(int j = 0;j < trigind.size();j++){
-//                        trigdata.row(j) << alldata.block(trigind[j],i*samLoc,1,samLoc);
-//                        if (OUT_RAW == 1) {
-//                            for (int k = 0; k < trigdata.cols(); k++)
-//                                outtrigdata << trigdata(j,k) << " ";
-//                        }
-//                   }
-//                    if (OUT_RAW == 1) {
-//                       outinnerdata << "\n";
-//                       outtrigdata << "\n";
-//                   }
+                    coilFits[i].vecData = topo.col(i) * phase(0) + topo.col(i+numCoils) * phase(1);
                 }
 
-                itimerLocCoils = timerLocCoils.elapsed();
-
-//                    qDebug() << "numBlock: " << numBlock;
-//                    qDebug() << "alldata: " << alldata.rows() << " x " << alldata.cols();
-//                    qDebug() << "innerdata: " << innerdata.rows() << " x " << innerdata.cols();
-//                    qDebug() << "trigdata: " << trigdata.rows() << " x " << trigdata.cols();
-
-                timerTransMulti.start();
-                    // topo 247 x 8
-                    topo = innerdata * pinv(simsig).transpose();
-
-                itimerTransMulti = timerTransMulti.elapsed();
-
-                    //topo = innerdata * pinv(trigdata.transpose()).transpose();
-                    //qDebug() << "topo: " << topo.rows() << " " << topo.cols();
-
-//                    for (int i =0; i<numCoils; i++) {
-//                        for (int j =0; j< innerind.size(); j++)
-//                            outtopo << topo(j,i) << " ";
-//
-//                        outtopo << "\n";
-//                    }
-
-
-                // amp 247 x 4
-                timerPhase.start();
-
-                amp = (topo.leftCols(numCoils).array().square() + topo.rightCols(numCoils).array().square()).array().sqrt();
-                //amp = (topo.array().square()).array().sqrt();
-                //qDebug() << "amp: " << amp.rows() << " " << amp.cols();
+                QtConcurrent::blockingMap(coilFits, &RtHPIS::fitCoil);
 
                 for (int i = 0;i < numCoils;i++) {
-                    for (int j = 0;j < innerind.size();j++) {
-                        phase = atan2(topo(j,i+numCoils),topo(j,i)) * 180/M_PI;
-                        if(phase < 0) phase = 360 + phase;
-                        if(phase <= 90) phase = 1;
-                        else if(phase > 90 || phase <= 270) phase = -1;
-                        else phase = 1;
-
-                        amp(j,i) = amp(j,i) * phase;
-
-//                            if (OUT_FLAG == 1) {
-//                                outamp << amp(j,i) << " ";
-//                                outphase << phase << " ";
-//                            }
+                    // A failed fit restarts from the origin next time
+                    if(!coilFits[i].vecPos.allFinite() || !coilFits[i].vecMom.allFinite()) {
+                        coilFits[i].vecPos.setZero();
+                        coilFits[i].vecMom.setZero();
+                        coilFits[i].dError = 1.0;
                     }
-//                        if (OUT_FLAG == 1) {
-//                            outamp << "\n";
-//                            outphase << "\n";
-//                        }
-                }
-
-                itimerPhase = timerPhase.elapsed();
-
-//                    coil.pos(0,0) = 22; coil.pos(0,1) = 60; coil.pos(0,2) = 20;
-//                    coil.pos(1,0) = 32; coil.pos(1,1) = 48; coil.pos(1,2) = 34;
-//                    coil.pos(2,0) = 35; coil.pos(2,1) = 10; coil.pos(2,2) = 48;
-//                    coil.pos(3,0) = 60; coil.pos(3,1) =  4; coil.pos(3,2) = 12;
-//                    coil.pos(0,0) = 0; coil.pos(0,1) = 0; coil.pos(0,2) = 0;
-//                    coil.pos(1,0) = 0; coil.pos(1,1) = 0; coil.pos(1,2) = 0;
-//                    coil.pos(2,0) = 0; coil.pos(2,1) = 0; coil.pos(2,2) = 0;
-//                    coil.pos(3,0) = 0; coil.pos(3,1) = 0; coil.pos(3,2) = 0;
-
-                timerDipFit.start();
-
-                //coil.pos = Eigen::MatrixXd::Zero(numCoils,3);
-                coil = dipfit(coil, sensors, amp, numCoils);
-                itimerDipFit = timerDipFit.elapsed();
-
 
-//                    qDebug()<<"HPI head "<<headHPI(0,0)<<" "<<headHPI(0,1)<<" "<<headHPI(0,2);
-//                    qDebug()<<"HPI head "<<headHPI(1,0)<<" "<<headHPI(1,1)<<" "<<headHPI(1,2);
-//                    qDebug()<<"HPI head "<<headHPI(2,0)<<" "<<headHPI(2,1)<<" "<<headHPI(2,2);
-//                    qDebug()<<"HPI head "<<headHPI(3,0)<<" "<<headHPI(3,1)<<" "<<headHPI(3,2);
-
-
-//                    qDebug()<<"HPI device "<<1e3*coil.pos(0,0)<<" "<<1e3*coil.pos(0,1)<<" "<<1e3*coil.pos(0,2);
-//                    qDebug()<<"HPI device "<<1e3*coil.pos(1,0)<<" "<<1e3*coil.pos(1,1)<<" "<<1e3*coil.pos(1,2);
-//                    qDebug()<<"HPI device "<<1e3*coil.pos(2,0)<<" "<<1e3*coil.pos(2,1)<<" "<<1e3*coil.pos(2,2);
-//                    qDebug()<<"HPI device "<<1e3*coil.pos(3,0)<<" "<<1e3*coil.pos(3,1)<<" "<<1e3*coil.pos(3,2);
-//                    qDebug()<<"HPI dpfit error "<<coil.dpfiterror(0) <<" "<<coil.dpfiterror(1) <<" "<<coil.dpfiterror (2)<<" " << coil.dpfiterror(3);
-
-                    //outcoilp << "   coil position" << "\n";
-//                    if (OUT_FLAG == 1) {
-//                        outcoilp <<coil.pos(0,0)<<" "<<coil.pos(0,1)<<" "<<coil.pos(0,2) <<"\n";
-//                        outcoilp <<coil.pos(1,0)<<" "<<coil.pos(1,1)<<" "<<coil.pos(1,2) <<"\n";
-//                        outcoilp <<coil.pos(2,0)<<" "<<coil.pos(2,1)<<" "<<coil.pos(2,2) <<"\n";
-//                        outcoilp <<coil.pos(3,0)<<" "<<coil.pos(3,1)<<" "<<coil.pos(3,2) <<"\n";
-
-//                        outcoilm <<coil.mom(0,0)<<" "<<coil.mom(0,1)<<" "<<coil.mom(0,2) <<"\n";
-//                        outcoilm <<coil.mom(1,0)<<" "<<coil.mom(1,1)<<" "<<coil.mom(1,2) <<"\n";
-//                        outcoilm <<coil.mom(2,0)<<" "<<coil.mom(2,1)<<" "<<coil.mom(2,2) <<"\n";
-//                        outcoilm <<coil.mom(3,0)<<" "<<coil.mom(3,1)<<" "<<coil.mom(3,2) <<"\n";
-
-//                        outdpfiterror << coil.dpfiterror(0) <<" "<<coil.dpfiterror(1) <<" "<<coil.dpfiterror(2) <<" " << coil.dpfiterror(3) <<"\n";
-//                        outdpfitnumitr << coil.dpfitnumitr(0) <<" "<<coil.dpfitnumitr(1) <<" "<<coil.dpfitnumitr(2) <<" " << coil.dpfitnumitr(3) <<"\n";
-//                    }
+                    coil.pos.row(i) = coilFits[i].vecPos.transpose();
+                    coil.mom.row(i) = coilFits[i].vecMom.transpose();
+                    coil.dpfiterror(i) = coilFits[i].dError;
+                    coil.dpfitnumitr(i) = coilFits[i].iIterations;
+                }
 
-                timerCompTrans.start();
                 trans = computeTransformation(coil.pos,headHPI);
 
                 for(int ti =0; ti<4;ti++)
                     for(int tj=0;tj<4;tj++)
                         m_pFiffInfo->dev_head_t.trans(ti,tj) = trans(ti,tj);
 
-                itimerCompTrans = timerCompTrans.elapsed();
+                emit HPICalculated(trans);
 
-//                    qDebug()<<"**** rotation ------- dev2head transformation ************";
-//                    qDebug()<< trans(0,0)<<" "<<trans(0,1)<<" "<<trans(0,2);
-//                    qDebug()<< trans(1,0)<<" "<<trans(1,1)<<" "<<trans(1,2);
-//                    qDebug()<< trans(2,0)<<" "<<trans(2,1)<<" "<<trans(2,2);
-//                    qDebug()<<"**** translation(dx,dy,dz) - dev2head transformation ***********";
-//                    qDebug()<< 1e3*trans(0,3)<<" "<<1e3*trans(1,3)<<" "<<1e3*trans(2,3);
-
-/*                     if (OUT_FLAG == 1) {
-                    //outxfm << "   rotation" << "\n";
-                    outxfm << trans(0,0)<<" "<<trans(0,1)<<" "<<trans(0,2) <<" "<< trans(0,3)<<"\n";
-                    outxfm << trans(1,0)<<" "<<trans(1,1)<<" "<<trans(1,2) <<" "<< trans(1,3)<<"\n";
-                    outxfm << trans(2,0)<<" "<<trans(2,1)<<" "<<trans(2,2) <<" "<< trans(2,3)<<"\n";
-                    }
-*/
-                itimerBufFull = timerBufFull.elapsed();
-
-                buffer.clear();
+                topo.setZero();
+                windowFill = 0;
             }
-
-            qDebug() << "";
-            qDebug() << "RtHPIS::run() - All" << timerAll.elapsed() << "milliseconds";
-            qDebug() << "";
-            qDebug() << "RtHPIS::run() - itimerMatAlloc" << itimerMatAlloc << "milliseconds";
-            qDebug() << "RtHPIS::run() - itimerLocCoils" << itimerLocCoils << "milliseconds";
-            qDebug() << "RtHPIS::run() - itimerTransMulti" << itimerTransMulti << "milliseconds";
-            qDebug() << "RtHPIS::run() - itimerPhase" << itimerPhase << "milliseconds";
-            qDebug() << "RtHPIS::run() - itimerDipFit" << itimerDipFit << "milliseconds";
-            qDebug() << "RtHPIS::run() - itimerCompTrans" << itimerCompTrans << "milliseconds";
-            qDebug() << "RtHPIS::run() - itimerBufFull" << itimerBufFull << "milliseconds";
-
         }//m_pRawMatrixBuffer
     }  //End of while statement
-
-    //m_bIsRunning
-//    outinnerdata.close();
-//    outtrigdata.close();
-//    outtopo.close();
-//    outamp.close();
-//    outphase.close();
-//    outxfm.close();
-//    outcoilp.close();
-//    outcoilm.close();
-//    outdpfiterror.close();
-//    outdpfitnumitr.close();
-
 }
 
 
+//*************************************************************************************************************
 
-/*
-Goodness of fit (for MNE HPI GOF)is
-
-g = 1 - sum(e_k^2)/sum(y_k^2)
-
-where
-
-y_k is the measured signal in channel k
-
-e_k = y_k - y’_k, the difference of y_k and the signal predicted by the model
-*/
-
-
-/*********************************************************************************
- * dipfit function is adapted from Fieldtrip Software. It has been
- * heavily edited for use with MNE Scan Software
- *********************************************************************************/
-
-coilParam RtHPIS::dipfit(struct coilParam coil, struct sens sensors, Eigen::MatrixXd data, int numCoils)
-{
-    // Initialize variables
-    int display = 0;
-    int maxiter = 100;
-
-    dipError temp;
-
-    for(int i = 0;i<numCoils;i++) {
-        coil.pos.row(i).array() = fminsearch(coil.pos.row(i), maxiter, 2 * maxiter * coil.pos.cols(), display, data.col(i), sensors);
-        temp = dipfitError(coil.pos.row(i), data.col(i), sensors);
-        coil.mom = temp.moment.transpose();
-
-        // Seok
-        qDebug()<<"RtHPIS::dipfit - simplex_numitr"<<simplex_numitr<<"num coil"<<i;
-//        coil.dpfiterror(i) = temp.error;
-//        coil.dpfitnumitr(i) = simplex_numitr;
-    }
-
-    return coil;
-}
-
-/*********************************************************************************
- * fminsearch Multidimensional unconstrained nonlinear minimization (Nelder-Mead).
- * X = fminsearch(X0, maxiter, maxfun, display, data, sensors) starts at X0 and
- * attempts to find a local minimizer
- *********************************************************************************/
-
-Eigen::MatrixXd RtHPIS::fminsearch(Eigen::MatrixXd pos,int maxiter, int maxfun, int display, Eigen::MatrixXd data, struct sens sensors)
+void RtHPIS::fitCoil(CoilFit& fit)
 {
-    double tolx, tolf, rho, chi, psi, sigma, func_evals, usual_delta, zero_term_delta, temp1, temp2;
-    std::string header, how;
-    int n, itercount, prnt;
-    Eigen::MatrixXd onesn, two2np1, one2n, v, y, v1, tempX1, tempX2, xbar, xr, x, xe, xc, xcc, xin;
-    std::vector <double> fv, fv1;
-    std::vector <int> idx;
-
-    dipError tempdip, fxr, fxe, fxc, fxcc;
-
-    tolx = tolf = 1e-4;
-
-    switch(display)
-    {
-        case 0:
-            prnt = 0;
-            break;
-        default:
-            prnt = 1;
-    }
-
-    header = " Iteration   Func-count     min f(x) Procedure";
-
-    n = pos.cols();
-
-    // Initialize parameters
-    rho = 1; chi = 2; psi = 0.5; sigma = 0.5;
-    onesn = Eigen::MatrixXd::Ones(1,n);
-    two2np1 = one2n = Eigen::MatrixXd::Zero(1,n);
-
-    for(int i = 0;i < n;i++) {
-        two2np1(i) = 1 + i;
-        one2n(i) = i;
-    }
-
-    v = v1 = Eigen::MatrixXd::Zero(n, n+1);
-    fv.resize(n+1);idx.resize(n+1);fv1.resize(n+1);
+    const int nchan = fit.vecData.size();
+    const double dataNorm = fit.vecData.squaredNorm();
 
-    for(int i = 0;i < n; i++) v(i,0) = pos(i);
-
-    tempdip = dipfitError(pos, data, sensors);
-    fv[0] = tempdip.error;
-
-
-    func_evals = 1;itercount = 0;how = "";
-
-    // Continue setting up the initial simplex.
-    // Following improvement suggested by L.Pfeffer at Stanford
-    usual_delta = 0.05;             // 5 percent deltas for non-zero terms
-    zero_term_delta = 0.00025;      // Even smaller delta for zero elements of x
-    xin = pos.transpose();
-
-    for(int j = 0;j < n;j++) {
-        y = xin;
-
-        if(y(j) != 0) y(j) = (1 + usual_delta) * y(j);
-        else y(j) = zero_term_delta;
-
-        v.col(j+1).array() = y;
-        pos = y.transpose();
-        tempdip = dipfitError(pos, data, sensors);
-        fv[j+1] = tempdip.error;
-    }
-
-    // Sort elements of fv
-    base_arr = fv;
-    for (int i = 0; i < n+1; i++) idx[i] = i;
-
-    sort (idx.begin(), idx.end(), RtHPIS::compar);
-
-    for (int i = 0;i < n+1;i++) {
-        v1.col(i) = v.col(idx[i]);
-        fv1[i] = fv[idx[i]];
+    fit.iIterations = 0;
+    if(nchan < 6 || dataNorm <= 0) {
+        fit.dError = 1.0;
+        return;
     }
 
-    v = v1;fv = fv1;
-
-    how = "initial simplex";
-    itercount = itercount + 1;
-    func_evals = n + 1;
+    Eigen::VectorXd res(nchan), resNew(nchan);
+    Eigen::MatrixXd jac(nchan,6), jacNew(nchan,6);
+    Eigen::Vector3d pos = fit.vecPos, posNew;
+    Eigen::Vector3d mom, momNew;
 
-    tempX1 = Eigen::MatrixXd::Zero(1,n);
+    // Linear fit of the moment at the start position - the last three Jacobian columns are the lead field
+    evaluateCoil(fit, pos, Eigen::Vector3d::Zero(), res, jac);
+    mom = jac.rightCols(3).colPivHouseholderQr().solve(fit.vecData);
+    evaluateCoil(fit, pos, mom, res, jac);
 
-    while ((func_evals < maxfun) && (itercount < maxiter)) {
-        for (int i = 0;i < n;i++) tempX1(i) = abs(fv[0] - fv[i+1]);
-        temp1 = tempX1.maxCoeff();
+    double cost = res.squaredNorm();
+    double lambda = 1e-3;
 
-        tempX2 = Eigen::MatrixXd::Zero(n,n);
+    Eigen::Matrix<double,6,6> A;
+    Eigen::Matrix<double,6,1> g, dx;
 
-        for(int i = 0;i < n;i++) tempX2.col(i) = v.col(i+1) -  v.col(0);
+    int iter;
+    for(iter = 0;iter < RTHPIS_LM_MAX_ITERATIONS;iter++) {
+        A = jac.transpose() * jac;
+        g = jac.transpose() * res;
 
-        tempX2 = tempX2.array().abs();
+        // Marquardt scaling - position and moment differ by orders of magnitude
+        A.diagonal() *= 1.0 + lambda;
+        dx = A.ldlt().solve(-g);
 
-        temp2 = tempX2.maxCoeff();
+        posNew = pos + dx.head<3>();
+        momNew = mom + dx.tail<3>();
+        evaluateCoil(fit, posNew, momNew, resNew, jacNew);
+        double costNew = resNew.squaredNorm();
 
-        if((temp1 <= tolf) && (temp2 <= tolx)) break;
+        if(costNew < cost) {
+            bool converged = dx.head<3>().norm() < RTHPIS_LM_POS_TOLERANCE || cost - costNew < 1e-12 * cost;
 
-        xbar = v.block(0,0,n,n).rowwise().sum();
-        xbar /= n;
+            pos = posNew;
+            mom = momNew;
+            res.swap(resNew);
+            jac.swap(jacNew);
+            cost = costNew;
+            lambda = std::max(lambda * 0.1, 1e-12);
 
-        xr = (1+rho) * xbar - rho * v.block(0,n,v.rows(),1);
-
-        x = xr.transpose();
-        //std::cout << "Iteration Count: " << itercount << ":" << x << std::endl;
-
-        fxr = dipfitError(x, data, sensors);
-
-        func_evals = func_evals+1;
-
-        if (fxr.error < fv[0]) {
-            // Calculate the expansion point
-            xe = (1 + rho * chi) * xbar - rho * chi * v.col(v.cols()-1);
-            x = xe.transpose();
-            fxe = dipfitError(x, data, sensors);
-            func_evals = func_evals+1;
-
-            if(fxe.error < fxr.error) {
-                v.col(v.cols()-1) = xe;
-                fv[n] = fxe.error;
-                how = "expand";
-            }
-            else {
-                v.col(v.cols()-1) = xr;
-                fv[n] = fxr.error;
-                how = "reflect";
-            }
+            if(converged)
+                break;
         }
         else {
-            if(fxr.error < fv[n-1]) {
-                v.col(v.cols()-1) = xr;
-                fv[n] = fxr.error;
-                how = "reflect";
-            }
-            else { // fxr.error >= fv[:,n-1]
-                // Perform contraction
-                if(fxr.error < fv[n]) {
-                    // Perform an outside contraction
-                    xc = (1 + psi * rho) * xbar - psi * rho * v.col(v.cols()-1);
-                    x = xc.transpose();
-                    fxc = dipfitError(x, data, sensors);
-                    func_evals = func_evals + 1;
-
-                    if(fxc.error <= fxr.error) {
-                        v.col(v.cols()-1) = xc;
-                        fv[n] = fxc.error;
-                        how = "contract outside";
-                    }
-                    else {
-                        // perform a shrink
-                        how = "shrink";
-                    }
-                }
-                else {
-                    xcc = (1 - psi) * xbar + psi * v.col(v.cols()-1);
-                    x = xcc.transpose();
-                    fxcc = dipfitError(x, data, sensors);
-                    func_evals = func_evals+1;
-                    if(fxcc.error < fv[n]) {
-                        v.col(v.cols()-1) = xcc;
-                        fv[n] = fxcc.error;
-                        how = "contract inside";
-                    }
-                    else {
-                        // perform a shrink
-                        how = "shrink";
-                    }
-                }
-                if(how.compare("shrink") == 0) {
-                    for(int j = 1;j < n+1;j++) {
-                        v.col(j).array() = v.col(0).array() + sigma * (v.col(j).array() - v.col(0).array());
-                        x = v.col(j).array().transpose();
-                        tempdip = dipfitError(x,data, sensors);
-                        fv[j] = tempdip.error;
-                    }
-                }
-            }
-        }
-        // Sort elements of fv
-        base_arr = fv;
-        for (int i = 0; i < n+1; i++) idx[i] = i;
-        sort (idx.begin (), idx.end (), compar);
-        for (int i = 0;i < n+1;i++) {
-            v1.col(i) = v.col(idx[i]);
-            fv1[i] = fv[idx[i]];
+            lambda *= 10;
+            if(lambda > 1e10)
+                break;
         }
-        v = v1;fv = fv1;
-        itercount = itercount + 1;
-
-    } // end of while loop
-//    }while(dipfitError(x, data, sensors).error > 0.1);
-
-    x = v.col(0).transpose();
-
-    // Seok
-    simplex_numitr = itercount;
+    }
 
-    return x;
+    fit.vecPos = pos;
+    fit.vecMom = mom;
+    fit.dError = cost / dataNorm;
+    fit.iIterations = iter;
 }
 
 
-/*********************************************************************************
- * dipfitError computes the error between measured and model data
- * and can be used for non-linear fitting of dipole position.
- * The function has been compared with matlab dipfit_error and it gives
- * same output
- *********************************************************************************/
+//*************************************************************************************************************
 
-dipError RtHPIS::dipfitError(Eigen::MatrixXd pos, Eigen::MatrixXd data, struct sens sensors)
+void RtHPIS::evaluateCoil(const CoilFit& fit, const Eigen::Vector3d& pos, const Eigen::Vector3d& mom, Eigen::VectorXd& res, Eigen::MatrixXd& jac)
 {
-    // Variable Declaration
-    struct dipError e;
-    Eigen::MatrixXd lf, dif;
+    // Same constant as the magnetic dipole model of FieldTrip
+    const double K = 1e-7 / (4 * M_PI);
 
-    // Compute lead field for a magnetic dipole in infinite vacuum
-    lf = ft_compute_leadfield(pos, sensors);
+    const Eigen::MatrixXd& sensorPos = *fit.pSensorPos;
+    const Eigen::MatrixXd& sensorOri = *fit.pSensorOri;
 
-    e.moment = pinv(lf) * data;
+    Eigen::Vector3d rel, ori, lead, grad;
 
-    dif = data - lf * e.moment;
+    for(int i = 0;i < sensorPos.rows();i++) {
+        rel = sensorPos.row(i).transpose() - pos;
+        ori = sensorOri.row(i).transpose();
 
-    e.error = dif.array().square().sum()/data.array().square().sum();
+        double r2 = rel.squaredNorm();
+        double r5inv = 1.0 / (r2 * r2 * sqrt(r2));
+        double a = ori.dot(rel);
+        double c = rel.dot(mom);
+        double d = ori.dot(mom);
 
-    return e;
-}
+        // Field of the dipole along the sensor orientation: K * (3 (o.r)(r.m) - (o.m) |r|^2) / |r|^5
+        lead = K * r5inv * (3 * a * rel - r2 * ori);
 
-/*********************************************************************************
- * ft_compute_leadfield computes a forward solution for a dipole in a a volume
- * conductor model. The forward solution is expressed as the leadfield
- * matrix (Nchan*3), where each column corresponds with the potential or field
- * distributions on all sensors for one of the x,y,z-orientations of the dipole.
- * The function has been compared with matlab ft_compute_leadfield and it gives
- * same output
- *********************************************************************************/
+        // Derivative with respect to the dipole position, which enters as -r
+        grad = -K * r5inv * (3 * (c * ori + a * mom) + (3 * d - 15 * a * c / r2) * rel);
 
-Eigen::MatrixXd RtHPIS::ft_compute_leadfield(Eigen::MatrixXd pos, struct sens sensors)
-{
-
-    Eigen::MatrixXd pnt, ori, lf;
-
-    pnt = sensors.coilpos; // position of each coil
-    ori = sensors.coilori; // orientation of each coil
-
-    lf = magnetic_dipole(pos, pnt, ori);
-
-    lf = sensors.tra * lf;
-
-    return lf;
+        res(i) = lead.dot(mom) - fit.vecData(i);
+        jac.block<1,3>(i,0) = grad.transpose();
+        jac.block<1,3>(i,3) = lead.transpose();
+    }
 }
 
-/*********************************************************************************
- * magnetic_dipole leadfield for a magnetic dipole in an infinite medium
- * The function has been compared with matlab magnetic_dipole and it gives same output
- *********************************************************************************/
 
-Eigen::MatrixXd RtHPIS::magnetic_dipole(Eigen::MatrixXd pos, Eigen::MatrixXd pnt, Eigen::MatrixXd ori) {
 
-    double u0 = 1e-7;
-    int nchan;
-    Eigen::MatrixXd r, r2, r5, x, y, z, mx, my, mz, Tx, Ty, Tz, lf, temp;
-
-    nchan = pnt.rows();
-
-    // Shift the magnetometers so that the dipole is in the origin
-    pnt.array().col(0) -= pos(0);pnt.array().col(1) -= pos(1);pnt.array().col(2) -= pos(2);
-
-    r = pnt.array().square().rowwise().sum().sqrt();
-
-   r2 = r5 = x = y = z = mx = my = mz = Tx = Ty = Tz = lf = Eigen::MatrixXd::Zero(nchan,3);
+/*
+Goodness of fit (for MNE HPI GOF)is
 
-    for(int i = 0;i < nchan;i++) {
-            r2.row(i).array().fill(pow(r(i),2));
-            r5.row(i).array().fill(pow(r(i),5));
-    }
+g = 1 - sum(e_k^2)/sum(y_k^2)
 
-    for(int i = 0;i < nchan;i++) {
-        x.row(i).array().fill(pnt(i,0));
-        y.row(i).array().fill(pnt(i,1));
-        z.row(i).array().fill(pnt(i,2));
-    }
-    mx.col(0).array().fill(1);my.col(1).array().fill(1);mz.col(2).array().fill(1);
+where
 
-    Tx = 3 * x.cwiseProduct(pnt) - mx.cwiseProduct(r2);
-    Ty = 3 * y.cwiseProduct(pnt) - my.cwiseProduct(r2);
-    Tz = 3 * z.cwiseProduct(pnt) - mz.cwiseProduct(r2);
+y_k is the measured signal in channel k
 
-    for(int i = 0;i < nchan;i++) {
-        lf(i,0) = Tx.row(i).dot(ori.row(i));
-        lf(i,1) = Ty.row(i).dot(ori.row(i));
-        lf(i,2) = Tz.row(i).dot(ori.row(i));
-    }
+e_k = y_k - y’_k, the difference of y_k and the signal predicted by the model
+*/
 
-    for(int i = 0;i < nchan;i++) {
-        for(int j = 0;j < 3;j++) {
-            lf(i,j) = u0 * lf(i,j)/(4 * M_PI * r5(i,j));
-        }
-    }
-    return lf;
-}
 
-bool RtHPIS::compar (int a, int b){
-  return ((base_arr)[a] < (base_arr)[b]);
-}
+//*************************************************************************************************************
 
 Eigen::Matrix4d RtHPIS::computeTransformation(Eigen::MatrixXd NH, Eigen::MatrixXd BT)
 {
@@ -927,6 +480,9 @@ Eigen::Matrix4d RtHPIS::computeTransformation(Eigen::MatrixXd NH, Eigen::MatrixX
     return trans;
 }
 
+
+//*************************************************************************************************************
+
 Eigen::MatrixXd RtHPIS::pinv(Eigen::MatrixXd a)
 {
     double epsilon = std::numeric_limits<double>::epsilon();
@@ -934,198 +490,3 @@ Eigen::MatrixXd RtHPIS::pinv(Eigen::MatrixXd a)
     double tolerance = epsilon * std::max(a.cols(), a.rows()) * svd.singularValues().array().abs()(0);
     return svd.matrixV() * (svd.singularValues().array().abs() > tolerance).select(svd.singularValues().array().inverse(),0).matrix().asDiagonal() * svd.matrixU().adjoint();
 }
-std::vector <double>RtHPIS::base_arr;
-
-//*************************************************************************************************************
-
-//void RtHPIS::test()
-//{
-
-//    struct sens sensors;
-//    struct coilParam coil;
-//    int numCoils = 4;
-//    int numCh = m_pFiffInfo->nchan;
-//    int samF = m_pFiffInfo->sfreq;
-//    int numLoc = 3, numBlock, samLoc; // numLoc : Number of times to localize in a second
-//    samLoc = samF/numLoc; // minimum samples required to localize numLoc times in a second
-//    Eigen::VectorXd coilfreq(numCoils);
-//    coilfreq[0] = 154;coilfreq[1] = 158;coilfreq[2] = 162;coilfreq[3] = 166;
-
-//    // Initialize HPI coils location and moment
-//    coil.pos = Eigen::MatrixXd::Zero(numCoils,3);
-//    coil.mom = Eigen::MatrixXd::Zero(numCoils,3);
-
-//    // Generate simulated data
-//    Eigen::MatrixXd simreal(numCoils,samLoc);
-//    Eigen::MatrixXd simimag(numCoils,samLoc);
-//    Eigen::VectorXd time(samLoc);
-
-//    for (int i = 0;i < samLoc;i++) time[i] = i*1.0/samF;
-
-//    double coilnorm;
-
-//    for(int i=0;i<numCoils;i++) {
-//        for(int j=0;j<samLoc;j++) {
-//            simreal(i,j) = cos(2*M_PI*coilfreq[i]*time[j]);
-//            simimag(i,j) = sin(2*M_PI*coilfreq[i]*time[j]);
-//        }
-//        coilnorm = sqrt((simreal.row(i).array().square() + simimag.row(i).array().square()).array().sum());
-//        simreal.row(i) = simreal.row(i) / coilnorm;
-//        simimag.row(i) = simimag.row(i) / coilnorm;
-//    }
-
-//    // Get the indices of reference channels
-//    QVector<int> refind(0);
-//    if (m_pFiffInfo->ch_names.indexOf("TRG013",0) >= 0) refind.append(m_pFiffInfo->ch_names.indexOf("TRG009",0)+1);
-//    if (m_pFiffInfo->ch_names.indexOf("TRG014",0) >= 0) refind.append(m_pFiffInfo->ch_names.indexOf("TRG010",0)+1);
-//    if (m_pFiffInfo->ch_names.indexOf("TRG015",0) >= 0) refind.append(m_pFiffInfo->ch_names.indexOf("TRG011",0)+1);
-//    if (m_pFiffInfo->ch_names.indexOf("TRG016",0) >= 0) refind.append(m_pFiffInfo->ch_names.indexOf("TRG012",0)+1);
-
-//    // Get the indices of inner layer channels
-//    QVector<int> innerind(0);
-//    for (int i = 0;i < numCh;i++) {
-//        if(m_pFiffInfo->chs[i].coil_type == 7002) {
-//            // Check if the sensor is bad, if not append to innerind
-//            if(!(m_pFiffInfo->bads.contains(m_pFiffInfo->ch_names.at(i)))) innerind.append(i);
-//        }
-//    }
-
-//    // Initialize inner layer sensors
-//    sensors.coilpos = Eigen::MatrixXd::Zero(innerind.size(),3);
-//    sensors.coilori = Eigen::MatrixXd::Zero(innerind.size(),3);
-//    sensors.tra = Eigen::MatrixXd::Identity(innerind.size(),innerind.size());
-
-//    for(int i=0;i<innerind.size();i++) {
-//        sensors.coilpos(i,0) = m_pFiffInfo->chs[innerind.at(i)].loc(0,0);
-//        sensors.coilpos(i,1) = m_pFiffInfo->chs[innerind.at(i)].loc(1,0);
-//        sensors.coilpos(i,2) = m_pFiffInfo->chs[innerind.at(i)].loc(2,0);
-//        sensors.coilori(i,0) = m_pFiffInfo->chs[innerind.at(i)].loc(9,0);
-//        sensors.coilori(i,1) = m_pFiffInfo->chs[innerind.at(i)].loc(10,0);
-//        sensors.coilori(i,2) = m_pFiffInfo->chs[innerind.at(i)].loc(11,0);
-//    }
-
-//    //load polhemus HPI
-//    Eigen::MatrixXd headHPI(numCoils,3);
-
-//    // check the m_pFiffInfo->dig information. If dig is empty, set the headHPI is 0;
-//    if (m_pFiffInfo->dig.size()>0)
-//    {
-//        for (int i=0;i<numCoils;i++) {
-//            headHPI(i,0) = m_pFiffInfo->dig.at(i+3).r[0];
-//            headHPI(i,1) = m_pFiffInfo->dig.at(i+3).r[1];
-//            headHPI(i,2) = m_pFiffInfo->dig.at(i+3).r[2];
-//        }
-//    }
-//    else
-//    {
-//        for (int i=0;i<numCoils;i++) {
-//            headHPI(i,0) = 0;
-//            headHPI(i,1) = 0;
-//            headHPI(i,2) = 0;
-//        }
-//        qDebug()<< "Forget to load polhemus HPI! Please stop running and load it again!";
-//    }
-
-//    Eigen::MatrixXd ampreal(innerind.size(),numCoils);
-//    Eigen::MatrixXd ampimag(innerind.size(),numCoils);
-//    Eigen::Matrix4d trans;
-//    Eigen::MatrixXd phasereal(1,samLoc);
-//    Eigen::MatrixXd phaseimag(1,samLoc);
-//    Eigen::MatrixXd ampl(1,samLoc);
-
-//    QVector<MatrixXd> buffer;
-
-
-//    while(m_bIsRunning)
-//    {
-//        if(m_pRawMatrixBuffer)
-//        {
-//            MatrixXd t_mat = m_pRawMatrixBuffer->pop();
-
-//            buffer.append(t_mat);
-
-//            if(buffer.size()*t_mat.cols() >= samLoc) {
-
-//                Eigen::MatrixXd alldata(t_mat.rows(),buffer.size()*t_mat.cols());
-
-//                // Concatenate data into a matrix
-//                for(int i=0;i<buffer.size();i++) alldata << buffer[i];
-
-
-//                // Get the data from inner layer channels
-//                Eigen::MatrixXd innerdata(innerind.size(),samLoc);
-//                Eigen::MatrixXd refdata(numCoils,samLoc);
-
-//                numBlock = alldata.cols()/samLoc;
-
-//                // Loop for localizing coils
-//                for(int i = 0;i<numBlock;i++) {
-
-//                    for(int j = 0;j < innerind.size();j++) {
-//                        std::cout << innerind[j] << std::endl;
-//                        innerdata.row(j) << alldata.block(innerind[j],i*samLoc,1,samLoc);
-//                    }
-
-//                    for(int j = 0;j < refind.size();j++)
-//                        refdata.row(j) << alldata.block(refind[j],i*samLoc,1,samLoc);
-
-//                    ampreal = innerdata*simreal.transpose();
-//                    ampimag = innerdata*simimag.transpose()*-1;
-
-//                    phasereal = (refdata.array() * simreal.array()).array().colwise().sum();
-//                    phaseimag = (refdata.array() * simimag.array()).array().colwise().sum();
-
-//                    ampl = sqrt(phasereal.array().square() + phaseimag.array().square());
-
-//                    phasereal = phasereal.array() / ampl.array();
-//                    phaseimag = phaseimag.array() / ampl.array();
-
-//                    for(int i = 0;i < numCoils;i++)
-//                        ampreal.col(i).array() = ampreal.col(i) * phasereal(i) - ampimag.col(i) * phaseimag(i);
-
-////                    for(int i = 0;i<innerdata.rows();i++) {
-////                        for(int j=0;j<4;j++) {
-////                            std::cout<<innerdata(i,j)<< "  ";
-
-////                        }
-////                        std::cout << std::endl;
-////                     }
-
-
-
-
-////                    std::cout << ampreal.rows() << std::endl;
-////                    std::cout << ampreal.cols() << std::endl;
-
-//                    coil = dipfit(coil, sensors, ampreal, numCoils);
-
-//                    qDebug()<<"HPI head "<<headHPI(0,0)<<" "<<headHPI(0,1)<<" "<<headHPI(0,2);
-//                    qDebug()<<"HPI head "<<headHPI(1,0)<<" "<<headHPI(1,1)<<" "<<headHPI(1,2);
-//                    qDebug()<<"HPI head "<<headHPI(2,0)<<" "<<headHPI(2,1)<<" "<<headHPI(2,2);
-//                    qDebug()<<"HPI head "<<headHPI(3,0)<<" "<<headHPI(3,1)<<" "<<headHPI(3,2);
-
-
-//                    qDebug()<<"HPI device "<<coil.pos(0,0)<<" "<<coil.pos(0,1)<<" "<<coil.pos(0,2);
-//                    qDebug()<<"HPI device "<<coil.pos(1,0)<<" "<<coil.pos(1,1)<<" "<<coil.pos(1,2);
-//                    qDebug()<<"HPI device "<<coil.pos(2,0)<<" "<<coil.pos(2,1)<<" "<<coil.pos(2,2);
-//                    qDebug()<<"HPI device "<<coil.pos(3,0)<<" "<<coil.pos(3,1)<<" "<<coil.pos(3,2);
-
-//                    trans = computeTransformation(coil.pos,headHPI);
-
-//                    for(int ti =0; ti<4;ti++)
-//                        for(int tj=0;tj<4;tj++)
-//                    m_pFiffInfo->dev_head_t.trans(ti,tj) = trans(ti,tj);
-
-//                }
-//                buffer.clear();
-//            }
-
-
-//        }//m_pRawMatrixBuffer
-
-
-
-//    } //m_bIsRunning
-
-//}
-
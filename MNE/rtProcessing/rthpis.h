@@ -79,6 +79,16 @@
 #include <Eigen/Core>
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define RTHPIS_LOCALIZATIONS_PER_SEC    10      /**< Number of head position updates per second, sets the demodulation window length. */
+#define RTHPIS_LM_MAX_ITERATIONS        50      /**< Maximal number of Levenberg-Marquardt iterations per coil. */
+#define RTHPIS_LM_POS_TOLERANCE         1e-7    /**< Position step in meters below which a coil fit has converged. */
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE NAMESPACE RTPROCESSINGLIB
@@ -109,11 +119,6 @@ struct coilParam {
     Eigen::VectorXd dpfitnumitr;
 };
 
-struct dipError {
-    double error;
-    Eigen::MatrixXd moment;
-};
-
 struct sens {
     Eigen::MatrixXd coilpos;
     Eigen::MatrixXd coilori;
@@ -183,23 +188,38 @@ public:
     */
     virtual bool stop();
 
-    dipError dipfitError (Eigen::MatrixXd, Eigen::MatrixXd, struct sens);
-    Eigen::MatrixXd ft_compute_leadfield(Eigen::MatrixXd, struct sens);
-    Eigen::MatrixXd magnetic_dipole(Eigen::MatrixXd, Eigen::MatrixXd, Eigen::MatrixXd);
-    coilParam dipfit(struct coilParam, struct sens, Eigen::MatrixXd, int numCoils);
-    Eigen::MatrixXd fminsearch(Eigen::MatrixXd,int, int, int, Eigen::MatrixXd, struct sens);
-    static bool compar (int, int);
     Eigen::MatrixXd pinv(Eigen::MatrixXd);
     Eigen::Matrix4d computeTransformation(Eigen::MatrixXd, Eigen::MatrixXd);
 
-    //void test();
+    //=========================================================================================================
+    /**
+    * Input and result of the fit of one coil.
+    */
+    struct CoilFit {
+        const Eigen::MatrixXd*  pSensorPos;     /**< Sensor positions - one row per channel. */
+        const Eigen::MatrixXd*  pSensorOri;     /**< Sensor orientations - one row per channel. */
+        Eigen::VectorXd         vecData;        /**< Demodulated amplitude of the coil on each channel. */
+        Eigen::Vector3d         vecPos;         /**< Coil position, the start value on input. */
+        Eigen::Vector3d         vecMom;         /**< Coil moment. */
+        double                  dError;         /**< Relative residual, 1 - goodness of fit. */
+        qint32                  iIterations;    /**< Number of iterations used. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Fits position and moment of a magnetic dipole to the demodulated amplitudes of one coil with the
+    * Levenberg-Marquardt method. The moment is initialized by a linear fit at the start position.
+    *
+    * @param[in, out] fit   The coil fit
+    */
+    static void fitCoil(CoilFit& fit);
 
 signals:
     //=========================================================================================================
     /**
     * Signal which is emitted when a new data Matrix is estimated.
     *
-    * @param[out]
+    * @param[out]   The device to head transformation (4 x 4)
     */
     void HPICalculated(Eigen::MatrixXd);
 
@@ -213,6 +233,19 @@ protected:
     virtual void run();
 
 private:
+    //=========================================================================================================
+    /**
+    * Computes the residual of the magnetic dipole model and its analytic Jacobian with respect to the
+    * position (first three columns) and the moment (last three columns, the lead field).
+    *
+    * @param[in] fit        The coil fit which holds the sensors and the data
+    * @param[in] pos        Dipole position
+    * @param[in] mom        Dipole moment
+    * @param[out] res       Model minus data - one row per channel
+    * @param[out] jac       Jacobian of the residual - channels x 6
+    */
+    static void evaluateCoil(const CoilFit& fit, const Eigen::Vector3d& pos, const Eigen::Vector3d& mom, Eigen::VectorXd& res, Eigen::MatrixXd& jac);
+
     QMutex      mutex;                  /**< Provides access serialization between threads*/
 
     quint32      m_iMaxSamples;         /**< Maximal amount of samples received, before covariance is estimated.*/
@@ -232,9 +265,6 @@ private:
 //    qint32 m_iFFTlength;
 //    qint32 m_dataLength;
 
-    static std::vector <double>base_arr;
-
-
 //protected:
 //    int NumOfBlocks;
 //    int BlockSize  ;
@@ -249,8 +279,6 @@ public:
 
     bool SendDataToBuffer;
 
-    int simplex_numitr;
-
 };
 
 //*************************************************************************************************************
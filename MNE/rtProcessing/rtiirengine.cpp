@@ -0,0 +1,218 @@
+//=============================================================================================================
+/**
+* @file     rtiirengine.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the RtIirEngine Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rtiirengine.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace Eigen;
+using namespace UTILSLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+RtIirEngine::RtIirEngine()
+: m_iNumChannels(0)
+, m_iBlockSize(0)
+, m_bAllChannels(false)
+{
+}
+
+
+//*************************************************************************************************************
+
+void RtIirEngine::setFilters(const QList<FilterData>& lFilterData, const QVector<int>& lFilterChannelList)
+{
+    m_lSos.clear();
+    m_vecFilterChannels = lFilterChannelList;
+
+    int t_iNumSections = 0;
+    for(int i = 0; i < lFilterData.size(); ++i) {
+        if(lFilterData.at(i).isIIR()) {
+            m_lSos.append(lFilterData.at(i).m_matSos);
+            t_iNumSections += lFilterData.at(i).m_matSos.rows();
+        }
+    }
+
+    //One cascade of all sections, normalized to a0 = 1
+    m_matSos.resize(t_iNumSections, 6);
+
+    int t_iRow = 0;
+    for(int i = 0; i < m_lSos.size(); ++i) {
+        for(int s = 0; s < m_lSos.at(i).rows(); ++s, ++t_iRow)
+            m_matSos.row(t_iRow) = m_lSos.at(i).row(s) / m_lSos.at(i)(s,3);
+    }
+
+    if(m_iNumChannels > 0)
+        prepare(m_iNumChannels, m_iBlockSize);
+}
+
+
+//*************************************************************************************************************
+
+bool RtIirEngine::hasFilters(const QList<FilterData>& lFilterData, const QVector<int>& lFilterChannelList) const
+{
+    if(lFilterChannelList != m_vecFilterChannels)
+        return false;
+
+    int t_iIir = 0;
+    for(int i = 0; i < lFilterData.size(); ++i) {
+        if(!lFilterData.at(i).isIIR())
+            continue;
+
+        const MatrixXd& t_matSos = lFilterData.at(i).m_matSos;
+        if(t_iIir >= m_lSos.size() || t_matSos.rows() != m_lSos.at(t_iIir).rows() || t_matSos != m_lSos.at(t_iIir))
+            return false;
+        ++t_iIir;
+    }
+
+    return t_iIir == m_lSos.size();
+}
+
+
+//*************************************************************************************************************
+
+void RtIirEngine::reset()
+{
+    m_matState.setZero();
+}
+
+
+//*************************************************************************************************************
+
+void RtIirEngine::prepare(int iNumChannels, int iBlockSize)
+{
+    m_iNumChannels = iNumChannels;
+    m_iBlockSize = iBlockSize;
+
+    QVector<bool> t_vecFiltered(iNumChannels, false);
+    for(int i = 0; i < m_vecFilterChannels.size(); ++i) {
+        int t_iChannel = m_vecFilterChannels.at(i);
+        if(t_iChannel >= 0 && t_iChannel < iNumChannels)
+            t_vecFiltered[t_iChannel] = true;
+    }
+
+    m_vecChannels.clear();
+    for(int i = 0; i < iNumChannels; ++i) {
+        if(t_vecFiltered.at(i))
+            m_vecChannels.append(i);
+    }
+
+    m_bAllChannels = (m_vecChannels.size() == iNumChannels);
+
+    m_matWork.resize(m_bAllChannels ? 0 : m_vecChannels.size(), m_bAllChannels ? 0 : iBlockSize);
+    m_matState = MatrixXd::Zero(m_vecChannels.size(), 2 * m_matSos.rows());
+    m_vecOut.resize(m_vecChannels.size());
+}
+
+
+//*************************************************************************************************************
+
+void RtIirEngine::filter(MatrixXd& matData)
+{
+    if(m_matSos.rows() == 0)
+        return;
+
+    //The state only depends on the channels - a new block size just needs other work memory
+    if(matData.rows() != m_iNumChannels) {
+        prepare(matData.rows(), matData.cols());
+    } else if(matData.cols() != m_iBlockSize) {
+        m_iBlockSize = matData.cols();
+        if(!m_bAllChannels)
+            m_matWork.resize(m_vecChannels.size(), m_iBlockSize);
+    }
+
+    if(m_vecChannels.isEmpty())
+        return;
+
+    if(m_bAllChannels) {
+        runSections(matData);
+        return;
+    }
+
+    for(int j = 0; j < m_vecChannels.size(); ++j)
+        m_matWork.row(j) = matData.row(m_vecChannels.at(j));
+
+    runSections(m_matWork);
+
+    for(int j = 0; j < m_vecChannels.size(); ++j)
+        matData.row(m_vecChannels.at(j)) = m_matWork.row(j);
+}
+
+
+//*************************************************************************************************************
+
+void RtIirEngine::filter(const MatrixXd& matDataIn, MatrixXd& matDataOut)
+{
+    //Keep the caller's storage if it already has the right shape
+    matDataOut = matDataIn;
+    filter(matDataOut);
+}
+
+
+//*************************************************************************************************************
+
+void RtIirEngine::runSections(MatrixXd& matData)
+{
+    int t_iNumSamples = matData.cols();
+
+    //Transposed direct form II. Every statement updates all channels of one sample, which are contiguous in memory.
+    for(int s = 0; s < m_matSos.rows(); ++s) {
+        double b0 = m_matSos(s,0);
+        double b1 = m_matSos(s,1);
+        double b2 = m_matSos(s,2);
+        double a1 = m_matSos(s,4);
+        double a2 = m_matSos(s,5);
+
+        for(int t = 0; t < t_iNumSamples; ++t) {
+            m_vecOut = b0 * matData.col(t) + m_matState.col(2*s);
+            m_matState.col(2*s) = b1 * matData.col(t) - a1 * m_vecOut + m_matState.col(2*s+1);
+            m_matState.col(2*s+1) = b2 * matData.col(t) - a2 * m_vecOut;
+            matData.col(t) = m_vecOut;
+        }
+    }
+}
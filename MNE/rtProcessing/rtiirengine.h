@@ -0,0 +1,189 @@
+//=============================================================================================================
+/**
+* @file     rtiirengine.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the RtIirEngine Class.
+*
+*/
+
+#ifndef RTIIRENGINE_H
+#define RTIIRENGINE_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rtprocessing_global.h"
+
+#include <utils/filterTools/filterdata.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QList>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE RTPROCESSINGLIB
+//=============================================================================================================
+
+namespace RTPROCESSINGLIB
+{
+
+
+//=============================================================================================================
+/**
+* Streaming multi-channel IIR filter. Runs the second-order sections of all IIR filters (see FilterData::isIIR)
+* as one cascade in transposed direct form II and keeps the two state values of every section and channel across
+* blocks. The kernel steps through the samples of a section and updates all channels of a sample at once; as
+* Eigen stores a block column by column, these updates run on contiguous memory and are vectorized across
+* channels. Nothing is allocated while the block shape stays the same.
+*
+* @brief Streaming second-order section IIR engine.
+*/
+class RTPROCESSINGSHARED_EXPORT RtIirEngine
+{
+public:
+    //=========================================================================================================
+    /**
+    * Creates an engine without sections. Until setFilters is called with IIR filters, filter leaves the data
+    * untouched.
+    */
+    RtIirEngine();
+
+    //=========================================================================================================
+    /**
+    * Sets the filters and the channels they are applied to. FIR filters in the list are skipped. Resets the state.
+    *
+    * @param[in] lFilterData            the filters to apply
+    * @param[in] lFilterChannelList     indices of the channels which are to be filtered
+    */
+    void setFilters(const QList<UTILSLIB::FilterData>& lFilterData, const QVector<int>& lFilterChannelList);
+
+    //=========================================================================================================
+    /**
+    * Returns whether the engine is configured with the sections of the given filters and the given channels.
+    *
+    * @param[in] lFilterData            the filters to compare with
+    * @param[in] lFilterChannelList     the channel indices to compare with
+    *
+    * @return true if setFilters was called with equal sections and channels
+    */
+    bool hasFilters(const QList<UTILSLIB::FilterData>& lFilterData, const QVector<int>& lFilterChannelList) const;
+
+    //=========================================================================================================
+    /**
+    * Clears the filter state, e.g. after a gap in the data stream.
+    */
+    void reset();
+
+    //=========================================================================================================
+    /**
+    * Filters one block in place. Channels which are not in the channel list are left untouched.
+    *
+    * @param[in, out] matData   the block which is to be filtered
+    */
+    void filter(Eigen::MatrixXd& matData);
+
+    //=========================================================================================================
+    /**
+    * Filters one block. The output storage is only reallocated if its shape differs from the input.
+    *
+    * @param[in] matDataIn      the block which is to be filtered
+    * @param[out] matDataOut    the filtered block
+    */
+    void filter(const Eigen::MatrixXd& matDataIn, Eigen::MatrixXd& matDataOut);
+
+    //=========================================================================================================
+    /**
+    * Returns the number of second-order sections of the cascade.
+    *
+    * @return the number of sections
+    */
+    inline int numSections() const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Prepares channel selection, state and work memory for the given number of channels. Resets the state.
+    *
+    * @param[in] iNumChannels   number of rows of the blocks
+    * @param[in] iBlockSize     number of columns of the blocks
+    */
+    void prepare(int iNumChannels, int iBlockSize);
+
+    //=========================================================================================================
+    /**
+    * Runs all sections over a block whose rows are the filtered channels.
+    *
+    * @param[in, out] matData   the block
+    */
+    void runSections(Eigen::MatrixXd& matData);
+
+    QList<Eigen::MatrixXd>  m_lSos;                 /**< Sections of the filters as they were set. */
+    QVector<int>            m_vecFilterChannels;    /**< Channel list as it was set. */
+    Eigen::MatrixXd         m_matSos;               /**< Sections of the cascade, normalized to a0 = 1. */
+
+    int                     m_iNumChannels;         /**< Number of rows the engine is prepared for. */
+    int                     m_iBlockSize;           /**< Number of columns the engine is prepared for. */
+    QVector<int>            m_vecChannels;          /**< Valid filtered rows in ascending order. */
+    bool                    m_bAllChannels;         /**< Whether all rows are filtered, i.e. the block can be filtered without gathering. */
+    Eigen::MatrixXd         m_matWork;              /**< Gathered rows of the filtered channels. */
+    Eigen::MatrixXd         m_matState;             /**< Two state columns per section, one row per filtered channel. */
+    Eigen::VectorXd         m_vecOut;               /**< Output of a section for one sample of all channels. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline int RtIirEngine::numSections() const
+{
+    return m_matSos.rows();
+}
+
+} // NAMESPACE
+
+#endif // RTIIRENGINE_H
@@ -48,6 +48,24 @@
 //=============================================================================================================
 
 #include <QDebug>
+#include <QtConcurrent/QtConcurrent>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Eigenvalues>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <limits>
+#include <math.h>
 
 
 //*************************************************************************************************************
@@ -66,8 +84,14 @@ using namespace RTPROCESSINGLIB;
 RtInvOp::RtInvOp(FiffInfo::SPtr &p_pFiffInfo, MNEForwardSolution::SPtr &p_pFwd, QObject *parent)
 : QThread(parent)
 , m_bIsRunning(false)
+, m_bNoiseCovPending(false)
 , m_pFiffInfo(p_pFiffInfo)
 , m_pFwd(p_pFwd)
+, m_fLoose(0.2f)
+, m_fDepth(0.8f)
+, m_bCacheValid(false)
+, m_bFixedOri(false)
+, m_iMethods(FIFFV_MNE_MEG)
 {
     qRegisterMetaType<MNEInverseOperator::SPtr>("MNEInverseOperator::SPtr");
 }
@@ -86,12 +110,30 @@ RtInvOp::~RtInvOp()
 void RtInvOp::appendNoiseCov(FiffCov &p_noiseCov)
 {
     mutex.lock();
-    //Use here a circular buffer
-    m_vecNoiseCov.push_back(p_noiseCov);
+    //Only the latest inverse operator matters -> newer covariances supersede pending ones
+    m_noiseCov = p_noiseCov;
+    m_bNoiseCovPending = true;
+    m_waitCondition.wakeOne();
+    mutex.unlock();
+}
+
 
-    qDebug() << "RtInvOp m_vecNoiseCov" << m_vecNoiseCov.size();
+//*************************************************************************************************************
+
+bool RtInvOp::start()
+{
+    //Check if the thread is already or still running. This can happen if the start button is pressed immediately after the stop button was pressed. In this case the stopping process is not finished yet but the start process is initiated.
+    if(QThread::isRunning())
+        QThread::wait();
 
+    //Set before the thread starts - a stop() in between must not be overwritten by the thread
+    mutex.lock();
+    m_bIsRunning = true;
     mutex.unlock();
+
+    QThread::start();
+
+    return true;
 }
 
 
@@ -99,7 +141,11 @@ void RtInvOp::appendNoiseCov(FiffCov &p_noiseCov)
 
 bool RtInvOp::stop()
 {
+    mutex.lock();
     m_bIsRunning = false;
+    m_waitCondition.wakeAll();
+    mutex.unlock();
+
     QThread::wait();
 
     return true;
@@ -110,21 +156,238 @@ bool RtInvOp::stop()
 
 void RtInvOp::run()
 {
-    m_bIsRunning = true;
+    // Restrict forward solution as necessary for MEG
+    m_forwardMeg = m_pFwd->pick_types(true, false);
+    m_bCacheValid = false;
 
-    while(m_bIsRunning)
+    while(true)
     {
-        if(m_vecNoiseCov.size() > 0)
-        {
-            // Restrict forward solution as necessary for MEG
-            MNEForwardSolution t_forwardMeg = m_pFwd->pick_types(true, false);
+        mutex.lock();
+        while(m_bIsRunning && !m_bNoiseCovPending)
+            m_waitCondition.wait(&mutex);
 
-            mutex.lock();
-            MNEInverseOperator::SPtr t_invOpMeg(new MNEInverseOperator(*m_pFiffInfo.data(), t_forwardMeg, m_vecNoiseCov[0], 0.2f, 0.8f));
-            m_vecNoiseCov.pop_front();
+        if(!m_bIsRunning)
+        {
             mutex.unlock();
+            break;
+        }
+
+        FiffCov t_noiseCov = m_noiseCov;
+        m_bNoiseCovPending = false;
+        mutex.unlock();
+
+        MNEInverseOperator::SPtr t_invOpMeg = computeInverseOperator(t_noiseCov);
+
+        emit invOperatorCalculated(t_invOpMeg);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void RtInvOp::computeLeadsBlock(LeadsBlock& block)
+{
+    block.pLeads->middleRows(block.iFirst, block.iRows).noalias() = block.pWeightedGain->middleCols(block.iFirst, block.iRows).transpose() * (*block.pFactor);
+}
+
+
+//*************************************************************************************************************
+
+QStringList RtInvOp::pickChannels(const FiffCov &p_noiseCov) const
+{
+    QStringList fwd_ch_names, ch_names;
+    for(qint32 i = 0; i < m_forwardMeg.info.chs.size(); ++i)
+        fwd_ch_names << m_forwardMeg.info.chs[i].ch_name;
+
+    //Same selection as MNEForwardSolution::prepare_forward
+    for(qint32 i = 0; i < m_pFiffInfo->chs.size(); ++i)
+        if(     !m_pFiffInfo->bads.contains(m_pFiffInfo->chs[i].ch_name)
+            &&  !p_noiseCov.bads.contains(m_pFiffInfo->chs[i].ch_name)
+            &&  fwd_ch_names.contains(m_pFiffInfo->chs[i].ch_name))
+            ch_names << m_pFiffInfo->chs[i].ch_name;
+
+    return ch_names;
+}
+
+
+//*************************************************************************************************************
+
+bool RtInvOp::prepareCache(const FiffCov &p_noiseCov)
+{
+    m_bFixedOri = m_forwardMeg.isFixedOrient();
+
+    //The full computation reports these cases
+    if(m_fDepth <= 0 || m_fDepth > 1 || m_fLoose < 0 || m_fLoose > 1)
+        return false;
+    if(!m_bFixedOri && m_forwardMeg.source_ori == -1 && m_fLoose > 0)
+        return false;
+
+    FiffInfo gain_info;
+    MatrixXd gain;
+    MatrixXd whitener;
+    qint32 n_nzero;
+    FiffCov t_noiseCov;
+    m_forwardMeg.prepare_forward(*m_pFiffInfo, p_noiseCov, false, gain_info, gain, t_noiseCov, whitener, n_nzero);
+
+    if(gain.rows() == 0)
+        return false;
+
+    //
+    // Depth and orientation priors compose the source covariance
+    //
+    m_depthPrior = MNEForwardSolution::compute_depth_prior(gain, gain_info, m_bFixedOri, m_fDepth, 10.0, MatrixXd(), true);
+
+    m_sourceCov = m_depthPrior;
+    if(!m_bFixedOri)
+    {
+        m_orientPrior = m_forwardMeg.compute_orient_prior(m_fLoose);
+        m_sourceCov.data.array() *= m_orientPrior.data.array();
+    }
+
+    //
+    // Source weighting of the gain and its Gram matrix - the whitener is applied to the Gram matrix later on
+    //
+    m_matWeightedGain = gain * m_sourceCov.data.col(0).cwiseSqrt().asDiagonal();
+
+    MatrixXd t_matGram = MatrixXd::Zero(m_matWeightedGain.rows(), m_matWeightedGain.rows());
+    t_matGram.selfadjointView<Lower>().rankUpdate(m_matWeightedGain);
+    m_matWeightedGainGram = t_matGram.selfadjointView<Lower>();
+
+    //
+    // Methods
+    //
+    bool has_meg = false;
+    bool has_eeg = false;
+    for(qint32 i = 0; i < m_pFiffInfo->chs.size(); ++i)
+    {
+        if(gain_info.ch_names.contains(m_pFiffInfo->chs[i].ch_name))
+        {
+            QString ch_type = m_pFiffInfo->channel_type(i);
+            if (ch_type == "eeg")
+                has_eeg = true;
+            if ((ch_type == "mag") || (ch_type == "grad"))
+                has_meg = true;
+        }
+    }
+
+    if(has_eeg && has_meg)
+        m_iMethods = FIFFV_MNE_MEG_EEG;
+    else if(has_meg)
+        m_iMethods = FIFFV_MNE_MEG;
+    else
+        m_iMethods = FIFFV_MNE_EEG;
+
+    m_gainInfo = gain_info;
+    m_qListCacheChNames = pickChannels(p_noiseCov);
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+MNEInverseOperator::SPtr RtInvOp::computeInverseOperator(const FiffCov &p_noiseCov)
+{
+    QStringList t_qListChNames = pickChannels(p_noiseCov);
 
-            emit invOperatorCalculated(t_invOpMeg);
+    if(!m_bCacheValid || t_qListChNames != m_qListCacheChNames)
+        m_bCacheValid = prepareCache(p_noiseCov);
+
+    if(!m_bCacheValid)
+        return MNEInverseOperator::SPtr(new MNEInverseOperator(*m_pFiffInfo.data(), m_forwardMeg, p_noiseCov, m_fLoose, m_fDepth));
+
+    //
+    // Whitener of the picked channels, omitting the zeroes due to projection
+    //
+    FiffCov t_noiseCov = p_noiseCov.prepare_noise_cov(*m_pFiffInfo, t_qListChNames);
+
+    qint32 n_chan = t_qListChNames.size();
+    qint32 n_nzero = 0;
+    MatrixXd t_matWhitener = MatrixXd::Zero(n_chan, n_chan);
+    for(qint32 i = 0; i < t_noiseCov.eig.rows(); ++i)
+    {
+        if(t_noiseCov.eig[i] > 0)
+        {
+            // Rows of eigvec are the eigenvectors
+            t_matWhitener.row(i) = t_noiseCov.eigvec.row(i) / sqrt(t_noiseCov.eig[i]);
+            ++n_nzero;
         }
     }
+
+    //
+    // Gram matrix of the whitened and weighted gain G = W * Gs, i.e. G * G^T = W * (Gs * Gs^T) * W^T. Its trace
+    // adjusts the source covariance so that trace(G * R * G^T) equals the number of sensors.
+    //
+    MatrixXd t_matGram = t_matWhitener * m_matWeightedGainGram * t_matWhitener.transpose();
+
+    double trace_GRGT = t_matGram.trace();
+    double scaling_source_cov = (double)n_nzero / trace_GRGT;
+    t_matGram *= scaling_source_cov;
+
+    //
+    // SVD of G from the eigen decomposition of G * G^T: U are the eigenvectors, the singular values the roots of
+    // the eigenvalues and V = G^T * U * S^-1. Directions without signal get a zero singular value.
+    //
+    SelfAdjointEigenSolver<MatrixXd> t_eigSolver(t_matGram);
+    const VectorXd& t_vecEig = t_eigSolver.eigenvalues();
+    double t_dTol = t_vecEig.cwiseAbs().maxCoeff() * n_chan * std::numeric_limits<double>::epsilon();
+
+    VectorXd p_sing = VectorXd::Zero(n_chan);
+    MatrixXd t_U(n_chan, n_chan);
+    for(qint32 k = 0; k < n_chan; ++k)
+    {
+        // Eigenvalues are ascending, singular values descending
+        qint32 j = n_chan - 1 - k;
+        t_U.col(k) = t_eigSolver.eigenvectors().col(j);
+        if(t_vecEig[j] > t_dTol)
+            p_sing[k] = sqrt(t_vecEig[j]);
+    }
+
+    MatrixXd t_matLeadsFactor = t_matWhitener.transpose() * t_U;
+    for(qint32 k = 0; k < n_chan; ++k)
+        t_matLeadsFactor.col(k) *= p_sing[k] > 0 ? sqrt(scaling_source_cov) / p_sing[k] : 0.0;
+
+    //The product with the full gain dominates - its rows are spread over the cores
+    MatrixXd t_V(m_matWeightedGain.cols(), n_chan);
+    qint32 t_iNumBlocks = qMax(1, QThread::idealThreadCount());
+    QVector<LeadsBlock> t_vecBlocks(t_iNumBlocks);
+    for(qint32 b = 0; b < t_iNumBlocks; ++b)
+    {
+        t_vecBlocks[b].pWeightedGain = &m_matWeightedGain;
+        t_vecBlocks[b].pFactor = &t_matLeadsFactor;
+        t_vecBlocks[b].pLeads = &t_V;
+        t_vecBlocks[b].iFirst = (qint32)((qint64)t_V.rows() * b / t_iNumBlocks);
+        t_vecBlocks[b].iRows = (qint32)((qint64)t_V.rows() * (b+1) / t_iNumBlocks) - t_vecBlocks[b].iFirst;
+    }
+    QtConcurrent::blockingMap(t_vecBlocks, &RtInvOp::computeLeadsBlock);
+
+    //
+    // Compose the inverse operator as MNEInverseOperator::make_inverse_operator does
+    //
+    FiffCov::SDPtr p_source_cov(new FiffCov(m_sourceCov));
+    p_source_cov->data.array() *= scaling_source_cov;
+
+    MNEInverseOperator::SPtr p_invOp(new MNEInverseOperator());
+    p_invOp->eigen_fields = FiffNamedMatrix::SDPtr(new FiffNamedMatrix(t_U.cols(), t_U.rows(), defaultQStringList, m_gainInfo.ch_names, t_U.transpose()));
+    p_invOp->eigen_leads = FiffNamedMatrix::SDPtr(new FiffNamedMatrix(t_V.rows(), t_V.cols(), defaultQStringList, defaultQStringList, t_V));
+    p_invOp->sing = p_sing;
+    p_invOp->nave = 1;
+    p_invOp->depth_prior = FiffCov::SDPtr(new FiffCov(m_depthPrior));
+    p_invOp->source_cov = p_source_cov;
+    p_invOp->noise_cov = FiffCov::SDPtr(new FiffCov(t_noiseCov));
+    if(!m_bFixedOri)
+        p_invOp->orient_prior = FiffCov::SDPtr(new FiffCov(m_orientPrior));
+    p_invOp->projs = m_pFiffInfo->projs;
+    p_invOp->eigen_leads_weighted = false;
+    p_invOp->source_ori = m_forwardMeg.source_ori;
+    p_invOp->mri_head_t = m_forwardMeg.mri_head_t;
+    p_invOp->methods = m_iMethods;
+    p_invOp->nsource = m_forwardMeg.nsource;
+    p_invOp->coord_frame = m_forwardMeg.coord_frame;
+    p_invOp->source_nn = m_forwardMeg.source_nn;
+    p_invOp->src = m_forwardMeg.src;
+    p_invOp->info = m_forwardMeg.info;
+    p_invOp->info.bads = m_pFiffInfo->bads;
+
+    return p_invOp;
 }
@@ -67,6 +67,7 @@
 
 #include <QThread>
 #include <QMutex>
+#include <QWaitCondition>
 #include <QSharedPointer>
 
 
@@ -99,7 +100,11 @@ using namespace MNELIB;
 
 //=============================================================================================================
 /**
-* Real-time inverse dSPM, sLoreta inverse operator estimation
+* Real-time inverse dSPM, sLoreta inverse operator estimation. The parts of the inverse operator which do not depend
+* on the noise covariance - the picked gain matrix, the depth and orientation priors and the weighted gain - are
+* prepared once and kept as long as the channel selection stays the same. A new covariance then only requires its
+* whitener and the decomposition of the whitened gain, which is obtained from the small channel-by-channel Gram
+* matrix of the weighted gain instead of an SVD of the full gain matrix.
 *
 * @brief Real-time inverse operator estimation
 */
@@ -128,12 +133,21 @@ public:
 
     //=========================================================================================================
     /**
-    * Slot to receive incoming noise covariance estimations.
+    * Slot to receive incoming noise covariance estimations. Only the latest covariance is kept - a covariance
+    * which has not been processed yet is superseded by a newer one.
     *
     * @param[in] p_NoiseCov     Noise covariance estimation
     */
     void appendNoiseCov(FiffCov &p_NoiseCov);
 
+    //=========================================================================================================
+    /**
+    * Starts the RtInv by starting the producer's thread.
+    *
+    * @return true if succeeded, false otherwise
+    */
+    virtual bool start();
+
     //=========================================================================================================
     /**
     * Stops the RtInv by stopping the producer's thread.
@@ -169,13 +183,82 @@ protected:
     virtual void run();
 
 private:
+    //=========================================================================================================
+    /**
+    * Rows of the eigen leads which are computed by one worker.
+    */
+    struct LeadsBlock {
+        const MatrixXd* pWeightedGain;  /**< The weighted gain. */
+        const MatrixXd* pFactor;        /**< Maps the weighted gain onto the eigen leads. */
+        MatrixXd*       pLeads;         /**< The eigen leads. */
+        qint32          iFirst;         /**< First row of the block. */
+        qint32          iRows;          /**< Number of rows of the block. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Computes the rows of the eigen leads of a block.
+    *
+    * @param[in] block  the block
+    */
+    static void computeLeadsBlock(LeadsBlock& block);
+
+    //=========================================================================================================
+    /**
+    * Returns the channels the inverse operator is computed for: good channels of the measurement which are part of
+    * the forward solution and not bad in the covariance.
+    *
+    * @param[in] p_noiseCov     the noise covariance
+    *
+    * @return the channel names
+    */
+    QStringList pickChannels(const FiffCov &p_noiseCov) const;
+
+    //=========================================================================================================
+    /**
+    * Prepares the covariance independent parts of the inverse operator for the channels of the given covariance.
+    * Processing thread only.
+    *
+    * @param[in] p_noiseCov     the noise covariance
+    *
+    * @return true if the cache could be prepared, false if the inverse operator has to be computed in full
+    */
+    bool prepareCache(const FiffCov &p_noiseCov);
+
+    //=========================================================================================================
+    /**
+    * Computes the inverse operator for a noise covariance from the cache. Processing thread only.
+    *
+    * @param[in] p_noiseCov     the noise covariance
+    *
+    * @return the inverse operator
+    */
+    MNEInverseOperator::SPtr computeInverseOperator(const FiffCov &p_noiseCov);
+
     QMutex      mutex;                  /**< Provides access serialization between threads. */
+    QWaitCondition m_waitCondition;     /**< Wakes the processing thread when a covariance arrives or when stopping. */
     bool        m_bIsRunning;           /**< Whether RtInv is running. */
 
-    QVector<FiffCov> m_vecNoiseCov;     /**< Noise covariance matrices. */
+    bool        m_bNoiseCovPending;     /**< Whether m_noiseCov still has to be processed. */
+    FiffCov     m_noiseCov;             /**< The latest noise covariance. */
 
     FiffInfo::SPtr m_pFiffInfo;         /**< The fiff measurement information. */
     MNEForwardSolution::SPtr m_pFwd;    /**< The forward solution. */
+
+    float       m_fLoose;               /**< Loose orientation constraint. */
+    float       m_fDepth;               /**< Depth weighting exponent. */
+
+    MNEForwardSolution m_forwardMeg;    /**< The MEG part of the forward solution. Processing thread only. */
+    bool        m_bCacheValid;          /**< Whether the cache below belongs to m_qListCacheChNames. Processing thread only. */
+    QStringList m_qListCacheChNames;    /**< The channels the cache was prepared for. Processing thread only. */
+    FiffInfo    m_gainInfo;             /**< Measurement info of the picked channels. Processing thread only. */
+    bool        m_bFixedOri;            /**< Whether the forward solution has fixed orientation. Processing thread only. */
+    FiffCov     m_depthPrior;           /**< The depth prior. Processing thread only. */
+    FiffCov     m_orientPrior;          /**< The orientation prior, unused for fixed orientation. Processing thread only. */
+    FiffCov     m_sourceCov;            /**< The source covariance before it is scaled to the whitened gain. Processing thread only. */
+    MatrixXd    m_matWeightedGain;      /**< Gain of the picked channels, columns weighted by the source standard deviations. Processing thread only. */
+    MatrixXd    m_matWeightedGainGram;  /**< m_matWeightedGain * m_matWeightedGain^T. Processing thread only. */
+    qint32      m_iMethods;             /**< The FIFFV_MNE_* methods of the picked channels. Processing thread only. */
 };
 
 //*************************************************************************************************************
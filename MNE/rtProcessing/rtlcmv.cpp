@@ -0,0 +1,615 @@
+//=============================================================================================================
+/**
+* @file     rtlcmv.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief     RtLcmv class definition.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rtlcmv.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+#include <QtConcurrent/QtConcurrent>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Cholesky>
+#include <Eigen/Eigenvalues>
+#include <Eigen/LU>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <math.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+RtLcmv::RtLcmv(FiffInfo::SPtr &p_pFiffInfo, MNEForwardSolution::SPtr &p_pFwd, QObject *parent)
+: QThread(parent)
+, m_bIsRunning(false)
+, m_iWindowSamples(qMax(qRound(10.0f * p_pFiffInfo->sfreq), 2))
+, m_iUpdateInterval(qMax(qRound(p_pFiffInfo->sfreq), 1))
+, m_dReg(0.05)
+, m_bRegChanged(false)
+, m_bNoiseCovPending(false)
+, m_pFiffInfo(p_pFiffInfo)
+, m_pFwd(p_pFwd)
+, m_iOri(1)
+, m_iNumSources(0)
+, m_bInvCovValid(false)
+, m_bWeightsValid(false)
+, m_iSampleCount(0)
+, m_iSeenSamples(0)
+, m_iSinceUpdate(0)
+, m_iSinceResync(0)
+{
+    qRegisterMetaType<MNESourceEstimate::SPtr>("MNESourceEstimate::SPtr");
+}
+
+
+//*************************************************************************************************************
+
+RtLcmv::~RtLcmv()
+{
+    stop();
+    QThread::wait();
+}
+
+
+//*************************************************************************************************************
+
+void RtLcmv::append(const MatrixXd &p_DataSegment)
+{
+    if(!m_pRawMatrixBuffer) {
+        mutex.lock();
+        m_pRawMatrixBuffer = MatrixRingBuffer<double>::SPtr(new MatrixRingBuffer<double>(8, p_DataSegment.rows(), p_DataSegment.cols()));
+        m_waitCondition.wakeAll();
+        mutex.unlock();
+    }
+
+    if((quint32)p_DataSegment.rows() != m_pRawMatrixBuffer->rows() || (quint32)p_DataSegment.cols() != m_pRawMatrixBuffer->cols())
+        return;
+
+    //Copy straight into the preallocated slot
+    MatrixXd* t_pSlot = m_pRawMatrixBuffer->acquireWrite();
+    if(t_pSlot)
+    {
+        *t_pSlot = p_DataSegment;
+        m_pRawMatrixBuffer->commitWrite();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void RtLcmv::appendNoiseCov(FiffCov &p_noiseCov)
+{
+    mutex.lock();
+    m_noiseCov = p_noiseCov;
+    m_bNoiseCovPending = true;
+    mutex.unlock();
+}
+
+
+//*************************************************************************************************************
+
+void RtLcmv::setWindowSamples(qint32 samples)
+{
+    mutex.lock();
+    m_iWindowSamples = qMax(samples, 2);
+    mutex.unlock();
+}
+
+
+//*************************************************************************************************************
+
+void RtLcmv::setUpdateInterval(qint32 samples)
+{
+    mutex.lock();
+    m_iUpdateInterval = qMax(samples, 1);
+    mutex.unlock();
+}
+
+
+//*************************************************************************************************************
+
+void RtLcmv::setRegularization(double dReg)
+{
+    mutex.lock();
+    m_dReg = qMax(dReg, 0.0);
+    m_bRegChanged = true;
+    mutex.unlock();
+}
+
+
+//*************************************************************************************************************
+
+bool RtLcmv::start()
+{
+    //Check if the thread is already or still running. This can happen if the start button is pressed immediately after the stop button was pressed. In this case the stopping process is not finished yet but the start process is initiated.
+    if(this->isRunning())
+        QThread::wait();
+
+    //A stopped buffer is aborted - reset it before the processing thread blocks on it again
+    if(m_pRawMatrixBuffer && m_pRawMatrixBuffer->isAborted())
+        m_pRawMatrixBuffer->clear();
+
+    m_bIsRunning = true;
+    QThread::start();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool RtLcmv::stop()
+{
+    mutex.lock();
+    m_bIsRunning = false;
+    MatrixRingBuffer<double>::SPtr t_pRawMatrixBuffer = m_pRawMatrixBuffer;
+    m_waitCondition.wakeAll();
+    mutex.unlock();
+
+    //Wake the processing thread and a blocked producer
+    if(t_pRawMatrixBuffer)
+        t_pRawMatrixBuffer->abort();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void RtLcmv::run()
+{
+    //SETUP
+    prepareGain();
+    prepareWhitener(NULL);
+    resetEstimate();
+    m_iSampleCount = 0;
+
+    const float t_fTStep = 1.0f / m_pFiffInfo->sfreq;
+
+    //The buffer is created with the first block
+    mutex.lock();
+    while(m_bIsRunning && !m_pRawMatrixBuffer)
+        m_waitCondition.wait(&mutex);
+    MatrixRingBuffer<double>::SPtr t_pRawMatrixBuffer = m_pRawMatrixBuffer;
+    mutex.unlock();
+
+    while(m_bIsRunning && t_pRawMatrixBuffer)
+    {
+        //Blocks until a block arrived, NULL once stopped
+        MatrixXd* t_pRawSegment = t_pRawMatrixBuffer->acquireRead();
+        if(!t_pRawSegment)
+            continue;
+
+        //Pick the gain channels and hand the slot back right away
+        const qint32 t_iCols = t_pRawSegment->cols();
+        m_matData.resize(m_vecSelection.size(), t_iCols);
+        for(qint32 i = 0; i < m_vecSelection.size(); ++i)
+            m_matData.row(i) = t_pRawSegment->row(m_vecSelection[i]);
+
+        t_pRawMatrixBuffer->release();
+
+        //Take over the settings
+        mutex.lock();
+        const qint32 t_iWindowSamples = m_iWindowSamples;
+        const qint32 t_iUpdateInterval = m_iUpdateInterval;
+        const double t_dReg = m_dReg;
+        const bool t_bRegChanged = m_bRegChanged;
+        m_bRegChanged = false;
+        const bool t_bNoiseCovPending = m_bNoiseCovPending;
+        FiffCov t_noiseCov;
+        if(m_bNoiseCovPending) {
+            t_noiseCov = m_noiseCov;
+            m_bNoiseCovPending = false;
+        }
+        mutex.unlock();
+
+        if(m_iNumSources == 0 || m_matData.rows() == 0) {
+            m_iSampleCount += t_iCols;
+            continue;
+        }
+
+        //A new noise covariance changes the whitened space - the sensor covariance is kept, inverse and weights are recomputed with this block
+        if(t_bNoiseCovPending) {
+            prepareWhitener(&t_noiseCov);
+            m_bInvCovValid = false;
+            m_bWeightsValid = false;
+        }
+
+        updateCovariance(1.0 - 1.0 / t_iWindowSamples);
+        m_iSeenSamples += t_iCols;
+        m_iSinceUpdate += t_iCols;
+
+        //The covariance has full rank once a window was seen, from then on its inverse is carried along
+        if(m_bInvCovValid)
+            ++m_iSinceResync;
+
+        if(m_iSeenSamples >= t_iWindowSamples && (!m_bInvCovValid || t_bRegChanged || m_iSinceResync >= RTLCMV_RESYNC_BLOCKS))
+            resync(t_dReg);
+
+        if(m_bInvCovValid && (!m_bWeightsValid || m_iSinceUpdate >= t_iUpdateInterval)) {
+            m_matWeights.resize(m_matGain.rows(), m_matGain.cols());
+            runBlocks(&RtLcmv::computeWeightsBlock);
+            m_bWeightsValid = true;
+            m_iSinceUpdate = 0;
+        }
+
+        if(m_bWeightsValid) {
+            m_matDataWhite.noalias() = m_matWhitener * m_matData;
+            m_matSol.resize(m_iNumSources, t_iCols);
+            runBlocks(&RtLcmv::applyWeightsBlock);
+
+            MNESourceEstimate::SPtr t_pSourceEstimate(new MNESourceEstimate(m_matSol, m_vecVertices, m_iSampleCount * t_fTStep, t_fTStep));
+            emit sourceEstimateCalculated(t_pSourceEstimate);
+        }
+
+        m_iSampleCount += t_iCols;
+    }
+}
+
+
+//*************************************************************************************************************
+
+void RtLcmv::computeWeightsBlock(SourceBlock& block)
+{
+    const MatrixXd& t_matGain = *block.pGain;
+    const qint32 t_iFirstCol = block.iFirst * block.iOri;
+    const qint32 t_iCols = block.iSources * block.iOri;
+
+    //The product with the gain dominates, the rest are reductions and 3x3 systems per source
+    MatrixXd t_matInvCovGain(t_matGain.rows(), t_iCols);
+    t_matInvCovGain.noalias() = (*block.pInvCov) * t_matGain.middleCols(t_iFirstCol, t_iCols);
+
+    if(block.iOri == 1) {
+        //The normalization by l^T C^-1 l cancels in the unit noise gain scaling
+        block.pWeights->middleCols(t_iFirstCol, t_iCols) = t_matInvCovGain;
+    } else {
+        Matrix3d t_matA, t_matAInv;
+        double t_dDet;
+        bool t_bInvertible;
+
+        for(qint32 s = 0; s < block.iSources; ++s) {
+            t_matA.noalias() = t_matGain.middleCols(t_iFirstCol + 3*s, 3).transpose() * t_matInvCovGain.middleCols(3*s, 3);
+            t_matA.computeInverseAndDetWithCheck(t_matAInv, t_dDet, t_bInvertible);
+
+            if(t_bInvertible)
+                block.pWeights->middleCols(t_iFirstCol + 3*s, 3).noalias() = t_matInvCovGain.middleCols(3*s, 3) * t_matAInv;
+            else
+                block.pWeights->middleCols(t_iFirstCol + 3*s, 3).setZero();
+        }
+    }
+
+    //Unit noise gain - scale every weight vector by the standard deviation of its projected noise, white by construction
+    VectorXd t_vecNoiseGain = block.pWeights->middleCols(t_iFirstCol, t_iCols).colwise().squaredNorm().transpose();
+
+    for(qint32 c = 0; c < t_iCols; ++c)
+        block.pWeights->col(t_iFirstCol + c) *= t_vecNoiseGain[c] > 0.0 ? 1.0 / sqrt(t_vecNoiseGain[c]) : 0.0;
+}
+
+
+//*************************************************************************************************************
+
+void RtLcmv::applyWeightsBlock(SourceBlock& block)
+{
+    const qint32 t_iFirstCol = block.iFirst * block.iOri;
+    const qint32 t_iCols = block.iSources * block.iOri;
+
+    if(block.iOri == 1) {
+        block.pSol->middleRows(block.iFirst, block.iSources).noalias() = block.pWeights->middleCols(t_iFirstCol, t_iCols).transpose() * (*block.pData);
+    } else {
+        //Free orientation - the norm of the three components
+        MatrixXd t_matComponents(t_iCols, block.pData->cols());
+        t_matComponents.noalias() = block.pWeights->middleCols(t_iFirstCol, t_iCols).transpose() * (*block.pData);
+
+        for(qint32 s = 0; s < block.iSources; ++s)
+            block.pSol->row(block.iFirst + s) = t_matComponents.middleRows(3*s, 3).colwise().norm();
+    }
+}
+
+
+//*************************************************************************************************************
+
+bool RtLcmv::updateInverse(MatrixXd& matInvCov, const MatrixXd& matUpdate, double dAlpha, MatrixXd& matInvCovUpdate, MatrixXd& matCapacitance)
+{
+    //(alpha*R + U*U^T)^-1 = (P - P*U*(alpha*I + U^T*P*U)^-1*U^T*P) / alpha with P = R^-1
+    matInvCovUpdate.noalias() = matInvCov * matUpdate;
+    matCapacitance.noalias() = matUpdate.transpose() * matInvCovUpdate;
+    matCapacitance.diagonal().array() += dAlpha;
+
+    LLT<MatrixXd> t_llt(matCapacitance);
+    if(t_llt.info() != Success)
+        return false;
+
+    matInvCov.noalias() -= matInvCovUpdate * t_llt.solve(matInvCovUpdate.transpose());
+    matInvCov /= dAlpha;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void RtLcmv::computeWhitener(const MatrixXd& matNoiseCov, const VectorXd& vecAdHocStd, MatrixXd& matWhitener)
+{
+    const VectorXd t_vecScale = vecAdHocStd.cwiseInverse();
+
+    if(matNoiseCov.size() == 0) {
+        matWhitener = MatrixXd::Zero(t_vecScale.size(), t_vecScale.size());
+        matWhitener.diagonal() = t_vecScale;
+        return;
+    }
+
+    const MatrixXd t_matScaled = t_vecScale.asDiagonal() * matNoiseCov * t_vecScale.asDiagonal();
+    SelfAdjointEigenSolver<MatrixXd> t_eig(t_matScaled);
+
+    //The eigenvalues are sorted in increasing order
+    const VectorXd& t_vecEig = t_eig.eigenvalues();
+    const double t_dTol = RTLCMV_WHITENER_RTOL * t_vecEig[t_vecEig.size() - 1];
+    qint32 t_iFirst = 0;
+    while(t_iFirst < t_vecEig.size() && t_vecEig[t_iFirst] <= t_dTol)
+        ++t_iFirst;
+
+    const qint32 t_iRank = t_vecEig.size() - t_iFirst;
+    if(t_iRank == 0) {
+        qWarning() << "RtLcmv: noise covariance is zero - using the ad-hoc noise levels.";
+        computeWhitener(MatrixXd(), vecAdHocStd, matWhitener);
+        return;
+    }
+
+    matWhitener = t_vecEig.tail(t_iRank).cwiseSqrt().cwiseInverse().asDiagonal() * t_eig.eigenvectors().rightCols(t_iRank).transpose() * t_vecScale.asDiagonal();
+}
+
+
+//*************************************************************************************************************
+
+void RtLcmv::prepareGain()
+{
+    const FiffNamedMatrix& t_sol = *m_pFwd->sol;
+
+    //Good channels of the measurement which are part of the forward solution
+    m_qListChNames.clear();
+    QList<qint32> t_qListFwdRows, t_qListDataRows;
+    for(qint32 i = 0; i < t_sol.row_names.size(); ++i) {
+        const qint32 t_iIdx = m_pFiffInfo->ch_names.indexOf(t_sol.row_names[i]);
+        if(t_iIdx >= 0 && !m_pFiffInfo->bads.contains(t_sol.row_names[i])) {
+            m_qListChNames << t_sol.row_names[i];
+            t_qListFwdRows << i;
+            t_qListDataRows << t_iIdx;
+        }
+    }
+
+    m_vecSelection.resize(t_qListDataRows.size());
+    m_vecFwdRows.resize(t_qListFwdRows.size());
+    m_vecAdHocStd.resize(t_qListDataRows.size());
+    for(qint32 i = 0; i < t_qListFwdRows.size(); ++i) {
+        m_vecSelection[i] = t_qListDataRows[i];
+        m_vecFwdRows[i] = t_qListFwdRows[i];
+
+        const FiffChInfo& t_chInfo = m_pFiffInfo->chs[t_qListDataRows[i]];
+        if(t_chInfo.kind == FIFFV_MEG_CH)
+            m_vecAdHocStd[i] = t_chInfo.unit == FIFF_UNIT_T_M ? RTLCMV_ADHOC_GRAD_STD : RTLCMV_ADHOC_MAG_STD;
+        else if(t_chInfo.kind == FIFFV_EEG_CH)
+            m_vecAdHocStd[i] = RTLCMV_ADHOC_EEG_STD;
+        else
+            m_vecAdHocStd[i] = 1.0;
+    }
+
+    m_iOri = m_pFwd->isFixedOrient() ? 1 : 3;
+    m_iNumSources = t_sol.data.cols() / m_iOri;
+
+    qint32 t_iNumVertices = 0;
+    for(qint32 h = 0; h < m_pFwd->src.size(); ++h)
+        t_iNumVertices += m_pFwd->src[h].vertno.size();
+
+    m_vecVertices.resize(t_iNumVertices);
+    for(qint32 h = 0, t_iPos = 0; h < m_pFwd->src.size(); ++h) {
+        m_vecVertices.segment(t_iPos, m_pFwd->src[h].vertno.size()) = m_pFwd->src[h].vertno;
+        t_iPos += m_pFwd->src[h].vertno.size();
+    }
+
+    if(t_iNumVertices != m_iNumSources)
+        qWarning() << "RtLcmv: number of vertices" << t_iNumVertices << "does not match the number of sources" << m_iNumSources;
+}
+
+
+//*************************************************************************************************************
+
+void RtLcmv::prepareWhitener(const FiffCov* p_pNoiseCov)
+{
+    const qint32 t_iNumChs = m_qListChNames.size();
+
+    //Pick the noise covariance of the gain channels
+    MatrixXd t_matNoiseCov;
+    if(p_pNoiseCov) {
+        VectorXi t_vecIdx(t_iNumChs);
+        bool t_bComplete = true;
+        for(qint32 i = 0; i < t_iNumChs && t_bComplete; ++i) {
+            t_vecIdx[i] = p_pNoiseCov->names.indexOf(m_qListChNames[i]);
+            if(t_vecIdx[i] < 0) {
+                qWarning() << "RtLcmv: noise covariance lacks channel" << m_qListChNames[i] << "- using the ad-hoc noise levels.";
+                t_bComplete = false;
+            }
+        }
+
+        if(t_bComplete) {
+            t_matNoiseCov = MatrixXd::Zero(t_iNumChs, t_iNumChs);
+            for(qint32 i = 0; i < t_iNumChs; ++i) {
+                if(p_pNoiseCov->diag)
+                    t_matNoiseCov(i, i) = p_pNoiseCov->data(t_vecIdx[i], 0);
+                else
+                    for(qint32 j = 0; j < t_iNumChs; ++j)
+                        t_matNoiseCov(i, j) = p_pNoiseCov->data(t_vecIdx[i], t_vecIdx[j]);
+            }
+        }
+    }
+
+    if(t_iNumChs == 0) {
+        m_matWhitener.resize(0, 0);
+        m_matGain.resize(0, m_pFwd->sol->data.cols());
+        return;
+    }
+
+    computeWhitener(t_matNoiseCov, m_vecAdHocStd, m_matWhitener);
+
+    //Whitened gain
+    const MatrixXd& t_matSolData = m_pFwd->sol->data;
+    MatrixXd t_matGain(t_iNumChs, t_matSolData.cols());
+    for(qint32 i = 0; i < t_iNumChs; ++i)
+        t_matGain.row(i) = t_matSolData.row(m_vecFwdRows[i]);
+
+    m_matGain.noalias() = m_matWhitener * t_matGain;
+}
+
+
+//*************************************************************************************************************
+
+void RtLcmv::resetEstimate()
+{
+    m_matCov = MatrixXd::Zero(m_vecSelection.size(), m_vecSelection.size());
+    m_bInvCovValid = false;
+    m_bWeightsValid = false;
+    m_iSeenSamples = 0;
+    m_iSinceUpdate = 0;
+    m_iSinceResync = 0;
+}
+
+
+//*************************************************************************************************************
+
+void RtLcmv::updateCovariance(double dForget)
+{
+    const qint32 t_iCols = m_matData.cols();
+    const double t_dAlpha = pow(dForget, (double)t_iCols);
+
+    //C <- alpha*C + U*U^T, sample t of the block weighted by (1-forget)*forget^(cols-1-t)
+    m_matUpdate.resize(m_matData.rows(), t_iCols);
+    const double t_dStep = sqrt(dForget);
+    double t_dWeight = sqrt(1.0 - dForget);
+    for(qint32 t = t_iCols - 1; t >= 0; --t) {
+        m_matUpdate.col(t) = t_dWeight * m_matData.col(t);
+        t_dWeight *= t_dStep;
+    }
+
+    m_matCov *= t_dAlpha;
+    m_matCov.selfadjointView<Lower>().rankUpdate(m_matUpdate);
+
+    if(!m_bInvCovValid)
+        return;
+
+    //Woodbury takes about 4*n^2*b + 4*n*b^2 flops, a new inverse 7/3*n^3 - it pays off up to blocks of about 0.4*n
+    if(5 * t_iCols >= 2 * m_matInvCov.rows()) {
+        m_bInvCovValid = false;
+        return;
+    }
+
+    m_matUpdateWhite.noalias() = m_matWhitener * m_matUpdate;
+    if(!updateInverse(m_matInvCov, m_matUpdateWhite, t_dAlpha, m_matInvCovUpdate, m_matCapacitance))
+        m_bInvCovValid = false;
+}
+
+
+//*************************************************************************************************************
+
+void RtLcmv::resync(double dReg)
+{
+    const qint32 t_iNumChs = m_matWhitener.rows();
+
+    //Whitened covariance, the loading is relative to its mean variance
+    MatrixXd t_matLoaded(t_iNumChs, t_iNumChs);
+    t_matLoaded.noalias() = m_matWhitener * m_matCov.selfadjointView<Lower>() * m_matWhitener.transpose();
+    t_matLoaded.diagonal().array() += dReg * t_matLoaded.trace() / t_iNumChs;
+
+    m_iSinceResync = 0;
+
+    LLT<MatrixXd> t_llt(t_matLoaded);
+    if(t_llt.info() != Success) {
+        m_bInvCovValid = false;
+        return;
+    }
+
+    m_matInvCov = t_llt.solve(MatrixXd::Identity(t_iNumChs, t_iNumChs));
+    m_bInvCovValid = true;
+}
+
+
+//*************************************************************************************************************
+
+void RtLcmv::runBlocks(void (*function)(SourceBlock&))
+{
+    const qint32 t_iNumBlocks = qMax(1, qMin(QThread::idealThreadCount(), m_iNumSources));
+
+    QVector<SourceBlock> t_vecBlocks(t_iNumBlocks);
+    for(qint32 b = 0; b < t_iNumBlocks; ++b)
+    {
+        t_vecBlocks[b].pGain = &m_matGain;
+        t_vecBlocks[b].pInvCov = &m_matInvCov;
+        t_vecBlocks[b].pData = &m_matDataWhite;
+        t_vecBlocks[b].pWeights = &m_matWeights;
+        t_vecBlocks[b].pSol = &m_matSol;
+        t_vecBlocks[b].iFirst = (qint32)((qint64)m_iNumSources * b / t_iNumBlocks);
+        t_vecBlocks[b].iSources = (qint32)((qint64)m_iNumSources * (b+1) / t_iNumBlocks) - t_vecBlocks[b].iFirst;
+        t_vecBlocks[b].iOri = m_iOri;
+    }
+
+    QtConcurrent::blockingMap(t_vecBlocks, function);
+}
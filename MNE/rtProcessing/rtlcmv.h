@@ -0,0 +1,412 @@
+//=============================================================================================================
+/**
+* @file     rtlcmv.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief     RtLcmv class declaration.
+*
+*/
+
+#ifndef RTLCMV_H
+#define RTLCMV_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rtprocessing_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FIFF INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff_cov.h>
+#include <fiff/fiff_info.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MNE INCLUDES
+//=============================================================================================================
+
+#include <mne/mne_forwardsolution.h>
+#include <mne/mne_sourceestimate.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Generics INCLUDES
+//=============================================================================================================
+
+#include <generics/matrixringbuffer.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QSharedPointer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define RTLCMV_RESYNC_BLOCKS    32      /**< Number of blocks after which the inverse covariance is recomputed from the covariance itself. This bounds the rounding drift of the Woodbury updates and restores the diagonal loading, which decays with the forgetting factor in between. */
+#define RTLCMV_ADHOC_GRAD_STD   5e-13   /**< Ad-hoc noise standard deviation of gradiometers in T/m, used for whitening as long as no noise covariance was given. */
+#define RTLCMV_ADHOC_MAG_STD    20e-15  /**< Ad-hoc noise standard deviation of magnetometers in T. */
+#define RTLCMV_ADHOC_EEG_STD    0.2e-6  /**< Ad-hoc noise standard deviation of EEG channels in V. */
+#define RTLCMV_WHITENER_RTOL    1e-10   /**< Eigenvalues of the scaled noise covariance below this fraction of the largest one are dropped from the whitener. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE RTPROCESSINGLIB
+//=============================================================================================================
+
+namespace RTPROCESSINGLIB
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+using namespace IOBuffer;
+using namespace FIFFLIB;
+using namespace MNELIB;
+
+
+//=============================================================================================================
+/**
+* Real-time LCMV beamformer. The data covariance is estimated with an exponential forgetting factor whose time
+* constant is the window length. Its diagonally loaded inverse is carried along with a Woodbury update per block
+* and only recomputed every RTLCMV_RESYNC_BLOCKS blocks. At every update interval the weights of all sources are
+* recomputed from the current inverse: the product of the inverse covariance with the gain is split into column
+* blocks over the cores, the per source normalizations are cheap reductions of that product.
+*
+* Gain and data are whitened before the beamformer - by the noise covariance if one was given, otherwise by the
+* ad-hoc noise levels of the channel types - so gradiometers, magnetometers and EEG are on a common scale for the
+* diagonal loading. The weights are scaled to unit noise gain, so the output is the source activity in units of
+* the projected noise, whose power is the neural activity index. Free orientation sources output the norm of the
+* three components. The covariance is not mean corrected, the data are expected to be high-pass filtered.
+*
+* @brief Real-time LCMV beamformer
+*/
+class RTPROCESSINGSHARED_EXPORT RtLcmv : public QThread
+{
+    Q_OBJECT
+public:
+    typedef QSharedPointer<RtLcmv> SPtr;             /**< Shared pointer type for RtLcmv. */
+    typedef QSharedPointer<const RtLcmv> ConstSPtr;  /**< Const shared pointer type for RtLcmv. */
+
+    //=========================================================================================================
+    /**
+    * Creates the real-time LCMV beamformer. The window defaults to 10 s, the update interval to 1 s.
+    *
+    * @param[in] p_pFiffInfo    Fiff measurement info
+    * @param[in] p_pFwd         Forward solution, optionally clustered
+    * @param[in] parent         Parent QObject (optional)
+    */
+    explicit RtLcmv(FiffInfo::SPtr &p_pFiffInfo, MNEForwardSolution::SPtr &p_pFwd, QObject *parent = 0);
+
+    //=========================================================================================================
+    /**
+    * Destroys the real-time LCMV beamformer.
+    */
+    ~RtLcmv();
+
+    //=========================================================================================================
+    /**
+    * Slot to receive incoming data.
+    *
+    * @param[in] p_DataSegment  Data block with all channels of the measurement info
+    */
+    void append(const MatrixXd &p_DataSegment);
+
+    //=========================================================================================================
+    /**
+    * Slot to receive a noise covariance. It replaces the whitener, the weights are recomputed with the next block.
+    *
+    * @param[in] p_noiseCov     Noise covariance estimation
+    */
+    void appendNoiseCov(FiffCov &p_noiseCov);
+
+    //=========================================================================================================
+    /**
+    * Sets the time constant of the covariance estimate. The first weights are computed once this many samples
+    * arrived.
+    *
+    * @param[in] samples    the window length in samples
+    */
+    void setWindowSamples(qint32 samples);
+
+    //=========================================================================================================
+    /**
+    * Sets the number of samples between two weight updates.
+    *
+    * @param[in] samples    the update interval in samples
+    */
+    void setUpdateInterval(qint32 samples);
+
+    //=========================================================================================================
+    /**
+    * Sets the diagonal loading as fraction of the mean whitened channel variance.
+    *
+    * @param[in] dReg       the regularization, 0.05 by default
+    */
+    void setRegularization(double dReg);
+
+    //=========================================================================================================
+    /**
+    * Returns true if is running, otherwise false.
+    *
+    * @return true if is running, false otherwise
+    */
+    inline bool isRunning();
+
+    //=========================================================================================================
+    /**
+    * Starts the RtLcmv by starting the producer's thread.
+    *
+    * @return true if succeeded, false otherwise
+    */
+    virtual bool start();
+
+    //=========================================================================================================
+    /**
+    * Stops the RtLcmv by stopping the producer's thread.
+    *
+    * @return true if succeeded, false otherwise
+    */
+    virtual bool stop();
+
+    //=========================================================================================================
+    /**
+    * Sources which are processed by one worker. All matrices are in the whitened channel space.
+    */
+    struct SourceBlock {
+        const MatrixXd* pGain;          /**< The whitened gain of the picked channels. */
+        const MatrixXd* pInvCov;        /**< The inverse whitened data covariance. */
+        const MatrixXd* pData;          /**< The whitened data block. */
+        MatrixXd*       pWeights;       /**< The transposed weights, one column per source component. */
+        MatrixXd*       pSol;           /**< The source estimate of the block. */
+        qint32          iFirst;         /**< First source of the block. */
+        qint32          iSources;       /**< Number of sources of the block. */
+        qint32          iOri;           /**< Number of components per source, 1 or 3. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Computes the unit noise gain weights of the sources of a block. The noise covariance is the identity in the
+    * whitened space, so every weight vector is scaled to unit norm.
+    *
+    * @param[in] block  the block
+    */
+    static void computeWeightsBlock(SourceBlock& block);
+
+    //=========================================================================================================
+    /**
+    * Applies the weights of the sources of a block to the data block.
+    *
+    * @param[in] block  the block
+    */
+    static void applyWeightsBlock(SourceBlock& block);
+
+    //=========================================================================================================
+    /**
+    * Updates the inverse of R to the inverse of alpha*R + U*U^T by the Woodbury identity.
+    *
+    * @param[in, out] matInvCov     the inverse to update
+    * @param[in] matUpdate          the update U, one column per weighted sample
+    * @param[in] dAlpha             the decay alpha of the old covariance
+    * @param[out] matInvCovUpdate   work memory, matInvCov * U on return
+    * @param[out] matCapacitance    work memory, the capacitance matrix on return
+    *
+    * @return false if the capacitance matrix is not positive definite, matInvCov is unchanged then
+    */
+    static bool updateInverse(MatrixXd& matInvCov, const MatrixXd& matUpdate, double dAlpha, MatrixXd& matInvCovUpdate, MatrixXd& matCapacitance);
+
+    //=========================================================================================================
+    /**
+    * Computes the whitener of a noise covariance. The channels are scaled by their ad-hoc noise level before the
+    * eigendecomposition, so the rank threshold does not depend on the units of the channel types. Eigenvalues below
+    * RTLCMV_WHITENER_RTOL of the largest one are dropped, the whitener has one row per remaining eigenvalue.
+    *
+    * @param[in] matNoiseCov    the noise covariance, empty for the ad-hoc diagonal noise covariance
+    * @param[in] vecAdHocStd    the ad-hoc noise standard deviation per channel
+    * @param[out] matWhitener   the whitener W with W * noise covariance * W^T = I
+    */
+    static void computeWhitener(const MatrixXd& matNoiseCov, const VectorXd& vecAdHocStd, MatrixXd& matWhitener);
+
+signals:
+    //=========================================================================================================
+    /**
+    * Signal which is emitted for every block once the first weights are available.
+    *
+    * @param[out] p_pSourceEstimate  The source estimate of the block
+    */
+    void sourceEstimateCalculated(MNELIB::MNESourceEstimate::SPtr p_pSourceEstimate);
+
+protected:
+    //=========================================================================================================
+    /**
+    * The starting point for the thread. After calling start(), the newly created thread calls this function.
+    * Returning from this method will end the execution of the thread.
+    * Pure virtual method inherited by QThread.
+    */
+    virtual void run();
+
+private:
+    //=========================================================================================================
+    /**
+    * Picks the good channels of the measurement which are part of the forward solution and their ad-hoc noise
+    * levels. Processing thread only.
+    */
+    void prepareGain();
+
+    //=========================================================================================================
+    /**
+    * Computes the whitener from the noise covariance of the picked channels and whitens the gain. Falls back to
+    * the ad-hoc noise levels if no noise covariance is given or channels are missing. Processing thread only.
+    *
+    * @param[in] p_pNoiseCov    the noise covariance, NULL for the ad-hoc noise levels
+    */
+    void prepareWhitener(const FiffCov* p_pNoiseCov);
+
+    //=========================================================================================================
+    /**
+    * Clears the covariance and invalidates its inverse and the weights. Processing thread only.
+    */
+    void resetEstimate();
+
+    //=========================================================================================================
+    /**
+    * Adds the picked data block to the covariance and, once the inverse is valid, updates the inverse by the
+    * Woodbury identity. Processing thread only.
+    *
+    * @param[in] dForget    the forgetting factor per sample
+    */
+    void updateCovariance(double dForget);
+
+    //=========================================================================================================
+    /**
+    * Recomputes the diagonally loaded inverse from the covariance. Processing thread only.
+    *
+    * @param[in] dReg       the diagonal loading as fraction of the mean whitened channel variance
+    */
+    void resync(double dReg);
+
+    //=========================================================================================================
+    /**
+    * Distributes the sources over the workers and runs the given function. Processing thread only.
+    *
+    * @param[in] function   computeWeightsBlock or applyWeightsBlock
+    */
+    void runBlocks(void (*function)(SourceBlock&));
+
+    QMutex      mutex;                  /**< Provides access serialization between threads. */
+    QWaitCondition m_waitCondition;     /**< Wakes the processing thread when the first block arrives or when stopping. */
+    bool        m_bIsRunning;           /**< Whether RtLcmv is running. */
+
+    qint32      m_iWindowSamples;       /**< Time constant of the covariance estimate. Guarded by mutex. */
+    qint32      m_iUpdateInterval;      /**< Samples between two weight updates. Guarded by mutex. */
+    double      m_dReg;                 /**< Diagonal loading as fraction of the mean whitened channel variance. Guarded by mutex. */
+    bool        m_bRegChanged;          /**< Whether the inverse has to be recomputed with a new loading. Guarded by mutex. */
+    bool        m_bNoiseCovPending;     /**< Whether m_noiseCov still has to be picked. Guarded by mutex. */
+    FiffCov     m_noiseCov;             /**< The latest noise covariance. Guarded by mutex. */
+
+    FiffInfo::SPtr m_pFiffInfo;         /**< The fiff measurement information. */
+    MNEForwardSolution::SPtr m_pFwd;    /**< The forward solution. */
+
+    MatrixRingBuffer<double>::SPtr m_pRawMatrixBuffer;  /**< The Raw Matrix Ring Buffer. Created by the first append, guarded by mutex. */
+
+    QStringList m_qListChNames;         /**< Names of the picked channels. Processing thread only. */
+    VectorXi    m_vecSelection;         /**< Rows of the picked channels in the data blocks. Processing thread only. */
+    VectorXi    m_vecFwdRows;           /**< Rows of the picked channels in the forward solution. Processing thread only. */
+    VectorXd    m_vecAdHocStd;          /**< Ad-hoc noise standard deviation of the picked channels. Processing thread only. */
+    VectorXi    m_vecVertices;          /**< Vertices of the sources of all hemispheres. Processing thread only. */
+    MatrixXd    m_matWhitener;          /**< Whitener of the picked channels, one row per whitened channel. Processing thread only. */
+    MatrixXd    m_matGain;              /**< Whitened gain of the picked channels. Processing thread only. */
+    qint32      m_iOri;                 /**< Number of components per source, 1 or 3. Processing thread only. */
+    qint32      m_iNumSources;          /**< Number of sources. Processing thread only. */
+
+    MatrixXd    m_matData;              /**< The picked data block. Processing thread only. */
+    MatrixXd    m_matDataWhite;         /**< The whitened data block. Processing thread only. */
+    MatrixXd    m_matCov;               /**< Lower triangle of the exponentially weighted covariance of the picked channels. Processing thread only. */
+    MatrixXd    m_matInvCov;            /**< Inverse of the diagonally loaded whitened covariance. Processing thread only. */
+    MatrixXd    m_matUpdate;            /**< Weighted data block of the rank update. Processing thread only. */
+    MatrixXd    m_matUpdateWhite;       /**< Whitened m_matUpdate. Processing thread only. */
+    MatrixXd    m_matInvCovUpdate;      /**< m_matInvCov * m_matUpdateWhite. Processing thread only. */
+    MatrixXd    m_matCapacitance;       /**< Capacitance matrix of the Woodbury update. Processing thread only. */
+    MatrixXd    m_matWeights;           /**< Transposed weights, one column per source component. Processing thread only. */
+    MatrixXd    m_matSol;               /**< Source estimate of the current block. Processing thread only. */
+    bool        m_bInvCovValid;         /**< Whether m_matInvCov belongs to the current covariance. Processing thread only. */
+    bool        m_bWeightsValid;        /**< Whether m_matWeights holds weights. Processing thread only. */
+    qint64      m_iSampleCount;         /**< Samples since start. Processing thread only. */
+    qint64      m_iSeenSamples;         /**< Samples in the covariance since the last reset. Processing thread only. */
+    qint64      m_iSinceUpdate;         /**< Samples since the last weight update. Processing thread only. */
+    qint32      m_iSinceResync;         /**< Blocks since the inverse was recomputed. Processing thread only. */
+};
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline bool RtLcmv::isRunning()
+{
+    return m_bIsRunning;
+}
+
+} // NAMESPACE
+
+#ifndef metatype_mnesourceestimatesptr
+#define metatype_mnesourceestimatesptr
+Q_DECLARE_METATYPE(MNELIB::MNESourceEstimate::SPtr); /**< Provides QT META type declaration of the MNELIB::MNESourceEstimate type. For signal/slot usage.*/
+#endif
+
+#endif // RTLCMV_H
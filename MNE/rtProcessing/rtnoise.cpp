@@ -74,11 +74,18 @@ RtNoise::RtNoise(qint32 p_iMaxSamples, FiffInfo::SPtr p_pFiffInfo, qint32 p_data
 , m_iFFTlength(p_iMaxSamples)
 , m_pFiffInfo(p_pFiffInfo)
 , m_dataLength(p_dataLen)
+, m_iRefreshInterval(0)
 , m_bIsRunning(false)
 , m_iNumOfBlocks(0)
 , m_iBlockSize(0)
 , m_iSensors(0)
-, m_iBlockIndex(0)
+, m_iSegmentLength(0)
+, m_iHop(0)
+, m_iNumSegments(0)
+, m_iSegmentFill(0)
+, m_iOldestSegment(0)
+, m_iSinceResync(0)
+, m_dScale(0.0)
 {
     qRegisterMetaType<Eigen::MatrixXd>("Eigen::MatrixXd");
     //qRegisterMetaType<QVector<double>>("QVector<double>");
@@ -87,13 +94,7 @@ RtNoise::RtNoise(qint32 p_iMaxSamples, FiffInfo::SPtr p_pFiffInfo, qint32 p_data
 
     m_bSendDataToBuffer = true;
 
-    m_fWin.clear();
-
-    //create a hanning window
-    m_fWin = hanning(m_iFFTlength,0);
-
-    qDebug()<<"Hanning window is created.";
-
+    m_fft.SetFlag(m_fft.HalfSpectrum);
 }
 
 
@@ -164,6 +165,16 @@ void RtNoise::append(const MatrixXd &p_DataSegment)
 }
 
 
+//*************************************************************************************************************
+
+void RtNoise::setRefreshInterval(qint32 p_iMSec)
+{
+    mutex.lock();
+    m_iRefreshInterval = qMax(p_iMSec, 0);
+    mutex.unlock();
+}
+
+
 //*************************************************************************************************************
 
 bool RtNoise::start()
@@ -208,105 +219,128 @@ void RtNoise::run()
             MatrixXd block = m_pRawMatrixBuffer->pop();
 
             if(FirstStart){
-                //init the circ buffer and parameters
+                //init the segmentation and parameters
                 if(m_dataLength < 0) m_dataLength = 10;
-                m_iNumOfBlocks = m_dataLength;//60;
-                m_iBlockSize =  block.cols();
-                m_iSensors =  block.rows();
-
-                m_matCircBuf.resize(m_iSensors,m_iNumOfBlocks*m_iBlockSize);
-
-                m_iBlockIndex = 0;
+                initWelch(block.cols(), block.rows());
                 FirstStart = false;
             }
-            //concate blocks
-            for (int i=0; i< m_iSensors; i++)
-                for (int j=0; j< m_iBlockSize; j++)
-                    m_matCircBuf(i,j+m_iBlockIndex*m_iBlockSize) = block(i,j);
-
-
-            m_iBlockIndex ++;
-            if (m_iBlockIndex >= m_iNumOfBlocks){
-
-                //m_pRawMatrixBuffer.clear(); //empty the buffer
-
-                m_bSendDataToBuffer = false;
-                //stop collect block and start to calculate the spectrum
-                m_iBlockIndex = 0;
-
-                MatrixXd sum_psdx = MatrixXd::Zero(m_iSensors,m_iFFTlength/2+1);
-
-                int nb = floor(m_iNumOfBlocks*m_iBlockSize/m_iFFTlength)+1;
-                qDebug()<<"nb"<<nb<<"NumOfBlocks"<<m_iNumOfBlocks<<"BlockSize"<<m_iBlockSize;
-                MatrixXd t_mat(m_iSensors,m_iFFTlength);
-                MatrixXd t_psdx(m_iSensors,m_iFFTlength/2+1);
-                for (int n = 0; n<nb; n++){
-                    //collect a data block with data length of m_iFFTlength;
-                    if(n==nb-1)
-                    {
-                        for(qint32 ii=0; ii<m_iSensors; ii++)
-                        for(qint32 jj=0; jj<m_iFFTlength; jj++)
-                            if(jj+n*m_iFFTlength<m_iNumOfBlocks*m_iBlockSize)
-                                t_mat(ii,jj) = m_matCircBuf(ii,jj+n*m_iFFTlength);
-                            else
-                                t_mat(ii,jj) = 0.0;
-
-                    }
+
+            //segments which would be evicted again before the spectrum of this block is emitted are not transformed
+            qint32 t_iSkip = 0;
+            if(m_iSegmentFill + block.cols() >= m_iSegmentLength)
+                t_iSkip = qMax(0, (qint32)(m_iSegmentFill + block.cols() - m_iSegmentLength) / m_iHop + 1 - m_iNumSegments);
+
+            //cut the overlapping segments out of the stream
+            bool t_bNewSegment = false;
+            qint32 t_iPos = 0;
+            while(t_iPos < block.cols()) {
+                qint32 t_iCount = qMin((qint32)block.cols() - t_iPos, m_iSegmentLength - m_iSegmentFill);
+                m_matSegment.block(m_iSegmentFill, 0, t_iCount, m_iSensors) = block.block(0, t_iPos, m_iSensors, t_iCount).transpose();
+                m_iSegmentFill += t_iCount;
+                t_iPos += t_iCount;
+
+                if(m_iSegmentFill == m_iSegmentLength) {
+                    if(t_iSkip > 0)
+                        --t_iSkip;
                     else
-                    {
-                        for(qint32 ii=0; ii<m_iSensors; ii++)
-                        for(qint32 jj=0; jj<m_iFFTlength; jj++)
-                            t_mat(ii,jj) = m_matCircBuf(ii,jj+n*m_iFFTlength);
-                    }
-
-                    //FFT calculation by row
-                    for(qint32 i = 0; i < t_mat.rows(); i++){
-                        RowVectorXd data;
-
-                        data = t_mat.row(i);
-
-                        //zero-pad data to m_iFFTlength
-                        RowVectorXd t_dataZeroPad = RowVectorXd::Zero(m_iFFTlength);
-                        t_dataZeroPad.head(data.cols()) = data;
-
-                        for (qint32 lk = 0; lk<m_iFFTlength; lk++)
-                            t_dataZeroPad[lk] = t_dataZeroPad[lk]*m_fWin[lk];
-
-                        //generate fft object
-                        Eigen::FFT<double> fft;
-                        fft.SetFlag(fft.HalfSpectrum);
-
-                        //fft-transform data sequence
-                        RowVectorXcd t_freqData(m_iFFTlength/2+1);
-                        fft.fwd(t_freqData,t_dataZeroPad);
-
-                        // calculate spectrum from FFT
-                        for(qint32 j=0; j<m_iFFTlength/2+1;j++)
-                        {
-                            double mag_abs = sqrt(t_freqData(j).real()* t_freqData(j).real() +  t_freqData(j).imag()*t_freqData(j).imag());
-                            double spower = (1.0/(m_Fs*m_iFFTlength))* mag_abs;
-                            if (j>0&&j<m_iFFTlength/2) spower = 2.0*spower;
-                            sum_psdx(i,j) = sum_psdx(i,j) + spower;
-                        }
-                     }//row computing is done
-                }//nb
-
-                //DB-calculation
-                for(qint32 ii=0; ii<m_iSensors; ii++)
-                    for(qint32 jj=0; jj<m_iFFTlength/2+1; jj++)
-                        t_psdx(ii,jj) = 10.0*log10(sum_psdx(ii,jj)/nb);
-
-                qDebug()<<"Send spectrum to Noise Estimator";
-                emit SpecCalculated(t_psdx); //send back the spectrum result
-                if(m_pRawMatrixBuffer->size()>0)
-                    m_pRawMatrixBuffer->clear();
+                        processSegment();
 
-                m_bSendDataToBuffer = true;
+                    //the samples after the hop start the next segment
+                    m_matSegment.topRows(m_iSegmentLength - m_iHop) = m_matSegment.bottomRows(m_iSegmentLength - m_iHop);
+                    m_iSegmentFill = m_iSegmentLength - m_iHop;
+                    t_bNewSegment = true;
+                }
             }
 
-        }
+            if(t_bNewSegment) {
+                //DB-calculation of the averaged periodograms
+                MatrixXd t_psdx = (10.0/log(10.0)) * (m_matPsdSum / m_vecPeriodograms.size()).array().log().matrix();
 
+                emit SpecCalculated(t_psdx); //send back the spectrum result
+            }
+        }
     }
+}
+
 
+//*************************************************************************************************************
+
+void RtNoise::initWelch(qint32 p_iBlockSize, qint32 p_iSensors)
+{
+    m_iNumOfBlocks = m_dataLength;
+    m_iBlockSize = p_iBlockSize;
+    m_iSensors = p_iSensors;
+
+    //segments longer than the data length or the FFT length are shortened - an even length keeps the halves equal
+    qint32 t_iDataSamples = qMax(m_iNumOfBlocks * m_iBlockSize, 2);
+    m_iSegmentLength = qMin(m_iFFTlength, t_iDataSamples) & ~1;
+
+    //the refresh interval is the hop, at most one segment - without it the segments overlap by half
+    mutex.lock();
+    const qint32 t_iRefreshInterval = m_iRefreshInterval;
+    mutex.unlock();
+
+    if(t_iRefreshInterval > 0)
+        m_iHop = qBound(1, (qint32)(t_iRefreshInterval * m_Fs / 1000.0 + 0.5), m_iSegmentLength);
+    else
+        m_iHop = m_iSegmentLength / 2;
+    m_iNumSegments = (t_iDataSamples - m_iSegmentLength) / m_iHop + 1;
+
+    //create a hanning window
+    m_fWin = hanning(m_iSegmentLength, 0);
+    m_vecWindow.resize(m_iSegmentLength);
+    for(qint32 i = 0; i < m_iSegmentLength; ++i)
+        m_vecWindow[i] = m_fWin[i];
+
+    m_dScale = 2.0 / (m_Fs * m_vecWindow.squaredNorm());
+
+    m_matSegment.resize(m_iSegmentLength, m_iSensors);
+    m_vecTime = VectorXd::Zero(m_iFFTlength);
+    m_vecFreq.resize(m_iFFTlength/2+1);
+
+    m_vecPeriodograms.clear();
+    m_vecPeriodograms.reserve(m_iNumSegments);
+    m_matPsdSum = MatrixXd::Zero(m_iSensors, m_iFFTlength/2+1);
+
+    m_iSegmentFill = 0;
+    m_iOldestSegment = 0;
+    m_iSinceResync = 0;
 }
 
+
+//*************************************************************************************************************
+
+void RtNoise::processSegment()
+{
+    //replace the oldest periodogram once the data length is covered
+    MatrixXd* t_pPeriodogram;
+    if(m_vecPeriodograms.size() < m_iNumSegments) {
+        m_vecPeriodograms.append(MatrixXd(m_iSensors, m_iFFTlength/2+1));
+        t_pPeriodogram = &m_vecPeriodograms.last();
+    } else {
+        t_pPeriodogram = &m_vecPeriodograms[m_iOldestSegment];
+        m_matPsdSum -= *t_pPeriodogram;
+        m_iOldestSegment = (m_iOldestSegment + 1) % m_iNumSegments;
+        ++m_iSinceResync;
+    }
+
+    //all channels are transformed with the same plan, the zero padding of m_vecTime stays in place
+    for(qint32 i = 0; i < m_iSensors; ++i) {
+        m_vecTime.head(m_iSegmentLength) = m_matSegment.col(i).cwiseProduct(m_vecWindow);
+        m_fft.fwd(m_vecFreq, m_vecTime);
+        t_pPeriodogram->row(i) = m_dScale * m_vecFreq.cwiseAbs2().transpose();
+    }
+
+    //DC and Nyquist bin are not doubled
+    t_pPeriodogram->col(0) *= 0.5;
+    t_pPeriodogram->col(m_iFFTlength/2) *= 0.5;
+
+    m_matPsdSum += *t_pPeriodogram;
+
+    if(m_iSinceResync >= RTNOISE_RESYNC_SEGMENTS) {
+        m_matPsdSum.setZero();
+        for(qint32 i = 0; i < m_vecPeriodograms.size(); ++i)
+            m_matPsdSum += m_vecPeriodograms[i];
+        m_iSinceResync = 0;
+    }
+}
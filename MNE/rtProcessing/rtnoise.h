@@ -81,6 +81,14 @@
 #include <Eigen/Core>
 #include <unsupported/Eigen/FFT>
 
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define RTNOISE_RESYNC_SEGMENTS     64      /**< Number of evicted segments after which the periodogram sum is recomputed from the stored periodograms, which bounds the rounding drift of adding and subtracting. */
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE NAMESPACE RTPROCESSINGLIB
@@ -102,7 +110,9 @@ using namespace FIFFLIB;
 
 //=============================================================================================================
 /**
-* Real-time noise Spectrum estimation
+* Real-time noise Spectrum estimation. Welch's method: Hanning windowed segments are transformed as they complete
+* and the averaged periodogram of the segments within the data length is emitted in dB. Segments overlap by 50%
+* unless a refresh interval is set, which then is the hop between two segments and thus between two spectra.
 *
 * @brief Real-time Noise estimation
 */
@@ -117,8 +127,9 @@ public:
     /**
     * Creates the real-time covariance estimation object.
     *
-    * @param[in] p_iMaxSamples      Number of samples to use for each data chunk
+    * @param[in] p_iMaxSamples      FFT length, segments shorter than this are zero padded
     * @param[in] p_pFiffInfo        Associated Fiff Information
+    * @param[in] p_dataLen          Number of blocks the spectrum is averaged over
     * @param[in] parent     Parent QObject (optional)
     */
     explicit RtNoise(qint32 p_iMaxSamples, FiffInfo::SPtr p_pFiffInfo, qint32 p_dataLen, QObject *parent = 0);
@@ -137,6 +148,15 @@ public:
     */
     void append(const MatrixXd &p_DataSegment);
 
+    //=========================================================================================================
+    /**
+    * Sets the interval in which spectra are emitted, i.e. the hop between two segments. A shorter hop refreshes
+    * more often at the cost of one transform per channel and hop. Takes effect with the next start.
+    *
+    * @param[in] p_iMSec    the refresh interval in ms, 0 for segments with 50% overlap (default)
+    */
+    void setRefreshInterval(qint32 p_iMSec);
+
     //=========================================================================================================
     /**
     * Returns true if is running, otherwise false.
@@ -183,6 +203,21 @@ protected:
     QVector <float> hanning(int N, short itype);
 
 private:
+    //=========================================================================================================
+    /**
+    * Sets up the segmentation, the window and the work memory for the shape of the first block.
+    *
+    * @param[in] p_iBlockSize   Number of samples per block
+    * @param[in] p_iSensors     Number of channels
+    */
+    void initWelch(qint32 p_iBlockSize, qint32 p_iSensors);
+
+    //=========================================================================================================
+    /**
+    * Transforms the full segment buffer and replaces the oldest periodogram in the running sum.
+    */
+    void processSegment();
+
     QMutex      mutex;                  /**< Provides access serialization between threads*/
 
     FiffInfo::SPtr  m_pFiffInfo;        /**< Holds the fiff measurement information. */
@@ -197,14 +232,28 @@ private:
 
     qint32 m_iFFTlength;
     qint32 m_dataLength;
+    qint32 m_iRefreshInterval;          /**< Hop between two segments in ms, 0 for half a segment. Guarded by mutex. */
 
 protected:
     int m_iNumOfBlocks;
     int m_iBlockSize;
     int m_iSensors;
-    int m_iBlockIndex;
 
-    MatrixXd m_matCircBuf;
+    qint32 m_iSegmentLength;            /**< Number of samples per segment, at most the FFT length. */
+    qint32 m_iHop;                      /**< Number of samples between the starts of two segments. */
+    qint32 m_iNumSegments;              /**< Number of segments within the data length. */
+    qint32 m_iSegmentFill;              /**< Number of samples in the segment buffer. */
+    qint32 m_iOldestSegment;            /**< Index of the oldest periodogram once all are filled. */
+    qint32 m_iSinceResync;              /**< Number of segments evicted since the sum was recomputed. */
+
+    Eigen::FFT<double>  m_fft;          /**< FFT object - holds the plan for the FFT length and is reused for all channels and segments. */
+    VectorXd    m_vecWindow;            /**< Hanning window of the segment length. */
+    double      m_dScale;               /**< One-sided PSD scaling - 2/(Fs*sum(w^2)). */
+    MatrixXd    m_matSegment;           /**< Segment buffer - one column per channel, segment length rows. */
+    VectorXd    m_vecTime;              /**< Windowed and zero padded segment of one channel. */
+    VectorXcd   m_vecFreq;              /**< Half spectrum of one channel. */
+    QVector<MatrixXd>   m_vecPeriodograms;  /**< Periodograms of the segments within the data length - channels x bins, used as ring. */
+    MatrixXd    m_matPsdSum;            /**< Sum of the stored periodograms. */
 
 public:
     MatrixXd m_matSpecData;
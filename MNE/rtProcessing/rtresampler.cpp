@@ -0,0 +1,292 @@
+//=============================================================================================================
+/**
+* @file     rtresampler.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the implementation of the RtResampler class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rtresampler.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <math.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace Eigen;
+using namespace FIFFLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC FUNCTIONS
+//=============================================================================================================
+
+static double besselI0(double dX)
+{
+    //Power series of the modified Bessel function of the first kind and order zero
+    double t_dSum = 1.0;
+    double t_dTerm = 1.0;
+    for(int k = 1; k < 64; ++k) {
+        t_dTerm *= (dX / (2.0 * k)) * (dX / (2.0 * k));
+        t_dSum += t_dTerm;
+        if(t_dTerm < 1e-16 * t_dSum)
+            break;
+    }
+    return t_dSum;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+RtResampler::RtResampler()
+: m_iUp(1)
+, m_iDown(1)
+, m_iHalfLength(RTRESAMPLER_DEFAULT_HALF_LENGTH)
+, m_iDelay(0)
+, m_iPhaseLength(1)
+, m_iNumChannels(0)
+, m_iBlockSize(0)
+, m_iPosition(0)
+{
+    design();
+}
+
+
+//*************************************************************************************************************
+
+bool RtResampler::setFactors(int iUp, int iDown, int iHalfLength)
+{
+    if(iUp < 1 || iDown < 1 || iHalfLength < 1)
+        return false;
+
+    //Reduce L/M
+    int a = iUp;
+    int b = iDown;
+    while(b != 0) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+
+    m_iUp = iUp / a;
+    m_iDown = iDown / a;
+    m_iHalfLength = iHalfLength;
+
+    design();
+    reset();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void RtResampler::setHoldChannels(const QVector<int>& vecHoldChannels)
+{
+    m_vecHoldChannels = vecHoldChannels;
+    reset();
+}
+
+
+//*************************************************************************************************************
+
+void RtResampler::reset()
+{
+    //The buffer is cleared when the next block arrives
+    m_iNumChannels = 0;
+    m_iBlockSize = 0;
+    m_iPosition = 0;
+}
+
+
+//*************************************************************************************************************
+
+int RtResampler::numOutputSamples(int iNumInputSamples) const
+{
+    int t_iEnd = iNumInputSamples * m_iUp;
+    if(m_iPosition >= t_iEnd)
+        return 0;
+
+    return (t_iEnd - m_iPosition + m_iDown - 1) / m_iDown;
+}
+
+
+//*************************************************************************************************************
+
+void RtResampler::resample(const MatrixXd& matDataIn, MatrixXd& matDataOut)
+{
+    const int t_iNumSamples = matDataIn.cols();
+    const int t_iHistory = m_iPhaseLength - 1;
+
+    prepare(matDataIn.rows(), t_iNumSamples);
+
+    m_matBuffer.middleCols(t_iHistory, t_iNumSamples) = matDataIn;
+
+    const int t_iNumOut = numOutputSamples(t_iNumSamples);
+    if(matDataOut.rows() != matDataIn.rows() || matDataOut.cols() != t_iNumOut)
+        matDataOut.resize(matDataIn.rows(), t_iNumOut);
+
+    //Output n lies at m_iPosition + n*M of the upsampled stream. Its newest input sample is the one at or before
+    //that position and the remainder selects the phase.
+    int t_iPos = m_iPosition;
+    for(int n = 0; n < t_iNumOut; ++n, t_iPos += m_iDown) {
+        matDataOut.col(n).noalias() = m_matBuffer.middleCols(t_iPos / m_iUp, m_iPhaseLength) * m_matPhases.col(t_iPos % m_iUp);
+    }
+
+    //Hold channels take the last input sample before the output position minus the filter delay. The offset keeps
+    //the division positive, the delay never exceeds the history.
+    if(!m_vecHoldChannels.isEmpty()) {
+        t_iPos = m_iPosition - m_iDelay + t_iHistory * m_iUp;
+        for(int n = 0; n < t_iNumOut; ++n, t_iPos += m_iDown) {
+            const int t_iCol = t_iPos / m_iUp;
+            for(int i = 0; i < m_vecHoldChannels.size(); ++i) {
+                const int t_iChannel = m_vecHoldChannels[i];
+                if(t_iChannel >= 0 && t_iChannel < m_iNumChannels)
+                    matDataOut(t_iChannel, n) = m_matBuffer(t_iChannel, t_iCol);
+            }
+        }
+    }
+
+    m_iPosition += t_iNumOut * m_iDown - t_iNumSamples * m_iUp;
+
+    //Keep the newest samples as history of the next block - front to back, so overlapping ranges are fine
+    for(int i = 0; i < t_iHistory; ++i)
+        m_matBuffer.col(i) = m_matBuffer.col(i + t_iNumSamples);
+}
+
+
+//*************************************************************************************************************
+
+FiffInfo::SPtr RtResampler::resampledInfo(const FiffInfo& info) const
+{
+    FiffInfo::SPtr t_pInfo(new FiffInfo(info));
+
+    t_pInfo->sfreq = (float)((double)info.sfreq * m_iUp / m_iDown);
+
+    //The anti-aliasing filter removes everything above the lower Nyquist frequency
+    float t_fCutoff = qMin(info.sfreq, t_pInfo->sfreq) / 2.0f;
+    if(t_pInfo->lowpass <= 0.0f || t_pInfo->lowpass > t_fCutoff)
+        t_pInfo->lowpass = t_fCutoff;
+
+    return t_pInfo;
+}
+
+
+//*************************************************************************************************************
+
+void RtResampler::design()
+{
+    if(m_iUp == 1 && m_iDown == 1) {
+        m_iDelay = 0;
+        m_iPhaseLength = 1;
+        m_matPhases = MatrixXd::Ones(1, 1);
+        return;
+    }
+
+    //Kaiser windowed sinc at the upsampled rate, cut off at the lower of the two Nyquist frequencies
+    const int t_iMaxFactor = qMax(m_iUp, m_iDown);
+    const int t_iLength = 2 * m_iHalfLength * t_iMaxFactor + 1;
+    const double t_dCutoff = 1.0 / t_iMaxFactor;
+    const double t_dWindowNorm = besselI0(RTRESAMPLER_KAISER_BETA);
+
+    m_iDelay = m_iHalfLength * t_iMaxFactor;
+
+    VectorXd t_vecTaps(t_iLength);
+    for(int i = 0; i < t_iLength; ++i) {
+        const double t_dX = (double)(i - m_iDelay);
+        const double t_dSinc = (i == m_iDelay) ? t_dCutoff : sin(M_PI * t_dCutoff * t_dX) / (M_PI * t_dX);
+        const double t_dR = t_dX / m_iDelay;
+        t_vecTaps[i] = t_dSinc * besselI0(RTRESAMPLER_KAISER_BETA * sqrt(qMax(0.0, 1.0 - t_dR * t_dR))) / t_dWindowNorm;
+    }
+
+    //Unit gain at DC after upsampling, which spreads the energy of an input sample over L output positions
+    t_vecTaps *= m_iUp / t_vecTaps.sum();
+
+    //Phase p holds the taps p, p + L, p + 2L, ... - reversed, so that they line up with the input buffer
+    m_iPhaseLength = (t_iLength + m_iUp - 1) / m_iUp;
+    m_matPhases = MatrixXd::Zero(m_iPhaseLength, m_iUp);
+    for(int p = 0; p < m_iUp; ++p) {
+        for(int k = 0; k < m_iPhaseLength; ++k) {
+            const int t_iTap = p + k * m_iUp;
+            if(t_iTap < t_iLength)
+                m_matPhases(m_iPhaseLength - 1 - k, p) = t_vecTaps[t_iTap];
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void RtResampler::prepare(int iNumChannels, int iBlockSize)
+{
+    const int t_iHistory = m_iPhaseLength - 1;
+
+    if(iNumChannels != m_iNumChannels) {
+        m_matBuffer = MatrixXd::Zero(iNumChannels, t_iHistory + iBlockSize);
+        m_iNumChannels = iNumChannels;
+        m_iBlockSize = iBlockSize;
+        return;
+    }
+
+    if(iBlockSize != m_iBlockSize) {
+        MatrixXd t_matHistory = m_matBuffer.leftCols(t_iHistory);
+        m_matBuffer.resize(iNumChannels, t_iHistory + iBlockSize);
+        m_matBuffer.leftCols(t_iHistory) = t_matHistory;
+        m_iBlockSize = iBlockSize;
+    }
+}
@@ -0,0 +1,252 @@
+//=============================================================================================================
+/**
+* @file     rtresampler.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the declaration of the RtResampler class.
+*
+*/
+
+#ifndef RTRESAMPLER_H
+#define RTRESAMPLER_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rtprocessing_global.h"
+
+#include <fiff/fiff_info.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define RTRESAMPLER_DEFAULT_HALF_LENGTH     10      /**< Default half length of the anti-aliasing filter in periods of the lower of the two rates. */
+#define RTRESAMPLER_KAISER_BETA             5.0     /**< Kaiser window shape of the anti-aliasing filter. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE RTPROCESSINGLIB
+//=============================================================================================================
+
+namespace RTPROCESSINGLIB
+{
+
+
+//=============================================================================================================
+/**
+* Streaming rational resampler. Changes the sampling rate of multi-channel blocks by L/M (up factor L, down
+* factor M). The stream is conceptually upsampled by L, low-pass filtered below the lower of the two Nyquist
+* frequencies and downsampled by M. The polyphase form only evaluates the filter at the output samples and only
+* multiplies with the input samples which are not zero after upsampling, so an output sample costs the length of
+* one filter phase per channel. Every output sample is the product of the recent input columns with one phase,
+* which runs on all channels at once.
+*
+* The last input samples and the position of the next output sample are kept between blocks, so consecutive
+* blocks of any size are resampled as one continuous stream. The number of output samples of a block varies if
+* the block size is not a multiple of M; numOutputSamples tells it in advance.
+*
+* Channels set by setHoldChannels, e.g. trigger channels, are not filtered. They take the input sample which is
+* closest before the (delayed) output time, so their values stay exact and aligned with the filtered channels.
+*
+* @brief Polyphase rational resampler with state across blocks.
+*/
+class RTPROCESSINGSHARED_EXPORT RtResampler
+{
+public:
+    //=========================================================================================================
+    /**
+    * Creates a resampler which passes the data through unchanged (L = M = 1).
+    */
+    RtResampler();
+
+    //=========================================================================================================
+    /**
+    * Sets the resampling factors and designs the anti-aliasing filter. The factors are reduced by their greatest
+    * common divisor. Resets the state.
+    *
+    * @param[in] iUp            up factor L
+    * @param[in] iDown          down factor M
+    * @param[in] iHalfLength    half length of the filter in periods of the lower of the two rates, the longer the
+    *                           steeper the transition band
+    *
+    * @return false if a factor is not positive, in which case the resampler stays unchanged
+    */
+    bool setFactors(int iUp, int iDown, int iHalfLength = RTRESAMPLER_DEFAULT_HALF_LENGTH);
+
+    //=========================================================================================================
+    /**
+    * Sets the channels which are resampled by taking the closest earlier sample instead of filtering, e.g. the
+    * trigger channels. Resets the state.
+    *
+    * @param[in] vecHoldChannels    indices of the channels
+    */
+    void setHoldChannels(const QVector<int>& vecHoldChannels);
+
+    //=========================================================================================================
+    /**
+    * Clears the input history and the output position, e.g. after a gap in the data stream.
+    */
+    void reset();
+
+    //=========================================================================================================
+    /**
+    * Returns the number of output samples the next call of resample yields for the given number of input samples.
+    *
+    * @param[in] iNumInputSamples   number of columns of the next input block
+    *
+    * @return the number of output columns
+    */
+    int numOutputSamples(int iNumInputSamples) const;
+
+    //=========================================================================================================
+    /**
+    * Resamples one block. The output storage is only reallocated if its shape changes.
+    *
+    * @param[in] matDataIn      the block which is to be resampled
+    * @param[out] matDataOut    the resampled block with numOutputSamples(matDataIn.cols()) columns
+    */
+    void resample(const Eigen::MatrixXd& matDataIn, Eigen::MatrixXd& matDataOut);
+
+    //=========================================================================================================
+    /**
+    * Returns a copy of the measurement info which describes the resampled stream: the sampling frequency is scaled
+    * by L/M and the low-pass is limited to the cutoff of the anti-aliasing filter.
+    *
+    * @param[in] info   the measurement info of the input stream
+    *
+    * @return the measurement info of the output stream
+    */
+    FIFFLIB::FiffInfo::SPtr resampledInfo(const FIFFLIB::FiffInfo& info) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the delay of the anti-aliasing filter.
+    *
+    * @return the delay in output samples
+    */
+    inline double delay() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the up factor L after reduction.
+    *
+    * @return the up factor
+    */
+    inline int upFactor() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the down factor M after reduction.
+    *
+    * @return the down factor
+    */
+    inline int downFactor() const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Designs the Kaiser windowed sinc filter and splits it into the L phases.
+    */
+    void design();
+
+    //=========================================================================================================
+    /**
+    * Prepares the input buffer for the given block shape. The history is kept if the number of channels stays the
+    * same.
+    *
+    * @param[in] iNumChannels   number of rows of the blocks
+    * @param[in] iBlockSize     number of columns of the blocks
+    */
+    void prepare(int iNumChannels, int iBlockSize);
+
+    int                 m_iUp;                  /**< Up factor L. */
+    int                 m_iDown;                /**< Down factor M. */
+    int                 m_iHalfLength;          /**< Half length of the filter in periods of the lower rate. */
+    int                 m_iDelay;               /**< Delay of the filter at the upsampled rate. */
+    int                 m_iPhaseLength;         /**< Number of taps per phase, i.e. number of input samples per output sample. */
+    Eigen::MatrixXd     m_matPhases;            /**< One column per phase, taps ordered from the oldest to the newest input sample. */
+
+    QVector<int>        m_vecHoldChannels;      /**< Channels which are not filtered. */
+    int                 m_iNumChannels;         /**< Number of rows the buffer is prepared for. */
+    int                 m_iBlockSize;           /**< Number of columns the buffer is prepared for. */
+    Eigen::MatrixXd     m_matBuffer;            /**< Last m_iPhaseLength - 1 input samples followed by the current block. */
+    int                 m_iPosition;            /**< Position of the next output sample at the upsampled rate, relative to the first sample of the next block. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline double RtResampler::delay() const
+{
+    return (double)m_iDelay / (double)m_iDown;
+}
+
+
+//*************************************************************************************************************
+
+inline int RtResampler::upFactor() const
+{
+    return m_iUp;
+}
+
+
+//*************************************************************************************************************
+
+inline int RtResampler::downFactor() const
+{
+    return m_iDown;
+}
+
+} // NAMESPACE
+
+#endif // RTRESAMPLER_H
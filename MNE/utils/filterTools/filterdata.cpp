@@ -46,6 +46,7 @@
 
 #include "parksmcclellan.h"
 #include "cosinefilter.h"
+#include "iirfilter.h"
 
 
 //*************************************************************************************************************
@@ -183,6 +184,36 @@ void FilterData::designFilter()
 
             break;
         }
+
+        case ButterworthIIR:
+        case ChebyshevIIR: {
+            IirFilter::TPassType t_type = IirFilter::LPF;
+            if(m_Type == HPF)
+                t_type = IirFilter::HPF;
+            if(m_Type == BPF)
+                t_type = IirFilter::BPF;
+            if(m_Type == NOTCH)
+                t_type = IirFilter::NOTCH;
+
+            IirFilter filteriir(m_iFilterOrder,
+                                m_dCenterFreq,
+                                m_dBandwidth,
+                                t_type,
+                                m_designMethod == ButterworthIIR ? IirFilter::Butterworth : IirFilter::Chebyshev);
+
+            m_iFilterOrder = filteriir.m_iFilterOrder;
+            m_matSos = filteriir.m_matSos;
+            m_dCoeffA = filteriir.m_dCoeffA;
+            m_dCoeffB = filteriir.m_dCoeffB;
+
+            //The frequency response of the sections replaces the fft of the coefficients
+            fftTransformCoeffs();
+
+            break;
+        }
+
+        default:
+            break;
     }
 
     switch(m_Type) {
@@ -205,10 +236,23 @@ void FilterData::designFilter()
 }
 
 
+//*************************************************************************************************************
+
+bool FilterData::isIIR() const
+{
+    return m_matSos.rows() > 0;
+}
+
+
 //*************************************************************************************************************
 
 void FilterData::fftTransformCoeffs()
 {
+    if(isIIR()) {
+        m_dFFTCoeffA = IirFilter::sosResponse(m_matSos, m_iFFTlength);
+        return;
+    }
+
     //zero-pad m_dCoeffA to m_iFFTlength
     RowVectorXd t_coeffAzeroPad = RowVectorXd::Zero(m_iFFTlength);
     t_coeffAzeroPad.head(m_dCoeffA.cols()) = m_dCoeffA;
@@ -227,6 +271,13 @@ void FilterData::fftTransformCoeffs()
 
 RowVectorXd FilterData::applyConvFilter(const RowVectorXd& data, bool keepOverhead, CompensateEdgeEffects compensateEdgeEffects) const
 {
+    if(isIIR()) {
+        //Recursive filters are causal - the overhead is the response to zeros following the data
+        RowVectorXd t_data = RowVectorXd::Zero(data.cols() + (keepOverhead ? m_dCoeffA.cols() : 0));
+        t_data.head(data.cols()) = data;
+        return IirFilter::applySos(m_matSos, t_data);
+    }
+
     if(data.cols()<m_dCoeffA.cols() && compensateEdgeEffects==MirrorData){
         qDebug()<<QString("Error in FilterData: Number of filter taps(%1) bigger then data size(%2). Not enough data to perform mirroring!").arg(m_dCoeffA.cols()).arg(data.cols());
         return data;
@@ -338,6 +389,12 @@ QString FilterData::getStringForDesignMethod(const FilterData::DesignMethod &des
     if(designMethod == FilterData::Tschebyscheff)
         designMethodString = "Tschebyscheff";
 
+    if(designMethod == FilterData::ButterworthIIR)
+        designMethodString = "ButterworthIIR";
+
+    if(designMethod == FilterData::ChebyshevIIR)
+        designMethodString = "ChebyshevIIR";
+
     return designMethodString;
 }
 
@@ -379,6 +436,12 @@ FilterData::DesignMethod FilterData::getDesignMethodForString(const QString &des
     if(designMethodString == "Cosine")
         designMethod = FilterData::Cosine;
 
+    if(designMethodString == "ButterworthIIR")
+        designMethod = FilterData::ButterworthIIR;
+
+    if(designMethodString == "ChebyshevIIR")
+        designMethod = FilterData::ChebyshevIIR;
+
     return designMethod;
 }
 
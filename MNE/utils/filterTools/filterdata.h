@@ -102,7 +102,9 @@ public:
     enum DesignMethod {
         Tschebyscheff,
         Cosine,
-        External
+        External,
+        ButterworthIIR,
+        ChebyshevIIR
     } m_designMethod;
 
     enum FilterType {
@@ -128,13 +130,13 @@ public:
     * Constructs a FilterData object
     * @param [in] unique_name defines the name of the generated filter
     * @param [in] type of the filter: LPF, HPF, BPF, NOTCH (from enum FilterType)
-    * @param [in] order represents the order of the filter, the higher the higher is the stopband attenuation
+    * @param [in] order represents the order of the filter, the higher the higher is the stopband attenuation. For the IIR design methods this is the order of the analog prototype (typically 2-8).
     * @param [in] centerfreq determines the center of the frequency
     * @param [in] bandwidth ignored if FilterType is set to LPF,HPF. if NOTCH/BPF: bandwidth of stop-/passband
     * @param [in] parkswidth determines the width of the filter slopes (steepness)
     * @param [in] sFreq sampling frequency
     * @param [in] fftlength length of the fft (multiple integer of 2^x)
-    * @param [in] designMethod specifies the design method to use. Choose between Cosind and Tschebyscheff
+    * @param [in] designMethod specifies the design method to use. Choose between Cosind and Tschebyscheff (FIR) or ButterworthIIR and ChebyshevIIR (second-order sections)
     */
     FilterData(QString unique_name, FilterType type, int order, double centerfreq, double bandwidth, double parkswidth, double sFreq, qint32 fftlength=4096, DesignMethod designMethod = Cosine);
 
@@ -149,7 +151,12 @@ public:
     void designFilter();
 
     /**
-    * Applies the current filter to the input data using convolution in time domain. Pro: Uses only past samples (real-time capable) Con: Might not be as ideal as acausal version (steepness etc.)
+     * @brief isIIR returns whether the filter is a recursive filter given by m_matSos
+     */
+    bool isIIR() const;
+
+    /**
+    * Applies the current filter to the input data using convolution in time domain. IIR filters run their second-order sections instead, starting from zero state. Pro: Uses only past samples (real-time capable) Con: Might not be as ideal as acausal version (steepness etc.)
     *
     * @param [in] data holds the data to be filtered
     * @param [in] keepOverhead whether the result should still include the overhead information in front and back of the data
@@ -206,6 +213,8 @@ public:
 
     RowVectorXcd    m_dFFTCoeffA;       /**< the FFT-transformed forward filter coefficient set, required for frequency-domain filtering, zero-padded to m_iFFTlength. */
     RowVectorXcd    m_dFFTCoeffB;       /**< the FFT-transformed backward filter coefficient set, required for frequency-domain filtering, zero-padded to m_iFFTlength. */
+
+    MatrixXd        m_matSos;           /**< the second-order sections of IIR filters, one per row as b0 b1 b2 a0 a1 a2 (empty if FIR filter). */
 };
 
 //*************************************************************************************************************
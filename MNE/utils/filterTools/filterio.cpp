@@ -86,6 +86,7 @@ bool FilterIO::readFilter(QString path, FilterData &filter)
     //Start reading from file
     QTextStream in(&file);
     QVector<double> coefficientsTemp;
+    QVector<double> sosTemp;
 
     while(!in.atEnd())
     {
@@ -134,13 +135,23 @@ bool FilterIO::readFilter(QString path, FilterData &filter)
             if(line.contains("DesignMethod") && fields.size()==2)
                 filter.m_designMethod = FilterData::getDesignMethodForString(fields.at(1));
 
+            //Read the second-order sections of IIR filters
+            if(line.contains("SOS") && fields.size()==7)
+                for(int i=1; i<fields.size(); i++)
+                    sosTemp.push_back(fields.at(i).toDouble());
+
         } else // Read filter coefficients
             coefficientsTemp.push_back(fields.join("").toDouble());
     }
-    // Check if reading was successful and correct
-    if(filter.m_iFilterOrder != coefficientsTemp.size())
+    // Check if reading was successful and correct. The order of IIR filters is the prototype order.
+    if(filter.m_iFilterOrder != coefficientsTemp.size() && sosTemp.isEmpty())
         filter.m_iFilterOrder = coefficientsTemp.size();
 
+    filter.m_matSos = MatrixXd::Zero(sosTemp.size()/6, 6);
+    for(int i=0; i<filter.m_matSos.rows(); i++)
+        for(int j=0; j<6; j++)
+            filter.m_matSos(i,j) = sosTemp.at(6*i+j);
+
 //    if(filter.m_sFreq)
 
 //    if(filter.m_sName)
@@ -191,6 +202,14 @@ bool FilterIO::writeFilter(const QString &path, const FilterData &filter)
         out << "#CenterFreq " << filter.m_dCenterFreq << "\n";
         out << "#DesignMethod " << FilterData::getStringForDesignMethod(filter.m_designMethod) << "\n";
 
+        //Sections of IIR filters need full precision to stay stable
+        if(filter.isIIR())
+            out.setRealNumberPrecision(17);
+
+        for(int i = 0 ; i<filter.m_matSos.rows() ;i++)
+            out << "#SOS " << filter.m_matSos(i,0) << " " << filter.m_matSos(i,1) << " " << filter.m_matSos(i,2) << " "
+                << filter.m_matSos(i,3) << " " << filter.m_matSos(i,4) << " " << filter.m_matSos(i,5) << "\n";
+
         for(int i = 0 ; i<filter.m_dCoeffA.cols() ;i++)
             out << filter.m_dCoeffA(i) << "\n";
 
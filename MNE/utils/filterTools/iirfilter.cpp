@@ -0,0 +1,420 @@
+//=============================================================================================================
+/**
+* @file     iirfilter.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the IirFilter class
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "iirfilter.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QVector>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <complex>
+#include <cmath>
+#include <algorithm>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+
+typedef std::complex<double> Complex;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846  /* pi */
+#endif
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+/**
+* Product of all values.
+*/
+Complex product(const QVector<Complex>& values)
+{
+    Complex t_prod(1.0, 0.0);
+    for(int i = 0; i < values.size(); ++i)
+        t_prod *= values.at(i);
+    return t_prod;
+}
+
+
+/**
+* Orders real roots ascending.
+*/
+bool realLessThan(const Complex& a, const Complex& b)
+{
+    return a.real() < b.real();
+}
+
+
+/**
+* Orders root groups by the distance of their first root to the origin.
+*/
+bool groupMagnitudeLessThan(const QVector<Complex>& a, const QVector<Complex>& b)
+{
+    return std::abs(a.at(0)) < std::abs(b.at(0));
+}
+
+
+/**
+* Splits roots into groups of one conjugate pair, two real roots or a single real root.
+*/
+QVector<QVector<Complex> > groupRoots(const QVector<Complex>& roots)
+{
+    const double t_dEps = 1e-10;
+
+    QVector<QVector<Complex> > t_groups;
+    QVector<Complex> t_real;
+
+    for(int i = 0; i < roots.size(); ++i) {
+        if(std::abs(roots.at(i).imag()) <= t_dEps * qMax(1.0, std::abs(roots.at(i)))) {
+            t_real.append(Complex(roots.at(i).real(), 0.0));
+        } else if(roots.at(i).imag() > 0.0) {
+            QVector<Complex> t_pair;
+            t_pair << roots.at(i) << std::conj(roots.at(i));
+            t_groups.append(t_pair);
+        }
+    }
+
+    std::sort(t_real.begin(), t_real.end(), realLessThan);
+
+    for(int i = 0; i + 1 < t_real.size(); i += 2) {
+        QVector<Complex> t_pair;
+        t_pair << t_real.at(i) << t_real.at(i+1);
+        t_groups.append(t_pair);
+    }
+
+    if(t_real.size() % 2 == 1) {
+        QVector<Complex> t_single;
+        t_single << t_real.last();
+        t_groups.append(t_single);
+    }
+
+    return t_groups;
+}
+
+
+/**
+* Real coefficients 1, c1, c2 of the polynomial with the given (at most two) roots.
+*/
+Vector3d polynomial(const QVector<Complex>& roots)
+{
+    Vector3d t_poly(1.0, 0.0, 0.0);
+
+    if(roots.size() == 1) {
+        t_poly(1) = -roots.at(0).real();
+    } else if(roots.size() == 2) {
+        t_poly(1) = -(roots.at(0) + roots.at(1)).real();
+        t_poly(2) = (roots.at(0) * roots.at(1)).real();
+    }
+
+    return t_poly;
+}
+
+} // NAMESPACE
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+IirFilter::IirFilter()
+: m_iFilterOrder(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+IirFilter::IirFilter(int order, double centerfreq, double bandwidth, TPassType type, TDesignType design, double ripple)
+: m_iFilterOrder(qBound(1, order, IIRFILTER_MAX_ORDER))
+{
+    if(order != m_iFilterOrder)
+        qDebug() << "IirFilter: order" << order << "clipped to" << m_iFilterOrder;
+
+    int n = m_iFilterOrder;
+
+    //
+    // Analog lowpass prototype with cutoff 1 rad/s
+    //
+    QVector<Complex> t_z, t_p;
+    double t_k = 1.0;
+
+    switch(design) {
+        case Chebyshev: {
+            double t_dEps = std::sqrt(std::pow(10.0, ripple/10.0) - 1.0);
+            double t_dMu = std::log(1.0/t_dEps + std::sqrt(1.0/(t_dEps*t_dEps) + 1.0)) / n;   //asinh(1/eps)/n
+
+            for(int i = 0; i < n; ++i) {
+                double t_dTheta = M_PI * (2*i + 1) / (2.0*n);
+                t_p.append(Complex(-std::sinh(t_dMu) * std::sin(t_dTheta), std::cosh(t_dMu) * std::cos(t_dTheta)));
+            }
+
+            t_k = product(t_p).real() * (n % 2 == 0 ? 1.0 : -1.0);
+            if(n % 2 == 0)
+                t_k /= std::sqrt(1.0 + t_dEps*t_dEps);
+            break;
+        }
+
+        case Butterworth:
+        default: {
+            for(int i = 0; i < n; ++i)
+                t_p.append(std::exp(Complex(0.0, M_PI * (2*i + n + 1) / (2.0*n))));
+            t_k = 1.0;
+            break;
+        }
+    }
+
+    //
+    // Prewarp the band edges (normed to Nyquist, bilinear transform with fs = 2)
+    //
+    const double t_dFs2 = 4.0;
+    double t_dLow = qBound(1e-6, centerfreq - bandwidth/2.0, 1.0 - 1e-6);
+    double t_dHigh = qBound(1e-6, centerfreq + bandwidth/2.0, 1.0 - 1e-6);
+    double t_dCut = qBound(1e-6, centerfreq, 1.0 - 1e-6);
+
+    double t_dWarpedLow = t_dFs2 * std::tan(M_PI * t_dLow / 2.0);
+    double t_dWarpedHigh = t_dFs2 * std::tan(M_PI * t_dHigh / 2.0);
+    double t_dWarpedCut = t_dFs2 * std::tan(M_PI * t_dCut / 2.0);
+
+    double t_dWo = std::sqrt(t_dWarpedLow * t_dWarpedHigh);
+    double t_dBw = t_dWarpedHigh - t_dWarpedLow;
+
+    //
+    // Transform the prototype to the requested pass type
+    //
+    QVector<Complex> t_zt, t_pt;
+    int t_iDegree = t_p.size() - t_z.size();
+
+    switch(type) {
+        case HPF: {
+            t_k *= (product(t_z) / product(t_p)).real() * ((t_p.size() - t_z.size()) % 2 == 0 ? 1.0 : -1.0);
+            for(int i = 0; i < t_p.size(); ++i)
+                t_pt.append(t_dWarpedCut / t_p.at(i));
+            for(int i = 0; i < t_iDegree; ++i)
+                t_zt.append(Complex(0.0, 0.0));
+            break;
+        }
+
+        case BPF: {
+            for(int i = 0; i < t_p.size(); ++i) {
+                Complex t_pLp = t_p.at(i) * t_dBw / 2.0;
+                Complex t_root = std::sqrt(t_pLp*t_pLp - t_dWo*t_dWo);
+                t_pt.append(t_pLp + t_root);
+                t_pt.append(t_pLp - t_root);
+            }
+            for(int i = 0; i < t_iDegree; ++i)
+                t_zt.append(Complex(0.0, 0.0));
+            t_k *= std::pow(t_dBw, t_iDegree);
+            break;
+        }
+
+        case NOTCH: {
+            t_k *= (product(t_z) / product(t_p)).real() * ((t_p.size() - t_z.size()) % 2 == 0 ? 1.0 : -1.0);
+            for(int i = 0; i < t_p.size(); ++i) {
+                Complex t_pHp = (t_dBw / 2.0) / t_p.at(i);
+                Complex t_root = std::sqrt(t_pHp*t_pHp - t_dWo*t_dWo);
+                t_pt.append(t_pHp + t_root);
+                t_pt.append(t_pHp - t_root);
+            }
+            for(int i = 0; i < t_iDegree; ++i) {
+                t_zt.append(Complex(0.0, t_dWo));
+                t_zt.append(Complex(0.0, -t_dWo));
+            }
+            break;
+        }
+
+        case LPF:
+        default: {
+            for(int i = 0; i < t_p.size(); ++i)
+                t_pt.append(t_p.at(i) * t_dWarpedCut);
+            t_k *= std::pow(t_dWarpedCut, t_iDegree);
+            break;
+        }
+    }
+
+    //
+    // Bilinear transform - remaining zeros go to Nyquist
+    //
+    QVector<Complex> t_zd, t_pd;
+    QVector<Complex> t_zNum, t_pNum;
+
+    for(int i = 0; i < t_zt.size(); ++i) {
+        t_zd.append((t_dFs2 + t_zt.at(i)) / (t_dFs2 - t_zt.at(i)));
+        t_zNum.append(t_dFs2 - t_zt.at(i));
+    }
+    for(int i = 0; i < t_pt.size(); ++i) {
+        t_pd.append((t_dFs2 + t_pt.at(i)) / (t_dFs2 - t_pt.at(i)));
+        t_pNum.append(t_dFs2 - t_pt.at(i));
+    }
+    while(t_zd.size() < t_pd.size())
+        t_zd.append(Complex(-1.0, 0.0));
+
+    t_k *= (product(t_zNum) / product(t_pNum)).real();
+
+    //
+    // Pair poles and zeros to second-order sections
+    //
+    QVector<QVector<Complex> > t_poleGroups = groupRoots(t_pd);
+    QVector<QVector<Complex> > t_zeroGroups = groupRoots(t_zd);
+
+    //Poles closest to the unit circle go last, which keeps the intermediate gains moderate
+    std::sort(t_poleGroups.begin(), t_poleGroups.end(), groupMagnitudeLessThan);
+
+    m_matSos = MatrixXd::Zero(t_poleGroups.size(), 6);
+
+    for(int s = t_poleGroups.size() - 1; s >= 0; --s) {
+        const QVector<Complex>& t_poles = t_poleGroups.at(s);
+
+        //Closest zero group of the same size, otherwise the closest one
+        int t_iBest = -1;
+        double t_dBest = 0.0;
+        for(int j = 0; j < t_zeroGroups.size(); ++j) {
+            double t_dDist = std::abs(t_zeroGroups.at(j).at(0) - t_poles.at(0));
+            if(t_zeroGroups.at(j).size() != t_poles.size())
+                t_dDist += 1e6;
+            if(t_iBest < 0 || t_dDist < t_dBest) {
+                t_iBest = j;
+                t_dBest = t_dDist;
+            }
+        }
+
+        QVector<Complex> t_zeros;
+        if(t_iBest >= 0) {
+            t_zeros = t_zeroGroups.at(t_iBest);
+            t_zeroGroups.remove(t_iBest);
+        }
+
+        m_matSos.block(s, 0, 1, 3) = polynomial(t_zeros).transpose();
+        m_matSos.block(s, 3, 1, 3) = polynomial(t_poles).transpose();
+    }
+
+    if(m_matSos.rows() > 0)
+        m_matSos.block(0, 0, 1, 3) *= t_k;
+
+    //
+    // Expanded transfer function of the cascade
+    //
+    m_dCoeffA = RowVectorXd::Ones(1);
+    m_dCoeffB = RowVectorXd::Ones(1);
+
+    for(int s = 0; s < m_matSos.rows(); ++s) {
+        RowVectorXd t_b = RowVectorXd::Zero(m_dCoeffA.cols() + 2);
+        RowVectorXd t_a = RowVectorXd::Zero(m_dCoeffB.cols() + 2);
+        for(int i = 0; i < 3; ++i) {
+            t_b.segment(i, m_dCoeffA.cols()) += m_matSos(s, i) * m_dCoeffA;
+            t_a.segment(i, m_dCoeffB.cols()) += m_matSos(s, 3+i) * m_dCoeffB;
+        }
+        m_dCoeffA = t_b;
+        m_dCoeffB = t_a;
+    }
+}
+
+
+//*************************************************************************************************************
+
+RowVectorXd IirFilter::applySos(const MatrixXd& matSos, const RowVectorXd& data)
+{
+    RowVectorXd t_data = data;
+
+    //Transposed direct form II, one section after the other
+    for(int s = 0; s < matSos.rows(); ++s) {
+        double b0 = matSos(s,0) / matSos(s,3);
+        double b1 = matSos(s,1) / matSos(s,3);
+        double b2 = matSos(s,2) / matSos(s,3);
+        double a1 = matSos(s,4) / matSos(s,3);
+        double a2 = matSos(s,5) / matSos(s,3);
+
+        double z1 = 0.0;
+        double z2 = 0.0;
+
+        for(int i = 0; i < t_data.cols(); ++i) {
+            double x = t_data(i);
+            double y = b0*x + z1;
+            z1 = b1*x - a1*y + z2;
+            z2 = b2*x - a2*y;
+            t_data(i) = y;
+        }
+    }
+
+    return t_data;
+}
+
+
+//*************************************************************************************************************
+
+RowVectorXcd IirFilter::sosResponse(const MatrixXd& matSos, int fftLength)
+{
+    RowVectorXcd t_response = RowVectorXcd::Ones(fftLength/2 + 1);
+
+    for(int k = 0; k < t_response.cols(); ++k) {
+        Complex t_e1 = std::exp(Complex(0.0, -2.0 * M_PI * k / fftLength));
+        Complex t_e2 = t_e1 * t_e1;
+
+        for(int s = 0; s < matSos.rows(); ++s)
+            t_response(k) *= (matSos(s,0) + matSos(s,1)*t_e1 + matSos(s,2)*t_e2) / (matSos(s,3) + matSos(s,4)*t_e1 + matSos(s,5)*t_e2);
+    }
+
+    return t_response;
+}
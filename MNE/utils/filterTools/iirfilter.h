@@ -0,0 +1,144 @@
+//=============================================================================================================
+/**
+* @file     iirfilter.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the IirFilter class
+*
+*/
+
+#ifndef IIRFILTER_H
+#define IIRFILTER_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../utils_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define IIRFILTER_MAX_ORDER     16      /**< Maximal order of the analog prototype. */
+#define IIRFILTER_RIPPLE_DB     0.5     /**< Default passband ripple of the Chebyshev design in dB. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE UTILSLIB
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* Designs Butterworth and Chebyshev (type I) IIR filters as cascades of second-order sections. The analog
+* prototype is transformed to the requested pass type and mapped to the digital domain with the prewarped
+* bilinear transform. Sections are stored one per row as b0 b1 b2 a0 a1 a2 with a0 = 1.
+*
+* @brief Creates IIR filters as second-order sections.
+*/
+class UTILSSHARED_EXPORT IirFilter
+{
+public:
+    enum TPassType {LPF, HPF, BPF, NOTCH };
+
+    enum TDesignType {Butterworth, Chebyshev };
+
+    //=========================================================================================================
+    /**
+    * Constructs an empty IirFilter object.
+    */
+    IirFilter();
+
+    //=========================================================================================================
+    /**
+    * Constructs an IirFilter object.
+    *
+    * @param order          order of the analog prototype, band pass and notch filters have twice as many poles
+    * @param centerfreq     cutoff frequency of LPF/HPF, center frequency of BPF/NOTCH (normed to the Nyquist frequency)
+    * @param bandwidth      bandwidth of BPF/NOTCH (normed to the Nyquist frequency), ignored for LPF/HPF
+    * @param type           filter type (lowpass, highpass, etc.)
+    * @param design         prototype (Butterworth or Chebyshev)
+    * @param ripple         passband ripple of the Chebyshev prototype in dB
+    */
+    IirFilter(int order, double centerfreq, double bandwidth, TPassType type, TDesignType design, double ripple = IIRFILTER_RIPPLE_DB);
+
+    //=========================================================================================================
+    /**
+    * Applies second-order sections to a signal, starting from zero state.
+    *
+    * @param matSos     the sections, one per row as b0 b1 b2 a0 a1 a2
+    * @param data       the signal
+    *
+    * @return the filtered signal
+    */
+    static RowVectorXd applySos(const MatrixXd& matSos, const RowVectorXd& data);
+
+    //=========================================================================================================
+    /**
+    * Evaluates the frequency response of second-order sections at the bins of a real FFT.
+    *
+    * @param matSos     the sections, one per row as b0 b1 b2 a0 a1 a2
+    * @param fftLength  length of the fft
+    *
+    * @return the complex response at fftLength/2+1 bins
+    */
+    static RowVectorXcd sosResponse(const MatrixXd& matSos, int fftLength);
+
+    MatrixXd        m_matSos;       /**< the second-order sections, one per row as b0 b1 b2 a0 a1 a2. */
+    RowVectorXd     m_dCoeffA;      /**< the numerator (forward) coefficients of the whole cascade. */
+    RowVectorXd     m_dCoeffB;      /**< the denominator (backward) coefficients of the whole cascade. */
+    int             m_iFilterOrder; /**< the order of the analog prototype. */
+};
+
+} // NAMESPACE UTILSLIB
+
+#endif // IIRFILTER_H
@@ -0,0 +1,257 @@
+//=============================================================================================================
+/**
+* @file     triggerdetector.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    TriggerDetector class definition
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "triggerdetector.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <algorithm>
+#include <limits>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+using namespace UTILSLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+TriggerDetector::TriggerDetector()
+: m_dThreshold(0.5)
+, m_flankType(Rising)
+, m_iMask(0)
+, m_iMinimumGap(0)
+, m_bPrimed(false)
+, m_iSampleCount(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+TriggerDetector::TriggerDetector(const QList<int>& lChannels, double dThreshold, FlankType type)
+: m_dThreshold(dThreshold)
+, m_flankType(type)
+, m_iMask(0)
+, m_iMinimumGap(0)
+, m_bPrimed(false)
+, m_iSampleCount(0)
+{
+    setChannels(lChannels);
+}
+
+
+//*************************************************************************************************************
+
+void TriggerDetector::setChannels(const QList<int>& lChannels)
+{
+    m_vecChannels.clear();
+    m_vecChannels.reserve(lChannels.size());
+    for(int i = 0; i < lChannels.size(); ++i)
+        m_vecChannels.append(lChannels[i]);
+
+    reset();
+}
+
+
+//*************************************************************************************************************
+
+void TriggerDetector::setThreshold(double dThreshold)
+{
+    m_dThreshold = dThreshold;
+}
+
+
+//*************************************************************************************************************
+
+void TriggerDetector::setFlankType(FlankType type)
+{
+    m_flankType = type;
+}
+
+
+//*************************************************************************************************************
+
+void TriggerDetector::setMask(qint32 iMask)
+{
+    m_iMask = iMask;
+}
+
+
+//*************************************************************************************************************
+
+void TriggerDetector::setMinimumGap(qint32 iSamples)
+{
+    m_iMinimumGap = qMax(iSamples, 0);
+}
+
+
+//*************************************************************************************************************
+
+void TriggerDetector::reset()
+{
+    m_bPrimed = false;
+    m_iSampleCount = 0;
+    m_vecLast = VectorXd::Zero(m_vecChannels.size());
+    m_vecLastEvent.fill(std::numeric_limits<qint64>::min() / 2, m_vecChannels.size());
+    m_vecEvents.resize(0);
+}
+
+
+//*************************************************************************************************************
+
+const QVector<TriggerDetector::Event>& TriggerDetector::detect(const MatrixXd& data)
+{
+    m_vecEvents.resize(0);
+
+    const qint32 t_iNumChs = m_vecChannels.size();
+    const qint32 t_iCols = data.cols();
+
+    if(t_iNumChs == 0 || t_iCols == 0) {
+        m_iSampleCount += t_iCols;
+        return m_vecEvents;
+    }
+
+    //Gather the stim channels behind the last sample of the previous block - the first block primes itself
+    m_matData.resize(t_iNumChs, t_iCols + 1);
+    for(qint32 k = 0; k < t_iNumChs; ++k) {
+        const qint32 t_iCh = m_vecChannels[k];
+        if(t_iCh >= 0 && t_iCh < data.rows())
+            m_matData.block(k, 1, 1, t_iCols) = data.row(t_iCh);
+        else
+            m_matData.row(k).tail(t_iCols).setZero();
+
+        m_matData(k, 0) = m_bPrimed ? m_vecLast[k] : m_matData(k, 1);
+        m_vecLast[k] = m_matData(k, t_iCols);
+    }
+    m_bPrimed = true;
+
+    m_matDiff = m_matData.rightCols(t_iCols) - m_matData.leftCols(t_iCols);
+
+    const bool t_bDigital = m_iMask != 0;
+    const bool t_bRising = m_flankType != Falling;
+    const bool t_bFalling = m_flankType != Rising;
+
+    qint32 t_iChsWithEvents = 0;
+
+    for(qint32 k = 0; k < t_iNumChs; ++k) {
+        //Most blocks are flat - reject them without looking at single samples
+        const double t_dMaxStep = m_matDiff.row(k).cwiseAbs().maxCoeff();
+        if(t_bDigital ? t_dMaxStep == 0.0 : t_dMaxStep < m_dThreshold)
+            continue;
+
+        const qint32 t_iEventsBefore = m_vecEvents.size();
+
+        if(t_bDigital) {
+            qint32 t_iLastCode = qRound(m_matData(k, 0)) & m_iMask;
+
+            for(qint32 t = 0; t < t_iCols; ++t) {
+                if(m_matDiff(k, t) == 0.0)
+                    continue;
+
+                const qint32 t_iCode = qRound(m_matData(k, t + 1)) & m_iMask;
+                if(t_iCode != t_iLastCode) {
+                    if(t_bRising && t_iCode != 0)
+                        appendEvent(k, t, t_iCode, true);
+                    if(t_bFalling && t_iLastCode != 0)
+                        appendEvent(k, t, t_iLastCode, false);
+                }
+                t_iLastCode = t_iCode;
+            }
+        } else {
+            for(qint32 t = 0; t < t_iCols; ++t) {
+                const double t_dStep = m_matDiff(k, t);
+
+                if(t_bRising && t_dStep >= m_dThreshold)
+                    appendEvent(k, t, qRound(m_matData(k, t + 1)), true);
+                else if(t_bFalling && t_dStep <= -m_dThreshold)
+                    appendEvent(k, t, qRound(m_matData(k, t)), false);
+            }
+        }
+
+        if(m_vecEvents.size() > t_iEventsBefore)
+            ++t_iChsWithEvents;
+    }
+
+    //Events of a single channel are already in order
+    if(t_iChsWithEvents > 1)
+        std::stable_sort(m_vecEvents.begin(), m_vecEvents.end(), lessThan);
+
+    m_iSampleCount += t_iCols;
+
+    return m_vecEvents;
+}
+
+
+//*************************************************************************************************************
+
+void TriggerDetector::appendEvent(qint32 k, qint32 t, qint32 iValue, bool bRising)
+{
+    const qint64 t_iSample = m_iSampleCount + t;
+    if(m_iMinimumGap > 0 && t_iSample - m_vecLastEvent[k] <= m_iMinimumGap)
+        return;
+
+    m_vecLastEvent[k] = t_iSample;
+
+    Event t_event;
+    t_event.iSample = t_iSample;
+    t_event.iChannel = m_vecChannels[k];
+    t_event.iValue = iValue;
+    t_event.bRising = bRising;
+    m_vecEvents.append(t_event);
+}
+
+
+//*************************************************************************************************************
+
+bool TriggerDetector::lessThan(const Event& a, const Event& b)
+{
+    return a.iSample < b.iSample;
+}
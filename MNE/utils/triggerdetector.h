@@ -0,0 +1,260 @@
+//=============================================================================================================
+/**
+* @file     triggerdetector.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    TriggerDetector class declaration
+*
+*/
+
+#ifndef TRIGGERDETECTOR_H
+#define TRIGGERDETECTOR_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "utils_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QList>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE UTILSLIB
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+
+//=============================================================================================================
+/**
+* Stateful trigger flank detection on a set of stim channels. In contrast to DetectTrigger the last sample
+* of every channel is kept between blocks, so flanks which fall exactly on a block boundary are found, and
+* all channels are scanned in one call. Blocks without any flank are rejected with a vectorized test, only
+* channels which contain a flank are scanned sample by sample.
+*
+* Two modes are supported: in analog mode (mask 0) a flank is a sample to sample step of at least the
+* threshold, in digital mode the channel is rounded to an integer code, masked, and every change of the
+* masked code is a flank.
+*
+* @brief Stateful multi channel trigger flank detection
+*/
+class UTILSSHARED_EXPORT TriggerDetector
+{
+
+public:
+    typedef QSharedPointer<TriggerDetector> SPtr;            /**< Shared pointer type for TriggerDetector. */
+    typedef QSharedPointer<const TriggerDetector> ConstSPtr; /**< Const shared pointer type for TriggerDetector. */
+
+    //=========================================================================================================
+    /**
+    * Flank types which are reported.
+    */
+    enum FlankType {
+        Rising,     /**< Step up in analog mode, change to a non-zero code in digital mode. */
+        Falling,    /**< Step down in analog mode, change away from a non-zero code in digital mode. */
+        Both        /**< Rising and falling flanks. */
+    };
+
+    //=========================================================================================================
+    /**
+    * A detected flank.
+    */
+    struct Event {
+        qint64  iSample;    /**< Sample index counted from the last reset. */
+        qint32  iChannel;   /**< Row index of the stim channel in the data blocks. */
+        qint32  iValue;     /**< Rounded (and masked) value which starts (rising) or ends (falling) at the flank. */
+        bool    bRising;    /**< Whether this is a rising flank. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs a TriggerDetector without channels.
+    */
+    TriggerDetector();
+
+    //=========================================================================================================
+    /**
+    * Constructs a TriggerDetector for the given stim channels.
+    *
+    * @param[in] lChannels      Row indices of the stim channels.
+    * @param[in] dThreshold     Minimal step which is detected as flank in analog mode.
+    * @param[in] type           Flank type which is reported.
+    */
+    TriggerDetector(const QList<int>& lChannels, double dThreshold, FlankType type = Rising);
+
+    //=========================================================================================================
+    /**
+    * Sets the stim channels which are scanned and resets the detector.
+    *
+    * @param[in] lChannels      Row indices of the stim channels.
+    */
+    void setChannels(const QList<int>& lChannels);
+
+    //=========================================================================================================
+    /**
+    * Returns the row indices of the scanned stim channels.
+    *
+    * @return the row indices of the scanned stim channels.
+    */
+    inline const QVector<qint32>& channels() const;
+
+    //=========================================================================================================
+    /**
+    * Sets the minimal step which is detected as flank in analog mode.
+    *
+    * @param[in] dThreshold     The threshold.
+    */
+    void setThreshold(double dThreshold);
+
+    //=========================================================================================================
+    /**
+    * Sets the flank type which is reported.
+    *
+    * @param[in] type   The flank type.
+    */
+    void setFlankType(FlankType type);
+
+    //=========================================================================================================
+    /**
+    * Sets the bit mask which is applied to the rounded stim values. A non-zero mask switches to digital mode,
+    * 0 switches back to analog mode.
+    *
+    * @param[in] iMask  The bit mask.
+    */
+    void setMask(qint32 iMask);
+
+    //=========================================================================================================
+    /**
+    * Sets the number of samples after an event during which further flanks of the same channel are ignored.
+    * The gap is carried across blocks.
+    *
+    * @param[in] iSamples   Minimum gap in samples, 0 reports every flank.
+    */
+    void setMinimumGap(qint32 iSamples);
+
+    //=========================================================================================================
+    /**
+    * Forgets the last samples and events of the previous blocks and restarts the sample count at 0.
+    */
+    void reset();
+
+    //=========================================================================================================
+    /**
+    * Scans the next block for flanks. The first block after a reset only primes the detector at its first
+    * sample, i.e. no flank is reported at sample 0. The returned events are sorted by sample and stay valid
+    * until the next call.
+    *
+    * @param[in] data   The next data block, rows are channels.
+    *
+    * @return the events of this block.
+    */
+    const QVector<Event>& detect(const Eigen::MatrixXd& data);
+
+    //=========================================================================================================
+    /**
+    * Returns the number of samples scanned since the last reset, i.e. the sample index of the next block.
+    *
+    * @return the number of scanned samples.
+    */
+    inline qint64 sampleCount() const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Appends the event to m_vecEvents unless it falls into the minimum gap of the previous event.
+    *
+    * @param[in] k          Index of the channel in m_vecChannels.
+    * @param[in] t          Column of the flank in the current block.
+    * @param[in] iValue     Value of the event.
+    * @param[in] bRising    Whether this is a rising flank.
+    */
+    void appendEvent(qint32 k, qint32 t, qint32 iValue, bool bRising);
+
+    //=========================================================================================================
+    /**
+    * Orders events by sample, used with a stable sort to keep the channel order of simultaneous events.
+    */
+    static bool lessThan(const Event& a, const Event& b);
+
+    QVector<qint32>     m_vecChannels;      /**< Row indices of the stim channels. */
+    double              m_dThreshold;       /**< Minimal step which is detected as flank in analog mode. */
+    FlankType           m_flankType;        /**< Flank type which is reported. */
+    qint32              m_iMask;            /**< Bit mask of digital mode, 0 for analog mode. */
+    qint32              m_iMinimumGap;      /**< Samples after an event during which flanks of the same channel are ignored. */
+
+    bool                m_bPrimed;          /**< Whether m_vecLast holds the last samples of a previous block. */
+    qint64              m_iSampleCount;     /**< Samples scanned since the last reset. */
+    Eigen::VectorXd     m_vecLast;          /**< Last sample of each channel of the previous block. */
+    QVector<qint64>     m_vecLastEvent;     /**< Sample of the last event of each channel. */
+
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> m_matData;  /**< Last sample and current block of all channels, one contiguous row per channel. */
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> m_matDiff;  /**< Sample to sample steps of all channels. */
+    QVector<Event>      m_vecEvents;        /**< Events of the current block. */
+};
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline const QVector<qint32>& TriggerDetector::channels() const
+{
+    return m_vecChannels;
+}
+
+
+//*************************************************************************************************************
+
+inline qint64 TriggerDetector::sampleCount() const
+{
+    return m_iSampleCount;
+}
+
+} // NAMESPACE
+
+#endif // TRIGGERDETECTOR_H
@@ -83,10 +83,12 @@ SOURCES += \
     selectionio.cpp \
     minimizersimplex.cpp \
     filterTools/cosinefilter.cpp \
+    filterTools/iirfilter.cpp \
     filterTools/parksmcclellan.cpp \
     filterTools/filterdata.cpp \
     filterTools/filterio.cpp \
     detecttrigger.cpp \
+    triggerdetector.cpp \
     spectrogram.cpp \
     warp.cpp \
     filterTools/sphara.cpp \
@@ -106,10 +108,12 @@ HEADERS += \
     layoutmaker.h \
     minimizersimplex.h \
     filterTools/cosinefilter.h \
+    filterTools/iirfilter.h \
     filterTools/parksmcclellan.h \
     filterTools/filterdata.h \
     filterTools/filterio.h \
     detecttrigger.h \
+    triggerdetector.h \
     spectrogram.h \
     warp.h \
     filterTools/sphara.h \
@@ -533,7 +533,7 @@ void FiffSimulator::run()
 //        ++count;
 //        printf("%d raw buffer (%d x %d) generated\r\n", count, t_pRawBuffer->rows(), t_pRawBuffer->cols());
 
-        emit remitRawBuffer(t_pRawBuffer);
+        emit remitRawBuffer(t_pRawBuffer, FiffRtBufferInfo::currentTime());
         usleep(uiSamplePeriod);
     }
 }
@@ -42,6 +42,7 @@
 //=============================================================================================================
 
 #include <fiff/fiff_info.h>
+#include <fiff/fiff_rt_buffer_info.h>
 #include <rtCommand/commandmanager.h>
 
 
@@ -217,7 +218,14 @@ public:
 signals:
     void remitMeasInfo(qint32, FIFFLIB::FiffInfo);
 
-    void remitRawBuffer(QSharedPointer<Eigen::MatrixXf>);
+    //=========================================================================================================
+    /**
+    * Is emitted when a raw buffer was acquired.
+    *
+    * @param [in] p_pMatRawData     The raw buffer.
+    * @param [in] p_iAcqTime        The acquisition time in microseconds since epoch (FiffRtBufferInfo::currentTime()).
+    */
+    void remitRawBuffer(QSharedPointer<Eigen::MatrixXf> p_pMatRawData, qint64 p_iAcqTime);
 
 protected:
 
@@ -49,6 +49,15 @@
 #include "connectormanager.h"
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QJsonDocument>
+#include <QJsonArray>
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // STL INCLUDES
@@ -75,6 +84,7 @@ CommandServer::CommandServer(QObject *parent)
 : QTcpServer(parent)
 , m_iThreadCount(0)
 , m_iCurrentCommandThreadID(0)
+, m_bCollectReplies(false)
 {
     QObject::connect(&m_commandParser, &CommandParser::response, this, &CommandServer::prepareReply);
 }
@@ -96,15 +106,35 @@ void CommandServer::incommingCommand(QString p_sCommand, qint32 p_iThreadID)
 
     m_iCurrentCommandThreadID = p_iThreadID;
 
-    if(!m_commandParser.parse(p_sCommand, t_qListParsedCommands))
+    //Pipelined request
+    if(p_sCommand.startsWith('{'))
+    {
+        QJsonDocument t_jsonDocument(QJsonDocument::fromJson(p_sCommand.toUtf8()));
+        if(t_jsonDocument.isObject() && t_jsonDocument.object().value(QString("commands")).isArray())
+        {
+            processPipelinedRequest(t_jsonDocument.object(), p_iThreadID);
+            return;
+        }
+    }
+
+    //Collect the replies of all command handlers and send them as one block
+    m_qListCollectedReplies.clear();
+    m_bCollectReplies = true;
+    bool t_bParsed = m_commandParser.parse(p_sCommand, t_qListParsedCommands);
+    m_bCollectReplies = false;
+
+    if(!t_bParsed)
     {
         QByteArray t_blockReply;
         t_blockReply.append("command unknown\r\n");
         printf("%s", t_blockReply.data());
 
-        //send reply
-        emit replyCommand(t_blockReply, p_iThreadID);
+        m_qListCollectedReplies.append(t_blockReply);
     }
+
+    //send reply
+    if(!m_qListCollectedReplies.isEmpty())
+        emit replyCommand(m_qListCollectedReplies.join(""), p_iThreadID);
 }
 
 
@@ -160,7 +190,52 @@ void CommandServer::prepareReply(QString p_sReply, Command p_command)
     //print
 //    printf("%s",p_sReply.toLatin1().constData());
 
-    emit replyCommand(p_sReply, t_iThreadID);
+    if(m_bCollectReplies)
+        m_qListCollectedReplies.append(p_sReply);
+    else
+        emit replyCommand(p_sReply, t_iThreadID);
 
     Q_UNUSED(p_command);
 }
+
+
+//*************************************************************************************************************
+
+void CommandServer::processPipelinedRequest(const QJsonObject &p_jsonObjectRequest, qint32 p_iThreadID)
+{
+    QJsonArray t_jsonArrayCommands = p_jsonObjectRequest.value(QString("commands")).toArray();
+    QJsonArray t_jsonArrayReplies;
+
+    for(qint32 i = 0; i < t_jsonArrayCommands.size(); ++i)
+    {
+        QJsonObject t_jsonObjectCommand = t_jsonArrayCommands[i].toObject();
+        QString t_sCommandName = t_jsonObjectCommand.keys().isEmpty() ? QString("") : t_jsonObjectCommand.keys().first();
+
+        //Each array element is parsed as a single JSON command
+        QJsonObject t_jsonObjectSingle;
+        t_jsonObjectSingle.insert("commands", QJsonValue(t_jsonObjectCommand));
+
+        QStringList t_qListParsedCommands;
+        m_qListCollectedReplies.clear();
+        m_bCollectReplies = true;
+        bool t_bParsed = m_commandParser.parse(QString(QJsonDocument(t_jsonObjectSingle).toJson(QJsonDocument::Compact)), t_qListParsedCommands)
+                && !t_qListParsedCommands.isEmpty();
+        m_bCollectReplies = false;
+
+        if(!t_bParsed)
+            printf("command unknown\r\n");
+
+        QJsonObject t_jsonObjectReply;
+        t_jsonObjectReply.insert("command", QJsonValue(t_sCommandName));
+        t_jsonObjectReply.insert("success", QJsonValue(t_bParsed));
+        t_jsonObjectReply.insert("reply", QJsonValue(t_bParsed ? m_qListCollectedReplies.join("") : QString("command unknown\r\n")));
+        t_jsonArrayReplies.append(t_jsonObjectReply);
+    }
+    m_qListCollectedReplies.clear();
+
+    QJsonObject t_jsonObjectRoot;
+    t_jsonObjectRoot.insert("id", p_jsonObjectRequest.value(QString("id")));
+    t_jsonObjectRoot.insert("replies", QJsonValue(t_jsonArrayReplies));
+
+    emit replyCommand(QString(QJsonDocument(t_jsonObjectRoot).toJson(QJsonDocument::Compact)), p_iThreadID);
+}
@@ -52,6 +52,7 @@
 
 #include <QStringList>
 #include <QTcpServer>
+#include <QJsonObject>
 
 
 //*************************************************************************************************************
@@ -110,7 +111,9 @@ public:
 
     //=========================================================================================================
     /**
-    * Slot which is called when a new command is available.
+    * Slot which is called when a new command is available. Besides CLI and JSON commands a pipelined request
+    * {"id": <request id>, "commands": [{<command>}, ...]} is accepted: its commands are executed in order and all
+    * replies are sent back at once as {"id": <request id>, "replies": [{"command", "success", "reply"}, ...]}.
     *
     * @param[in] p_sCommand     Raw command
     * @param[in] p_iThreadID    ID of the thread which received the command.
@@ -158,12 +161,24 @@ protected:
     void incomingConnection(qintptr socketDescriptor);
 
 private:
+    //=========================================================================================================
+    /**
+    * Executes the commands of a pipelined request in order and sends one reply containing all command replies.
+    *
+    * @param[in] p_jsonObjectRequest    The request object holding the request id and the command array.
+    * @param[in] p_iThreadID            ID of the thread which received the request.
+    */
+    void processPipelinedRequest(const QJsonObject &p_jsonObjectRequest, qint32 p_iThreadID);
+
     qint32 m_iThreadCount;              /**< Is incresed each time a new command client connects to mne_rt_server. */
 
     CommandParser m_commandParser;      /**< Command parser. */
 
 //    QMultiMap<QString, qint32> m_qMultiMapCommandThreadID;//This is need when commands are processed by different threads; currently its only one command per time processed by one thread --> m_iCurrentCommandThreadID
     qint32 m_iCurrentCommandThreadID;   /**< Command Thread ID of the current command. */
+
+    bool m_bCollectReplies;             /**< Whether replies are collected until the current command is processed. */
+    QStringList m_qListCollectedReplies;/**< Replies of the command which is currently processed. */
 };
 
 
@@ -91,8 +91,9 @@ void CommandThread::attachCommandReply(QString p_blockReply, qint32 p_iID)
     qDebug() << "CommandThread::attachCommandReply";
     if(p_iID == m_iThreadID)
     {
+        //Queue the reply - a pipelining client may have several requests in flight
         m_qMutex.lock();
-        m_qSendData = p_blockReply;
+        m_qListSendData.append(p_blockReply);
         m_qMutex.unlock();
     }
 }
@@ -130,28 +131,32 @@ void CommandThread::run()
         //
         // Write available data
         //
-        if(m_qSendData.size() > 0)
+        m_qMutex.lock();
+        QStringList t_qListSendData = m_qListSendData;
+        m_qListSendData.clear();
+        m_qMutex.unlock();
+
+        for(qint32 i = 0; i < t_qListSendData.size(); ++i)
         {
             QByteArray block;
             QDataStream out(&block, QIODevice::WriteOnly);
             out.setVersion(QDataStream::Qt_5_1);
             out << (quint16)0;
-            m_qMutex.lock();
-            out << m_qSendData;
-            m_qSendData.clear();
-            m_qMutex.unlock();
+            out << t_qListSendData[i];
             out.device()->seek(0);
             out << (quint16)(block.size() - sizeof(quint16));
 
             t_qTcpSocket.write(block);
-            t_qTcpSocket.waitForBytesWritten();
         }
+        if(!t_qListSendData.isEmpty())
+            t_qTcpSocket.waitForBytesWritten();
 
         //
         // Read: Wait 100ms for incomming tag header, read and continue
         //
 
-        t_qTcpSocket.waitForReadyRead(100);
+        if(t_qTcpSocket.bytesAvailable() < (int)sizeof(quint16))
+            t_qTcpSocket.waitForReadyRead(100);
 
         if (t_qTcpSocket.bytesAvailable() >= (int)sizeof(quint16))
         {
@@ -178,6 +183,10 @@ void CommandThread::run()
 
                     respComplete = true;
                 }
+                else if(!t_qTcpSocket.waitForReadyRead(100) && t_qTcpSocket.state() != QAbstractSocket::ConnectedState)
+                {
+                    break;
+                }
             }
         }
 
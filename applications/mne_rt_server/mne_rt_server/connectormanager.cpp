@@ -86,8 +86,17 @@ using namespace RTSERVER;
 ConnectorManager::ConnectorManager(FiffStreamServer* p_pFiffStreamServer, QObject *parent)
 : QPluginLoader(parent)
 , m_pFiffStreamServer(p_pFiffStreamServer)
+, m_streamMerger(this)
+, m_bMergerActive(false)
 {
-
+    //Measurement info requests are routed to the stream the client is subscribed to
+    QObject::connect(   m_pFiffStreamServer, &FiffStreamServer::requestMeasInfo,
+                        this, &ConnectorManager::forwardMeasInfoRequest);
+
+    QObject::connect(   &m_streamMerger, &StreamMerger::mergedRawBuffer,
+                        m_pFiffStreamServer, [=](QSharedPointer<Eigen::MatrixXf> p_pMatRawData, qint64 p_iAcqTime) {
+                            m_pFiffStreamServer->forwardRawBuffer(FiffStreamServer::s_iMergedStream, p_pMatRawData, p_iAcqTime);
+                        });
 }
 
 
@@ -161,8 +170,30 @@ void ConnectorManager::comSelcon(Command p_command)
 
 void ConnectorManager::comStart(Command p_command)//comMeas
 {
-    getActiveConnector()->start();
-    qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["start"].reply("Starting active connector.\n");
+    //Several clients may request a start - only the first one initializes and starts the connectors
+    QString t_sOutput;
+    bool t_bStarted = false;
+
+    QList<IConnector*> t_qListConnectors = getAcquisitionConnectors();
+    for(qint32 i = 0; i < t_qListConnectors.size(); ++i)
+    {
+        if(t_qListConnectors[i]->isRunning())
+        {
+            t_sOutput.append(QString("%1 is already running.\n").arg(t_qListConnectors[i]->getName()));
+        }
+        else
+        {
+            t_qListConnectors[i]->start();
+            t_sOutput.append(QString("Starting %1.\n").arg(t_qListConnectors[i]->getName()));
+            t_bStarted = true;
+        }
+    }
+
+    //Started connectors begin a new time base
+    if(t_bStarted)
+        updateMerger();
+
+    qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["start"].reply(t_sOutput);
 
     Q_UNUSED(p_command);
 }
@@ -172,13 +203,157 @@ void ConnectorManager::comStart(Command p_command)//comMeas
 
 void ConnectorManager::comStopAll(Command p_command)
 {
-    getActiveConnector()->stop();
+    QList<IConnector*> t_qListConnectors = getAcquisitionConnectors();
+    for(qint32 i = 0; i < t_qListConnectors.size(); ++i)
+        t_qListConnectors[i]->stop();
+
     qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["stop-all"].reply("Stoping all connectors.\r\n");
 
     Q_UNUSED(p_command);
 }
 
 
+//*************************************************************************************************************
+
+void ConnectorManager::comAddcon(Command p_command)
+{
+    bool t_bIsInt;
+    QString t_sOutput;
+
+    qint32 t_id = p_command.pValues()[0].toInt(&t_bIsInt);
+    IConnector* t_pConnector = t_bIsInt ? getConnector(t_id) : NULL;
+
+    if(!t_pConnector)
+    {
+        t_sOutput = QString("\tID %1 doesn't match a connector ID.\r\n\n").arg(p_command.pValues()[0].toString());
+    }
+    else if(getAcquisitionConnectors().contains(t_pConnector))
+    {
+        t_sOutput = QString("\t%1 is already acquiring.\r\n\n").arg(t_pConnector->getName());
+    }
+    else
+    {
+        //Join a running acquisition right away
+        bool t_bIsAcquiring = false;
+        QList<IConnector*> t_qListConnectors = getAcquisitionConnectors();
+        for(qint32 i = 0; i < t_qListConnectors.size(); ++i)
+            t_bIsAcquiring |= t_qListConnectors[i]->isRunning();
+
+        m_qListConcurrentConnectors.append(t_pConnector);
+        connectConnector(t_pConnector);
+
+        if(t_bIsAcquiring && !t_pConnector->isRunning())
+            t_pConnector->start();
+
+        updateMerger();
+
+        t_sOutput = QString("\t%1 acquires concurrently (stream %2).\r\n\n").arg(t_pConnector->getName()).arg(t_id);
+    }
+
+    t_sOutput.append(getConnectorList(p_command.isJson()));
+    qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["addcon"].reply(t_sOutput);
+}
+
+
+//*************************************************************************************************************
+
+void ConnectorManager::comRemcon(Command p_command)
+{
+    bool t_bIsInt;
+    QString t_sOutput;
+
+    qint32 t_id = p_command.pValues()[0].toInt(&t_bIsInt);
+    IConnector* t_pConnector = t_bIsInt ? getConnector(t_id) : NULL;
+
+    if(!t_pConnector || !m_qListConcurrentConnectors.contains(t_pConnector))
+    {
+        t_sOutput = QString("\tID %1 doesn't match a concurrently acquiring connector.\r\n\n").arg(p_command.pValues()[0].toString());
+    }
+    else
+    {
+        m_qListConcurrentConnectors.removeAll(t_pConnector);
+
+        //The selected connector keeps on acquiring
+        if(t_pConnector != getActiveConnector())
+        {
+            t_pConnector->stop();
+            disconnectConnector(t_pConnector);
+        }
+
+        updateMerger();
+
+        t_sOutput = QString("\t%1 removed from the concurrent acquisition.\r\n\n").arg(t_pConnector->getName());
+    }
+
+    t_sOutput.append(getConnectorList(p_command.isJson()));
+    qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["remcon"].reply(t_sOutput);
+}
+
+
+//*************************************************************************************************************
+
+void ConnectorManager::forwardRawBuffer(qint32 p_iConnectorId, QSharedPointer<Eigen::MatrixXf> p_pMatRawData, qint64 p_iAcqTime)
+{
+    m_pFiffStreamServer->forwardRawBuffer(p_iConnectorId, p_pMatRawData, p_iAcqTime);
+
+    //Merging costs are only spent while the merged stream is subscribed
+    bool t_bMerge = m_pFiffStreamServer->hasSubscribers(FiffStreamServer::s_iMergedStream);
+
+    if(t_bMerge && !m_bMergerActive)
+        updateMerger();
+    m_bMergerActive = t_bMerge;
+
+    if(t_bMerge)
+        m_streamMerger.appendRawBuffer(p_iConnectorId, p_pMatRawData, p_iAcqTime);
+}
+
+
+//*************************************************************************************************************
+
+void ConnectorManager::forwardMeasInfoRequest(qint32 ID)
+{
+    qint32 t_iStreamId = m_pFiffStreamServer->getStreamId(ID);
+
+    if(t_iStreamId == FiffStreamServer::s_iMergedStream)
+    {
+        if(!m_streamMerger.hasInfo())
+            updateMerger();
+
+        if(m_streamMerger.hasInfo())
+            m_pFiffStreamServer->forwardMeasInfo(ID, m_streamMerger.info());
+        else
+            printf("Error: Merged measurement info is not available!\n");
+    }
+    else
+    {
+        IConnector* t_pConnector = getConnector(t_iStreamId);
+
+        if(t_pConnector)
+            t_pConnector->info(ID);
+        else
+            printf("Error: No connector for stream %d!\n", t_iStreamId);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void ConnectorManager::updateMerger()
+{
+    QList<IConnector*> t_qListConnectors = getAcquisitionConnectors();
+
+    QList<qint32> t_qListSourceIds;
+    for(qint32 i = 0; i < t_qListConnectors.size(); ++i)
+        t_qListSourceIds.append(t_qListConnectors[i]->getConnectorID());
+
+    m_streamMerger.setSources(t_qListSourceIds);
+
+    //The infos are delivered with the merger id and routed to the merger on connection
+    for(qint32 i = 0; i < t_qListConnectors.size(); ++i)
+        t_qListConnectors[i]->info(StreamMerger::s_iMergerId);
+}
+
+
 //*************************************************************************************************************
 
 void ConnectorManager::connectActiveConnector()
@@ -187,37 +362,12 @@ void ConnectorManager::connectActiveConnector()
 
     if(t_activeConnector)
     {
-        // use signal slots instead of call backs
-        //Consulting the Signal/Slot documentation describes why the Signal/Slot approach is better:
-        //    Callbacks have two fundamental flaws: Firstly, they are not type-safe. We can never be certain
-        //    that the processing function will call the callback with the correct arguments.
-        //    Secondly, the callback is strongly coupled to the processing function since the processing
-        //    function must know which callback to call.
-        //Do be aware of the following though:
-        //    Compared to callbacks, signals and slots are slightly slower because of the increased
-        //    flexibility they provide
-        //The speed probably doesn't matter for most cases, but there may be some extreme cases of repeated
-        //calling that makes a difference.
-
-        //
-        // Meas Info
-        //
-        // connect command server and connector manager
-        QObject::connect(   this->m_pFiffStreamServer, &FiffStreamServer::requestMeasInfo,
-                            t_activeConnector, &IConnector::info);
-
-        // connect connector manager and fiff stream server
-        QObject::connect(   t_activeConnector, &IConnector::remitMeasInfo,
-                            this->m_pFiffStreamServer, &FiffStreamServer::forwardMeasInfo);
-
-        //
-        // Raw Data
-        //
-        // connect command server and connector manager
-
-        // connect connector manager and fiff stream server
-        QObject::connect(   t_activeConnector, &IConnector::remitRawBuffer,
-                            this->m_pFiffStreamServer, &FiffStreamServer::forwardRawBuffer);
+        connectConnector(t_activeConnector);
+
+        //Clients which did not subscribe to a specific stream follow the selected connector
+        m_pFiffStreamServer->setSelectedStreamId(t_activeConnector->getConnectorID());
+
+        updateMerger();
     }
     else
     {
@@ -233,46 +383,86 @@ void ConnectorManager::disconnectActiveConnector()
     IConnector* t_activeConnector = ConnectorManager::getActiveConnector();
 
     if(t_activeConnector)
-    {
-        // use signal slots instead of call backs
-        //Consulting the Signal/Slot documentation describes why the Signal/Slot approach is better:
-        //    Callbacks have two fundamental flaws: Firstly, they are not type-safe. We can never be certain
-        //    that the processing function will call the callback with the correct arguments.
-        //    Secondly, the callback is strongly coupled to the processing function since the processing
-        //    function must know which callback to call.
-        //Do be aware of the following though:
-        //    Compared to callbacks, signals and slots are slightly slower because of the increased
-        //    flexibility they provide
-        //The speed probably doesn't matter for most cases, but there may be some extreme cases of repeated
-        //calling that makes a difference.
-
-        //
-        // Meas Info
-        //
-        this->disconnect(t_activeConnector);
-        //
-        t_activeConnector->disconnect(this->m_pFiffStreamServer);
-
-        this->m_pFiffStreamServer->disconnect(t_activeConnector);
-
-        //
-        // Raw Data
-        //
-//        t_pMNERTServer->m_pCommandServer->disconnect(t_activeConnector);
-        //
-//        t_activeConnector->disconnect(t_pMNERTServer->m_pFiffStreamServer);
-        // connect command server and connector manager
-//        t_pMNERTServer->m_pCommandServer->disconnect(t_activeConnector);
-
-        //
-        // Reset Raw Buffer
-        //
-//        t_pMNERTServer->m_pCommandServer->disconnect(t_activeConnector);
-    }
+        disconnectConnector(t_activeConnector);
     else
-    {
         printf("Error: Can't connect, no connector active!\n");
-    }
+}
+
+
+//*************************************************************************************************************
+
+void ConnectorManager::connectConnector(IConnector* p_pConnector)
+{
+    if(!p_pConnector || m_qMapConnections.contains(p_pConnector))
+        return;
+
+    qint32 t_iConnectorId = p_pConnector->getConnectorID();
+
+    QList<QMetaObject::Connection> t_qListConnections;
+
+    //
+    // Meas Info - infos requested by the merger stay with the merger
+    //
+    t_qListConnections << QObject::connect(p_pConnector, &IConnector::remitMeasInfo,
+                                           m_pFiffStreamServer, [=](qint32 ID, FIFFLIB::FiffInfo p_fiffInfo) {
+                                               if(ID == StreamMerger::s_iMergerId)
+                                                   m_streamMerger.setSourceInfo(t_iConnectorId, p_fiffInfo);
+                                               else
+                                                   m_pFiffStreamServer->forwardMeasInfo(ID, p_fiffInfo);
+                                           });
+
+    //
+    // Raw Data - the buffers are tagged with the connector id as stream id. The fiff stream server is the
+    // context, i.e., the buffers are queued from the producer threads to the server thread.
+    //
+    t_qListConnections << QObject::connect(p_pConnector, &IConnector::remitRawBuffer,
+                                           m_pFiffStreamServer, [=](QSharedPointer<Eigen::MatrixXf> p_pMatRawData, qint64 p_iAcqTime) {
+                                               forwardRawBuffer(t_iConnectorId, p_pMatRawData, p_iAcqTime);
+                                           });
+
+    m_qMapConnections.insert(p_pConnector, t_qListConnections);
+}
+
+
+//*************************************************************************************************************
+
+void ConnectorManager::disconnectConnector(IConnector* p_pConnector)
+{
+    QList<QMetaObject::Connection> t_qListConnections = m_qMapConnections.take(p_pConnector);
+
+    for(qint32 i = 0; i < t_qListConnections.size(); ++i)
+        QObject::disconnect(t_qListConnections[i]);
+}
+
+
+//*************************************************************************************************************
+
+QList<IConnector*> ConnectorManager::getAcquisitionConnectors()
+{
+    QList<IConnector*> t_qListConnectors;
+
+    IConnector* t_pActiveConnector = getActiveConnector();
+    if(t_pActiveConnector)
+        t_qListConnectors.append(t_pActiveConnector);
+
+    for(qint32 i = 0; i < m_qListConcurrentConnectors.size(); ++i)
+        if(!t_qListConnectors.contains(m_qListConcurrentConnectors[i]))
+            t_qListConnectors.append(m_qListConcurrentConnectors[i]);
+
+    return t_qListConnectors;
+}
+
+
+//*************************************************************************************************************
+
+IConnector* ConnectorManager::getConnector(qint32 ID)
+{
+    QVector<IConnector*>::const_iterator it = s_vecConnectors.begin();
+    for( ; it != s_vecConnectors.end(); ++it)
+        if((*it)->getConnectorID() == ID)
+            return *it;
+
+    return NULL;
 }
 
 
@@ -312,6 +502,10 @@ QByteArray ConnectorManager::getConnectorList(bool p_bFlagJSON) const
             //insert isActive
             t_qJsonObjectConnector.insert(QString("active"), QJsonValue((*it)->isActive()));
 
+            //insert concurrent acquisition and running state
+            t_qJsonObjectConnector.insert(QString("concurrent"), QJsonValue(m_qListConcurrentConnectors.contains(*it)));
+            t_qJsonObjectConnector.insert(QString("running"), QJsonValue((*it)->isRunning()));
+
             //insert Connector JsonObject
             t_qJsonObjectConnectors.insert((*it)->getName(),t_qJsonObjectConnector);//QJsonObject());//QJsonValue());
 
@@ -332,6 +526,8 @@ QByteArray ConnectorManager::getConnectorList(bool p_bFlagJSON) const
             {
                 if((*it)->isActive())
                     t_blockConnectorList.append(QString("  *  (%1) %2\r\n").arg((*it)->getConnectorID()).arg((*it)->getName()));
+                else if(m_qListConcurrentConnectors.contains(*it))
+                    t_blockConnectorList.append(QString("  +  (%1) %2\r\n").arg((*it)->getConnectorID()).arg((*it)->getName()));
                 else
                     t_blockConnectorList.append(QString("     (%1) %2\r\n").arg((*it)->getConnectorID()).arg((*it)->getName()));
             }
@@ -354,6 +550,8 @@ void ConnectorManager::connectCommands()
     QObject::connect(&t_pMNERTServer->getCommandManager()["selcon"], &Command::executed, this, &ConnectorManager::comSelcon);
     QObject::connect(&t_pMNERTServer->getCommandManager()["start"], &Command::executed, this, &ConnectorManager::comStart);
     QObject::connect(&t_pMNERTServer->getCommandManager()["stop-all"], &Command::executed, this, &ConnectorManager::comStopAll);
+    QObject::connect(&t_pMNERTServer->getCommandManager()["addcon"], &Command::executed, this, &ConnectorManager::comAddcon);
+    QObject::connect(&t_pMNERTServer->getCommandManager()["remcon"], &Command::executed, this, &ConnectorManager::comRemcon);
 }
 
 
@@ -475,9 +673,12 @@ QByteArray ConnectorManager::setActiveConnector(qint32 ID)
 
            IConnector* t_pActiveConnector = getActiveConnector();
 
-           //Stop and disconnect active connector
-           t_pActiveConnector->stop();
-           this->disconnectActiveConnector();
+           //Stop and disconnect active connector, unless it acquires concurrently
+           if(!m_qListConcurrentConnectors.contains(t_pActiveConnector))
+           {
+               t_pActiveConnector->stop();
+               this->disconnectActiveConnector();
+           }
            t_pActiveConnector->setStatus(false);
 
            //set new active connector
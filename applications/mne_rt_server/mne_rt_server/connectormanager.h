@@ -43,6 +43,7 @@
 //=============================================================================================================
 
 #include "IConnector.h"
+#include "streammerger.h"
 
 
 //*************************************************************************************************************
@@ -59,6 +60,8 @@
 //=============================================================================================================
 
 #include <QVector>
+#include <QList>
+#include <QMap>
 #include <QPluginLoader>
 
 
@@ -139,6 +142,41 @@ public:
 
     void disconnectActiveConnector();
 
+    //=========================================================================================================
+    /**
+    * Connects the measurement info and raw data of a connector to the fiff stream server. The raw buffers are
+    * forwarded as the stream of the connector id. Does nothing if the connector is already connected.
+    *
+    * @param[in] p_pConnector   The connector to connect.
+    */
+    void connectConnector(IConnector* p_pConnector);
+
+    //=========================================================================================================
+    /**
+    * Disconnects a connector from the fiff stream server.
+    *
+    * @param[in] p_pConnector   The connector to disconnect.
+    */
+    void disconnectConnector(IConnector* p_pConnector);
+
+    //=========================================================================================================
+    /**
+    * Returns the connectors which take part in the acquisition: the selected connector followed by the
+    * connectors which were added to run concurrently.
+    *
+    * @return the acquiring connectors.
+    */
+    QList<IConnector*> getAcquisitionConnectors();
+
+    //=========================================================================================================
+    /**
+    * Forwards a measurement info request to the connector of the stream the data client is subscribed to, or
+    * answers it with the merged measurement info.
+    *
+    * @param[in] ID     The id of the data client which requested the info.
+    */
+    void forwardMeasInfoRequest(qint32 ID);
+
     //=========================================================================================================
     /**
     * Returns vector containing active ISensor plugins.
@@ -210,12 +248,58 @@ private:
     */
     void comStopAll(Command p_command);
 
+    //=========================================================================================================
+    /**
+    * Adds a connector which acquires concurrently to the selected connector
+    *
+    * @param[in] p_command  The add connector command.
+    */
+    void comAddcon(Command p_command);
+
+    //=========================================================================================================
+    /**
+    * Removes a concurrently acquiring connector
+    *
+    * @param[in] p_command  The remove connector command.
+    */
+    void comRemcon(Command p_command);
+
+    //=========================================================================================================
+    /**
+    * Forwards a raw buffer of a connector as its stream and feeds the stream merger if the merged stream is
+    * subscribed.
+    *
+    * @param[in] p_iConnectorId     The id of the connector which acquired the buffer.
+    * @param[in] p_pMatRawData      The raw buffer.
+    * @param[in] p_iAcqTime         The acquisition time in microseconds since epoch.
+    */
+    void forwardRawBuffer(qint32 p_iConnectorId, QSharedPointer<Eigen::MatrixXf> p_pMatRawData, qint64 p_iAcqTime);
 
+    //=========================================================================================================
+    /**
+    * Resets the stream merger to the acquiring connectors and requests their measurement infos.
+    */
+    void updateMerger();
 
+    //=========================================================================================================
+    /**
+    * Returns the loaded connector with the given id.
+    *
+    * @param[in] ID     The connector id.
+    *
+    * @return the connector, NULL if no connector with this id is loaded.
+    */
+    IConnector* getConnector(qint32 ID);
 
     static QVector<IConnector*> s_vecConnectors;       /**< Holds vector of all plugins. */
 
     FiffStreamServer* m_pFiffStreamServer;
+
+    QList<IConnector*>  m_qListConcurrentConnectors;    /**< Connectors which keep acquiring next to the selected connector. */
+    QMap<IConnector*, QList<QMetaObject::Connection> > m_qMapConnections;  /**< Connections of each connected connector. */
+
+    StreamMerger        m_streamMerger;                 /**< Merges the streams of the acquiring connectors. */
+    bool                m_bMergerActive;                /**< Whether the merged stream was subscribed when the last buffer arrived. */
 };
 
 
@@ -0,0 +1,478 @@
+//=============================================================================================================
+/**
+* @file     fiffrecorder.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    definition of the FiffRecorder Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiffrecorder.h"
+#include "fiffstreamserver.h"
+#include "mne_rt_server.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <vector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTSERVER;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffRecorder::FiffRecorder(FiffStreamServer* p_pFiffStreamServer, QObject* parent)
+: QThread(parent)
+, m_pFiffStreamServer(p_pFiffStreamServer)
+, m_bIsPending(false)
+, m_iMaxQueueSize(REC_MAX_QUEUE_SIZE)
+, m_bIsRecording(false)
+, m_bIsRunning(false)
+, m_iMaxQueueDepth(0)
+, m_iBuffersWritten(0)
+, m_iSamplesWritten(0)
+, m_iBytesWritten(0)
+, m_iBuffersDropped(0)
+, m_iStreamId(FiffStreamServer::s_iSelectedStream)
+, m_dWriteRate(0.0)
+{
+    // measurement info is requested with the reserved recorder id, it may arrive from a connector thread
+    QObject::connect(m_pFiffStreamServer, &FiffStreamServer::remitMeasInfo,
+                     this, &FiffRecorder::setMeasInfo);
+}
+
+
+//*************************************************************************************************************
+
+FiffRecorder::~FiffRecorder()
+{
+    stopRecording();
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::comRecStart(Command p_command)
+{
+    QString t_sFileName = p_command.pValues()[0].toString();
+    QString t_sOutput;
+
+    if(isRecording())
+        t_sOutput = QString("\tAlready recording to %1.\r\n\n").arg(m_qFile.fileName());
+    else if(isPending())
+        t_sOutput = QString("\tRecording to %1 is already pending.\r\n\n").arg(m_sPendingFileName);
+    else if(startRecording(t_sFileName))
+    {
+        if(isRecording())
+            t_sOutput = QString("\tStarted recording to %1.\r\n\n").arg(m_qFile.fileName());
+        else
+            t_sOutput = QString("\tRecording to %1 starts as soon as the measurement info arrives.\r\n\n").arg(m_sPendingFileName);
+    }
+    else
+        t_sOutput = QString("\tRecording to %1 could not be started.\r\n\n").arg(t_sFileName);
+
+    qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["rec-start"].reply(t_sOutput);
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::comRecStop(Command p_command)
+{
+    QString t_sOutput;
+
+    if(isRecording())
+    {
+        stopRecording();
+        t_sOutput = QString("\tStopped recording to %1 (%2 buffers written, %3 dropped).\r\n\n").arg(m_qFile.fileName()).arg(m_iBuffersWritten).arg(m_iBuffersDropped);
+    }
+    else if(isPending())
+    {
+        stopRecording();
+        t_sOutput = QString("\tCanceled the pending recording.\r\n\n");
+    }
+    else
+        t_sOutput = QString("\tNo recording running.\r\n\n");
+
+    qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["rec-stop"].reply(t_sOutput);
+
+    Q_UNUSED(p_command);
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::comRecStatus(Command p_command)
+{
+    qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["rec-status"].reply(this->getStatus(p_command.isJson()));
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::connectCommands()
+{
+    //Connect slots
+    MNERTServer* t_pMNERTServer = qobject_cast<MNERTServer*> (this->parent());
+
+    QObject::connect(&t_pMNERTServer->getCommandManager()["rec-start"], &Command::executed, this, &FiffRecorder::comRecStart);
+    QObject::connect(&t_pMNERTServer->getCommandManager()["rec-stop"], &Command::executed, this, &FiffRecorder::comRecStop);
+    QObject::connect(&t_pMNERTServer->getCommandManager()["rec-status"], &Command::executed, this, &FiffRecorder::comRecStatus);
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::setRecordingDirectory(const QString& p_sDirectory)
+{
+    m_qRecordingDir.setPath(QDir::cleanPath(QDir(p_sDirectory).absolutePath()));
+
+    if(!m_qRecordingDir.exists() && !m_qRecordingDir.mkpath("."))
+        printf("Error: Not able to create the recording directory %s!\n", m_qRecordingDir.path().toUtf8().constData());
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRecorder::startRecording(const QString& p_sFileName)
+{
+    if(isRecording() || isPending() || p_sFileName.isEmpty())
+        return false;
+
+    //
+    // Files are only written into the recording directory
+    //
+    QString t_sFilePath = QDir::cleanPath(m_qRecordingDir.absoluteFilePath(p_sFileName));
+    if(!t_sFilePath.startsWith(m_qRecordingDir.path() + QLatin1Char('/')))
+    {
+        printf("Error: Can't start recording, %s is not inside the recording directory %s!\n", p_sFileName.toUtf8().constData(), m_qRecordingDir.path().toUtf8().constData());
+        return false;
+    }
+
+    //
+    // Request the measurement info of the selected connector, the recording starts when it arrives
+    //
+    m_qMutex.lock();
+    m_sPendingFileName = t_sFilePath;
+    m_bIsPending = true;
+    m_qMutex.unlock();
+
+    m_iStreamId = m_pFiffStreamServer->getStreamId(s_iRecorderId);
+    emit m_pFiffStreamServer->requestMeasInfo(s_iRecorderId);
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRecorder::beginRecording()
+{
+    //
+    // Write the header
+    //
+    m_qFile.setFileName(m_sPendingFileName);
+    RowVectorXd t_vecCals;
+    m_pOutStream = FiffStream::start_writing_raw(m_qFile, m_fiffInfo, t_vecCals);
+
+    if(!m_pOutStream)
+    {
+        printf("Error: Can't start recording, not able to write to %s!\n", m_sPendingFileName.toUtf8().constData());
+        return false;
+    }
+
+    //Inverse calibration is assembled once instead of per buffer
+    typedef Eigen::Triplet<double> T;
+    std::vector<T> tripletList;
+    tripletList.reserve(t_vecCals.cols());
+    for(qint32 i = 0; i < t_vecCals.cols(); ++i)
+        tripletList.push_back(T(i, i, 1.0/t_vecCals[i]));
+    m_matInvCals = SparseMatrix<double>(t_vecCals.cols(), t_vecCals.cols());
+    m_matInvCals.setFromTriplets(tripletList.begin(), tripletList.end());
+
+    //
+    // Reset the counters and start the writer
+    //
+    m_qMutex.lock();
+    m_qQueue.clear();
+    m_iMaxQueueDepth = 0;
+    m_iBuffersWritten = 0;
+    m_iSamplesWritten = 0;
+    m_iBytesWritten = 0;
+    m_iBuffersDropped = 0;
+    m_dWriteRate = 0.0;
+    m_bIsRunning = true;
+    m_bIsRecording = true;
+    m_qTimer.start();
+    m_qMutex.unlock();
+
+    QThread::start(QThread::LowPriority);
+
+    QObject::connect(m_pFiffStreamServer, &FiffStreamServer::remitRawBuffer,
+                     this, &FiffRecorder::enqueueRawBuffer, Qt::DirectConnection);
+
+    printf("Start recording to %s\n", m_sPendingFileName.toUtf8().constData());
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::stopRecording()
+{
+    m_qMutex.lock();
+    m_bIsPending = false;
+    m_qMutex.unlock();
+
+    QObject::disconnect(m_pFiffStreamServer, &FiffStreamServer::remitRawBuffer,
+                        this, &FiffRecorder::enqueueRawBuffer);
+
+    m_qMutex.lock();
+    m_bIsRecording = false;
+    m_bIsRunning = false;
+    m_qWaitCondition.wakeAll();
+    m_qMutex.unlock();
+
+    //Writer drains the queue before it returns
+    QThread::wait();
+}
+
+
+//*************************************************************************************************************
+
+QByteArray FiffRecorder::getStatus(bool p_bFlagJSON)
+{
+    QByteArray t_blockStatus;
+
+    QMutexLocker locker(&m_qMutex);
+
+    double t_dElapsed = m_qTimer.isValid() ? m_qTimer.elapsed()/1000.0 : 0.0;
+
+    if(p_bFlagJSON)
+    {
+        QJsonObject t_qJsonObjectStatus;
+        t_qJsonObjectStatus.insert(QString("recording"), QJsonValue(m_bIsRecording));
+        t_qJsonObjectStatus.insert(QString("file"), QJsonValue(m_qFile.fileName()));
+        t_qJsonObjectStatus.insert(QString("time"), QJsonValue(t_dElapsed));
+        t_qJsonObjectStatus.insert(QString("queue"), QJsonValue(m_qQueue.size()));
+        t_qJsonObjectStatus.insert(QString("maxqueue"), QJsonValue(m_iMaxQueueDepth));
+        t_qJsonObjectStatus.insert(QString("written"), QJsonValue((double)m_iBuffersWritten));
+        t_qJsonObjectStatus.insert(QString("samples"), QJsonValue((double)m_iSamplesWritten));
+        t_qJsonObjectStatus.insert(QString("bytes"), QJsonValue((double)m_iBytesWritten));
+        t_qJsonObjectStatus.insert(QString("dropped"), QJsonValue((double)m_iBuffersDropped));
+        t_qJsonObjectStatus.insert(QString("rate"), QJsonValue(m_dWriteRate));
+
+        QJsonObject t_qJsonObjectRoot;
+        t_qJsonObjectRoot.insert("recording", t_qJsonObjectStatus);
+        QJsonDocument p_qJsonDocument(t_qJsonObjectRoot);
+
+        t_blockStatus.append(p_qJsonDocument.toJson());
+    }
+    else
+    {
+        if(m_bIsRecording)
+            t_blockStatus.append(QString("\tRecording to %1 since %2 s\r\n").arg(m_qFile.fileName()).arg(t_dElapsed, 0, 'f', 1));
+        else
+            t_blockStatus.append(QString("\tNo recording running\r\n"));
+        t_blockStatus.append(QString("\tqueue depth:\t%1 (max %2 of %3)\r\n").arg(m_qQueue.size()).arg(m_iMaxQueueDepth).arg(m_iMaxQueueSize));
+        t_blockStatus.append(QString("\twritten:\t%1 buffers, %2 samples, %3 MB\r\n").arg(m_iBuffersWritten).arg(m_iSamplesWritten).arg(m_iBytesWritten/1048576.0, 0, 'f', 2));
+        t_blockStatus.append(QString("\tdropped:\t%1 buffers\r\n").arg(m_iBuffersDropped));
+        t_blockStatus.append(QString("\twrite rate:\t%1 MB/s\r\n\n").arg(m_dWriteRate/1048576.0, 0, 'f', 2));
+    }
+
+    return t_blockStatus;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::enqueueRawBuffer(QSharedPointer<Eigen::MatrixXf> p_pMatRawData, const FiffRtBufferInfo& p_bufferInfo, qint32 p_iStreamId)
+{
+    Q_UNUSED(p_bufferInfo);
+
+    if(p_iStreamId != m_iStreamId)
+        return;
+
+    QMutexLocker locker(&m_qMutex);
+
+    if(!m_bIsRecording)
+        return;
+
+    if(m_qQueue.size() >= m_iMaxQueueSize || p_pMatRawData->rows() != m_fiffInfo.nchan)
+    {
+        ++m_iBuffersDropped;
+        return;
+    }
+
+    //Only the handle is stored, the buffer is shared with the FiffStreamClients
+    m_qQueue.enqueue(p_pMatRawData);
+
+    if(m_qQueue.size() > m_iMaxQueueDepth)
+        m_iMaxQueueDepth = m_qQueue.size();
+
+    m_qWaitCondition.wakeOne();
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::setMeasInfo(qint32 ID, const FiffInfo& p_fiffInfo)
+{
+    if(ID != s_iRecorderId || !isPending())
+        return;
+
+    m_fiffInfo = p_fiffInfo;
+
+    m_qMutex.lock();
+    m_bIsPending = false;
+    m_qMutex.unlock();
+
+    beginRecording();
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::writeBuffers(const QList<QSharedPointer<Eigen::MatrixXf> >& p_qListBuffers, qint32 p_iNumSamples)
+{
+    MatrixXd t_matData(m_fiffInfo.nchan, p_iNumSamples);
+
+    qint32 t_iCol = 0;
+    for(qint32 i = 0; i < p_qListBuffers.size(); ++i)
+    {
+        t_matData.block(0, t_iCol, t_matData.rows(), p_qListBuffers[i]->cols()) = p_qListBuffers[i]->cast<double>();
+        t_iCol += p_qListBuffers[i]->cols();
+    }
+
+    m_pOutStream->write_raw_buffer(t_matData, m_matInvCals);
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::run()
+{
+    QList<QSharedPointer<Eigen::MatrixXf> > t_qListBatch;
+    QList<QSharedPointer<Eigen::MatrixXf> > t_qListTag;
+    QElapsedTimer t_qTimerWrite;
+
+    forever
+    {
+        //
+        // Take all pending buffers at once, to keep the lock short
+        //
+        m_qMutex.lock();
+        while(m_qQueue.isEmpty() && m_bIsRunning)
+            m_qWaitCondition.wait(&m_qMutex);
+
+        if(m_qQueue.isEmpty() && !m_bIsRunning)
+        {
+            m_qMutex.unlock();
+            break;
+        }
+
+        t_qListBatch = m_qQueue;
+        m_qQueue.clear();
+        m_qMutex.unlock();
+
+        //
+        // Coalesce the buffers into large tags and write them
+        //
+        t_qTimerWrite.start();
+        qint64 t_iBytes = 0;
+        qint32 t_iSamples = 0;
+        for(qint32 i = 0; i < t_qListBatch.size(); ++i)
+        {
+            t_qListTag.append(t_qListBatch[i]);
+            t_iSamples += t_qListBatch[i]->cols();
+
+            if(t_iSamples >= REC_MAX_TAG_SAMPLES || i == t_qListBatch.size() - 1)
+            {
+                writeBuffers(t_qListTag, t_iSamples);
+                t_iBytes += (qint64)m_fiffInfo.nchan * t_iSamples * sizeof(float);
+
+                m_qMutex.lock();
+                m_iBuffersWritten += t_qListTag.size();
+                m_iSamplesWritten += t_iSamples;
+                m_qMutex.unlock();
+
+                t_qListTag.clear();
+                t_iSamples = 0;
+            }
+        }
+        t_qListBatch.clear();
+
+        //
+        // Update the write counters
+        //
+        qint64 t_iElapsed = t_qTimerWrite.nsecsElapsed();
+        m_qMutex.lock();
+        m_iBytesWritten += t_iBytes;
+        if(t_iElapsed > 0)
+        {
+            double t_dRate = (double)t_iBytes / (t_iElapsed / 1000000000.0);
+            m_dWriteRate = m_dWriteRate > 0.0 ? 0.9 * m_dWriteRate + 0.1 * t_dRate : t_dRate;
+        }
+        m_qMutex.unlock();
+    }
+
+    m_pOutStream->finish_writing_raw();
+    m_pOutStream.clear();
+
+    printf("Stopped recording to %s (%lld buffers written, %lld dropped)\n", m_qFile.fileName().toUtf8().constData(), m_iBuffersWritten, m_iBuffersDropped);
+}
@@ -0,0 +1,316 @@
+//=============================================================================================================
+/**
+* @file     fiffrecorder.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    declaration of the FiffRecorder Class.
+*
+*/
+
+#ifndef FIFFRECORDER_H
+#define FIFFRECORDER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MNE INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff_stream.h>
+#include <fiff/fiff_info.h>
+#include <fiff/fiff_rt_buffer_info.h>
+#include <rtCommand/commandmanager.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QFile>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QSharedPointer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define REC_MAX_QUEUE_SIZE      2000    /**< Maximal number of raw buffers waiting for the disk, before new buffers are dropped. */
+#define REC_MAX_TAG_SAMPLES     10000   /**< Maximal number of samples which are coalesced into one data buffer tag. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE RTSERVER
+//=============================================================================================================
+
+namespace RTSERVER
+{
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+using namespace RTCOMMANDLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class FiffStreamServer;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS FiffRecorder
+*
+* @brief The FiffRecorder class records the raw buffers of the active connector to a fiff file. Incomming buffers
+*        are only enqueued, the file is written by the recorder thread, so that a slow disk never stalls the
+*        data distribution to the FiffStreamClients.
+*/
+class FiffRecorder : public QThread
+{
+    Q_OBJECT
+public:
+    static const qint32 s_iRecorderId = -2;    /**< Reserved client id, which is used to request the measurement info. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a FiffRecorder.
+    *
+    * @param[in] p_pFiffStreamServer    The fiff stream server which distributes the raw buffers.
+    * @param[in] parent                 pointer to parent Object (has to be the MNERTServer).
+    */
+    FiffRecorder(FiffStreamServer* p_pFiffStreamServer, QObject* parent = 0);
+
+    //=========================================================================================================
+    /**
+    * Destroys the FiffRecorder. A running recording is stopped and the file is closed properly.
+    */
+    ~FiffRecorder();
+
+    //=========================================================================================================
+    /**
+    * Connect the recorder to the mne_rt_server commands
+    */
+    void connectCommands();
+
+    //=========================================================================================================
+    /**
+    * Sets the directory to which all recordings are written. File names of rec-start are resolved relative to
+    * this directory, names which point outside of it are rejected.
+    *
+    * @param[in] p_sDirectory   The recording directory, it is created when it does not exist.
+    */
+    void setRecordingDirectory(const QString& p_sDirectory);
+
+    //=========================================================================================================
+    /**
+    * Requests a recording of the raw buffers of the active connector. The measurement info of the connector
+    * is requested and the recording starts as soon as it arrives, see setMeasInfo.
+    *
+    * @param[in] p_sFileName    The fiff file to write to, relative to the recording directory.
+    *
+    * @return true if the recording was requested, false otherwise.
+    */
+    bool startRecording(const QString& p_sFileName);
+
+    //=========================================================================================================
+    /**
+    * Stops the recording. All buffers which are still enqueued are written before the file is closed.
+    */
+    void stopRecording();
+
+    //=========================================================================================================
+    /**
+    * Returns whether a recording is running.
+    *
+    * @return true if recording, false otherwise.
+    */
+    inline bool isRecording() const;
+
+    //=========================================================================================================
+    /**
+    * Returns whether a recording was requested, which still waits for the measurement info.
+    *
+    * @return true if a recording is pending, false otherwise.
+    */
+    inline bool isPending() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the recording status: file, queue depth, written/dropped buffers and write rate.
+    *
+    * @param[in] p_bFlagJSON    if true, function return JSON formatted (default = false)
+    *
+    * @return the status.
+    */
+    QByteArray getStatus(bool p_bFlagJSON = false);
+
+    //=========================================================================================================
+    /**
+    * Enqueues a raw buffer of the recorded stream. Never blocks on the disk, if the queue is full the buffer is
+    * dropped and counted.
+    *
+    * @param[in] p_pMatRawData  The raw buffer to record.
+    * @param[in] p_bufferInfo   Sequence number and acquisition time of the buffer.
+    * @param[in] p_iStreamId    The stream the buffer belongs to, buffers of other streams are ignored.
+    */
+    void enqueueRawBuffer(QSharedPointer<Eigen::MatrixXf> p_pMatRawData, const FIFFLIB::FiffRtBufferInfo& p_bufferInfo, qint32 p_iStreamId);
+
+    //=========================================================================================================
+    /**
+    * Receives the measurement info, which was requested with the recorder id, and starts the pending
+    * recording.
+    *
+    * @param[in] ID             The client id the info was requested for.
+    * @param[in] p_fiffInfo     The measurement info.
+    */
+    void setMeasInfo(qint32 ID, const FIFFLIB::FiffInfo& p_fiffInfo);
+
+protected:
+    //=========================================================================================================
+    /**
+    * The writer loop. Drains the queue, coalesces the buffers into larger tags and writes them to disk.
+    */
+    virtual void run();
+
+private:
+    //SLOTS
+    //=========================================================================================================
+    /**
+    * Starts a recording
+    *
+    * @param[in] p_command  The rec-start command.
+    */
+    void comRecStart(Command p_command);
+
+    //=========================================================================================================
+    /**
+    * Stops the recording
+    *
+    * @param[in] p_command  The rec-stop command.
+    */
+    void comRecStop(Command p_command);
+
+    //=========================================================================================================
+    /**
+    * Sends the recording status
+    *
+    * @param[in] p_command  The rec-status command.
+    */
+    void comRecStatus(Command p_command);
+
+    //=========================================================================================================
+    /**
+    * Writes the header of the pending recording and starts the writer.
+    *
+    * @return true if the recording was started, false otherwise.
+    */
+    bool beginRecording();
+
+    //=========================================================================================================
+    /**
+    * Writes the given buffers as one coalesced data buffer tag.
+    *
+    * @param[in] p_qListBuffers     The buffers to write, all with nchan rows.
+    * @param[in] p_iNumSamples      The total number of samples of all buffers.
+    */
+    void writeBuffers(const QList<QSharedPointer<Eigen::MatrixXf> >& p_qListBuffers, qint32 p_iNumSamples);
+
+    FiffStreamServer*   m_pFiffStreamServer;    /**< The fiff stream server, which provides the raw buffers. */
+
+    QFile               m_qFile;                /**< The file which is recorded to. */
+    FiffStream::SPtr    m_pOutStream;           /**< The fiff out stream, only accessed by the recorder thread. */
+    FiffInfo            m_fiffInfo;             /**< The measurement info of the recording. */
+    qint32              m_iStreamId;            /**< The recorded stream, i.e., the connector selected at start. */
+    QDir                m_qRecordingDir;        /**< The directory to which all recordings are written. */
+    QString             m_sPendingFileName;     /**< The file of the requested recording. */
+    bool                m_bIsPending;           /**< Whether a requested recording waits for the measurement info. */
+    Eigen::SparseMatrix<double> m_matInvCals;   /**< The inverse calibration of all channels. */
+
+    mutable QMutex      m_qMutex;               /**< Guards the queue and the counters. */
+    QWaitCondition      m_qWaitCondition;       /**< Wakes the recorder thread when buffers are enqueued. */
+    QQueue<QSharedPointer<Eigen::MatrixXf> > m_qQueue;  /**< Raw buffers which wait to be written. */
+    qint32              m_iMaxQueueSize;        /**< Maximal queue size, before buffers are dropped. */
+    bool                m_bIsRecording;         /**< Whether the recorder accepts new buffers. */
+    bool                m_bIsRunning;           /**< Whether the recorder thread is running. */
+
+    QElapsedTimer       m_qTimer;               /**< Time since the recording was started. */
+    qint32              m_iMaxQueueDepth;       /**< Maximal queue depth observed during the recording. */
+    qint64              m_iBuffersWritten;      /**< Number of written buffers. */
+    qint64              m_iSamplesWritten;      /**< Number of written samples. */
+    qint64              m_iBytesWritten;        /**< Number of written data bytes. */
+    qint64              m_iBuffersDropped;      /**< Number of dropped buffers, due to a full queue or a channel mismatch. */
+    double              m_dWriteRate;           /**< Smoothed write rate in bytes per second. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline bool FiffRecorder::isRecording() const
+{
+    QMutexLocker locker(&m_qMutex);
+    return m_bIsRecording;
+}
+
+
+//*************************************************************************************************************
+
+inline bool FiffRecorder::isPending() const
+{
+    QMutexLocker locker(&m_qMutex);
+    return m_bIsPending;
+}
+
+} // NAMESPACE
+
+#endif // FIFFRECORDER_H
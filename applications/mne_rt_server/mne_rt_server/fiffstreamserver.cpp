@@ -69,6 +69,7 @@ using namespace FIFFLIB;
 FiffStreamServer::FiffStreamServer(QObject *parent)
 : QTcpServer(parent)
 , m_iNextClientId(0)
+, m_iSelectedStreamId(s_iSelectedStream)
 {
 
 }
@@ -88,11 +89,11 @@ void FiffStreamServer::comClist(Command p_command)
 {
     //ToDo JSON
     QString t_sOutput("");
-    t_sOutput.append("\tID\tAlias\r\n");
+    t_sOutput.append("\tID\tAlias\tStream\r\n");
     QMap<qint32, FiffStreamThread*>::iterator i;
     for (i = this->m_qClientList.begin(); i != this->m_qClientList.end(); ++i)
     {
-        QString str = QString("\t%1\t%2\r\n").arg(i.key()).arg(i.value()->getAlias());
+        QString str = QString("\t%1\t%2\t%3\r\n").arg(i.key()).arg(i.value()->getAlias()).arg(getStreamId(i.key()));
         t_sOutput.append(str);
     }
     t_sOutput.append("\n");
@@ -173,6 +174,60 @@ void FiffStreamServer::comStopAll(Command p_command)
 }
 
 
+//*************************************************************************************************************
+
+void FiffStreamServer::comSubscribe(Command p_command)
+{
+    qint32 t_id = -1;
+    QString t_sOutput("");
+    QString t_sAlias(p_command.pValues()[0].toString());
+    t_sOutput.append(parseToId(t_sAlias,t_id));
+
+    bool t_bIsInt;
+    qint32 t_iStreamId = p_command.pValues()[1].toInt(&t_bIsInt);
+
+    if(t_id != -1 && t_bIsInt)
+    {
+        m_qClientList[t_id]->setStreamId(t_iStreamId);
+
+        QString str;
+        if(t_iStreamId == s_iSelectedStream)
+            str = QString("\tFiffStreamClient (ID: %1) follows the selected connector\r\n\n").arg(t_id);
+        else if(t_iStreamId == s_iMergedStream)
+            str = QString("\tFiffStreamClient (ID: %1) subscribed to the merged stream\r\n\n").arg(t_id);
+        else
+            str = QString("\tFiffStreamClient (ID: %1) subscribed to connector %2\r\n\n").arg(t_id).arg(t_iStreamId);
+        t_sOutput.append(str);
+    }
+    qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["subscribe"].reply(t_sOutput);
+}
+
+
+//*************************************************************************************************************
+
+qint32 FiffStreamServer::getStreamId(qint32 p_iClientId) const
+{
+    qint32 t_iStreamId = s_iSelectedStream;
+    if(m_qClientList.contains(p_iClientId))
+        t_iStreamId = m_qClientList[p_iClientId]->getStreamId();
+
+    return t_iStreamId == s_iSelectedStream ? m_iSelectedStreamId : t_iStreamId;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffStreamServer::hasSubscribers(qint32 p_iStreamId) const
+{
+    QMap<qint32, FiffStreamThread*>::const_iterator i;
+    for (i = this->m_qClientList.begin(); i != this->m_qClientList.end(); ++i)
+        if(getStreamId(i.key()) == p_iStreamId)
+            return true;
+
+    return false;
+}
+
+
 //*************************************************************************************************************
 
 void FiffStreamServer::connectCommands()
@@ -185,6 +240,7 @@ void FiffStreamServer::connectCommands()
     QObject::connect(&t_pMNERTServer->getCommandManager()["start"], &Command::executed, this, &FiffStreamServer::comStart);
     QObject::connect(&t_pMNERTServer->getCommandManager()["stop"], &Command::executed, this, &FiffStreamServer::comStop);
     QObject::connect(&t_pMNERTServer->getCommandManager()["stop-all"], &Command::executed, this, &FiffStreamServer::comStopAll);
+    QObject::connect(&t_pMNERTServer->getCommandManager()["subscribe"], &Command::executed, this, &FiffStreamServer::comSubscribe);
 
 //    t_pMNERTServer->getCommandManager().connectSlot(QString("clist"), this, &FiffStreamServer::comClist);
 //    t_pMNERTServer->getCommandManager().connectSlot(QString("measinfo"), this, &FiffStreamServer::comMeasinfo);
@@ -374,9 +430,11 @@ void FiffStreamServer::forwardMeasInfo(qint32 ID, const FiffInfo& p_fiffInfo)
 
 //*************************************************************************************************************
 //ToDo increase preformance --> try inline
-void FiffStreamServer::forwardRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRawData)
+void FiffStreamServer::forwardRawBuffer(qint32 p_iStreamId, QSharedPointer<Eigen::MatrixXf> m_pMatRawData, qint64 p_iAcqTime)
 {
-    emit remitRawBuffer(m_pMatRawData);
+    //Each stream is numbered separately, clients detect missed buffers by gaps in their stream
+    fiff_int_t& t_iSequenceNumber = m_qMapSequenceNumbers[p_iStreamId];
+    emit remitRawBuffer(m_pMatRawData, FiffRtBufferInfo(t_iSequenceNumber++, p_iAcqTime), p_iStreamId);
 }
 
 
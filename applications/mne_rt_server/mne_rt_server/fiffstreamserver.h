@@ -42,6 +42,7 @@
 //=============================================================================================================
 
 #include <fiff/fiff_info.h>
+#include <fiff/fiff_rt_buffer_info.h>
 #include <rtCommand/commandmanager.h>
 
 
@@ -92,6 +93,9 @@ class FiffStreamServer : public QTcpServer//, public ICommandParser //OLD remove
 
 public:
 
+    static const qint32 s_iSelectedStream = -1;    /**< Stream id which follows the selected connector (default subscription). */
+    static const qint32 s_iMergedStream = 0;       /**< Stream id of the merged stream of all running connectors. */
+
     FiffStreamServer(QObject *parent = 0);
 
     //=========================================================================================================
@@ -112,6 +116,43 @@ public:
     */
     void connectCommands();
 
+    //=========================================================================================================
+    /**
+    * Returns the stream a data client is subscribed to, s_iSelectedStream is resolved to the selected connector.
+    * Unknown ids (e.g. server internal receivers) get the stream of the selected connector.
+    *
+    * @param[in] p_iClientId    The data client id.
+    *
+    * @return the stream id, i.e., the connector id or s_iMergedStream.
+    */
+    qint32 getStreamId(qint32 p_iClientId) const;
+
+    //=========================================================================================================
+    /**
+    * Returns whether at least one data client is subscribed to the given stream.
+    *
+    * @param[in] p_iStreamId    The stream id.
+    *
+    * @return true if the stream has subscribers.
+    */
+    bool hasSubscribers(qint32 p_iStreamId) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the stream id of the selected connector.
+    *
+    * @return the connector id of the selected connector.
+    */
+    inline qint32 selectedStreamId() const;
+
+    //=========================================================================================================
+    /**
+    * Sets the stream id of the selected connector, is called by the connector manager on selection.
+    *
+    * @param[in] p_iStreamId    The connector id of the selected connector.
+    */
+    inline void setSelectedStreamId(qint32 p_iStreamId);
+
 //    virtual bool parseCommand(QStringList& p_sListCommand, QByteArray& p_blockOutputInfo);
 
 
@@ -123,7 +164,15 @@ public:
 
 //public slots: --> in Qt 5 not anymore declared as slot
     void forwardMeasInfo(qint32 ID, const FiffInfo& p_fiffInfo);
-    void forwardRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRawData);
+    //=========================================================================================================
+    /**
+    * Assigns the next sequence number of the stream to the raw buffer and forwards it to the FiffStreamClients.
+    *
+    * @param[in] p_iStreamId    The stream the buffer belongs to, i.e., the connector id or s_iMergedStream.
+    * @param[in] m_pMatRawData  The raw buffer.
+    * @param[in] p_iAcqTime     The acquisition time in microseconds since epoch.
+    */
+    void forwardRawBuffer(qint32 p_iStreamId, QSharedPointer<Eigen::MatrixXf> m_pMatRawData, qint64 p_iAcqTime);
 
 signals:
     void requestMeasInfo(qint32 ID);
@@ -132,7 +181,7 @@ signals:
     void stopMeasFiffStreamClient(qint32 ID);
 
     void remitMeasInfo(qint32 ID, const FIFFLIB::FiffInfo& p_fiffInfo);
-    void remitRawBuffer(QSharedPointer<Eigen::MatrixXf>);
+    void remitRawBuffer(QSharedPointer<Eigen::MatrixXf>, FIFFLIB::FiffRtBufferInfo, qint32 p_iStreamId);
 
     void closeFiffStreamServer();
 
@@ -181,11 +230,22 @@ private:
     */
     void comStopAll(Command p_command);
 
+    //=========================================================================================================
+    /**
+    * Subscribes a fiff data client to a stream
+    *
+    * @param[in] p_command  The subscribe command.
+    */
+    void comSubscribe(Command p_command);
+
     QByteArray parseToId(QString& p_sRawId, qint32& p_iParsedId);
 
     QMap<qint32, FiffStreamThread*> m_qClientList;
     qint32                          m_iNextClientId;
 
+    QMap<qint32, fiff_int_t>        m_qMapSequenceNumbers;  /**< Sequence number of the next raw buffer, per stream. */
+    qint32                          m_iSelectedStreamId;    /**< Connector id of the selected connector. */
+
 };
 
 
@@ -199,6 +259,22 @@ FiffStreamThread* FiffStreamServer::getClient(qint32 id)
     return m_qClientList[id];
 }
 
+
+//*************************************************************************************************************
+
+inline qint32 FiffStreamServer::selectedStreamId() const
+{
+    return m_iSelectedStreamId;
+}
+
+
+//*************************************************************************************************************
+
+inline void FiffStreamServer::setSelectedStreamId(qint32 p_iStreamId)
+{
+    m_iSelectedStreamId = p_iStreamId;
+}
+
 } // NAMESPACE
 
 #endif //FIFFSTREAMSERVER_H
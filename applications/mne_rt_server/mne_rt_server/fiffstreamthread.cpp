@@ -83,6 +83,7 @@ FiffStreamThread::FiffStreamThread(qint32 id, int socketDescriptor, QObject *par
 , m_sDataClientAlias(QString(""))
 , m_iSocketDescriptor(socketDescriptor)
 , m_bIsSendingRawBuffer(false)
+, m_iStreamId(FiffStreamServer::s_iSelectedStream)
 , m_bIsRunning(false)
 {
 }
@@ -178,15 +179,20 @@ void FiffStreamThread::parseCommand(FiffTag::SPtr p_pTag)
 
 //*************************************************************************************************************
 
-void FiffStreamThread::sendRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRawData)
+void FiffStreamThread::sendRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRawData, const FiffRtBufferInfo& p_bufferInfo, qint32 p_iStreamId)
 {
     if(m_bIsSendingRawBuffer)
     {
+        FiffStreamServer* t_pParentServer = qobject_cast<FiffStreamServer*>(this->parent());
+        if(t_pParentServer && t_pParentServer->getStreamId(m_iDataClientId) != p_iStreamId)
+            return;
+
 //        qDebug() << "Send RawBuffer to client";
 
         m_qMutex.lock();
 
         FiffStream t_FiffStreamOut(&m_qSendBlock, QIODevice::WriteOnly);
+        t_FiffStreamOut.write_rt_buffer_info(p_bufferInfo);
         t_FiffStreamOut.write_float(FIFF_DATA_BUFFER,m_pMatRawData->data(),m_pMatRawData->rows()*m_pMatRawData->cols());
 
         m_qMutex.unlock();
@@ -43,6 +43,7 @@
 
 #include <fiff/fiff_stream.h>
 #include <fiff/fiff_info.h>
+#include <fiff/fiff_rt_buffer_info.h>
 
 
 //*************************************************************************************************************
@@ -91,6 +92,10 @@ public:
 
     inline QString getAlias();
 
+    inline qint32 getStreamId();
+
+    inline void setStreamId(qint32 p_iStreamId);
+
 //    void deactivateRawBufferSending();
 
 
@@ -114,6 +119,8 @@ private:
 
     bool m_bIsSendingRawBuffer;
 
+    qint32 m_iStreamId;     /**< Subscribed stream: a connector id, the merged or the selected connector stream. */
+
     bool m_bIsRunning;
 
     void startMeas(qint32 ID);
@@ -122,7 +129,7 @@ private:
 
     void sendMeasurementInfo(qint32 ID, const FiffInfo& p_fiffInfo);
 
-    void sendRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRawData);
+    void sendRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRawData, const FiffRtBufferInfo& p_bufferInfo, qint32 p_iStreamId);
     //void readToBuffer1();
 //    void readProc(QTcpSocket& p_qTcpSocket);
 };
@@ -140,6 +147,18 @@ inline QString FiffStreamThread::getAlias()
 }
 
 
+inline qint32 FiffStreamThread::getStreamId()
+{
+    return m_iStreamId;
+}
+
+
+inline void FiffStreamThread::setStreamId(qint32 p_iStreamId)
+{
+    m_iStreamId = p_iStreamId;
+}
+
+
 } // NAMESPACE
 
 #endif //FIFFSTREAMTHREAD_H
@@ -70,6 +70,7 @@ using namespace RTSERVER;
 
 
 const char* connectorDir = "/mne_rt_server_plugins";        /**< holds directory to connectors.*/
+const char* recordingDir = "/mne_rt_server_recordings";     /**< holds directory to which rec-start writes.*/
 
 
 //*************************************************************************************************************
@@ -81,9 +82,12 @@ MNERTServer::MNERTServer()
 : m_fiffStreamServer(this)
 , m_commandServer(this)
 , m_connectorManager(&m_fiffStreamServer, this)
+, m_fiffRecorder(&m_fiffStreamServer, this)
 {
     qRegisterMetaType<MatrixXf>("MatrixXf");
     qRegisterMetaType<QSharedPointer<Eigen::MatrixXf> >("QSharedPointer<Eigen::MatrixXf>");
+    qRegisterMetaType<FIFFLIB::FiffRtBufferInfo>("FIFFLIB::FiffRtBufferInfo");
+    qRegisterMetaType<FIFFLIB::FiffInfo>("FIFFLIB::FiffInfo");
 
     //
     // init mne_rt_server
@@ -96,6 +100,10 @@ MNERTServer::MNERTServer()
     // fiff stream server
     m_fiffStreamServer.connectCommands();
 
+    // fiff recorder
+    m_fiffRecorder.setRecordingDirectory(qApp->applicationDirPath()+recordingDir);
+    m_fiffRecorder.connectCommands();
+
     // command manager
     m_commandServer.registerCommandManager(this->getCommandManager());
 
@@ -324,6 +332,15 @@ void MNERTServer::init()
             "           \"description\": \"Closes mne_rt_server.\","
             "           \"parameters\": {}"
             "        },"
+            "       \"addcon\": {"
+            "           \"description\": \"Adds a connector which acquires concurrently to the selected one. Its data is streamed with the connector ID as stream ID.\","
+            "           \"parameters\": {"
+            "               \"ConID\": {"
+            "                   \"description\": \"Connector ID\","
+            "                   \"type\": \"int\" "
+            "               }"
+            "           }"
+            "        },"
             "       \"conlist\": {"
             "           \"description\": \"Prints and sends all available connectors.\","
             "           \"parameters\": {}"
@@ -341,6 +358,32 @@ void MNERTServer::init()
             "               }"
             "           }"
             "       },"
+            "       \"rec-start\": {"
+            "           \"description\": \"Starts recording the raw data of the active connector to a fiff file on the server.\","
+            "           \"parameters\": {"
+            "               \"file\": {"
+            "                   \"description\": \"File name, relative to the recording directory of the server\","
+            "                   \"type\": \"QString\" "
+            "               }"
+            "           }"
+            "        },"
+            "       \"rec-status\": {"
+            "           \"description\": \"Prints and sends the recording status: queue depth, written and dropped buffers and write rate.\","
+            "           \"parameters\": {}"
+            "        },"
+            "       \"rec-stop\": {"
+            "           \"description\": \"Stops the recording and closes the fiff file.\","
+            "           \"parameters\": {}"
+            "        },"
+            "       \"remcon\": {"
+            "           \"description\": \"Removes a concurrently acquiring connector and stops it.\","
+            "           \"parameters\": {"
+            "               \"ConID\": {"
+            "                   \"description\": \"Connector ID\","
+            "                   \"type\": \"int\" "
+            "               }"
+            "           }"
+            "        },"
             "       \"selcon\": {"
             "           \"description\": \"Selects a new connector, if a measurement is running it will be stopped.\","
             "           \"parameters\": {"
@@ -368,6 +411,19 @@ void MNERTServer::init()
             "               }"
             "           }"
             "        },"
+            "       \"subscribe\": {"
+            "           \"description\": \"Subscribes the specified FiffStreamClient to a stream: -1 selected connector (default), 0 merged stream, otherwise a connector ID.\","
+            "           \"parameters\": {"
+            "               \"id\": {"
+            "                   \"description\": \"ID/Alias\","
+            "                   \"type\": \"QString\" "
+            "               },"
+            "               \"stream\": {"
+            "                   \"description\": \"Stream ID\","
+            "                   \"type\": \"int\" "
+            "               }"
+            "           }"
+            "        },"
             "       \"stop-all\": {"
             "           \"description\": \"Stops the whole acquisition process.\","
             "           \"parameters\": {}"
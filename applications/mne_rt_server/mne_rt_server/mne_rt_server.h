@@ -45,6 +45,7 @@
 #include "connectormanager.h"
 #include "commandserver.h"
 #include "fiffstreamserver.h"
+#include "fiffrecorder.h"
 
 
 //*************************************************************************************************************
@@ -138,6 +139,8 @@ private:
 
     ConnectorManager    m_connectorManager;     /**< Connector manager. */
 
+    FiffRecorder        m_fiffRecorder;         /**< Server-side recorder of the active connector stream. */
+
     CommandManager      m_commandManager;       /**< The command manager of the mne_rt_server. */
 };
 
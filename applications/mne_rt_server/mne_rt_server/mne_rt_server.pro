@@ -76,7 +76,9 @@ SOURCES += \
     fiffstreamserver.cpp \
     fiffstreamthread.cpp \
     commandserver.cpp \
-    commandthread.cpp
+    commandthread.cpp \
+    fiffrecorder.cpp \
+    streammerger.cpp
 
 
 HEADERS += \
@@ -88,7 +90,9 @@ HEADERS += \
     fiffstreamthread.h \
     commandserver.h \
     commandthread.h \
-    mne_rt_commands.h
+    mne_rt_commands.h \
+    fiffrecorder.h \
+    streammerger.h
 
 INCLUDEPATH += $${EIGEN_INCLUDE_DIR}
 INCLUDEPATH += $${MNE_INCLUDE_DIR}
@@ -0,0 +1,351 @@
+//=============================================================================================================
+/**
+* @file     streammerger.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the StreamMerger Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "streammerger.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <cmath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTSERVER;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+StreamMerger::StreamMerger(QObject* parent)
+: QObject(parent)
+, m_dSFreq(0.0)
+, m_iBlockSize(0)
+, m_dT0(-1.0)
+, m_iOutputSample(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+void StreamMerger::setSources(const QList<qint32>& p_qListSourceIds)
+{
+    m_qListSourceIds = p_qListSourceIds;
+
+    m_qMapSources.clear();
+    for(qint32 i = 0; i < m_qListSourceIds.size(); ++i)
+    {
+        Source t_source;
+        t_source.hasInfo = false;
+        t_source.sfreq = 0.0;
+        t_source.t0 = -1.0;
+        t_source.firstSample = 0;
+        t_source.head = 0;
+        t_source.count = 0;
+        m_qMapSources.insert(m_qListSourceIds[i], t_source);
+    }
+
+    m_dSFreq = 0.0;
+    m_dT0 = -1.0;
+    m_iOutputSample = 0;
+}
+
+
+//*************************************************************************************************************
+
+void StreamMerger::setSourceInfo(qint32 p_iSourceId, const FiffInfo& p_fiffInfo)
+{
+    if(!m_qMapSources.contains(p_iSourceId))
+        return;
+
+    Source& t_source = m_qMapSources[p_iSourceId];
+    t_source.info = p_fiffInfo;
+    t_source.sfreq = p_fiffInfo.sfreq;
+    t_source.hasInfo = true;
+
+    t_source.stimRows.clear();
+    for(qint32 k = 0; k < p_fiffInfo.chs.size(); ++k)
+        if(p_fiffInfo.chs[k].kind == FIFFV_STIM_CH)
+            t_source.stimRows.append(k);
+
+    //The backlog is allocated once, appending only copies into the ring buffer
+    qint32 t_iCapacity = qMax(1, (qint32)(MERGER_MAX_BACKLOG_SEC * t_source.sfreq));
+    if(t_source.data.rows() != p_fiffInfo.nchan || t_source.data.cols() != t_iCapacity)
+    {
+        t_source.data.resize(p_fiffInfo.nchan, t_iCapacity);
+        t_source.firstSample += t_source.count;
+        t_source.head = 0;
+        t_source.count = 0;
+    }
+
+    //Merge at the highest rate, lower rates are interpolated
+    if(t_source.sfreq > m_dSFreq)
+        m_dSFreq = t_source.sfreq;
+}
+
+
+//*************************************************************************************************************
+
+bool StreamMerger::hasInfo() const
+{
+    if(m_qListSourceIds.isEmpty())
+        return false;
+
+    QMap<qint32, Source>::const_iterator it;
+    for(it = m_qMapSources.begin(); it != m_qMapSources.end(); ++it)
+        if(!it.value().hasInfo)
+            return false;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+FiffInfo StreamMerger::info() const
+{
+    FiffInfo t_fiffInfo;
+
+    if(!hasInfo())
+        return t_fiffInfo;
+
+    for(qint32 i = 0; i < m_qListSourceIds.size(); ++i)
+    {
+        const FiffInfo& t_sourceInfo = m_qMapSources[m_qListSourceIds[i]].info;
+
+        if(i == 0)
+        {
+            t_fiffInfo = t_sourceInfo;
+            t_fiffInfo.chs.clear();
+            t_fiffInfo.ch_names.clear();
+            t_fiffInfo.bads.clear();
+            t_fiffInfo.nchan = 0;
+        }
+        else
+        {
+            t_fiffInfo.projs.append(t_sourceInfo.projs);
+            t_fiffInfo.lowpass = qMin(t_fiffInfo.lowpass, t_sourceInfo.lowpass);
+            t_fiffInfo.highpass = qMax(t_fiffInfo.highpass, t_sourceInfo.highpass);
+            //Compensators refer to the channel layout of a single system
+            t_fiffInfo.comps.clear();
+        }
+
+        for(qint32 k = 0; k < t_sourceInfo.chs.size(); ++k)
+        {
+            FiffChInfo t_chInfo = t_sourceInfo.chs[k];
+
+            if(t_fiffInfo.ch_names.contains(t_chInfo.ch_name))
+                t_chInfo.ch_name = QString("%1-%2").arg(t_chInfo.ch_name).arg(m_qListSourceIds[i]);
+            if(t_sourceInfo.bads.contains(t_sourceInfo.chs[k].ch_name))
+                t_fiffInfo.bads.append(t_chInfo.ch_name);
+
+            t_chInfo.scanno = t_fiffInfo.nchan + 1;
+            t_fiffInfo.chs.append(t_chInfo);
+            t_fiffInfo.ch_names.append(t_chInfo.ch_name);
+            ++t_fiffInfo.nchan;
+        }
+    }
+
+    t_fiffInfo.sfreq = m_dSFreq;
+
+    return t_fiffInfo;
+}
+
+
+//*************************************************************************************************************
+
+void StreamMerger::appendRawBuffer(qint32 p_iSourceId, QSharedPointer<MatrixXf> p_pMatRawData, qint64 p_iAcqTime)
+{
+    if(!m_qMapSources.contains(p_iSourceId))
+        return;
+
+    Source& t_source = m_qMapSources[p_iSourceId];
+
+    if(!t_source.hasInfo || p_pMatRawData->rows() != t_source.info.nchan || t_source.sfreq <= 0)
+        return;
+
+    qint32 t_iNewCols = p_pMatRawData->cols();
+
+    //
+    // Clock model: the acquisition time stamp refers to the last sample of the buffer. The estimate of sample 0
+    // is smoothed, which suppresses scheduling jitter but follows a slow drift between the device clocks.
+    //
+    qint64 t_iLastSample = t_source.firstSample + t_source.count + t_iNewCols - 1;
+    double t_dT0Estimate = (double)p_iAcqTime - t_iLastSample * 1.0e6 / t_source.sfreq;
+
+    if(t_source.t0 < 0)
+        t_source.t0 = t_dT0Estimate;
+    else
+        t_source.t0 += 0.01 * (t_dT0Estimate - t_source.t0);
+
+    //
+    // Limit the backlog when another source stalls - the oldest samples are overwritten
+    //
+    qint32 t_iCapacity = t_source.data.cols();
+    qint32 t_iSkip = qMax(0, t_iNewCols - t_iCapacity);
+    qint32 t_iCopy = t_iNewCols - t_iSkip;
+
+    if(t_source.count + t_iCopy > t_iCapacity)
+        dropSamples(t_source, t_source.count + t_iCopy - t_iCapacity);
+    t_source.firstSample += t_iSkip;
+
+    qint32 t_iTail = ringColumn(t_source, t_source.count);
+    qint32 t_iFirst = qMin(t_iCopy, t_iCapacity - t_iTail);
+
+    t_source.data.middleCols(t_iTail, t_iFirst) = p_pMatRawData->middleCols(t_iSkip, t_iFirst);
+    if(t_iFirst < t_iCopy)
+        t_source.data.leftCols(t_iCopy - t_iFirst) = p_pMatRawData->middleCols(t_iSkip + t_iFirst, t_iCopy - t_iFirst);
+    t_source.count += t_iCopy;
+
+    merge();
+}
+
+
+//*************************************************************************************************************
+
+void StreamMerger::merge()
+{
+    if(m_qListSourceIds.isEmpty() || m_dSFreq <= 0)
+        return;
+
+    //
+    // All sources have to be started, the merged stream begins when the last source started
+    //
+    qint32 t_iNChan = 0;
+    double t_dStart = -1.0;
+    QMap<qint32, Source>::iterator it;
+    for(it = m_qMapSources.begin(); it != m_qMapSources.end(); ++it)
+    {
+        if(!it.value().hasInfo || it.value().t0 < 0)
+            return;
+
+        t_iNChan += it.value().info.nchan;
+        t_dStart = qMax(t_dStart, it.value().t0);
+    }
+
+    if(m_iOutputSample == 0)
+        m_dT0 = t_dStart;
+
+    qint32 t_iBlockSize = m_iBlockSize > 0 ? m_iBlockSize : qMax(1, (qint32)(m_dSFreq / 10.0));
+    double t_dOutputPeriod = 1.0e6 / m_dSFreq;
+
+    forever
+    {
+        double t_dTLast = m_dT0 + (m_iOutputSample + t_iBlockSize - 1) * t_dOutputPeriod;
+
+        //Every source has to cover the last sample of the block
+        for(it = m_qMapSources.begin(); it != m_qMapSources.end(); ++it)
+        {
+            double t_dX = (t_dTLast - it.value().t0) * it.value().sfreq * 1.0e-6 - it.value().firstSample;
+            if(std::ceil(t_dX) >= it.value().count)
+                return;
+        }
+
+        QSharedPointer<MatrixXf> t_pMatMerged(new MatrixXf(t_iNChan, t_iBlockSize));
+
+        qint32 t_iRow = 0;
+        for(qint32 i = 0; i < m_qListSourceIds.size(); ++i)
+        {
+            const Source& t_source = m_qMapSources[m_qListSourceIds[i]];
+            qint32 t_iRows = t_source.data.rows();
+            qint32 t_iLastSample = t_source.count - 1;
+
+            for(qint32 j = 0; j < t_iBlockSize; ++j)
+            {
+                double t_dT = m_dT0 + (m_iOutputSample + j) * t_dOutputPeriod;
+                double t_dX = (t_dT - t_source.t0) * t_source.sfreq * 1.0e-6 - t_source.firstSample;
+                if(t_dX < 0)
+                    t_dX = 0;
+
+                qint32 t_i0 = qMin((qint32)std::floor(t_dX), t_iLastSample);
+                qint32 t_i1 = qMin(t_i0 + 1, t_iLastSample);
+                float t_fW = (float)(t_dX - t_i0);
+
+                qint32 t_iCol0 = ringColumn(t_source, t_i0);
+                qint32 t_iCol1 = ringColumn(t_source, t_i1);
+
+                t_pMatMerged->block(t_iRow, j, t_iRows, 1) = (1.0f - t_fW) * t_source.data.col(t_iCol0) + t_fW * t_source.data.col(t_iCol1);
+
+                //Trigger codes are held, an interpolated code would be a different event
+                for(qint32 k = 0; k < t_source.stimRows.size(); ++k)
+                    (*t_pMatMerged)(t_iRow + t_source.stimRows[k], j) = t_source.data(t_source.stimRows[k], t_iCol0);
+            }
+            t_iRow += t_iRows;
+        }
+
+        m_iOutputSample += t_iBlockSize;
+
+        emit mergedRawBuffer(t_pMatMerged, (qint64)t_dTLast);
+
+        //
+        // Drop the samples which are not needed for the next block
+        //
+        double t_dTNext = m_dT0 + m_iOutputSample * t_dOutputPeriod;
+        for(it = m_qMapSources.begin(); it != m_qMapSources.end(); ++it)
+        {
+            Source& t_source = it.value();
+            double t_dX = (t_dTNext - t_source.t0) * t_source.sfreq * 1.0e-6 - t_source.firstSample;
+            qint32 t_iDrop = qBound(0, (qint32)std::floor(t_dX), t_source.count);
+
+            if(t_iDrop > 0)
+                dropSamples(t_source, t_iDrop);
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void StreamMerger::dropSamples(Source& p_source, qint32 p_iDrop)
+{
+    p_source.head = ringColumn(p_source, p_iDrop);
+    p_source.count -= p_iDrop;
+    p_source.firstSample += p_iDrop;
+}
@@ -0,0 +1,267 @@
+//=============================================================================================================
+/**
+* @file     streammerger.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the StreamMerger Class.
+*
+*/
+
+#ifndef STREAMMERGER_H
+#define STREAMMERGER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MNE INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff_info.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QObject>
+#include <QMap>
+#include <QList>
+#include <QVector>
+#include <QSharedPointer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define MERGER_MAX_BACKLOG_SEC  10      /**< Seconds of data kept per source while waiting for the other sources. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE RTSERVER
+//=============================================================================================================
+
+namespace RTSERVER
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+
+
+//=============================================================================================================
+/**
+* Merges the raw buffers of several concurrently running connectors into one stream. The sources are resampled
+* by linear interpolation to the highest source sampling rate and aligned to a common time base, which is derived
+* from the acquisition time stamps of the buffers. Stimulus channels are resampled by sample-and-hold, so that
+* trigger codes are never blended. The channels of all sources are stacked in source order.
+*
+* @brief Aligns and merges the streams of several connectors.
+*/
+class StreamMerger : public QObject
+{
+    Q_OBJECT
+public:
+    static const qint32 s_iMergerId = -3;      /**< Reserved client id, which is used to request the measurement infos of the sources. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a StreamMerger.
+    *
+    * @param[in] parent     Parent QObject (optional)
+    */
+    explicit StreamMerger(QObject* parent = 0);
+
+    //=========================================================================================================
+    /**
+    * Sets the sources to merge and resets the merger.
+    *
+    * @param[in] p_qListSourceIds   The connector ids of the sources, their channels are merged in this order.
+    */
+    void setSources(const QList<qint32>& p_qListSourceIds);
+
+    //=========================================================================================================
+    /**
+    * Returns the connector ids of the merged sources.
+    *
+    * @return the source ids.
+    */
+    inline const QList<qint32>& sources() const;
+
+    //=========================================================================================================
+    /**
+    * Sets the measurement info of a source.
+    *
+    * @param[in] p_iSourceId    The connector id of the source.
+    * @param[in] p_fiffInfo     The measurement info of the source.
+    */
+    void setSourceInfo(qint32 p_iSourceId, const FiffInfo& p_fiffInfo);
+
+    //=========================================================================================================
+    /**
+    * Returns whether the measurement infos of all sources are available.
+    *
+    * @return true if the merged info can be assembled.
+    */
+    bool hasInfo() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the merged measurement info. Duplicate channel names get the connector id as suffix.
+    *
+    * @return the merged measurement info.
+    */
+    FiffInfo info() const;
+
+    //=========================================================================================================
+    /**
+    * Sets the number of samples of the merged buffers.
+    *
+    * @param[in] p_iBlockSize   The merged buffer size in samples.
+    */
+    inline void setBlockSize(qint32 p_iBlockSize);
+
+    //=========================================================================================================
+    /**
+    * Appends a raw buffer of a source and emits all merged buffers, which can be completed afterwards.
+    *
+    * @param[in] p_iSourceId        The connector id of the source.
+    * @param[in] p_pMatRawData      The raw buffer of the source.
+    * @param[in] p_iAcqTime         The acquisition time of the buffer in microseconds since epoch.
+    */
+    void appendRawBuffer(qint32 p_iSourceId, QSharedPointer<Eigen::MatrixXf> p_pMatRawData, qint64 p_iAcqTime);
+
+signals:
+    //=========================================================================================================
+    /**
+    * Is emitted when a merged buffer is available.
+    *
+    * @param[in] p_pMatRawData  The merged buffer.
+    * @param[in] p_iAcqTime     Time of its last sample on the common time base, in microseconds since epoch.
+    */
+    void mergedRawBuffer(QSharedPointer<Eigen::MatrixXf> p_pMatRawData, qint64 p_iAcqTime);
+
+private:
+    //=========================================================================================================
+    /**
+    * Merged source, its pending samples and its clock model.
+    */
+    struct Source
+    {
+        FiffInfo        info;           /**< Measurement info of the source. */
+        bool            hasInfo;        /**< Whether the measurement info was received. */
+        double          sfreq;          /**< Sampling frequency of the source. */
+        double          t0;             /**< Estimated time of sample 0 in microseconds since epoch, < 0 if not started. */
+        qint64          firstSample;    /**< Index of the first pending sample, counted since sample 0. */
+        Eigen::MatrixXf data;           /**< Ring buffer of the pending samples, allocated once when the info is set. */
+        qint32          head;           /**< Column of the first pending sample in data. */
+        qint32          count;          /**< Number of pending samples. */
+        QVector<qint32> stimRows;       /**< Rows of the stimulus channels, which are resampled by sample-and-hold. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Returns the column of a pending sample in the ring buffer of a source.
+    *
+    * @param[in] p_source   The source.
+    * @param[in] p_iSample  Index of the pending sample, 0 is the first pending sample.
+    *
+    * @return the column in p_source.data.
+    */
+    static inline qint32 ringColumn(const Source& p_source, qint32 p_iSample);
+
+    //=========================================================================================================
+    /**
+    * Drops the first pending samples of a source.
+    *
+    * @param[in] p_source   The source.
+    * @param[in] p_iDrop    Number of samples to drop, at most the number of pending samples.
+    */
+    static void dropSamples(Source& p_source, qint32 p_iDrop);
+
+    //=========================================================================================================
+    /**
+    * Emits all merged buffers which are covered by the pending samples of every source and drops consumed samples.
+    */
+    void merge();
+
+    QList<qint32>           m_qListSourceIds;   /**< Connector ids of the sources in merge order. */
+    QMap<qint32, Source>    m_qMapSources;      /**< Sources by connector id. */
+
+    double                  m_dSFreq;           /**< Sampling frequency of the merged stream. */
+    qint32                  m_iBlockSize;       /**< Samples per merged buffer. */
+    double                  m_dT0;              /**< Time of merged sample 0 in microseconds since epoch, < 0 if not started. */
+    qint64                  m_iOutputSample;    /**< Index of the next merged sample. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline const QList<qint32>& StreamMerger::sources() const
+{
+    return m_qListSourceIds;
+}
+
+
+//*************************************************************************************************************
+
+inline void StreamMerger::setBlockSize(qint32 p_iBlockSize)
+{
+    m_iBlockSize = p_iBlockSize > 0 ? p_iBlockSize : m_iBlockSize;
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 StreamMerger::ringColumn(const Source& p_source, qint32 p_iSample)
+{
+    qint32 t_iCol = p_source.head + p_iSample;
+    return t_iCol < p_source.data.cols() ? t_iCol : t_iCol - p_source.data.cols();
+}
+
+} // NAMESPACE
+
+#endif // STREAMMERGER_H
@@ -571,10 +571,12 @@ void RealTimeEvokedModel::filterChanged(QList<FilterData> filterData)
 {
     m_filterData = filterData;
 
+    updateFilters();
+
     m_iMaxFilterLength = 1;
-    for(int i=0; i<filterData.size(); i++) {
-        if(m_iMaxFilterLength<filterData.at(i).m_iFilterOrder) {
-            m_iMaxFilterLength = filterData.at(i).m_iFilterOrder;
+    for(int i=0; i<m_filterDataFIR.size(); i++) {
+        if(m_iMaxFilterLength<m_filterDataFIR.at(i).m_iFilterOrder) {
+            m_iMaxFilterLength = m_filterDataFIR.at(i).m_iFilterOrder;
         }
     }
 
@@ -606,6 +608,8 @@ void RealTimeEvokedModel::setFilterChannelType(QString channelType)
         }
     }
 
+    updateFilters();
+
 //    if(channelType != "All") {
 //        QMutableListIterator<QString> i(m_filterChannelList);
 //        while(i.hasNext()) {
@@ -655,6 +659,8 @@ void RealTimeEvokedModel::createFilterChannelList(QStringList channelNames)
         }
     }
 
+    updateFilters();
+
 //    for(int i = 0; i<m_filterChannelList.size(); i++)
 //        std::cout<<m_filterChannelList.at(i).toStdString()<<std::endl;
 
@@ -663,6 +669,32 @@ void RealTimeEvokedModel::createFilterChannelList(QStringList channelNames)
 }
 
 
+//*************************************************************************************************************
+
+void RealTimeEvokedModel::updateFilters()
+{
+    m_filterDataFIR.clear();
+    for(int i = 0; i < m_filterData.size(); i++) {
+        if(!m_filterData.at(i).isIIR()) {
+            m_filterDataFIR.append(m_filterData.at(i));
+        }
+    }
+
+    QVector<int> vecFilterChannels;
+    if(m_pRTE) {
+        for(int i = 0; i < m_pRTE->info()->chs.size(); i++) {
+            if(m_filterChannelList.contains(m_pRTE->info()->chs.at(i).ch_name)) {
+                vecFilterChannels.append(i);
+            }
+        }
+    }
+
+    if(!m_iirEngine.hasFilters(m_filterData, vecFilterChannels)) {
+        m_iirEngine.setFilters(m_filterData, vecFilterChannels);
+    }
+}
+
+
 //*************************************************************************************************************
 
 void doFilterPerChannelRTE(QPair<QList<FilterData>,QPair<int,RowVectorXd> > &channelDataTime)
@@ -684,16 +716,34 @@ void RealTimeEvokedModel::filterChannelsConcurrently()
         return;
     }
 
+    //Every average is filtered on its own. The IIR filters start from the time reversed average in front, so that they do not start with a step.
+    MatrixXd matData = m_matData;
+
+    if(m_iirEngine.numSections() > 0) {
+        MatrixXd matDataMirrored(m_matData.rows(), 2 * m_matData.cols());
+        matDataMirrored << m_matData.rowwise().reverse(), m_matData;
+
+        m_iirEngine.reset();
+        m_iirEngine.filter(matDataMirrored);
+
+        matData = matDataMirrored.rightCols(m_matData.cols());
+    }
+
+    if(m_filterDataFIR.isEmpty()) {
+        m_matDataFiltered = matData;
+        return;
+    }
+
     //Generate QList structure which can be handled by the QConcurrent framework
     QList<QPair<QList<FilterData>,QPair<int,RowVectorXd> > > timeData;
     QList<int> notFilterChannelIndex;
 
     //Also append mirrored data in front and back to get rid of edge effects
-    for(qint32 i=0; i<m_matData.rows(); ++i) {
+    for(qint32 i=0; i<matData.rows(); ++i) {
         if(m_filterChannelList.contains(m_pRTE->info()->chs.at(i).ch_name)) {
-            RowVectorXd datTemp(m_matData.row(i).cols() + 2 * m_iMaxFilterLength);
-            datTemp << m_matData.row(i).head(m_iMaxFilterLength).reverse(), m_matData.row(i), m_matData.row(i).tail(m_iMaxFilterLength).reverse();
-            timeData.append(QPair<QList<FilterData>,QPair<int,RowVectorXd> >(m_filterData,QPair<int,RowVectorXd>(i,datTemp)));
+            RowVectorXd datTemp(matData.row(i).cols() + 2 * m_iMaxFilterLength);
+            datTemp << matData.row(i).head(m_iMaxFilterLength).reverse(), matData.row(i), matData.row(i).tail(m_iMaxFilterLength).reverse();
+            timeData.append(QPair<QList<FilterData>,QPair<int,RowVectorXd> >(m_filterDataFIR,QPair<int,RowVectorXd>(i,datTemp)));
         } else {
             notFilterChannelIndex.append(i);
         }
@@ -707,13 +757,13 @@ void RealTimeEvokedModel::filterChannelsConcurrently()
         future.waitForFinished();
 
         for(int r = 0; r<timeData.size(); r++) {
-            m_matDataFiltered.row(timeData.at(r).second.first) = timeData.at(r).second.second.segment(m_iMaxFilterLength+m_iMaxFilterLength/2, m_matData.cols());
+            m_matDataFiltered.row(timeData.at(r).second.first) = timeData.at(r).second.second.segment(m_iMaxFilterLength+m_iMaxFilterLength/2, matData.cols());
         }
     }
 
     //Fill filtered data with raw data if the channel was not filtered
     for(int i = 0; i<notFilterChannelIndex.size(); i++) {
-        m_matDataFiltered.row(notFilterChannelIndex.at(i)) = m_matData.row(notFilterChannelIndex.at(i));
+        m_matDataFiltered.row(notFilterChannelIndex.at(i)) = matData.row(notFilterChannelIndex.at(i));
     }
 
     //std::cout<<"END RealTimeEvokedModel::filterChannelsConcurrently()"<<std::endl;
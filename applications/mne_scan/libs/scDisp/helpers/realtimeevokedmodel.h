@@ -49,6 +49,8 @@
 
 #include <utils/filterTools/filterdata.h>
 
+#include <rtProcessing/rtiirengine.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -387,6 +389,13 @@ private:
     */
     void filterChannelsConcurrently();
 
+    //=========================================================================================================
+    /**
+    * Splits the active filters into FIR filters, which are applied by FFT convolution, and IIR filters, which
+    * are run by m_iirEngine on the filter channels.
+    */
+    void updateFilters();
+
     QSharedPointer<RealTimeEvoked>      m_pRTE;          /**< The real-time evoked measurement. */
 
     QMap<qint32,qint32>                 m_qMapIdxRowSelection;          /**< Selection mapping.*/
@@ -414,10 +423,12 @@ private:
     bool                                m_bProjActivated;               /**< Doo projections flag */
     bool                                m_bCompActivated;               /**< Compensator activated */
     float                               m_fSps;                         /**< Sampling rate */
-    qint32                              m_iMaxFilterLength;             /**< Max order of the current filters */
+    qint32                              m_iMaxFilterLength;             /**< Max order of the current FIR filters */
 
     QString                             m_sFilterChannelType;           /**< Kind of channel which is to be filtered */
     QList<FilterData>                   m_filterData;                   /**< List of currently active filters. */
+    QList<FilterData>                   m_filterDataFIR;                /**< FIR filters of m_filterData, applied by FFT convolution. */
+    RTPROCESSINGLIB::RtIirEngine        m_iirEngine;                    /**< Runs the IIR filters of m_filterData over each average. */
     QStringList                         m_filterChannelList;            /**< List of channels which are to be filtered.*/
     QStringList                         m_visibleChannelList;           /**< List of currently visible channels in the view.*/
 };
@@ -366,6 +366,10 @@ void RealTimeMultiSampleArrayModel::setFiffInfo(FiffInfo::SPtr& p_pFiffInfo)
                 m_lTriggerChannelIndices.append(i);
         }
 
+        m_triggerDetector.setChannels(m_lTriggerChannelIndices);
+        m_triggerDetector.setThreshold(m_dTriggerThreshold);
+        m_triggerDetector.setMinimumGap(100);
+
         //Init the sphara operators
         initSphara();
     }
@@ -402,7 +406,7 @@ void RealTimeMultiSampleArrayModel::setSamplingInfo(float sps, int T)
 
 //*************************************************************************************************************
 
-void RealTimeMultiSampleArrayModel::addData(const QList<MatrixXd> &data)
+void RealTimeMultiSampleArrayModel::addData(const QList<QSharedPointer<const MatrixXd> > &data)
 {
     //SSP
     bool doProj = m_bProjActivated && m_matDataRaw.cols() > 0 && m_matDataRaw.rows() == m_matProj.cols() ? true : false;
@@ -415,8 +419,11 @@ void RealTimeMultiSampleArrayModel::addData(const QList<MatrixXd> &data)
 
     //Copy new data into the global data matrix
     for(qint32 b = 0; b < data.size(); ++b) {
-        int nCol = data.at(b).cols();
-        int nRow = data.at(b).rows();
+        //The blocks are shared with the other consumers of the measurement and are only read
+        const MatrixXd& t_matBlock = *data.at(b);
+
+        int nCol = t_matBlock.cols();
+        int nRow = t_matBlock.rows();
 
         if(nRow != m_matDataRaw.rows()) {
             std::cout<<"incoming data does not match internal data row size. Returning..."<<std::endl;
@@ -439,19 +446,19 @@ void RealTimeMultiSampleArrayModel::addData(const QList<MatrixXd> &data)
             if(doComp) {
                 if(doProj) {
                     //Comp + Proj
-                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseProjCompMult * data.at(b).block(0,0,nRow,m_iResidual);
+                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseProjCompMult * t_matBlock.block(0,0,nRow,m_iResidual);
                 } else {
                     //Comp
-                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseCompMult * data.at(b).block(0,0,nRow,m_iResidual);
+                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseCompMult * t_matBlock.block(0,0,nRow,m_iResidual);
                 }
             } else {
                 if(doProj)
                 {
                     //Proj
-                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseProjMult * data.at(b).block(0,0,nRow,m_iResidual);
+                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseProjMult * t_matBlock.block(0,0,nRow,m_iResidual);
                 } else {
                     //None - Raw
-                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = data.at(b).block(0,0,nRow,m_iResidual);
+                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = t_matBlock.block(0,0,nRow,m_iResidual);
                 }
             }
 
@@ -482,24 +489,37 @@ void RealTimeMultiSampleArrayModel::addData(const QList<MatrixXd> &data)
         if(doComp) {
             if(doProj) {
                 //Comp + Proj
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseProjCompMult * data.at(b);
+                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseProjCompMult * t_matBlock;
             } else {
                 //Comp
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseCompMult * data.at(b);
+                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseCompMult * t_matBlock;
             }
         } else {
             if(doProj) {
                 //Proj
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseProjMult * data.at(b);
+                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseProjMult * t_matBlock;
             } else {
                 //None - Raw
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = data.at(b);
+                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = t_matBlock;
             }
         }
 
         //Filter if neccessary else set filtered data matrix to zero
         if(!m_filterData.isEmpty()) {
-            filterChannelsConcurrently(m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol), m_iCurrentSample);
+            //IIR filters run causally on every sample once and keep their state across blocks, FIR filters follow with the overlap add method
+            MatrixXd matBlock = m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol);
+            m_iirEngine.filter(matBlock);
+
+            if(!m_filterDataFIR.isEmpty()) {
+                filterChannelsConcurrently(matBlock, m_iCurrentSample);
+            } else {
+                m_matDataFiltered.block(0, m_iCurrentSample, nRow, nCol) = matBlock;
+
+                //Copy residual data from the front to the back
+                if(m_iResidual > 0) {
+                    m_matDataFiltered.block(0, m_matDataFiltered.cols()-m_iResidual, nRow, m_iResidual) = matBlock.leftCols(m_iResidual);
+                }
+            }
 
             //Perform SPHARA on filtered data after actual filtering - SPHARA should be applied on the best possible data
             if(doSphara) {
@@ -530,16 +550,13 @@ void RealTimeMultiSampleArrayModel::addData(const QList<MatrixXd> &data)
         if(m_bTriggerDetectionActive) {
             int iOldDetectedTriggers = m_qMapDetectedTrigger[m_iCurrentTriggerChIndex].size();
 
-            QString detectionType("Rising");
-
-            //m_qMapDetectedTrigger = DetectTrigger::detectTriggerFlanksMax(data.at(b), m_lTriggerChannelIndices, m_iCurrentSample-nCol, m_dTriggerThreshold, true);
-            QMap<int,QList<QPair<int,double> > > qMapDetectedTrigger = DetectTrigger::detectTriggerFlanksGrad(data.at(b), m_lTriggerChannelIndices, m_iCurrentSample-nCol, m_dTriggerThreshold, false, detectionType);
+            //Map the event samples to the display position of this block and append them to the already found triggers
+            const qint64 iBlockStart = m_triggerDetector.sampleCount();
+            const QVector<TriggerDetector::Event>& vecEvents = m_triggerDetector.detect(t_matBlock);
 
-            //Append results to already found triggers
-            QMapIterator<int,QList<QPair<int,double> > > i(qMapDetectedTrigger);
-            while (i.hasNext()) {
-                i.next();
-                m_qMapDetectedTrigger[i.key()].append(i.value());
+            for(int i = 0; i < vecEvents.size(); ++i) {
+                const int iPos = m_iCurrentSample - nCol + (int)(vecEvents[i].iSample - iBlockStart);
+                m_qMapDetectedTrigger[vecEvents[i].iChannel].append(qMakePair(iPos, (double)vecEvents[i].iValue));
             }
 
             //Compute newly counted triggers
@@ -900,10 +917,12 @@ void RealTimeMultiSampleArrayModel::filterChanged(QList<FilterData> filterData)
 {
     m_filterData = filterData;
 
+    updateFilters();
+
     m_iMaxFilterLength = 1;
-    for(int i=0; i<filterData.size(); ++i) {
-        if(m_iMaxFilterLength<filterData.at(i).m_iFilterOrder) {
-            m_iMaxFilterLength = filterData.at(i).m_iFilterOrder;
+    for(int i=0; i<m_filterDataFIR.size(); ++i) {
+        if(m_iMaxFilterLength<m_filterDataFIR.at(i).m_iFilterOrder) {
+            m_iMaxFilterLength = m_filterDataFIR.at(i).m_iFilterOrder;
         }
     }
 
@@ -952,6 +971,8 @@ void RealTimeMultiSampleArrayModel::setFilterChannelType(QString channelType)
         }
     }
 
+    updateFilters();
+
 //    if(channelType != "All") {
 //        QMutableListIterator<QString> i(m_filterChannelList);
 //        while(i.hasNext()) {
@@ -1001,6 +1022,8 @@ void RealTimeMultiSampleArrayModel::createFilterChannelList(QStringList channelN
         }
     }
 
+    updateFilters();
+
 //    m_bDrawFilterFront = false;
 
 //    for(int i = 0; i<m_filterChannelList.size(); ++i)
@@ -1044,9 +1067,14 @@ void RealTimeMultiSampleArrayModel::markChBad(QModelIndex ch, bool status)
 
 void RealTimeMultiSampleArrayModel::triggerInfoChanged(const QMap<QString, QColor>& colorMap, bool active, QString triggerCh, double threshold)
 {
+    //The last samples and gaps of the detector are stale when the detection is switched on or the channel changes
+    if((active && !m_bTriggerDetectionActive) || m_sCurrentTriggerCh != triggerCh)
+        m_triggerDetector.reset();
+
     m_qMapTriggerColor = colorMap;
     m_bTriggerDetectionActive = active;    
     m_dTriggerThreshold = threshold;
+    m_triggerDetector.setThreshold(threshold);
 
     //Find channel index and initialise detected trigger map if channel name changed
     if(m_sCurrentTriggerCh != triggerCh) {
@@ -1113,6 +1141,30 @@ void RealTimeMultiSampleArrayModel::markChBad(QModelIndexList chlist, bool statu
 }
 
 
+//*************************************************************************************************************
+
+void RealTimeMultiSampleArrayModel::updateFilters()
+{
+    m_filterDataFIR.clear();
+    for(int i = 0; i < m_filterData.size(); ++i) {
+        if(!m_filterData.at(i).isIIR()) {
+            m_filterDataFIR.append(m_filterData.at(i));
+        }
+    }
+
+    QVector<int> vecFilterChannels;
+    for(int i = 0; i < m_pFiffInfo->chs.size(); ++i) {
+        if(m_filterChannelList.contains(m_pFiffInfo->chs.at(i).ch_name)) {
+            vecFilterChannels.append(i);
+        }
+    }
+
+    if(!m_iirEngine.hasFilters(m_filterData, vecFilterChannels)) {
+        m_iirEngine.setFilters(m_filterData, vecFilterChannels);
+    }
+}
+
+
 //*************************************************************************************************************
 
 void doFilterPerChannelRTMSA(QPair<QList<FilterData>,QPair<int,RowVectorXd> > &channelDataTime)
@@ -1132,6 +1184,34 @@ void RealTimeMultiSampleArrayModel::filterChannelsConcurrently()
     if(m_filterData.isEmpty())
         return;
 
+    //The IIR filters run over the whole buffer in time order, oldest sample first, so that their state continues with the next block of addData
+    MatrixXd matData = m_matDataRaw;
+
+    if(m_iirEngine.numSections() > 0) {
+        const int iOldest = m_iCurrentSample < m_matDataRaw.cols() ? m_iCurrentSample : 0;
+        const int iNumOld = m_matDataRaw.cols() - iOldest;
+
+        MatrixXd matDataOrdered(m_matDataRaw.rows(), m_matDataRaw.cols());
+        matDataOrdered.leftCols(iNumOld) = m_matDataRaw.rightCols(iNumOld);
+        matDataOrdered.rightCols(iOldest) = m_matDataRaw.leftCols(iOldest);
+
+        m_iirEngine.reset();
+        m_iirEngine.filter(matDataOrdered);
+
+        matData.rightCols(iNumOld) = matDataOrdered.leftCols(iNumOld);
+        matData.leftCols(iOldest) = matDataOrdered.rightCols(iOldest);
+    }
+
+    if(m_filterDataFIR.isEmpty()) {
+        m_matDataFiltered = matData;
+
+        if(!m_bIsFreezed) {
+            m_vecLastBlockFirstValuesFiltered = m_matDataFiltered.col(0);
+        }
+
+        return;
+    }
+
     //Create temporary filters with higher fft length because we are going to filter all available data at once for one time
     QList<FilterData> tempFilterList;
 
@@ -1139,16 +1219,16 @@ void RealTimeMultiSampleArrayModel::filterChannelsConcurrently()
     int exp = ceil(MNEMath::log2(fftLength));
     fftLength = pow(2, exp) < 512 ? 512 : pow(2, exp);
 
-    for(int i = 0; i<m_filterData.size(); ++i) {
-        FilterData tempFilter(m_filterData.at(i).m_sName,
-                              m_filterData.at(i).m_Type,
-                              m_filterData.at(i).m_iFilterOrder,
-                              m_filterData.at(i).m_dCenterFreq,
-                              m_filterData.at(i).m_dBandwidth,
-                              m_filterData.at(i).m_dParksWidth,
-                              m_filterData.at(i).m_sFreq,
+    for(int i = 0; i<m_filterDataFIR.size(); ++i) {
+        FilterData tempFilter(m_filterDataFIR.at(i).m_sName,
+                              m_filterDataFIR.at(i).m_Type,
+                              m_filterDataFIR.at(i).m_iFilterOrder,
+                              m_filterDataFIR.at(i).m_dCenterFreq,
+                              m_filterDataFIR.at(i).m_dBandwidth,
+                              m_filterDataFIR.at(i).m_dParksWidth,
+                              m_filterDataFIR.at(i).m_sFreq,
                               fftLength,
-                              m_filterData.at(i).m_designMethod);
+                              m_filterDataFIR.at(i).m_designMethod);
 
         tempFilterList.append(tempFilter);
     }
@@ -1158,10 +1238,10 @@ void RealTimeMultiSampleArrayModel::filterChannelsConcurrently()
     QList<int> notFilterChannelIndex;
 
     //Also append mirrored data in front and back to get rid of edge effects
-    for(qint32 i=0; i<m_matDataRaw.rows(); ++i) {
+    for(qint32 i=0; i<matData.rows(); ++i) {
         if(m_filterChannelList.contains(m_pFiffInfo->chs.at(i).ch_name)) {
-            RowVectorXd datTemp(m_matDataRaw.row(i).cols() + 2 * m_iMaxFilterLength);
-            datTemp << m_matDataRaw.row(i).head(m_iMaxFilterLength).reverse(), m_matDataRaw.row(i), m_matDataRaw.row(i).tail(m_iMaxFilterLength).reverse();
+            RowVectorXd datTemp(matData.row(i).cols() + 2 * m_iMaxFilterLength);
+            datTemp << matData.row(i).head(m_iMaxFilterLength).reverse(), matData.row(i), matData.row(i).tail(m_iMaxFilterLength).reverse();
             timeData.append(QPair<QList<FilterData>,QPair<int,RowVectorXd> >(tempFilterList,QPair<int,RowVectorXd>(i,datTemp)));
         }
         else
@@ -1176,14 +1256,14 @@ void RealTimeMultiSampleArrayModel::filterChannelsConcurrently()
         future.waitForFinished();
 
         for(int r = 0; r < timeData.size(); ++r) {
-            m_matDataFiltered.row(timeData.at(r).second.first) = timeData.at(r).second.second.segment(m_iMaxFilterLength+m_iMaxFilterLength/2, m_matDataRaw.cols());
+            m_matDataFiltered.row(timeData.at(r).second.first) = timeData.at(r).second.second.segment(m_iMaxFilterLength+m_iMaxFilterLength/2, matData.cols());
             m_matOverlap.row(timeData.at(r).second.first) = timeData.at(r).second.second.tail(m_iMaxFilterLength);
         }
     }
 
     //Fill filtered data with raw data if the channel was not filtered
     for(int i = 0; i < notFilterChannelIndex.size(); ++i)
-        m_matDataFiltered.row(notFilterChannelIndex.at(i)) = m_matDataRaw.row(notFilterChannelIndex.at(i));
+        m_matDataFiltered.row(notFilterChannelIndex.at(i)) = matData.row(notFilterChannelIndex.at(i));
 
     if(!m_bIsFreezed) {
         m_vecLastBlockFirstValuesFiltered = m_matDataFiltered.col(0);
@@ -1208,7 +1288,7 @@ void RealTimeMultiSampleArrayModel::filterChannelsConcurrently(const MatrixXd &d
 
     for(qint32 i = 0; i < data.rows(); ++i) {
         if(m_filterChannelList.contains(m_pFiffInfo->chs.at(i).ch_name))
-            timeData.append(QPair<QList<FilterData>,QPair<int,RowVectorXd> >(m_filterData,QPair<int,RowVectorXd>(i,data.row(i))));
+            timeData.append(QPair<QList<FilterData>,QPair<int,RowVectorXd> >(m_filterDataFIR,QPair<int,RowVectorXd>(i,data.row(i))));
         else
             notFilterChannelIndex.append(i);
     }
@@ -1321,6 +1401,7 @@ void RealTimeMultiSampleArrayModel::clearModel()
     m_vecLastBlockFirstValuesFiltered.setZero();
     m_vecLastBlockFirstValuesRaw.setZero();
     m_matOverlap.setZero();
+    m_iirEngine.reset();
 
     endResetModel();
 
@@ -48,10 +48,12 @@
 
 #include <utils/filterTools/filterdata.h>
 #include <utils/mnemath.h>
-#include <utils/detecttrigger.h>
+#include <utils/triggerdetector.h>
 #include <utils/ioutils.h>
 #include <utils/filterTools/sphara.h>
 
+#include <rtProcessing/rtiirengine.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -195,9 +197,9 @@ public:
     /**
     * Adds multiple time points (QVector) for a channel set (VectorXd)
     *
-    * @param[in] data       data to add (Time points of channel samples)
+    * @param[in] data       data to add (Time points of channel samples), shared read-only blocks
     */
-    void addData(const QList<MatrixXd> &data);
+    void addData(const QList<QSharedPointer<const MatrixXd> > &data);
 
     //=========================================================================================================
     /**
@@ -532,6 +534,13 @@ private:
     */
     void filterChannelsConcurrently(const MatrixXd &data, int iDataIndex);
 
+    //=========================================================================================================
+    /**
+    * Splits the active filters into FIR filters, which are applied by the overlap add method, and IIR filters,
+    * which are run by m_iirEngine on the filter channels. Resets the IIR state if the filters or channels changed.
+    */
+    void updateFilters();
+
     //=========================================================================================================
     /**
     * Clears the model
@@ -551,7 +560,7 @@ private:
     qint32                              m_iMaxSamples;                              /**< Max samples per window */
     qint32                              m_iCurrentSample;                           /**< Current sample which holds the current position in the data matrix */
     qint32                              m_iCurrentSampleFreeze;                     /**< Current sample which holds the current position in the data matrix when freezing tool is active */
-    qint32                              m_iMaxFilterLength;                         /**< Max order of the current filters */
+    qint32                              m_iMaxFilterLength;                         /**< Max order of the current FIR filters */
     qint32                              m_iCurrentBlockSize;                        /**< Current block size */
     qint32                              m_iResidual;                                /**< Current amount of samples which were to size */
     int                                 m_iCurrentTriggerChIndex;                   /**< The index of the current trigger channel */
@@ -596,11 +605,14 @@ private:
     QMap<QString, QColor>               m_qMapTriggerColor;                         /**< Current colors for all trigger channels. */
     QMap<int,QList<QPair<int,double> > >m_qMapDetectedTrigger;                      /**< Detected trigger for each trigger channel. */
     QList<int>                          m_lTriggerChannelIndices;                   /**< List of all trigger channel indices. */
+    TriggerDetector                     m_triggerDetector;                          /**< Rising flank detection on all trigger channels, carried across blocks. */
     QMap<int,QList<QPair<int,double> > >m_qMapDetectedTriggerFreeze;                /**< Detected trigger for each trigger channel while display is freezed. */
     QMap<int,QList<QPair<int,double> > >m_qMapDetectedTriggerOld;                   /**< Old detected trigger for each trigger channel. */
     QMap<int,QList<QPair<int,double> > >m_qMapDetectedTriggerOldFreeze;             /**< Old detected trigger for each trigger channel while display is freezed. */
     QMap<qint32,float>                  m_qMapChScaling;                            /**< Channel scaling map. */
     QList<FilterData>                   m_filterData;                               /**< List of currently active filters. */
+    QList<FilterData>                   m_filterDataFIR;                            /**< FIR filters of m_filterData, applied by the overlap add method. */
+    RTPROCESSINGLIB::RtIirEngine        m_iirEngine;                                /**< Runs the IIR filters of m_filterData and keeps their state across blocks. */
     QList<RealTimeSampleArrayChInfo>    m_qListChInfo;                              /**< Channel info list. ToDo: Obsolete*/
     QStringList                         m_filterChannelList;                        /**< List of channels which are to be filtered.*/
     QStringList                         m_visibleChannelList;                       /**< List of currently visible channels in the view.*/
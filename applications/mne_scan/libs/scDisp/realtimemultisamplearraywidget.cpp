@@ -225,13 +225,14 @@ void RealTimeMultiSampleArrayWidget::update(SCMEASLIB::NewMeasurement::SPtr)
 
             m_fSamplingRate = m_pRTMSA->getSamplingRate();
 
-            m_iMaxFilterTapSize = m_pRTMSA->getMultiSampleArray().at(m_pRTMSA->getMultiSampleArray().size()-1).cols();
+            QList<NewRealTimeMultiSampleArray::ConstMatrixPtr> t_qListBlocks = m_pRTMSA->getMultiSampleBlocks();
+            m_iMaxFilterTapSize = t_qListBlocks.isEmpty() ? 0 : t_qListBlocks.last()->cols();
 
             init();
         }
     }
     else
-        m_pRTMSAModel->addData(m_pRTMSA->getMultiSampleArray());
+        m_pRTMSAModel->addData(m_pRTMSA->getMultiSampleBlocks());
 }
 
 
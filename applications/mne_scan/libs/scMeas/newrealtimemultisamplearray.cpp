@@ -40,6 +40,8 @@
 
 #include "newrealtimemultisamplearray.h"
 
+#include <generics/matrixpool.h>
+
 #include <iostream>
 
 
@@ -57,6 +59,7 @@
 //=============================================================================================================
 
 using namespace SCMEASLIB;
+using namespace IOBuffer;
 
 
 //*************************************************************************************************************
@@ -239,13 +242,33 @@ void NewRealTimeMultiSampleArray::initFromFiffInfo(FiffInfo::SPtr &p_pFiffInfo)
 //*************************************************************************************************************
 
 void NewRealTimeMultiSampleArray::setValue(const MatrixXd& mat)
+{
+    setValue(mat, FiffRtBufferInfo());
+}
+
+
+//*************************************************************************************************************
+
+void NewRealTimeMultiSampleArray::setValue(const MatrixXd& mat, const FiffRtBufferInfo& bufferInfo)
 {
     if(!m_bChInfoIsInit)
         return;
 
+    //The only copy of the block - all consumers share it. The storage returns to the pool with the last consumer.
+    setValue(MatrixPool::global().copy(mat), bufferInfo);
+}
+
+
+//*************************************************************************************************************
+
+void NewRealTimeMultiSampleArray::setValue(const ConstMatrixPtr& block, const FiffRtBufferInfo& bufferInfo)
+{
+    if(!m_bChInfoIsInit || !block)
+        return;
+
     m_qMutex.lock();
     //check vector size
-    if(mat.rows() != m_qListChInfo.size())
+    if(block->rows() != m_qListChInfo.size())
         qCritical() << "Error Occured in RealTimeMultiSampleArrayNew::setVector: Vector size does not match the number of channels! ";
 
     //ToDo
@@ -257,16 +280,60 @@ void NewRealTimeMultiSampleArray::setValue(const MatrixXd& mat)
 //    }
 
     //Store
-    m_matSamples.push_back(mat);
+    m_qListPendingSamples.push_back(block);
+    m_qListPendingBufferInfo.push_back(bufferInfo);
 
-    m_qMutex.unlock();
-    if(m_matSamples.size() >= m_iMultiArraySize)
+    //Publish the gathered blocks as a new list. Consumers which still hold the previous list keep it, so
+    //nothing has to be cleared after the notification.
+    bool t_bPublish = m_qListPendingSamples.size() >= m_iMultiArraySize;
+    if(t_bPublish)
     {
-        emit notify();
-        m_qMutex.lock();
-        m_matSamples.clear();
-        m_qMutex.unlock();
+        m_qListSamples = m_qListPendingSamples;
+        m_qListBufferInfo = m_qListPendingBufferInfo;
+        m_qListPendingSamples.clear();
+        m_qListPendingBufferInfo.clear();
     }
+
+    m_qMutex.unlock();
+
+    if(t_bPublish)
+        emit notify();
+}
+
+
+//*************************************************************************************************************
+
+void NewRealTimeMultiSampleArray::setMultiSampleBlocks(const QList< ConstMatrixPtr >& blocks, const QList< FiffRtBufferInfo >& bufferInfo)
+{
+    m_qMutex.lock();
+
+    m_qListSamples = blocks;
+    m_qListBufferInfo = bufferInfo;
+
+    //Keep one buffer info per block
+    while(m_qListBufferInfo.size() < m_qListSamples.size())
+        m_qListBufferInfo.append(FiffRtBufferInfo());
+
+    m_qListPendingSamples.clear();
+    m_qListPendingBufferInfo.clear();
+
+    m_qMutex.unlock();
+
+    emit notify();
+}
+
+
+//*************************************************************************************************************
+
+QList< MatrixXd > NewRealTimeMultiSampleArray::getMultiSampleArray() const
+{
+    QList< ConstMatrixPtr > t_qListBlocks = getMultiSampleBlocks();
+
+    QList< MatrixXd > t_qListSamples;
+    for(qint32 i = 0; i < t_qListBlocks.size(); ++i)
+        t_qListSamples.append(*t_qListBlocks[i]);
+
+    return t_qListSamples;
 }
 
 
@@ -47,6 +47,7 @@
 #include "realtimesamplearraychinfo.h"
 
 #include <fiff/fiff_info.h>
+#include <fiff/fiff_rt_buffer_info.h>
 
 
 //*************************************************************************************************************
@@ -91,6 +92,8 @@ public:
     typedef QSharedPointer<NewRealTimeMultiSampleArray> SPtr;               /**< Shared pointer type for NewRealTimeMultiSampleArray. */
     typedef QSharedPointer<const NewRealTimeMultiSampleArray> ConstSPtr;    /**< Const shared pointer type for NewRealTimeMultiSampleArray. */
 
+    typedef QSharedPointer<const MatrixXd> ConstMatrixPtr;                  /**< Shared pointer type for an immutable sample array block. */
+
     //=========================================================================================================
     /**
     * Constructs a RealTimeMultiSampleArrayNew.
@@ -223,11 +226,29 @@ public:
 
     //=========================================================================================================
     /**
-    * Returns the gathered multi sample array.
+    * Returns the last published multi sample array as shared, immutable blocks. Taking the list is cheap and
+    * the blocks stay valid after the next notify(). Consumers which need to modify a block copy it first.
     *
     * @return the current multi sample array.
     */
-    inline const QList< MatrixXd >& getMultiSampleArray();
+    inline QList< ConstMatrixPtr > getMultiSampleBlocks() const;
+
+    //=========================================================================================================
+    /**
+    * Returns a deep copy of the last published multi sample array. Prefer getMultiSampleBlocks().
+    *
+    * @return the current multi sample array.
+    */
+    QList< MatrixXd > getMultiSampleArray() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the sequence numbers and acquisition times of the last published multi sample array, one per
+    * sample array. Entries are invalid if the producer didn't provide acquisition information.
+    *
+    * @return the buffer infos of the current multi sample array.
+    */
+    inline QList< FiffRtBufferInfo > getBufferInfoList() const;
 
     //=========================================================================================================
     /**
@@ -237,6 +258,36 @@ public:
     */
     virtual void setValue(const MatrixXd& mat);
 
+    //=========================================================================================================
+    /**
+    * Attaches a value to the sample array list together with its acquisition information, so that
+    * consumers can determine the age of the data.
+    *
+    * @param [in] mat           the value which is attached to the sample array list.
+    * @param [in] bufferInfo    the sequence number and acquisition time of the value.
+    */
+    void setValue(const MatrixXd& mat, const FiffRtBufferInfo& bufferInfo);
+
+    //=========================================================================================================
+    /**
+    * Attaches a block which is already shared to the sample array list without copying it. The block must not
+    * be modified afterwards.
+    *
+    * @param [in] block         the block which is attached to the sample array list.
+    * @param [in] bufferInfo    the sequence number and acquisition time of the block.
+    */
+    void setValue(const ConstMatrixPtr& block, const FiffRtBufferInfo& bufferInfo = FiffRtBufferInfo());
+
+    //=========================================================================================================
+    /**
+    * Publishes the given blocks as the multi sample array at once, independent of the multi array size, and
+    * notifies the observers. Blocks gathered by setValue are discarded. The blocks must not be modified afterwards.
+    *
+    * @param [in] blocks        the blocks which are published.
+    * @param [in] bufferInfo    the sequence numbers and acquisition times of the blocks.
+    */
+    void setMultiSampleBlocks(const QList< ConstMatrixPtr >& blocks, const QList< FiffRtBufferInfo >& bufferInfo);
+
     //=========================================================================================================
     /**
     * Attaches a value to the sample array vector.
@@ -255,7 +306,10 @@ private:
     double                      m_dSamplingRate;    /**< Sampling rate of the RealTimeSampleArray.*/
 //    MatrixXd                    m_vecValue;         /**< The current attached sample vector.*/
     qint32                      m_iMultiArraySize; /**< Sample size of the multi sample array.*/
-    QList< MatrixXd >           m_matSamples;       /**< The multi sample array.*/
+    QList< ConstMatrixPtr >     m_qListPendingSamples;      /**< The blocks gathered for the next notify.*/
+    QList< FiffRtBufferInfo >   m_qListPendingBufferInfo;   /**< The acquisition information of the gathered blocks.*/
+    QList< ConstMatrixPtr >     m_qListSamples;             /**< The published multi sample array.*/
+    QList< FiffRtBufferInfo >   m_qListBufferInfo;          /**< The acquisition information of the published multi sample array.*/
     QList<RealTimeSampleArrayChInfo> m_qListChInfo; /**< Channel info list.*/
     bool                        m_bChInfoIsInit;    /**< If channel info is initialized.*/
 };
@@ -269,7 +323,10 @@ private:
 inline void NewRealTimeMultiSampleArray::clear()
 {
     QMutexLocker locker(&m_qMutex);
-    m_matSamples.clear();
+    m_qListPendingSamples.clear();
+    m_qListPendingBufferInfo.clear();
+    m_qListSamples.clear();
+    m_qListBufferInfo.clear();
 }
 
 
@@ -387,9 +444,19 @@ qint32 NewRealTimeMultiSampleArray::getMultiArraySize() const
 
 //*************************************************************************************************************
 
-inline const QList< MatrixXd >& NewRealTimeMultiSampleArray::getMultiSampleArray()
+inline QList< NewRealTimeMultiSampleArray::ConstMatrixPtr > NewRealTimeMultiSampleArray::getMultiSampleBlocks() const
 {
-    return m_matSamples;
+    QMutexLocker locker(&m_qMutex);
+    return m_qListSamples;
+}
+
+
+//*************************************************************************************************************
+
+inline QList< FiffRtBufferInfo > NewRealTimeMultiSampleArray::getBufferInfoList() const
+{
+    QMutexLocker locker(&m_qMutex);
+    return m_qListBufferInfo;
 }
 
 } // NAMESPACE
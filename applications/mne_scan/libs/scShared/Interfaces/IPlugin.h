@@ -45,6 +45,8 @@
 //#include "../Management/pluginoutputconnector.h"
 #include "../Management/pluginoutputdata.h"
 #include "../Management/plugininputdata.h"
+#include "../Management/plugintaskscheduler.h"
+#include "../Management/pluginstatistics.h"
 
 
 //*************************************************************************************************************
@@ -111,6 +113,12 @@ public:
     typedef QVector< QSharedPointer< PluginInputConnector > > InputConnectorList;  /**< List of input connectors. */
     typedef QVector< QSharedPointer< PluginOutputConnector > > OutputConnectorList; /**< List of output connectors. */
 
+    //=========================================================================================================
+    /**
+    * Constructs the IPlugin.
+    */
+    IPlugin() : m_pTaskScheduler(NULL) {};
+
     //=========================================================================================================
     /**
     * Destroys the IPlugin.
@@ -200,6 +208,49 @@ public:
     inline InputConnectorList& getInputConnectors(){return m_inputConnectors;}
     inline OutputConnectorList& getOutputConnectors(){return m_outputConnectors;}
 
+    //=========================================================================================================
+    /**
+    * True if the plugin implements process() and can run on the shared PluginTaskScheduler instead of its own thread.
+    *
+    * @return true if scheduled processing is supported.
+    */
+    virtual bool supportsScheduledProcessing() const { return false; }
+
+    //=========================================================================================================
+    /**
+    * Processes one block on a worker of the PluginTaskScheduler. Blocks of a plugin are processed in the order
+    * they were posted and never concurrently. Reimplement together with supportsScheduledProcessing().
+    *
+    * @param [in] pBlock       the block to process.
+    * @param [in] bufferInfo   the acquisition information of the block, to be passed on with the output.
+    */
+    virtual void process(const QSharedPointer<const Eigen::MatrixXd>& pBlock, const FIFFLIB::FiffRtBufferInfo& bufferInfo) { Q_UNUSED(pBlock); Q_UNUSED(bufferInfo); }
+
+    //=========================================================================================================
+    /**
+    * Sets the scheduler which executes process(). Called by the PluginSceneManager while the plugins are stopped.
+    *
+    * @param [in] pScheduler   the scheduler, NULL to run the plugin in its own thread.
+    */
+    inline void setTaskScheduler(PluginTaskScheduler* pScheduler);
+
+    //=========================================================================================================
+    /**
+    * Returns whether the plugin runs on the PluginTaskScheduler.
+    *
+    * @return true if scheduled.
+    */
+    inline bool isScheduled() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the runtime statistics of the plugin. Input and output are recorded by the connectors, the
+    * processing of a block has to be marked with a PluginStatistics::BlockTimer unless the plugin is scheduled.
+    *
+    * @return the statistics.
+    */
+    inline PluginStatistics& statistics();
+
 
 protected:
     //=========================================================================================================
@@ -218,11 +269,24 @@ protected:
     */
     inline void addPluginAction(QAction* pAction);
 
+    //=========================================================================================================
+    /**
+    * Posts a received block to the PluginTaskScheduler, which calls process() with it.
+    *
+    * @param [in] pBlock       the block to process.
+    * @param [in] bufferInfo   the acquisition information of the block.
+    *
+    * @return true if the block was queued.
+    */
+    inline bool postBlock(const PluginTaskScheduler::Block& pBlock, const FIFFLIB::FiffRtBufferInfo& bufferInfo = FIFFLIB::FiffRtBufferInfo());
+
     InputConnectorList m_inputConnectors;    /**< Set of input connectors associated with this plug-in. */
     OutputConnectorList m_outputConnectors;  /**< Set of output connectors associated with this plug-in. */
 
 private:
-    QList< QAction* >   m_qListPluginActions;  /**< List of plugin actions */
+    QList< QAction* >       m_qListPluginActions;  /**< List of plugin actions */
+    PluginTaskScheduler*    m_pTaskScheduler;      /**< The scheduler which executes process(), NULL if the plugin runs its own thread. */
+    PluginStatistics        m_statistics;          /**< Runtime statistics of the plugin. */
 };
 
 //*************************************************************************************************************
@@ -252,6 +316,38 @@ inline void IPlugin::addPluginAction(QAction* pAction)
 }
 
 
+//*************************************************************************************************************
+
+inline void IPlugin::setTaskScheduler(PluginTaskScheduler* pScheduler)
+{
+    m_pTaskScheduler = pScheduler;
+}
+
+
+//*************************************************************************************************************
+
+inline bool IPlugin::isScheduled() const
+{
+    return m_pTaskScheduler != NULL;
+}
+
+
+//*************************************************************************************************************
+
+inline PluginStatistics& IPlugin::statistics()
+{
+    return m_statistics;
+}
+
+
+//*************************************************************************************************************
+
+inline bool IPlugin::postBlock(const PluginTaskScheduler::Block& pBlock, const FIFFLIB::FiffRtBufferInfo& bufferInfo)
+{
+    return m_pTaskScheduler ? m_pTaskScheduler->post(this, pBlock, bufferInfo) : false;
+}
+
+
 //*************************************************************************************************************
 
 //inline void IPlugin::addPluginWidget(QWidget* pWidget)
@@ -0,0 +1,213 @@
+//=============================================================================================================
+/**
+* @file     blockcoalescer.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the BlockCoalescer Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "blockcoalescer.h"
+
+#include <generics/matrixpool.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QtAlgorithms>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace SCSHAREDLIB;
+using namespace SCMEASLIB;
+using namespace FIFFLIB;
+using namespace IOBuffer;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+BlockCoalescer::BlockCoalescer()
+: m_iPreferred(0)
+, m_iMaximum(0)
+, m_iPendingSamples(0)
+, m_iPendingOffset(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+void BlockCoalescer::setBlockSize(int iPreferred, int iMaximum)
+{
+    m_iPreferred = iPreferred;
+    m_iMaximum = qMax(iPreferred, iMaximum);
+
+    clear();
+}
+
+
+//*************************************************************************************************************
+
+void BlockCoalescer::clear()
+{
+    m_qListPending.clear();
+    m_qListPendingBufferInfo.clear();
+    m_iPendingSamples = 0;
+    m_iPendingOffset = 0;
+}
+
+
+//*************************************************************************************************************
+
+NewMeasurement::SPtr BlockCoalescer::process(const NewMeasurement::SPtr& pMeasurement)
+{
+    QSharedPointer<NewRealTimeMultiSampleArray> pRTMSA = pMeasurement.dynamicCast<NewRealTimeMultiSampleArray>();
+
+    if(!isEnabled() || !pRTMSA)
+        return pMeasurement;
+
+    updateOutput(pRTMSA);
+
+    QList<NewRealTimeMultiSampleArray::ConstMatrixPtr> t_qListBlocks = pRTMSA->getMultiSampleBlocks();
+    QList<FiffRtBufferInfo> t_qListBufferInfo = pRTMSA->getBufferInfoList();
+
+    QList<NewRealTimeMultiSampleArray::ConstMatrixPtr> t_qListOutput;
+    QList<FiffRtBufferInfo> t_qListOutputBufferInfo;
+
+    for(qint32 i = 0; i < t_qListBlocks.size(); ++i)
+    {
+        const NewRealTimeMultiSampleArray::ConstMatrixPtr& t_pBlock = t_qListBlocks[i];
+        if(!t_pBlock || t_pBlock->cols() == 0)
+            continue;
+
+        //The channel count changed - the remainder can not be merged with the new blocks
+        if(!m_qListPending.isEmpty() && m_qListPending.first()->rows() != t_pBlock->rows())
+            clear();
+
+        m_qListPending.append(t_pBlock);
+        m_qListPendingBufferInfo.append(i < t_qListBufferInfo.size() ? t_qListBufferInfo[i] : FiffRtBufferInfo());
+        m_iPendingSamples += (int)t_pBlock->cols();
+
+        while(m_iPendingSamples >= m_iPreferred)
+        {
+            FiffRtBufferInfo t_bufferInfo;
+            t_qListOutput.append(takeSamples(qMin(m_iPendingSamples, m_iMaximum), t_bufferInfo));
+            t_qListOutputBufferInfo.append(t_bufferInfo);
+        }
+    }
+
+    if(t_qListOutput.isEmpty())
+        return NewMeasurement::SPtr();
+
+    m_pOutput->setMultiSampleBlocks(t_qListOutput, t_qListOutputBufferInfo);
+
+    return m_pOutput;
+}
+
+
+//*************************************************************************************************************
+
+NewRealTimeMultiSampleArray::ConstMatrixPtr BlockCoalescer::takeSamples(int iSamples, FiffRtBufferInfo& bufferInfo)
+{
+    bufferInfo = m_qListPendingBufferInfo.first();
+
+    //Sizes line up - hand on the received block itself
+    if(m_iPendingOffset == 0 && m_qListPending.first()->cols() == iSamples)
+    {
+        NewRealTimeMultiSampleArray::ConstMatrixPtr t_pBlock = m_qListPending.takeFirst();
+        m_qListPendingBufferInfo.removeFirst();
+        m_iPendingSamples -= iSamples;
+        return t_pBlock;
+    }
+
+    MatrixPool::MatrixPtr t_pBlock = MatrixPool::global().acquire((qint32)m_qListPending.first()->rows(), iSamples);
+
+    int iCol = 0;
+    while(iCol < iSamples)
+    {
+        const NewRealTimeMultiSampleArray::ConstMatrixPtr& t_pHead = m_qListPending.first();
+        int iTake = qMin((int)t_pHead->cols() - m_iPendingOffset, iSamples - iCol);
+
+        t_pBlock->middleCols(iCol, iTake) = t_pHead->middleCols(m_iPendingOffset, iTake);
+
+        iCol += iTake;
+        m_iPendingOffset += iTake;
+
+        if(m_iPendingOffset == t_pHead->cols())
+        {
+            m_qListPending.removeFirst();
+            m_qListPendingBufferInfo.removeFirst();
+            m_iPendingOffset = 0;
+        }
+    }
+
+    m_iPendingSamples -= iSamples;
+
+    return t_pBlock;
+}
+
+
+//*************************************************************************************************************
+
+void BlockCoalescer::updateOutput(const QSharedPointer<NewRealTimeMultiSampleArray>& pSource)
+{
+    if(m_pSource != pSource)
+    {
+        clear();
+
+        m_pSource = pSource;
+
+        m_pOutput = QSharedPointer<NewRealTimeMultiSampleArray>(new NewRealTimeMultiSampleArray());
+        m_pOutput->setName(pSource->getName());
+        m_pOutput->setVisibility(pSource->isVisible());
+        m_pOutput->setXMLLayoutFile(pSource->getXMLLayoutFile());
+        m_pOutput->setDisplayFlags(pSource->getDisplayFlags());
+    }
+
+    //The channel description may be set after the connection was established
+    if(m_pOutput->getNumChannels() != pSource->getNumChannels())
+        m_pOutput->init(pSource->chInfo());
+
+    m_pOutput->setSamplingRate(pSource->getSamplingRate());
+    m_pOutput->info() = pSource->info();
+}
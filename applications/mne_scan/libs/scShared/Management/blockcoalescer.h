@@ -0,0 +1,217 @@
+//=============================================================================================================
+/**
+* @file     blockcoalescer.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the BlockCoalescer Class.
+*
+*/
+
+#ifndef BLOCKCOALESCER_H
+#define BLOCKCOALESCER_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../scshared_global.h"
+
+#include <scMeas/newmeasurement.h>
+#include <scMeas/newrealtimemultisamplearray.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QList>
+#include <QSharedPointer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE SCSHAREDLIB
+//=============================================================================================================
+
+namespace SCSHAREDLIB
+{
+
+
+//=============================================================================================================
+/**
+* Re-blocks the sample array stream of an input connector. Incoming blocks are gathered until at least the
+* preferred number of samples is available; the gathered samples are then handed on in blocks of at most the
+* maximum number of samples. Blocks which already have an acceptable size and are not preceded by a remainder
+* are passed on without copying. Merged or split blocks are assembled in blocks of the global matrix pool.
+*
+* Measurements which are no NewRealTimeMultiSampleArray are passed through unchanged. The coalescer is used from
+* the thread which delivers the measurements to the input connector and is not thread-safe.
+*
+* @brief Merges and splits sample array blocks to a preferred block size
+*/
+class SCSHAREDSHARED_EXPORT BlockCoalescer
+{
+public:
+    //=========================================================================================================
+    /**
+    * Constructs a disabled BlockCoalescer which passes all measurements through.
+    */
+    BlockCoalescer();
+
+    //=========================================================================================================
+    /**
+    * Sets the block size. Gathered samples are discarded.
+    *
+    * @param[in] iPreferred     Preferred number of samples per block. Coalescing is disabled if it is <= 0.
+    * @param[in] iMaximum       Maximal number of samples per block, clamped to at least iPreferred. If it is
+    *                           equal to iPreferred all blocks have exactly iPreferred samples.
+    */
+    void setBlockSize(int iPreferred, int iMaximum);
+
+    //=========================================================================================================
+    /**
+    * Returns the preferred number of samples per block.
+    *
+    * @return the preferred block size, <= 0 if coalescing is disabled.
+    */
+    inline int preferredBlockSize() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the maximal number of samples per block.
+    *
+    * @return the maximal block size.
+    */
+    inline int maximumBlockSize() const;
+
+    //=========================================================================================================
+    /**
+    * Returns whether coalescing is enabled.
+    *
+    * @return true if the blocks are coalesced.
+    */
+    inline bool isEnabled() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of gathered samples which were not handed on yet.
+    *
+    * @return the number of pending samples.
+    */
+    inline int pendingSamples() const;
+
+    //=========================================================================================================
+    /**
+    * Discards the gathered samples.
+    */
+    void clear();
+
+    //=========================================================================================================
+    /**
+    * Feeds a measurement into the coalescer.
+    *
+    * @param[in] pMeasurement   The measurement received by the input connector.
+    *
+    * @return the measurement to forward to the plugin: the input itself if coalescing does not apply, a sample
+    *         array holding the completed blocks, or NULL if no block was completed.
+    */
+    SCMEASLIB::NewMeasurement::SPtr process(const SCMEASLIB::NewMeasurement::SPtr& pMeasurement);
+
+private:
+    //=========================================================================================================
+    /**
+    * Takes the given number of samples from the front of the pending blocks. The first pending block is handed
+    * on as it is if it matches, otherwise the samples are copied into a block of the global matrix pool.
+    *
+    * @param[in] iSamples       Number of samples to take, must not exceed m_iPendingSamples.
+    * @param[out] bufferInfo    Acquisition information of the first pending block.
+    *
+    * @return the block.
+    */
+    SCMEASLIB::NewRealTimeMultiSampleArray::ConstMatrixPtr takeSamples(int iSamples, FIFFLIB::FiffRtBufferInfo& bufferInfo);
+
+    //=========================================================================================================
+    /**
+    * Copies the description of the source sample array to the forwarded sample array when it changed.
+    *
+    * @param[in] pSource    The received sample array.
+    */
+    void updateOutput(const QSharedPointer<SCMEASLIB::NewRealTimeMultiSampleArray>& pSource);
+
+    int     m_iPreferred;       /**< Preferred number of samples per block, <= 0 if disabled. */
+    int     m_iMaximum;         /**< Maximal number of samples per block. */
+    int     m_iPendingSamples;  /**< Number of samples in m_qListPending, excluding the m_iPendingOffset consumed ones. */
+    int     m_iPendingOffset;   /**< Number of already handed on samples of the first pending block. */
+
+    QList<SCMEASLIB::NewRealTimeMultiSampleArray::ConstMatrixPtr>  m_qListPending;           /**< Received blocks which were not completely handed on yet. */
+    QList<FIFFLIB::FiffRtBufferInfo>                                m_qListPendingBufferInfo; /**< Acquisition information of the pending blocks. */
+
+    QSharedPointer<SCMEASLIB::NewRealTimeMultiSampleArray>          m_pSource;  /**< The sample array the output description was taken from. */
+    QSharedPointer<SCMEASLIB::NewRealTimeMultiSampleArray>          m_pOutput;  /**< The sample array which is forwarded to the plugin. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline int BlockCoalescer::preferredBlockSize() const
+{
+    return m_iPreferred;
+}
+
+
+//*************************************************************************************************************
+
+inline int BlockCoalescer::maximumBlockSize() const
+{
+    return m_iMaximum;
+}
+
+
+//*************************************************************************************************************
+
+inline bool BlockCoalescer::isEnabled() const
+{
+    return m_iPreferred > 0;
+}
+
+
+//*************************************************************************************************************
+
+inline int BlockCoalescer::pendingSamples() const
+{
+    return m_iPendingSamples;
+}
+
+} // NAMESPACE
+
+#endif // BLOCKCOALESCER_H
@@ -41,6 +41,8 @@
 #include "plugininputconnector.h"
 #include "../Interfaces/IPlugin.h"
 
+#include <scMeas/newrealtimemultisamplearray.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -48,6 +50,8 @@
 //=============================================================================================================
 
 using namespace SCSHAREDLIB;
+using namespace SCMEASLIB;
+using namespace FIFFLIB;
 
 
 //*************************************************************************************************************
@@ -81,5 +85,41 @@ bool PluginInputConnector::isOutputConnector() const
 
 void PluginInputConnector::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
 {
-    emit notify(pMeasurement);
+    if(m_pPlugin && PluginStatistics::isEnabled()) {
+        //End-to-end latency of the blocks which carry their acquisition time
+        QSharedPointer<NewRealTimeMultiSampleArray> t_pRTMSA = pMeasurement.dynamicCast<NewRealTimeMultiSampleArray>();
+        if(t_pRTMSA) {
+            QList<FiffRtBufferInfo> t_qListBufferInfo = t_pRTMSA->getBufferInfoList();
+            for(qint32 i = 0; i < t_qListBufferInfo.size(); ++i) {
+                if(t_qListBufferInfo[i].isValid())
+                    m_pPlugin->statistics().recordLatency(t_qListBufferInfo[i].age());
+            }
+        }
+    }
+
+    SCMEASLIB::NewMeasurement::SPtr t_pMeasurement = prepare(pMeasurement);
+
+    if(!t_pMeasurement)
+        return;
+
+    if(m_pPlugin && PluginStatistics::isEnabled()) {
+        //One notification can carry several blocks, the plugin processes and times each of them separately
+        qint32 t_iBlocks = 1;
+        QSharedPointer<NewRealTimeMultiSampleArray> t_pRTMSA = t_pMeasurement.dynamicCast<NewRealTimeMultiSampleArray>();
+        if(t_pRTMSA)
+            t_iBlocks = qMax(1, t_pRTMSA->getMultiSampleBlocks().size());
+
+        for(qint32 i = 0; i < t_iBlocks; ++i)
+            m_pPlugin->statistics().recordInput();
+    }
+
+    emit notify(t_pMeasurement);
+}
+
+
+//*************************************************************************************************************
+
+SCMEASLIB::NewMeasurement::SPtr PluginInputConnector::prepare(const SCMEASLIB::NewMeasurement::SPtr& pMeasurement)
+{
+    return pMeasurement;
 }
@@ -115,7 +115,17 @@ signals:
 public slots:
     void update(SCMEASLIB::NewMeasurement::SPtr pMeasurement);
 
-
+protected:
+    //=========================================================================================================
+    /**
+    * Prepares a received measurement before it is handed on to the plugin by notify. The default implementation
+    * passes the measurement through.
+    *
+    * @param[in] pMeasurement   the received measurement.
+    *
+    * @return the measurement to notify, NULL if nothing is to be notified.
+    */
+    virtual SCMEASLIB::NewMeasurement::SPtr prepare(const SCMEASLIB::NewMeasurement::SPtr& pMeasurement);
 
 };
 
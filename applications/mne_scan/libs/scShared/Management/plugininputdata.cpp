@@ -81,6 +81,15 @@ void PluginInputData<T>::setCallbackMethod(callback_function pFunc)
 }
 
 
+//*************************************************************************************************************
+
+template <class T>
+SCMEASLIB::NewMeasurement::SPtr PluginInputData<T>::prepare(const SCMEASLIB::NewMeasurement::SPtr& pMeasurement)
+{
+    return m_blockCoalescer.process(pMeasurement);
+}
+
+
 //*************************************************************************************************************
 
 template <class T>
@@ -43,6 +43,7 @@
 #include "../scshared_global.h"
 
 #include "plugininputconnector.h"
+#include "blockcoalescer.h"
 
 #include <QSharedPointer>
 
@@ -103,7 +104,45 @@ public:
     */
     void setCallbackMethod(callback_function pFunc);
 
+    //=========================================================================================================
+    /**
+    * Declares the block size the plugin prefers. Received sample array blocks are merged until at least iPreferred
+    * samples are available and handed on in blocks of at most iMaximum samples, which trades latency for less
+    * per-block overhead. Blocks are passed on without copying when their size is already acceptable.
+    * Call with iPreferred <= 0 to receive the blocks as they are sent, which is the default.
+    *
+    * @param[in] iPreferred     preferred number of samples per block.
+    * @param[in] iMaximum       maximal number of samples per block, -1 to use iPreferred.
+    */
+    inline void setBlockSize(int iPreferred, int iMaximum = -1);
+
+    //=========================================================================================================
+    /**
+    * Returns the preferred number of samples per block.
+    *
+    * @return the preferred block size, <= 0 if the blocks are not coalesced.
+    */
+    inline int preferredBlockSize() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the maximal number of samples per block.
+    *
+    * @return the maximal block size.
+    */
+    inline int maximumBlockSize() const;
+
 protected:
+    //=========================================================================================================
+    /**
+    * Coalesces the received sample array blocks to the declared block size.
+    *
+    * @param[in] pMeasurement   the received measurement.
+    *
+    * @return the measurement to notify, NULL if no block was completed.
+    */
+    virtual SCMEASLIB::NewMeasurement::SPtr prepare(const SCMEASLIB::NewMeasurement::SPtr& pMeasurement);
+
     //=========================================================================================================
     /**
     * SLOT to notify the registered calback fucntion.
@@ -113,7 +152,8 @@ protected:
     void notifyCallbackFunction(SCMEASLIB::NewMeasurement::SPtr pMeasurement);
 
 private:
-    callback_function m_pFunc;  /**< registered callback function */
+    callback_function m_pFunc;          /**< registered callback function */
+    BlockCoalescer m_blockCoalescer;    /**< merges and splits the received blocks to the declared block size */
 
 };
 
@@ -129,6 +169,33 @@ inline QSharedPointer< PluginInputData<T> > PluginInputData<T>::create(IPlugin *
     return pPluginInputData;
 }
 
+
+//*************************************************************************************************************
+
+template <class T>
+inline void PluginInputData<T>::setBlockSize(int iPreferred, int iMaximum)
+{
+    m_blockCoalescer.setBlockSize(iPreferred, iMaximum < 0 ? iPreferred : iMaximum);
+}
+
+
+//*************************************************************************************************************
+
+template <class T>
+inline int PluginInputData<T>::preferredBlockSize() const
+{
+    return m_blockCoalescer.preferredBlockSize();
+}
+
+
+//*************************************************************************************************************
+
+template <class T>
+inline int PluginInputData<T>::maximumBlockSize() const
+{
+    return m_blockCoalescer.maximumBlockSize();
+}
+
 } // NAMESPACE
 
 //Make the template definition visible to compiler in the first point of instantiation
@@ -76,3 +76,12 @@ bool PluginOutputConnector::isOutputConnector() const
     return true;
 }
 
+
+//*************************************************************************************************************
+
+void PluginOutputConnector::recordOutputStatistics()
+{
+    if(m_pPlugin)
+        m_pPlugin->statistics().recordOutput();
+}
+
@@ -99,6 +99,13 @@ public:
      */
     virtual bool isOutputConnector() const;
 
+protected:
+    //=========================================================================================================
+    /**
+     * Records an output block in the statistics of the plugin.
+     */
+    void recordOutputStatistics();
+
 signals:
     void notify(SCMEASLIB::NewMeasurement::SPtr);
 
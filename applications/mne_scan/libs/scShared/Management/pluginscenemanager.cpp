@@ -41,6 +41,16 @@
 #include "pluginscenemanager.h"
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QFile>
+#include <QTextStream>
+#include <QJsonArray>
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // USED NAMESPACES
@@ -56,6 +66,7 @@ using namespace SCSHAREDLIB;
 
 PluginSceneManager::PluginSceneManager(QObject *parent)
 : QObject(parent)
+, m_executionMode(_ThreadPerPlugin)
 {
 }
 
@@ -135,6 +146,27 @@ bool PluginSceneManager::removePlugin(const IPlugin::SPtr pPlugin)
 
 bool PluginSceneManager::startPlugins()
 {
+    // Statistics cover the current measurement only
+    QList<IPlugin::SPtr>::iterator itStats = m_pluginList.begin();
+    for( ; itStats != m_pluginList.end(); ++itStats)
+        (*itStats)->statistics().reset();
+
+    // The scheduler has to run before the sensors deliver the first block
+    if(m_executionMode == _Scheduled)
+    {
+        QList<IPlugin::SPtr>::iterator it = m_pluginList.begin();
+        for( ; it != m_pluginList.end(); ++it)
+        {
+            if((*it)->supportsScheduledProcessing())
+            {
+                m_taskScheduler.registerPlugin(it->data());
+                (*it)->setTaskScheduler(&m_taskScheduler);
+            }
+        }
+
+        m_taskScheduler.start();
+    }
+
     // Start ISensor and IRTAlgorithm plugins first!
     bool bFlag = startSensorPlugins();
 
@@ -143,6 +175,8 @@ bool PluginSceneManager::startPlugins()
         startAlgorithmPlugins();
         startIOPlugins();
     }
+    else
+        stopTaskScheduler();
 
     return bFlag;
 }
@@ -205,12 +239,30 @@ void PluginSceneManager::stopPlugins()
             if(!(*it)->stop())
                 qWarning() << "Could not stop IPlugin: " << (*it)->getName();
 
+    // No more input -> stop processing of the scheduled plugins
+    m_taskScheduler.stop();
+
     // Stop all other plugins!
     it = m_pluginList.begin();
     for( ; it != m_pluginList.end(); ++it)
         if((*it)->getType() != IPlugin::_ISensor)
             if(!(*it)->stop())
                 qWarning() << "Could not stop IPlugin: " << (*it)->getName();
+
+    stopTaskScheduler();
+}
+
+
+//*************************************************************************************************************
+
+void PluginSceneManager::stopTaskScheduler()
+{
+    m_taskScheduler.stop();
+    m_taskScheduler.unregisterAll();
+
+    QList<IPlugin::SPtr>::iterator it = m_pluginList.begin();
+    for( ; it != m_pluginList.end(); ++it)
+        (*it)->setTaskScheduler(NULL);
 }
 
 
@@ -220,3 +272,57 @@ void PluginSceneManager::clear()
 {
 //    m_pluginList.clear();
 }
+
+
+//*************************************************************************************************************
+
+QString PluginSceneManager::statisticsToCsv() const
+{
+    QString t_sCsv = "id;plugin;" + PluginStatistics::csvHeader() + "\n";
+
+    for(qint32 i = 0; i < m_pluginList.size(); ++i)
+        t_sCsv += QString("%1;%2;").arg(i).arg(m_pluginList[i]->getName()) + m_pluginList[i]->statistics().toCsvRow() + "\n";
+
+    return t_sCsv;
+}
+
+
+//*************************************************************************************************************
+
+QJsonDocument PluginSceneManager::statisticsToJson() const
+{
+    QJsonArray t_jsonPlugins;
+
+    for(qint32 i = 0; i < m_pluginList.size(); ++i)
+    {
+        QJsonObject t_jsonPlugin = m_pluginList[i]->statistics().toJson();
+        t_jsonPlugin.insert("id", i);
+        t_jsonPlugin.insert("plugin", m_pluginList[i]->getName());
+        t_jsonPlugins.append(t_jsonPlugin);
+    }
+
+    QJsonObject t_jsonObject;
+    t_jsonObject.insert("plugins", t_jsonPlugins);
+
+    return QJsonDocument(t_jsonObject);
+}
+
+
+//*************************************************************************************************************
+
+bool PluginSceneManager::saveStatistics(const QString& sFileName) const
+{
+    QFile t_file(sFileName);
+    if(!t_file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        qWarning() << "Could not write plugin statistics to" << sFileName;
+        return false;
+    }
+
+    if(sFileName.endsWith(".json", Qt::CaseInsensitive))
+        t_file.write(statisticsToJson().toJson());
+    else
+        QTextStream(&t_file) << statisticsToCsv();
+
+    return true;
+}
@@ -44,6 +44,7 @@
 #include "../scshared_global.h"
 #include "../Interfaces/IPlugin.h"
 #include "pluginconnectorconnection.h"
+#include "plugintaskscheduler.h"
 
 
 //*************************************************************************************************************
@@ -54,6 +55,7 @@
 #include <QObject>
 #include <QSharedPointer>
 #include <QList>
+#include <QJsonDocument>
 
 
 //*************************************************************************************************************
@@ -80,6 +82,16 @@ public:
     typedef QList< IPlugin::SPtr > PluginList;                                      /**< type for a list of plugins. */
     typedef QList<PluginConnectorConnection::SPtr> PluginConnectorConnectionList;   /**< Shared pointer type for PluginConnectorConnection::SPtr list */
 
+    //=========================================================================================================
+    /**
+    * Execution mode of the plugins.
+    */
+    enum ExecutionMode
+    {
+        _ThreadPerPlugin,   /**< Every plugin runs its own thread. */
+        _Scheduled          /**< Plugins which support it are processed on the shared PluginTaskScheduler. */
+    };
+
     //=========================================================================================================
     /**
     * Constructs a PluginSceneManager.
@@ -105,6 +117,22 @@ public:
 
     inline PluginList& getPlugins();
 
+    //=========================================================================================================
+    /**
+    * Sets the execution mode. Takes effect with the next startPlugins().
+    *
+    * @param[in] mode   the execution mode.
+    */
+    inline void setExecutionMode(ExecutionMode mode);
+
+    //=========================================================================================================
+    /**
+    * Returns the execution mode.
+    *
+    * @return the execution mode.
+    */
+    inline ExecutionMode getExecutionMode() const;
+
     //=========================================================================================================
     /**
     * Removes a plugin from the stage.
@@ -155,13 +183,49 @@ public:
     */
     void clear();
 
+    //=========================================================================================================
+    /**
+    * Returns the runtime statistics of all plugins as CSV table, one row per plugin.
+    *
+    * @return the CSV table.
+    */
+    QString statisticsToCsv() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the runtime statistics of all plugins as JSON document.
+    *
+    * @return the JSON document.
+    */
+    QJsonDocument statisticsToJson() const;
+
+    //=========================================================================================================
+    /**
+    * Writes the runtime statistics of all plugins to a file. Files ending with .json are written as JSON,
+    * all others as CSV.
+    *
+    * @param[in] sFileName  the file to write.
+    *
+    * @return true if the file was written.
+    */
+    bool saveStatistics(const QString& sFileName) const;
+
 signals:
 
 
 private:
+    //=========================================================================================================
+    /**
+    * Stops the PluginTaskScheduler and detaches the plugins from it.
+    */
+    void stopTaskScheduler();
+
     PluginList m_pluginList;    /**< List of plugins associated with this set. */
     PluginConnectorConnectionList m_conConList; /**< List of connector connections. */
 
+    ExecutionMode       m_executionMode;    /**< The execution mode of the plugins. */
+    PluginTaskScheduler m_taskScheduler;    /**< Processes the plugins in _Scheduled mode. */
+
 //    QSharedPointer<PluginSet> m_pPluginSet;     /**< The Plugin set of the stage -> ToDo: check, if more than one set on the stage is usefull. */
 };
 
@@ -175,6 +239,22 @@ inline PluginSceneManager::PluginList& PluginSceneManager::getPlugins()
     return m_pluginList;
 }
 
+
+//*************************************************************************************************************
+
+inline void PluginSceneManager::setExecutionMode(ExecutionMode mode)
+{
+    m_executionMode = mode;
+}
+
+
+//*************************************************************************************************************
+
+inline PluginSceneManager::ExecutionMode PluginSceneManager::getExecutionMode() const
+{
+    return m_executionMode;
+}
+
 } //Namespace
 
 #endif // PLUGINSCENEMANAGER_H
@@ -0,0 +1,369 @@
+//=============================================================================================================
+/**
+* @file     pluginstatistics.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the PluginStatistics Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "pluginstatistics.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QElapsedTimer>
+#include <QStringList>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace SCSHAREDLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC DEFINITIONS
+//=============================================================================================================
+
+QAtomicInt PluginStatistics::s_iEnabled(1);
+
+namespace
+{
+    const char* const s_metricNames[PluginStatistics::_NumMetrics] = {"processing_us", "input_wait_us", "input_queue_depth", "output_interval_us", "latency_us"};
+
+    QElapsedTimer startedClock()
+    {
+        QElapsedTimer t_clock;
+        t_clock.start();
+        return t_clock;
+    }
+
+    const QElapsedTimer& monotonicClock()
+    {
+        static const QElapsedTimer s_clock = startedClock();
+        return s_clock;
+    }
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+double PluginHistogram::Snapshot::mean() const
+{
+    return count > 0 ? (double)sum / (double)count : 0.0;
+}
+
+
+//*************************************************************************************************************
+
+quint32 PluginHistogram::Snapshot::percentile(double dPercent) const
+{
+    if(count == 0)
+        return 0;
+
+    quint64 t_uiRank = (quint64)(qBound(0.0, dPercent, 100.0) / 100.0 * (double)(count - 1));
+    quint64 t_uiSeen = 0;
+
+    for(qint32 i = 0; i < bins.size(); ++i)
+    {
+        t_uiSeen += bins[i];
+        if(t_uiSeen > t_uiRank)
+            return qMin(i == 0 ? 0 : (quint32)((((quint64)1) << i) - 1), max);
+    }
+
+    return max;
+}
+
+
+//*************************************************************************************************************
+
+PluginHistogram::PluginHistogram()
+{
+    reset();
+}
+
+
+//*************************************************************************************************************
+
+PluginHistogram::Snapshot PluginHistogram::snapshot() const
+{
+    Snapshot t_snapshot;
+    t_snapshot.count = 0;
+    t_snapshot.bins.resize(PLUGIN_STATISTICS_NUM_BINS);
+
+    for(qint32 i = 0; i < PLUGIN_STATISTICS_NUM_BINS; ++i)
+    {
+        t_snapshot.bins[i] = (quint32)m_iBins[i].loadAcquire();
+        t_snapshot.count += t_snapshot.bins[i];
+    }
+
+    t_snapshot.sum = m_iSum.loadAcquire();
+    t_snapshot.max = (quint32)m_iMax.loadAcquire();
+
+    return t_snapshot;
+}
+
+
+//*************************************************************************************************************
+
+void PluginHistogram::reset()
+{
+    for(qint32 i = 0; i < PLUGIN_STATISTICS_NUM_BINS; ++i)
+        m_iBins[i].storeRelease(0);
+
+    m_iMax.storeRelease(0);
+    m_iSum.storeRelease(0);
+}
+
+
+//*************************************************************************************************************
+
+PluginStatistics::PluginStatistics()
+{
+    reset();
+}
+
+
+//*************************************************************************************************************
+
+void PluginStatistics::recordInput()
+{
+    if(!isEnabled())
+        return;
+
+    m_iInputs.fetchAndAddRelaxed(1);
+
+    //Single producer - the input connector is updated from one thread only
+    quint32 t_uiWrite = (quint32)m_iArrivalWrite.loadAcquire();
+    quint32 t_uiPending = t_uiWrite - (quint32)m_iArrivalRead.loadAcquire();
+
+    m_histograms[_InputQueueDepth].record(t_uiPending);
+
+    //Drop the stamp if the plugin doesn't consume them
+    if(t_uiPending < PLUGIN_STATISTICS_ARRIVAL_SLOTS)
+    {
+        m_iArrivals[t_uiWrite % PLUGIN_STATISTICS_ARRIVAL_SLOTS] = timestamp();
+        m_iArrivalWrite.storeRelease((qint32)(t_uiWrite + 1));
+    }
+}
+
+
+//*************************************************************************************************************
+
+void PluginStatistics::recordLatency(qint64 iAge)
+{
+    if(!isEnabled())
+        return;
+
+    m_histograms[_Latency].record((quint32)qBound((qint64)0, iAge, (qint64)0xFFFFFFFF));
+}
+
+
+//*************************************************************************************************************
+
+void PluginStatistics::recordOutput()
+{
+    if(!isEnabled())
+        return;
+
+    m_iOutputs.fetchAndAddRelaxed(1);
+
+    qint64 t_iNow = timestamp();
+    qint64 t_iLast = m_iLastOutput.fetchAndStoreRelaxed(t_iNow);
+
+    if(t_iLast > 0)
+        m_histograms[_OutputInterval].record((quint32)qMin(t_iNow - t_iLast, (qint64)0xFFFFFFFF));
+}
+
+
+//*************************************************************************************************************
+
+qint64 PluginStatistics::beginBlock()
+{
+    if(!isEnabled())
+        return 0;
+
+    qint64 t_iNow = timestamp();
+
+    //Single consumer - blocks of a plugin are never processed concurrently
+    quint32 t_uiRead = (quint32)m_iArrivalRead.loadAcquire();
+    if(t_uiRead != (quint32)m_iArrivalWrite.loadAcquire())
+    {
+        qint64 t_iArrival = m_iArrivals[t_uiRead % PLUGIN_STATISTICS_ARRIVAL_SLOTS];
+        m_iArrivalRead.storeRelease((qint32)(t_uiRead + 1));
+
+        m_histograms[_InputWaitTime].record((quint32)qBound((qint64)0, t_iNow - t_iArrival, (qint64)0xFFFFFFFF));
+    }
+
+    return t_iNow;
+}
+
+
+//*************************************************************************************************************
+
+void PluginStatistics::endBlock(qint64 iStart)
+{
+    if(iStart == 0)
+        return;
+
+    m_iProcessed.fetchAndAddRelaxed(1);
+    m_histograms[_ProcessingTime].record((quint32)qMin(timestamp() - iStart, (qint64)0xFFFFFFFF));
+}
+
+
+//*************************************************************************************************************
+
+PluginHistogram::Snapshot PluginStatistics::histogram(Metric metric) const
+{
+    return m_histograms[metric].snapshot();
+}
+
+
+//*************************************************************************************************************
+
+double PluginStatistics::outputRate() const
+{
+    double t_dSeconds = (double)(timestamp() - m_iResetTime) / 1000000.0;
+    return t_dSeconds > 0 ? (double)outputBlocks() / t_dSeconds : 0.0;
+}
+
+
+//*************************************************************************************************************
+
+void PluginStatistics::reset()
+{
+    for(qint32 i = 0; i < _NumMetrics; ++i)
+        m_histograms[i].reset();
+
+    m_iArrivalWrite.storeRelease(0);
+    m_iArrivalRead.storeRelease(0);
+    m_iInputs.storeRelease(0);
+    m_iProcessed.storeRelease(0);
+    m_iOutputs.storeRelease(0);
+    m_iLastOutput.storeRelease(0);
+    m_iResetTime = timestamp();
+}
+
+
+//*************************************************************************************************************
+
+QJsonObject PluginStatistics::toJson() const
+{
+    QJsonObject t_jsonObject;
+    t_jsonObject.insert("input_blocks", (double)inputBlocks());
+    t_jsonObject.insert("processed_blocks", (double)processedBlocks());
+    t_jsonObject.insert("output_blocks", (double)outputBlocks());
+    t_jsonObject.insert("output_rate_hz", outputRate());
+
+    for(qint32 i = 0; i < _NumMetrics; ++i)
+    {
+        PluginHistogram::Snapshot t_snapshot = histogram((Metric)i);
+
+        QJsonObject t_jsonMetric;
+        t_jsonMetric.insert("count", (double)t_snapshot.count);
+        t_jsonMetric.insert("mean", t_snapshot.mean());
+        t_jsonMetric.insert("p50", (double)t_snapshot.percentile(50));
+        t_jsonMetric.insert("p95", (double)t_snapshot.percentile(95));
+        t_jsonMetric.insert("p99", (double)t_snapshot.percentile(99));
+        t_jsonMetric.insert("max", (double)t_snapshot.max);
+
+        t_jsonObject.insert(s_metricNames[i], t_jsonMetric);
+    }
+
+    return t_jsonObject;
+}
+
+
+//*************************************************************************************************************
+
+QString PluginStatistics::csvHeader()
+{
+    QStringList t_qListColumns;
+    t_qListColumns << "input_blocks" << "processed_blocks" << "output_blocks" << "output_rate_hz";
+
+    for(qint32 i = 0; i < _NumMetrics; ++i)
+    {
+        QString t_sName(s_metricNames[i]);
+        t_qListColumns << t_sName + "_mean" << t_sName + "_p50" << t_sName + "_p95" << t_sName + "_p99" << t_sName + "_max";
+    }
+
+    return t_qListColumns.join(';');
+}
+
+
+//*************************************************************************************************************
+
+QString PluginStatistics::toCsvRow() const
+{
+    QStringList t_qListValues;
+    t_qListValues << QString::number(inputBlocks()) << QString::number(processedBlocks()) << QString::number(outputBlocks()) << QString::number(outputRate());
+
+    for(qint32 i = 0; i < _NumMetrics; ++i)
+    {
+        PluginHistogram::Snapshot t_snapshot = histogram((Metric)i);
+        t_qListValues << QString::number(t_snapshot.mean())
+                      << QString::number(t_snapshot.percentile(50))
+                      << QString::number(t_snapshot.percentile(95))
+                      << QString::number(t_snapshot.percentile(99))
+                      << QString::number(t_snapshot.max);
+    }
+
+    return t_qListValues.join(';');
+}
+
+
+//*************************************************************************************************************
+
+void PluginStatistics::setEnabled(bool bEnabled)
+{
+    s_iEnabled.storeRelease(bEnabled ? 1 : 0);
+}
+
+
+//*************************************************************************************************************
+
+qint64 PluginStatistics::timestamp()
+{
+    //Offset by one so that a valid time stamp is never 0
+    return monotonicClock().nsecsElapsed() / 1000 + 1;
+}
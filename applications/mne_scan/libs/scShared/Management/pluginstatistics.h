@@ -0,0 +1,414 @@
+//=============================================================================================================
+/**
+* @file     pluginstatistics.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the PluginStatistics Class.
+*
+*/
+
+#ifndef PLUGINSTATISTICS_H
+#define PLUGINSTATISTICS_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../scshared_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QAtomicInt>
+#include <QAtomicInteger>
+#include <QtAlgorithms>
+#include <QVector>
+#include <QString>
+#include <QJsonObject>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define PLUGIN_STATISTICS_NUM_BINS          32      /**< Number of log2 histogram bins - covers the full quint32 range. */
+#define PLUGIN_STATISTICS_ARRIVAL_SLOTS     256     /**< Number of input arrival time stamps kept per plugin, power of two. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE SCSHAREDLIB
+//=============================================================================================================
+
+namespace SCSHAREDLIB
+{
+
+
+//=========================================================================================================
+/**
+* PluginHistogram counts values in power of two bins. Recording is lock-free and wait-free and can be done
+* from any thread while another thread takes snapshots.
+*
+* @brief Lock-free log2 histogram.
+*/
+class SCSHAREDSHARED_EXPORT PluginHistogram
+{
+public:
+    //=========================================================================================================
+    /**
+    * A consistent copy of the histogram.
+    */
+    struct Snapshot {
+        quint64             count;      /**< Number of recorded values. */
+        qint64              sum;        /**< Sum of the recorded values. */
+        quint32             max;        /**< Largest recorded value. */
+        QVector<quint32>    bins;       /**< Bin i counts the values in [2^(i-1), 2^i - 1], bin 0 counts zeros. */
+
+        //=====================================================================================================
+        /**
+        * Returns the mean of the recorded values.
+        *
+        * @return the mean, 0 if nothing was recorded.
+        */
+        double mean() const;
+
+        //=====================================================================================================
+        /**
+        * Returns an upper bound of the given percentile, accurate to the bin width.
+        *
+        * @param[in] dPercent   the percentile in [0, 100].
+        *
+        * @return the upper bound of the bin holding the percentile, 0 if nothing was recorded.
+        */
+        quint32 percentile(double dPercent) const;
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs an empty PluginHistogram.
+    */
+    PluginHistogram();
+
+    //=========================================================================================================
+    /**
+    * Records a value.
+    *
+    * @param[in] uiValue    the value to record.
+    */
+    inline void record(quint32 uiValue);
+
+    //=========================================================================================================
+    /**
+    * Returns a copy of the histogram.
+    *
+    * @return the snapshot.
+    */
+    Snapshot snapshot() const;
+
+    //=========================================================================================================
+    /**
+    * Clears the histogram. Must not be called concurrently to record().
+    */
+    void reset();
+
+private:
+    QAtomicInt              m_iBins[PLUGIN_STATISTICS_NUM_BINS];    /**< The bin counts. */
+    QAtomicInt              m_iMax;                                 /**< The largest recorded value. */
+    QAtomicInteger<qint64>  m_iSum;                                 /**< Sum of the recorded values. */
+};
+
+
+//=========================================================================================================
+/**
+* PluginStatistics holds the runtime statistics of one plugin: time to process a block, time a block waited
+* in the input buffer, input buffer fill level, output rate and the end-to-end latency since acquisition. The connectors record input and output, the
+* plugin or the PluginTaskScheduler marks the processing of a block with a BlockTimer. All recording is
+* lock-free and costs a few atomic operations and two clock reads per block.
+*
+* @brief Per plugin latency, throughput and queue depth statistics.
+*/
+class SCSHAREDSHARED_EXPORT PluginStatistics
+{
+public:
+    //=========================================================================================================
+    /**
+    * The recorded metrics.
+    */
+    enum Metric
+    {
+        _ProcessingTime,    /**< Time to process a block in microseconds. */
+        _InputWaitTime,     /**< Time between input arrival and start of processing in microseconds. */
+        _InputQueueDepth,   /**< Blocks pending in the input buffer when a block arrives. */
+        _OutputInterval,    /**< Time between two output blocks in microseconds. */
+        _Latency,           /**< Time between acquisition of a block and its arrival at the plugin in microseconds. */
+        _NumMetrics
+    };
+
+    //=========================================================================================================
+    /**
+    * Measures the processing of one block while in scope.
+    */
+    class BlockTimer
+    {
+    public:
+        inline explicit BlockTimer(PluginStatistics& statistics);
+        inline ~BlockTimer();
+
+    private:
+        PluginStatistics&   m_statistics;   /**< The statistics to record to. */
+        qint64              m_iStart;       /**< Start of processing in microseconds. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs empty PluginStatistics.
+    */
+    PluginStatistics();
+
+    //=========================================================================================================
+    /**
+    * Records the arrival of an input block. Called by the PluginInputConnector once per delivered block.
+    */
+    void recordInput();
+
+    //=========================================================================================================
+    /**
+    * Records the end-to-end latency of an input block, i.e., the age of the block when it arrives at the plugin.
+    * Called by the PluginInputConnector for blocks which carry a valid FiffRtBufferInfo.
+    *
+    * @param[in] iAge   the age of the block in microseconds.
+    */
+    void recordLatency(qint64 iAge);
+
+    //=========================================================================================================
+    /**
+    * Records an output block. Called by the PluginOutputConnector.
+    */
+    void recordOutput();
+
+    //=========================================================================================================
+    /**
+    * Marks the start of processing of the oldest pending input block.
+    *
+    * @return the start time stamp to pass to endBlock().
+    */
+    qint64 beginBlock();
+
+    //=========================================================================================================
+    /**
+    * Marks the end of processing of a block.
+    *
+    * @param[in] iStart     the time stamp returned by beginBlock().
+    */
+    void endBlock(qint64 iStart);
+
+    //=========================================================================================================
+    /**
+    * Returns a snapshot of a metric.
+    *
+    * @param[in] metric     the metric.
+    *
+    * @return the snapshot.
+    */
+    PluginHistogram::Snapshot histogram(Metric metric) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of input blocks since the last reset.
+    *
+    * @return the number of input blocks.
+    */
+    inline quint32 inputBlocks() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of processed blocks since the last reset.
+    *
+    * @return the number of processed blocks.
+    */
+    inline quint32 processedBlocks() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of output blocks since the last reset.
+    *
+    * @return the number of output blocks.
+    */
+    inline quint32 outputBlocks() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the output rate since the last reset.
+    *
+    * @return output blocks per second.
+    */
+    double outputRate() const;
+
+    //=========================================================================================================
+    /**
+    * Clears all metrics. Must not be called while the plugin is running.
+    */
+    void reset();
+
+    //=========================================================================================================
+    /**
+    * Returns the metrics as JSON object.
+    *
+    * @return the JSON object.
+    */
+    QJsonObject toJson() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the column names of toCsvRow(), separated by ';'.
+    *
+    * @return the CSV header.
+    */
+    static QString csvHeader();
+
+    //=========================================================================================================
+    /**
+    * Returns the metrics as CSV row, separated by ';'.
+    *
+    * @return the CSV row.
+    */
+    QString toCsvRow() const;
+
+    //=========================================================================================================
+    /**
+    * Enables or disables recording for all plugins. Enabled by default.
+    *
+    * @param[in] bEnabled   whether to record.
+    */
+    static void setEnabled(bool bEnabled);
+
+    //=========================================================================================================
+    /**
+    * Returns whether recording is enabled.
+    *
+    * @return true if enabled.
+    */
+    static inline bool isEnabled();
+
+    //=========================================================================================================
+    /**
+    * Returns a monotonic time stamp.
+    *
+    * @return the time stamp in microseconds.
+    */
+    static qint64 timestamp();
+
+private:
+    PluginHistogram     m_histograms[_NumMetrics];      /**< The metrics. */
+
+    qint64              m_iArrivals[PLUGIN_STATISTICS_ARRIVAL_SLOTS];   /**< Arrival time stamps of the pending input blocks. */
+    QAtomicInt          m_iArrivalWrite;                /**< Arrival time stamps written. */
+    QAtomicInt          m_iArrivalRead;                 /**< Stamps consumed by beginBlock(). */
+    QAtomicInt          m_iInputs;                      /**< Input blocks. */
+    QAtomicInt          m_iProcessed;                   /**< Processed blocks. */
+    QAtomicInt          m_iOutputs;                     /**< Output blocks. */
+    QAtomicInteger<qint64>  m_iLastOutput;              /**< Time stamp of the last output block, 0 if none. */
+    qint64              m_iResetTime;                   /**< Time stamp of the last reset. */
+
+    static QAtomicInt   s_iEnabled;                     /**< Whether recording is enabled. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline void PluginHistogram::record(quint32 uiValue)
+{
+    qint32 t_iBin = uiValue == 0 ? 0 : 32 - qCountLeadingZeroBits(uiValue);
+    m_iBins[t_iBin == PLUGIN_STATISTICS_NUM_BINS ? t_iBin - 1 : t_iBin].fetchAndAddRelaxed(1);
+    m_iSum.fetchAndAddRelaxed(uiValue);
+
+    qint32 t_iMax = m_iMax.loadAcquire();
+    while((quint32)t_iMax < uiValue && !m_iMax.testAndSetRelaxed(t_iMax, (qint32)uiValue))
+        t_iMax = m_iMax.loadAcquire();
+}
+
+
+//*************************************************************************************************************
+
+inline PluginStatistics::BlockTimer::BlockTimer(PluginStatistics& statistics)
+: m_statistics(statistics)
+, m_iStart(statistics.beginBlock())
+{
+}
+
+
+//*************************************************************************************************************
+
+inline PluginStatistics::BlockTimer::~BlockTimer()
+{
+    m_statistics.endBlock(m_iStart);
+}
+
+
+//*************************************************************************************************************
+
+inline quint32 PluginStatistics::inputBlocks() const
+{
+    return (quint32)m_iInputs.loadAcquire();
+}
+
+
+//*************************************************************************************************************
+
+inline quint32 PluginStatistics::processedBlocks() const
+{
+    return (quint32)m_iProcessed.loadAcquire();
+}
+
+
+//*************************************************************************************************************
+
+inline quint32 PluginStatistics::outputBlocks() const
+{
+    return (quint32)m_iOutputs.loadAcquire();
+}
+
+
+//*************************************************************************************************************
+
+inline bool PluginStatistics::isEnabled()
+{
+    return s_iEnabled.loadAcquire() != 0;
+}
+
+} // NAMESPACE
+
+#endif // PLUGINSTATISTICS_H
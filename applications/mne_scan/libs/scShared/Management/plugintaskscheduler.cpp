@@ -0,0 +1,370 @@
+//=============================================================================================================
+/**
+* @file     plugintaskscheduler.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the PluginTaskScheduler Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "plugintaskscheduler.h"
+#include "../Interfaces/IPlugin.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QMutexLocker>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace SCSHAREDLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+PluginTaskWorker::PluginTaskWorker(PluginTaskScheduler* pScheduler, qint32 iIndex)
+: m_pScheduler(pScheduler)
+, m_iIndex(iIndex)
+{
+}
+
+
+//*************************************************************************************************************
+
+void PluginTaskWorker::run()
+{
+    while(m_pScheduler->isRunning())
+    {
+        IPlugin* t_pPlugin = popTask();
+
+        if(!t_pPlugin)
+            t_pPlugin = m_pScheduler->stealTask(this);
+
+        if(t_pPlugin)
+            m_pScheduler->executeTask(t_pPlugin, this);
+        else
+            m_pScheduler->waitForTask();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void PluginTaskWorker::pushTask(IPlugin* pPlugin)
+{
+    QMutexLocker t_locker(&m_qMutex);
+    m_qListTasks.append(pPlugin);
+}
+
+
+//*************************************************************************************************************
+
+IPlugin* PluginTaskWorker::popTask()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_qListTasks.isEmpty() ? NULL : m_qListTasks.takeLast();
+}
+
+
+//*************************************************************************************************************
+
+IPlugin* PluginTaskWorker::stealTask()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_qListTasks.isEmpty() ? NULL : m_qListTasks.takeFirst();
+}
+
+
+//*************************************************************************************************************
+
+PluginTaskScheduler::PluginTaskScheduler(QObject *parent)
+: QObject(parent)
+, m_iRunning(0)
+, m_iReadyTasks(0)
+, m_iNextWorker(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+PluginTaskScheduler::~PluginTaskScheduler()
+{
+    stop();
+}
+
+
+//*************************************************************************************************************
+
+void PluginTaskScheduler::registerPlugin(IPlugin* pPlugin)
+{
+    if(isRunning() || !pPlugin || m_qHashQueues.contains(pPlugin))
+        return;
+
+    QSharedPointer<PluginTaskQueue> t_pQueue(new PluginTaskQueue);
+    t_pQueue->bScheduled = false;
+    m_qHashQueues.insert(pPlugin, t_pQueue);
+}
+
+
+//*************************************************************************************************************
+
+void PluginTaskScheduler::unregisterAll()
+{
+    if(isRunning())
+        return;
+
+    m_qHashQueues.clear();
+}
+
+
+//*************************************************************************************************************
+
+void PluginTaskScheduler::start(qint32 iNumThreads)
+{
+    if(isRunning())
+        return;
+
+    //Posting threads read the pool, so complete it before the scheduler reports running
+    m_qLockWorkers.lockForWrite();
+    m_iReadyTasks.storeRelease(0);
+    for(qint32 i = 0; i < qMax(iNumThreads, 1); ++i)
+        m_qListWorkers.append(new PluginTaskWorker(this, i));
+    m_iRunning.storeRelease(1);
+    m_qLockWorkers.unlock();
+
+    for(qint32 i = 0; i < m_qListWorkers.size(); ++i)
+        m_qListWorkers[i]->start();
+}
+
+
+//*************************************************************************************************************
+
+void PluginTaskScheduler::stop()
+{
+    //Waits for the posts in flight, all later posts see the stopped scheduler
+    m_qLockWorkers.lockForWrite();
+    if(!isRunning())
+    {
+        m_qLockWorkers.unlock();
+        return;
+    }
+
+    m_qMutexIdle.lock();
+    m_iRunning.storeRelease(0);
+    m_qWaitIdle.wakeAll();
+    m_qMutexIdle.unlock();
+    m_qLockWorkers.unlock();
+
+    //A worker may wait for a blocking queued delivery into this thread - keep serving events while joining
+    bool t_bServeEvents = QCoreApplication::instance() && QThread::currentThread() == QCoreApplication::instance()->thread();
+
+    for(qint32 i = 0; i < m_qListWorkers.size(); ++i)
+    {
+        while(!m_qListWorkers[i]->wait(10))
+            if(t_bServeEvents)
+                QCoreApplication::processEvents();
+    }
+
+    //Workers are joined without the lock, since their tasks may post to downstream plugins
+    m_qLockWorkers.lockForWrite();
+    for(qint32 i = 0; i < m_qListWorkers.size(); ++i)
+        delete m_qListWorkers[i];
+    m_qListWorkers.clear();
+
+    //Drop pending input
+    QHash<IPlugin*, QSharedPointer<PluginTaskQueue> >::iterator it = m_qHashQueues.begin();
+    for( ; it != m_qHashQueues.end(); ++it)
+    {
+        QMutexLocker t_locker(&it.value()->mutex);
+        it.value()->blocks.clear();
+        it.value()->bufferInfo.clear();
+        it.value()->bScheduled = false;
+    }
+    m_qLockWorkers.unlock();
+}
+
+
+//*************************************************************************************************************
+
+bool PluginTaskScheduler::post(IPlugin* pPlugin, const Block& pBlock, const FIFFLIB::FiffRtBufferInfo& bufferInfo)
+{
+    if(!pBlock)
+        return false;
+
+    //The running state and the pool can't change while a block is posted
+    QReadLocker t_lockerWorkers(&m_qLockWorkers);
+    if(!isRunning())
+        return false;
+
+    QSharedPointer<PluginTaskQueue> t_pQueue = m_qHashQueues.value(pPlugin);
+    if(!t_pQueue)
+        return false;
+
+    bool t_bSchedule;
+    {
+        QMutexLocker t_locker(&t_pQueue->mutex);
+        t_pQueue->blocks.enqueue(pBlock);
+        t_pQueue->bufferInfo.enqueue(bufferInfo);
+        t_bSchedule = !t_pQueue->bScheduled;
+        t_pQueue->bScheduled = true;
+    }
+
+    //Keep the task local if it is posted by a worker, e.g. by an upstream plugin's process()
+    if(t_bSchedule)
+        enqueueTask(pPlugin, currentWorker());
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void PluginTaskScheduler::enqueueTask(IPlugin* pPlugin, PluginTaskWorker* pWorker)
+{
+    if(m_qListWorkers.isEmpty())
+        return;
+
+    if(!pWorker)
+        pWorker = m_qListWorkers[(quint32)m_iNextWorker.fetchAndAddRelaxed(1) % m_qListWorkers.size()];
+
+    pWorker->pushTask(pPlugin);
+    m_iReadyTasks.fetchAndAddOrdered(1);
+
+    QMutexLocker t_locker(&m_qMutexIdle);
+    m_qWaitIdle.wakeOne();
+}
+
+
+//*************************************************************************************************************
+
+IPlugin* PluginTaskScheduler::stealTask(PluginTaskWorker* pThief)
+{
+    if(m_iReadyTasks.loadAcquire() <= 0)
+        return NULL;
+
+    //Start with the neighbour so that the thieves spread over the pool
+    for(qint32 i = 1; i < m_qListWorkers.size(); ++i)
+    {
+        PluginTaskWorker* t_pVictim = m_qListWorkers[(pThief->m_iIndex + i) % m_qListWorkers.size()];
+        IPlugin* t_pPlugin = t_pVictim->stealTask();
+        if(t_pPlugin)
+            return t_pPlugin;
+    }
+
+    return NULL;
+}
+
+
+//*************************************************************************************************************
+
+void PluginTaskScheduler::executeTask(IPlugin* pPlugin, PluginTaskWorker* pWorker)
+{
+    m_iReadyTasks.fetchAndAddOrdered(-1);
+
+    QSharedPointer<PluginTaskQueue> t_pQueue = m_qHashQueues.value(pPlugin);
+    if(!t_pQueue)
+        return;
+
+    //Only one task per plugin exists, so the blocks of a plugin are processed in order
+    for(qint32 i = 0; i < SCHEDULER_MAX_BLOCKS_PER_TASK && isRunning(); ++i)
+    {
+        Block t_pBlock;
+        FIFFLIB::FiffRtBufferInfo t_bufferInfo;
+        {
+            QMutexLocker t_locker(&t_pQueue->mutex);
+            if(t_pQueue->blocks.isEmpty())
+            {
+                t_pQueue->bScheduled = false;
+                return;
+            }
+            t_pBlock = t_pQueue->blocks.dequeue();
+            t_bufferInfo = t_pQueue->bufferInfo.dequeue();
+        }
+
+        PluginStatistics::BlockTimer t_blockTimer(pPlugin->statistics());
+        pPlugin->process(t_pBlock, t_bufferInfo);
+    }
+
+    //More input pending -> give the other ready plugins a turn first
+    {
+        QMutexLocker t_locker(&t_pQueue->mutex);
+        if(t_pQueue->blocks.isEmpty() || !isRunning())
+        {
+            t_pQueue->bScheduled = false;
+            return;
+        }
+    }
+
+    //A stop in between resets the scheduled flag itself
+    QReadLocker t_lockerWorkers(&m_qLockWorkers);
+    if(isRunning())
+        enqueueTask(pPlugin, pWorker);
+}
+
+
+//*************************************************************************************************************
+
+void PluginTaskScheduler::waitForTask()
+{
+    QMutexLocker t_locker(&m_qMutexIdle);
+
+    //Tasks are counted before the wake up is sent under this mutex, so no wake up gets lost
+    if(m_iReadyTasks.loadAcquire() <= 0 && isRunning())
+        m_qWaitIdle.wait(&m_qMutexIdle);
+}
+
+
+//*************************************************************************************************************
+
+PluginTaskWorker* PluginTaskScheduler::currentWorker() const
+{
+    QThread* t_pThread = QThread::currentThread();
+
+    for(qint32 i = 0; i < m_qListWorkers.size(); ++i)
+        if(m_qListWorkers[i] == t_pThread)
+            return m_qListWorkers[i];
+
+    return NULL;
+}
@@ -0,0 +1,337 @@
+//=============================================================================================================
+/**
+* @file     plugintaskscheduler.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the PluginTaskScheduler Class.
+*
+*/
+
+#ifndef PLUGINTASKSCHEDULER_H
+#define PLUGINTASKSCHEDULER_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../scshared_global.h"
+
+#include <fiff/fiff_rt_buffer_info.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QObject>
+#include <QThread>
+#include <QSharedPointer>
+#include <QList>
+#include <QHash>
+#include <QQueue>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QWaitCondition>
+#include <QAtomicInt>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define SCHEDULER_MAX_BLOCKS_PER_TASK   4   /**< Blocks a plugin processes before its task goes back to the queue. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE SCSHAREDLIB
+//=============================================================================================================
+
+namespace SCSHAREDLIB
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class IPlugin;
+class PluginTaskScheduler;
+
+
+//=========================================================================================================
+/**
+* PluginTaskWorker is one thread of the PluginTaskScheduler pool. It owns a deque of ready plugin tasks,
+* takes its own tasks from the back and steals from the front of the other workers' deques when it runs dry.
+*
+* @brief Worker thread of the PluginTaskScheduler.
+*/
+class PluginTaskWorker : public QThread
+{
+    friend class PluginTaskScheduler;
+
+public:
+    //=========================================================================================================
+    /**
+    * Constructs a PluginTaskWorker.
+    *
+    * @param[in] pScheduler     the scheduler the worker belongs to.
+    * @param[in] iIndex         index of the worker in the pool.
+    */
+    PluginTaskWorker(PluginTaskScheduler* pScheduler, qint32 iIndex);
+
+protected:
+    //=========================================================================================================
+    /**
+    * Runs tasks until the scheduler is stopped. Sleeps while no task is ready.
+    */
+    virtual void run();
+
+private:
+    //=========================================================================================================
+    /**
+    * Appends a ready task to the deque of this worker.
+    *
+    * @param[in] pPlugin    the plugin which has input pending.
+    */
+    void pushTask(IPlugin* pPlugin);
+
+    //=========================================================================================================
+    /**
+    * Takes the newest task of this worker.
+    *
+    * @return the plugin to process, NULL if the deque is empty.
+    */
+    IPlugin* popTask();
+
+    //=========================================================================================================
+    /**
+    * Takes the oldest task of this worker - called by the other workers.
+    *
+    * @return the plugin to process, NULL if the deque is empty.
+    */
+    IPlugin* stealTask();
+
+    PluginTaskScheduler*    m_pScheduler;   /**< The scheduler the worker belongs to. */
+    qint32                  m_iIndex;       /**< Index of the worker in the pool. */
+    QMutex                  m_qMutex;       /**< Guards the task deque. */
+    QList<IPlugin*>         m_qListTasks;   /**< The ready tasks of this worker. */
+};
+
+
+//=========================================================================================================
+/**
+* PluginTaskScheduler executes the process() callbacks of plugins on a shared work-stealing thread pool instead
+* of one thread per plugin. A plugin posts the blocks it receives; the plugin is scheduled as soon as input is
+* pending and its blocks are processed in order, one task per plugin at a time. Different plugins, e.g.
+* independent branches of the plugin graph, run in parallel. Idle workers sleep without consuming CPU time.
+*
+* @brief Work-stealing scheduler for plugin processing.
+*/
+class SCSHAREDSHARED_EXPORT PluginTaskScheduler : public QObject
+{
+    Q_OBJECT
+
+    friend class PluginTaskWorker;
+
+public:
+    typedef QSharedPointer<PluginTaskScheduler> SPtr;               /**< Shared pointer type for PluginTaskScheduler. */
+    typedef QSharedPointer<const PluginTaskScheduler> ConstSPtr;    /**< Const shared pointer type for PluginTaskScheduler. */
+
+    typedef QSharedPointer<const Eigen::MatrixXd> Block;            /**< A shared, immutable data block. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a PluginTaskScheduler.
+    *
+    * @param[in] parent     parent of the object.
+    */
+    explicit PluginTaskScheduler(QObject *parent = 0);
+
+    //=========================================================================================================
+    /**
+    * Destroys the PluginTaskScheduler and stops the workers.
+    */
+    ~PluginTaskScheduler();
+
+    //=========================================================================================================
+    /**
+    * Registers a plugin. Only registered plugins can post blocks. Must not be called while running.
+    *
+    * @param[in] pPlugin    the plugin to register.
+    */
+    void registerPlugin(IPlugin* pPlugin);
+
+    //=========================================================================================================
+    /**
+    * Removes all registered plugins. Must not be called while running.
+    */
+    void unregisterAll();
+
+    //=========================================================================================================
+    /**
+    * Starts the worker threads.
+    *
+    * @param[in] iNumThreads    number of workers, defaults to the number of cores.
+    */
+    void start(qint32 iNumThreads = QThread::idealThreadCount());
+
+    //=========================================================================================================
+    /**
+    * Stops the worker threads after their current task. Blocks which are still pending are dropped. Upstream
+    * threads may keep posting meanwhile, their blocks are rejected once the scheduler stops.
+    */
+    void stop();
+
+    //=========================================================================================================
+    /**
+    * Queues a block for the plugin and schedules the plugin if it is idle. May be called from any thread.
+    *
+    * @param[in] pPlugin        the registered plugin.
+    * @param[in] pBlock         the block to process.
+    * @param[in] bufferInfo     the acquisition information of the block, handed to process() with it.
+    *
+    * @return true if the block was queued, false if the scheduler isn't running or the plugin isn't registered.
+    */
+    bool post(IPlugin* pPlugin, const Block& pBlock, const FIFFLIB::FiffRtBufferInfo& bufferInfo = FIFFLIB::FiffRtBufferInfo());
+
+    //=========================================================================================================
+    /**
+    * Returns whether the workers are running.
+    *
+    * @return true if running.
+    */
+    inline bool isRunning() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of worker threads.
+    *
+    * @return the number of workers.
+    */
+    inline qint32 numThreads() const;
+
+private:
+    /**
+    * The pending input of one plugin.
+    */
+    struct PluginTaskQueue {
+        QMutex          mutex;          /**< Guards the queue. */
+        QQueue<Block>   blocks;         /**< The pending blocks. */
+        QQueue<FIFFLIB::FiffRtBufferInfo> bufferInfo;   /**< The acquisition information of the pending blocks. */
+        bool            bScheduled;     /**< Whether a task of the plugin is queued or running. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Puts the task of a plugin into a worker deque and wakes an idle worker. The caller has to hold
+    * m_qLockWorkers for reading and has to have checked that the scheduler is running.
+    *
+    * @param[in] pPlugin    the plugin to schedule.
+    * @param[in] pWorker    the preferred worker, NULL distributes the tasks round-robin.
+    */
+    void enqueueTask(IPlugin* pPlugin, PluginTaskWorker* pWorker);
+
+    //=========================================================================================================
+    /**
+    * Takes a task of another worker.
+    *
+    * @param[in] pThief     the worker which looks for work.
+    *
+    * @return the plugin to process, NULL if all deques are empty.
+    */
+    IPlugin* stealTask(PluginTaskWorker* pThief);
+
+    //=========================================================================================================
+    /**
+    * Processes pending blocks of a plugin and reschedules it if more input is pending.
+    *
+    * @param[in] pPlugin    the plugin to process.
+    * @param[in] pWorker    the executing worker.
+    */
+    void executeTask(IPlugin* pPlugin, PluginTaskWorker* pWorker);
+
+    //=========================================================================================================
+    /**
+    * Puts the calling worker to sleep until a task is ready or the scheduler stops.
+    */
+    void waitForTask();
+
+    //=========================================================================================================
+    /**
+    * Returns the worker which runs the calling thread.
+    *
+    * @return the worker, NULL if the caller isn't a worker.
+    */
+    PluginTaskWorker* currentWorker() const;
+
+    QHash<IPlugin*, QSharedPointer<PluginTaskQueue> >   m_qHashQueues;      /**< The pending input per registered plugin. */
+    QList<PluginTaskWorker*>                            m_qListWorkers;     /**< The worker pool. */
+    QReadWriteLock  m_qLockWorkers;     /**< Read locked while a task is enqueued, write locked while the pool and the running state change. */
+
+    QAtomicInt      m_iRunning;         /**< Whether the workers are running. */
+    QAtomicInt      m_iReadyTasks;      /**< Number of tasks in the worker deques. */
+    QAtomicInt      m_iNextWorker;      /**< Round-robin index for tasks posted from outside the pool. */
+    QMutex          m_qMutexIdle;       /**< Guards the idle wait condition. */
+    QWaitCondition  m_qWaitIdle;        /**< Wakes sleeping workers. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline bool PluginTaskScheduler::isRunning() const
+{
+    return m_iRunning.loadAcquire() != 0;
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 PluginTaskScheduler::numThreads() const
+{
+    return m_qListWorkers.size();
+}
+
+} // NAMESPACE
+
+#endif // PLUGINTASKSCHEDULER_H
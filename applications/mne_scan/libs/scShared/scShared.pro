@@ -92,6 +92,9 @@ SOURCES += \
     Management/pluginconnectorconnection.cpp \
     Management/pluginconnectorconnectionwidget.cpp \
     Management/pluginscenemanager.cpp \
+    Management/plugintaskscheduler.cpp \
+    Management/pluginstatistics.cpp \
+    Management/blockcoalescer.cpp \
     Management/displaymanager.cpp
 
 HEADERS += \
@@ -109,6 +112,9 @@ HEADERS += \
     Management/pluginconnectorconnection.h \
     Management/pluginconnectorconnectionwidget.h \
     Management/pluginscenemanager.h \
+    Management/plugintaskscheduler.h \
+    Management/pluginstatistics.h \
+    Management/blockcoalescer.h \
     Management/displaymanager.h
 
 
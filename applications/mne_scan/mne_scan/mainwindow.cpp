@@ -47,6 +47,7 @@
 #include "runwidget.h"
 #include "startupwidget.h"
 #include "plugingui.h"
+#include "pluginstatisticswidget.h"
 
 
 //*************************************************************************************************************
@@ -123,6 +124,7 @@ MainWindow::MainWindow(QWidget *parent)
     createToolBars();
     createPluginDockWindow();
     createLogDockWindow();
+    createStatisticsDockWindow();
 
 //    //ToDo Debug Startup
 //    writeToLog(tr("Test normal message, Max"), _LogKndMessage, _LogLvMax);
@@ -216,6 +218,26 @@ void MainWindow::saveConfiguration()
 }
 
 
+//*************************************************************************************************************
+
+void MainWindow::saveStatistics()
+{
+    writeToLog(tr("Invoked <b>File|SaveStatistics</b>"), _LogKndMessage, _LogLvMin);
+
+    QString path = QFileDialog::getSaveFileName(
+                this,
+                "Save MNE Scan Plugin Statistics",
+                QStandardPaths::writableLocation(QStandardPaths::DataLocation),
+                 tr("CSV file (*.csv);;JSON file (*.json)"));
+
+    if(path.isEmpty())
+        return;
+
+    if(!m_pPluginSceneManager->saveStatistics(path))
+        writeToLog(tr("Could not save plugin statistics to %1").arg(path), _LogKndError, _LogLvMin);
+}
+
+
 //*************************************************************************************************************
 //Help QMenu
 void MainWindow::helpContents()
@@ -343,6 +365,15 @@ void MainWindow::setMaxLogLevel()
     m_eLogLevelCurrent = _LogLvMax;
 }
 
+
+//*************************************************************************************************************
+
+void MainWindow::setScheduledExecution(bool state)
+{
+    m_pPluginSceneManager->setExecutionMode(state ? SCSHAREDLIB::PluginSceneManager::_Scheduled : SCSHAREDLIB::PluginSceneManager::_ThreadPerPlugin);
+    writeToLog(state ? tr("scheduled plugin execution set") : tr("thread per plugin execution set"), _LogKndMessage, _LogLvNormal);
+}
+
 //*************************************************************************************************************
 
 void MainWindow::createActions()
@@ -363,6 +394,10 @@ void MainWindow::createActions()
     m_pActionSaveConfig->setStatusTip(tr("Save the current configuration"));
     connect(m_pActionSaveConfig, &QAction::triggered, this, &MainWindow::saveConfiguration);
 
+    m_pActionSaveStatistics = new QAction(tr("Save plugin s&tatistics..."), this);
+    m_pActionSaveStatistics->setStatusTip(tr("Save the latency and throughput statistics of the plugins"));
+    connect(m_pActionSaveStatistics, &QAction::triggered, this, &MainWindow::saveStatistics);
+
     m_pActionExit = new QAction(tr("E&xit"), this);
     m_pActionExit->setShortcuts(QKeySequence::Quit);
     m_pActionExit->setStatusTip(tr("Exit the application"));
@@ -398,6 +433,12 @@ void MainWindow::createActions()
     else {
         m_pActionMaxLgLv->setChecked(true);}
 
+    m_pActionScheduled = new QAction(tr("&Scheduled Plugin Execution"), this);
+    m_pActionScheduled->setCheckable(true);
+    m_pActionScheduled->setChecked(m_pPluginSceneManager->getExecutionMode() == SCSHAREDLIB::PluginSceneManager::_Scheduled);
+    m_pActionScheduled->setStatusTip(tr("Process supporting plugins on a shared thread pool instead of one thread per plugin"));
+    connect(m_pActionScheduled, &QAction::toggled, this, &MainWindow::setScheduledExecution);
+
     //Help QMenu
     m_pActionHelpContents = new QAction(tr("Help &Contents"), this);
     m_pActionHelpContents->setShortcuts(QKeySequence::HelpContents);
@@ -449,6 +490,7 @@ void MainWindow::createMenus()
     m_pMenuFile->addAction(m_pActionNewConfig);
     m_pMenuFile->addAction(m_pActionOpenConfig);
     m_pMenuFile->addAction(m_pActionSaveConfig);
+    m_pMenuFile->addAction(m_pActionSaveStatistics);
     m_pMenuFile->addSeparator();
     m_pMenuFile->addAction(m_pActionExit);
 
@@ -457,6 +499,7 @@ void MainWindow::createMenus()
     m_pMenuLgLv->addAction(m_pActionMinLgLv);
     m_pMenuLgLv->addAction(m_pActionNormLgLv);
     m_pMenuLgLv->addAction(m_pActionMaxLgLv);
+    m_pMenuView->addAction(m_pActionScheduled);
     m_pMenuView->addSeparator();
 
     menuBar()->addSeparator();
@@ -585,6 +628,23 @@ void MainWindow::createLogDockWindow()
 }
 
 
+//*************************************************************************************************************
+
+void MainWindow::createStatisticsDockWindow()
+{
+    m_pDockWidget_Statistics = new QDockWidget(tr("Plugin Statistics"), this);
+
+    m_pDockWidget_Statistics->setWidget(new PluginStatisticsWidget(m_pPluginSceneManager.data(), m_pDockWidget_Statistics));
+
+    m_pDockWidget_Statistics->setAllowedAreas(Qt::BottomDockWidgetArea);
+    addDockWidget(Qt::BottomDockWidgetArea, m_pDockWidget_Statistics);
+
+    m_pDockWidget_Statistics->hide();
+
+    m_pMenuView->addAction(m_pDockWidget_Statistics->toggleViewAction());
+}
+
+
 //*************************************************************************************************************
 //Plugin stuff
 void MainWindow::updatePluginWidget(SCSHAREDLIB::IPlugin::SPtr pPlugin)
@@ -788,6 +848,7 @@ void MainWindow::uiSetupRunningState(bool state)
 {
     m_pActionRun->setEnabled(!state);
     m_pActionStop->setEnabled(state);
+    m_pActionScheduled->setEnabled(!state);
 
     if(state)
     {
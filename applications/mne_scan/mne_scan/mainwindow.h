@@ -205,6 +205,7 @@ private:
     QAction*                            m_pActionNewConfig;         /**< new configuration */
     QAction*                            m_pActionOpenConfig;        /**< open configuration */
     QAction*                            m_pActionSaveConfig;        /**< save configuration */
+    QAction*                            m_pActionSaveStatistics;    /**< save plugin statistics */
     QAction*                            m_pActionExit;              /**< exit application */
 
     QActionGroup*                       m_pActionGroupLgLv;         /**< group log level */
@@ -212,6 +213,8 @@ private:
     QAction*                            m_pActionNormLgLv;          /**< set normal log level */
     QAction*                            m_pActionMaxLgLv;           /**< set maximal log level */
 
+    QAction*                            m_pActionScheduled;         /**< toggle scheduled plugin execution */
+
     QAction*                            m_pActionHelpContents;      /**< open help contents */
     QAction*                            m_pActionAbout;             /**< show about dialog */
 
@@ -245,6 +248,7 @@ private:
 
     void createPluginDockWindow();                          /**< Creates plugin dock widget.*/
     void createLogDockWindow();                             /**< Creates log dock widget.*/
+    void createStatisticsDockWindow();                      /**< Creates plugin statistics dock widget.*/
 
     //Plugin Management
     QDockWidget*                        m_pPluginGuiDockWidget;         /**< Dock widget which holds the plugin gui. */
@@ -258,6 +262,9 @@ private:
 
     LogLevel                            m_eLogLevelCurrent;             /**< Holds the current log level.*/
 
+    //Statistics
+    QDockWidget*                        m_pDockWidget_Statistics;       /**< Holds the dock widget containing the plugin statistics.*/
+
     QSharedPointer<QWidget>             m_pAboutWindow;                 /**< Holds the widget containing the about information.*/
 
     void updatePluginWidget(QSharedPointer<SCSHAREDLIB::IPlugin> pPlugin);                           /**< Sets the plugin widget to central widget of MainWindow class depending on the current plugin selected in m_pDockWidgetPlugins.*/
@@ -269,6 +276,7 @@ private:
     void newConfiguration();            /**< Implements new configuration tasks.*/
     void openConfiguration();           /**< Implements open configuration tasks.*/
     void saveConfiguration();           /**< Implements save configuration tasks.*/
+    void saveStatistics();              /**< Writes the plugin statistics to a CSV or JSON file.*/
 
     void helpContents();                /**< Implements help contents action.*/
 
@@ -278,6 +286,8 @@ private:
     void setNormalLogLevel();           /**< Sets normal log level as current log level.*/
     void setMaxLogLevel();              /**< Sets maximal log level as current log level.*/
 
+    void setScheduledExecution(bool state); /**< Switches between the shared task scheduler and one thread per plugin.*/
+
     void startMeasurement();            /**< Runs application.*/
     void stopMeasurement();             /**< Stops application.*/
 
@@ -97,6 +97,7 @@ SOURCES += \
     pluginscene.cpp \
     pluginitem.cpp \
     plugingui.cpp \
+    pluginstatisticswidget.cpp \
     arrow.cpp
 
 HEADERS += \
@@ -108,6 +109,7 @@ HEADERS += \
     pluginscene.h \
     pluginitem.h \
     plugingui.h \
+    pluginstatisticswidget.h \
     arrow.h
 
 FORMS +=
@@ -0,0 +1,172 @@
+//=============================================================================================================
+/**
+* @file     pluginstatisticswidget.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains implementation of PluginStatisticsWidget class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "pluginstatisticswidget.h"
+
+#include <scShared/Management/pluginscenemanager.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QTimer>
+#include <QVBoxLayout>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNESCAN;
+using namespace SCSHAREDLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+PluginStatisticsWidget::PluginStatisticsWidget(PluginSceneManager* pPluginSceneManager, QWidget *parent)
+: QWidget(parent)
+, m_pPluginSceneManager(pPluginSceneManager)
+{
+    QStringList t_qListHeader;
+    t_qListHeader << tr("Plugin") << tr("In") << tr("Out/s")
+                  << tr("Proc. mean [us]") << tr("Proc. p95 [us]") << tr("Proc. max [us]")
+                  << tr("Wait mean [us]") << tr("Wait p95 [us]")
+                  << tr("Queue mean") << tr("Queue max")
+                  << tr("Latency p50 [us]") << tr("Latency p95 [us]");
+
+    m_pTableWidget = new QTableWidget(0, t_qListHeader.size(), this);
+    m_pTableWidget->setHorizontalHeaderLabels(t_qListHeader);
+    m_pTableWidget->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_pTableWidget->verticalHeader()->hide();
+    m_pTableWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+    QVBoxLayout *layout = new QVBoxLayout;
+    layout->setMargin(0);
+    layout->addWidget(m_pTableWidget);
+    this->setLayout(layout);
+
+    m_pTimer = new QTimer(this);
+    connect(m_pTimer, &QTimer::timeout, this, &PluginStatisticsWidget::refresh);
+}
+
+
+//*************************************************************************************************************
+
+PluginStatisticsWidget::~PluginStatisticsWidget()
+{
+
+}
+
+
+//*************************************************************************************************************
+
+void PluginStatisticsWidget::showEvent(QShowEvent* event)
+{
+    refresh();
+    m_pTimer->start(1000);
+
+    QWidget::showEvent(event);
+}
+
+
+//*************************************************************************************************************
+
+void PluginStatisticsWidget::hideEvent(QHideEvent* event)
+{
+    m_pTimer->stop();
+
+    QWidget::hideEvent(event);
+}
+
+
+//*************************************************************************************************************
+
+void PluginStatisticsWidget::refresh()
+{
+    const PluginSceneManager::PluginList& t_pluginList = m_pPluginSceneManager->getPlugins();
+
+    m_pTableWidget->setRowCount(t_pluginList.size());
+
+    for(qint32 i = 0; i < t_pluginList.size(); ++i)
+    {
+        const PluginStatistics& t_statistics = t_pluginList[i]->statistics();
+
+        PluginHistogram::Snapshot t_proc = t_statistics.histogram(PluginStatistics::_ProcessingTime);
+        PluginHistogram::Snapshot t_wait = t_statistics.histogram(PluginStatistics::_InputWaitTime);
+        PluginHistogram::Snapshot t_queue = t_statistics.histogram(PluginStatistics::_InputQueueDepth);
+        PluginHistogram::Snapshot t_latency = t_statistics.histogram(PluginStatistics::_Latency);
+
+        //Plugins which don't mark their blocks have no processing statistics, sources have no latency
+        bool t_bTimed = t_proc.count > 0;
+        bool t_bStamped = t_latency.count > 0;
+
+        QStringList t_qListValues;
+        t_qListValues << t_pluginList[i]->getName()
+                      << QString::number(t_statistics.inputBlocks())
+                      << QString::number(t_statistics.outputRate(), 'f', 1)
+                      << (t_bTimed ? QString::number(t_proc.mean(), 'f', 0) : "-")
+                      << (t_bTimed ? QString::number(t_proc.percentile(95)) : "-")
+                      << (t_bTimed ? QString::number(t_proc.max) : "-")
+                      << (t_bTimed ? QString::number(t_wait.mean(), 'f', 0) : "-")
+                      << (t_bTimed ? QString::number(t_wait.percentile(95)) : "-")
+                      << (t_bTimed ? QString::number(t_queue.mean(), 'f', 1) : "-")
+                      << (t_bTimed ? QString::number(t_queue.max) : "-")
+                      << (t_bStamped ? QString::number(t_latency.percentile(50)) : "-")
+                      << (t_bStamped ? QString::number(t_latency.percentile(95)) : "-");
+
+        for(qint32 j = 0; j < t_qListValues.size(); ++j)
+        {
+            QTableWidgetItem* t_pItem = m_pTableWidget->item(i, j);
+            if(!t_pItem)
+            {
+                t_pItem = new QTableWidgetItem;
+                m_pTableWidget->setItem(i, j, t_pItem);
+            }
+            t_pItem->setText(t_qListValues[j]);
+        }
+    }
+}
@@ -0,0 +1,120 @@
+//=============================================================================================================
+/**
+* @file     pluginstatisticswidget.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains declaration of PluginStatisticsWidget class.
+*
+*/
+
+#ifndef PLUGINSTATISTICSWIDGET_H
+#define PLUGINSTATISTICSWIDGET_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QWidget>
+#include <QSharedPointer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class QTableWidget;
+class QTimer;
+
+namespace SCSHAREDLIB
+{
+class PluginSceneManager;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE MNESCAN
+//=============================================================================================================
+
+namespace MNESCAN
+{
+
+//=============================================================================================================
+/**
+* DECLARE CLASS PluginStatisticsWidget
+*
+* @brief The PluginStatisticsWidget class shows the live latency, throughput and queue depth of the plugins.
+*/
+class PluginStatisticsWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    typedef QSharedPointer<PluginStatisticsWidget> SPtr;               /**< Shared pointer type for PluginStatisticsWidget. */
+    typedef QSharedPointer<const PluginStatisticsWidget> ConstSPtr;    /**< Const shared pointer type for PluginStatisticsWidget. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a PluginStatisticsWidget which is a child of parent.
+    *
+    * @param [in] pPluginSceneManager   the scene manager which holds the plugins.
+    * @param [in] parent                pointer to parent widget.
+    */
+    PluginStatisticsWidget(SCSHAREDLIB::PluginSceneManager* pPluginSceneManager, QWidget *parent = 0);
+
+    //=========================================================================================================
+    /**
+    * Destroys the PluginStatisticsWidget.
+    */
+    ~PluginStatisticsWidget();
+
+protected:
+    //=========================================================================================================
+    /**
+    * Refreshes the table only while the widget is visible.
+    */
+    virtual void showEvent(QShowEvent* event);
+    virtual void hideEvent(QHideEvent* event);
+
+private:
+    //=========================================================================================================
+    /**
+    * Reads the statistics of all plugins into the table.
+    */
+    void refresh();
+
+    SCSHAREDLIB::PluginSceneManager*    m_pPluginSceneManager;  /**< The scene manager which holds the plugins. */
+    QTableWidget*                       m_pTableWidget;         /**< The statistics table. */
+    QTimer*                             m_pTimer;               /**< Refresh timer. */
+};
+
+}//NAMESPACE
+
+#endif // PLUGINSTATISTICSWIDGET_H
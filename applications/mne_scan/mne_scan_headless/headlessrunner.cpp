@@ -0,0 +1,304 @@
+//=============================================================================================================
+/**
+* @file     headlessrunner.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains implementation of HeadlessRunner class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "headlessrunner.h"
+
+#include <scShared/Interfaces/IPlugin.h>
+#include <scShared/Management/pluginoutputconnector.h>
+#include <scMeas/newrealtimemultisamplearray.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSettings>
+#include <QTextStream>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNESCANHEADLESS;
+using namespace SCSHAREDLIB;
+using namespace SCMEASLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+HeadlessRunner::HeadlessRunner(const QString& sPluginDir, QObject *parent)
+: QObject(parent)
+, m_pPluginManager(new PluginManager)
+, m_pPluginSceneManager(new PluginSceneManager)
+, m_iElapsedMsec(0)
+, m_iNumSamples(0)
+, m_iSamples(0)
+, m_iStopRequested(0)
+, m_bIsRunning(false)
+{
+    m_pPluginManager->loadPlugins(sPluginDir);
+
+    m_qTimerDuration.setSingleShot(true);
+    connect(&m_qTimerDuration, &QTimer::timeout, this, &HeadlessRunner::stop);
+
+    connect(this, &HeadlessRunner::stopRequested, this, &HeadlessRunner::stop, Qt::QueuedConnection);
+}
+
+
+//*************************************************************************************************************
+
+HeadlessRunner::~HeadlessRunner()
+{
+    if(m_bIsRunning)
+        stop();
+
+    m_qListConnections.clear();
+}
+
+
+//*************************************************************************************************************
+
+bool HeadlessRunner::build(const PipelineDescription& description)
+{
+    QMap<QString, IPlugin::SPtr> t_qMapPlugins;
+
+    //
+    // Plugins - the settings have to be in place before init() reads them
+    //
+    QSettings t_settings;
+    for(qint32 i = 0; i < description.plugins.size(); ++i)
+    {
+        const PipelinePlugin& t_plugin = description.plugins[i];
+
+        qint32 t_iIdx = m_pPluginManager->findByName(t_plugin.sName);
+        if(t_iIdx < 0)
+        {
+            qWarning() << "Plugin" << t_plugin.sName << "not found";
+            return false;
+        }
+
+        QVariantMap::const_iterator it = t_plugin.settings.constBegin();
+        for( ; it != t_plugin.settings.constEnd(); ++it)
+            t_settings.setValue(it.key(), it.value());
+        t_settings.sync();
+
+        IPlugin::SPtr t_pAddedPlugin;
+        if(!m_pPluginSceneManager->addPlugin(m_pPluginManager->getPlugins()[t_iIdx], t_pAddedPlugin))
+        {
+            qWarning() << "Plugin" << t_plugin.sName << "can't be instantiated twice";
+            return false;
+        }
+
+        t_qMapPlugins.insert(t_plugin.sId, t_pAddedPlugin);
+    }
+
+    //
+    // Connections
+    //
+    for(qint32 i = 0; i < description.connections.size(); ++i)
+    {
+        const PipelineConnection& t_connection = description.connections[i];
+
+        PluginConnectorConnection::SPtr t_pConnection = PluginConnectorConnection::create(t_qMapPlugins[t_connection.sSender], t_qMapPlugins[t_connection.sReceiver]);
+        if(!t_pConnection->isConnected())
+        {
+            qWarning() << "No matching connectors for" << t_connection.sSender << "->" << t_connection.sReceiver;
+            return false;
+        }
+
+        m_qListConnections.append(t_pConnection);
+    }
+
+    m_iNumSamples = description.iNumSamples;
+
+    if(description.iDurationMsec > 0)
+        m_qTimerDuration.setInterval((int)description.iDurationMsec);
+
+    m_pPluginSceneManager->setExecutionMode(description.bScheduled ? PluginSceneManager::_Scheduled : PluginSceneManager::_ThreadPerPlugin);
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool HeadlessRunner::start()
+{
+    if(m_bIsRunning)
+        return true;
+
+    m_iSamples.storeRelease(0);
+    m_iStopRequested.storeRelease(0);
+
+    //Count the sensor samples
+    PluginSceneManager::PluginList& t_pluginList = m_pPluginSceneManager->getPlugins();
+    for(qint32 i = 0; i < t_pluginList.size(); ++i)
+    {
+        if(t_pluginList[i]->getType() != IPlugin::_ISensor)
+            continue;
+
+        IPlugin::OutputConnectorList& t_outputList = t_pluginList[i]->getOutputConnectors();
+        for(qint32 j = 0; j < t_outputList.size(); ++j)
+            m_qListSampleCounters.append(connect(t_outputList[j].data(), &PluginOutputConnector::notify, this, &HeadlessRunner::countSamples, Qt::DirectConnection));
+    }
+
+    m_qElapsedTimer.start();
+
+    if(!m_pPluginSceneManager->startPlugins())
+    {
+        for(qint32 i = 0; i < m_qListSampleCounters.size(); ++i)
+            disconnect(m_qListSampleCounters[i]);
+        m_qListSampleCounters.clear();
+        return false;
+    }
+
+    m_bIsRunning = true;
+
+    if(m_qTimerDuration.interval() > 0)
+        m_qTimerDuration.start();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void HeadlessRunner::stop()
+{
+    if(!m_bIsRunning)
+        return;
+
+    m_qTimerDuration.stop();
+
+    m_pPluginSceneManager->stopPlugins();
+    m_iElapsedMsec = m_qElapsedTimer.elapsed();
+
+    for(qint32 i = 0; i < m_qListSampleCounters.size(); ++i)
+        disconnect(m_qListSampleCounters[i]);
+    m_qListSampleCounters.clear();
+
+    m_bIsRunning = false;
+
+    printStatistics();
+
+    emit finished();
+}
+
+
+//*************************************************************************************************************
+
+bool HeadlessRunner::saveStatistics(const QString& sFileName) const
+{
+    return m_pPluginSceneManager->saveStatistics(sFileName);
+}
+
+
+//*************************************************************************************************************
+
+void HeadlessRunner::countSamples(NewMeasurement::SPtr pMeasurement)
+{
+    QSharedPointer<NewRealTimeMultiSampleArray> pRTMSA = pMeasurement.dynamicCast<NewRealTimeMultiSampleArray>();
+    if(!pRTMSA)
+        return;
+
+    QList<NewRealTimeMultiSampleArray::ConstMatrixPtr> t_qListBlocks = pRTMSA->getMultiSampleBlocks();
+
+    qint32 t_iSamples = 0;
+    for(qint32 i = 0; i < t_qListBlocks.size(); ++i)
+        t_iSamples += t_qListBlocks[i]->cols();
+
+    qint32 t_iTotal = m_iSamples.fetchAndAddOrdered(t_iSamples) + t_iSamples;
+
+    if(m_iNumSamples > 0 && t_iTotal >= m_iNumSamples && m_iStopRequested.testAndSetOrdered(0, 1))
+        emit stopRequested();
+}
+
+
+//*************************************************************************************************************
+
+void HeadlessRunner::printStatistics() const
+{
+    QTextStream t_out(stdout);
+
+    double t_dSeconds = (double)m_iElapsedMsec / 1000.0;
+    qint32 t_iSamples = m_iSamples.loadAcquire();
+
+    t_out << "Run time: " << QString::number(t_dSeconds, 'f', 3) << " s, sensor samples: " << t_iSamples
+          << " (" << QString::number(t_dSeconds > 0 ? (double)t_iSamples / t_dSeconds : 0.0, 'f', 1) << " samples/s)\n\n";
+
+    t_out << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9 %10 %11\n")
+             .arg("Plugin", -28).arg("In", 8).arg("Out/s", 9)
+             .arg("Proc.mean", 11).arg("Proc.p95", 10).arg("Proc.max", 10)
+             .arg("Wait.mean", 11).arg("Wait.p95", 10).arg("Queue.max", 10)
+             .arg("Lat.p50", 10).arg("Lat.p95", 10);
+
+    const PluginSceneManager::PluginList& t_pluginList = m_pPluginSceneManager->getPlugins();
+    for(qint32 i = 0; i < t_pluginList.size(); ++i)
+    {
+        const PluginStatistics& t_statistics = t_pluginList[i]->statistics();
+
+        PluginHistogram::Snapshot t_proc = t_statistics.histogram(PluginStatistics::_ProcessingTime);
+        PluginHistogram::Snapshot t_wait = t_statistics.histogram(PluginStatistics::_InputWaitTime);
+        PluginHistogram::Snapshot t_queue = t_statistics.histogram(PluginStatistics::_InputQueueDepth);
+        PluginHistogram::Snapshot t_latency = t_statistics.histogram(PluginStatistics::_Latency);
+
+        t_out << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9 %10 %11\n")
+                 .arg(t_pluginList[i]->getName().left(28), -28)
+                 .arg(t_statistics.inputBlocks(), 8)
+                 .arg(t_statistics.outputRate(), 9, 'f', 1)
+                 .arg(t_proc.mean(), 11, 'f', 1)
+                 .arg(t_proc.percentile(95), 10)
+                 .arg(t_proc.max, 10)
+                 .arg(t_wait.mean(), 11, 'f', 1)
+                 .arg(t_wait.percentile(95), 10)
+                 .arg(t_queue.max, 10)
+                 .arg(t_latency.percentile(50), 10)
+                 .arg(t_latency.percentile(95), 10);
+    }
+
+    t_out << "\nTimes in microseconds, the latency is measured from acquisition to the plugin input.\n";
+    t_out.flush();
+}
@@ -0,0 +1,177 @@
+//=============================================================================================================
+/**
+* @file     headlessrunner.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains declaration of HeadlessRunner class.
+*
+*/
+
+#ifndef HEADLESSRUNNER_H
+#define HEADLESSRUNNER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "pipelinedescription.h"
+
+#include <scShared/Management/pluginmanager.h>
+#include <scShared/Management/pluginscenemanager.h>
+#include <scShared/Management/pluginconnectorconnection.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QTimer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE MNESCANHEADLESS
+//=============================================================================================================
+
+namespace MNESCANHEADLESS
+{
+
+//=============================================================================================================
+/**
+* DECLARE CLASS HeadlessRunner
+*
+* @brief The HeadlessRunner class builds a plugin pipeline from a PipelineDescription, runs it for a fixed time or
+* sample count and prints the statistics of all plugins.
+*/
+class HeadlessRunner : public QObject
+{
+    Q_OBJECT
+public:
+    //=========================================================================================================
+    /**
+    * Constructs a HeadlessRunner.
+    *
+    * @param [in] sPluginDir    directory of the mne_scan plugins.
+    * @param [in] parent        parent of the object.
+    */
+    explicit HeadlessRunner(const QString& sPluginDir, QObject *parent = 0);
+
+    //=========================================================================================================
+    /**
+    * Destroys the HeadlessRunner and stops the pipeline.
+    */
+    ~HeadlessRunner();
+
+    //=========================================================================================================
+    /**
+    * Creates the plugins and connections of the pipeline.
+    *
+    * @param [in] description   the pipeline.
+    *
+    * @return true if all plugins and connections were created.
+    */
+    bool build(const PipelineDescription& description);
+
+    //=========================================================================================================
+    /**
+    * Starts the pipeline. The runner stops when the duration or the sample count of the description is reached
+    * and emits finished().
+    *
+    * @return true if at least one sensor plugin started.
+    */
+    bool start();
+
+    //=========================================================================================================
+    /**
+    * Stops the pipeline and prints the statistics.
+    */
+    void stop();
+
+    //=========================================================================================================
+    /**
+    * Writes the statistics of the last run to a CSV or JSON file.
+    *
+    * @param [in] sFileName     the file to write.
+    *
+    * @return true if the file was written.
+    */
+    bool saveStatistics(const QString& sFileName) const;
+
+signals:
+    //=========================================================================================================
+    /**
+    * Emitted after the pipeline stopped.
+    */
+    void finished();
+
+    //=========================================================================================================
+    /**
+    * Emitted from a sensor thread when the sample limit is reached. Queued to stop().
+    */
+    void stopRequested();
+
+private:
+    //=========================================================================================================
+    /**
+    * Counts the samples of a sensor output and stops the run when the sample limit is reached.
+    * Called from the sensor threads.
+    *
+    * @param [in] pMeasurement  the sensor output.
+    */
+    void countSamples(SCMEASLIB::NewMeasurement::SPtr pMeasurement);
+
+    //=========================================================================================================
+    /**
+    * Prints the statistics table to stdout.
+    */
+    void printStatistics() const;
+
+    QSharedPointer<SCSHAREDLIB::PluginManager>          m_pPluginManager;       /**< Loads the plugins. */
+    QSharedPointer<SCSHAREDLIB::PluginSceneManager>     m_pPluginSceneManager;  /**< Holds the plugin graph. */
+    QList<SCSHAREDLIB::PluginConnectorConnection::SPtr> m_qListConnections;     /**< The connections of the graph. */
+    QList<QMetaObject::Connection>                      m_qListSampleCounters;  /**< Connections to the sensor outputs. */
+
+    QTimer          m_qTimerDuration;   /**< Ends a run with limited duration. */
+    QElapsedTimer   m_qElapsedTimer;    /**< Measures the run time. */
+    qint64          m_iElapsedMsec;     /**< Run time of the last run. */
+    qint64          m_iNumSamples;      /**< Sample limit, 0 if not limited. */
+    QAtomicInt      m_iSamples;         /**< Sensor samples of the current run. */
+    QAtomicInt      m_iStopRequested;   /**< Whether the sample limit already requested the stop. */
+    bool            m_bIsRunning;       /**< Whether the pipeline runs. */
+};
+
+}//NAMESPACE
+
+#endif // HEADLESSRUNNER_H
@@ -0,0 +1,154 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Implements the main() of the headless mne_scan pipeline runner.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "pipelinedescription.h"
+#include "headlessrunner.h"
+
+#include <scMeas/measurementtypes.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNESCANHEADLESS;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* The function main marks the entry point of the program.
+* By default, main has the storage class extern.
+*
+* @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+* @param [in] argv (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+* @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+*/
+int main(int argc, char *argv[])
+{
+    //Plugins create widgets - render them offscreen unless a platform is requested explicitly
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+
+    //Same application info as mne_scan so that the plugins read the same QSettings
+    QCoreApplication::setOrganizationName("MNE-CPP");
+    QCoreApplication::setOrganizationDomain("www.tu-ilmenau.de/mne-cpp");
+    QCoreApplication::setApplicationName("MNE Scan");
+
+    SCMEASLIB::MeasurementTypes::registerTypes();
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs an MNE Scan plugin pipeline without user interface and prints the plugin statistics.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("pipeline", "Pipeline description (.json or .xml).");
+
+    QCommandLineOption durationOption("duration", "Run for <msec> milliseconds, overrides the pipeline file.", "msec");
+    QCommandLineOption samplesOption("samples", "Stop after <n> sensor samples, overrides the pipeline file.", "n");
+    QCommandLineOption scheduledOption("scheduled", "Process the plugins on the shared task scheduler.");
+    QCommandLineOption statisticsOption("stats", "Write the plugin statistics to <file> (.csv or .json).", "file");
+    QCommandLineOption pluginDirOption("plugins", "Directory of the mne_scan plugins.", "dir", QCoreApplication::applicationDirPath() + "/mne_scan_plugins");
+
+    parser.addOption(durationOption);
+    parser.addOption(samplesOption);
+    parser.addOption(scheduledOption);
+    parser.addOption(statisticsOption);
+    parser.addOption(pluginDirOption);
+    parser.process(app);
+
+    if(parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+
+    PipelineDescription t_description;
+    if(!t_description.read(parser.positionalArguments()[0]))
+    {
+        qCritical() << t_description.errorString();
+        return 1;
+    }
+
+    if(parser.isSet(durationOption))
+        t_description.iDurationMsec = parser.value(durationOption).toLongLong();
+    if(parser.isSet(samplesOption))
+        t_description.iNumSamples = parser.value(samplesOption).toLongLong();
+    if(parser.isSet(scheduledOption))
+        t_description.bScheduled = true;
+
+    if(t_description.iDurationMsec <= 0 && t_description.iNumSamples <= 0)
+    {
+        qCritical() << "Neither a duration nor a sample count is given - the pipeline would run forever.";
+        return 1;
+    }
+
+    HeadlessRunner t_runner(parser.value(pluginDirOption));
+
+    if(!t_runner.build(t_description))
+        return 1;
+
+    QObject::connect(&t_runner, &HeadlessRunner::finished, &app, &QCoreApplication::quit, Qt::QueuedConnection);
+
+    if(!t_runner.start())
+    {
+        qCritical() << "Not able to start at least one sensor plugin!";
+        return 1;
+    }
+
+    int t_iReturn = app.exec();
+
+    if(parser.isSet(statisticsOption) && !t_runner.saveStatistics(parser.value(statisticsOption)))
+        return 1;
+
+    return t_iReturn;
+}
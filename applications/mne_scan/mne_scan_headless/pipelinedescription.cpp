@@ -0,0 +1,240 @@
+//=============================================================================================================
+/**
+* @file     pipelinedescription.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains implementation of PipelineDescription class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "pipelinedescription.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QFile>
+#include <QSet>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDomDocument>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNESCANHEADLESS;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+PipelineDescription::PipelineDescription()
+: iDurationMsec(0)
+, iNumSamples(0)
+, bScheduled(false)
+{
+}
+
+
+//*************************************************************************************************************
+
+bool PipelineDescription::read(const QString& sFileName)
+{
+    plugins.clear();
+    connections.clear();
+
+    QFile t_file(sFileName);
+    if(!t_file.open(QIODevice::ReadOnly))
+    {
+        m_sErrorString = QString("Could not open %1").arg(sFileName);
+        return false;
+    }
+
+    QByteArray t_data = t_file.readAll();
+    t_file.close();
+
+    bool t_bRead = sFileName.endsWith(".json", Qt::CaseInsensitive) ? readJson(t_data) : readXml(t_data);
+
+    return t_bRead && validate();
+}
+
+
+//*************************************************************************************************************
+
+bool PipelineDescription::readJson(const QByteArray& data)
+{
+    QJsonParseError t_error;
+    QJsonDocument t_jsonDocument = QJsonDocument::fromJson(data, &t_error);
+    if(t_jsonDocument.isNull() || !t_jsonDocument.isObject())
+    {
+        m_sErrorString = QString("JSON error: %1").arg(t_error.errorString());
+        return false;
+    }
+
+    QJsonObject t_jsonRoot = t_jsonDocument.object();
+
+    QJsonArray t_jsonPlugins = t_jsonRoot.value("plugins").toArray();
+    for(qint32 i = 0; i < t_jsonPlugins.size(); ++i)
+    {
+        QJsonObject t_jsonPlugin = t_jsonPlugins[i].toObject();
+
+        PipelinePlugin t_plugin;
+        t_plugin.sName = t_jsonPlugin.value("name").toString();
+        t_plugin.sId = t_jsonPlugin.value("id").toString(t_plugin.sName);
+        t_plugin.settings = t_jsonPlugin.value("settings").toObject().toVariantMap();
+        plugins.append(t_plugin);
+    }
+
+    QJsonArray t_jsonConnections = t_jsonRoot.value("connections").toArray();
+    for(qint32 i = 0; i < t_jsonConnections.size(); ++i)
+    {
+        QJsonObject t_jsonConnection = t_jsonConnections[i].toObject();
+
+        PipelineConnection t_connection;
+        t_connection.sSender = t_jsonConnection.value("sender").toString();
+        t_connection.sReceiver = t_jsonConnection.value("receiver").toString();
+        connections.append(t_connection);
+    }
+
+    QJsonObject t_jsonRun = t_jsonRoot.value("run").toObject();
+    iDurationMsec = (qint64)t_jsonRun.value("duration_ms").toDouble(0);
+    iNumSamples = (qint64)t_jsonRun.value("samples").toDouble(0);
+    bScheduled = t_jsonRun.value("execution").toString() == "scheduled";
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool PipelineDescription::readXml(const QByteArray& data)
+{
+    QDomDocument t_domDocument("PluginConfig");
+    QString t_sError;
+    qint32 t_iLine;
+    if(!t_domDocument.setContent(data, &t_sError, &t_iLine))
+    {
+        m_sErrorString = QString("XML error in line %1: %2").arg(t_iLine).arg(t_sError);
+        return false;
+    }
+
+    QDomElement t_domRoot = t_domDocument.documentElement();
+    if(t_domRoot.tagName() != "PluginTree")
+    {
+        m_sErrorString = "PluginTree element not found";
+        return false;
+    }
+
+    for(QDomElement e = t_domRoot.firstChildElement(); !e.isNull(); e = e.nextSiblingElement())
+    {
+        if(e.tagName() == "Plugins")
+        {
+            for(QDomElement p = e.firstChildElement("Plugin"); !p.isNull(); p = p.nextSiblingElement("Plugin"))
+            {
+                PipelinePlugin t_plugin;
+                t_plugin.sName = p.attribute("name");
+                t_plugin.sId = p.attribute("id", t_plugin.sName);
+
+                for(QDomElement s = p.firstChildElement("Setting"); !s.isNull(); s = s.nextSiblingElement("Setting"))
+                    t_plugin.settings.insert(s.attribute("key"), s.attribute("value"));
+
+                plugins.append(t_plugin);
+            }
+        }
+        else if(e.tagName() == "Connections")
+        {
+            for(QDomElement c = e.firstChildElement(); !c.isNull(); c = c.nextSiblingElement())
+            {
+                PipelineConnection t_connection;
+                t_connection.sSender = c.attribute("sender");
+                t_connection.sReceiver = c.attribute("receiver");
+                connections.append(t_connection);
+            }
+        }
+        else if(e.tagName() == "Run")
+        {
+            iDurationMsec = e.attribute("duration_ms", "0").toLongLong();
+            iNumSamples = e.attribute("samples", "0").toLongLong();
+            bScheduled = e.attribute("execution") == "scheduled";
+        }
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool PipelineDescription::validate()
+{
+    if(plugins.isEmpty())
+    {
+        m_sErrorString = "The pipeline has no plugins";
+        return false;
+    }
+
+    QSet<QString> t_qSetIds;
+    for(qint32 i = 0; i < plugins.size(); ++i)
+    {
+        if(plugins[i].sName.isEmpty())
+        {
+            m_sErrorString = QString("Plugin %1 has no name").arg(i);
+            return false;
+        }
+        if(t_qSetIds.contains(plugins[i].sId))
+        {
+            m_sErrorString = QString("Plugin id %1 is not unique").arg(plugins[i].sId);
+            return false;
+        }
+        t_qSetIds.insert(plugins[i].sId);
+    }
+
+    for(qint32 i = 0; i < connections.size(); ++i)
+    {
+        if(!t_qSetIds.contains(connections[i].sSender) || !t_qSetIds.contains(connections[i].sReceiver))
+        {
+            m_sErrorString = QString("Connection %1 -> %2 refers to an unknown plugin").arg(connections[i].sSender).arg(connections[i].sReceiver);
+            return false;
+        }
+    }
+
+    return true;
+}
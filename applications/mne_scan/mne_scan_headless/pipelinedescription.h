@@ -0,0 +1,171 @@
+//=============================================================================================================
+/**
+* @file     pipelinedescription.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains declaration of PipelineDescription class.
+*
+*/
+
+#ifndef PIPELINEDESCRIPTION_H
+#define PIPELINEDESCRIPTION_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QString>
+#include <QList>
+#include <QVariantMap>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE MNESCANHEADLESS
+//=============================================================================================================
+
+namespace MNESCANHEADLESS
+{
+
+//=============================================================================================================
+/**
+* A plugin instance of the pipeline.
+*/
+struct PipelinePlugin {
+    QString     sId;            /**< Unique id used by the connections, defaults to the plugin name. */
+    QString     sName;          /**< Name of the plugin as returned by IPlugin::getName(). */
+    QVariantMap settings;       /**< QSettings entries written before the plugin is initialized. */
+};
+
+
+//=============================================================================================================
+/**
+* A connection between two plugins of the pipeline.
+*/
+struct PipelineConnection {
+    QString     sSender;        /**< Id of the sending plugin. */
+    QString     sReceiver;      /**< Id of the receiving plugin. */
+};
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS PipelineDescription
+*
+* A pipeline file lists the plugins with their settings, the connections and how long to run. JSON files look like
+*
+*   { "plugins": [ { "id": "sim", "name": "Fiff Simulator", "settings": { "<QSettings key>": <value> } }, ... ],
+*     "connections": [ { "sender": "sim", "receiver": "avg" }, ... ],
+*     "run": { "duration_ms": 10000, "samples": 0, "execution": "scheduled" } }
+*
+* XML files use the PluginTree format which mne_scan saves, extended by optional id attributes,
+* <Setting key="" value=""/> children of <Plugin> and a <Run duration_ms="" samples="" execution=""/> element.
+*
+* @brief The PipelineDescription class reads a pipeline file for the headless runner.
+*/
+class PipelineDescription
+{
+public:
+    //=========================================================================================================
+    /**
+    * Constructs an empty PipelineDescription.
+    */
+    PipelineDescription();
+
+    //=========================================================================================================
+    /**
+    * Reads a pipeline file. Files ending with .json are read as JSON, all others as XML.
+    *
+    * @param [in] sFileName     the pipeline file.
+    *
+    * @return true if the file was read and is consistent.
+    */
+    bool read(const QString& sFileName);
+
+    //=========================================================================================================
+    /**
+    * Returns the reason why read() failed.
+    *
+    * @return the error message.
+    */
+    inline QString errorString() const;
+
+    QList<PipelinePlugin>       plugins;            /**< The plugins in creation order. */
+    QList<PipelineConnection>   connections;        /**< The connections between the plugins. */
+    qint64                      iDurationMsec;      /**< Run time in milliseconds, 0 if not limited. */
+    qint64                      iNumSamples;        /**< Number of sensor samples to process, 0 if not limited. */
+    bool                        bScheduled;         /**< Whether to process the plugins on the task scheduler. */
+
+private:
+    //=========================================================================================================
+    /**
+    * Reads the JSON format.
+    *
+    * @param [in] data  the file content.
+    *
+    * @return true if successful.
+    */
+    bool readJson(const QByteArray& data);
+
+    //=========================================================================================================
+    /**
+    * Reads the XML format.
+    *
+    * @param [in] data  the file content.
+    *
+    * @return true if successful.
+    */
+    bool readXml(const QByteArray& data);
+
+    //=========================================================================================================
+    /**
+    * Checks that ids are unique and that all connections refer to existing plugins.
+    *
+    * @return true if consistent.
+    */
+    bool validate();
+
+    QString m_sErrorString;     /**< The reason why read() failed. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline QString PipelineDescription::errorString() const
+{
+    return m_sErrorString;
+}
+
+}//NAMESPACE
+
+#endif // PIPELINEDESCRIPTION_H
@@ -262,9 +262,14 @@ void Averaging::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
     QSharedPointer<NewRealTimeMultiSampleArray> pRTMSA = pMeasurement.dynamicCast<NewRealTimeMultiSampleArray>();
 
     if(pRTMSA) {
+        //Shared blocks of the measurement - they are only read here
+        QList<NewRealTimeMultiSampleArray::ConstMatrixPtr> t_qListBlocks = pRTMSA->getMultiSampleBlocks();
+        if(t_qListBlocks.isEmpty())
+            return;
+
         //Check if buffer initialized
         if(!m_pAveragingBuffer) {
-            m_pAveragingBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, pRTMSA->getNumChannels(), pRTMSA->getMultiSampleArray()[0].cols()));
+            m_pAveragingBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, pRTMSA->getNumChannels(), t_qListBlocks[0]->cols()));
         }
 
         //Fiff information
@@ -287,11 +292,12 @@ void Averaging::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
 
         if(m_bProcessData)
         {
-            for(qint32 i = 0; i < pRTMSA->getMultiSampleArray().size(); ++i)
+            for(qint32 i = 0; i < t_qListBlocks.size(); ++i)
             {
-                MatrixXd t_mat = pRTMSA->getMultiSampleArray()[i];
-
 #ifdef DEBUG_AVERAGING
+                //The test stimulus modifies the block -> work on a copy
+                MatrixXd t_mat = *t_qListBlocks[i];
+
                 qsrand(time(NULL)+m_iTestCount);
 
                 t_mat = MatrixXd::Zero(t_mat.rows(), t_mat.cols());
@@ -310,8 +316,11 @@ void Averaging::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
                     ++m_iTestCount2;
                 }
                 ++m_iTestCount;
-#endif
+
                 m_pAveragingBuffer->push(&t_mat);
+#else
+                m_pAveragingBuffer->push(t_qListBlocks[i].data());
+#endif
             }
         }
     }
@@ -397,9 +406,7 @@ void Averaging::changeStimChannel(qint32 index)
     m_iStimChan = m_pAveragingWidget->getStimChannelIdx();
     m_iStimChanIdx = m_qListStimChs.at(index);
 
-    if(m_pRtAve) {
-        m_pRtAve->setTriggerChIndx(m_iStimChanIdx);
-    }
+    //All stim channels are averaged as separate conditions - only the displayed one changes
 
 //    qDebug() << "Averaging::changeStimChannel(qint32 index)" << m_pAveragingWidget->m_pComboBoxChSelection->currentData().toInt();
 }
@@ -525,18 +532,12 @@ void Averaging::changeBaselineActive(bool state)
 
 void Averaging::appendEvoked(FiffEvoked::SPtr p_pEvoked)
 {
-//    qDebug() << "void Averaging::appendEvoked";// << p_pEvoked->comment;
-//    qDebug() << p_pEvoked->comment;
-//    QString t_sStimulusChannel = m_pFiffInfo->chs[m_qListStimChs[m_iStimChan]].ch_name;
+    QMutexLocker locker(&m_qMutex);
 
-//    if(p_pEvoked->comment == t_sStimulusChannel)
-//    {
-//        qDebug()<< "append" << p_pEvoked->comment << "=" << t_sStimulusChannel;
-        m_qMutex.lock();
+    QString t_sStimulusChannel = m_pFiffInfo->chs[m_iStimChanIdx].ch_name;
+
+    if(p_pEvoked->comment == t_sStimulusChannel)
         m_qVecEvokedData.push_back(p_pEvoked);
-        m_qMutex.unlock();
-//        qDebug() << "append after" << m_qVecEvokedData.size();
-//    }
 }
 
 
@@ -595,7 +596,12 @@ void Averaging::run()
     //
     // Init Real-Time average
     //
-    m_pRtAve = RtAve::SPtr(new RtAve(m_iNumAverages, m_iPreStimSamples, m_iPostStimSamples, m_iBaselineFromSeconds, m_iBaselineToSeconds, m_qListStimChs.at(m_iStimChan), m_pFiffInfo));
+    m_iStimChanIdx = m_qListStimChs.at(m_iStimChan);
+
+    m_pRtAve = RtAve::SPtr(new RtAve(m_iNumAverages, m_iPreStimSamples, m_iPostStimSamples, m_iBaselineFromSeconds, m_iBaselineToSeconds, m_qListStimChs.at(0), m_pFiffInfo));
+    for(qint32 i = 1; i < m_qListStimChs.size(); ++i)
+        m_pRtAve->addCondition(m_qListStimChs.at(i));
+
     m_pRtAve->setBaselineFrom(m_iBaselineFromSamples, m_iBaselineFromSeconds);
     m_pRtAve->setBaselineTo(m_iBaselineToSamples, m_iBaselineToSeconds);
     m_pRtAve->setBaselineActive(m_bDoBaselineCorrection);
@@ -625,6 +631,7 @@ void Averaging::run()
         {
             /* Dispatch the inputs */
             MatrixXd rawSegment = m_pAveragingBuffer->pop();
+            PluginStatistics::BlockTimer t_blockTimer(statistics());
 
             m_pRtAve->append(rawSegment);
 
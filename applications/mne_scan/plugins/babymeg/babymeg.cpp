@@ -51,7 +51,6 @@
 #include <iostream>
 
 #include <utils/ioutils.h>
-#include <utils/detecttrigger.h>
 #include <fiff/fiff_types.h>
 #include <fiff/fiff_dir_tree.h>
 #include <rtClient/rtcmdclient.h>
@@ -307,6 +306,10 @@ void BabyMEG::initConnector()
         m_lTriggerChannelIndices.append(m_pFiffInfo->ch_names.indexOf("TRG006"));
         m_lTriggerChannelIndices.append(m_pFiffInfo->ch_names.indexOf("TRG007"));
         m_lTriggerChannelIndices.append(m_pFiffInfo->ch_names.indexOf("TRG008"));
+
+        m_triggerDetector.setChannels(m_lTriggerChannelIndices);
+        m_triggerDetector.setThreshold(3.0);
+        m_triggerDetector.setMinimumGap(100);
     }
 }
 
@@ -739,7 +742,7 @@ void BabyMEG::run()
         if(m_pRawMatrixBuffer)
         {
             //pop matrix
-            matValue = m_pRawMatrixBuffer->pop();
+            m_pRawMatrixBuffer->pop(matValue);
 
             //create digital trigger information
             //QElapsedTimer time;
@@ -787,45 +790,39 @@ void BabyMEG::run()
 void BabyMEG::createDigTrig(MatrixXf& data)
 {
     //Look for triggers in all trigger channels
+    const qint64 iBlockStart = m_triggerDetector.sampleCount();
+    const QVector<TriggerDetector::Event>& vecEvents = m_triggerDetector.detect(data.cast<double>());
 
-    //m_qMapDetectedTrigger = DetectTrigger::detectTriggerFlanksMax(data.at(b), m_lTriggerChannelIndices, m_iCurrentSample-nCol, m_dTriggerThreshold, true);
-    QMap<int,QList<QPair<int,double> > > qMapDetectedTrigger = DetectTrigger::detectTriggerFlanksGrad(data.cast<double>(), m_lTriggerChannelIndices, 0, 3.0, false, "Rising");
-
-    //Combine and write results into data block's digital trigger channel
-    QMapIterator<int,QList<QPair<int,double> >> i(qMapDetectedTrigger);
-    int counter = 0;
+    //Combine and write results into data block's digital trigger channel - TRG00n sets bit n-1
     int idxDigTrig = m_pFiffInfo->ch_names.indexOf("DTRG01");
 
-    while (i.hasNext())
+    for(int k = 0; k < vecEvents.size(); ++k)
     {
-        i.next();
-
-        QList<QPair<int,double> > lDetectedTriggers = i.value();
+        const int iCol = (int)(vecEvents[k].iSample - iBlockStart);
+        const int iBit = m_lTriggerChannelIndices.indexOf(vecEvents[k].iChannel);
 
-        for(int k = 0; k < lDetectedTriggers.size(); ++k)
+        if(idxDigTrig >= 0 && iBit >= 0)
         {
-            if(lDetectedTriggers.at(k).first < data.cols() && lDetectedTriggers.at(k).first >= 0)
-            {
-                data(idxDigTrig,lDetectedTriggers.at(k).first) = data(idxDigTrig,lDetectedTriggers.at(k).first) + pow(2,counter);
-            }
+            data(idxDigTrig,iCol) = data(idxDigTrig,iCol) + pow(2,iBit);
         }
-
-        counter++;
     }
 }
 
 
 //*************************************************************************************************************
 
-MatrixXd BabyMEG::calibrate(const MatrixXf& data)
+MatrixPool::MatrixPtr BabyMEG::calibrate(const MatrixXf& data)
 {
-    MatrixXd one;
-    if(m_pFiffInfo && m_sparseMatCals.cols() == m_pFiffInfo->nchan)
-        one = m_sparseMatCals*data.cast<double>();
-    else
-        one = data.cast<double>();
+    MatrixPool::MatrixPtr t_pBlock = MatrixPool::global().acquire(data.rows(), data.cols());
+
+    if(m_pFiffInfo && m_sparseMatCals.cols() == m_pFiffInfo->nchan) {
+        m_matCalibrateIn = data.cast<double>();
+        t_pBlock->noalias() = m_sparseMatCals*m_matCalibrateIn;
+    } else {
+        *t_pBlock = data.cast<double>();
+    }
 
-    return one;
+    return t_pBlock;
 }
 
 
@@ -50,6 +50,8 @@
 
 #include <scShared/Interfaces/ISensor.h>
 #include <generics/circularmatrixbuffer.h>
+#include <generics/matrixpool.h>
+#include <utils/triggerdetector.h>
 
 
 //*************************************************************************************************************
@@ -333,11 +335,13 @@ private:
 
     //=========================================================================================================
     /**
-    * Calibrate matrix.
+    * Calibrate matrix into a block taken from the global matrix pool.
     *
-    * @param[out] data  the data matrix
+    * @param[in] data  the raw data matrix
+    *
+    * @return the calibrated data block
     */
-    Eigen::MatrixXd calibrate(const Eigen::MatrixXf& data);
+    IOBuffer::MatrixPool::MatrixPtr calibrate(const Eigen::MatrixXf& data);
 
     //=========================================================================================================
     /**
@@ -397,6 +401,7 @@ private:
     QSharedPointer<QTimer>                  m_pRecordTimer;                 /**< timer to control recording time. */
 
     QList<int>                              m_lTriggerChannelIndices;       /**< List of all trigger channel indices. */
+    UTILSLIB::TriggerDetector               m_triggerDetector;              /**< Rising flank detection on the trigger channels, carried across blocks. */
 
     FIFFLIB::FiffInfo::SPtr                 m_pFiffInfo;                    /**< Fiff measurement info.*/
     FIFFLIB::FiffStream::SPtr               m_pOutfid;                      /**< FiffStream to write to.*/
@@ -423,6 +428,7 @@ private:
 
     Eigen::RowVectorXd                      m_cals;                         /**< Calibration vector.*/
     Eigen::SparseMatrix<double>             m_sparseMatCals;                /**< Sparse calibration matrix.*/
+    Eigen::MatrixXd                         m_matCalibrateIn;               /**< Reused double precision copy of the raw block used during calibration.*/
 
     QAction*                                m_pActionSetupProject;          /**< shows setup project dialog */
     QAction*                                m_pActionRecordFile;            /**< start recording action */
@@ -100,6 +100,13 @@ void BCI::init()
 {
     m_bIsRunning = false;
     m_bTriggerActivated = false;
+    m_bTriggerReceived = false;
+    m_iTriggerOnset = -1;
+
+    // The trigger channel is 136 - the rounded codes are masked to 8 bit, both flanks bound the trigger length
+    m_triggerDetector.setChannels(QList<int>() << 136);
+    m_triggerDetector.setMask(0xFF);
+    m_triggerDetector.setFlankType(TriggerDetector::Both);
 
     // Inputs - Source estimates and sensor level
     m_pRTSEInput = PluginInputData<RealTimeSourceEstimate>::create(this, "BCIInSource", "BCI source input data");
@@ -209,6 +216,11 @@ bool BCI::start()
     m_iTBWIndexSensor = 0;
     m_iNumberOfCalculatedFeatures = 0;
 
+    // Initialise trigger detection
+    m_triggerDetector.reset();
+    m_bTriggerReceived = false;
+    m_iTriggerOnset = -1;
+
     // BCIFeatureWindow show and init
     if(m_bDisplayFeatures)
     {
@@ -571,13 +583,36 @@ bool BCI::hasThresholdArtefact(const QList< QPair<int,RowVectorXd> > &data)
 bool BCI::lookForTrigger(const MatrixXd &data)
 {
     // Check if capacitive touch trigger signal was received - Note that there can also be "beep" triggers in the received data, which are only 1 sample wide -> therefore look for 2 samples with a value of 254 each
-    for(int i = 0; i<data.cols()-1; i++)
+    bool bTriggerFound = false;
+
+    const QVector<TriggerDetector::Event>& events = m_triggerDetector.detect(data);
+
+    for(int i = 0; i < events.size(); i++)
+    {
+        const TriggerDetector::Event& event = events.at(i);
+
+        if(event.iValue != 254)
+            continue;
+
+        if(event.bRising)
+            m_iTriggerOnset = event.iSample;
+        else if(m_iTriggerOnset >= 0)
+        {
+            if(event.iSample - m_iTriggerOnset >= 2)
+                bTriggerFound = true;
+
+            m_iTriggerOnset = -1;
+        }
+    }
+
+    // The code is still on at the end of the block
+    if(m_iTriggerOnset >= 0 && m_triggerDetector.sampleCount() - m_iTriggerOnset >= 2)
     {
-        if(data(0,i) == 254 && data(0,i+1) == 254) // data - corresponds with channel 136 which is the trigger channel
-            return true;
+        bTriggerFound = true;
+        m_iTriggerOnset = -1;
     }
 
-    return false;
+    return bTriggerFound;
 }
 
 
@@ -623,6 +658,9 @@ void BCI::BCIOnSensorLevel()
 
             m_matStimChannelSensor.block(0, m_iTBWIndexSensor, 1, t_mat.cols()) = t_mat.block(136, 0, 1, t_mat.cols());
 
+            if(lookForTrigger(t_mat))
+                m_bTriggerReceived = true;
+
             m_iTBWIndexSensor = m_iTBWIndexSensor + t_mat.cols();
         }
         else // m_matSlidingWindowSensor is full for the first time
@@ -645,6 +683,9 @@ void BCI::BCIOnSensorLevel()
 
             m_matTimeBetweenWindowsStimSensor.block(0, m_iTBWIndexSensor, 1, t_mat.cols()) = t_mat.block(136, 0, 1, t_mat.cols());
 
+            if(lookForTrigger(t_mat))
+                m_bTriggerReceived = true;
+
             m_iTBWIndexSensor = m_iTBWIndexSensor + t_mat.cols();
         }
         else // Recalculate m_matSlidingWindowSensor -> Calculate features, classify and store results
@@ -701,11 +742,12 @@ void BCI::BCIOnSensorLevel()
             if(hasThresholdArtefact(qlMatrixRows) == false)
             {
                 // Look for trigger flag
-                if(lookForTrigger(m_matStimChannelSensor) && !m_bTriggerActivated)
+                if(m_bTriggerReceived && !m_bTriggerActivated)
                 {
                     // cout << "Trigger activated" << endl;
                     //QFuture<void> future = QtConcurrent::run(Beep, 450, 700);
                     m_bTriggerActivated = true;
+                    m_bTriggerReceived = false;
                 }
 
                 // ----5---- Filter data in m_matSlidingWindowSensor concurrently using map()
@@ -53,6 +53,7 @@
 #include <xMeas/realtimesourceestimate.h>
 
 #include <utils/filterdata.h>
+#include <utils/triggerdetector.h>
 
 #include <fstream>
 
@@ -240,8 +241,13 @@ protected:
 
     //=========================================================================================================
     /**
-    * Look for trigger in stim channel
+    * Scans the stim channel of the next received block for the capacitive touch trigger, a code of 254 which
+    * lasts at least two samples. A trigger which is still on at the end of the block is found as soon as it
+    * lasted two samples, possibly in the next block.
     *
+    * @param[in] data   The next received block, rows are channels.
+    *
+    * @return true if a trigger was found, false otherwise.
     */
     bool lookForTrigger(const MatrixXd &data);
 
@@ -293,6 +299,9 @@ private:
     QString                 m_qStringResourcePath;              /**< The path to the BCI resource directory.*/
     bool                    m_bProcessData;                     /**< Whether BCI is to get data out of the continous input data stream, i.e. the EEG data from sensor level.*/
     bool                    m_bTriggerActivated;                /**< Whether the trigger was activated.*/
+    bool                    m_bTriggerReceived;                 /**< Whether a trigger was received which did not activate yet.*/
+    TriggerDetector         m_triggerDetector;                  /**< Digital flank detection on the stim channel, carried across blocks.*/
+    qint64                  m_iTriggerOnset;                    /**< Sample at which the current code of 254 started, -1 if none is pending.*/
     QMutex                  m_qMutex;                           /**< QMutex to guarantee thread safety.*/
 
     // Sensor level
@@ -5,6 +5,8 @@
 #include <QGridLayout>
 #include <QSpinBox>
 #include <QLabel>
+#include <QComboBox>
+#include <QCheckBox>
 
 
 //*************************************************************************************************************
@@ -41,5 +43,36 @@ CovarianceSettingsWidget::CovarianceSettingsWidget(Covariance *toolbox, QWidget
     connect(m_pSpinBoxNumSamples, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), m_pCovarianceToolbox, &Covariance::changeSamples);
     t_pGridLayout->addWidget(m_pSpinBoxNumSamples,0,1,1,1);
 //    }
+
+    QLabel* t_pLabelMode = new QLabel;
+    t_pLabelMode->setText("Estimation");
+    t_pGridLayout->addWidget(t_pLabelMode,1,0,1,1);
+
+    //Order of RtCov::EstimationMode
+    m_pComboBoxMode = new QComboBox;
+    m_pComboBoxMode->addItem("Blocks");
+    m_pComboBoxMode->addItem("Sliding window");
+    m_pComboBoxMode->addItem("Exponential");
+    m_pComboBoxMode->setCurrentIndex(toolbox->m_iEstimationMode);
+    connect(m_pComboBoxMode, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), m_pCovarianceToolbox, &Covariance::changeMode);
+    t_pGridLayout->addWidget(m_pComboBoxMode,1,1,1,1);
+
+    QLabel* t_pLabelUpdateInterval = new QLabel;
+    t_pLabelUpdateInterval->setText("Update every (Samples)");
+    t_pGridLayout->addWidget(t_pLabelUpdateInterval,2,0,1,1);
+
+    m_pSpinBoxUpdateInterval = new QSpinBox;
+    m_pSpinBoxUpdateInterval->setMinimum(1);
+    m_pSpinBoxUpdateInterval->setMaximum(minSamples*60);
+    m_pSpinBoxUpdateInterval->setSingleStep(100);
+    m_pSpinBoxUpdateInterval->setValue(toolbox->m_iUpdateInterval);
+    connect(m_pSpinBoxUpdateInterval, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), m_pCovarianceToolbox, &Covariance::changeUpdateInterval);
+    t_pGridLayout->addWidget(m_pSpinBoxUpdateInterval,2,1,1,1);
+
+    m_pCheckBoxSinglePrecision = new QCheckBox("Single precision");
+    m_pCheckBoxSinglePrecision->setChecked(toolbox->m_bSinglePrecision);
+    connect(m_pCheckBoxSinglePrecision, &QCheckBox::toggled, m_pCovarianceToolbox, &Covariance::changeSinglePrecision);
+    t_pGridLayout->addWidget(m_pCheckBoxSinglePrecision,3,0,1,2);
+
     this->setLayout(t_pGridLayout);
 }
@@ -55,6 +55,9 @@ public slots:
 private:
     Covariance* m_pCovarianceToolbox;
     QSpinBox* m_pSpinBoxNumSamples;
+    QComboBox* m_pComboBoxMode;
+    QSpinBox* m_pSpinBoxUpdateInterval;
+    QCheckBox* m_pCheckBoxSinglePrecision;
 };
 
 } // NAMESPACE
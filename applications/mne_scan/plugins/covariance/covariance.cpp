@@ -74,6 +74,9 @@ Covariance::Covariance()
 , m_pCovarianceOutput(NULL)
 , m_pCovarianceBuffer(CircularMatrixBuffer<double>::SPtr())
 , m_iEstimationSamples(5000)
+, m_iEstimationMode(RtCov::Block)
+, m_iUpdateInterval(1000)
+, m_bSinglePrecision(false)
 {
     m_pActionShowAdjustment = new QAction(QIcon(":/images/covadjustments.png"), tr("Covariance Adjustments"),this);
 //    m_pActionSetupProject->setShortcut(tr("F12"));
@@ -114,12 +117,18 @@ void Covariance::init()
     //
     QSettings settings;
     m_iEstimationSamples = settings.value(QString("Plugin/%1/estimationSamples").arg(this->getName()), 5000).toInt();
+    m_iEstimationMode = settings.value(QString("Plugin/%1/estimationMode").arg(this->getName()), RtCov::Block).toInt();
+    m_iUpdateInterval = settings.value(QString("Plugin/%1/updateInterval").arg(this->getName()), 1000).toInt();
+    m_bSinglePrecision = settings.value(QString("Plugin/%1/singlePrecision").arg(this->getName()), false).toBool();
 
     // Input
     m_pCovarianceInput = PluginInputData<NewRealTimeMultiSampleArray>::create(this, "CovarianceIn", "Covariance input data");
     connect(m_pCovarianceInput.data(), &PluginInputConnector::notify, this, &Covariance::update, Qt::DirectConnection);
     m_inputConnectors.append(m_pCovarianceInput);
 
+    //The covariance is estimated over thousands of samples - large input blocks save per-block overhead
+    m_pCovarianceInput->setBlockSize(settings.value(QString("Plugin/%1/inputBlockSize").arg(this->getName()), 1000).toInt());
+
     // Output
     m_pCovarianceOutput = PluginOutputData<RealTimeCov>::create(this, "CovarianceOut", "Covariance output data");
     m_outputConnectors.append(m_pCovarianceOutput);
@@ -139,6 +148,9 @@ void Covariance::unload()
     //
     QSettings settings;
     settings.setValue(QString("Plugin/%1/estimationSamples").arg(this->getName()), m_iEstimationSamples);
+    settings.setValue(QString("Plugin/%1/estimationMode").arg(this->getName()), m_iEstimationMode);
+    settings.setValue(QString("Plugin/%1/updateInterval").arg(this->getName()), m_iUpdateInterval);
+    settings.setValue(QString("Plugin/%1/singlePrecision").arg(this->getName()), m_bSinglePrecision);
 }
 
 
@@ -217,9 +229,14 @@ void Covariance::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
 
     if(pRTMSA)
     {
+        //Shared blocks of the measurement - they are only read here
+        QList<NewRealTimeMultiSampleArray::ConstMatrixPtr> t_qListBlocks = pRTMSA->getMultiSampleBlocks();
+        if(t_qListBlocks.isEmpty())
+            return;
+
         //Check if buffer initialized
         if(!m_pCovarianceBuffer)
-            m_pCovarianceBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, pRTMSA->getNumChannels(), pRTMSA->getMultiSampleArray()[0].cols()));
+            m_pCovarianceBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, pRTMSA->getNumChannels(), t_qListBlocks[0]->cols()));
 
         //Fiff information
         if(!m_pFiffInfo)
@@ -231,13 +248,8 @@ void Covariance::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
 
         if(m_bProcessData)
         {
-            MatrixXd t_mat;
-
-            for(qint32 i = 0; i < pRTMSA->getMultiArraySize(); ++i)
-            {
-                t_mat = pRTMSA->getMultiSampleArray()[i];
-                m_pCovarianceBuffer->push(&t_mat);
-            }
+            for(qint32 i = 0; i < t_qListBlocks.size(); ++i)
+                m_pCovarianceBuffer->push(t_qListBlocks[i].data());
         }
     }
 }
@@ -263,6 +275,36 @@ void Covariance::changeSamples(qint32 samples)
 }
 
 
+//*************************************************************************************************************
+
+void Covariance::changeMode(qint32 mode)
+{
+    m_iEstimationMode = mode;
+    if(m_pRtCov)
+        m_pRtCov->setMode((RtCov::EstimationMode)m_iEstimationMode);
+}
+
+
+//*************************************************************************************************************
+
+void Covariance::changeUpdateInterval(qint32 samples)
+{
+    m_iUpdateInterval = samples;
+    if(m_pRtCov)
+        m_pRtCov->setUpdateInterval(m_iUpdateInterval);
+}
+
+
+//*************************************************************************************************************
+
+void Covariance::changeSinglePrecision(bool bSinglePrecision)
+{
+    m_bSinglePrecision = bSinglePrecision;
+    if(m_pRtCov)
+        m_pRtCov->setSinglePrecision(m_bSinglePrecision);
+}
+
+
 //*************************************************************************************************************
 
 void Covariance::run()
@@ -282,6 +324,9 @@ void Covariance::run()
     // Init Real-Time Covariance estimator
     //
     m_pRtCov = RtCov::SPtr(new RtCov(m_iEstimationSamples, m_pFiffInfo));
+    m_pRtCov->setMode((RtCov::EstimationMode)m_iEstimationMode);
+    m_pRtCov->setUpdateInterval(m_iUpdateInterval);
+    m_pRtCov->setSinglePrecision(m_bSinglePrecision);
     connect(m_pRtCov.data(), &RtCov::covCalculated, this, &Covariance::appendCovariance);
 
     //
@@ -300,6 +345,7 @@ void Covariance::run()
         {
             /* Dispatch the inputs */
             MatrixXd t_mat = m_pCovarianceBuffer->pop();
+            PluginStatistics::BlockTimer t_blockTimer(statistics());
 
             //Add to covariance estimation
             m_pRtCov->append(t_mat);
@@ -160,6 +160,12 @@ public:
 
     void changeSamples(qint32 samples);
 
+    void changeMode(qint32 mode);
+
+    void changeUpdateInterval(qint32 samples);
+
+    void changeSinglePrecision(bool bSinglePrecision);
+
 signals:
     //=========================================================================================================
     /**
@@ -188,6 +194,9 @@ private:
     bool m_bProcessData;                        /**< If data should be received for processing */
 
     qint32 m_iEstimationSamples;
+    qint32 m_iEstimationMode;                   /**< The RtCov::EstimationMode. */
+    qint32 m_iUpdateInterval;                   /**< Samples between two estimates of the sliding window and exponential modes. */
+    bool m_bSinglePrecision;                    /**< Whether the covariance is accumulated in single precision. */
 
     QSharedPointer<CovarianceSettingsWidget> m_pCovarianceWidget;
 
@@ -49,6 +49,7 @@
 using namespace DummyToolboxPlugin;
 using namespace SCSHAREDLIB;
 using namespace SCMEASLIB;
+using namespace FIFFLIB;
 using namespace IOBuffer;
 
 
@@ -129,6 +130,10 @@ bool DummyToolbox::start()
 
     m_bIsRunning = true;
 
+    //The scheduler calls process() - no own thread needed
+    if(isScheduled())
+        return true;
+
     //Start thread
     QThread::start();
 
@@ -142,10 +147,17 @@ bool DummyToolbox::stop()
 {
     m_bIsRunning = false;
 
-    m_pDummyBuffer->releaseFromPop();
-    m_pDummyBuffer->releaseFromPush();
+    //Buffer is only created in threaded mode
+    if(m_pDummyBuffer) {
+        m_pDummyBuffer->releaseFromPop();
+        m_pDummyBuffer->releaseFromPush();
+
+        m_pDummyBuffer->clear();
+    }
 
-    m_pDummyBuffer->clear();
+    m_qMutexBufferInfo.lock();
+    m_qQueueBufferInfo.clear();
+    m_qMutexBufferInfo.unlock();
 
     return true;
 }
@@ -167,6 +179,14 @@ QString DummyToolbox::getName() const
 }
 
 
+//*************************************************************************************************************
+
+bool DummyToolbox::supportsScheduledProcessing() const
+{
+    return true;
+}
+
+
 //*************************************************************************************************************
 
 QWidget* DummyToolbox::setupWidget()
@@ -183,10 +203,13 @@ void DummyToolbox::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
     QSharedPointer<NewRealTimeMultiSampleArray> pRTMSA = pMeasurement.dynamicCast<NewRealTimeMultiSampleArray>();
 
     if(pRTMSA) {
-        //Check if buffer initialized
-        if(!m_pDummyBuffer) {
-            m_pDummyBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, pRTMSA->getNumChannels(), pRTMSA->getMultiSampleArray()[0].cols()));
-        }
+        //Shared blocks of the measurement - they are only read here
+        QList<NewRealTimeMultiSampleArray::ConstMatrixPtr> t_qListBlocks = pRTMSA->getMultiSampleBlocks();
+        if(t_qListBlocks.isEmpty())
+            return;
+
+        //Acquisition information travels with the blocks to the output
+        QList<FiffRtBufferInfo> t_qListBufferInfo = pRTMSA->getBufferInfoList();
 
         //Fiff information
         if(!m_pFiffInfo) {
@@ -198,17 +221,46 @@ void DummyToolbox::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
             m_pDummyOutput->data()->setVisibility(true);
         }
 
-        MatrixXd t_mat;
+        //Scheduled - hand the shared blocks to the task scheduler
+        if(isScheduled()) {
+            for(qint32 i = 0; i < t_qListBlocks.size(); ++i) {
+                postBlock(t_qListBlocks[i], t_qListBufferInfo.value(i));
+            }
+            return;
+        }
+
+        //Check if buffer initialized
+        if(!m_pDummyBuffer) {
+            m_pDummyBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, pRTMSA->getNumChannels(), t_qListBlocks[0]->cols()));
+        }
+
+        for(qint32 i = 0; i < t_qListBlocks.size(); ++i) {
+            //The info is queued first, so it is available as soon as the block can be popped
+            m_qMutexBufferInfo.lock();
+            m_qQueueBufferInfo.enqueue(t_qListBufferInfo.value(i));
+            m_qMutexBufferInfo.unlock();
 
-        for(unsigned char i = 0; i < pRTMSA->getMultiArraySize(); ++i) {
-            t_mat = pRTMSA->getMultiSampleArray()[i];
-            m_pDummyBuffer->push(&t_mat);
+            m_pDummyBuffer->push(t_qListBlocks[i].data());
         }
     }
 }
 
 
 
+//*************************************************************************************************************
+
+void DummyToolbox::process(const QSharedPointer<const Eigen::MatrixXd>& pBlock, const FiffRtBufferInfo& bufferInfo)
+{
+    if(!m_bIsRunning)
+        return;
+
+    //ToDo: Implement your algorithm here
+
+    //Send the data to the connected plugins and the online display - the block is forwarded without a copy
+    m_pDummyOutput->data()->setValue(pBlock, bufferInfo);
+}
+
+
 //*************************************************************************************************************
 
 void DummyToolbox::run()
@@ -224,11 +276,18 @@ void DummyToolbox::run()
         //Dispatch the inputs
         MatrixXd t_mat = m_pDummyBuffer->pop();
 
+        m_qMutexBufferInfo.lock();
+        FiffRtBufferInfo t_bufferInfo = m_qQueueBufferInfo.isEmpty() ? FiffRtBufferInfo() : m_qQueueBufferInfo.dequeue();
+        m_qMutexBufferInfo.unlock();
+
+        //Measure the processing of the block for the plugin statistics
+        PluginStatistics::BlockTimer t_blockTimer(statistics());
+
         //ToDo: Implement your algorithm here
 
         //Send the data to the connected plugins and the online display
         //Unocmment this if you also uncommented the m_pDummyOutput in the constructor above
-        m_pDummyOutput->data()->setValue(t_mat);
+        m_pDummyOutput->data()->setValue(t_mat, t_bufferInfo);
     }
 }
 
@@ -59,6 +59,8 @@
 #include <QtWidgets>
 #include <QtCore/QtPlugin>
 #include <QDebug>
+#include <QQueue>
+#include <QMutex>
 
 
 //*************************************************************************************************************
@@ -122,6 +124,16 @@ public:
     virtual IPlugin::PluginType getType() const;
     virtual QString getName() const;
     virtual QWidget* setupWidget();
+    virtual bool supportsScheduledProcessing() const;
+
+    //=========================================================================================================
+    /**
+    * Processes one block on the task scheduler. Used instead of run() in the scheduled execution mode.
+    *
+    * @param[in] pBlock         The block to process.
+    * @param[in] bufferInfo     The acquisition information of the block, passed on with the output.
+    */
+    virtual void process(const QSharedPointer<const Eigen::MatrixXd>& pBlock, const FIFFLIB::FiffRtBufferInfo& bufferInfo);
 
     //=========================================================================================================
     /**
@@ -148,6 +160,8 @@ private:
     QAction*                                        m_pActionShowYourWidget;/**< flag whether thread is running.*/
 
     IOBuffer::CircularMatrixBuffer<double>::SPtr    m_pDummyBuffer;         /**< Holds incoming data.*/
+    QQueue<FIFFLIB::FiffRtBufferInfo>               m_qQueueBufferInfo;     /**< Acquisition information of the blocks in m_pDummyBuffer, in the same order.*/
+    QMutex                                          m_qMutexBufferInfo;     /**< Guards m_qQueueBufferInfo.*/
 
     PluginInputData<SCMEASLIB::NewRealTimeMultiSampleArray>::SPtr      m_pDummyInput;      /**< The NewRealTimeMultiSampleArray of the DummyToolbox input.*/
     PluginOutputData<SCMEASLIB::NewRealTimeMultiSampleArray>::SPtr     m_pDummyOutput;     /**< The NewRealTimeMultiSampleArray of the DummyToolbox output.*/
@@ -0,0 +1,154 @@
+//=============================================================================================================
+/**
+* @file     fiffrecordersetupwidget.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the implementation of the FiffRecorderSetupWidget class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiffrecordersetupwidget.h"
+
+#include "../fiffrecorder.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QFileDialog>
+#include <QGridLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTimer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FiffRecorderPlugin;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffRecorderSetupWidget::FiffRecorderSetupWidget(FiffRecorder* toolbox, QWidget *parent)
+: QWidget(parent)
+, m_pFiffRecorder(toolbox)
+{
+    this->setWindowTitle("Fiff Recorder Settings");
+
+    QGridLayout* t_pGridLayout = new QGridLayout;
+
+    t_pGridLayout->addWidget(new QLabel("Record file"), 0, 0, 1, 1);
+    m_pLineEditRecordFile = new QLineEdit(m_pFiffRecorder->recordFile());
+    t_pGridLayout->addWidget(m_pLineEditRecordFile, 0, 1, 1, 1);
+    QPushButton* t_pPushButtonBrowse = new QPushButton("...");
+    t_pGridLayout->addWidget(t_pPushButtonBrowse, 0, 2, 1, 1);
+
+    t_pGridLayout->addWidget(new QLabel("Split size [MB]"), 1, 0, 1, 1);
+    m_pSpinBoxSplitSize = new QSpinBox;
+    m_pSpinBoxSplitSize->setRange(1, 1000000);
+    m_pSpinBoxSplitSize->setValue(m_pFiffRecorder->splitSize());
+    t_pGridLayout->addWidget(m_pSpinBoxSplitSize, 1, 1, 1, 2);
+
+    t_pGridLayout->addWidget(new QLabel("Samples per tag"), 2, 0, 1, 1);
+    m_pSpinBoxTagSamples = new QSpinBox;
+    m_pSpinBoxTagSamples->setRange(1, 1000000);
+    m_pSpinBoxTagSamples->setValue(m_pFiffRecorder->tagSamples());
+    t_pGridLayout->addWidget(m_pSpinBoxTagSamples, 2, 1, 1, 2);
+
+    t_pGridLayout->addWidget(new QLabel("Backlog"), 3, 0, 1, 1);
+    m_pLabelBacklog = new QLabel;
+    t_pGridLayout->addWidget(m_pLabelBacklog, 3, 1, 1, 2);
+
+    t_pGridLayout->setRowStretch(4, 1);
+    this->setLayout(t_pGridLayout);
+
+    connect(t_pPushButtonBrowse, &QPushButton::released, this, &FiffRecorderSetupWidget::browseRecordFile);
+    connect(m_pLineEditRecordFile, &QLineEdit::editingFinished, this, &FiffRecorderSetupWidget::applySettings);
+    connect(m_pSpinBoxSplitSize, &QSpinBox::editingFinished, this, &FiffRecorderSetupWidget::applySettings);
+    connect(m_pSpinBoxTagSamples, &QSpinBox::editingFinished, this, &FiffRecorderSetupWidget::applySettings);
+
+    m_pTimerBacklog = new QTimer(this);
+    connect(m_pTimerBacklog, &QTimer::timeout, this, &FiffRecorderSetupWidget::updateBacklog);
+    m_pTimerBacklog->start(500);
+
+    updateBacklog();
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorderSetupWidget::browseRecordFile()
+{
+    QString t_sFileName = QFileDialog::getSaveFileName(this, "Record file", m_pLineEditRecordFile->text(), "Fiff raw files (*.fif)");
+
+    if(!t_sFileName.isEmpty()) {
+        m_pLineEditRecordFile->setText(t_sFileName);
+        applySettings();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorderSetupWidget::applySettings()
+{
+    m_pFiffRecorder->setRecordFile(m_pLineEditRecordFile->text());
+    m_pFiffRecorder->setSplitSize(m_pSpinBoxSplitSize->value());
+    m_pFiffRecorder->setTagSamples(m_pSpinBoxTagSamples->value());
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorderSetupWidget::updateBacklog()
+{
+    FiffRecorder::Backlog t_backlog = m_pFiffRecorder->backlog();
+
+    m_pLabelBacklog->setText(QString("%1 blocks (%2 samples) queued, %3 dropped\n%4 samples written to %5 file(s)\n%6")
+                             .arg(t_backlog.blocks)
+                             .arg(t_backlog.samples)
+                             .arg(t_backlog.droppedBlocks)
+                             .arg(t_backlog.writtenSamples)
+                             .arg(t_backlog.files)
+                             .arg(t_backlog.currentFile));
+}
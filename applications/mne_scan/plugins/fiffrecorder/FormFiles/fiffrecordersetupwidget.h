@@ -0,0 +1,127 @@
+//=============================================================================================================
+/**
+* @file     fiffrecordersetupwidget.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the declaration of the FiffRecorderSetupWidget class.
+*
+*/
+
+#ifndef FIFFRECORDERSETUPWIDGET_H
+#define FIFFRECORDERSETUPWIDGET_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QWidget>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class QLabel;
+class QLineEdit;
+class QSpinBox;
+class QTimer;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE FiffRecorderPlugin
+//=============================================================================================================
+
+namespace FiffRecorderPlugin
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class FiffRecorder;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS FiffRecorderSetupWidget
+*
+* @brief The FiffRecorderSetupWidget class provides the FiffRecorder configuration window and shows the backlog of
+* the running recording.
+*/
+class FiffRecorderSetupWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    //=========================================================================================================
+    /**
+    * Constructs a FiffRecorderSetupWidget which is a child of parent.
+    *
+    * @param [in] toolbox   a pointer to the corresponding FiffRecorder.
+    * @param [in] parent    pointer to parent widget; If parent is 0, the new FiffRecorderSetupWidget becomes a window.
+    */
+    FiffRecorderSetupWidget(FiffRecorder* toolbox, QWidget *parent = 0);
+
+private slots:
+    //=========================================================================================================
+    /**
+    * Lets the user choose the record file.
+    */
+    void browseRecordFile();
+
+    //=========================================================================================================
+    /**
+    * Hands the edited settings to the recorder.
+    */
+    void applySettings();
+
+    //=========================================================================================================
+    /**
+    * Refreshes the backlog display.
+    */
+    void updateBacklog();
+
+private:
+    FiffRecorder*   m_pFiffRecorder;            /**< Holds a pointer to corresponding FiffRecorder.*/
+
+    QLineEdit*      m_pLineEditRecordFile;      /**< The record file.*/
+    QSpinBox*       m_pSpinBoxSplitSize;        /**< The split size in MB.*/
+    QSpinBox*       m_pSpinBoxTagSamples;       /**< The samples per data tag.*/
+    QLabel*         m_pLabelBacklog;            /**< Shows the backlog of the recording.*/
+    QTimer*         m_pTimerBacklog;            /**< Refreshes the backlog display.*/
+};
+
+} // NAMESPACE
+
+#endif // FIFFRECORDERSETUPWIDGET_H
@@ -0,0 +1,522 @@
+//=============================================================================================================
+/**
+* @file     fiffrecorder.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the implementation of the FiffRecorder class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiffrecorder.h"
+#include "FormFiles/fiffrecordersetupwidget.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSettings>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FiffRecorderPlugin;
+using namespace SCSHAREDLIB;
+using namespace SCMEASLIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffRecorder::FiffRecorder()
+: m_bIsRunning(false)
+, m_iQueuedSamples(0)
+, m_iDroppedBlocks(0)
+, m_iWrittenSamples(0)
+, m_iFileCount(0)
+, m_iSplitBytes(0)
+, m_iTagFill(0)
+, m_pRecorderInput(NULL)
+{
+    QSettings settings;
+    m_sRecordFile = settings.value(QString("Plugin/%1/recordFile").arg(this->getName()), QDir::homePath() + "/mne_scan_recording_raw.fif").toString();
+    m_iSplitSizeMB = settings.value(QString("Plugin/%1/splitSizeMB").arg(this->getName()), FIFFRECORDER_SPLIT_SIZE_MB).toInt();
+    m_iTagSamples = settings.value(QString("Plugin/%1/tagSamples").arg(this->getName()), FIFFRECORDER_TAG_SAMPLES).toInt();
+}
+
+
+//*************************************************************************************************************
+
+FiffRecorder::~FiffRecorder()
+{
+    if(this->isRunning()) {
+        stop();
+        QThread::wait();
+    }
+
+    QSettings settings;
+    settings.setValue(QString("Plugin/%1/recordFile").arg(this->getName()), m_sRecordFile);
+    settings.setValue(QString("Plugin/%1/splitSizeMB").arg(this->getName()), m_iSplitSizeMB);
+    settings.setValue(QString("Plugin/%1/tagSamples").arg(this->getName()), m_iTagSamples);
+}
+
+
+//*************************************************************************************************************
+
+QSharedPointer<IPlugin> FiffRecorder::clone() const
+{
+    QSharedPointer<FiffRecorder> pFiffRecorderClone(new FiffRecorder);
+    return pFiffRecorderClone;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::init()
+{
+    // Input
+    m_pRecorderInput = PluginInputData<NewRealTimeMultiSampleArray>::create(this, "FiffRecorderIn", "Fiff recorder input data");
+    connect(m_pRecorderInput.data(), &PluginInputConnector::notify, this, &FiffRecorder::update, Qt::DirectConnection);
+    m_inputConnectors.append(m_pRecorderInput);
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::unload()
+{
+
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRecorder::start()
+{
+    //Let a previous recording finish writing its backlog
+    if(this->isRunning())
+        QThread::wait();
+
+    m_qMutex.lock();
+    m_qQueueBlocks.clear();
+    m_iQueuedSamples = 0;
+    m_iDroppedBlocks = 0;
+    m_iWrittenSamples = 0;
+    m_iFileCount = 0;
+    m_sCurrentFile.clear();
+    //Take the measurement info of this recording from its first block, the upstream info may have changed
+    m_pFiffInfo.clear();
+    m_bIsRunning = true;
+    m_qMutex.unlock();
+
+    //Start writer thread
+    QThread::start();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRecorder::stop()
+{
+    //The writer drains the backlog and closes the file on its own
+    m_qMutex.lock();
+    m_bIsRunning = false;
+    m_qWaitCondition.wakeAll();
+    m_qMutex.unlock();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+IPlugin::PluginType FiffRecorder::getType() const
+{
+    return _IAlgorithm;
+}
+
+
+//*************************************************************************************************************
+
+QString FiffRecorder::getName() const
+{
+    return "Fiff Recorder";
+}
+
+
+//*************************************************************************************************************
+
+QWidget* FiffRecorder::setupWidget()
+{
+    FiffRecorderSetupWidget* setupWidget = new FiffRecorderSetupWidget(this);//widget is later distroyed by CentralWidget - so it has to be created everytime new
+    return setupWidget;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
+{
+    QSharedPointer<NewRealTimeMultiSampleArray> pRTMSA = pMeasurement.dynamicCast<NewRealTimeMultiSampleArray>();
+
+    if(pRTMSA) {
+        //Shared blocks of the measurement - only the handles are queued, nothing is copied here
+        QList<NewRealTimeMultiSampleArray::ConstMatrixPtr> t_qListBlocks = pRTMSA->getMultiSampleBlocks();
+        if(t_qListBlocks.isEmpty())
+            return;
+
+        QMutexLocker t_locker(&m_qMutex);
+
+        if(!m_bIsRunning)
+            return;
+
+        //Fiff information
+        if(!m_pFiffInfo)
+            m_pFiffInfo = pRTMSA->info();
+
+        for(qint32 i = 0; i < t_qListBlocks.size(); ++i) {
+            if(m_qQueueBlocks.size() >= FIFFRECORDER_MAX_BACKLOG) {
+                if(m_iDroppedBlocks == 0)
+                    qWarning() << "FiffRecorder::update - Writer can not keep up, dropping blocks.";
+                ++m_iDroppedBlocks;
+                continue;
+            }
+
+            m_qQueueBlocks.enqueue(t_qListBlocks[i]);
+            m_iQueuedSamples += t_qListBlocks[i]->cols();
+        }
+
+        m_qWaitCondition.wakeAll();
+    }
+}
+
+
+//*************************************************************************************************************
+
+FiffRecorder::Backlog FiffRecorder::backlog() const
+{
+    QMutexLocker t_locker(&m_qMutex);
+
+    Backlog t_backlog;
+    t_backlog.blocks = m_qQueueBlocks.size();
+    t_backlog.samples = m_iQueuedSamples;
+    t_backlog.droppedBlocks = m_iDroppedBlocks;
+    t_backlog.writtenSamples = m_iWrittenSamples;
+    t_backlog.files = m_iFileCount;
+    t_backlog.currentFile = m_sCurrentFile;
+
+    return t_backlog;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::setRecordFile(const QString& sFileName)
+{
+    QMutexLocker t_locker(&m_qMutex);
+    m_sRecordFile = sFileName;
+}
+
+
+//*************************************************************************************************************
+
+QString FiffRecorder::recordFile() const
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_sRecordFile;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::setSplitSize(qint32 iMegaBytes)
+{
+    QMutexLocker t_locker(&m_qMutex);
+    m_iSplitSizeMB = qMax(1, iMegaBytes);
+}
+
+
+//*************************************************************************************************************
+
+qint32 FiffRecorder::splitSize() const
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_iSplitSizeMB;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::setTagSamples(qint32 iSamples)
+{
+    QMutexLocker t_locker(&m_qMutex);
+    m_iTagSamples = qMax(1, iSamples);
+}
+
+
+//*************************************************************************************************************
+
+qint32 FiffRecorder::tagSamples() const
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_iTagSamples;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::run()
+{
+    //Take over the settings of this recording
+    m_qMutex.lock();
+    m_sBaseFile = m_sRecordFile;
+    m_iSplitBytes = (qint64)m_iSplitSizeMB * 1024 * 1024;
+    m_iTagFill = 0;
+    m_matTag.resize(0, m_iTagSamples);
+    m_qMutex.unlock();
+
+    //Never overwrite an existing recording
+    if(QFile::exists(m_sBaseFile)) {
+        QFileInfo t_fileInfo(m_sBaseFile);
+        QString t_sSuffix = m_sBaseFile.endsWith("_raw.fif") ? "_raw.fif" : ".fif";
+        QString t_sStem = m_sBaseFile.endsWith(t_sSuffix) ? m_sBaseFile.left(m_sBaseFile.size() - t_sSuffix.size()) : m_sBaseFile;
+        m_sBaseFile = t_sStem + QDateTime::currentDateTime().toString("_yyMMdd_hhmmss") + t_sSuffix;
+        qWarning() << "FiffRecorder::run -" << t_fileInfo.fileName() << "exists, recording to" << m_sBaseFile;
+    }
+
+    bool t_bFileError = false;
+
+    while(true)
+    {
+        m_qMutex.lock();
+
+        while(m_bIsRunning && m_qQueueBlocks.isEmpty())
+            m_qWaitCondition.wait(&m_qMutex);
+
+        //Stopped and the backlog is written
+        if(m_qQueueBlocks.isEmpty()) {
+            m_qMutex.unlock();
+            break;
+        }
+
+        NewRealTimeMultiSampleArray::ConstMatrixPtr t_pBlock = m_qQueueBlocks.dequeue();
+        m_iQueuedSamples -= t_pBlock->cols();
+
+        m_qMutex.unlock();
+
+        if(!m_pStream && !t_bFileError)
+            t_bFileError = !openFile(m_sBaseFile);
+
+        if(t_bFileError || t_pBlock->rows() != m_vecInvCals.cols()) {
+            m_qMutex.lock();
+            ++m_iDroppedBlocks;
+            m_qMutex.unlock();
+            continue;
+        }
+
+        appendBlock(*t_pBlock);
+
+        //A failed split leaves no stream - drop the rest of the recording instead of overwriting the first file
+        t_bFileError = !m_pStream;
+    }
+
+    closeFile();
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRecorder::openFile(const QString& sFileName)
+{
+    m_qMutex.lock();
+    FiffInfo::SPtr t_pFiffInfo = m_pFiffInfo;
+    m_qMutex.unlock();
+
+    if(!t_pFiffInfo) {
+        qWarning() << "FiffRecorder::openFile - Fiff info missing, nothing is recorded.";
+        return false;
+    }
+
+    //Always write the raw data - the projectors are stored inactive
+    FiffInfo t_fiffInfo(*t_pFiffInfo);
+    for(qint32 i = 0; i < t_fiffInfo.projs.size(); ++i)
+        t_fiffInfo.projs[i].active = false;
+
+    m_qFile.setFileName(sFileName);
+    m_pStream = FiffStream::start_writing_raw(m_qFile, t_fiffInfo, m_vecCals, defaultMatrixXi, false);
+
+    if(!m_pStream) {
+        qWarning() << "FiffRecorder::openFile - Could not open" << sFileName;
+        return false;
+    }
+
+    fiff_int_t first = (fiff_int_t)m_iWrittenSamples;
+    m_pStream->write_int(FIFF_FIRST_SAMPLE, &first);
+
+    //The stream carries calibrated data - undo the calibration once per sample while gathering the tag
+    m_vecInvCals = RowVectorXd::Ones(m_vecCals.cols());
+    for(qint32 i = 0; i < m_vecCals.cols(); ++i)
+        if(m_vecCals[i] != 0.0)
+            m_vecInvCals[i] = 1.0 / m_vecCals[i];
+
+    if(m_matTag.rows() != m_vecCals.cols())
+        m_matTag.resize(m_vecCals.cols(), m_matTag.cols());
+
+    m_qMutex.lock();
+    ++m_iFileCount;
+    m_sCurrentFile = sFileName;
+    m_qMutex.unlock();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::splitFile()
+{
+    qint32 t_iSplit;
+    m_qMutex.lock();
+    t_iSplit = m_iFileCount;
+    m_qMutex.unlock();
+
+    QString t_sNextFile = splitFileName(t_iSplit);
+
+    //Write the link to the next file
+    qint32 data;
+    m_pStream->start_block(FIFFB_REF);
+    data = FIFFV_ROLE_NEXT_FILE;
+    m_pStream->write_int(FIFF_REF_ROLE, &data);
+    m_pStream->write_string(FIFF_REF_FILE_NAME, QFileInfo(t_sNextFile).fileName());
+    m_pStream->write_id(FIFF_REF_FILE_ID);
+    data = t_iSplit;
+    m_pStream->write_int(FIFF_REF_FILE_NUM, &data);
+    m_pStream->end_block(FIFFB_REF);
+
+    m_pStream->finish_writing_raw();
+    m_pStream.clear();
+
+    openFile(t_sNextFile);
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::closeFile()
+{
+    if(!m_pStream)
+        return;
+
+    writeTag();
+
+    m_pStream->finish_writing_raw();
+    m_pStream.clear();
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::appendBlock(const MatrixXd& matBlock)
+{
+    qint32 iCol = 0;
+    while(iCol < matBlock.cols()) {
+        qint32 iTake = qMin((qint32)matBlock.cols() - iCol, (qint32)m_matTag.cols() - m_iTagFill);
+
+        m_matTag.middleCols(m_iTagFill, iTake) = m_vecInvCals.asDiagonal() * matBlock.middleCols(iCol, iTake);
+
+        m_iTagFill += iTake;
+        iCol += iTake;
+
+        if(m_iTagFill == m_matTag.cols()) {
+            writeTag();
+
+            if(m_qFile.size() >= m_iSplitBytes)
+                splitFile();
+
+            //A failed split leaves no stream - the rest of the block is lost
+            if(!m_pStream)
+                return;
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void FiffRecorder::writeTag()
+{
+    if(m_iTagFill == 0 || !m_pStream)
+        return;
+
+    if(m_iTagFill == m_matTag.cols())
+        m_pStream->write_raw_buffer(m_matTag);
+    else
+        m_pStream->write_raw_buffer(m_matTag.leftCols(m_iTagFill));
+
+    m_qMutex.lock();
+    m_iWrittenSamples += m_iTagFill;
+    m_qMutex.unlock();
+
+    m_iTagFill = 0;
+}
+
+
+//*************************************************************************************************************
+
+QString FiffRecorder::splitFileName(qint32 iSplit) const
+{
+    if(iSplit == 0)
+        return m_sBaseFile;
+
+    if(m_sBaseFile.endsWith("_raw.fif"))
+        return m_sBaseFile.left(m_sBaseFile.size() - 8) + QString("-%1_raw.fif").arg(iSplit);
+
+    if(m_sBaseFile.endsWith(".fif"))
+        return m_sBaseFile.left(m_sBaseFile.size() - 4) + QString("-%1.fif").arg(iSplit);
+
+    return m_sBaseFile + QString("-%1.fif").arg(iSplit);
+}
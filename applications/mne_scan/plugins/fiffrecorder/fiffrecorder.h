@@ -0,0 +1,299 @@
+//=============================================================================================================
+/**
+* @file     fiffrecorder.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the declaration of the FiffRecorder class.
+*
+*/
+
+#ifndef FIFFRECORDER_H
+#define FIFFRECORDER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiffrecorder_global.h"
+
+#include <scShared/Interfaces/IAlgorithm.h>
+#include <scMeas/newrealtimemultisamplearray.h>
+
+#include <fiff/fiff_info.h>
+#include <fiff/fiff_stream.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtWidgets>
+#include <QtCore/QtPlugin>
+#include <QFile>
+#include <QMutex>
+#include <QQueue>
+#include <QWaitCondition>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define FIFFRECORDER_SPLIT_SIZE_MB      2000    /**< Default file size in MB at which the recording continues in the next file. */
+#define FIFFRECORDER_TAG_SAMPLES        4096    /**< Default number of samples per FIFF_DATA_BUFFER tag. */
+#define FIFFRECORDER_MAX_BACKLOG        8192    /**< Maximal number of blocks waiting for the writer before blocks are dropped. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE FiffRecorderPlugin
+//=============================================================================================================
+
+namespace FiffRecorderPlugin
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace SCSHAREDLIB;
+
+
+//=============================================================================================================
+/**
+* Records a NewRealTimeMultiSampleArray stream to fiff files. The input connector only enqueues the shared block
+* handles; the plugin's thread gathers the blocks into large FIFF_DATA_BUFFER tags and writes them, so a slow disk
+* never stalls the pipeline. Files are split at a configurable size following the "-1.fif" naming. If the writer
+* falls more than FIFFRECORDER_MAX_BACKLOG blocks behind, incoming blocks are dropped and counted instead of
+* blocking the sender.
+*
+* @brief The FiffRecorder class provides an asynchronous fiff recording sink.
+*/
+class FIFFRECORDERSHARED_EXPORT FiffRecorder : public IAlgorithm
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID "scsharedlib/1.0" FILE "fiffrecorder.json") //NEw Qt5 Plugin system replaces Q_EXPORT_PLUGIN2 macro
+    // Use the Q_INTERFACES() macro to tell Qt's meta-object system about the interfaces
+    Q_INTERFACES(SCSHAREDLIB::IAlgorithm)
+
+public:
+    //=========================================================================================================
+    /**
+    * State of the recording.
+    */
+    struct Backlog {
+        qint32  blocks;             /**< Blocks waiting for the writer. */
+        qint64  samples;            /**< Samples waiting for the writer. */
+        qint64  droppedBlocks;      /**< Blocks dropped because the backlog was full or the file could not be written. */
+        qint64  writtenSamples;     /**< Samples written to the current recording. */
+        qint32  files;              /**< Number of files of the current recording. */
+        QString currentFile;        /**< The file which is currently written. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs a FiffRecorder.
+    */
+    FiffRecorder();
+
+    //=========================================================================================================
+    /**
+    * Destroys the FiffRecorder.
+    */
+    ~FiffRecorder();
+
+    //=========================================================================================================
+    /**
+    * IAlgorithm functions
+    */
+    virtual QSharedPointer<IPlugin> clone() const;
+    virtual void init();
+    virtual void unload();
+    virtual bool start();
+    virtual bool stop();
+    virtual IPlugin::PluginType getType() const;
+    virtual QString getName() const;
+    virtual QWidget* setupWidget();
+
+    //=========================================================================================================
+    /**
+    * Enqueues the blocks of the incoming measurement for the writer.
+    *
+    * @param[in] pMeasurement    The incoming data in form of a generalized NewMeasurement.
+    */
+    void update(SCMEASLIB::NewMeasurement::SPtr pMeasurement);
+
+    //=========================================================================================================
+    /**
+    * Returns the state of the recording.
+    *
+    * @return the backlog and progress of the recording.
+    */
+    Backlog backlog() const;
+
+    //=========================================================================================================
+    /**
+    * Sets the file of the next recording. If the file exists, a time stamp is appended to the name.
+    *
+    * @param[in] sFileName  The file name, usually ending with "_raw.fif".
+    */
+    void setRecordFile(const QString& sFileName);
+
+    //=========================================================================================================
+    /**
+    * Returns the file of the next recording.
+    *
+    * @return the file name.
+    */
+    QString recordFile() const;
+
+    //=========================================================================================================
+    /**
+    * Sets the file size at which the next recording continues in a new file.
+    *
+    * @param[in] iMegaBytes     The split size in MB.
+    */
+    void setSplitSize(qint32 iMegaBytes);
+
+    //=========================================================================================================
+    /**
+    * Returns the split size.
+    *
+    * @return the split size in MB.
+    */
+    qint32 splitSize() const;
+
+    //=========================================================================================================
+    /**
+    * Sets the number of samples which are gathered into one data tag for the next recording.
+    *
+    * @param[in] iSamples   The number of samples per tag.
+    */
+    void setTagSamples(qint32 iSamples);
+
+    //=========================================================================================================
+    /**
+    * Returns the number of samples per data tag.
+    *
+    * @return the number of samples per tag.
+    */
+    qint32 tagSamples() const;
+
+protected:
+    //=========================================================================================================
+    /**
+    * IAlgorithm function - the writer loop.
+    */
+    virtual void run();
+
+private:
+    //=========================================================================================================
+    /**
+    * Starts writing the given file. Writer thread only.
+    *
+    * @param[in] sFileName  The file to write.
+    *
+    * @return true if the file was opened.
+    */
+    bool openFile(const QString& sFileName);
+
+    //=========================================================================================================
+    /**
+    * Links the current file to the next split file, closes it and opens the next one. Writer thread only.
+    */
+    void splitFile();
+
+    //=========================================================================================================
+    /**
+    * Writes the pending samples and closes the current file. Writer thread only.
+    */
+    void closeFile();
+
+    //=========================================================================================================
+    /**
+    * Appends a block to the data tag, writes the tag once it is full and splits the file when it reached the split
+    * size. Writer thread only.
+    *
+    * @param[in] matBlock   The calibrated data block.
+    */
+    void appendBlock(const Eigen::MatrixXd& matBlock);
+
+    //=========================================================================================================
+    /**
+    * Writes the gathered samples as one data tag. Writer thread only.
+    */
+    void writeTag();
+
+    //=========================================================================================================
+    /**
+    * Returns the name of a split file of the current recording.
+    *
+    * @param[in] iSplit     The split number, 0 for the first file.
+    *
+    * @return the file name.
+    */
+    QString splitFileName(qint32 iSplit) const;
+
+    bool                                    m_bIsRunning;           /**< Flag whether the recording is running. Guarded by m_qMutex. */
+
+    FIFFLIB::FiffInfo::SPtr                 m_pFiffInfo;            /**< Fiff measurement info of the current recording, taken from its first block. */
+
+    mutable QMutex                          m_qMutex;               /**< Guards the queue, the counters and the settings. */
+    QWaitCondition                          m_qWaitCondition;       /**< Wakes the writer when blocks are enqueued or the recording stops. */
+    QQueue<SCMEASLIB::NewRealTimeMultiSampleArray::ConstMatrixPtr> m_qQueueBlocks;    /**< Blocks waiting for the writer. */
+    qint64                                  m_iQueuedSamples;       /**< Samples in m_qQueueBlocks. */
+    qint64                                  m_iDroppedBlocks;       /**< Dropped blocks of the current recording. */
+    qint64                                  m_iWrittenSamples;      /**< Written samples of the current recording. */
+    qint32                                  m_iFileCount;           /**< Files of the current recording. */
+    QString                                 m_sCurrentFile;         /**< The file which is currently written. */
+
+    QString                                 m_sRecordFile;          /**< File of the next recording. */
+    qint32                                  m_iSplitSizeMB;         /**< Split size of the next recording in MB. */
+    qint32                                  m_iTagSamples;          /**< Samples per data tag of the next recording. */
+
+    QString                                 m_sBaseFile;            /**< First file of the current recording. Writer thread only. */
+    qint64                                  m_iSplitBytes;          /**< Split size of the current recording in bytes. Writer thread only. */
+    QFile                                   m_qFile;                /**< The file which is currently written. Writer thread only. */
+    FIFFLIB::FiffStream::SPtr               m_pStream;              /**< The stream of the current file. Writer thread only. */
+    Eigen::RowVectorXd                      m_vecCals;              /**< Calibrations of the channels. Writer thread only. */
+    Eigen::RowVectorXd                      m_vecInvCals;           /**< Inverse calibrations which convert the data back to raw units. Writer thread only. */
+    Eigen::MatrixXd                         m_matTag;               /**< The data tag which is being gathered. Writer thread only. */
+    qint32                                  m_iTagFill;             /**< Number of gathered samples in m_matTag. Writer thread only. */
+
+    PluginInputData<SCMEASLIB::NewRealTimeMultiSampleArray>::SPtr      m_pRecorderInput;   /**< The NewRealTimeMultiSampleArray input of the recorder.*/
+};
+
+} // NAMESPACE
+
+#endif // FIFFRECORDER_H
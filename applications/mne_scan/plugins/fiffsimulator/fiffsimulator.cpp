@@ -355,6 +355,10 @@ bool FiffSimulator::stop()
 
         m_pRawMatrixBuffer_In->clear();
 
+        m_qMutexBufferInfo.lock();
+        m_qQueueBufferInfo.clear();
+        m_qMutexBufferInfo.unlock();
+
         m_pRTMSA_FiffSimulator->data()->clear();
     }
 
@@ -393,6 +397,7 @@ QWidget* FiffSimulator::setupWidget()
 void FiffSimulator::run()
 {
     MatrixXf matValue;
+    FiffRtBufferInfo bufferInfo;
     while(true)
     {
         {
@@ -403,7 +408,11 @@ void FiffSimulator::run()
         //pop matrix
         matValue = m_pRawMatrixBuffer_In->pop();
 
+        m_qMutexBufferInfo.lock();
+        bufferInfo = m_qQueueBufferInfo.isEmpty() ? FiffRtBufferInfo() : m_qQueueBufferInfo.dequeue();
+        m_qMutexBufferInfo.unlock();
+
         //emit values
-        m_pRTMSA_FiffSimulator->data()->setValue(matValue.cast<double>());
+        m_pRTMSA_FiffSimulator->data()->setValue(matValue.cast<double>(), bufferInfo);
     }
 }
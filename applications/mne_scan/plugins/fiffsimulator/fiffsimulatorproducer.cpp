@@ -227,6 +227,12 @@ void FiffSimulatorProducer::run()
             {
                 to += t_matRawBuffer.cols();
                 from += t_matRawBuffer.cols();
+
+                //Info is enqueued first, it is available as soon as the buffer can be popped
+                m_pFiffSimulator->m_qMutexBufferInfo.lock();
+                m_pFiffSimulator->m_qQueueBufferInfo.enqueue(m_pRtDataClient->lastBufferInfo());
+                m_pFiffSimulator->m_qMutexBufferInfo.unlock();
+
                 m_pFiffSimulator->m_pRawMatrixBuffer_In->push(&t_matRawBuffer);
             }
             else if(FIFF_DATA_BUFFER == FIFF_BLOCK_END)
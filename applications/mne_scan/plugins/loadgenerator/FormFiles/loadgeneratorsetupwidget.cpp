@@ -0,0 +1,171 @@
+//=============================================================================================================
+/**
+* @file     loadgeneratorsetupwidget.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the implementation of the LoadGeneratorSetupWidget class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "loadgeneratorsetupwidget.h"
+
+#include "../loadgenerator.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDoubleSpinBox>
+#include <QGridLayout>
+#include <QLabel>
+#include <QSpinBox>
+#include <QTimer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace LoadGeneratorPlugin;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+LoadGeneratorSetupWidget::LoadGeneratorSetupWidget(LoadGenerator* simulator, QWidget *parent)
+: QWidget(parent)
+, m_pLoadGenerator(simulator)
+{
+    this->setWindowTitle("Load Generator Settings");
+
+    LoadGenerator::Settings t_settings = m_pLoadGenerator->settings();
+
+    QGridLayout* t_pGridLayout = new QGridLayout;
+
+    t_pGridLayout->addWidget(new QLabel("EEG channels"), 0, 0, 1, 1);
+    m_pSpinBoxChannels = new QSpinBox;
+    m_pSpinBoxChannels->setRange(1, LOADGENERATOR_MAX_CHANNELS);
+    m_pSpinBoxChannels->setValue(t_settings.numChannels);
+    t_pGridLayout->addWidget(m_pSpinBoxChannels, 0, 1, 1, 1);
+
+    t_pGridLayout->addWidget(new QLabel("Sampling rate [Hz]"), 1, 0, 1, 1);
+    m_pSpinBoxSamplingRate = new QDoubleSpinBox;
+    m_pSpinBoxSamplingRate->setRange(1.0, LOADGENERATOR_MAX_SAMPLING_RATE);
+    m_pSpinBoxSamplingRate->setValue(t_settings.samplingRate);
+    t_pGridLayout->addWidget(m_pSpinBoxSamplingRate, 1, 1, 1, 1);
+
+    t_pGridLayout->addWidget(new QLabel("Block size [samples]"), 2, 0, 1, 1);
+    m_pSpinBoxBlockSize = new QSpinBox;
+    m_pSpinBoxBlockSize->setRange(1, 100000);
+    m_pSpinBoxBlockSize->setValue(t_settings.blockSize);
+    t_pGridLayout->addWidget(m_pSpinBoxBlockSize, 2, 1, 1, 1);
+
+    t_pGridLayout->addWidget(new QLabel("Base frequency [Hz]"), 3, 0, 1, 1);
+    m_pSpinBoxFrequency = new QDoubleSpinBox;
+    m_pSpinBoxFrequency->setRange(0.0, LOADGENERATOR_MAX_SAMPLING_RATE / 20.0);
+    m_pSpinBoxFrequency->setValue(t_settings.frequency);
+    t_pGridLayout->addWidget(m_pSpinBoxFrequency, 3, 1, 1, 1);
+
+    t_pGridLayout->addWidget(new QLabel("Amplitude [uV]"), 4, 0, 1, 1);
+    m_pSpinBoxAmplitude = new QDoubleSpinBox;
+    m_pSpinBoxAmplitude->setRange(0.0, 1.0e6);
+    m_pSpinBoxAmplitude->setValue(t_settings.amplitude * 1.0e6);
+    t_pGridLayout->addWidget(m_pSpinBoxAmplitude, 4, 1, 1, 1);
+
+    t_pGridLayout->addWidget(new QLabel("Noise [uV]"), 5, 0, 1, 1);
+    m_pSpinBoxNoise = new QDoubleSpinBox;
+    m_pSpinBoxNoise->setRange(0.0, 1.0e6);
+    m_pSpinBoxNoise->setValue(t_settings.noise * 1.0e6);
+    t_pGridLayout->addWidget(m_pSpinBoxNoise, 5, 1, 1, 1);
+
+    t_pGridLayout->addWidget(new QLabel("Trigger interval [ms], 0 = off"), 6, 0, 1, 1);
+    m_pSpinBoxTriggerInterval = new QSpinBox;
+    m_pSpinBoxTriggerInterval->setRange(0, 3600000);
+    m_pSpinBoxTriggerInterval->setValue(t_settings.triggerInterval);
+    t_pGridLayout->addWidget(m_pSpinBoxTriggerInterval, 6, 1, 1, 1);
+
+    m_pLabelTiming = new QLabel;
+    t_pGridLayout->addWidget(m_pLabelTiming, 7, 0, 1, 2);
+
+    t_pGridLayout->setRowStretch(8, 1);
+    this->setLayout(t_pGridLayout);
+
+    connect(m_pSpinBoxChannels, &QSpinBox::editingFinished, this, &LoadGeneratorSetupWidget::applySettings);
+    connect(m_pSpinBoxSamplingRate, &QDoubleSpinBox::editingFinished, this, &LoadGeneratorSetupWidget::applySettings);
+    connect(m_pSpinBoxBlockSize, &QSpinBox::editingFinished, this, &LoadGeneratorSetupWidget::applySettings);
+    connect(m_pSpinBoxFrequency, &QDoubleSpinBox::editingFinished, this, &LoadGeneratorSetupWidget::applySettings);
+    connect(m_pSpinBoxAmplitude, &QDoubleSpinBox::editingFinished, this, &LoadGeneratorSetupWidget::applySettings);
+    connect(m_pSpinBoxNoise, &QDoubleSpinBox::editingFinished, this, &LoadGeneratorSetupWidget::applySettings);
+    connect(m_pSpinBoxTriggerInterval, &QSpinBox::editingFinished, this, &LoadGeneratorSetupWidget::applySettings);
+
+    m_pTimerTiming = new QTimer(this);
+    connect(m_pTimerTiming, &QTimer::timeout, this, &LoadGeneratorSetupWidget::updateTiming);
+    m_pTimerTiming->start(500);
+
+    updateTiming();
+}
+
+
+//*************************************************************************************************************
+
+void LoadGeneratorSetupWidget::applySettings()
+{
+    LoadGenerator::Settings t_settings;
+    t_settings.numChannels = m_pSpinBoxChannels->value();
+    t_settings.samplingRate = m_pSpinBoxSamplingRate->value();
+    t_settings.blockSize = m_pSpinBoxBlockSize->value();
+    t_settings.frequency = m_pSpinBoxFrequency->value();
+    t_settings.amplitude = m_pSpinBoxAmplitude->value() * 1.0e-6;
+    t_settings.noise = m_pSpinBoxNoise->value() * 1.0e-6;
+    t_settings.triggerInterval = m_pSpinBoxTriggerInterval->value();
+
+    m_pLoadGenerator->setSettings(t_settings);
+}
+
+
+//*************************************************************************************************************
+
+void LoadGeneratorSetupWidget::updateTiming()
+{
+    LoadGenerator::Timing t_timing = m_pLoadGenerator->timing();
+
+    m_pLabelTiming->setText(QString("%1 blocks published, %2 late, %3 samples/s")
+                            .arg(t_timing.publishedBlocks)
+                            .arg(t_timing.lateBlocks)
+                            .arg(t_timing.achievedRate, 0, 'f', 1));
+}
@@ -0,0 +1,125 @@
+//=============================================================================================================
+/**
+* @file     loadgeneratorsetupwidget.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the declaration of the LoadGeneratorSetupWidget class.
+*
+*/
+
+#ifndef LOADGENERATORSETUPWIDGET_H
+#define LOADGENERATORSETUPWIDGET_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QWidget>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class QDoubleSpinBox;
+class QLabel;
+class QSpinBox;
+class QTimer;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE LoadGeneratorPlugin
+//=============================================================================================================
+
+namespace LoadGeneratorPlugin
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class LoadGenerator;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS LoadGeneratorSetupWidget
+*
+* @brief The LoadGeneratorSetupWidget class provides the LoadGenerator configuration window and shows the timing of
+* the running generator.
+*/
+class LoadGeneratorSetupWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    //=========================================================================================================
+    /**
+    * Constructs a LoadGeneratorSetupWidget which is a child of parent.
+    *
+    * @param [in] simulator     a pointer to the corresponding LoadGenerator.
+    * @param [in] parent        pointer to parent widget; If parent is 0, the new LoadGeneratorSetupWidget becomes a window.
+    */
+    LoadGeneratorSetupWidget(LoadGenerator* simulator, QWidget *parent = 0);
+
+private slots:
+    //=========================================================================================================
+    /**
+    * Hands the edited settings to the generator. They take effect with the next start.
+    */
+    void applySettings();
+
+    //=========================================================================================================
+    /**
+    * Refreshes the timing display.
+    */
+    void updateTiming();
+
+private:
+    LoadGenerator*      m_pLoadGenerator;           /**< Holds a pointer to corresponding LoadGenerator.*/
+
+    QSpinBox*           m_pSpinBoxChannels;         /**< Number of EEG channels.*/
+    QDoubleSpinBox*     m_pSpinBoxSamplingRate;     /**< Sampling rate in Hz.*/
+    QSpinBox*           m_pSpinBoxBlockSize;        /**< Samples per block.*/
+    QDoubleSpinBox*     m_pSpinBoxFrequency;        /**< Base frequency of the sinusoids in Hz.*/
+    QDoubleSpinBox*     m_pSpinBoxAmplitude;        /**< Amplitude of the sinusoids in uV.*/
+    QDoubleSpinBox*     m_pSpinBoxNoise;            /**< Noise standard deviation in uV.*/
+    QSpinBox*           m_pSpinBoxTriggerInterval;  /**< Trigger interval in ms.*/
+    QLabel*             m_pLabelTiming;             /**< Shows the timing of the running generator.*/
+    QTimer*             m_pTimerTiming;             /**< Refreshes the timing display.*/
+};
+
+} // NAMESPACE
+
+#endif // LOADGENERATORSETUPWIDGET_H
@@ -0,0 +1,436 @@
+//=============================================================================================================
+/**
+* @file     loadgenerator.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the implementation of the LoadGenerator class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "loadgenerator.h"
+#include "FormFiles/loadgeneratorsetupwidget.h"
+
+#include <generics/matrixpool.h>
+#include <fiff/fiff_rt_buffer_info.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QSettings>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <random>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace LoadGeneratorPlugin;
+using namespace SCSHAREDLIB;
+using namespace SCMEASLIB;
+using namespace FIFFLIB;
+using namespace IOBuffer;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+LoadGenerator::LoadGenerator()
+: m_pRTMSA_LoadGenerator(NULL)
+, m_bIsRunning(false)
+, m_uiNoiseState(1)
+, m_iSampleCount(0)
+, m_iTriggerSamples(0)
+, m_iPulseSamples(1)
+, m_iStimChannel(-1)
+{
+    QSettings settings;
+    Settings t_settings;
+    t_settings.numChannels = settings.value(QString("Plugin/%1/numChannels").arg(this->getName()), 306).toInt();
+    t_settings.samplingRate = settings.value(QString("Plugin/%1/samplingRate").arg(this->getName()), 1000.0).toDouble();
+    t_settings.blockSize = settings.value(QString("Plugin/%1/blockSize").arg(this->getName()), 100).toInt();
+    t_settings.frequency = settings.value(QString("Plugin/%1/frequency").arg(this->getName()), 10.0).toDouble();
+    t_settings.amplitude = settings.value(QString("Plugin/%1/amplitude").arg(this->getName()), 1.0e-5).toDouble();
+    t_settings.noise = settings.value(QString("Plugin/%1/noise").arg(this->getName()), 2.0e-6).toDouble();
+    t_settings.triggerInterval = settings.value(QString("Plugin/%1/triggerInterval").arg(this->getName()), 1000).toInt();
+    setSettings(t_settings);
+
+    m_timing.publishedBlocks = 0;
+    m_timing.lateBlocks = 0;
+    m_timing.achievedRate = 0.0;
+}
+
+
+//*************************************************************************************************************
+
+LoadGenerator::~LoadGenerator()
+{
+    if(this->isRunning()) {
+        stop();
+        QThread::wait();
+    }
+
+    Settings t_settings = settings();
+
+    QSettings settings;
+    settings.setValue(QString("Plugin/%1/numChannels").arg(this->getName()), t_settings.numChannels);
+    settings.setValue(QString("Plugin/%1/samplingRate").arg(this->getName()), t_settings.samplingRate);
+    settings.setValue(QString("Plugin/%1/blockSize").arg(this->getName()), t_settings.blockSize);
+    settings.setValue(QString("Plugin/%1/frequency").arg(this->getName()), t_settings.frequency);
+    settings.setValue(QString("Plugin/%1/amplitude").arg(this->getName()), t_settings.amplitude);
+    settings.setValue(QString("Plugin/%1/noise").arg(this->getName()), t_settings.noise);
+    settings.setValue(QString("Plugin/%1/triggerInterval").arg(this->getName()), t_settings.triggerInterval);
+}
+
+
+//*************************************************************************************************************
+
+QSharedPointer<IPlugin> LoadGenerator::clone() const
+{
+    QSharedPointer<LoadGenerator> pLoadGeneratorClone(new LoadGenerator());
+    return pLoadGeneratorClone;
+}
+
+
+//*************************************************************************************************************
+
+void LoadGenerator::init()
+{
+    m_pRTMSA_LoadGenerator = PluginOutputData<NewRealTimeMultiSampleArray>::create(this, "LoadGenerator", "Load Generator Output");
+    m_pRTMSA_LoadGenerator->data()->setName(this->getName());//Provide name to auto store widget settings
+    m_outputConnectors.append(m_pRTMSA_LoadGenerator);
+}
+
+
+//*************************************************************************************************************
+
+void LoadGenerator::unload()
+{
+
+}
+
+
+//*************************************************************************************************************
+
+bool LoadGenerator::start()
+{
+    //Check if the thread is already or still running. This can happen if the start button is pressed immediately after the stop button was pressed. In this case the stopping process is not finished yet but the start process is initiated.
+    if(this->isRunning())
+        QThread::wait();
+
+    m_qMutex.lock();
+    m_runSettings = m_settings;
+    m_timing.publishedBlocks = 0;
+    m_timing.lateBlocks = 0;
+    m_timing.achievedRate = 0.0;
+    m_bIsRunning = true;
+    m_qMutex.unlock();
+
+    setUpFiffInfo();
+    setUpGenerator();
+
+    m_pRTMSA_LoadGenerator->data()->initFromFiffInfo(m_pFiffInfo);
+    m_pRTMSA_LoadGenerator->data()->setMultiArraySize(1);
+    m_pRTMSA_LoadGenerator->data()->setVisibility(true);
+
+    QThread::start();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool LoadGenerator::stop()
+{
+    m_qMutex.lock();
+    m_bIsRunning = false;
+    m_qMutex.unlock();
+
+    //Clear all data in the buffer connected to displays and other plugins
+    m_pRTMSA_LoadGenerator->data()->clear();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+IPlugin::PluginType LoadGenerator::getType() const
+{
+    return _ISensor;
+}
+
+
+//*************************************************************************************************************
+
+QString LoadGenerator::getName() const
+{
+    return "Load Generator";
+}
+
+
+//*************************************************************************************************************
+
+QWidget* LoadGenerator::setupWidget()
+{
+    LoadGeneratorSetupWidget* widget = new LoadGeneratorSetupWidget(this);//widget is later distroyed by CentralWidget - so it has to be created everytime new
+    return widget;
+}
+
+
+//*************************************************************************************************************
+
+LoadGenerator::Settings LoadGenerator::settings() const
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_settings;
+}
+
+
+//*************************************************************************************************************
+
+void LoadGenerator::setSettings(const Settings& settings)
+{
+    QMutexLocker t_locker(&m_qMutex);
+
+    m_settings.numChannels = qBound(1, settings.numChannels, LOADGENERATOR_MAX_CHANNELS);
+    m_settings.samplingRate = qBound(1.0, settings.samplingRate, (double)LOADGENERATOR_MAX_SAMPLING_RATE);
+    m_settings.blockSize = qMax(1, settings.blockSize);
+    m_settings.frequency = qBound(0.0, settings.frequency, m_settings.samplingRate / 20.0);
+    m_settings.amplitude = settings.amplitude;
+    m_settings.noise = qMax(0.0, settings.noise);
+    m_settings.triggerInterval = qMax(0, settings.triggerInterval);
+}
+
+
+//*************************************************************************************************************
+
+LoadGenerator::Timing LoadGenerator::timing() const
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_timing;
+}
+
+
+//*************************************************************************************************************
+
+void LoadGenerator::run()
+{
+    const qint32 t_iRows = m_pFiffInfo->nchan;
+    const qint32 t_iBlockSize = m_runSettings.blockSize;
+    const double t_dBlockNs = 1.0e9 * t_iBlockSize / m_runSettings.samplingRate;
+
+    QElapsedTimer t_timer;
+    t_timer.start();
+
+    qint64 t_iBlock = 0;
+    qint64 t_iLateBlocks = 0;
+
+    while(true)
+    {
+        {
+            QMutexLocker t_locker(&m_qMutex);
+            if(!m_bIsRunning)
+                break;
+        }
+
+        MatrixPool::MatrixPtr t_pBlock = MatrixPool::global().acquire(t_iRows, t_iBlockSize);
+        generateBlock(*t_pBlock);
+
+        //A block is due when its last sample would have been acquired - the schedule never accumulates drift
+        qint64 t_iWaitNs = (qint64)((t_iBlock + 1) * t_dBlockNs) - t_timer.nsecsElapsed();
+        if(t_iWaitNs > 0)
+            usleep((unsigned long)(t_iWaitNs / 1000));
+        else
+            ++t_iLateBlocks;
+
+        m_pRTMSA_LoadGenerator->data()->setValue(t_pBlock, FiffRtBufferInfo((fiff_int_t)t_iBlock, FiffRtBufferInfo::currentTime()));
+
+        ++t_iBlock;
+
+        QMutexLocker t_locker(&m_qMutex);
+        m_timing.publishedBlocks = t_iBlock;
+        m_timing.lateBlocks = t_iLateBlocks;
+        m_timing.achievedRate = (double)(t_iBlock * t_iBlockSize) * 1.0e9 / (double)qMax((qint64)1, t_timer.nsecsElapsed());
+    }
+}
+
+
+//*************************************************************************************************************
+
+void LoadGenerator::setUpFiffInfo()
+{
+    const bool t_bStim = m_runSettings.triggerInterval > 0;
+
+    m_pFiffInfo = FiffInfo::SPtr(new FiffInfo());
+
+    //
+    //Set number of channels, sampling frequency and high/-lowpass
+    //
+    m_pFiffInfo->nchan = m_runSettings.numChannels + (t_bStim ? 1 : 0);
+    m_pFiffInfo->sfreq = m_runSettings.samplingRate;
+    m_pFiffInfo->highpass = 0.0f;
+    m_pFiffInfo->lowpass = m_runSettings.samplingRate / 2;
+
+    m_pFiffInfo->meas_date[0] = (fiff_int_t)QDateTime::currentDateTime().toTime_t();
+    m_pFiffInfo->meas_date[1] = 0;
+
+    //
+    //Set up the channel info
+    //
+    QStringList QSLChNames;
+
+    for(qint32 i = 0; i < m_pFiffInfo->nchan; ++i)
+    {
+        FiffChInfo fChInfo;
+        fChInfo.scanno = i + 1;
+        fChInfo.logno = i + 1;
+        fChInfo.range = 1.0f;
+        fChInfo.cal = 1.0f;
+        fChInfo.unit_mul = 0;
+
+        if(i < m_runSettings.numChannels) {
+            fChInfo.ch_name = QString("EEG %1").arg(i + 1, 4, 10, QChar('0'));
+            fChInfo.kind = FIFFV_EEG_CH;
+            fChInfo.coil_type = FIFFV_COIL_EEG;
+            fChInfo.coord_frame = FIFFV_COORD_HEAD;
+            fChInfo.unit = FIFF_UNIT_V;
+        } else {
+            fChInfo.ch_name = QString("STI 014");
+            fChInfo.kind = FIFFV_STIM_CH;
+            fChInfo.coil_type = FIFFV_COIL_NONE;
+            fChInfo.unit = FIFF_UNIT_NONE;
+        }
+
+        QSLChNames << fChInfo.ch_name;
+        m_pFiffInfo->chs.append(fChInfo);
+    }
+
+    //Set channel names in fiff_info_base
+    m_pFiffInfo->ch_names = QSLChNames;
+
+    //
+    //Set head projection
+    //
+    m_pFiffInfo->dev_head_t.from = FIFFV_COORD_DEVICE;
+    m_pFiffInfo->dev_head_t.to = FIFFV_COORD_HEAD;
+    m_pFiffInfo->ctf_head_t.from = FIFFV_COORD_DEVICE;
+    m_pFiffInfo->ctf_head_t.to = FIFFV_COORD_HEAD;
+}
+
+
+//*************************************************************************************************************
+
+void LoadGenerator::setUpGenerator()
+{
+    const qint32 t_iNumChannels = m_runSettings.numChannels;
+
+    //Channel c oscillates at (1 + c % 10) times the base frequency with a channel dependent phase
+    m_arrCos.resize(t_iNumChannels);
+    m_arrSin.resize(t_iNumChannels);
+    m_arrRotCos.resize(t_iNumChannels);
+    m_arrRotSin.resize(t_iNumChannels);
+    m_arrTmp.resize(t_iNumChannels);
+
+    for(qint32 c = 0; c < t_iNumChannels; ++c) {
+        double t_dPhase = 2.0 * M_PI * c / t_iNumChannels;
+        double t_dIncrement = 2.0 * M_PI * m_runSettings.frequency * (1 + c % 10) / m_runSettings.samplingRate;
+
+        m_arrCos[c] = cos(t_dPhase);
+        m_arrSin[c] = sin(t_dPhase);
+        m_arrRotCos[c] = cos(t_dIncrement);
+        m_arrRotSin[c] = sin(t_dIncrement);
+    }
+
+    //Gaussian noise table - segments of it are added to the samples
+    std::mt19937 t_generator(4711);
+    std::normal_distribution<double> t_distribution(0.0, m_runSettings.noise > 0.0 ? m_runSettings.noise : 1.0);
+
+    m_vecNoiseTable.resize(LOADGENERATOR_NOISE_TABLE_SIZE + t_iNumChannels);
+    for(qint32 i = 0; i < m_vecNoiseTable.size(); ++i)
+        m_vecNoiseTable[i] = m_runSettings.noise > 0.0 ? t_distribution(t_generator) : 0.0;
+
+    m_uiNoiseState = 1;
+    m_iSampleCount = 0;
+
+    m_iStimChannel = m_runSettings.triggerInterval > 0 ? t_iNumChannels : -1;
+    m_iTriggerSamples = (qint64)(m_runSettings.triggerInterval * m_runSettings.samplingRate / 1000.0);
+    m_iPulseSamples = qMax((qint64)1, (qint64)(0.005 * m_runSettings.samplingRate));
+}
+
+
+//*************************************************************************************************************
+
+void LoadGenerator::generateBlock(MatrixXd& matBlock)
+{
+    const qint32 t_iNumChannels = m_runSettings.numChannels;
+
+    for(qint32 j = 0; j < matBlock.cols(); ++j) {
+        //Pick a pseudo random segment of the noise table
+        m_uiNoiseState = m_uiNoiseState * 1664525u + 1013904223u;
+        qint32 t_iOffset = (qint32)((m_uiNoiseState >> 8) & (LOADGENERATOR_NOISE_TABLE_SIZE - 1));
+
+        matBlock.col(j).head(t_iNumChannels) = (m_runSettings.amplitude * m_arrSin).matrix() + m_vecNoiseTable.segment(t_iOffset, t_iNumChannels);
+
+        //Advance the oscillators by one sample
+        m_arrTmp = m_arrCos * m_arrRotCos - m_arrSin * m_arrRotSin;
+        m_arrSin = m_arrSin * m_arrRotCos + m_arrCos * m_arrRotSin;
+        m_arrCos.swap(m_arrTmp);
+
+        if(m_iStimChannel >= 0)
+            matBlock(m_iStimChannel, j) = (m_iTriggerSamples > 0 && m_iSampleCount % m_iTriggerSamples < m_iPulseSamples) ? 1.0 : 0.0;
+
+        ++m_iSampleCount;
+    }
+
+    //Keep the oscillators on the unit circle
+    m_arrTmp = (m_arrCos.square() + m_arrSin.square()).sqrt().inverse();
+    m_arrCos *= m_arrTmp;
+    m_arrSin *= m_arrTmp;
+}
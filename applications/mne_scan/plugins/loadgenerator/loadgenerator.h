@@ -0,0 +1,243 @@
+//=============================================================================================================
+/**
+* @file     loadgenerator.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the declaration of the LoadGenerator class.
+*
+*/
+
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "loadgenerator_global.h"
+
+#include <scShared/Interfaces/ISensor.h>
+#include <scMeas/newrealtimemultisamplearray.h>
+
+#include <fiff/fiff_info.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtWidgets>
+#include <QtCore/QtPlugin>
+#include <QMutex>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define LOADGENERATOR_NOISE_TABLE_SIZE     65536   /**< Number of precomputed gaussian noise values, a power of two. */
+#define LOADGENERATOR_MAX_CHANNELS         4096    /**< Maximal number of generated EEG channels. */
+#define LOADGENERATOR_MAX_SAMPLING_RATE    20000   /**< Maximal sampling rate in Hz. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE LoadGeneratorPlugin
+//=============================================================================================================
+
+namespace LoadGeneratorPlugin
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace SCSHAREDLIB;
+
+
+//=============================================================================================================
+/**
+* Synthetic sensor for benchmarking. Generates a configurable number of EEG channels at a configurable sampling
+* rate, each carrying a sinusoid plus gaussian noise, and optionally trigger pulses on a stim channel. The blocks
+* are published at the exact nominal rate: block k is due k * blockSize / samplingRate seconds after the start,
+* independent of how long earlier blocks took, and blocks which are late are published immediately and counted.
+*
+* The sinusoids are advanced by a per channel rotation and the noise is read from a precomputed table, so the
+* generator itself stays cheap even at 1000+ channels and 20 kHz.
+*
+* @brief The LoadGenerator class provides a synthetic high-rate data source.
+*/
+class LOADGENERATORSHARED_EXPORT LoadGenerator : public ISensor
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID "scsharedlib/1.0" FILE "loadgenerator.json") //New Qt5 Plugin system replaces Q_EXPORT_PLUGIN2 macro
+    // Use the Q_INTERFACES() macro to tell Qt's meta-object system about the interfaces
+    Q_INTERFACES(SCSHAREDLIB::ISensor)
+
+public:
+    //=========================================================================================================
+    /**
+    * Parameters of the generated signal.
+    */
+    struct Settings {
+        qint32  numChannels;        /**< Number of EEG channels. */
+        double  samplingRate;       /**< Sampling rate in Hz. */
+        qint32  blockSize;          /**< Samples per published block. */
+        double  frequency;          /**< Frequency of the sinusoid of the first channel in Hz, channel c uses (1 + c % 10) times this frequency. */
+        double  amplitude;          /**< Amplitude of the sinusoids in V. */
+        double  noise;              /**< Standard deviation of the noise in V. */
+        qint32  triggerInterval;    /**< Interval between trigger pulses in ms, 0 for no stim channel. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Timing of the running generator.
+    */
+    struct Timing {
+        qint64  publishedBlocks;    /**< Blocks published since start. */
+        qint64  lateBlocks;         /**< Blocks which were published after their due time. */
+        double  achievedRate;       /**< Published samples per second since start. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs a LoadGenerator.
+    */
+    LoadGenerator();
+
+    //=========================================================================================================
+    /**
+    * Destroys the LoadGenerator.
+    */
+    virtual ~LoadGenerator();
+
+    //=========================================================================================================
+    /**
+    * ISensor functions
+    */
+    virtual QSharedPointer<IPlugin> clone() const;
+    virtual void init();
+    virtual void unload();
+    virtual bool start();
+    virtual bool stop();
+    virtual IPlugin::PluginType getType() const;
+    virtual QString getName() const;
+    virtual QWidget* setupWidget();
+
+    //=========================================================================================================
+    /**
+    * Returns the settings which are used by the next start.
+    *
+    * @return the settings.
+    */
+    Settings settings() const;
+
+    //=========================================================================================================
+    /**
+    * Sets the settings which are used by the next start. Values are clamped to the supported ranges.
+    *
+    * @param[in] settings   The settings.
+    */
+    void setSettings(const Settings& settings);
+
+    //=========================================================================================================
+    /**
+    * Returns the timing of the running generator.
+    *
+    * @return the timing.
+    */
+    Timing timing() const;
+
+protected:
+    //=========================================================================================================
+    /**
+    * ISensor function - the generator loop.
+    */
+    virtual void run();
+
+private:
+    //=========================================================================================================
+    /**
+    * Creates the fiff info of the generated channels.
+    */
+    void setUpFiffInfo();
+
+    //=========================================================================================================
+    /**
+    * Prepares the oscillators and the noise table.
+    */
+    void setUpGenerator();
+
+    //=========================================================================================================
+    /**
+    * Generates the next block.
+    *
+    * @param[out] matBlock  The block to fill, sized channels x block size.
+    */
+    void generateBlock(Eigen::MatrixXd& matBlock);
+
+    PluginOutputData<SCMEASLIB::NewRealTimeMultiSampleArray>::SPtr m_pRTMSA_LoadGenerator;    /**< The generated data.*/
+
+    FIFFLIB::FiffInfo::SPtr     m_pFiffInfo;            /**< Fiff info of the generated channels.*/
+
+    mutable QMutex              m_qMutex;               /**< Guards the settings, the timing and the running flag.*/
+    bool                        m_bIsRunning;           /**< Whether the generator thread is running.*/
+    Settings                    m_settings;             /**< Settings of the next start.*/
+    Settings                    m_runSettings;          /**< Settings of the running generator. Generator thread only.*/
+    Timing                      m_timing;               /**< Timing of the running generator.*/
+
+    Eigen::ArrayXd              m_arrCos;               /**< Cosine state of the channel oscillators.*/
+    Eigen::ArrayXd              m_arrSin;               /**< Sine state of the channel oscillators.*/
+    Eigen::ArrayXd              m_arrRotCos;            /**< Cosine of the per sample phase increment of each channel.*/
+    Eigen::ArrayXd              m_arrRotSin;            /**< Sine of the per sample phase increment of each channel.*/
+    Eigen::ArrayXd              m_arrTmp;               /**< Scratch array for advancing the oscillators.*/
+    Eigen::VectorXd             m_vecNoiseTable;        /**< Precomputed gaussian noise, extended by the number of channels so segments never wrap.*/
+    quint32                     m_uiNoiseState;         /**< State of the generator which picks the noise table offsets.*/
+    qint64                      m_iSampleCount;         /**< Generated samples since start.*/
+    qint64                      m_iTriggerSamples;      /**< Samples between trigger pulses, 0 if disabled.*/
+    qint64                      m_iPulseSamples;        /**< Length of a trigger pulse in samples.*/
+    qint32                      m_iStimChannel;         /**< Row of the stim channel, -1 if disabled.*/
+};
+
+} // NAMESPACE
+
+#endif // LOADGENERATOR_H
@@ -80,6 +80,7 @@ MNE::MNE()
 //, m_sAtlasDir("D:/SoersStation/Dokumente/Karriere/TU Ilmenau/Promotion/Projekte/2016_LNT/Messdaten/subjects/lorenz/label")
 //, m_sSurfaceDir("D:/SoersStation/Dokumente/Karriere/TU Ilmenau/Promotion/Projekte/2016_LNT/Messdaten/subjects/lorenz/surf")
 , m_iNumAverages(1)
+, m_bNoiseCovPending(false)
 , m_iDownSample(4)
 {
 
@@ -121,6 +122,10 @@ void MNE::init()
     connect(m_pRTMSAInput.data(), &PluginInputConnector::notify, this, &MNE::updateRTMSA, Qt::DirectConnection);
     m_inputConnectors.append(m_pRTMSAInput);
 
+    //Larger blocks make the inverse multiplication cheaper per sample at the cost of latency - off by default
+    QSettings settings;
+    m_pRTMSAInput->setBlockSize(settings.value(QString("Plugin/%1/inputBlockSize").arg(this->getName()), 0).toInt());
+
     m_pRTEInput = PluginInputData<RealTimeEvoked>::create(this, "MNE RTE In", "MNE real-time evoked input data");
     connect(m_pRTEInput.data(), &PluginInputConnector::notify, this, &MNE::updateRTE, Qt::DirectConnection);
     m_inputConnectors.append(m_pRTEInput);
@@ -301,15 +306,25 @@ bool MNE::start()
 
 bool MNE::stop()
 {
+    m_qMutex.lock();
     m_bIsRunning = false;
+    m_qWaitCondition.wakeAll();
+    m_qMutex.unlock();
 
-    if(m_pRtInvOp->isRunning())
+    if(m_pRtInvOp && m_pRtInvOp->isRunning())
         m_pRtInvOp->stop();
 
+    //A restart creates a new estimator - covariances must not go to the stopped one
+    m_qMutex.lock();
+    m_pRtInvOp.clear();
+    m_qMutex.unlock();
+
     if(m_bProcessData) // Only clear if buffers have been initialised
     {
+        QMutexLocker locker(&m_qMutex);
         m_qVecFiffEvoked.clear();
-        m_qVecFiffCov.clear();
+        m_qQueueRawBlocks.clear();
+        m_bNoiseCovPending = false;
     }
 
     m_qListCovChNames.clear();
@@ -362,9 +377,10 @@ void MNE::updateRTMSA(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
     QSharedPointer<NewRealTimeMultiSampleArray> pRTMSA = pMeasurement.dynamicCast<NewRealTimeMultiSampleArray>();
 
     if(pRTMSA && m_bReceiveData) {
-        //Check if buffer initialized
-        if(!m_pMatrixDataBuffer)
-            m_pMatrixDataBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, pRTMSA->getNumChannels(), pRTMSA->getMultiSampleArray()[0].cols()));
+        //Shared blocks of the measurement - they are only read here
+        QList<NewRealTimeMultiSampleArray::ConstMatrixPtr> t_qListBlocks = pRTMSA->getMultiSampleBlocks();
+        if(t_qListBlocks.isEmpty())
+            return;
 
         //Fiff Information of the evoked
         if(!m_pFiffInfoInput) {
@@ -375,12 +391,21 @@ void MNE::updateRTMSA(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
 
         if(m_bProcessData)
         {
-            for(qint32 i = 0; i < pRTMSA->getMultiSampleArray().size(); ++i)
-            {
-                MatrixXd t_mat = pRTMSA->getMultiSampleArray()[i];
+            QMutexLocker locker(&m_qMutex);
 
-                m_pMatrixDataBuffer->push(&t_mat);
+            //Nothing to estimate before the first inverse operator is available
+            if(!m_pMinimumNorm)
+                return;
+
+            for(qint32 i = 0; i < t_qListBlocks.size(); ++i)
+            {
+                //The processing thread lags behind -> drop the oldest block instead of blocking the producer
+                if(m_qQueueRawBlocks.size() >= MNE_MAX_RAW_BLOCKS)
+                    m_qQueueRawBlocks.dequeue();
+                m_qQueueRawBlocks.enqueue(t_qListBlocks[i]);
             }
+
+            m_qWaitCondition.wakeOne();
         }
     }
 }
@@ -401,9 +426,19 @@ void MNE::updateRTC(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
 
         if(m_bProcessData)
         {
-            m_qMutex.lock();
-            m_qVecFiffCov.push_back(pRTC->getValue()->pick_channels(m_qListPickChannels));
-            m_qMutex.unlock();
+            FiffCov t_noiseCov = pRTC->getValue()->pick_channels(m_qListPickChannels);
+
+            //Only the latest covariance matters - RtInvOp supersedes the one it has not processed yet
+            QMutexLocker locker(&m_qMutex);
+            if(m_pRtInvOp)
+            {
+                m_pRtInvOp->appendNoiseCov(t_noiseCov);
+            }
+            else
+            {
+                m_noiseCov = t_noiseCov;
+                m_bNoiseCovPending = true;
+            }
         }
     }
 }
@@ -423,8 +458,11 @@ void MNE::updateRTE(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
         if(!m_pFiffInfoInput)
             m_pFiffInfoInput = QSharedPointer<FiffInfo>(new FiffInfo(pRTE->getValue()->info));
 
-        if(m_bProcessData)
+        if(m_bProcessData && m_pMinimumNorm)
+        {
             m_qVecFiffEvoked.push_back(pRTE->getValue()->pick_channels(m_qListPickChannels));
+            m_qWaitCondition.wakeOne();
+        }
     }
 }
 
@@ -433,21 +471,22 @@ void MNE::updateRTE(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
 
 void MNE::updateInvOp(MNEInverseOperator::SPtr p_pInvOp)
 {
-    m_pInvOp = p_pInvOp;
-
     double snr = 3.0;
     double lambda2 = 1.0 / pow(snr, 2); //ToDO estimate lambda using covariance
 
     QString method("dSPM"); //"MNE" | "dSPM" | "sLORETA"
 
-    m_qMutex.lock();
-
-    m_pMinimumNorm = MinimumNorm::SPtr(new MinimumNorm(*m_pInvOp.data(), lambda2, method));
+    MinimumNorm::SPtr t_pMinimumNorm(new MinimumNorm(*p_pInvOp.data(), lambda2, method));
 
     //
     //   Set up the inverse according to the parameters
     //
-    m_pMinimumNorm->doInverseSetup(m_iNumAverages,false);
+    t_pMinimumNorm->doInverseSetup(m_iNumAverages,false);
+
+    //The processing thread keeps its own reference to the previous estimator until its current block is done
+    m_qMutex.lock();
+    m_pInvOp = p_pInvOp;
+    m_pMinimumNorm = t_pMinimumNorm;
     m_qMutex.unlock();
 }
 
@@ -472,6 +511,8 @@ void MNE::run()
             QMutexLocker locker(&m_qMutex);
             if(m_pFiffInfo)
                 break;
+            if(!m_bIsRunning)
+                return;
         }
         calcFiffInfo();
         msleep(10);// Wait for fiff Info
@@ -483,6 +524,7 @@ void MNE::run()
     //
     // Init Real-Time inverse estimator
     //
+    m_qMutex.lock();
     m_pRtInvOp = RtInvOp::SPtr(new RtInvOp(m_pFiffInfo, m_pClusteredFwd));
     connect(m_pRtInvOp.data(), &RtInvOp::invOperatorCalculated, this, &MNE::updateInvOp);
     m_pMinimumNorm.reset();
@@ -492,6 +534,13 @@ void MNE::run()
     //
     m_pRtInvOp->start();
 
+    if(m_bNoiseCovPending)
+    {
+        m_pRtInvOp->appendNoiseCov(m_noiseCov);
+        m_bNoiseCovPending = false;
+    }
+    m_qMutex.unlock();
+
     //
     // start processing data
     //
@@ -526,81 +575,67 @@ void MNE::run()
 //    // TEMP INV LOADING END
 //    //
 
-    while(m_bIsRunning)
+    while(true)
     {
+        //
+        // Sleep until raw data or an evoked response arrives - covariances are handed to RtInvOp directly
+        //
         m_qMutex.lock();
-        qint32 t_covSize = m_qVecFiffCov.size();
-        m_qMutex.unlock();
-        if(t_covSize > 0)
+        while(m_bIsRunning && m_qQueueRawBlocks.isEmpty() && m_qVecFiffEvoked.isEmpty())
+            m_qWaitCondition.wait(&m_qMutex);
+
+        if(!m_bIsRunning)
         {
-            m_qMutex.lock();
-            m_pRtInvOp->appendNoiseCov(m_qVecFiffCov[0]);
-            m_qVecFiffCov.pop_front();
             m_qMutex.unlock();
+            break;
         }
 
-        m_qMutex.lock();
-        qint32 t_evokedSize = m_qVecFiffEvoked.size();
+        NewRealTimeMultiSampleArray::ConstMatrixPtr t_pRawSegment;
+        FiffEvoked t_fiffEvoked;
+        if(!m_qQueueRawBlocks.isEmpty())
+        {
+            t_pRawSegment = m_qQueueRawBlocks.dequeue();
+        }
+        else
+        {
+            t_fiffEvoked = m_qVecFiffEvoked[0];
+            m_qVecFiffEvoked.pop_front();
+        }
+
+        MinimumNorm::SPtr t_pMinimumNorm = m_pMinimumNorm;
+        MNEInverseOperator::SPtr t_pInvOp = m_pInvOp;
         m_qMutex.unlock();
 
-        if(m_pMatrixDataBuffer)
-        {
-            //qDebug()<<"MNE::run - Processing RTMSA data";
-            if(m_pMinimumNorm && ((skip_count % m_iDownSample) == 0))
-            {
-                MatrixXd rawSegment = m_pMatrixDataBuffer->pop();
+        bool t_bProcess = t_pMinimumNorm && ((skip_count % m_iDownSample) == 0);
+        ++skip_count;
 
-                float tmin = 1 / m_pFiffInfo->sfreq;
-                float tstep = 1 / m_pFiffInfo->sfreq;
+        if(!t_bProcess)
+            continue;
 
-                m_qMutex.lock();
+        if(t_pRawSegment)
+        {
+            //qDebug()<<"MNE::run - Processing RTMSA data";
+            SCSHAREDLIB::PluginStatistics::BlockTimer t_blockTimer(statistics());
 
-                //TODO: Add picking here. See evoked part as input.
-                MNESourceEstimate sourceEstimate = m_pMinimumNorm->calculateInverse(rawSegment, tmin, tstep);
+            float tmin = 1 / m_pFiffInfo->sfreq;
+            float tstep = 1 / m_pFiffInfo->sfreq;
 
-                m_qMutex.unlock();
+            //TODO: Add picking here. See evoked part as input.
+            MNESourceEstimate sourceEstimate = t_pMinimumNorm->calculateInverse(*t_pRawSegment, tmin, tstep);
 
-                m_pRTSEOutput->data()->setValue(sourceEstimate);
-            }
-            else
-            {
-                m_qMutex.lock();
-                m_qVecFiffEvoked.pop_front();
-                m_qMutex.unlock();
-            }
-            ++skip_count;
+            m_pRTSEOutput->data()->setValue(sourceEstimate);
         }
-
-        if(t_evokedSize > 0)
+        else
         {
             //qDebug()<<"MNE::run - Processing RTE data";
-            if(m_pMinimumNorm && ((skip_count % m_iDownSample) == 0))
-            {
-                m_qMutex.lock();
-                FiffEvoked t_fiffEvoked = m_qVecFiffEvoked[0];
-                m_qVecFiffEvoked.pop_front();
-                m_qMutex.unlock();
+            float tmin = ((float)t_fiffEvoked.first) / t_fiffEvoked.info.sfreq;
+            float tstep = 1/t_fiffEvoked.info.sfreq;
 
-                float tmin = ((float)t_fiffEvoked.first) / t_fiffEvoked.info.sfreq;
-                float tstep = 1/t_fiffEvoked.info.sfreq;
+            t_fiffEvoked = t_fiffEvoked.pick_channels(t_pInvOp->noise_cov->names);
 
-                m_qMutex.lock();
+            MNESourceEstimate sourceEstimate = t_pMinimumNorm->calculateInverse(t_fiffEvoked.data, tmin, tstep);
 
-                t_fiffEvoked = t_fiffEvoked.pick_channels(m_pInvOp->noise_cov->names);
-
-                MNESourceEstimate sourceEstimate = m_pMinimumNorm->calculateInverse(t_fiffEvoked.data, tmin, tstep);
-
-                m_qMutex.unlock();
-
-                m_pRTSEOutput->data()->setValue(sourceEstimate);
-            }
-            else
-            {
-                m_qMutex.lock();
-                m_qVecFiffEvoked.pop_front();
-                m_qMutex.unlock();
-            }
-            ++skip_count;
+            m_pRTSEOutput->data()->setValue(sourceEstimate);
         }
     }
 }
@@ -45,7 +45,6 @@
 #include "mne_global.h"
 #include <scShared/Interfaces/IAlgorithm.h>
 
-#include <generics/circularmatrixbuffer.h>
 
 #include <fs/annotationset.h>
 #include <fs/surfaceset.h>
@@ -69,6 +68,16 @@
 
 #include <QtWidgets>
 #include <QFile>
+#include <QQueue>
+#include <QWaitCondition>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define MNE_MAX_RAW_BLOCKS      64      /**< Maximal number of raw blocks waiting for the inverse before the oldest is dropped. */
 
 
 //*************************************************************************************************************
@@ -214,14 +223,16 @@ private:
 
     PluginOutputData<RealTimeSourceEstimate>::SPtr          m_pRTSEOutput;          /**< The RealTimeSourceEstimate output.*/
 
-    CircularMatrixBuffer<double>::SPtr                      m_pMatrixDataBuffer;    /**< Holds incoming RealTimeMultiSampleArray data.*/
+    QQueue<NewRealTimeMultiSampleArray::ConstMatrixPtr>     m_qQueueRawBlocks;      /**< Holds incoming RealTimeMultiSampleArray blocks.*/
 
     QMutex m_qMutex;
+    QWaitCondition m_qWaitCondition;    /**< Wakes the processing thread when new data arrives or when stopping. */
 
     QVector<FiffEvoked> m_qVecFiffEvoked;
     qint32 m_iNumAverages;
 
-    QVector<FiffCov>        m_qVecFiffCov;
+    FiffCov m_noiseCov;                 /**< Latest covariance which arrived before the inverse estimator was started. */
+    bool m_bNoiseCovPending;            /**< If m_noiseCov still has to be handed to the inverse estimator. */
 
     bool m_bIsRunning;      /**< If source lab is running */
     bool m_bReceiveData;    /**< If thread is ready to receive data */
@@ -357,6 +357,10 @@ bool Neuromag::stop()
 
         m_pRawMatrixBuffer_In->clear();
 
+        m_qMutexBufferInfo.lock();
+        m_qQueueBufferInfo.clear();
+        m_qMutexBufferInfo.unlock();
+
         m_pRTMSA_Neuromag->data()->clear();
     }
 
@@ -439,12 +443,17 @@ void Neuromag::run()
 {
 
     MatrixXf matValue;
+    FiffRtBufferInfo bufferInfo;
     while(m_bIsRunning)
     {
         //pop matrix
         matValue = m_pRawMatrixBuffer_In->pop();
 
+        m_qMutexBufferInfo.lock();
+        bufferInfo = m_qQueueBufferInfo.isEmpty() ? FiffRtBufferInfo() : m_qQueueBufferInfo.dequeue();
+        m_qMutexBufferInfo.unlock();
+
         //emit values
-        m_pRTMSA_Neuromag->data()->setValue(matValue.cast<double>());
+        m_pRTMSA_Neuromag->data()->setValue(matValue.cast<double>(), bufferInfo);
     }
 }
@@ -56,6 +56,7 @@
 //=============================================================================================================
 
 #include <fiff/fiff_info.h>
+#include <fiff/fiff_rt_buffer_info.h>
 
 
 //*************************************************************************************************************
@@ -74,6 +75,7 @@
 #include <QtWidgets>
 #include <QVector>
 #include <QTimer>
+#include <QQueue>
 
 
 //*************************************************************************************************************
@@ -249,6 +251,8 @@ private:
     QTimer m_cmdConnectionTimer;                            /**< Timer for convinient command client connection. When timer times out a connection is tried to be established. */
 
     QSharedPointer<RawMatrixBuffer> m_pRawMatrixBuffer_In;  /**< Holds incoming raw data. */
+    QQueue<FiffRtBufferInfo>        m_qQueueBufferInfo;     /**< Acquisition information of the incoming raw data, in the same order as m_pRawMatrixBuffer_In. */
+    QMutex                          m_qMutexBufferInfo;     /**< Guards the acquisition information queue. */
 
     bool                            m_bIsRunning;           /**< Whether FiffSimulator is running.*/
 
@@ -215,6 +215,11 @@ void NeuromagProducer::run()
                 to += t_matRawBuffer.cols();
                 from += t_matRawBuffer.cols();
 
+                //Info is enqueued first, it is available as soon as the buffer can be popped
+                m_pNeuromag->m_qMutexBufferInfo.lock();
+                m_pNeuromag->m_qQueueBufferInfo.enqueue(m_pRtDataClient->lastBufferInfo());
+                m_pNeuromag->m_qMutexBufferInfo.unlock();
+
                 m_pNeuromag->m_pRawMatrixBuffer_In->push(&t_matRawBuffer);
             }
             else if(FIFF_DATA_BUFFER == FIFF_BLOCK_END)
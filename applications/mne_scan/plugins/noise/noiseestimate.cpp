@@ -249,12 +249,17 @@ void NoiseEstimate::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
 
     if(pRTMSA)
     {
+        //Shared blocks of the measurement - they are only read here
+        QList<NewRealTimeMultiSampleArray::ConstMatrixPtr> t_qListBlocks = pRTMSA->getMultiSampleBlocks();
+        if(t_qListBlocks.isEmpty())
+            return;
+
         //Check if buffer initialized
 
         m_qMutex.lock();
         if(!m_pBuffer)
         {
-            m_pBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(8, pRTMSA->getNumChannels(), pRTMSA->getMultiSampleArray()[0].cols()));
+            m_pBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(8, pRTMSA->getNumChannels(), t_qListBlocks[0]->cols()));
         }
 
         //Fiff information
@@ -267,13 +272,8 @@ void NoiseEstimate::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
 
         if(m_bProcessData)
         {
-            MatrixXd t_mat;
-
-            for(qint32 i = 0; i < pRTMSA->getMultiArraySize(); ++i)
-            {
-                t_mat = pRTMSA->getMultiSampleArray()[i];
-                m_pBuffer->push(&t_mat);
-            }
+            for(qint32 i = 0; i < t_qListBlocks.size(); ++i)
+                m_pBuffer->push(t_qListBlocks[i].data());
         }
     }
 }
@@ -282,11 +282,9 @@ void NoiseEstimate::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
 
 void NoiseEstimate::appendNoiseSpectrum(MatrixXd t_send)
 { 
-    qDebug()<<"Spectrum"<<t_send(0,1)<<t_send(0,2)<<t_send(0,3);
     m_qMutex.lock();
     m_qVecSpecData.push_back(t_send);
     m_qMutex.unlock();
-    qDebug()<<"---------------------------------appendNoiseSpectrum--------------------------------";
 }
 
 
@@ -324,6 +322,9 @@ void NoiseEstimate::run()
     m_pRtNoise = RtNoise::SPtr(new RtNoise(m_iFFTlength, m_pFiffInfo, segments));
     connect(m_pRtNoise.data(), &RtNoise::SpecCalculated, this, &NoiseEstimate::appendNoiseSpectrum);
 
+    //Emit a spectrum every 100 ms - the display refreshes at 10 Hz instead of once per half segment
+    m_pRtNoise->setRefreshInterval(100);
+
     // Start Spectrum estimation
 
     m_pRtNoise->start();
@@ -339,6 +340,7 @@ void NoiseEstimate::run()
         {
             /* Dispatch the inputs */
             MatrixXd t_mat = m_pBuffer->pop();
+            PluginStatistics::BlockTimer t_blockTimer(statistics());
 
             //ToDo: Implement your algorithm here
             m_pRtNoise->append(t_mat);
@@ -346,7 +348,6 @@ void NoiseEstimate::run()
            if(m_qVecSpecData.size() > 0)
            {
                m_qMutex.lock();
-               qDebug()<<"%%%%%%%%%%%%%%%% send spectrum for display %%%%%%%%%%%%%%%%%%%";
                 //send spectrum to the output data
                m_pFSOutput->data()->setValue(m_qVecSpecData[0]);
                m_qVecSpecData.pop_front();
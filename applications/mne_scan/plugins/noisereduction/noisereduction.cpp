@@ -49,6 +49,7 @@
 using namespace NoiseReductionPlugin;
 using namespace SCSHAREDLIB;
 using namespace SCMEASLIB;
+using namespace FIFFLIB;
 using namespace UTILSLIB;
 using namespace IOBuffer;
 using namespace Eigen;
@@ -210,6 +211,10 @@ bool NoiseReduction::stop()
 
     m_pNoiseReductionBuffer->clear();
 
+    m_qMutexBufferInfo.lock();
+    m_qQueueBufferInfo.clear();
+    m_qMutexBufferInfo.unlock();
+
     return true;
 }
 
@@ -248,9 +253,17 @@ void NoiseReduction::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
     m_pRTMSA = pMeasurement.dynamicCast<NewRealTimeMultiSampleArray>();
 
     if(m_pRTMSA) {
+        //Shared blocks of the measurement - they are only read here
+        QList<NewRealTimeMultiSampleArray::ConstMatrixPtr> t_qListBlocks = m_pRTMSA->getMultiSampleBlocks();
+        if(t_qListBlocks.isEmpty())
+            return;
+
+        //Acquisition information travels with the blocks to the output
+        QList<FiffRtBufferInfo> t_qListBufferInfo = m_pRTMSA->getBufferInfoList();
+
         //Check if buffer initialized
         if(!m_pNoiseReductionBuffer) {
-            m_pNoiseReductionBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, m_pRTMSA->getNumChannels(), m_pRTMSA->getMultiSampleArray()[0].cols()));
+            m_pNoiseReductionBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, m_pRTMSA->getNumChannels(), t_qListBlocks[0]->cols()));
         }
 
         //Fiff information
@@ -278,15 +291,17 @@ void NoiseReduction::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
             m_pNoiseReductionOutput->data()->setVisibility(true);            
 
             //Init the filter
-            m_iMaxFilterTapSize = m_pRTMSA->getMultiSampleArray().at(m_pRTMSA->getMultiSampleArray().size()-1).cols();
+            m_iMaxFilterTapSize = t_qListBlocks.last()->cols();
             initFilter();
         }
 
-        MatrixXd t_mat;
+        for(qint32 i = 0; i < t_qListBlocks.size(); ++i) {
+            //The info is queued first, so it is available as soon as the block can be popped
+            m_qMutexBufferInfo.lock();
+            m_qQueueBufferInfo.enqueue(t_qListBufferInfo.value(i));
+            m_qMutexBufferInfo.unlock();
 
-        for(unsigned char i = 0; i < m_pRTMSA->getMultiArraySize(); ++i) {
-            t_mat = m_pRTMSA->getMultiSampleArray()[i];
-            m_pNoiseReductionBuffer->push(&t_mat);
+            m_pNoiseReductionBuffer->push(t_qListBlocks[i].data());
         }
     }
 }
@@ -730,10 +745,17 @@ void NoiseReduction::run()
     initSphara();
     createSpharaOperator();
 
+    MatrixXd t_mat;
+
     while(m_bIsRunning)
     {
         //Dispatch the inputs
-        MatrixXd t_mat = m_pNoiseReductionBuffer->pop();
+        m_pNoiseReductionBuffer->pop(t_mat);
+        PluginStatistics::BlockTimer t_blockTimer(statistics());
+
+        m_qMutexBufferInfo.lock();
+        FiffRtBufferInfo t_bufferInfo = m_qQueueBufferInfo.isEmpty() ? FiffRtBufferInfo() : m_qQueueBufferInfo.dequeue();
+        m_qMutexBufferInfo.unlock();
 
         m_mutex.lock();
 
@@ -755,9 +777,13 @@ void NoiseReduction::run()
             }
         }
 
-        //Do temporal filtering here
+        //Take the output block from the pool and do temporal filtering directly into it
+        MatrixPool::MatrixPtr t_pBlock = MatrixPool::global().acquire(t_mat.rows(), t_mat.cols());
+
         if(m_bFilterActivated) {
-            t_mat = m_pRtFilter->filterChannelsConcurrently(t_mat, m_iMaxFilterLength, m_lFilterChannelList, m_filterData);
+            m_pRtFilter->filterChannelsConcurrently(t_mat, m_iMaxFilterLength, m_lFilterChannelList, m_filterData, *t_pBlock);
+        } else {
+            *t_pBlock = t_mat;
         }
 
 //        qDebug()<<"t_mat dim:"<<t_mat.rows()<<"x"<<t_mat.cols();
@@ -768,10 +794,12 @@ void NoiseReduction::run()
         if(m_bSpharaActive) {
             //Set bad channels to zero so they do not get smeared into
             for(int i = 0; i < m_pFiffInfo->bads.size(); ++i) {
-                t_mat.row(m_pFiffInfo->ch_names.indexOf(m_pFiffInfo->bads.at(i))).setZero();
+                t_pBlock->row(m_pFiffInfo->ch_names.indexOf(m_pFiffInfo->bads.at(i))).setZero();
             }
 
-            t_mat = m_matSparseSpharaMult * t_mat;
+            //t_mat has the same shape and is not needed anymore, use it as target and swap the storage back into the block
+            t_mat.noalias() = m_matSparseSpharaMult * (*t_pBlock);
+            t_pBlock->swap(t_mat);
         }
 
 //        //Common average
@@ -799,6 +827,6 @@ void NoiseReduction::run()
         m_mutex.unlock();
 
         //Send the data to the connected plugins and the online display
-        m_pNoiseReductionOutput->data()->setValue(t_mat);
+        m_pNoiseReductionOutput->data()->setValue(t_pBlock, t_bufferInfo);
     }
 }
@@ -54,6 +54,7 @@
 #include <rtProcessing/rtfilter.h>
 
 #include <generics/circularmatrixbuffer.h>
+#include <generics/matrixpool.h>
 
 #include <scMeas/newrealtimemultisamplearray.h>
 
@@ -71,6 +72,8 @@
 #include <QDebug>
 #include <QSettings>
 #include <QElapsedTimer>
+#include <QQueue>
+#include <QMutex>
 
 
 //*************************************************************************************************************
@@ -298,6 +301,8 @@ private:
     FIFFLIB::FiffInfo::SPtr                         m_pFiffInfo;                /**< Fiff measurement info.*/
 
     IOBuffer::CircularMatrixBuffer<double>::SPtr    m_pNoiseReductionBuffer;    /**< Holds incoming data.*/
+    QQueue<FIFFLIB::FiffRtBufferInfo>               m_qQueueBufferInfo;         /**< Acquisition information of the blocks in m_pNoiseReductionBuffer, in the same order.*/
+    QMutex                                          m_qMutexBufferInfo;         /**< Guards m_qQueueBufferInfo.*/
 
     NoiseReductionOptionsWidget::SPtr               m_pOptionsWidget;           /**< The noise reduction option widget object.*/
     QAction*                                        m_pActionShowOptionsWidget; /**< The noise reduction option widget action.*/
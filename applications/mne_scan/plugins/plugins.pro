@@ -55,6 +55,7 @@ contains(MNECPP_CONFIG, BuildBasicMNESCANVersion) {
         neuromag \
         babymeg \
         triggercontrol \
+        loadgenerator \
         #gusbamp \
         #eegosports
 
@@ -69,7 +70,9 @@ contains(MNECPP_CONFIG, BuildBasicMNESCANVersion) {
         # bci \
         rtsss \
         rthpi \
-        noisereduction
+        noisereduction \
+        fiffrecorder \
+        resampler
 
     win32 { #Only compile the TMSI plugin if a windows system is used - TMSi driver is not available for linux yet
         contains(QMAKE_HOST.arch, x86_64) { #Compiling MNE-X FOR a 64bit system
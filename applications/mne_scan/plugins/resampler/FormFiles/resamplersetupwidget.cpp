@@ -0,0 +1,117 @@
+//=============================================================================================================
+/**
+* @file     resamplersetupwidget.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the implementation of the ResamplerSetupWidget class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "resamplersetupwidget.h"
+
+#include "../resampler.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QGridLayout>
+#include <QLabel>
+#include <QSpinBox>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace ResamplerPlugin;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+ResamplerSetupWidget::ResamplerSetupWidget(Resampler* toolbox, QWidget *parent)
+: QWidget(parent)
+, m_pResampler(toolbox)
+{
+    this->setWindowTitle("Resampler Settings");
+
+    QGridLayout* t_pGridLayout = new QGridLayout;
+
+    t_pGridLayout->addWidget(new QLabel("Up factor (L)"), 0, 0, 1, 1);
+    m_pSpinBoxUpFactor = new QSpinBox;
+    m_pSpinBoxUpFactor->setRange(1, 1000);
+    m_pSpinBoxUpFactor->setValue(m_pResampler->upFactor());
+    t_pGridLayout->addWidget(m_pSpinBoxUpFactor, 0, 1, 1, 1);
+
+    t_pGridLayout->addWidget(new QLabel("Down factor (M)"), 1, 0, 1, 1);
+    m_pSpinBoxDownFactor = new QSpinBox;
+    m_pSpinBoxDownFactor->setRange(1, 1000);
+    m_pSpinBoxDownFactor->setValue(m_pResampler->downFactor());
+    t_pGridLayout->addWidget(m_pSpinBoxDownFactor, 1, 1, 1, 1);
+
+    t_pGridLayout->addWidget(new QLabel("Output rate"), 2, 0, 1, 1);
+    m_pLabelRate = new QLabel;
+    t_pGridLayout->addWidget(m_pLabelRate, 2, 1, 1, 1);
+
+    t_pGridLayout->addWidget(new QLabel("Changes take effect on the next start."), 3, 0, 1, 2);
+
+    t_pGridLayout->setRowStretch(4, 1);
+    this->setLayout(t_pGridLayout);
+
+    connect(m_pSpinBoxUpFactor, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &ResamplerSetupWidget::applySettings);
+    connect(m_pSpinBoxDownFactor, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &ResamplerSetupWidget::applySettings);
+
+    applySettings();
+}
+
+
+//*************************************************************************************************************
+
+void ResamplerSetupWidget::applySettings()
+{
+    m_pResampler->setFactors(m_pSpinBoxUpFactor->value(), m_pSpinBoxDownFactor->value());
+
+    double t_dRatio = (double)m_pSpinBoxUpFactor->value() / (double)m_pSpinBoxDownFactor->value();
+    double t_dInputRate = m_pResampler->inputSamplingRate();
+
+    if(t_dInputRate > 0.0)
+        m_pLabelRate->setText(QString("%1 Hz (input %2 Hz)").arg(t_dInputRate * t_dRatio).arg(t_dInputRate));
+    else
+        m_pLabelRate->setText(QString("%1 x input rate").arg(t_dRatio));
+}
@@ -0,0 +1,109 @@
+//=============================================================================================================
+/**
+* @file     resamplersetupwidget.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the declaration of the ResamplerSetupWidget class.
+*
+*/
+
+#ifndef RESAMPLERSETUPWIDGET_H
+#define RESAMPLERSETUPWIDGET_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QWidget>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class QLabel;
+class QSpinBox;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE ResamplerPlugin
+//=============================================================================================================
+
+namespace ResamplerPlugin
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class Resampler;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS ResamplerSetupWidget
+*
+* @brief The ResamplerSetupWidget class provides the Resampler configuration window.
+*/
+class ResamplerSetupWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    //=========================================================================================================
+    /**
+    * Constructs a ResamplerSetupWidget which is a child of parent.
+    *
+    * @param [in] toolbox   a pointer to the corresponding Resampler.
+    * @param [in] parent    pointer to parent widget; If parent is 0, the new ResamplerSetupWidget becomes a window.
+    */
+    ResamplerSetupWidget(Resampler* toolbox, QWidget *parent = 0);
+
+private slots:
+    //=========================================================================================================
+    /**
+    * Hands the edited factors to the resampler and refreshes the rate display.
+    */
+    void applySettings();
+
+private:
+    Resampler*      m_pResampler;               /**< Holds a pointer to corresponding Resampler.*/
+    QSpinBox*       m_pSpinBoxUpFactor;         /**< The up factor L.*/
+    QSpinBox*       m_pSpinBoxDownFactor;       /**< The down factor M.*/
+    QLabel*         m_pLabelRate;               /**< Shows the resulting sampling rate.*/
+};
+
+} // NAMESPACE
+
+#endif // RESAMPLERSETUPWIDGET_H
@@ -0,0 +1,383 @@
+//=============================================================================================================
+/**
+* @file     resampler.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the implementation of the Resampler class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "resampler.h"
+#include "FormFiles/resamplersetupwidget.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+#include <QSettings>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace ResamplerPlugin;
+using namespace SCSHAREDLIB;
+using namespace SCMEASLIB;
+using namespace FIFFLIB;
+using namespace IOBuffer;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+Resampler::Resampler()
+: m_bIsRunning(false)
+, m_iDroppedBlocks(0)
+, m_iOutputFill(0)
+, m_iOutputBlockSize(0)
+, m_pResamplerInput(NULL)
+, m_pResamplerOutput(NULL)
+{
+    QSettings settings;
+    m_iUpFactor = qMax(1, settings.value(QString("Plugin/%1/upFactor").arg(this->getName()), 1).toInt());
+    m_iDownFactor = qMax(1, settings.value(QString("Plugin/%1/downFactor").arg(this->getName()), 4).toInt());
+}
+
+
+//*************************************************************************************************************
+
+Resampler::~Resampler()
+{
+    if(this->isRunning()) {
+        stop();
+        QThread::wait();
+    }
+
+    QSettings settings;
+    settings.setValue(QString("Plugin/%1/upFactor").arg(this->getName()), m_iUpFactor);
+    settings.setValue(QString("Plugin/%1/downFactor").arg(this->getName()), m_iDownFactor);
+}
+
+
+//*************************************************************************************************************
+
+QSharedPointer<IPlugin> Resampler::clone() const
+{
+    QSharedPointer<Resampler> pResamplerClone(new Resampler);
+    return pResamplerClone;
+}
+
+
+//*************************************************************************************************************
+
+void Resampler::init()
+{
+    // Input
+    m_pResamplerInput = PluginInputData<NewRealTimeMultiSampleArray>::create(this, "ResamplerIn", "Resampler input data");
+    connect(m_pResamplerInput.data(), &PluginInputConnector::notify, this, &Resampler::update, Qt::DirectConnection);
+    m_inputConnectors.append(m_pResamplerInput);
+
+    // Output
+    m_pResamplerOutput = PluginOutputData<NewRealTimeMultiSampleArray>::create(this, "ResamplerOut", "Resampler output data");
+    m_outputConnectors.append(m_pResamplerOutput);
+}
+
+
+//*************************************************************************************************************
+
+void Resampler::unload()
+{
+
+}
+
+
+//*************************************************************************************************************
+
+bool Resampler::start()
+{
+    //Check if the thread is already or still running. This can happen if the start button is pressed immediately after the stop button was pressed. In this case the stopping process is not finished yet but the start process is initiated.
+    if(this->isRunning())
+        QThread::wait();
+
+    m_qMutex.lock();
+    m_rtResampler.setFactors(m_iUpFactor, m_iDownFactor);
+
+    //The output is initialized with the resampled info when the first block arrives
+    m_pFiffInfo.clear();
+    m_qQueueBlocks.clear();
+    m_qQueueBufferInfo.clear();
+    m_iDroppedBlocks = 0;
+    m_pOutputBlock.clear();
+    m_iOutputFill = 0;
+    m_iOutputBlockSize = 0;
+    m_bIsRunning = true;
+    m_qMutex.unlock();
+
+    //The scheduler calls process() - no own thread needed
+    if(isScheduled())
+        return true;
+
+    //Start thread
+    QThread::start();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool Resampler::stop()
+{
+    m_qMutex.lock();
+    m_bIsRunning = false;
+    m_qQueueBlocks.clear();
+    m_qQueueBufferInfo.clear();
+    m_qWaitCondition.wakeAll();
+    m_qMutex.unlock();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+IPlugin::PluginType Resampler::getType() const
+{
+    return _IAlgorithm;
+}
+
+
+//*************************************************************************************************************
+
+QString Resampler::getName() const
+{
+    return "Resampler";
+}
+
+
+//*************************************************************************************************************
+
+QWidget* Resampler::setupWidget()
+{
+    ResamplerSetupWidget* setupWidget = new ResamplerSetupWidget(this);//widget is later distroyed by CentralWidget - so it has to be created everytime new
+    return setupWidget;
+}
+
+
+//*************************************************************************************************************
+
+bool Resampler::supportsScheduledProcessing() const
+{
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void Resampler::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
+{
+    QSharedPointer<NewRealTimeMultiSampleArray> pRTMSA = pMeasurement.dynamicCast<NewRealTimeMultiSampleArray>();
+
+    if(pRTMSA) {
+        //Shared blocks of the measurement - they are only read here
+        QList<NewRealTimeMultiSampleArray::ConstMatrixPtr> t_qListBlocks = pRTMSA->getMultiSampleBlocks();
+        if(t_qListBlocks.isEmpty())
+            return;
+
+        //Acquisition information travels with the blocks to the output
+        QList<FiffRtBufferInfo> t_qListBufferInfo = pRTMSA->getBufferInfoList();
+
+        QMutexLocker t_locker(&m_qMutex);
+
+        if(!m_bIsRunning)
+            return;
+
+        //Fiff information - no block was resampled yet, so the resampler can still be configured here
+        if(!m_pFiffInfo) {
+            m_pFiffInfo = pRTMSA->info();
+
+            QVector<int> t_vecStimChannels;
+            for(qint32 i = 0; i < m_pFiffInfo->chs.size(); ++i) {
+                if(m_pFiffInfo->chs[i].kind == FIFFV_STIM_CH)
+                    t_vecStimChannels.append(i);
+            }
+            m_rtResampler.setHoldChannels(t_vecStimChannels);
+
+            FiffInfo::SPtr t_pResampledInfo = m_rtResampler.resampledInfo(*m_pFiffInfo);
+            m_pResamplerOutput->data()->initFromFiffInfo(t_pResampledInfo);
+            m_pResamplerOutput->data()->setMultiArraySize(1);
+            m_pResamplerOutput->data()->setVisibility(true);
+        }
+
+        //Scheduled - hand the shared blocks to the task scheduler
+        if(isScheduled()) {
+            for(qint32 i = 0; i < t_qListBlocks.size(); ++i) {
+                postBlock(t_qListBlocks[i], t_qListBufferInfo.value(i));
+            }
+            return;
+        }
+
+        for(qint32 i = 0; i < t_qListBlocks.size(); ++i) {
+            if(m_qQueueBlocks.size() >= RESAMPLER_MAX_BACKLOG) {
+                if(m_iDroppedBlocks == 0)
+                    qWarning() << "Resampler::update - Resampler can not keep up, dropping blocks.";
+                ++m_iDroppedBlocks;
+                m_qQueueBlocks.dequeue();
+                m_qQueueBufferInfo.dequeue();
+            }
+
+            m_qQueueBlocks.enqueue(t_qListBlocks[i]);
+            m_qQueueBufferInfo.enqueue(t_qListBufferInfo.value(i));
+        }
+
+        m_qWaitCondition.wakeAll();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void Resampler::setFactors(qint32 iUp, qint32 iDown)
+{
+    QMutexLocker t_locker(&m_qMutex);
+    m_iUpFactor = qMax(1, iUp);
+    m_iDownFactor = qMax(1, iDown);
+}
+
+
+//*************************************************************************************************************
+
+qint32 Resampler::upFactor() const
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_iUpFactor;
+}
+
+
+//*************************************************************************************************************
+
+qint32 Resampler::downFactor() const
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_iDownFactor;
+}
+
+
+//*************************************************************************************************************
+
+double Resampler::inputSamplingRate() const
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_pFiffInfo ? m_pFiffInfo->sfreq : 0.0;
+}
+
+
+//*************************************************************************************************************
+
+void Resampler::process(const QSharedPointer<const Eigen::MatrixXd>& pBlock, const FiffRtBufferInfo& bufferInfo)
+{
+    m_qMutex.lock();
+    bool t_bIsRunning = m_bIsRunning;
+    m_qMutex.unlock();
+
+    if(t_bIsRunning)
+        resampleBlock(*pBlock, bufferInfo);
+}
+
+
+//*************************************************************************************************************
+
+void Resampler::run()
+{
+    while(true) {
+        NewRealTimeMultiSampleArray::ConstMatrixPtr t_pBlock;
+        FiffRtBufferInfo t_bufferInfo;
+
+        m_qMutex.lock();
+        while(m_bIsRunning && m_qQueueBlocks.isEmpty())
+            m_qWaitCondition.wait(&m_qMutex);
+
+        if(!m_bIsRunning) {
+            m_qMutex.unlock();
+            break;
+        }
+
+        t_pBlock = m_qQueueBlocks.dequeue();
+        t_bufferInfo = m_qQueueBufferInfo.dequeue();
+        m_qMutex.unlock();
+
+        //Measure the processing of the block for the plugin statistics
+        PluginStatistics::BlockTimer t_blockTimer(statistics());
+
+        resampleBlock(*t_pBlock, t_bufferInfo);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void Resampler::resampleBlock(const MatrixXd& matBlock, const FiffRtBufferInfo& bufferInfo)
+{
+    m_rtResampler.resample(matBlock, m_matResampled);
+
+    //Output blocks keep the duration of the input blocks
+    if(m_iOutputBlockSize == 0)
+        m_iOutputBlockSize = qMax(1, (int)((matBlock.cols() * m_rtResampler.upFactor() + m_rtResampler.downFactor() / 2) / m_rtResampler.downFactor()));
+
+    qint32 t_iDone = 0;
+    while(t_iDone < m_matResampled.cols()) {
+        if(!m_pOutputBlock) {
+            m_pOutputBlock = MatrixPool::global().acquire(m_matResampled.rows(), m_iOutputBlockSize);
+            m_iOutputFill = 0;
+            m_outputBufferInfo = bufferInfo;
+        }
+
+        qint32 t_iSamples = qMin(m_iOutputBlockSize - m_iOutputFill, (qint32)m_matResampled.cols() - t_iDone);
+        m_pOutputBlock->middleCols(m_iOutputFill, t_iSamples) = m_matResampled.middleCols(t_iDone, t_iSamples);
+        m_iOutputFill += t_iSamples;
+        t_iDone += t_iSamples;
+
+        if(m_iOutputFill == m_iOutputBlockSize) {
+            m_pResamplerOutput->data()->setValue(m_pOutputBlock, m_outputBufferInfo);
+            m_pOutputBlock.clear();
+        }
+    }
+}
@@ -0,0 +1,228 @@
+//=============================================================================================================
+/**
+* @file     resampler.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the declaration of the Resampler class.
+*
+*/
+
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "resampler_global.h"
+
+#include <scShared/Interfaces/IAlgorithm.h>
+#include <scMeas/newrealtimemultisamplearray.h>
+
+#include <generics/matrixpool.h>
+#include <rtProcessing/rtresampler.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtWidgets>
+#include <QtCore/QtPlugin>
+#include <QMutex>
+#include <QQueue>
+#include <QWaitCondition>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define RESAMPLER_MAX_BACKLOG       64      /**< Maximal number of blocks waiting for the resampler before the oldest is dropped. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE ResamplerPlugin
+//=============================================================================================================
+
+namespace ResamplerPlugin
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace SCSHAREDLIB;
+
+
+//=============================================================================================================
+/**
+* Changes the sampling rate of a NewRealTimeMultiSampleArray stream by a rational factor L/M, so that costly stages
+* behind it, e.g. source estimation, displays or BCI, run at a reduced rate without aliasing. The resampling is
+* done by RTPROCESSINGLIB::RtResampler; trigger channels are resampled without filtering. The resampled samples are
+* gathered into pooled blocks of a fixed size, which is the input block size scaled by L/M, and published with a
+* measurement info of the new sampling frequency. The factors take effect on the next start.
+*
+* @brief The Resampler class provides a real-time resampling stage.
+*/
+class RESAMPLERSHARED_EXPORT Resampler : public IAlgorithm
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID "scsharedlib/1.0" FILE "resampler.json") //NEw Qt5 Plugin system replaces Q_EXPORT_PLUGIN2 macro
+    // Use the Q_INTERFACES() macro to tell Qt's meta-object system about the interfaces
+    Q_INTERFACES(SCSHAREDLIB::IAlgorithm)
+
+public:
+    //=========================================================================================================
+    /**
+    * Constructs a Resampler.
+    */
+    Resampler();
+
+    //=========================================================================================================
+    /**
+    * Destroys the Resampler.
+    */
+    ~Resampler();
+
+    //=========================================================================================================
+    /**
+    * IAlgorithm functions
+    */
+    virtual QSharedPointer<IPlugin> clone() const;
+    virtual void init();
+    virtual void unload();
+    virtual bool start();
+    virtual bool stop();
+    virtual IPlugin::PluginType getType() const;
+    virtual QString getName() const;
+    virtual QWidget* setupWidget();
+    virtual bool supportsScheduledProcessing() const;
+
+    //=========================================================================================================
+    /**
+    * Processes one block on the task scheduler. Used instead of run() in the scheduled execution mode.
+    *
+    * @param[in] pBlock         The block to process.
+    * @param[in] bufferInfo     The acquisition information of the block.
+    */
+    virtual void process(const QSharedPointer<const Eigen::MatrixXd>& pBlock, const FIFFLIB::FiffRtBufferInfo& bufferInfo);
+
+    //=========================================================================================================
+    /**
+    * Udates the pugin with new (incoming) data.
+    *
+    * @param[in] pMeasurement    The incoming data in form of a generalized NewMeasurement.
+    */
+    void update(SCMEASLIB::NewMeasurement::SPtr pMeasurement);
+
+    //=========================================================================================================
+    /**
+    * Sets the resampling factors of the next start.
+    *
+    * @param[in] iUp        The up factor L.
+    * @param[in] iDown      The down factor M.
+    */
+    void setFactors(qint32 iUp, qint32 iDown);
+
+    //=========================================================================================================
+    /**
+    * Returns the up factor of the next start.
+    *
+    * @return the up factor L.
+    */
+    qint32 upFactor() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the down factor of the next start.
+    *
+    * @return the down factor M.
+    */
+    qint32 downFactor() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the sampling frequency of the input stream.
+    *
+    * @return the sampling frequency in Hz, or 0 if no data was received yet.
+    */
+    double inputSamplingRate() const;
+
+protected:
+    //=========================================================================================================
+    /**
+    * IAlgorithm function
+    */
+    virtual void run();
+
+private:
+    //=========================================================================================================
+    /**
+    * Resamples a block and publishes the output blocks which got full. An output block carries the acquisition
+    * information of the input block which contributed its first sample. Processing thread only.
+    *
+    * @param[in] matBlock       The input block.
+    * @param[in] bufferInfo     The acquisition information of the input block.
+    */
+    void resampleBlock(const Eigen::MatrixXd& matBlock, const FIFFLIB::FiffRtBufferInfo& bufferInfo);
+
+    bool                                    m_bIsRunning;           /**< Flag whether the resampler is running. Guarded by m_qMutex. */
+
+    FIFFLIB::FiffInfo::SPtr                 m_pFiffInfo;            /**< Fiff measurement info of the input. */
+
+    mutable QMutex                          m_qMutex;               /**< Guards the queue and the settings. */
+    QWaitCondition                          m_qWaitCondition;       /**< Wakes the thread when blocks are enqueued or the resampler stops. */
+    QQueue<SCMEASLIB::NewRealTimeMultiSampleArray::ConstMatrixPtr> m_qQueueBlocks;    /**< Blocks waiting for the resampler. */
+    QQueue<FIFFLIB::FiffRtBufferInfo>       m_qQueueBufferInfo;     /**< Acquisition information of the waiting blocks. */
+    qint64                                  m_iDroppedBlocks;       /**< Blocks dropped because the backlog was full. */
+
+    qint32                                  m_iUpFactor;            /**< Up factor of the next start. */
+    qint32                                  m_iDownFactor;          /**< Down factor of the next start. */
+
+    RTPROCESSINGLIB::RtResampler            m_rtResampler;          /**< The resampler. Processing thread only once started. */
+    Eigen::MatrixXd                         m_matResampled;         /**< Resampled samples of the current block. Processing thread only. */
+    IOBuffer::MatrixPool::MatrixPtr         m_pOutputBlock;         /**< The output block which is being gathered. Processing thread only. */
+    qint32                                  m_iOutputFill;          /**< Number of gathered samples in m_pOutputBlock. Processing thread only. */
+    FIFFLIB::FiffRtBufferInfo               m_outputBufferInfo;     /**< Acquisition information of m_pOutputBlock. Processing thread only. */
+    qint32                                  m_iOutputBlockSize;     /**< Number of samples of the output blocks. Processing thread only. */
+
+    PluginInputData<SCMEASLIB::NewRealTimeMultiSampleArray>::SPtr      m_pResamplerInput;      /**< The NewRealTimeMultiSampleArray input of the resampler.*/
+    PluginOutputData<SCMEASLIB::NewRealTimeMultiSampleArray>::SPtr     m_pResamplerOutput;     /**< The NewRealTimeMultiSampleArray output of the resampler.*/
+};
+
+} // NAMESPACE
+
+#endif // RESAMPLER_H
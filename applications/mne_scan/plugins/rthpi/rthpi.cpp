@@ -222,10 +222,15 @@ void RtHpi::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
 
     if(pRTMSA)
     {
+        //Shared blocks of the measurement - they are only read here
+        QList<NewRealTimeMultiSampleArray::ConstMatrixPtr> t_qListBlocks = pRTMSA->getMultiSampleBlocks();
+        if(t_qListBlocks.isEmpty())
+            return;
+
         m_qMutex.lock();
         //Check if buffer initialized
         if(!m_pRtHpiBuffer)
-            m_pRtHpiBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(8, pRTMSA->getNumChannels(), pRTMSA->getMultiSampleArray()[0].cols()));
+            m_pRtHpiBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(8, pRTMSA->getNumChannels(), t_qListBlocks[0]->cols()));
 
         //Fiff information
         if(!m_pFiffInfo)
@@ -237,13 +242,8 @@ void RtHpi::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
         m_qMutex.unlock();
         if(m_bProcessData)
         {
-            MatrixXd t_mat;
-
-            for(qint32 i = 0; i < pRTMSA->getMultiArraySize(); ++i)
-            {
-                t_mat = pRTMSA->getMultiSampleArray()[i];
-                m_pRtHpiBuffer->push(&t_mat);
-            }
+            for(qint32 i = 0; i < t_qListBlocks.size(); ++i)
+                m_pRtHpiBuffer->push(t_qListBlocks[i].data());
         }
     }
 }
@@ -283,6 +283,7 @@ void RtHpi::run()
     while (m_bIsRunning) {
         if(m_bProcessData) {
             MatrixXd t_mat = m_pRtHpiBuffer->pop();
+            PluginStatistics::BlockTimer t_blockTimer(statistics());
             m_pRtHPIS->append(t_mat);
         }
         //msleep(1);
@@ -180,6 +180,10 @@ bool RtSss::stop()
         m_pRtSssBuffer->clear();
     }
 
+    m_qMutexBufferInfo.lock();
+    m_qQueueBufferInfo.clear();
+    m_qMutexBufferInfo.unlock();
+
     m_bReceiveData = false;
 
     m_qMutex.unlock();
@@ -272,9 +276,14 @@ void RtSss::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
 
     if(pRTMSA && m_bReceiveData)
     {
+        //Shared blocks of the measurement - they are only read here
+        QList<NewRealTimeMultiSampleArray::ConstMatrixPtr> t_qListBlocks = pRTMSA->getMultiSampleBlocks();
+        if(t_qListBlocks.isEmpty())
+            return;
+
         //Check if buffer initialized
         if(!m_pRtSssBuffer)
-            m_pRtSssBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(32, pRTMSA->getNumChannels(), pRTMSA->getMultiSampleArray()[0].cols()));
+            m_pRtSssBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(32, pRTMSA->getNumChannels(), t_qListBlocks[0]->cols()));
 
         //Fiff information
         if(!m_pFiffInfo)
@@ -282,11 +291,17 @@ void RtSss::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
 
         if(m_bProcessData)
         {
-            MatrixXd in_mat;
-            for(unsigned char i = 0; i < pRTMSA->getMultiArraySize(); ++i)
+            //Acquisition information travels with the blocks to the output
+            QList<FiffRtBufferInfo> t_qListBufferInfo = pRTMSA->getBufferInfoList();
+
+            for(qint32 i = 0; i < t_qListBlocks.size(); ++i)
             {
-                in_mat = pRTMSA->getMultiSampleArray()[i];
-                m_pRtSssBuffer->push(&in_mat);
+                //The info is queued first, so it is available as soon as the block can be popped
+                m_qMutexBufferInfo.lock();
+                m_qQueueBufferInfo.enqueue(t_qListBufferInfo.value(i));
+                m_qMutexBufferInfo.unlock();
+
+                m_pRtSssBuffer->push(t_qListBlocks[i].data());
             }
         }
     }
@@ -430,6 +445,10 @@ void RtSss::run()
         {
             // * Dispatch the inputs * //
             MatrixXd in_mat = m_pRtSssBuffer->pop();
+
+            m_qMutexBufferInfo.lock();
+            FiffRtBufferInfo t_bufferInfo = m_qQueueBufferInfo.isEmpty() ? FiffRtBufferInfo() : m_qQueueBufferInfo.dequeue();
+            m_qMutexBufferInfo.unlock();
 //            qDebug() << "size of in_mat (run): " << in_mat.rows() << " x " << in_mat.cols();
 
             //Generate new matrix from picked channels
@@ -480,7 +499,7 @@ void RtSss::run()
             }
 
             // Output to display
-            m_pRTMSAOutput->data()->setValue(0.01* in_mat);
+            m_pRTMSAOutput->data()->setValue(0.01* in_mat, t_bufferInfo);
 
 //            cnt++;
 //            qDebug() << cnt << "   " ;
@@ -172,6 +172,8 @@ private:
     FiffInfo::SPtr              m_pFiffInfo;        /**< Fiff information. */
 
     CircularMatrixBuffer<double>::SPtr m_pRtSssBuffer;   /**< Holds incoming rt server data.*/
+    QQueue<FiffRtBufferInfo> m_qQueueBufferInfo;         /**< Acquisition information of the blocks in m_pRtSssBuffer, in the same order.*/
+    QMutex m_qMutexBufferInfo;                           /**< Guards m_qQueueBufferInfo.*/
 
     int LinRR, LoutRR, Lin, Lout;
 
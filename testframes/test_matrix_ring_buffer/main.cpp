@@ -0,0 +1,291 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Throughput benchmark of MatrixRingBuffer against CircularMatrixBuffer.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <generics/circularmatrixbuffer.h>
+#include <generics/matrixringbuffer.h>
+#include <generics/matrixringbufferadapter.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QThread>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <stdio.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace IOBuffer;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// PRODUCERS
+//=============================================================================================================
+
+/**
+* Pushes a number of blocks to a buffer with a push(const MatrixXd*) interface.
+*/
+template<class BufferType>
+class PushProducer : public QThread
+{
+public:
+    PushProducer(BufferType& p_buffer, const MatrixXd& p_matBlock, qint32 p_iNumBlocks)
+    : m_buffer(p_buffer)
+    , m_matBlock(p_matBlock)
+    , m_iNumBlocks(p_iNumBlocks)
+    {
+    }
+
+protected:
+    void run()
+    {
+        for(qint32 i = 0; i < m_iNumBlocks; ++i)
+        {
+            m_matBlock(0,0) = i;
+            m_buffer.push(&m_matBlock);
+        }
+    }
+
+private:
+    BufferType& m_buffer;
+    MatrixXd    m_matBlock;
+    qint32      m_iNumBlocks;
+};
+
+
+/**
+* Fills the slots of a MatrixRingBuffer in place.
+*/
+class RingProducer : public QThread
+{
+public:
+    RingProducer(MatrixRingBuffer<double>& p_ring, const MatrixXd& p_matBlock, qint32 p_iNumBlocks)
+    : m_ring(p_ring)
+    , m_matBlock(p_matBlock)
+    , m_iNumBlocks(p_iNumBlocks)
+    {
+    }
+
+protected:
+    void run()
+    {
+        for(qint32 i = 0; i < m_iNumBlocks; ++i)
+        {
+            MatrixXd* t_pSlot = m_ring.acquireWrite();
+            *t_pSlot = m_matBlock;
+            (*t_pSlot)(0,0) = i;
+            m_ring.commitWrite();
+        }
+    }
+
+private:
+    MatrixRingBuffer<double>&   m_ring;
+    MatrixXd                    m_matBlock;
+    qint32                      m_iNumBlocks;
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC FUNCTIONS
+//=============================================================================================================
+
+/**
+* Prints the result of one benchmark run.
+*
+* @param[in] p_sName        Name of the buffer.
+* @param[in] p_iNumBlocks   Number of transferred blocks.
+* @param[in] p_iBlockBytes  Size of one block in bytes.
+* @param[in] p_iMSecs       Elapsed time in milliseconds.
+* @param[in] p_iErrors      Number of blocks which arrived out of order.
+*/
+static void printResult(const char* p_sName, qint32 p_iNumBlocks, qint64 p_iBlockBytes, qint64 p_iMSecs, qint32 p_iErrors)
+{
+    double t_dSec = qMax(p_iMSecs, (qint64)1) / 1000.0;
+    printf("%-28s %10.0f blocks/s %10.1f MB/s   %lld ms   %d errors\n",
+           p_sName,
+           p_iNumBlocks / t_dSec,
+           p_iNumBlocks * p_iBlockBytes / t_dSec / (1024.0*1024.0),
+           p_iMSecs,
+           p_iErrors);
+}
+
+
+//*************************************************************************************************************
+
+/**
+* Transfers the blocks through a buffer with push/pop interface.
+*/
+template<class BufferType>
+static void benchmarkPushPop(const char* p_sName, qint32 p_iSlots, const MatrixXd& p_matBlock, qint32 p_iNumBlocks)
+{
+    BufferType t_buffer(p_iSlots, p_matBlock.rows(), p_matBlock.cols());
+    PushProducer<BufferType> t_producer(t_buffer, p_matBlock, p_iNumBlocks);
+
+    QElapsedTimer t_timer;
+    t_timer.start();
+    t_producer.start();
+
+    qint32 t_iErrors = 0;
+    double t_dSum = 0.0;
+    for(qint32 i = 0; i < p_iNumBlocks; ++i)
+    {
+        MatrixXd t_matBlock = t_buffer.pop();
+        if(t_matBlock(0,0) != i)
+            ++t_iErrors;
+        t_dSum += t_matBlock(t_matBlock.rows()-1, t_matBlock.cols()-1);
+    }
+
+    t_producer.wait();
+    printResult(p_sName, p_iNumBlocks, p_matBlock.size()*sizeof(double), t_timer.elapsed(), t_iErrors);
+
+    Q_UNUSED(t_dSum);
+}
+
+
+//*************************************************************************************************************
+
+/**
+* Transfers the blocks through the zero-copy interface of the ring.
+*/
+static void benchmarkRing(const char* p_sName, qint32 p_iSlots, const MatrixXd& p_matBlock, qint32 p_iNumBlocks)
+{
+    MatrixRingBuffer<double> t_ring(p_iSlots, p_matBlock.rows(), p_matBlock.cols());
+    RingProducer t_producer(t_ring, p_matBlock, p_iNumBlocks);
+
+    QElapsedTimer t_timer;
+    t_timer.start();
+    t_producer.start();
+
+    qint32 t_iErrors = 0;
+    double t_dSum = 0.0;
+    for(qint32 i = 0; i < p_iNumBlocks; ++i)
+    {
+        const MatrixXd* t_pBlock = t_ring.acquireRead();
+        if((*t_pBlock)(0,0) != i)
+            ++t_iErrors;
+        t_dSum += (*t_pBlock)(t_pBlock->rows()-1, t_pBlock->cols()-1);
+        t_ring.release();
+    }
+
+    t_producer.wait();
+    printResult(p_sName, p_iNumBlocks, p_matBlock.size()*sizeof(double), t_timer.elapsed(), t_iErrors);
+
+    Q_UNUSED(t_dSum);
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* The function main marks the entry point of the program.
+* By default, main has the storage class extern.
+*
+* @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+* @param [in] argv (argument vector) is an array of pointers to arrays of character strings that contain the arguments, one per string.
+* @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+*/
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Throughput benchmark: CircularMatrixBuffer vs. MatrixRingBuffer (single producer, single consumer).");
+    parser.addHelpOption();
+
+    QCommandLineOption blocksOption("n", "Number of transferred <blocks>.", "blocks", "20000");
+    QCommandLineOption rowsOption("r", "Number of <rows> (channels) per block.", "rows", "366");
+    QCommandLineOption colsOption("c", "Number of <cols> (samples) per block.", "cols", "100");
+    QCommandLineOption slotsOption("s", "Number of buffer <slots>.", "slots", "32");
+    parser.addOption(blocksOption);
+    parser.addOption(rowsOption);
+    parser.addOption(colsOption);
+    parser.addOption(slotsOption);
+    parser.process(app);
+
+    qint32 t_iNumBlocks = parser.value(blocksOption).toInt();
+    qint32 t_iRows = parser.value(rowsOption).toInt();
+    qint32 t_iCols = parser.value(colsOption).toInt();
+    qint32 t_iSlots = parser.value(slotsOption).toInt();
+
+    if(t_iNumBlocks <= 0 || t_iRows <= 0 || t_iCols <= 0 || t_iSlots <= 0)
+    {
+        printf("Error: blocks, rows, cols and slots have to be positive.\n");
+        return 1;
+    }
+
+    printf("%d blocks of %d x %d doubles, %d slots\n\n", t_iNumBlocks, t_iRows, t_iCols, t_iSlots);
+
+    MatrixXd t_matBlock = MatrixXd::Random(t_iRows, t_iCols);
+
+    benchmarkPushPop< CircularMatrixBuffer<double> >("CircularMatrixBuffer", t_iSlots, t_matBlock, t_iNumBlocks);
+    benchmarkPushPop< MatrixRingBufferAdapter<double> >("MatrixRingBufferAdapter", t_iSlots, t_matBlock, t_iNumBlocks);
+    benchmarkRing("MatrixRingBuffer (zero-copy)", t_iSlots, t_matBlock, t_iNumBlocks);
+
+    return 0;
+}
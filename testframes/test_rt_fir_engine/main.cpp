@@ -0,0 +1,252 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Benchmark of the batched RtFirEngine against the per-channel QtConcurrent filtering it replaces.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <rtProcessing/rtfirengine.h>
+#include <utils/filterTools/filterdata.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrent>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <stdio.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// LEGACY IMPLEMENTATION
+//=============================================================================================================
+
+/**
+* Per-channel filtering as done by RtFilter before the RtFirEngine was introduced. Kept as reference.
+*/
+void doFilterPerChannelLegacy(QPair<QList<FilterData>,QPair<int,RowVectorXd> > &channelDataTime)
+{
+    for(int i = 0; i < channelDataTime.first.size(); ++i) {
+        channelDataTime.second.second = channelDataTime.first.at(i).applyFFTFilter(channelDataTime.second.second, true, FilterData::ZeroPad);
+    }
+}
+
+
+/**
+* Overlap-add state of the legacy implementation.
+*/
+class LegacyFilter
+{
+public:
+    void filter(const MatrixXd& matDataIn, int iMaxFilterLength, const QVector<int>& lFilterChannelList, const QList<FilterData>& lFilterData, MatrixXd& matDataOut)
+    {
+        if(m_matOverlap.cols() != iMaxFilterLength || m_matOverlap.rows() < matDataIn.rows()) {
+            m_matOverlap.resize(matDataIn.rows(), iMaxFilterLength);
+            m_matOverlap.setZero();
+        }
+
+        matDataOut.resize(matDataIn.rows(), matDataIn.cols());
+
+        QList<QPair<QList<FilterData>,QPair<int,RowVectorXd> > > timeData;
+
+        for(qint32 i = 0; i < matDataIn.rows(); ++i) {
+            int pos = lFilterChannelList.indexOf(i);
+            if(pos != -1 && pos < matDataIn.rows())
+                timeData.append(QPair<QList<FilterData>,QPair<int,RowVectorXd> >(lFilterData,QPair<int,RowVectorXd>(pos,matDataIn.row(pos))));
+        }
+
+        QFuture<void> future = QtConcurrent::map(timeData, doFilterPerChannelLegacy);
+        future.waitForFinished();
+
+        int iFilteredNumberCols = timeData.at(0).second.second.cols();
+
+        for(int r = 0; r < timeData.size(); r++) {
+            RowVectorXd tempData = timeData.at(r).second.second;
+            tempData.head(iMaxFilterLength) += m_matOverlap.row(timeData.at(r).second.first);
+            matDataOut.row(timeData.at(r).second.first).segment(0,iFilteredNumberCols-iMaxFilterLength) = tempData.head(iFilteredNumberCols-iMaxFilterLength);
+            m_matOverlap.row(timeData.at(r).second.first) = timeData.at(r).second.second.tail(iMaxFilterLength);
+        }
+    }
+
+private:
+    MatrixXd m_matOverlap;
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC FUNCTIONS
+//=============================================================================================================
+
+/**
+* Filters a stream of blocks with both implementations and prints the time per block.
+*
+* @param[in] p_iChannels    Number of channels.
+* @param[in] p_iBlockSize   Number of samples per block.
+* @param[in] p_iOrder       Number of filter taps.
+* @param[in] p_iNumBlocks   Number of filtered blocks.
+*/
+static void benchmark(int p_iChannels, int p_iBlockSize, int p_iOrder, int p_iNumBlocks)
+{
+    //The legacy implementation needs the zero padded block and twice the filter length to fit into the filter's FFT
+    int t_iFFTLength = 2;
+    while(t_iFFTLength < p_iBlockSize + 2*p_iOrder)
+        t_iFFTLength *= 2;
+
+    QList<FilterData> t_lFilterData;
+    t_lFilterData << FilterData("BPF", FilterData::BPF, p_iOrder, 0.2, 0.2, 0.1, 1000.0, t_iFFTLength, FilterData::Cosine);
+
+    QVector<int> t_lChannels;
+    for(int i = 0; i < p_iChannels; ++i)
+        t_lChannels << i;
+
+    MatrixXd t_matStream = MatrixXd::Random(p_iChannels, p_iBlockSize * p_iNumBlocks);
+    MatrixXd t_matOutLegacy, t_matOutEngine;
+
+    LegacyFilter t_legacy;
+    RtFirEngine t_engine;
+    t_engine.setFilters(t_lFilterData, t_lChannels);
+    t_engine.prepare(p_iChannels, p_iBlockSize);
+
+    qint64 t_iNSecsLegacy = 0;
+    qint64 t_iNSecsEngine = 0;
+    double t_dMaxDiff = 0.0;
+
+    QElapsedTimer t_timer;
+    for(int b = 0; b < p_iNumBlocks; ++b)
+    {
+        MatrixXd t_matBlock = t_matStream.middleCols(b * p_iBlockSize, p_iBlockSize);
+
+        t_timer.start();
+        t_legacy.filter(t_matBlock, p_iOrder, t_lChannels, t_lFilterData, t_matOutLegacy);
+        t_iNSecsLegacy += t_timer.nsecsElapsed();
+
+        t_timer.start();
+        t_engine.filter(t_matBlock, t_matOutEngine);
+        t_iNSecsEngine += t_timer.nsecsElapsed();
+
+        t_dMaxDiff = qMax(t_dMaxDiff, (t_matOutLegacy - t_matOutEngine).cwiseAbs().maxCoeff());
+    }
+
+    double t_dLegacy = t_iNSecsLegacy / 1.0e6 / p_iNumBlocks;
+    double t_dEngine = t_iNSecsEngine / 1.0e6 / p_iNumBlocks;
+
+    printf("%5d x %d, %d taps:   legacy %8.3f ms/block   engine %8.3f ms/block   speedup %5.1fx   max deviation %g\n",
+           p_iChannels,
+           p_iBlockSize,
+           p_iOrder,
+           t_dLegacy,
+           t_dEngine,
+           t_dLegacy / qMax(t_dEngine, 1.0e-9),
+           t_dMaxDiff);
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* The function main marks the entry point of the program.
+* By default, main has the storage class extern.
+*
+* @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+* @param [in] argv (argument vector) is an array of pointers to arrays of character strings that contain the arguments, one per string.
+* @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+*/
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmark: per-channel QtConcurrent filtering vs. batched RtFirEngine for 64, 306 and 1000 channels.");
+    parser.addHelpOption();
+
+    QCommandLineOption blocksOption("n", "Number of filtered <blocks>.", "blocks", "200");
+    QCommandLineOption colsOption("c", "Number of <cols> (samples) per block.", "cols", "200");
+    QCommandLineOption orderOption("o", "Filter <order> (number of taps).", "order", "128");
+    parser.addOption(blocksOption);
+    parser.addOption(colsOption);
+    parser.addOption(orderOption);
+    parser.process(app);
+
+    int t_iNumBlocks = parser.value(blocksOption).toInt();
+    int t_iCols = parser.value(colsOption).toInt();
+    int t_iOrder = parser.value(orderOption).toInt();
+
+    if(t_iNumBlocks <= 0 || t_iCols <= 0 || t_iOrder <= 0)
+    {
+        printf("Error: blocks, cols and order have to be positive.\n");
+        return 1;
+    }
+
+    benchmark(64, t_iCols, t_iOrder, t_iNumBlocks);
+    benchmark(306, t_iCols, t_iOrder, t_iNumBlocks);
+    benchmark(1000, t_iCols, t_iOrder, t_iNumBlocks);
+
+    return 0;
+}
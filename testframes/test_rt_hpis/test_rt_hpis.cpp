@@ -0,0 +1,302 @@
+//=============================================================================================================
+/**
+* @file     test_rt_hpis.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Tests the HPI coil fit of RtHPIS on simulated coil signals.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <rtProcessing/rthpis.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Dense>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <math.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestRtHpis
+*
+* @brief The TestRtHpis class fits four simulated HPI coils with RtHPIS::fitCoil, without and with sensor noise
+*
+*/
+class TestRtHpis: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRtHpis();
+
+private slots:
+    void initTestCase();
+    void compareNoiseFreeFit();
+    void compareNoisyFit();
+    void cleanupTestCase();
+
+private:
+    //=========================================================================================================
+    /**
+    * Computes the field of a magnetic dipole along the sensor orientations, with the constant RtHPIS uses.
+    *
+    * @param[in] p_vecPos   Dipole position.
+    * @param[in] p_vecMom   Dipole moment.
+    *
+    * @return the field at each sensor.
+    */
+    VectorXd dipoleField(const Vector3d& p_vecPos, const Vector3d& p_vecMom) const;
+
+    //=========================================================================================================
+    /**
+    * Simulates one localization window of the coils, each driven by a sinusoid of its own frequency and phase,
+    * plus white sensor noise. The coil amplitudes are demodulated with the sin/cos reference model and the
+    * dominant phase as done by RtHPIS::run, and every coil is fitted from the origin.
+    *
+    * @param[in] p_dNoise       Standard deviation of the noise relative to the RMS of the coil signals.
+    * @param[out] p_vecPosError Position error of each coil in meters.
+    * @param[out] p_vecMomError Moment error of each coil relative to its moment.
+    * @param[out] p_vecFitError Remaining fit error of each coil.
+    */
+    void fitCoils(double p_dNoise, VectorXd& p_vecPosError, VectorXd& p_vecMomError, VectorXd& p_vecFitError);
+
+    double epsilon;
+
+    double m_dNoise;            /**< Standard deviation of the noise relative to the RMS of the coil signals. */
+
+    MatrixXd m_matSensorPos;    /**< Sensor positions of a helmet of radial magnetometers - one row per sensor. */
+    MatrixXd m_matSensorOri;    /**< Sensor orientations - one row per sensor. */
+    MatrixXd m_matCoilPos;      /**< Simulated coil positions - one row per coil. */
+    MatrixXd m_matCoilMom;      /**< Simulated coil moments - one row per coil. */
+};
+
+
+//*************************************************************************************************************
+
+TestRtHpis::TestRtHpis()
+: epsilon(1.0e-6)
+, m_dNoise(0.01)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestRtHpis::initTestCase()
+{
+    qDebug() << "Epsilon" << epsilon;
+
+    //Helmet of 248 radial magnetometers on a Fibonacci spiral over the upper hemisphere
+    const int t_iNumSensors = 248;
+    const double t_dRadius = 0.12;
+    const double t_dGoldenAngle = M_PI * (3.0 - sqrt(5.0));
+
+    m_matSensorPos.resize(t_iNumSensors, 3);
+    m_matSensorOri.resize(t_iNumSensors, 3);
+    for(int i = 0; i < t_iNumSensors; ++i) {
+        double z = 1.0 - (i + 0.5) / t_iNumSensors;
+        double r = sqrt(1.0 - z * z);
+        double phi = t_dGoldenAngle * i;
+
+        m_matSensorOri.row(i) << r * cos(phi), r * sin(phi), z;
+        m_matSensorPos.row(i) = t_dRadius * m_matSensorOri.row(i);
+    }
+
+    m_matCoilPos.resize(4, 3);
+    m_matCoilPos << 0.07, 0.02, 0.05,
+                    -0.06, 0.03, 0.05,
+                    0.01, 0.08, 0.04,
+                    0.00, -0.05, 0.07;
+
+    m_matCoilMom.resize(4, 3);
+    m_matCoilMom << 2.0e-8, 0.5e-8, 1.0e-8,
+                    -1.5e-8, 0.5e-8, 1.5e-8,
+                    0.2e-8, 2.0e-8, 1.0e-8,
+                    0.3e-8, -1.0e-8, 2.0e-8;
+}
+
+
+//*************************************************************************************************************
+
+void TestRtHpis::compareNoiseFreeFit()
+{
+    VectorXd t_vecPosError, t_vecMomError, t_vecFitError;
+    fitCoils(0.0, t_vecPosError, t_vecMomError, t_vecFitError);
+
+    for(int i = 0; i < m_matCoilPos.rows(); ++i) {
+        QVERIFY(t_vecPosError[i] < epsilon);
+        QVERIFY(t_vecMomError[i] < epsilon);
+        QVERIFY(t_vecFitError[i] < 1.0e-9);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestRtHpis::compareNoisyFit()
+{
+    VectorXd t_vecPosError, t_vecMomError, t_vecFitError;
+    fitCoils(m_dNoise, t_vecPosError, t_vecMomError, t_vecFitError);
+
+    for(int i = 0; i < m_matCoilPos.rows(); ++i) {
+        QVERIFY(t_vecPosError[i] < 1.0e-3);
+        QVERIFY(t_vecMomError[i] < 0.05);
+        QVERIFY(t_vecFitError[i] < 10.0 * m_dNoise * m_dNoise);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestRtHpis::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+VectorXd TestRtHpis::dipoleField(const Vector3d& p_vecPos, const Vector3d& p_vecMom) const
+{
+    const double K = 1e-7 / (4 * M_PI);
+
+    VectorXd t_vecField(m_matSensorPos.rows());
+    for(int i = 0; i < m_matSensorPos.rows(); ++i) {
+        Vector3d rel = m_matSensorPos.row(i).transpose() - p_vecPos;
+        Vector3d ori = m_matSensorOri.row(i).transpose();
+        double r2 = rel.squaredNorm();
+
+        t_vecField[i] = K * (3.0 * ori.dot(rel) * rel.dot(p_vecMom) - r2 * ori.dot(p_vecMom)) / (r2 * r2 * sqrt(r2));
+    }
+
+    return t_vecField;
+}
+
+
+//*************************************************************************************************************
+
+void TestRtHpis::fitCoils(double p_dNoise, VectorXd& p_vecPosError, VectorXd& p_vecMomError, VectorXd& p_vecFitError)
+{
+    const int t_iNumCoils = (int)m_matCoilPos.rows();
+    const int t_iSFreq = 1000;
+    const int t_iSamples = t_iSFreq / RTHPIS_LOCALIZATIONS_PER_SEC;
+    const double t_aFreq[4] = {155.0, 165.0, 190.0, 200.0};
+    const double t_aPhase[4] = {0.3, 1.7, 2.9, 4.4};
+
+    //Coil signals plus noise
+    MatrixXd t_matRef(t_iSamples, 2 * t_iNumCoils);
+    for(int t = 0; t < t_iSamples; ++t) {
+        for(int i = 0; i < t_iNumCoils; ++i) {
+            t_matRef(t, i) = sin(2.0 * M_PI * t_aFreq[i] * t / t_iSFreq);
+            t_matRef(t, i + t_iNumCoils) = cos(2.0 * M_PI * t_aFreq[i] * t / t_iSFreq);
+        }
+    }
+
+    MatrixXd t_matData = MatrixXd::Zero(m_matSensorPos.rows(), t_iSamples);
+    for(int i = 0; i < t_iNumCoils; ++i) {
+        VectorXd t_vecField = dipoleField(m_matCoilPos.row(i).transpose(), m_matCoilMom.row(i).transpose());
+        RowVectorXd t_vecSignal = cos(t_aPhase[i]) * t_matRef.col(i).transpose() + sin(t_aPhase[i]) * t_matRef.col(i + t_iNumCoils).transpose();
+        t_matData += t_vecField * t_vecSignal;
+    }
+
+    double t_dRms = sqrt(t_matData.squaredNorm() / t_matData.size());
+    t_matData += p_dNoise * t_dRms * MatrixXd::Random(t_matData.rows(), t_matData.cols()) * sqrt(3.0);
+
+    //Demodulation: least squares amplitudes of the sin/cos references, projected onto the dominant phase
+    MatrixXd t_matTopo = t_matRef.colPivHouseholderQr().solve(t_matData.transpose()).transpose();
+
+    p_vecPosError.resize(t_iNumCoils);
+    p_vecMomError.resize(t_iNumCoils);
+    p_vecFitError.resize(t_iNumCoils);
+
+    for(int i = 0; i < t_iNumCoils; ++i) {
+        Matrix2d t_matPhaseCov;
+        t_matPhaseCov(0,0) = t_matTopo.col(i).squaredNorm();
+        t_matPhaseCov(1,1) = t_matTopo.col(i + t_iNumCoils).squaredNorm();
+        t_matPhaseCov(0,1) = t_matPhaseCov(1,0) = t_matTopo.col(i).dot(t_matTopo.col(i + t_iNumCoils));
+
+        SelfAdjointEigenSolver<Matrix2d> t_eig(t_matPhaseCov);
+        Vector2d t_vecPhase = t_eig.eigenvectors().col(1);
+
+        RtHPIS::CoilFit t_fit;
+        t_fit.pSensorPos = &m_matSensorPos;
+        t_fit.pSensorOri = &m_matSensorOri;
+        t_fit.vecData = t_matTopo.col(i) * t_vecPhase(0) + t_matTopo.col(i + t_iNumCoils) * t_vecPhase(1);
+        t_fit.vecPos = Vector3d::Zero();
+        t_fit.vecMom = Vector3d::Zero();
+
+        RtHPIS::fitCoil(t_fit);
+
+        //The sign of the demodulated amplitude, and thus of the moment, is arbitrary
+        p_vecPosError[i] = (t_fit.vecPos - m_matCoilPos.row(i).transpose()).norm();
+        p_vecMomError[i] = qMin((t_fit.vecMom - m_matCoilMom.row(i).transpose()).norm(),
+                                (t_fit.vecMom + m_matCoilMom.row(i).transpose()).norm()) / m_matCoilMom.row(i).norm();
+        p_vecFitError[i] = t_fit.dError;
+    }
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestRtHpis)
+#include "test_rt_hpis.moc"
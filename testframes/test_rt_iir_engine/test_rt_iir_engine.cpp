@@ -0,0 +1,260 @@
+//=============================================================================================================
+/**
+* @file     test_rt_iir_engine.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+*
+* @brief    Tests of the IirFilter design and the streaming RtIirEngine.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <rtProcessing/rtiirengine.h>
+#include <utils/filterTools/filterdata.h>
+#include <utils/filterTools/iirfilter.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <cmath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestRtIirEngine
+*
+* @brief The TestRtIirEngine class tests the IIR filter design and the block-wise filtering of RtIirEngine
+*
+*/
+class TestRtIirEngine: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRtIirEngine();
+
+private slots:
+    void initTestCase();
+    void compareSosCoefficients();
+    void compareLowpassResponse();
+    void compareHighpassResponse();
+    void compareStepResponse();
+    void compareBlockContinuity();
+    void cleanupTestCase();
+
+private:
+    double epsilon;
+
+    int m_iChannels;
+    int m_iSamples;
+};
+
+
+//*************************************************************************************************************
+
+TestRtIirEngine::TestRtIirEngine()
+: epsilon(1.0e-9)
+, m_iChannels(64)
+, m_iSamples(5000)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestRtIirEngine::initTestCase()
+{
+    qDebug() << "Epsilon" << epsilon;
+}
+
+
+//*************************************************************************************************************
+
+void TestRtIirEngine::compareSosCoefficients()
+{
+    //Second order Butterworth lowpass at 0.2 of the Nyquist frequency, i.e. scipy.signal.butter(2, 0.2)
+    IirFilter t_filter(2, 0.2, 0.0, IirFilter::LPF, IirFilter::Butterworth);
+
+    RowVectorXd t_vecExpected(6);
+    t_vecExpected << 0.06745527, 0.13491055, 0.06745527, 1.0, -1.14298050, 0.41280160;
+
+    QCOMPARE((int)t_filter.m_matSos.rows(), 1);
+    QVERIFY((t_filter.m_matSos.row(0) - t_vecExpected).cwiseAbs().maxCoeff() < 1.0e-6);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtIirEngine::compareLowpassResponse()
+{
+    //Bin k of a 1000 point fft lies at k/500 of the Nyquist frequency
+    IirFilter t_lowpass(4, 0.2, 0.0, IirFilter::LPF, IirFilter::Butterworth);
+    RowVectorXcd t_vecResponse = IirFilter::sosResponse(t_lowpass.m_matSos, 1000);
+
+    QVERIFY(std::fabs(std::abs(t_vecResponse(0)) - 1.0) < epsilon);
+    QVERIFY(std::fabs(std::abs(t_vecResponse(100)) - std::sqrt(0.5)) < 1.0e-6);
+    QVERIFY(std::abs(t_vecResponse(400)) < 1.0e-3);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtIirEngine::compareHighpassResponse()
+{
+    IirFilter t_highpass(4, 0.2, 0.0, IirFilter::HPF, IirFilter::Butterworth);
+    RowVectorXcd t_vecResponse = IirFilter::sosResponse(t_highpass.m_matSos, 1000);
+
+    QVERIFY(std::abs(t_vecResponse(0)) < epsilon);
+    QVERIFY(std::fabs(std::abs(t_vecResponse(100)) - std::sqrt(0.5)) < 1.0e-6);
+    QVERIFY(std::fabs(std::abs(t_vecResponse(500)) - 1.0) < epsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtIirEngine::compareStepResponse()
+{
+    QList<FilterData> t_lLowpass, t_lHighpass;
+    t_lLowpass << FilterData("LPF", FilterData::LPF, 4, 0.2, 0.0, 0.0, 1000.0, 4096, FilterData::ButterworthIIR);
+    t_lHighpass << FilterData("HPF", FilterData::HPF, 4, 0.2, 0.0, 0.0, 1000.0, 4096, FilterData::ButterworthIIR);
+
+    QVector<int> t_lChannels;
+    t_lChannels << 0;
+
+    RtIirEngine t_lowpass, t_highpass;
+    t_lowpass.setFilters(t_lLowpass, t_lChannels);
+    t_highpass.setFilters(t_lHighpass, t_lChannels);
+
+    //A unit step block by block - the lowpass settles at 1, the highpass at 0
+    MatrixXd t_matLowpass, t_matHighpass;
+    for(int b = 0; b < 20; ++b) {
+        t_matLowpass = MatrixXd::Ones(1, 100);
+        t_matHighpass = MatrixXd::Ones(1, 100);
+        t_lowpass.filter(t_matLowpass);
+        t_highpass.filter(t_matHighpass);
+    }
+
+    QVERIFY(std::fabs(t_matLowpass(0, 99) - 1.0) < epsilon);
+    QVERIFY(std::fabs(t_matHighpass(0, 99)) < epsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtIirEngine::compareBlockContinuity()
+{
+    QList<FilterData> t_lFilterData;
+    t_lFilterData << FilterData("LPF", FilterData::LPF, 4, 0.4, 0.0, 0.0, 1000.0, 4096, FilterData::ButterworthIIR);
+    t_lFilterData << FilterData("HPF", FilterData::HPF, 2, 0.01, 0.0, 0.0, 1000.0, 4096, FilterData::ChebyshevIIR);
+
+    //Every second channel is filtered, the others have to stay untouched
+    QVector<int> t_lChannels;
+    for(int i = 0; i < m_iChannels; i += 2)
+        t_lChannels << i;
+
+    MatrixXd t_matStream = MatrixXd::Random(m_iChannels, m_iSamples);
+
+    //Reference: both filters over the whole stream, starting from zero state
+    MatrixXd t_matExpected = t_matStream;
+    for(int i = 0; i < t_lChannels.size(); ++i) {
+        RowVectorXd t_vecRow = t_matStream.row(t_lChannels.at(i));
+        for(int f = 0; f < t_lFilterData.size(); ++f)
+            t_vecRow = IirFilter::applySos(t_lFilterData.at(f).m_matSos, t_vecRow);
+        t_matExpected.row(t_lChannels.at(i)) = t_vecRow;
+    }
+
+    RtIirEngine t_engine;
+    t_engine.setFilters(t_lFilterData, t_lChannels);
+
+    QCOMPARE(t_engine.numSections(), 3);
+
+    //Blocks of changing size, the state has to carry over every block boundary
+    const int t_aBlockSizes[] = {100, 37, 1, 250, 64};
+    MatrixXd t_matFiltered(m_iChannels, m_iSamples);
+    MatrixXd t_matBlock;
+
+    int t_iStart = 0;
+    for(int b = 0; t_iStart < m_iSamples; ++b) {
+        int t_iCols = qMin(t_aBlockSizes[b % 5], m_iSamples - t_iStart);
+        t_engine.filter(t_matStream.middleCols(t_iStart, t_iCols), t_matBlock);
+        t_matFiltered.middleCols(t_iStart, t_iCols) = t_matBlock;
+        t_iStart += t_iCols;
+    }
+
+    QVERIFY((t_matFiltered - t_matExpected).cwiseAbs().maxCoeff() < 1.0e-10);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtIirEngine::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestRtIirEngine)
+#include "test_rt_iir_engine.moc"
@@ -0,0 +1,327 @@
+//=============================================================================================================
+/**
+* @file     test_rt_lcmv.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+*
+* @brief    Tests the Woodbury update, the whitener and the unit noise gain weights of RtLcmv.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <rtProcessing/rtlcmv.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Dense>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <math.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestRtLcmv
+*
+* @brief The TestRtLcmv class tests the Woodbury update, the whitener and the unit noise gain weights of RtLcmv
+*
+*/
+class TestRtLcmv: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRtLcmv();
+
+private slots:
+    void initTestCase();
+    void compareWoodbury();
+    void compareWhitener();
+    void compareFixedWeights();
+    void compareFreeWeights();
+    void cleanupTestCase();
+
+private:
+    //=========================================================================================================
+    /**
+    * Creates a random symmetric positive definite matrix.
+    *
+    * @param[in] p_iSize    Number of rows and columns.
+    *
+    * @return the matrix.
+    */
+    static MatrixXd randomCovariance(int p_iSize);
+
+    //=========================================================================================================
+    /**
+    * Computes the weights of random sources in the whitened space, split into two worker blocks, and applies
+    * them to a data block. Fixed orientation weights have to point along C^-1 * l, free orientation weights
+    * have to pass the three components of their source without crosstalk.
+    *
+    * @param[in] p_iOri         Number of components per source, 1 or 3.
+    * @param[out] p_dNormError  Largest deviation of a weight vector norm from 1.
+    * @param[out] p_dGainError  Largest deviation from C^-1 * l (fixed) or largest relative crosstalk (free).
+    * @param[out] p_dSolError   Largest deviation of the source estimate from the weights applied to the data.
+    */
+    static void computeWeights(int p_iOri, double& p_dNormError, double& p_dGainError, double& p_dSolError);
+
+    double epsilon;
+
+    int m_iChannels;    /**< Number of channels of the Woodbury test. */
+    int m_iBlocks;      /**< Number of blocks of the Woodbury test. */
+    int m_iBlockSize;   /**< Number of samples per block of the Woodbury test. */
+};
+
+
+//*************************************************************************************************************
+
+TestRtLcmv::TestRtLcmv()
+: epsilon(1.0e-12)
+, m_iChannels(60)
+, m_iBlocks(200)
+, m_iBlockSize(12)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestRtLcmv::initTestCase()
+{
+    qDebug() << "Epsilon" << epsilon;
+}
+
+
+//*************************************************************************************************************
+
+void TestRtLcmv::compareWoodbury()
+{
+    //Carry the inverse of an exponentially weighted covariance along and compare it to the covariance after every
+    //block. A time constant of ten times the channels keeps the covariance well conditioned, as a window of some
+    //seconds does.
+    const double t_dForget = 1.0 - 1.0 / (10 * m_iChannels);
+    const double t_dAlpha = pow(t_dForget, (double)m_iBlockSize);
+
+    MatrixXd t_matCov = randomCovariance(m_iChannels);
+    MatrixXd t_matInvCov = t_matCov.inverse();
+    MatrixXd t_matUpdate, t_matInvCovUpdate, t_matCapacitance;
+
+    for(int b = 0; b < m_iBlocks; ++b) {
+        t_matUpdate = sqrt(1.0 - t_dForget) * MatrixXd::Random(m_iChannels, m_iBlockSize);
+
+        t_matCov = t_dAlpha * t_matCov + t_matUpdate * t_matUpdate.transpose();
+        QVERIFY(RtLcmv::updateInverse(t_matInvCov, t_matUpdate, t_dAlpha, t_matInvCovUpdate, t_matCapacitance));
+
+        double t_dError = (t_matInvCov * t_matCov - MatrixXd::Identity(m_iChannels, m_iChannels)).cwiseAbs().maxCoeff();
+        QVERIFY(t_dError < 1.0e-9);
+    }
+
+    //A capacitance matrix which is not positive definite has to leave the inverse untouched
+    MatrixXd t_matBefore = t_matInvCov;
+    t_matUpdate = MatrixXd::Zero(m_iChannels, m_iBlockSize);
+    QVERIFY(!RtLcmv::updateInverse(t_matInvCov, t_matUpdate, -1.0, t_matInvCovUpdate, t_matCapacitance));
+    QVERIFY(t_matInvCov == t_matBefore);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtLcmv::compareWhitener()
+{
+    const int t_iNumChs = 30;
+
+    VectorXd t_vecStd(t_iNumChs);
+    for(int i = 0; i < t_iNumChs; ++i)
+        t_vecStd[i] = i < 10 ? RTLCMV_ADHOC_GRAD_STD : (i < 20 ? RTLCMV_ADHOC_MAG_STD : RTLCMV_ADHOC_EEG_STD);
+
+    //Noise covariance of gradiometers, magnetometers and EEG channels in physical units with one projected
+    //component - the whitener has to drop that component and turn the noise covariance into the identity
+    VectorXd t_vecProj = VectorXd::Random(t_iNumChs).normalized();
+    MatrixXd t_matProj = MatrixXd::Identity(t_iNumChs, t_iNumChs) - t_vecProj * t_vecProj.transpose();
+    MatrixXd t_matNoiseCov = t_vecStd.asDiagonal() * t_matProj * randomCovariance(t_iNumChs) * t_matProj * t_vecStd.asDiagonal();
+
+    MatrixXd t_matWhitener;
+    RtLcmv::computeWhitener(t_matNoiseCov, t_vecStd, t_matWhitener);
+
+    QCOMPARE((int)t_matWhitener.rows(), t_iNumChs - 1);
+    QCOMPARE((int)t_matWhitener.cols(), t_iNumChs);
+
+    double t_dError = (t_matWhitener * t_matNoiseCov * t_matWhitener.transpose() - MatrixXd::Identity(t_iNumChs - 1, t_iNumChs - 1)).cwiseAbs().maxCoeff();
+    QVERIFY(t_dError < 1.0e-8);
+
+    //Without noise covariance the channels are scaled by their ad-hoc noise level
+    RtLcmv::computeWhitener(MatrixXd(), t_vecStd, t_matWhitener);
+    MatrixXd t_matAdHoc = t_vecStd.cwiseInverse().asDiagonal();
+    double t_dAdHocError = (t_matWhitener - t_matAdHoc).cwiseAbs().maxCoeff() / t_matAdHoc.cwiseAbs().maxCoeff();
+    QVERIFY(t_dAdHocError < epsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtLcmv::compareFixedWeights()
+{
+    double t_dNormError, t_dGainError, t_dSolError;
+    computeWeights(1, t_dNormError, t_dGainError, t_dSolError);
+
+    QVERIFY(t_dNormError < epsilon);
+    QVERIFY(t_dGainError < 1.0e-10);
+    QVERIFY(t_dSolError < epsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtLcmv::compareFreeWeights()
+{
+    double t_dNormError, t_dGainError, t_dSolError;
+    computeWeights(3, t_dNormError, t_dGainError, t_dSolError);
+
+    QVERIFY(t_dNormError < epsilon);
+    QVERIFY(t_dGainError < 1.0e-10);
+    QVERIFY(t_dSolError < epsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtLcmv::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd TestRtLcmv::randomCovariance(int p_iSize)
+{
+    MatrixXd t_matFactor = MatrixXd::Random(p_iSize, 2 * p_iSize);
+    MatrixXd t_matCov = t_matFactor * t_matFactor.transpose() / (2 * p_iSize);
+    t_matCov.diagonal().array() += 0.1;
+
+    return t_matCov;
+}
+
+
+//*************************************************************************************************************
+
+void TestRtLcmv::computeWeights(int p_iOri, double& p_dNormError, double& p_dGainError, double& p_dSolError)
+{
+    const int t_iNumChs = 40;
+    const int t_iNumSources = 25;
+    const int t_iSamples = 16;
+    const int t_iCols = t_iNumSources * p_iOri;
+
+    MatrixXd t_matGain = MatrixXd::Random(t_iNumChs, t_iCols);
+    MatrixXd t_matInvCov = randomCovariance(t_iNumChs).inverse();
+    MatrixXd t_matData = MatrixXd::Random(t_iNumChs, t_iSamples);
+    MatrixXd t_matWeights(t_iNumChs, t_iCols);
+    MatrixXd t_matSol(t_iNumSources, t_iSamples);
+
+    RtLcmv::SourceBlock t_aBlocks[2];
+    for(int b = 0; b < 2; ++b) {
+        t_aBlocks[b].pGain = &t_matGain;
+        t_aBlocks[b].pInvCov = &t_matInvCov;
+        t_aBlocks[b].pData = &t_matData;
+        t_aBlocks[b].pWeights = &t_matWeights;
+        t_aBlocks[b].pSol = &t_matSol;
+        t_aBlocks[b].iFirst = b == 0 ? 0 : t_iNumSources / 2;
+        t_aBlocks[b].iSources = b == 0 ? t_iNumSources / 2 : t_iNumSources - t_iNumSources / 2;
+        t_aBlocks[b].iOri = p_iOri;
+    }
+
+    for(int b = 0; b < 2; ++b)
+        RtLcmv::computeWeightsBlock(t_aBlocks[b]);
+    for(int b = 0; b < 2; ++b)
+        RtLcmv::applyWeightsBlock(t_aBlocks[b]);
+
+    p_dNormError = (t_matWeights.colwise().norm().array() - 1.0).abs().maxCoeff();
+
+    //Fixed orientation: along C^-1 * l. Free orientation: W_s^T * L_s is diagonal.
+    p_dGainError = 0.0;
+    for(int s = 0; s < t_iNumSources; ++s) {
+        if(p_iOri == 1) {
+            VectorXd t_vecExpected = (t_matInvCov * t_matGain.col(s)).normalized();
+            p_dGainError = qMax(p_dGainError, (t_matWeights.col(s) - t_vecExpected).cwiseAbs().maxCoeff());
+        } else {
+            Matrix3d t_matPass = t_matWeights.middleCols(3*s, 3).transpose() * t_matGain.middleCols(3*s, 3);
+            Matrix3d t_matCrosstalk = t_matPass;
+            t_matCrosstalk.diagonal().setZero();
+            p_dGainError = qMax(p_dGainError, t_matCrosstalk.cwiseAbs().maxCoeff() / t_matPass.diagonal().cwiseAbs().minCoeff());
+        }
+    }
+
+    //Fixed orientation outputs the signed component, free orientation the norm of the three components
+    MatrixXd t_matComponents = t_matWeights.transpose() * t_matData;
+    MatrixXd t_matExpected = t_matComponents;
+    if(p_iOri == 3) {
+        t_matExpected.resize(t_iNumSources, t_iSamples);
+        for(int s = 0; s < t_iNumSources; ++s)
+            t_matExpected.row(s) = t_matComponents.middleRows(3*s, 3).colwise().norm();
+    }
+
+    p_dSolError = (t_matSol - t_matExpected).cwiseAbs().maxCoeff();
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestRtLcmv)
+#include "test_rt_lcmv.moc"
@@ -0,0 +1,337 @@
+//=============================================================================================================
+/**
+* @file     test_rt_resampler.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+*
+* @brief    Tests of the polyphase RtResampler.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <rtProcessing/rtresampler.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+#include <Eigen/LU>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <math.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestRtResampler
+*
+* @brief The TestRtResampler class resamples a sine and a hold channel from 1000 Hz to 1500 Hz with RtResampler
+*
+*/
+class TestRtResampler: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRtResampler();
+
+private slots:
+    void initTestCase();
+    void compareReducedFactors();
+    void compareBlockLengths();
+    void compareOutputLength();
+    void compareSineAmplitude();
+    void compareSinePhase();
+    void compareBlockContinuity();
+    void compareHoldChannel();
+    void cleanupTestCase();
+
+private:
+    //=========================================================================================================
+    /**
+    * Resamples a stream block by block.
+    *
+    * @param[in] p_resampler        The resampler, its state is carried over all blocks.
+    * @param[in] p_matStream        The input stream, rows are channels.
+    * @param[in] p_vecBlockSizes    Block sizes which are used in turn.
+    * @param[out] p_bLengthsOk      Whether every block had the length announced by numOutputSamples.
+    *
+    * @return the concatenated output blocks.
+    */
+    MatrixXd resampleStream(RtResampler& p_resampler, const MatrixXd& p_matStream, const QVector<int>& p_vecBlockSizes, bool& p_bLengthsOk);
+
+    //=========================================================================================================
+    /**
+    * Least squares fit of a*sin + b*cos of the delayed input time to the resampled sine after the filter has
+    * settled. For a matching amplitude and phase a is 1 and b is 0.
+    *
+    * @return the coefficients a and b, zero if the output is too short.
+    */
+    Vector2d fitDelayedSine() const;
+
+    double epsilon;
+
+    int m_iSamples;             /**< Number of input samples of the sine. */
+    double m_dFrequency;        /**< Frequency of the sine in Hz. */
+    double m_dSFreqIn;          /**< Input sampling frequency. */
+    double m_dSFreqOut;         /**< Output sampling frequency. */
+
+    RtResampler m_resampler;    /**< Resampler of the sine, set up with the unreduced factors 6/4. */
+    bool m_bLengthsOk;          /**< Whether every output block had the announced length. */
+    MatrixXd m_matOut;          /**< The sine and cosine resampled block by block. */
+    MatrixXd m_matReference;    /**< The sine and cosine resampled as one block. */
+};
+
+
+//*************************************************************************************************************
+
+TestRtResampler::TestRtResampler()
+: epsilon(1.0e-12)
+, m_iSamples(5001)
+, m_dFrequency(50.0)
+, m_dSFreqIn(1000.0)
+, m_dSFreqOut(1500.0)
+, m_bLengthsOk(false)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestRtResampler::initTestCase()
+{
+    qDebug() << "Epsilon" << epsilon;
+
+    MatrixXd t_matStream(2, m_iSamples);
+    for(int t = 0; t < m_iSamples; ++t) {
+        t_matStream(0, t) = sin(2.0 * M_PI * m_dFrequency * t / m_dSFreqIn);
+        t_matStream(1, t) = cos(2.0 * M_PI * m_dFrequency * t / m_dSFreqIn);
+    }
+
+    //Blocks of changing size
+    QVector<int> t_vecBlockSizes;
+    t_vecBlockSizes << 100 << 37 << 1 << 250 << 64;
+
+    m_resampler.setFactors(6, 4);
+    m_matOut = resampleStream(m_resampler, t_matStream, t_vecBlockSizes, m_bLengthsOk);
+
+    //Reference: the whole stream as one block
+    RtResampler t_reference;
+    t_reference.setFactors(3, 2);
+    t_reference.resample(t_matStream, m_matReference);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtResampler::compareReducedFactors()
+{
+    QCOMPARE(m_resampler.upFactor(), 3);
+    QCOMPARE(m_resampler.downFactor(), 2);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtResampler::compareBlockLengths()
+{
+    QVERIFY(m_bLengthsOk);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtResampler::compareOutputLength()
+{
+    QCOMPARE((int)m_matOut.cols(), (m_iSamples * 3 + 1) / 2);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtResampler::compareSineAmplitude()
+{
+    //The tolerance covers the passband ripple of the Kaiser window
+    QVERIFY(fabs(fitDelayedSine().norm() - 1.0) < 5.0e-3);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtResampler::compareSinePhase()
+{
+    //For a sine which is delayed by RtResampler::delay the cosine part vanishes
+    Vector2d t_vecFit = fitDelayedSine();
+    QVERIFY(fabs(atan2(t_vecFit[1], t_vecFit[0])) < 1.0e-6);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtResampler::compareBlockContinuity()
+{
+    QCOMPARE(m_matReference.cols(), m_matOut.cols());
+    QVERIFY((m_matOut - m_matReference).cwiseAbs().maxCoeff() < epsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtResampler::compareHoldChannel()
+{
+    const int t_iSamples = 300;
+    const int t_iStep = 100;
+
+    MatrixXd t_matStream = MatrixXd::Zero(1, t_iSamples);
+    t_matStream.rightCols(t_iSamples - t_iStep).setConstant(5.0);
+
+    QVector<int> t_vecHoldChannels;
+    t_vecHoldChannels << 0;
+
+    RtResampler t_resampler;
+    t_resampler.setFactors(3, 2);
+    t_resampler.setHoldChannels(t_vecHoldChannels);
+
+    QVector<int> t_vecBlockSizes;
+    t_vecBlockSizes << 33;
+
+    bool t_bLengthsOk;
+    MatrixXd t_matOut = resampleStream(t_resampler, t_matStream, t_vecBlockSizes, t_bLengthsOk);
+
+    //The hold channel keeps its exact values
+    int t_iFirst = -1;
+    for(int k = 0; k < t_matOut.cols(); ++k) {
+        QVERIFY(t_matOut(0, k) == 0.0 || t_matOut(0, k) == 5.0);
+        if(t_iFirst < 0 && t_matOut(0, k) == 5.0)
+            t_iFirst = k;
+    }
+
+    //The first output which takes the step is the first one whose delayed time lies at or after the input step
+    QCOMPARE(t_iFirst, (int)ceil(t_iStep * 1.5 + t_resampler.delay()));
+}
+
+
+//*************************************************************************************************************
+
+void TestRtResampler::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd TestRtResampler::resampleStream(RtResampler& p_resampler, const MatrixXd& p_matStream, const QVector<int>& p_vecBlockSizes, bool& p_bLengthsOk)
+{
+    QList<MatrixXd> t_lBlocks;
+    MatrixXd t_matBlock;
+    int t_iNumOut = 0;
+
+    p_bLengthsOk = true;
+
+    int t_iStart = 0;
+    for(int b = 0; t_iStart < p_matStream.cols(); ++b) {
+        int t_iCols = qMin(p_vecBlockSizes.at(b % p_vecBlockSizes.size()), (int)p_matStream.cols() - t_iStart);
+        int t_iExpected = p_resampler.numOutputSamples(t_iCols);
+
+        p_resampler.resample(p_matStream.middleCols(t_iStart, t_iCols), t_matBlock);
+
+        p_bLengthsOk &= (t_matBlock.cols() == t_iExpected);
+        t_lBlocks.append(t_matBlock);
+        t_iNumOut += t_matBlock.cols();
+        t_iStart += t_iCols;
+    }
+
+    MatrixXd t_matOut(p_matStream.rows(), t_iNumOut);
+    int t_iCol = 0;
+    for(int b = 0; b < t_lBlocks.size(); ++b) {
+        t_matOut.middleCols(t_iCol, t_lBlocks.at(b).cols()) = t_lBlocks.at(b);
+        t_iCol += t_lBlocks.at(b).cols();
+    }
+
+    return t_matOut;
+}
+
+
+//*************************************************************************************************************
+
+Vector2d TestRtResampler::fitDelayedSine() const
+{
+    const double t_dDelay = m_resampler.delay();
+    const int t_iFirst = 4 * (int)ceil(t_dDelay);
+    const int t_iCount = (int)m_matOut.cols() - t_iFirst;
+    if(t_iCount < 2)
+        return Vector2d::Zero();
+
+    MatrixXd t_matBasis(t_iCount, 2);
+    for(int k = 0; k < t_iCount; ++k) {
+        const double t_dPhase = 2.0 * M_PI * m_dFrequency * (t_iFirst + k - t_dDelay) / m_dSFreqOut;
+        t_matBasis(k, 0) = sin(t_dPhase);
+        t_matBasis(k, 1) = cos(t_dPhase);
+    }
+
+    return (t_matBasis.transpose() * t_matBasis).inverse() * (t_matBasis.transpose() * m_matOut.row(0).segment(t_iFirst, t_iCount).transpose());
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestRtResampler)
+#include "test_rt_resampler.moc"
@@ -0,0 +1,270 @@
+//=============================================================================================================
+/**
+* @file     loadtestclient.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the LoadTestClient Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "loadtestclient.h"
+
+#include <rtClient/rtcmdclient.h>
+#include <rtClient/rtdataclient.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <algorithm>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace TESTRTSERVERLOAD;
+using namespace RTCLIENTLIB;
+using namespace RTCOMMANDLIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+LoadTestClient::LoadTestClient(qint32 p_iIndex, const QString& p_sHost, qint32 p_iDelayMs, QObject* parent)
+: QThread(parent)
+, m_iIndex(p_iIndex)
+, m_sHost(p_sHost)
+, m_iDelayMs(p_iDelayMs)
+, m_bIsRunning(0)
+, m_bIsStreaming(0)
+{
+    m_result.clientId = -1;
+    m_result.nChannels = 0;
+    m_result.sfreq = 0.0;
+    m_result.buffers = 0;
+    m_result.samples = 0;
+    m_result.bytes = 0;
+    m_result.missedBuffers = 0;
+    m_result.timeouts = 0;
+    m_result.elapsed = 0.0;
+}
+
+
+//*************************************************************************************************************
+
+LoadTestClient::~LoadTestClient()
+{
+    stop();
+    wait();
+}
+
+
+//*************************************************************************************************************
+
+void LoadTestClient::stop()
+{
+    m_bIsRunning.store(0);
+}
+
+
+//*************************************************************************************************************
+
+qint64 LoadTestClient::latencyPercentile(double p_dPercentile) const
+{
+    if(m_result.latencies.isEmpty())
+        return -1;
+
+    QVector<qint64> t_vecSorted = m_result.latencies;
+    std::sort(t_vecSorted.begin(), t_vecSorted.end());
+
+    qint32 t_iIdx = (qint32)((p_dPercentile / 100.0) * (t_vecSorted.size() - 1) + 0.5);
+    t_iIdx = qBound(0, t_iIdx, t_vecSorted.size() - 1);
+
+    return t_vecSorted[t_iIdx];
+}
+
+
+//*************************************************************************************************************
+
+QJsonObject LoadTestClient::toJsonObject() const
+{
+    QJsonObject t_qJsonObject;
+
+    t_qJsonObject.insert("index", QJsonValue(m_iIndex));
+    t_qJsonObject.insert("client_id", QJsonValue(m_result.clientId));
+    t_qJsonObject.insert("delay_ms", QJsonValue(m_iDelayMs));
+    t_qJsonObject.insert("nchan", QJsonValue(m_result.nChannels));
+    t_qJsonObject.insert("sfreq", QJsonValue(m_result.sfreq));
+    t_qJsonObject.insert("buffers", QJsonValue((double)m_result.buffers));
+    t_qJsonObject.insert("samples", QJsonValue((double)m_result.samples));
+    t_qJsonObject.insert("bytes", QJsonValue((double)m_result.bytes));
+    t_qJsonObject.insert("missed_buffers", QJsonValue(m_result.missedBuffers));
+    t_qJsonObject.insert("timeouts", QJsonValue(m_result.timeouts));
+    t_qJsonObject.insert("elapsed_s", QJsonValue(m_result.elapsed));
+
+    double t_dSamplesPerSec = m_result.elapsed > 0 ? m_result.samples / m_result.elapsed : 0.0;
+    double t_dMBytesPerSec = m_result.elapsed > 0 ? m_result.bytes / m_result.elapsed / (1024.0*1024.0) : 0.0;
+    t_qJsonObject.insert("samples_per_s", QJsonValue(t_dSamplesPerSec));
+    t_qJsonObject.insert("mbytes_per_s", QJsonValue(t_dMBytesPerSec));
+    t_qJsonObject.insert("realtime_factor", QJsonValue(m_result.sfreq > 0 ? t_dSamplesPerSec / m_result.sfreq : 0.0));
+
+    QJsonObject t_qJsonObjectLatency;
+    t_qJsonObjectLatency.insert("p50", QJsonValue((double)latencyPercentile(50)));
+    t_qJsonObjectLatency.insert("p95", QJsonValue((double)latencyPercentile(95)));
+    t_qJsonObjectLatency.insert("p99", QJsonValue((double)latencyPercentile(99)));
+    t_qJsonObjectLatency.insert("max", QJsonValue((double)latencyPercentile(100)));
+    t_qJsonObject.insert("latency_us", t_qJsonObjectLatency);
+
+    return t_qJsonObject;
+}
+
+
+//*************************************************************************************************************
+
+void LoadTestClient::run()
+{
+    m_bIsRunning.store(1);
+
+    //
+    // Connect clients
+    //
+    QString t_sHost = m_sHost;
+
+    RtCmdClient t_cmdClient;
+    t_cmdClient.connectToHost(t_sHost);
+    if(!t_cmdClient.waitForConnected(5000))
+    {
+        qWarning("Load test client %d: could not connect to command port.", m_iIndex);
+        return;
+    }
+
+    RtDataClient t_dataClient;
+    t_dataClient.connectToHost(t_sHost);
+    if(!t_dataClient.waitForConnected(5000))
+    {
+        qWarning("Load test client %d: could not connect to data port.", m_iIndex);
+        return;
+    }
+
+    m_result.clientId = t_dataClient.getClientId();
+    t_dataClient.setClientAlias(QString("load%1").arg(m_iIndex));
+
+    t_cmdClient.requestCommands();
+
+    //
+    // Measurement info and start - one pipelined request
+    //
+    t_cmdClient["measinfo"].pValues()[0].setValue(m_result.clientId);
+    t_cmdClient["start"].pValues()[0].setValue(m_result.clientId);
+
+    QList<Command> t_qListCommands;
+    t_qListCommands << t_cmdClient["measinfo"] << t_cmdClient["start"];
+    QFuture<QStringList> t_futureSession = t_cmdClient.sendCommandsAsync(t_qListCommands);
+
+    FiffInfo::SPtr t_pFiffInfo = t_dataClient.readInfo();
+    m_result.nChannels = t_pFiffInfo->nchan;
+    m_result.sfreq = t_pFiffInfo->sfreq;
+
+    if(!t_cmdClient.waitForReplies(t_futureSession, 5000))
+        qWarning("Load test client %d: no reply to the session setup.", m_iIndex);
+
+    m_bIsStreaming.store(1);
+    emit streamingStarted(m_iIndex);
+
+    MatrixXf t_matRawBuffer;
+    fiff_int_t kind;
+
+    QElapsedTimer t_timer;
+    t_timer.start();
+
+    while(m_bIsRunning.load())
+    {
+        // Do not block forever within readRawBuffer when the server stalls
+        if(t_dataClient.bytesAvailable() == 0 && !t_dataClient.waitForReadyRead(1000))
+        {
+            ++m_result.timeouts;
+            if(t_dataClient.state() != QAbstractSocket::ConnectedState)
+                break;
+            continue;
+        }
+
+        t_dataClient.readRawBuffer(m_result.nChannels, t_matRawBuffer, kind);
+
+        if(kind == FIFF_DATA_BUFFER)
+        {
+            qint64 t_iAge = t_dataClient.lastBufferInfo().age();
+            if(t_iAge >= 0)
+                m_result.latencies.append(t_iAge);
+
+            ++m_result.buffers;
+            m_result.samples += t_matRawBuffer.cols();
+            m_result.bytes += t_matRawBuffer.size() * sizeof(float);
+
+            if(m_iDelayMs > 0)
+                msleep(m_iDelayMs);
+        }
+        else if(kind == FIFF_BLOCK_END)
+            break;
+    }
+
+    m_result.elapsed = t_timer.nsecsElapsed() / 1.0e9;
+    m_result.missedBuffers = t_dataClient.missedBuffers();
+
+    //
+    // Stop and disconnect
+    //
+    t_cmdClient["stop"].pValues()[0].setValue(m_result.clientId);
+    t_cmdClient["stop"].send();
+
+    t_cmdClient.disconnectFromHost();
+    t_dataClient.disconnectFromHost();
+
+    m_bIsStreaming.store(0);
+}
@@ -0,0 +1,219 @@
+//=============================================================================================================
+/**
+* @file     loadtestclient.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the LoadTestClient Class.
+*
+*/
+
+#ifndef LOADTESTCLIENT_H
+#define LOADTESTCLIENT_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff_info.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QThread>
+#include <QString>
+#include <QVector>
+#include <QJsonObject>
+#include <QAtomicInt>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE TESTRTSERVERLOAD
+//=============================================================================================================
+
+namespace TESTRTSERVERLOAD
+{
+
+
+//=============================================================================================================
+/**
+* Measures of a single load test client, collected while streaming.
+*
+* @brief Load test client results
+*/
+struct LoadTestResult
+{
+    qint32          clientId;           /**< Id assigned by the mne_rt_server, -1 if the client failed to connect. */
+    qint32          nChannels;          /**< Number of received channels. */
+    double          sfreq;              /**< Sampling frequency reported by the measurement info. */
+    qint64          buffers;            /**< Number of received data buffers. */
+    qint64          samples;            /**< Number of received samples per channel. */
+    qint64          bytes;              /**< Number of received data bytes. */
+    qint32          missedBuffers;      /**< Buffers lost between server and client, derived from sequence gaps. */
+    qint32          timeouts;           /**< Number of read attempts which timed out. */
+    double          elapsed;            /**< Streaming time in seconds. */
+    QVector<qint64> latencies;          /**< Age of each buffer at the time it was parsed, in microseconds. */
+};
+
+
+//=============================================================================================================
+/**
+* Connects one RtCmdClient/RtDataClient pair to a running mne_rt_server, requests the measurement info,
+* starts streaming and reads raw buffers until stop() is called. A per-buffer delay can be configured to
+* simulate a slow consumer.
+*
+* @brief Streaming client used by the mne_rt_server load test
+*/
+class LoadTestClient : public QThread
+{
+    Q_OBJECT
+public:
+    //=========================================================================================================
+    /**
+    * Constructs a LoadTestClient.
+    *
+    * @param[in] p_iIndex       Index of the client within the load test, used as client alias.
+    * @param[in] p_sHost        Host name of the mne_rt_server.
+    * @param[in] p_iDelayMs     Processing delay which is added after each received buffer, in milliseconds.
+    * @param[in] parent         Parent QObject (optional)
+    */
+    LoadTestClient(qint32 p_iIndex, const QString& p_sHost, qint32 p_iDelayMs = 0, QObject* parent = 0);
+
+    //=========================================================================================================
+    /**
+    * Destroys the LoadTestClient.
+    */
+    ~LoadTestClient();
+
+    //=========================================================================================================
+    /**
+    * Requests the client to stop streaming. The thread finishes after the next received buffer or read timeout.
+    */
+    void stop();
+
+    //=========================================================================================================
+    /**
+    * Returns whether the client received the measurement info and started streaming.
+    *
+    * @return true if streaming has been started.
+    */
+    inline bool isStreaming() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the collected measures. Only valid after the thread has finished.
+    *
+    * @return the client results.
+    */
+    inline const LoadTestResult& result() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the processing delay of the client.
+    *
+    * @return the delay in milliseconds.
+    */
+    inline qint32 delay() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the value at the given percentile of the measured buffer latencies.
+    *
+    * @param[in] p_dPercentile  Percentile in the range [0, 100].
+    *
+    * @return the latency in microseconds, -1 if no latencies were recorded.
+    */
+    qint64 latencyPercentile(double p_dPercentile) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the results as a JSON object.
+    *
+    * @return the results JSON object.
+    */
+    QJsonObject toJsonObject() const;
+
+signals:
+    //=========================================================================================================
+    /**
+    * Emitted when the client has started streaming.
+    *
+    * @param[in] p_iIndex   Index of the client within the load test.
+    */
+    void streamingStarted(qint32 p_iIndex);
+
+protected:
+    //=========================================================================================================
+    /**
+    * The starting point for the thread. Connects to the server and reads raw buffers until stopped.
+    */
+    virtual void run();
+
+private:
+    qint32          m_iIndex;           /**< Index of the client within the load test. */
+    QString         m_sHost;            /**< Host name of the mne_rt_server. */
+    qint32          m_iDelayMs;         /**< Processing delay after each buffer, in milliseconds. */
+    QAtomicInt      m_bIsRunning;       /**< Whether the client should keep on streaming. */
+    QAtomicInt      m_bIsStreaming;     /**< Whether the client started streaming. */
+    LoadTestResult  m_result;           /**< The collected measures. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline bool LoadTestClient::isStreaming() const
+{
+    return m_bIsStreaming.load() != 0;
+}
+
+
+//*************************************************************************************************************
+
+inline const LoadTestResult& LoadTestClient::result() const
+{
+    return m_result;
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 LoadTestClient::delay() const
+{
+    return m_iDelayMs;
+}
+
+} // NAMESPACE
+
+#endif // LOADTESTCLIENT_H
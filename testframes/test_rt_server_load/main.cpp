@@ -0,0 +1,358 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Load test for mne_rt_server: streams a simulated recording to several clients and reports their throughput, latency and buffer losses.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "loadtestclient.h"
+
+#include <rtClient/rtcmdclient.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QFile>
+#include <QTextStream>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDateTime>
+#include <QThread>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <stdio.h>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace TESTRTSERVERLOAD;
+using namespace RTCLIENTLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC FUNCTIONS
+//=============================================================================================================
+
+/**
+* Reads the consumed user and system CPU time of a process.
+*
+* @param[in] p_iPid     Process id.
+* @param[out] p_dUser   User CPU time in seconds.
+* @param[out] p_dSystem System CPU time in seconds.
+*
+* @return true if the CPU time could be determined, false otherwise (always false on non Linux platforms).
+*/
+static bool readProcessCpuTime(qint64 p_iPid, double& p_dUser, double& p_dSystem)
+{
+    p_dUser = p_dSystem = 0.0;
+#ifdef Q_OS_LINUX
+    QFile t_file(QString("/proc/%1/stat").arg(p_iPid));
+    if(p_iPid <= 0 || !t_file.open(QIODevice::ReadOnly))
+        return false;
+
+    QString t_sStat = QString(t_file.readAll());
+
+    // The process name may contain spaces -> fields are counted from the closing parenthesis
+    QStringList t_qListFields = t_sStat.mid(t_sStat.lastIndexOf(')') + 2).split(' ');
+    if(t_qListFields.size() < 13)
+        return false;
+
+    double t_dTicks = (double)sysconf(_SC_CLK_TCK);
+    p_dUser = t_qListFields[11].toDouble() / t_dTicks;
+    p_dSystem = t_qListFields[12].toDouble() / t_dTicks;
+    return true;
+#else
+    Q_UNUSED(p_iPid);
+    return false;
+#endif
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* The function main marks the entry point of the program.
+* By default, main has the storage class extern.
+*
+* @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+* @param [in] argv (argument vector) is an array of pointers to arrays of character strings that contain the arguments, one per string.
+* @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+*/
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Command Line Parser
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Load test for mne_rt_server. Streams a simulated recording to several clients and reports their throughput, latency and buffer losses.");
+    parser.addHelpOption();
+
+    QCommandLineOption clientsOption("n", "Number of streaming clients.", "clients", "4");
+    QCommandLineOption slowOption("slow", "Number of clients which simulate a slow consumer.", "clients", "1");
+    QCommandLineOption delayOption("delay", "Processing delay of the slow clients per buffer in milliseconds.", "msecs", "50");
+    QCommandLineOption durationOption("t", "Streaming duration in seconds.", "secs", "30");
+    QCommandLineOption simFileOption("f", "Fiff file which is streamed by the FiffSimulator connector.", "file", QCoreApplication::applicationDirPath() + "/MNE-sample-data/MEG/sample/sample_audvis_raw.fif");
+    QCommandLineOption bufSizeOption("b", "Buffer size in samples, 0 keeps the connector setting.", "samples", "0");
+    QCommandLineOption accelOption("a", "Acceleration factor of the simulator, 0 keeps the connector setting.", "factor", "0");
+    QCommandLineOption hostOption("host", "Host name of the mne_rt_server.", "host", "127.0.0.1");
+    QCommandLineOption serverOption("server", "Path to a mne_rt_server binary which is started for the test.", "path", "");
+    QCommandLineOption pidOption("pid", "Process id of an already running mne_rt_server to measure its CPU time.", "pid", "0");
+    QCommandLineOption outOption("o", "Result file (JSON).", "file", "rt_server_load.json");
+
+    parser.addOption(clientsOption);
+    parser.addOption(slowOption);
+    parser.addOption(delayOption);
+    parser.addOption(durationOption);
+    parser.addOption(simFileOption);
+    parser.addOption(bufSizeOption);
+    parser.addOption(accelOption);
+    parser.addOption(hostOption);
+    parser.addOption(serverOption);
+    parser.addOption(pidOption);
+    parser.addOption(outOption);
+
+    parser.process(app);
+
+    qint32 t_iNumClients = qMax(1, parser.value(clientsOption).toInt());
+    qint32 t_iNumSlow = qBound(0, parser.value(slowOption).toInt(), t_iNumClients);
+    qint32 t_iDelayMs = parser.value(delayOption).toInt();
+    qint32 t_iDuration = qMax(1, parser.value(durationOption).toInt());
+    QString t_sHost = parser.value(hostOption);
+    qint64 t_iServerPid = parser.value(pidOption).toLongLong();
+
+    //
+    // Start server
+    //
+    QProcess t_serverProcess;
+    if(!parser.value(serverOption).isEmpty())
+    {
+        t_serverProcess.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        t_serverProcess.start(parser.value(serverOption));
+        if(!t_serverProcess.waitForStarted())
+        {
+            printf("Could not start %s\n", parser.value(serverOption).toUtf8().constData());
+            return 1;
+        }
+        t_iServerPid = t_serverProcess.processId();
+        QThread::sleep(2); // give the server time to load its connectors
+    }
+
+    //
+    // Configure connector
+    //
+    RtCmdClient t_cmdClient;
+    QElapsedTimer t_timer;
+    t_timer.start();
+    do
+    {
+        t_cmdClient.connectToHost(t_sHost);
+    } while(!t_cmdClient.waitForConnected(1000) && t_timer.elapsed() < 10000);
+
+    if(t_cmdClient.state() != QTcpSocket::ConnectedState)
+    {
+        printf("Could not connect to mne_rt_server at %s\n", t_sHost.toUtf8().constData());
+        return 1;
+    }
+
+    t_cmdClient.requestCommands();
+    t_cmdClient["selcon"].pValues()[0].setValue(1); // FiffSimulator
+    t_cmdClient["selcon"].send();
+
+    // Connector specific commands are available after selection
+    t_cmdClient.requestCommands();
+
+    if(t_cmdClient.hasCommand("simfile"))
+    {
+        t_cmdClient["simfile"].pValues()[0].setValue(parser.value(simFileOption));
+        t_cmdClient["simfile"].send();
+    }
+    if(parser.value(bufSizeOption).toInt() > 0)
+    {
+        t_cmdClient["bufsize"].pValues()[0].setValue(parser.value(bufSizeOption).toInt());
+        t_cmdClient["bufsize"].send();
+    }
+    if(parser.value(accelOption).toFloat() > 0)
+    {
+        t_cmdClient["accel"].pValues()[0].setValue(parser.value(accelOption).toFloat());
+        t_cmdClient["accel"].send();
+    }
+
+    //
+    // Start clients
+    //
+    QList<QSharedPointer<LoadTestClient> > t_qListClients;
+    for(qint32 i = 0; i < t_iNumClients; ++i)
+    {
+        QSharedPointer<LoadTestClient> t_pClient(new LoadTestClient(i, t_sHost, i < t_iNumSlow ? t_iDelayMs : 0));
+        t_pClient->start();
+        t_qListClients.append(t_pClient);
+    }
+
+    t_timer.restart();
+    bool t_bAllStreaming = false;
+    while(!t_bAllStreaming && t_timer.elapsed() < 30000)
+    {
+        QThread::msleep(100);
+        t_bAllStreaming = true;
+        foreach(const QSharedPointer<LoadTestClient>& t_pClient, t_qListClients)
+            t_bAllStreaming &= t_pClient->isStreaming();
+    }
+
+    if(!t_bAllStreaming)
+        printf("Warning: not all clients started streaming.\n");
+
+    //
+    // Measure
+    //
+    double t_dUserStart, t_dSystemStart, t_dUserEnd, t_dSystemEnd;
+    bool t_bHasCpu = readProcessCpuTime(t_iServerPid, t_dUserStart, t_dSystemStart);
+
+    printf("Streaming to %d clients (%d slow) for %d s...\n", t_iNumClients, t_iNumSlow, t_iDuration);
+    t_timer.restart();
+    QThread::sleep(t_iDuration);
+    double t_dWallTime = t_timer.nsecsElapsed() / 1.0e9;
+
+    t_bHasCpu &= readProcessCpuTime(t_iServerPid, t_dUserEnd, t_dSystemEnd);
+
+    foreach(const QSharedPointer<LoadTestClient>& t_pClient, t_qListClients)
+        t_pClient->stop();
+    foreach(const QSharedPointer<LoadTestClient>& t_pClient, t_qListClients)
+        t_pClient->wait();
+
+    t_cmdClient["stop-all"].send();
+    t_cmdClient.disconnectFromHost();
+
+    if(t_serverProcess.state() != QProcess::NotRunning)
+    {
+        t_serverProcess.terminate();
+        if(!t_serverProcess.waitForFinished(5000))
+            t_serverProcess.kill();
+    }
+
+    //
+    // Report
+    //
+    QJsonObject t_qJsonObjectRoot;
+    QJsonObject t_qJsonObjectConfig;
+    t_qJsonObjectConfig.insert("clients", QJsonValue(t_iNumClients));
+    t_qJsonObjectConfig.insert("slow_clients", QJsonValue(t_iNumSlow));
+    t_qJsonObjectConfig.insert("slow_delay_ms", QJsonValue(t_iDelayMs));
+    t_qJsonObjectConfig.insert("duration_s", QJsonValue(t_iDuration));
+    t_qJsonObjectConfig.insert("simfile", QJsonValue(parser.value(simFileOption)));
+    t_qJsonObjectConfig.insert("bufsize", QJsonValue(parser.value(bufSizeOption).toInt()));
+    t_qJsonObjectConfig.insert("accel", QJsonValue(parser.value(accelOption).toDouble()));
+    t_qJsonObjectRoot.insert("timestamp", QJsonValue(QDateTime::currentDateTimeUtc().toString(Qt::ISODate)));
+    t_qJsonObjectRoot.insert("config", t_qJsonObjectConfig);
+
+    QJsonObject t_qJsonObjectServer;
+    t_qJsonObjectServer.insert("wall_s", QJsonValue(t_dWallTime));
+    if(t_bHasCpu)
+    {
+        double t_dCpu = (t_dUserEnd - t_dUserStart) + (t_dSystemEnd - t_dSystemStart);
+        t_qJsonObjectServer.insert("cpu_user_s", QJsonValue(t_dUserEnd - t_dUserStart));
+        t_qJsonObjectServer.insert("cpu_system_s", QJsonValue(t_dSystemEnd - t_dSystemStart));
+        t_qJsonObjectServer.insert("cpu_load", QJsonValue(t_dCpu / t_dWallTime));
+    }
+    t_qJsonObjectRoot.insert("server", t_qJsonObjectServer);
+
+    printf("\n%6s %6s %8s %10s %9s %8s %10s %10s %10s %7s\n", "client", "delay", "buffers", "samples/s", "MB/s", "rt", "p50[ms]", "p95[ms]", "p99[ms]", "missed");
+
+    QJsonArray t_qJsonArrayClients;
+    bool t_bSuccess = true;
+    for(qint32 i = 0; i < t_qListClients.size(); ++i)
+    {
+        QJsonObject t_qJsonObjectClient = t_qListClients[i]->toJsonObject();
+        t_qJsonArrayClients.append(t_qJsonObjectClient);
+
+        const LoadTestResult& t_result = t_qListClients[i]->result();
+        t_bSuccess &= t_result.buffers > 0;
+
+        printf("%6d %6d %8lld %10.1f %9.3f %8.3f %10.2f %10.2f %10.2f %7d\n",
+               i,
+               t_qListClients[i]->delay(),
+               t_result.buffers,
+               t_qJsonObjectClient["samples_per_s"].toDouble(),
+               t_qJsonObjectClient["mbytes_per_s"].toDouble(),
+               t_qJsonObjectClient["realtime_factor"].toDouble(),
+               t_qListClients[i]->latencyPercentile(50) / 1000.0,
+               t_qListClients[i]->latencyPercentile(95) / 1000.0,
+               t_qListClients[i]->latencyPercentile(99) / 1000.0,
+               t_result.missedBuffers);
+    }
+    t_qJsonObjectRoot.insert("clients", t_qJsonArrayClients);
+
+    if(t_bHasCpu)
+        printf("\nServer CPU time: %.2f s user, %.2f s system (%.1f%% load)\n",
+               t_qJsonObjectServer["cpu_user_s"].toDouble(),
+               t_qJsonObjectServer["cpu_system_s"].toDouble(),
+               100.0 * t_qJsonObjectServer["cpu_load"].toDouble());
+
+    QFile t_fileOut(parser.value(outOption));
+    if(t_fileOut.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        t_fileOut.write(QJsonDocument(t_qJsonObjectRoot).toJson());
+        printf("Results written to %s\n", parser.value(outOption).toUtf8().constData());
+    }
+    else
+        printf("Could not write %s\n", parser.value(outOption).toUtf8().constData());
+
+    return t_bSuccess ? 0 : 1;
+}
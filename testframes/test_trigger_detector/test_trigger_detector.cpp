@@ -0,0 +1,275 @@
+//=============================================================================================================
+/**
+* @file     test_trigger_detector.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+* @version  1.0
+* @date     October, 2016
+*
+* @section  LICENSE
+*
+* Copyright (C) 2016, Christoph Dinh. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Tests the flank detection of TriggerDetector across block boundaries.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <utils/triggerdetector.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestTriggerDetector
+*
+* @brief The TestTriggerDetector class feeds short stim blocks to TriggerDetector and checks the reported events
+*
+*/
+class TestTriggerDetector: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestTriggerDetector();
+
+private slots:
+    void initTestCase();
+    void compareFlankAtBlockStart();
+    void compareMaskedCode();
+    void compareBothFlanks();
+    void compareGapAcrossBlocks();
+    void compareReset();
+    void cleanupTestCase();
+
+private:
+    //=========================================================================================================
+    /**
+    * Creates a data block whose stim row holds the given samples and whose other rows are noise.
+    *
+    * @param[in] p_vecStim  Samples of the stim row.
+    *
+    * @return the data block.
+    */
+    MatrixXd createBlock(const VectorXd& p_vecStim) const;
+
+    //=========================================================================================================
+    /**
+    * Compares an event with the expected values.
+    *
+    * @return true if all values match.
+    */
+    static bool isEvent(const TriggerDetector::Event& p_event, qint64 p_iSample, qint32 p_iChannel, qint32 p_iValue, bool p_bRising);
+
+    int m_iNumRows;         /**< Number of rows of the data blocks. */
+    int m_iStimChannel;     /**< Row of the stim channel. */
+};
+
+
+//*************************************************************************************************************
+
+TestTriggerDetector::TestTriggerDetector()
+: m_iNumRows(4)
+, m_iStimChannel(2)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestTriggerDetector::initTestCase()
+{
+    qDebug() << "Stim channel" << m_iStimChannel << "of" << m_iNumRows;
+}
+
+
+//*************************************************************************************************************
+
+void TestTriggerDetector::compareFlankAtBlockStart()
+{
+    TriggerDetector t_detector(QList<int>() << m_iStimChannel, 0.5);
+
+    //The step lies between the last sample of the first and the first sample of the second block
+    VectorXd t_vecFirst = VectorXd::Zero(10);
+    VectorXd t_vecSecond = VectorXd::Constant(10, 5.0);
+
+    QVERIFY(t_detector.detect(createBlock(t_vecFirst)).isEmpty());
+
+    QVector<TriggerDetector::Event> t_vecEvents = t_detector.detect(createBlock(t_vecSecond));
+    QCOMPARE(t_vecEvents.size(), 1);
+    QVERIFY(isEvent(t_vecEvents[0], 10, m_iStimChannel, 5, true));
+    QCOMPARE(t_detector.sampleCount(), (qint64)20);
+}
+
+
+//*************************************************************************************************************
+
+void TestTriggerDetector::compareMaskedCode()
+{
+    TriggerDetector t_detector(QList<int>() << m_iStimChannel, 0.5);
+    t_detector.setMask(0x0F);
+
+    //Only the change of the low nibble from 0 to 1 at sample 4 passes the mask
+    VectorXd t_vecStim(8);
+    t_vecStim << 0, 0, 16, 16, 17, 17, 33, 33;
+
+    QVector<TriggerDetector::Event> t_vecEvents = t_detector.detect(createBlock(t_vecStim));
+    QCOMPARE(t_vecEvents.size(), 1);
+    QVERIFY(isEvent(t_vecEvents[0], 4, m_iStimChannel, 1, true));
+}
+
+
+//*************************************************************************************************************
+
+void TestTriggerDetector::compareBothFlanks()
+{
+    TriggerDetector t_detector(QList<int>() << m_iStimChannel, 0.5, TriggerDetector::Both);
+    t_detector.setMask(0xFF);
+
+    //Code 5 from sample 2, code 3 from sample 4 and back to 0 at sample 6
+    VectorXd t_vecStim(8);
+    t_vecStim << 0, 0, 5, 5, 3, 3, 0, 0;
+
+    QVector<TriggerDetector::Event> t_vecEvents = t_detector.detect(createBlock(t_vecStim));
+    QCOMPARE(t_vecEvents.size(), 4);
+    QVERIFY(isEvent(t_vecEvents[0], 2, m_iStimChannel, 5, true));
+    QVERIFY(isEvent(t_vecEvents[1], 4, m_iStimChannel, 3, true));
+    QVERIFY(isEvent(t_vecEvents[2], 4, m_iStimChannel, 5, false));
+    QVERIFY(isEvent(t_vecEvents[3], 6, m_iStimChannel, 3, false));
+}
+
+
+//*************************************************************************************************************
+
+void TestTriggerDetector::compareGapAcrossBlocks()
+{
+    TriggerDetector t_detector(QList<int>() << m_iStimChannel, 0.5);
+    t_detector.setMinimumGap(10);
+
+    //Rising flanks at samples 6, 10 and 17 in blocks of 8 samples - 10 lies within the gap of 6, 17 does not
+    VectorXd t_vecStim = VectorXd::Zero(24);
+    t_vecStim.segment(6, 2).setOnes();
+    t_vecStim.segment(10, 2).setOnes();
+    t_vecStim.segment(17, 7).setOnes();
+
+    QVector<TriggerDetector::Event> t_vecEvents = t_detector.detect(createBlock(t_vecStim.segment(0, 8)));
+    QCOMPARE(t_vecEvents.size(), 1);
+    QVERIFY(isEvent(t_vecEvents[0], 6, m_iStimChannel, 1, true));
+
+    t_vecEvents = t_detector.detect(createBlock(t_vecStim.segment(8, 8)));
+    QCOMPARE(t_vecEvents.size(), 0);
+
+    t_vecEvents = t_detector.detect(createBlock(t_vecStim.segment(16, 8)));
+    QCOMPARE(t_vecEvents.size(), 1);
+    QVERIFY(isEvent(t_vecEvents[0], 17, m_iStimChannel, 1, true));
+}
+
+
+//*************************************************************************************************************
+
+void TestTriggerDetector::compareReset()
+{
+    TriggerDetector t_detector(QList<int>() << m_iStimChannel, 0.5);
+    t_detector.setMinimumGap(10);
+
+    VectorXd t_vecStim = VectorXd::Zero(8);
+    t_vecStim.tail(4).setOnes();
+    QCOMPARE(t_detector.detect(createBlock(t_vecStim)).size(), 1);
+
+    //After the reset the first block primes the detector again - neither its first sample nor the gap of the
+    //event before the reset count
+    t_detector.reset();
+    QCOMPARE(t_detector.sampleCount(), (qint64)0);
+
+    t_vecStim << 0, 0, 1, 1, 0, 0, 0, 0;
+    t_vecStim *= 3.0;
+    t_vecStim[0] = 5.0;
+
+    QVector<TriggerDetector::Event> t_vecEvents = t_detector.detect(createBlock(t_vecStim));
+    QCOMPARE(t_vecEvents.size(), 1);
+    QVERIFY(isEvent(t_vecEvents[0], 2, m_iStimChannel, 3, true));
+}
+
+
+//*************************************************************************************************************
+
+void TestTriggerDetector::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd TestTriggerDetector::createBlock(const VectorXd& p_vecStim) const
+{
+    MatrixXd t_matBlock = MatrixXd::Random(m_iNumRows, p_vecStim.size());
+    t_matBlock.row(m_iStimChannel) = p_vecStim.transpose();
+
+    return t_matBlock;
+}
+
+
+//*************************************************************************************************************
+
+bool TestTriggerDetector::isEvent(const TriggerDetector::Event& p_event, qint64 p_iSample, qint32 p_iChannel, qint32 p_iValue, bool p_bRising)
+{
+    return p_event.iSample == p_iSample
+            && p_event.iChannel == p_iChannel
+            && p_event.iValue == p_iValue
+            && p_event.bRising == p_bRising;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestTriggerDetector)
+#include "test_trigger_detector.moc"
@@ -40,6 +40,14 @@ TEMPLATE = subdirs
 SUBDIRS += \
     test_codecov \
     test_fiff_rwr \
+    test_rt_server_load \
+    test_matrix_ring_buffer \
+    test_rt_fir_engine \
+    test_rt_iir_engine \
+    test_rt_resampler \
+    test_rt_hpis \
+    test_rt_lcmv \
+    test_trigger_detector \
 #    test_mne_libs \
 #    test_mne_rt \
 #    mne_x_plugin_com \